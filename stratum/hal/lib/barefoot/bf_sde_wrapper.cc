@@ -28,6 +28,7 @@
 #include "stratum/hal/lib/p4/utils.h"
 #include "stratum/lib/channel/channel.h"
 #include "stratum/lib/constants.h"
+#include "stratum/lib/metrics.h"
 #include "stratum/lib/utils.h"
 
 extern "C" {
@@ -574,6 +575,14 @@ template <typename T>
   return ::util::OkStatus();
 }
 
+// Returns the latency histogram of the given SDE wrapper call, e.g.
+// "InsertTableEntry".
+LatencyHistogram* SdeCallLatencyHistogram(const std::string& call) {
+  return MetricRegistry::GetInstance()->GetHistogram(
+      "stratum_bfrt_sde_call_latency_seconds",
+      "Latency of the BfRt SDE table entry calls.", {{"call", call}});
+}
+
 }  // namespace
 
 ::util::Status TableKey::SetExact(int id, const std::string& value) {
@@ -3443,6 +3452,9 @@ namespace {
     uint32 table_id, const TableKeyInterface* table_key,
     const TableDataInterface* table_data) {
   ::absl::ReaderMutexLock l(&data_lock_);
+  static LatencyHistogram* latency =
+      SdeCallLatencyHistogram("InsertTableEntry");
+  ScopedLatencyRecorder latency_recorder(latency);
   auto real_session = std::dynamic_pointer_cast<Session>(session);
   RET_CHECK(real_session);
   auto real_table_key = dynamic_cast<const TableKey*>(table_key);
@@ -3477,6 +3489,9 @@ namespace {
     uint32 table_id, const TableKeyInterface* table_key,
     const TableDataInterface* table_data) {
   ::absl::ReaderMutexLock l(&data_lock_);
+  static LatencyHistogram* latency =
+      SdeCallLatencyHistogram("ModifyTableEntry");
+  ScopedLatencyRecorder latency_recorder(latency);
   auto real_session = std::dynamic_pointer_cast<Session>(session);
   RET_CHECK(real_session);
   auto real_table_key = dynamic_cast<const TableKey*>(table_key);
@@ -3509,6 +3524,9 @@ namespace {
     int device, std::shared_ptr<BfSdeInterface::SessionInterface> session,
     uint32 table_id, const TableKeyInterface* table_key) {
   ::absl::ReaderMutexLock l(&data_lock_);
+  static LatencyHistogram* latency =
+      SdeCallLatencyHistogram("DeleteTableEntry");
+  ScopedLatencyRecorder latency_recorder(latency);
   auto real_session = std::dynamic_pointer_cast<Session>(session);
   RET_CHECK(real_session);
   auto real_table_key = dynamic_cast<const TableKey*>(table_key);
@@ -3536,6 +3554,8 @@ namespace {
     uint32 table_id, const TableKeyInterface* table_key,
     TableDataInterface* table_data) {
   ::absl::ReaderMutexLock l(&data_lock_);
+  static LatencyHistogram* latency = SdeCallLatencyHistogram("GetTableEntry");
+  ScopedLatencyRecorder latency_recorder(latency);
   auto real_session = std::dynamic_pointer_cast<Session>(session);
   RET_CHECK(real_session);
   auto real_table_key = dynamic_cast<const TableKey*>(table_key);
@@ -3560,6 +3580,9 @@ namespace {
     std::vector<std::unique_ptr<TableKeyInterface>>* table_keys,
     std::vector<std::unique_ptr<TableDataInterface>>* table_datas) {
   ::absl::ReaderMutexLock l(&data_lock_);
+  static LatencyHistogram* latency =
+      SdeCallLatencyHistogram("GetAllTableEntries");
+  ScopedLatencyRecorder latency_recorder(latency);
   auto real_session = std::dynamic_pointer_cast<Session>(session);
   RET_CHECK(real_session);
   const bfrt::BfRtTable* table;
@@ -3588,6 +3611,9 @@ namespace {
     int device, std::shared_ptr<BfSdeInterface::SessionInterface> session,
     uint32 table_id, const TableDataInterface* table_data) {
   ::absl::ReaderMutexLock l(&data_lock_);
+  static LatencyHistogram* latency =
+      SdeCallLatencyHistogram("SetDefaultTableEntry");
+  ScopedLatencyRecorder latency_recorder(latency);
   auto real_session = std::dynamic_pointer_cast<Session>(session);
   RET_CHECK(real_session);
   auto real_table_data = dynamic_cast<const TableData*>(table_data);
@@ -3606,6 +3632,9 @@ namespace {
     int device, std::shared_ptr<BfSdeInterface::SessionInterface> session,
     uint32 table_id) {
   ::absl::ReaderMutexLock l(&data_lock_);
+  static LatencyHistogram* latency =
+      SdeCallLatencyHistogram("ResetDefaultTableEntry");
+  ScopedLatencyRecorder latency_recorder(latency);
   auto real_session = std::dynamic_pointer_cast<Session>(session);
   RET_CHECK(real_session);
   const bfrt::BfRtTable* table;
@@ -3622,6 +3651,9 @@ namespace {
     int device, std::shared_ptr<BfSdeInterface::SessionInterface> session,
     uint32 table_id, TableDataInterface* table_data) {
   ::absl::ReaderMutexLock l(&data_lock_);
+  static LatencyHistogram* latency =
+      SdeCallLatencyHistogram("GetDefaultTableEntry");
+  ScopedLatencyRecorder latency_recorder(latency);
   auto real_session = std::dynamic_pointer_cast<Session>(session);
   RET_CHECK(real_session);
   auto real_table_data = dynamic_cast<const TableData*>(table_data);
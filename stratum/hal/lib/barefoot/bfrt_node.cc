@@ -5,9 +5,11 @@
 
 #include <unistd.h>
 
+#include <deque>
 #include <memory>
 #include <string>
 #include <utility>
+#include <vector>
 
 #include "absl/memory/memory.h"
 #include "stratum/glue/status/status_macros.h"
@@ -196,15 +198,29 @@ std::unique_ptr<BfrtNode> BfrtNode::CreateInstance(
     return MAKE_ERROR(ERR_NOT_INITIALIZED) << "Not initialized!";
   }
 
+  // The table entries of the request are translated to the SDK in one batch.
+  // Entries which need no translation are written without being copied.
+  std::vector<const ::p4::v1::TableEntry*> table_entries;
+  std::deque<::p4::v1::TableEntry> translated_table_entries;
+  std::vector<::util::Status> translation_results;
+  RETURN_IF_ERROR(bfrt_p4runtime_translator_->TranslateWriteRequest(
+      req, &table_entries, &translated_table_entries, &translation_results));
+  RET_CHECK(table_entries.size() == req.updates().size());
+  RET_CHECK(translation_results.size() == req.updates().size());
+
   bool success = true;
   ASSIGN_OR_RETURN(auto session, bf_sde_interface_->CreateSession());
   RETURN_IF_ERROR(session->BeginBatch());
-  for (const auto& update : req.updates()) {
+  for (int i = 0; i < req.updates_size(); ++i) {
+    const ::p4::v1::Update& update = req.updates(i);
     ::util::Status status = ::util::OkStatus();
     switch (update.entity().entity_case()) {
       case ::p4::v1::Entity::kTableEntry:
-        status = bfrt_table_manager_->WriteTableEntry(
-            session, update.type(), update.entity().table_entry());
+        status = translation_results[i];
+        if (status.ok()) {
+          status = bfrt_table_manager_->WriteTableEntry(
+              session, update.type(), *table_entries[i]);
+        }
         break;
       case ::p4::v1::Entity::kExternEntry:
         status = WriteExternEntry(session, update.type(),
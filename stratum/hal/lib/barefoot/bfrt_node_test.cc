@@ -4,7 +4,9 @@
 
 #include "stratum/hal/lib/barefoot/bfrt_node.h"
 
+#include <deque>
 #include <string>
+#include <vector>
 
 #include "absl/memory/memory.h"
 #include "absl/synchronization/mutex.h"
@@ -59,6 +61,9 @@ class BfrtNodeTest : public ::testing::Test {
     bf_sde_mock_ = absl::make_unique<BfSdeMock>();
     bfrt_p4runtime_translator_mock_ =
         absl::make_unique<BfrtP4RuntimeTranslatorMock>();
+    ON_CALL(*bfrt_p4runtime_translator_mock_,
+            TranslateWriteRequest(_, _, _, _))
+        .WillByDefault(Invoke(TranslateWriteRequestAsIs));
 
     bfrt_node_ = BfrtNode::CreateInstance(
         bfrt_table_manager_mock_.get(), bfrt_packetio_manager_mock_.get(),
@@ -113,6 +118,22 @@ class BfrtNodeTest : public ::testing::Test {
     return bfrt_node_->HandleStreamMessageRequest(req);
   }
 
+  // Leaves the table entries of a write request untranslated.
+  static ::util::Status TranslateWriteRequestAsIs(
+      const ::p4::v1::WriteRequest& req,
+      std::vector<const ::p4::v1::TableEntry*>* entries,
+      std::deque<::p4::v1::TableEntry>* translated_entries,
+      std::vector<::util::Status>* results) {
+    entries->assign(req.updates_size(), nullptr);
+    results->assign(req.updates_size(), ::util::OkStatus());
+    for (int i = 0; i < req.updates_size(); ++i) {
+      if (req.updates(i).entity().has_table_entry()) {
+        (*entries)[i] = &req.updates(i).entity().table_entry();
+      }
+    }
+    return ::util::OkStatus();
+  }
+
   void PushChassisConfigWithCheck() {
     ChassisConfig config;
     config.add_nodes()->set_id(kNodeId);
@@ -1015,6 +1036,44 @@ TEST_F(BfrtNodeTest, WriteForwardingEntriesSuccess_DeleteTableEntry) {
   EXPECT_EQ(1U, results.size());
 }
 
+TEST_F(BfrtNodeTest, WriteForwardingEntriesTranslatesTableEntries) {
+  ASSERT_NO_FATAL_FAILURE(PushChassisConfigWithCheck());
+  ASSERT_NO_FATAL_FAILURE(PushForwardingPipelineConfigWithCheck());
+
+  // The first entry is translated, the second fails to be translated.
+  ::p4::v1::WriteRequest req;
+  SetupTableEntryToInsert(&req, kNodeId)->set_table_id(1);
+  SetupTableEntryToInsert(&req, kNodeId)->set_table_id(2);
+  ::p4::v1::TableEntry translated_entry;
+  translated_entry.set_table_id(3);
+  EXPECT_CALL(*bfrt_p4runtime_translator_mock_,
+              TranslateWriteRequest(EqualsProto(req), _, _, _))
+      .WillOnce(Invoke([&](const ::p4::v1::WriteRequest& /*req*/,
+                           std::vector<const ::p4::v1::TableEntry*>* entries,
+                           std::deque<::p4::v1::TableEntry>* translated_entries,
+                           std::vector<::util::Status>* results) {
+        translated_entries->push_back(translated_entry);
+        *entries = {&translated_entries->back(), nullptr};
+        *results = {::util::OkStatus(), DefaultError()};
+        return ::util::OkStatus();
+      }));
+
+  std::shared_ptr<BfSdeInterface::SessionInterface> session_mock =
+      std::make_shared<SessionMock>();
+  EXPECT_CALL(*bf_sde_mock_, CreateSession()).WillOnce(Return(session_mock));
+  EXPECT_CALL(*bfrt_table_manager_mock_,
+              WriteTableEntry(session_mock, ::p4::v1::Update::INSERT,
+                              EqualsProto(translated_entry)))
+      .WillOnce(Return(::util::OkStatus()));
+
+  std::vector<::util::Status> results = {};
+  EXPECT_EQ(ERR_AT_LEAST_ONE_OPER_FAILED,
+            WriteForwardingEntries(req, &results).error_code());
+  ASSERT_EQ(2U, results.size());
+  EXPECT_OK(results[0]);
+  EXPECT_EQ(DefaultError(), results[1]);
+}
+
 TEST_F(BfrtNodeTest, WriteForwardingEntriesSuccess_InsertActionProfileMember) {
   ASSERT_NO_FATAL_FAILURE(PushChassisConfigWithCheck());
   ASSERT_NO_FATAL_FAILURE(PushForwardingPipelineConfigWithCheck());
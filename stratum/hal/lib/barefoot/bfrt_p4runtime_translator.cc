@@ -90,56 +90,59 @@ namespace barefoot {
   // Types that support P4Runtime translation:
   // Table.MatchField, Action.Param, ControllerPacketMetadata.Metadata
   // Counter, Meter, Register (index)
-  absl::flat_hash_map<uint32, absl::flat_hash_map<uint32, std::string>>
-      table_to_field_to_type_uri;
-  absl::flat_hash_map<uint32, absl::flat_hash_map<uint32, std::string>>
-      action_to_param_to_type_uri;
+  // Table match fields and action parameters are compiled into per-table and
+  // per-action translation plans, so that table entries are translated without
+  // any URI or bit width lookup.
+  absl::flat_hash_map<uint32, TableTranslation> table_translations;
+  absl::flat_hash_map<uint32, absl::flat_hash_map<uint32, FieldTranslation>>
+      action_translations;
   absl::flat_hash_map<uint32, std::string> packet_in_meta_to_type_uri;
   absl::flat_hash_map<uint32, std::string> packet_out_meta_to_type_uri;
   absl::flat_hash_map<uint32, std::string> counter_to_type_uri;
   absl::flat_hash_map<uint32, std::string> meter_to_type_uri;
   absl::flat_hash_map<uint32, std::string> register_to_type_uri;
-  absl::flat_hash_map<uint32, absl::flat_hash_map<uint32, int32>>
-      table_to_field_to_bit_width;
-  absl::flat_hash_map<uint32, absl::flat_hash_map<uint32, int32>>
-      action_to_param_to_bit_width;
   absl::flat_hash_map<uint32, int32> packet_in_meta_to_bit_width;
   absl::flat_hash_map<uint32, int32> packet_out_meta_to_bit_width;
 
+  for (const auto& action : p4info.actions()) {
+    for (const auto& param : action.params()) {
+      if (param.has_type_name()) {
+        const auto& type_name = param.type_name().name();
+        std::string* uri = gtl::FindOrNull(type_name_to_uri, type_name);
+        int32* bit_width = gtl::FindOrNull(type_name_to_bit_width, type_name);
+        if (uri && bit_width) {
+          action_translations[action.preamble().id()][param.id()] = {
+              *uri, *bit_width, gtl::FindWithDefault(kUriToBitWidth, *uri, 0)};
+        }
+      }
+    }
+  }
   for (const auto& table : p4info.tables()) {
+    TableTranslation table_translation;
     for (const auto& match_field : table.match_fields()) {
       if (match_field.has_type_name()) {
         const auto& type_name = match_field.type_name().name();
-        const auto& table_id = table.preamble().id();
-        const auto& match_field_id = match_field.id();
         std::string* uri = gtl::FindOrNull(type_name_to_uri, type_name);
         if (uri) {
           RET_CHECK(kUriToBitWidth.contains(*uri));
-          table_to_field_to_type_uri[table_id][match_field_id] = *uri;
         }
         int32* bit_width = gtl::FindOrNull(type_name_to_bit_width, type_name);
-        if (bit_width) {
-          table_to_field_to_bit_width[table_id][match_field_id] = *bit_width;
+        if (uri && bit_width) {
+          table_translation.match_fields[match_field.id()] = {
+              *uri, *bit_width, kUriToBitWidth.at(*uri)};
         }
       }
     }
-  }
-  for (const auto& action : p4info.actions()) {
-    for (const auto& param : action.params()) {
-      if (param.has_type_name()) {
-        const auto& type_name = param.type_name().name();
-        const auto& action_id = action.preamble().id();
-        const auto& param_id = param.id();
-        std::string* uri = gtl::FindOrNull(type_name_to_uri, type_name);
-        if (uri) {
-          action_to_param_to_type_uri[action_id][param_id] = *uri;
-        }
-        int32* bit_width = gtl::FindOrNull(type_name_to_bit_width, type_name);
-        if (bit_width) {
-          action_to_param_to_bit_width[action_id][param_id] = *bit_width;
-        }
+    for (const auto& action_ref : table.action_refs()) {
+      if (action_translations.contains(action_ref.id())) {
+        table_translation.has_translated_actions = true;
+        break;
       }
     }
+    if (!table_translation.match_fields.empty() ||
+        table_translation.has_translated_actions) {
+      table_translations[table.preamble().id()] = std::move(table_translation);
+    }
   }
   for (const auto& pkt_md : p4info.controller_packet_metadata()) {
     const auto& ctrl_hdr_name = pkt_md.preamble().name();
@@ -201,15 +204,13 @@ namespace barefoot {
       }
     }
   }
-  table_to_field_to_type_uri_ = table_to_field_to_type_uri;
-  action_to_param_to_type_uri_ = action_to_param_to_type_uri;
+  table_translations_ = std::move(table_translations);
+  action_translations_ = std::move(action_translations);
   packet_in_meta_to_type_uri_ = packet_in_meta_to_type_uri;
   packet_out_meta_to_type_uri_ = packet_out_meta_to_type_uri;
   counter_to_type_uri_ = counter_to_type_uri;
   meter_to_type_uri_ = meter_to_type_uri;
   register_to_type_uri_ = register_to_type_uri;
-  table_to_field_to_bit_width_ = table_to_field_to_bit_width;
-  action_to_param_to_bit_width_ = action_to_param_to_bit_width;
   packet_in_meta_to_bit_width_ = packet_in_meta_to_bit_width;
   packet_out_meta_to_bit_width_ = packet_out_meta_to_bit_width;
   pipeline_require_translation_ = true;
@@ -220,45 +221,117 @@ namespace barefoot {
 BfrtP4RuntimeTranslator::TranslateTableEntry(const ::p4::v1::TableEntry& entry,
                                              bool to_sdk) {
   absl::ReaderMutexLock l(&lock_);
-  if (!pipeline_require_translation_) {
+  const TableTranslation* table_translation =
+      FindTableTranslation(entry.table_id());
+  if (!table_translation) {
     return entry;
   }
-  return TranslateTableEntryInternal(entry, to_sdk);
+  ::p4::v1::TableEntry translated_entry(entry);
+  RETURN_IF_ERROR(TranslateTableEntryInternal(*table_translation,
+                                              &translated_entry, to_sdk));
+  return translated_entry;
 }
 
-::util::StatusOr<::p4::v1::TableEntry>
-BfrtP4RuntimeTranslator::TranslateTableEntryInternal(
-    const ::p4::v1::TableEntry& entry, bool to_sdk) {
-  ::p4::v1::TableEntry translated_entry(entry);
-  const auto& table_id = translated_entry.table_id();
-  if (table_to_field_to_type_uri_.contains(table_id) &&
-      table_to_field_to_bit_width_.contains(table_id)) {
-    for (::p4::v1::FieldMatch& field_match :
-         *translated_entry.mutable_match()) {
-      const auto& field_id = field_match.field_id();
-      std::string* uri =
-          gtl::FindOrNull(table_to_field_to_type_uri_[table_id], field_id);
-      if (!uri) {
+::util::StatusOr<const ::p4::v1::TableEntry*>
+BfrtP4RuntimeTranslator::TranslateTableEntry(
+    const ::p4::v1::TableEntry& entry, bool to_sdk,
+    ::p4::v1::TableEntry* translated_entry) {
+  RET_CHECK(translated_entry);
+  absl::ReaderMutexLock l(&lock_);
+  const TableTranslation* table_translation =
+      FindTableTranslation(entry.table_id());
+  if (!table_translation) {
+    return &entry;
+  }
+  *translated_entry = entry;
+  RETURN_IF_ERROR(TranslateTableEntryInternal(*table_translation,
+                                              translated_entry, to_sdk));
+  return translated_entry;
+}
+
+::util::Status BfrtP4RuntimeTranslator::TranslateWriteRequest(
+    const ::p4::v1::WriteRequest& req,
+    std::vector<const ::p4::v1::TableEntry*>* entries,
+    std::deque<::p4::v1::TableEntry>* translated_entries,
+    std::vector<::util::Status>* results) {
+  RET_CHECK(entries);
+  RET_CHECK(translated_entries);
+  RET_CHECK(results);
+  entries->assign(req.updates_size(), nullptr);
+  results->assign(req.updates_size(), ::util::OkStatus());
+  absl::ReaderMutexLock l(&lock_);
+  for (int i = 0; i < req.updates_size(); ++i) {
+    const ::p4::v1::Entity& entity = req.updates(i).entity();
+    if (!entity.has_table_entry()) {
+      continue;
+    }
+    const ::p4::v1::TableEntry& entry = entity.table_entry();
+    const TableTranslation* table_translation =
+        FindTableTranslation(entry.table_id());
+    if (!table_translation) {
+      (*entries)[i] = &entry;
+      continue;
+    }
+    translated_entries->push_back(entry);
+    (*results)[i] = TranslateTableEntryInternal(
+        *table_translation, &translated_entries->back(), /*to_sdk=*/true);
+    if ((*results)[i].ok()) {
+      (*entries)[i] = &translated_entries->back();
+    } else {
+      translated_entries->pop_back();
+    }
+  }
+  return ::util::OkStatus();
+}
+
+::util::Status BfrtP4RuntimeTranslator::TranslateTableEntries(
+    size_t num_entries,
+    const std::function<::util::StatusOr<::p4::v1::TableEntry*>(size_t)>&
+        get_entry,
+    bool to_sdk) {
+  absl::ReaderMutexLock l(&lock_);
+  for (size_t i = 0; i < num_entries; ++i) {
+    ASSIGN_OR_RETURN(auto* entry, get_entry(i));
+    const TableTranslation* table_translation =
+        FindTableTranslation(entry->table_id());
+    if (table_translation) {
+      RETURN_IF_ERROR(
+          TranslateTableEntryInternal(*table_translation, entry, to_sdk));
+    }
+  }
+  return ::util::OkStatus();
+}
+
+const BfrtP4RuntimeTranslator::TableTranslation*
+BfrtP4RuntimeTranslator::FindTableTranslation(uint32 table_id) const {
+  if (!pipeline_require_translation_) {
+    return nullptr;
+  }
+  return gtl::FindOrNull(table_translations_, table_id);
+}
+
+::util::Status BfrtP4RuntimeTranslator::TranslateTableEntryInternal(
+    const TableTranslation& table_translation, ::p4::v1::TableEntry* entry,
+    bool to_sdk) {
+  if (!table_translation.match_fields.empty()) {
+    for (::p4::v1::FieldMatch& field_match : *entry->mutable_match()) {
+      const FieldTranslation* translation = gtl::FindOrNull(
+          table_translation.match_fields, field_match.field_id());
+      if (!translation) {
         continue;
       }
-      int32 from_bit_width = 0;
-      int32 to_bit_width = 0;
-      if (to_sdk) {
-        from_bit_width = gtl::FindWithDefault(
-            table_to_field_to_bit_width_[table_id], field_id, 0);
-        to_bit_width = gtl::FindWithDefault(kUriToBitWidth, *uri, 0);
-      } else {
-        from_bit_width = gtl::FindWithDefault(kUriToBitWidth, *uri, 0);
-        to_bit_width = gtl::FindWithDefault(
-            table_to_field_to_bit_width_[table_id], field_id, 0);
-      }
+      const std::string& uri = translation->uri;
+      const int32 from_bit_width =
+          to_sdk ? translation->sdn_bit_width : translation->sdk_bit_width;
+      const int32 to_bit_width =
+          to_sdk ? translation->sdk_bit_width : translation->sdn_bit_width;
       if (!from_bit_width || !to_bit_width) {
         continue;
       }
       switch (field_match.field_match_type_case()) {
         case ::p4::v1::FieldMatch::kExact: {
           ASSIGN_OR_RETURN(const std::string& new_val,
-                           TranslateValue(field_match.exact().value(), *uri,
+                           TranslateValue(field_match.exact().value(), uri,
                                           to_sdk, to_bit_width));
           field_match.mutable_exact()->set_value(new_val);
           break;
@@ -270,7 +343,7 @@ BfrtP4RuntimeTranslator::TranslateTableEntryInternal(
                     AllOnesByteString(from_bit_width));
           // New mask with bit width.
           ASSIGN_OR_RETURN(const std::string& new_val,
-                           TranslateValue(field_match.ternary().value(), *uri,
+                           TranslateValue(field_match.ternary().value(), uri,
                                           to_sdk, to_bit_width));
           field_match.mutable_ternary()->set_value(new_val);
           field_match.mutable_ternary()->set_mask(
@@ -282,7 +355,7 @@ BfrtP4RuntimeTranslator::TranslateTableEntryInternal(
           // length must same as the bit width of the field.
           RET_CHECK(field_match.lpm().prefix_len() == from_bit_width);
           ASSIGN_OR_RETURN(const std::string& new_val,
-                           TranslateValue(field_match.lpm().value(), *uri,
+                           TranslateValue(field_match.lpm().value(), uri,
                                           to_sdk, to_bit_width));
           field_match.mutable_lpm()->set_value(new_val);
           field_match.mutable_lpm()->set_prefix_len(to_bit_width);
@@ -293,7 +366,7 @@ BfrtP4RuntimeTranslator::TranslateTableEntryInternal(
           // and high value must be the same.
           RET_CHECK(field_match.range().low() == field_match.range().high());
           ASSIGN_OR_RETURN(const std::string& new_val,
-                           TranslateValue(field_match.range().low(), *uri,
+                           TranslateValue(field_match.range().low(), uri,
                                           to_sdk, to_bit_width));
           field_match.mutable_range()->set_low(new_val);
           field_match.mutable_range()->set_high(new_val);
@@ -301,7 +374,7 @@ BfrtP4RuntimeTranslator::TranslateTableEntryInternal(
         }
         case ::p4::v1::FieldMatch::kOptional: {
           ASSIGN_OR_RETURN(const std::string& new_val,
-                           TranslateValue(field_match.optional().value(), *uri,
+                           TranslateValue(field_match.optional().value(), uri,
                                           to_sdk, to_bit_width));
           field_match.mutable_optional()->set_value(new_val);
           break;
@@ -314,28 +387,29 @@ BfrtP4RuntimeTranslator::TranslateTableEntryInternal(
     }
   }
 
-  switch (translated_entry.action().type_case()) {
+  if (!table_translation.has_translated_actions) {
+    return ::util::OkStatus();
+  }
+  switch (entry->action().type_case()) {
     case ::p4::v1::TableAction::kAction: {
-      ASSIGN_OR_RETURN(
-          *(translated_entry.mutable_action()->mutable_action()),
-          TranslateAction(translated_entry.action().action(), to_sdk));
+      RETURN_IF_ERROR(
+          TranslateAction(entry->mutable_action()->mutable_action(), to_sdk));
       break;
     }
     case ::p4::v1::TableAction::kActionProfileActionSet: {
-      auto* action_set = translated_entry.mutable_action()
-                             ->mutable_action_profile_action_set();
+      auto* action_set =
+          entry->mutable_action()->mutable_action_profile_action_set();
       for (::p4::v1::ActionProfileAction& action_profile_action :
            *action_set->mutable_action_profile_actions()) {
-        ASSIGN_OR_RETURN(
-            *(action_profile_action.mutable_action()),
-            TranslateAction(action_profile_action.action(), to_sdk));
+        RETURN_IF_ERROR(
+            TranslateAction(action_profile_action.mutable_action(), to_sdk));
       }
       break;
     }
     default:
       break;
   }
-  return translated_entry;
+  return ::util::OkStatus();
 }
 
 ::util::StatusOr<::p4::v1::ActionProfileMember>
@@ -345,12 +419,8 @@ BfrtP4RuntimeTranslator::TranslateActionProfileMember(
   if (!pipeline_require_translation_) {
     return act_prof_mem;
   }
-  ::p4::v1::ActionProfileMember translated_apm;
-  translated_apm.CopyFrom(act_prof_mem);
-  const auto& action_profile_id = act_prof_mem.action_profile_id();
-  const auto& member_id = act_prof_mem.member_id();
-  ASSIGN_OR_RETURN(*(translated_apm.mutable_action()),
-                   TranslateAction(translated_apm.action(), to_sdk));
+  ::p4::v1::ActionProfileMember translated_apm(act_prof_mem);
+  RETURN_IF_ERROR(TranslateAction(translated_apm.mutable_action(), to_sdk));
   return translated_apm;
 }
 
@@ -374,12 +444,14 @@ BfrtP4RuntimeTranslator::TranslateMeterEntry(const ::p4::v1::MeterEntry& entry,
 BfrtP4RuntimeTranslator::TranslateDirectMeterEntry(
     const ::p4::v1::DirectMeterEntry& entry, bool to_sdk) {
   absl::ReaderMutexLock l(&lock_);
-  if (!pipeline_require_translation_) {
+  const TableTranslation* table_translation =
+      FindTableTranslation(entry.table_entry().table_id());
+  if (!table_translation) {
     return entry;
   }
   ::p4::v1::DirectMeterEntry translated_entry(entry);
-  ASSIGN_OR_RETURN(*translated_entry.mutable_table_entry(),
-                   TranslateTableEntryInternal(entry.table_entry(), to_sdk));
+  RETURN_IF_ERROR(TranslateTableEntryInternal(
+      *table_translation, translated_entry.mutable_table_entry(), to_sdk));
   return translated_entry;
 }
 
@@ -429,12 +501,14 @@ BfrtP4RuntimeTranslator::TranslateCounterEntry(
 BfrtP4RuntimeTranslator::TranslateDirectCounterEntry(
     const ::p4::v1::DirectCounterEntry& entry, bool to_sdk) {
   absl::ReaderMutexLock l(&lock_);
-  if (!pipeline_require_translation_) {
+  const TableTranslation* table_translation =
+      FindTableTranslation(entry.table_entry().table_id());
+  if (!table_translation) {
     return entry;
   }
   ::p4::v1::DirectCounterEntry translated_entry(entry);
-  ASSIGN_OR_RETURN(*translated_entry.mutable_table_entry(),
-                   TranslateTableEntryInternal(entry.table_entry(), to_sdk));
+  RETURN_IF_ERROR(TranslateTableEntryInternal(
+      *table_translation, translated_entry.mutable_table_entry(), to_sdk));
   return translated_entry;
 }
 
@@ -637,34 +711,30 @@ BfrtP4RuntimeTranslator::TranslateP4Info(
   return translated_p4info;
 }
 
-::util::StatusOr<::p4::v1::Action> BfrtP4RuntimeTranslator::TranslateAction(
-    const ::p4::v1::Action& action, bool to_sdk) {
-  ::p4::v1::Action translated_action;
-  translated_action.CopyFrom(action);
-  const auto& action_id = action.action_id();
-  if (action_to_param_to_type_uri_.contains(action_id) &&
-      action_to_param_to_bit_width_.contains(action_id)) {
-    for (::p4::v1::Action_Param& param : *translated_action.mutable_params()) {
-      const auto& param_id = param.param_id();
-      std::string* uri =
-          gtl::FindOrNull(action_to_param_to_type_uri_[action_id], param_id);
-      int32 to_bit_width = 0;
-      if (to_sdk && uri) {
-        to_bit_width = gtl::FindWithDefault(kUriToBitWidth, *uri, 0);
-      } else {
-        to_bit_width = gtl::FindWithDefault(
-            action_to_param_to_bit_width_[action_id], param_id, 0);
-      }
-      if (uri && to_bit_width) {
-        ASSIGN_OR_RETURN(
-            const std::string& new_val,
-            TranslateValue(param.value(), *uri, to_sdk, to_bit_width));
-        param.set_value(new_val);
-      }  // else, we don't modify the value if it doesn't need to be
-         // translated.
+::util::Status BfrtP4RuntimeTranslator::TranslateAction(
+    ::p4::v1::Action* action, bool to_sdk) {
+  const auto* param_translations =
+      gtl::FindOrNull(action_translations_, action->action_id());
+  if (!param_translations) {
+    return ::util::OkStatus();
+  }
+  for (::p4::v1::Action_Param& param : *action->mutable_params()) {
+    const FieldTranslation* translation =
+        gtl::FindOrNull(*param_translations, param.param_id());
+    if (!translation) {
+      continue;
     }
+    const int32 to_bit_width =
+        to_sdk ? translation->sdk_bit_width : translation->sdn_bit_width;
+    if (to_bit_width) {
+      ASSIGN_OR_RETURN(const std::string& new_val,
+                       TranslateValue(param.value(), translation->uri, to_sdk,
+                                      to_bit_width));
+      param.set_value(new_val);
+    }  // else, we don't modify the value if it doesn't need to be
+       // translated.
   }
-  return translated_action;
+  return ::util::OkStatus();
 }
 
 ::util::StatusOr<std::string> BfrtP4RuntimeTranslator::TranslateValue(
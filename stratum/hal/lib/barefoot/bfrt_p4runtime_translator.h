@@ -4,8 +4,11 @@
 #ifndef STRATUM_HAL_LIB_BAREFOOT_BFRT_P4RUNTIME_TRANSLATOR_H_
 #define STRATUM_HAL_LIB_BAREFOOT_BFRT_P4RUNTIME_TRANSLATOR_H_
 
+#include <deque>
+#include <functional>
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "absl/container/flat_hash_map.h"
 #include "absl/memory/memory.h"
@@ -42,6 +45,34 @@ class BfrtP4RuntimeTranslator {
       const ::p4::config::v1::P4Info& p4info) LOCKS_EXCLUDED(lock_);
   virtual ::util::StatusOr<::p4::v1::TableEntry> TranslateTableEntry(
       const ::p4::v1::TableEntry& entry, bool to_sdk) LOCKS_EXCLUDED(lock_);
+  // Translates a table entry without copying it when its table has no
+  // translated fields. Returns 'entry' itself in that case, and otherwise
+  // 'translated_entry', owned by the caller, set to the translated entry.
+  virtual ::util::StatusOr<const ::p4::v1::TableEntry*> TranslateTableEntry(
+      const ::p4::v1::TableEntry& entry, bool to_sdk,
+      ::p4::v1::TableEntry* translated_entry) LOCKS_EXCLUDED(lock_);
+  // Translates the table entries of a write request to the SDK. The lock is
+  // taken once for the whole request. 'entries' and 'results' get one element
+  // per update, in order: the entry to write, or nullptr if the update is not
+  // a table entry or could not be translated, and the translation status.
+  // Entries of tables without translated fields point into 'req', the others
+  // are kept in 'translated_entries'.
+  virtual ::util::Status TranslateWriteRequest(
+      const ::p4::v1::WriteRequest& req,
+      std::vector<const ::p4::v1::TableEntry*>* entries,
+      std::deque<::p4::v1::TableEntry>* translated_entries,
+      std::vector<::util::Status>* results) LOCKS_EXCLUDED(lock_);
+  // Translates a batch of table entries in place, e.g. the results of a
+  // wildcard read. 'get_entry' is called with the indexes 0 to num_entries - 1
+  // in order and returns the entry to translate. Each entry is translated
+  // before the next call, so the caller can build the entries directly in the
+  // messages it sends. The lock is taken once for the whole batch and the
+  // entries of tables without translated fields are not modified.
+  virtual ::util::Status TranslateTableEntries(
+      size_t num_entries,
+      const std::function<::util::StatusOr<::p4::v1::TableEntry*>(size_t)>&
+          get_entry,
+      bool to_sdk) LOCKS_EXCLUDED(lock_);
   virtual ::util::StatusOr<::p4::v1::ActionProfileMember>
   TranslateActionProfileMember(const ::p4::v1::ActionProfileMember& entry,
                                bool to_sdk) LOCKS_EXCLUDED(lock_);
@@ -97,17 +128,44 @@ class BfrtP4RuntimeTranslator {
         pipeline_require_translation_(false),
         bf_sde_interface_(bf_sde_interface),
         device_id_(device_id) {}
-  virtual ::util::StatusOr<::p4::v1::TableEntry> TranslateTableEntryInternal(
-      const ::p4::v1::TableEntry& entry, bool to_sdk)
+  // The translation of a match field or an action parameter, precomputed
+  // when the pipeline is pushed.
+  struct FieldTranslation {
+    std::string uri;
+    // Bit width of the field in the SDN and SDK representations. The SDK bit
+    // width is 0 if the URI is unknown, in which case the field is not
+    // translated to the SDK.
+    int32 sdn_bit_width;
+    int32 sdk_bit_width;
+  };
+
+  // The translation plan of a table. Tables without translated match fields
+  // and without actions with translated parameters have no plan, and their
+  // entries are not translated at all.
+  struct TableTranslation {
+    // Map from match field ID to its translation.
+    absl::flat_hash_map<uint32, FieldTranslation> match_fields;
+    // True if any of the table actions has translated parameters.
+    bool has_translated_actions = false;
+  };
+
+  // Returns the translation plan of a table, or nullptr if its entries are not
+  // translated.
+  const TableTranslation* FindTableTranslation(uint32 table_id) const
       SHARED_LOCKS_REQUIRED(lock_);
+  // Translates a table entry in place, following the plan of its table.
+  virtual ::util::Status TranslateTableEntryInternal(
+      const TableTranslation& table_translation, ::p4::v1::TableEntry* entry,
+      bool to_sdk) SHARED_LOCKS_REQUIRED(lock_);
   virtual ::util::StatusOr<::p4::v1::PacketMetadata> TranslatePacketMetadata(
       const p4::v1::PacketMetadata& packet_metadata, const std::string& uri,
       int32 bit_width, bool to_sdk) SHARED_LOCKS_REQUIRED(lock_);
   virtual ::util::StatusOr<::p4::v1::Replica> TranslateReplica(
       const ::p4::v1::Replica& replica, bool to_sdk)
       SHARED_LOCKS_REQUIRED(lock_);
-  virtual ::util::StatusOr<::p4::v1::Action> TranslateAction(
-      const ::p4::v1::Action& action, bool to_sdk) SHARED_LOCKS_REQUIRED(lock_);
+  // Translates the parameters of an action in place.
+  virtual ::util::Status TranslateAction(::p4::v1::Action* action, bool to_sdk)
+      SHARED_LOCKS_REQUIRED(lock_);
   virtual ::util::StatusOr<::p4::v1::Index> TranslateIndex(
       const ::p4::v1::Index& index, const std::string& uri, bool to_sdk)
       SHARED_LOCKS_REQUIRED(lock_);
@@ -141,10 +199,12 @@ class BfrtP4RuntimeTranslator {
       GUARDED_BY(lock_);
 
   // P4Runtime translation information
-  absl::flat_hash_map<uint32, absl::flat_hash_map<uint32, std::string>>
-      table_to_field_to_type_uri_ GUARDED_BY(lock_);
-  absl::flat_hash_map<uint32, absl::flat_hash_map<uint32, std::string>>
-      action_to_param_to_type_uri_ GUARDED_BY(lock_);
+  // Map from table ID to the translation plan of the table.
+  absl::flat_hash_map<uint32, TableTranslation> table_translations_
+      GUARDED_BY(lock_);
+  // Map from action ID to the translations of its parameters, by param ID.
+  absl::flat_hash_map<uint32, absl::flat_hash_map<uint32, FieldTranslation>>
+      action_translations_ GUARDED_BY(lock_);
   absl::flat_hash_map<uint32, std::string> packet_in_meta_to_type_uri_
       GUARDED_BY(lock_);
   absl::flat_hash_map<uint32, std::string> packet_out_meta_to_type_uri_
@@ -154,10 +214,6 @@ class BfrtP4RuntimeTranslator {
   absl::flat_hash_map<uint32, std::string> meter_to_type_uri_ GUARDED_BY(lock_);
   absl::flat_hash_map<uint32, std::string> register_to_type_uri_
       GUARDED_BY(lock_);
-  absl::flat_hash_map<uint32, absl::flat_hash_map<uint32, int32>>
-      table_to_field_to_bit_width_ GUARDED_BY(lock_);
-  absl::flat_hash_map<uint32, absl::flat_hash_map<uint32, int32>>
-      action_to_param_to_bit_width_ GUARDED_BY(lock_);
   absl::flat_hash_map<uint32, int32> packet_in_meta_to_bit_width_
       GUARDED_BY(lock_);
   absl::flat_hash_map<uint32, int32> packet_out_meta_to_bit_width_
@@ -4,7 +4,10 @@
 #ifndef STRATUM_HAL_LIB_BAREFOOT_BFRT_P4RUNTIME_TRANSLATOR_MOCK_H_
 #define STRATUM_HAL_LIB_BAREFOOT_BFRT_P4RUNTIME_TRANSLATOR_MOCK_H_
 
+#include <deque>
+#include <functional>
 #include <string>
+#include <vector>
 
 #include "gmock/gmock.h"
 #include "stratum/hal/lib/barefoot/bfrt_p4runtime_translator.h"
@@ -22,6 +25,23 @@ class BfrtP4RuntimeTranslatorMock : public BfrtP4RuntimeTranslator {
   MOCK_METHOD2(TranslateTableEntry,
                ::util::StatusOr<::p4::v1::TableEntry>(
                    const ::p4::v1::TableEntry& entry, bool to_sdk));
+  MOCK_METHOD3(TranslateTableEntry,
+               ::util::StatusOr<const ::p4::v1::TableEntry*>(
+                   const ::p4::v1::TableEntry& entry, bool to_sdk,
+                   ::p4::v1::TableEntry* translated_entry));
+  MOCK_METHOD4(TranslateWriteRequest,
+               ::util::Status(const ::p4::v1::WriteRequest& req,
+                              std::vector<const ::p4::v1::TableEntry*>* entries,
+                              std::deque<::p4::v1::TableEntry>*
+                                  translated_entries,
+                              std::vector<::util::Status>* results));
+  MOCK_METHOD3(
+      TranslateTableEntries,
+      ::util::Status(
+          size_t num_entries,
+          const std::function<::util::StatusOr<::p4::v1::TableEntry*>(size_t)>&
+              get_entry,
+          bool to_sdk));
   MOCK_METHOD2(TranslateActionProfileMember,
                ::util::StatusOr<::p4::v1::ActionProfileMember>(
                    const ::p4::v1::ActionProfileMember& entry, bool to_sdk));
@@ -3,7 +3,9 @@
 
 #include "stratum/hal/lib/barefoot/bfrt_p4runtime_translator.h"
 
+#include <deque>
 #include <string>
+#include <vector>
 
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
@@ -827,6 +829,162 @@ TEST_F(BfrtP4RuntimeTranslatorTest, ReadTableEntry_ActionProfileActionSet) {
                        &BfrtP4RuntimeTranslator::TranslateTableEntry);
 }
 
+TEST_F(BfrtP4RuntimeTranslatorTest, ReadTableEntries) {
+  EXPECT_OK(PushChassisConfig());
+  EXPECT_OK(PushForwardingPipelineConfig());
+  constexpr char table_entry_str[] = R"pb(
+    table_id: 33583783
+    match {
+      field_id: 1
+      exact { value: "\x01\x2C" }
+    }
+    action {
+      action {
+        action_id: 16794911
+        params { param_id: 1 value: "\x01\x2C" }
+      }
+    }
+  )pb";
+  constexpr char expected_table_entry_str[] = R"pb(
+    table_id: 33583783
+    match {
+      field_id: 1
+      exact { value: "\x01" }
+    }
+    action {
+      action {
+        action_id: 16794911
+        params { param_id: 1 value: "\x01" }
+      }
+    }
+  )pb";
+  // Entries of a table without translated fields are not modified, even if
+  // their values could not be translated.
+  constexpr char untranslated_table_entry_str[] = R"pb(
+    table_id: 33554433
+    match {
+      field_id: 1
+      exact { value: "\x0A" }
+    }
+  )pb";
+
+  std::vector<::p4::v1::TableEntry> entries(2);
+  EXPECT_OK(ParseProtoFromString(table_entry_str, &entries[0]));
+  EXPECT_OK(ParseProtoFromString(untranslated_table_entry_str, &entries[1]));
+  ::p4::v1::TableEntry expected_table_entry;
+  EXPECT_OK(
+      ParseProtoFromString(expected_table_entry_str, &expected_table_entry));
+  ::p4::v1::TableEntry untranslated_table_entry(entries[1]);
+  EXPECT_OK(bfrt_p4runtime_translator_->TranslateTableEntries(
+      entries.size(),
+      [&](size_t i) -> ::util::StatusOr<::p4::v1::TableEntry*> {
+        return &entries[i];
+      },
+      /*to_sdk=*/false));
+  EXPECT_THAT(entries[0], EqualsProto(expected_table_entry));
+  EXPECT_THAT(entries[1], EqualsProto(untranslated_table_entry));
+}
+
+TEST_F(BfrtP4RuntimeTranslatorTest, WriteRequest) {
+  EXPECT_OK(PushChassisConfig());
+  EXPECT_OK(PushForwardingPipelineConfig());
+  // A translated entry, an entry of a table without translated fields, an
+  // action profile member and an entry which can't be translated.
+  constexpr char write_request_str[] = R"pb(
+    updates {
+      type: INSERT
+      entity {
+        table_entry {
+          table_id: 33583783
+          match {
+            field_id: 1
+            exact { value: "\x01" }
+          }
+        }
+      }
+    }
+    updates {
+      type: INSERT
+      entity {
+        table_entry {
+          table_id: 33554433
+          match {
+            field_id: 1
+            exact { value: "\x0A" }
+          }
+        }
+      }
+    }
+    updates {
+      type: INSERT
+      entity { action_profile_member { action_profile_id: 1 member_id: 1 } }
+    }
+    updates {
+      type: INSERT
+      entity {
+        table_entry {
+          table_id: 33583783
+          match {
+            field_id: 2
+            ternary { value: "\x01" mask: "\xff\xff" }
+          }
+        }
+      }
+    }
+  )pb";
+  constexpr char expected_table_entry_str[] = R"pb(
+    table_id: 33583783
+    match {
+      field_id: 1
+      exact { value: "\x01\x2C" }
+    }
+  )pb";
+
+  ::p4::v1::WriteRequest req;
+  EXPECT_OK(ParseProtoFromString(write_request_str, &req));
+  ::p4::v1::TableEntry expected_table_entry;
+  EXPECT_OK(
+      ParseProtoFromString(expected_table_entry_str, &expected_table_entry));
+  std::vector<const ::p4::v1::TableEntry*> entries;
+  std::deque<::p4::v1::TableEntry> translated_entries;
+  std::vector<::util::Status> results;
+  EXPECT_OK(bfrt_p4runtime_translator_->TranslateWriteRequest(
+      req, &entries, &translated_entries, &results));
+  ASSERT_EQ(4, entries.size());
+  ASSERT_EQ(4, results.size());
+  ASSERT_EQ(1, translated_entries.size());
+  EXPECT_EQ(&translated_entries[0], entries[0]);
+  EXPECT_THAT(translated_entries[0], EqualsProto(expected_table_entry));
+  EXPECT_OK(results[0]);
+  EXPECT_EQ(&req.updates(1).entity().table_entry(), entries[1]);
+  EXPECT_OK(results[1]);
+  EXPECT_EQ(nullptr, entries[2]);
+  EXPECT_OK(results[2]);
+  EXPECT_EQ(nullptr, entries[3]);
+  EXPECT_EQ(ERR_INVALID_PARAM, results[3].error_code());
+}
+
+TEST_F(BfrtP4RuntimeTranslatorTest, TableEntryWithoutTranslationIsNotCopied) {
+  EXPECT_OK(PushChassisConfig());
+  EXPECT_OK(PushForwardingPipelineConfig());
+  constexpr char table_entry_str[] = R"pb(
+    table_id: 33554433
+    match {
+      field_id: 1
+      exact { value: "\x0A" }
+    }
+  )pb";
+  ::p4::v1::TableEntry table_entry;
+  EXPECT_OK(ParseProtoFromString(table_entry_str, &table_entry));
+  ::p4::v1::TableEntry translated_entry;
+  ::util::StatusOr<const ::p4::v1::TableEntry*> result =
+      bfrt_p4runtime_translator_->TranslateTableEntry(table_entry, true,
+                                                      &translated_entry);
+  ASSERT_OK(result.status());
+  EXPECT_EQ(&table_entry, result.ValueOrDie());
+  EXPECT_THAT(translated_entry, EqualsProto(::p4::v1::TableEntry()));
+}
+
 TEST_F(BfrtP4RuntimeTranslatorTest, WriteTableEntry_InvalidTernary) {
   EXPECT_OK(PushChassisConfig());
   EXPECT_OK(PushForwardingPipelineConfig());
@@ -16,6 +16,7 @@
 #include "stratum/glue/status/status_macros.h"
 #include "stratum/hal/lib/barefoot/bfrt_constants.h"
 #include "stratum/hal/lib/barefoot/utils.h"
+#include "stratum/hal/lib/p4/read_response_batcher.h"
 #include "stratum/hal/lib/p4/utils.h"
 #include "stratum/lib/utils.h"
 
@@ -316,16 +317,12 @@ std::unique_ptr<BfrtTableManager> BfrtTableManager::CreateInstance(
   RET_CHECK(type != ::p4::v1::Update::UNSPECIFIED)
       << "Invalid update type " << type;
   absl::ReaderMutexLock l(&lock_);
-  ASSIGN_OR_RETURN(const auto& translated_table_entry,
-                   bfrt_p4runtime_translator_->TranslateTableEntry(
-                       table_entry, /*to_sdk=*/true));
-
-  ASSIGN_OR_RETURN(auto table, p4_info_manager_->FindTableByID(
-                                   translated_table_entry.table_id()));
-  ASSIGN_OR_RETURN(uint32 table_id, bf_sde_interface_->GetBfRtId(
-                                        translated_table_entry.table_id()));
+  ASSIGN_OR_RETURN(auto table,
+                   p4_info_manager_->FindTableByID(table_entry.table_id()));
+  ASSIGN_OR_RETURN(uint32 table_id,
+                   bf_sde_interface_->GetBfRtId(table_entry.table_id()));
 
-  if (!translated_table_entry.is_default_action()) {
+  if (!table_entry.is_default_action()) {
     if (table.is_const_table()) {
       return MAKE_ERROR(ERR_PERMISSION_DENIED)
              << "Can't write to const table " << table.preamble().name()
@@ -333,14 +330,13 @@ std::unique_ptr<BfrtTableManager> BfrtTableManager::CreateInstance(
     }
     ASSIGN_OR_RETURN(auto table_key,
                      bf_sde_interface_->CreateTableKey(table_id));
-    RETURN_IF_ERROR(BuildTableKey(translated_table_entry, table_key.get()));
+    RETURN_IF_ERROR(BuildTableKey(table_entry, table_key.get()));
 
-    ASSIGN_OR_RETURN(
-        auto table_data,
-        bf_sde_interface_->CreateTableData(
-            table_id, translated_table_entry.action().action().action_id()));
+    ASSIGN_OR_RETURN(auto table_data,
+                     bf_sde_interface_->CreateTableData(
+                         table_id, table_entry.action().action().action_id()));
     if (type == ::p4::v1::Update::INSERT || type == ::p4::v1::Update::MODIFY) {
-      RETURN_IF_ERROR(BuildTableData(translated_table_entry, table_data.get()));
+      RETURN_IF_ERROR(BuildTableData(table_entry, table_data.get()));
     }
 
     switch (type) {
@@ -359,22 +355,22 @@ std::unique_ptr<BfrtTableManager> BfrtTableManager::CreateInstance(
       default:
         return MAKE_ERROR(ERR_INTERNAL)
                << "Unsupported update type: " << type << " in table entry "
-               << translated_table_entry.ShortDebugString() << ".";
+               << table_entry.ShortDebugString() << ".";
     }
   } else {
     RET_CHECK(type == ::p4::v1::Update::MODIFY)
         << "The default table entry can only be modified.";
-    RET_CHECK(translated_table_entry.match_size() == 0)
+    RET_CHECK(table_entry.match_size() == 0)
         << "Default action must not contain match fields.";
-    RET_CHECK(translated_table_entry.priority() == 0)
+    RET_CHECK(table_entry.priority() == 0)
         << "Default action must not contain a priority field.";
 
-    if (translated_table_entry.has_action()) {
+    if (table_entry.has_action()) {
       ASSIGN_OR_RETURN(
           auto table_data,
           bf_sde_interface_->CreateTableData(
-              table_id, translated_table_entry.action().action().action_id()));
-      RETURN_IF_ERROR(BuildTableData(translated_table_entry, table_data.get()));
+              table_id, table_entry.action().action().action_id()));
+      RETURN_IF_ERROR(BuildTableData(table_entry, table_data.get()));
       RETURN_IF_ERROR(bf_sde_interface_->SetDefaultTableEntry(
           device_, session, table_id, table_data.get()));
     } else {
@@ -388,15 +384,16 @@ std::unique_ptr<BfrtTableManager> BfrtTableManager::CreateInstance(
 
 // TODO(max): the need for the original request might go away when the table
 // data is correctly initialized with only the fields we care about.
-::util::StatusOr<::p4::v1::TableEntry> BfrtTableManager::BuildP4TableEntry(
+::util::Status BfrtTableManager::BuildP4TableEntry(
     const ::p4::v1::TableEntry& request,
     const BfSdeInterface::TableKeyInterface* table_key,
-    const BfSdeInterface::TableDataInterface* table_data) {
-  ::p4::v1::TableEntry result;
+    const BfSdeInterface::TableDataInterface* table_data,
+    ::p4::v1::TableEntry* result) {
+  result->Clear();
 
   ASSIGN_OR_RETURN(auto table,
                    p4_info_manager_->FindTableByID(request.table_id()));
-  result.set_table_id(request.table_id());
+  result->set_table_id(request.table_id());
 
   bool has_priority_field = false;
   // Match keys
@@ -408,7 +405,7 @@ std::unique_ptr<BfrtTableManager> BfrtTableManager::CreateInstance(
         RETURN_IF_ERROR(table_key->GetExact(
             expected_match_field.id(), match.mutable_exact()->mutable_value()));
         if (!IsDontCareMatch(match.exact())) {
-          *result.add_match() = match;
+          *result->add_match() = match;
         }
         break;
       }
@@ -420,7 +417,7 @@ std::unique_ptr<BfrtTableManager> BfrtTableManager::CreateInstance(
         match.mutable_ternary()->set_value(value);
         match.mutable_ternary()->set_mask(mask);
         if (!IsDontCareMatch(match.ternary())) {
-          *result.add_match() = match;
+          *result->add_match() = match;
         }
         break;
       }
@@ -432,7 +429,7 @@ std::unique_ptr<BfrtTableManager> BfrtTableManager::CreateInstance(
         match.mutable_lpm()->set_value(prefix);
         match.mutable_lpm()->set_prefix_len(prefix_length);
         if (!IsDontCareMatch(match.lpm())) {
-          *result.add_match() = match;
+          *result->add_match() = match;
         }
         break;
       }
@@ -444,7 +441,7 @@ std::unique_ptr<BfrtTableManager> BfrtTableManager::CreateInstance(
         match.mutable_range()->set_low(low);
         match.mutable_range()->set_high(high);
         if (!IsDontCareMatch(match.range(), expected_match_field.bitwidth())) {
-          *result.add_match() = match;
+          *result->add_match() = match;
         }
         break;
       }
@@ -469,7 +466,7 @@ std::unique_ptr<BfrtTableManager> BfrtTableManager::CreateInstance(
     RETURN_IF_ERROR(table_key->GetPriority(&bf_priority));
     ASSIGN_OR_RETURN(uint64 p4rt_priority,
                      ConvertPriorityFromBfrtToP4rt(bf_priority));
-    result.set_priority(p4rt_priority);
+    result->set_priority(p4rt_priority);
   }
 
   // Action and action data
@@ -478,11 +475,11 @@ std::unique_ptr<BfrtTableManager> BfrtTableManager::CreateInstance(
   // TODO(max): perform check if action id is valid for this table.
   if (action_id) {
     ASSIGN_OR_RETURN(auto action, p4_info_manager_->FindActionByID(action_id));
-    result.mutable_action()->mutable_action()->set_action_id(action_id);
+    result->mutable_action()->mutable_action()->set_action_id(action_id);
     for (const auto& expected_param : action.params()) {
       std::string value;
       RETURN_IF_ERROR(table_data->GetParam(expected_param.id(), &value));
-      auto* param = result.mutable_action()->mutable_action()->add_params();
+      auto* param = result->mutable_action()->mutable_action()->add_params();
       param->set_param_id(expected_param.id());
       param->set_value(value);
     }
@@ -491,24 +488,24 @@ std::unique_ptr<BfrtTableManager> BfrtTableManager::CreateInstance(
   // Action profile member id
   uint64 action_member_id;
   if (table_data->GetActionMemberId(&action_member_id).ok()) {
-    result.mutable_action()->set_action_profile_member_id(action_member_id);
+    result->mutable_action()->set_action_profile_member_id(action_member_id);
   }
 
   // Action profile group id
   uint64 selector_group_id;
   if (table_data->GetSelectorGroupId(&selector_group_id).ok()) {
-    result.mutable_action()->set_action_profile_group_id(selector_group_id);
+    result->mutable_action()->set_action_profile_group_id(selector_group_id);
   }
 
   // Counter data, if applicable.
   uint64 bytes, packets;
   if (request.has_counter_data() &&
       table_data->GetCounterData(&bytes, &packets).ok()) {
-    result.mutable_counter_data()->set_byte_count(bytes);
-    result.mutable_counter_data()->set_packet_count(packets);
+    result->mutable_counter_data()->set_byte_count(bytes);
+    result->mutable_counter_data()->set_packet_count(packets);
   }
 
-  return result;
+  return ::util::OkStatus();
 }
 
 ::util::StatusOr<::p4::v1::DigestList> BfrtTableManager::BuildP4DigestList(
@@ -551,9 +548,9 @@ std::unique_ptr<BfrtTableManager> BfrtTableManager::CreateInstance(
   RETURN_IF_ERROR(BuildTableKey(table_entry, table_key.get()));
   RETURN_IF_ERROR(bf_sde_interface_->GetTableEntry(
       device_, session, table_id, table_key.get(), table_data.get()));
-  ASSIGN_OR_RETURN(
-      ::p4::v1::TableEntry result,
-      BuildP4TableEntry(table_entry, table_key.get(), table_data.get()));
+  ::p4::v1::TableEntry result;
+  RETURN_IF_ERROR(BuildP4TableEntry(table_entry, table_key.get(),
+                                    table_data.get(), &result));
   ::p4::v1::ReadResponse resp;
   ASSIGN_OR_RETURN(*resp.add_entities()->mutable_table_entry(),
                    bfrt_p4runtime_translator_->TranslateTableEntry(
@@ -583,9 +580,9 @@ std::unique_ptr<BfrtTableManager> BfrtTableManager::CreateInstance(
   RETURN_IF_ERROR(bf_sde_interface_->GetDefaultTableEntry(
       device_, session, table_id, table_data.get()));
   // FIXME: BuildP4TableEntry is not suitable for default entries.
-  ASSIGN_OR_RETURN(
-      ::p4::v1::TableEntry result,
-      BuildP4TableEntry(table_entry, table_key.get(), table_data.get()));
+  ::p4::v1::TableEntry result;
+  RETURN_IF_ERROR(BuildP4TableEntry(table_entry, table_key.get(),
+                                    table_data.get(), &result));
   result.set_is_default_action(true);
   result.clear_match();
 
@@ -622,24 +619,23 @@ std::unique_ptr<BfrtTableManager> BfrtTableManager::CreateInstance(
   std::vector<std::unique_ptr<BfSdeInterface::TableDataInterface>> datas;
   RETURN_IF_ERROR(bf_sde_interface_->GetAllTableEntries(
       device_, session, table_id, &keys, &datas));
-  ::p4::v1::ReadResponse resp;
-  for (size_t i = 0; i < keys.size(); ++i) {
-    const std::unique_ptr<BfSdeInterface::TableKeyInterface>& table_key =
-        keys[i];
-    const std::unique_ptr<BfSdeInterface::TableDataInterface>& table_data =
-        datas[i];
-    ASSIGN_OR_RETURN(
-        auto result,
-        BuildP4TableEntry(table_entry, table_key.get(), table_data.get()));
-    ASSIGN_OR_RETURN(*resp.add_entities()->mutable_table_entry(),
-                     bfrt_p4runtime_translator_->TranslateTableEntry(
-                         result, /*to_sdk=*/false));
-  }
-
-  VLOG(1) << "ReadAllTableEntries resp " << resp.DebugString();
-  if (!writer->Write(resp)) {
-    return MAKE_ERROR(ERR_INTERNAL) << "Write to stream for failed.";
-  }
+  // The entries are built directly in the responses and translated in one
+  // batch, each one before the next is added.
+  ReadResponseBatcher batcher(writer);
+  RETURN_IF_ERROR(bfrt_p4runtime_translator_->TranslateTableEntries(
+      keys.size(),
+      [&](size_t i) -> ::util::StatusOr<::p4::v1::TableEntry*> {
+        ASSIGN_OR_RETURN(auto* entity, batcher.AddEntity());
+        RETURN_IF_ERROR(BuildP4TableEntry(table_entry, keys[i].get(),
+                                          datas[i].get(),
+                                          entity->mutable_table_entry()));
+        return entity->mutable_table_entry();
+      },
+      /*to_sdk=*/false));
+  RETURN_IF_ERROR(batcher.Finish());
+  VLOG(1) << "ReadAllTableEntries wrote " << batcher.num_responses_written()
+          << " responses for " << keys.size() << " entries of table "
+          << table_entry.table_id() << ".";
 
   return ::util::OkStatus();
 }
@@ -650,9 +646,11 @@ std::unique_ptr<BfrtTableManager> BfrtTableManager::CreateInstance(
     WriterInterface<::p4::v1::ReadResponse>* writer) {
   RET_CHECK(writer) << "Null writer.";
   absl::ReaderMutexLock l(&lock_);
-  ASSIGN_OR_RETURN(const auto& translated_table_entry,
+  ::p4::v1::TableEntry translated_entry;
+  ASSIGN_OR_RETURN(const ::p4::v1::TableEntry* entry,
                    bfrt_p4runtime_translator_->TranslateTableEntry(
-                       table_entry, /*to_sdk=*/true));
+                       table_entry, /*to_sdk=*/true, &translated_entry));
+  const ::p4::v1::TableEntry& translated_table_entry = *entry;
 
   // We have four cases to handle:
   // 1. table id not set: return all table entries from all tables
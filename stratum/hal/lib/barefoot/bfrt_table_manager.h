@@ -45,7 +45,8 @@ class BfrtTableManager {
   // class is not initialized by the time we push config.
   virtual ::util::Status Shutdown() LOCKS_EXCLUDED(lock_);
 
-  // Writes a table entry.
+  // Writes a table entry. The entry must already be translated to the SDK,
+  // see BfrtP4RuntimeTranslator::TranslateWriteRequest().
   virtual ::util::Status WriteTableEntry(
       std::shared_ptr<BfSdeInterface::SessionInterface> session,
       const ::p4::v1::Update::Type type,
@@ -190,13 +191,13 @@ class BfrtTableManager {
       WriterInterface<::p4::v1::ReadResponse>* writer)
       SHARED_LOCKS_REQUIRED(lock_);
 
-  // Construct a P4RT table entry from a table entry request, table key and
-  // table data.
-  ::util::StatusOr<::p4::v1::TableEntry> BuildP4TableEntry(
+  // Construct a P4RT table entry in 'result' from a table entry request, table
+  // key and table data.
+  ::util::Status BuildP4TableEntry(
       const ::p4::v1::TableEntry& request,
       const BfSdeInterface::TableKeyInterface* table_key,
-      const BfSdeInterface::TableDataInterface* table_data)
-      SHARED_LOCKS_REQUIRED(lock_);
+      const BfSdeInterface::TableDataInterface* table_data,
+      ::p4::v1::TableEntry* result) SHARED_LOCKS_REQUIRED(lock_);
 
   // Construct a P4RT digest list from a list of learn data.
   ::util::StatusOr<::p4::v1::DigestList> BuildP4DigestList(
@@ -698,8 +698,8 @@ TEST_F(BfrtTableManagerTest, RejectTableEntryWithDontCareRangeMatch) {
   ::p4::v1::TableEntry entry;
   ASSERT_OK(ParseProtoFromString(kTableEntryText, &entry));
   EXPECT_CALL(*bfrt_p4runtime_translator_mock_,
-              TranslateTableEntry(EqualsProto(entry), true))
-      .WillOnce(Return(::util::StatusOr<::p4::v1::TableEntry>(entry)));
+              TranslateTableEntry(EqualsProto(entry), true, _))
+      .WillOnce(Return(::util::StatusOr<const ::p4::v1::TableEntry*>(&entry)));
 
   ::util::Status ret =
       bfrt_table_manager_->ReadTableEntry(session_mock, entry, &writer_mock);
@@ -732,10 +732,6 @@ TEST_F(BfrtTableManagerTest, WriteTableEntryTest) {
               std::move(table_data_mock)))));
   ::p4::v1::TableEntry entry;
   ASSERT_OK(ParseProtoFromString(kTableEntryText, &entry));
-  EXPECT_CALL(*bfrt_p4runtime_translator_mock_,
-              TranslateTableEntry(EqualsProto(entry), true))
-      .WillOnce(Return(::util::StatusOr<::p4::v1::TableEntry>(entry)));
-
   EXPECT_OK(bfrt_table_manager_->WriteTableEntry(
       session_mock, ::p4::v1::Update::INSERT, entry));
 }
@@ -765,10 +761,6 @@ TEST_F(BfrtTableManagerTest, ModifyTableEntryTest) {
               std::move(table_data_mock)))));
   ::p4::v1::TableEntry entry;
   ASSERT_OK(ParseProtoFromString(kTableEntryText, &entry));
-  EXPECT_CALL(*bfrt_p4runtime_translator_mock_,
-              TranslateTableEntry(EqualsProto(entry), true))
-      .WillOnce(Return(::util::StatusOr<::p4::v1::TableEntry>(entry)));
-
   EXPECT_OK(bfrt_table_manager_->WriteTableEntry(
       session_mock, ::p4::v1::Update::MODIFY, entry));
 }
@@ -797,10 +789,6 @@ TEST_F(BfrtTableManagerTest, DeleteTableEntryTest) {
               std::move(table_data_mock)))));
   ::p4::v1::TableEntry entry;
   ASSERT_OK(ParseProtoFromString(kTableEntryText, &entry));
-  EXPECT_CALL(*bfrt_p4runtime_translator_mock_,
-              TranslateTableEntry(EqualsProto(entry), true))
-      .WillOnce(Return(::util::StatusOr<::p4::v1::TableEntry>(entry)));
-
   EXPECT_OK(bfrt_table_manager_->WriteTableEntry(
       session_mock, ::p4::v1::Update::DELETE, entry));
 }
@@ -844,10 +832,6 @@ TEST_F(BfrtTableManagerTest, RejectWriteTableConstTest) {
   )pb";
   ::p4::v1::TableEntry entry;
   ASSERT_OK(ParseProtoFromString(kTableEntryText2, &entry));
-  EXPECT_CALL(*bfrt_p4runtime_translator_mock_,
-              TranslateTableEntry(EqualsProto(entry), true))
-      .WillOnce(Return(::util::StatusOr<::p4::v1::TableEntry>(entry)));
-
   ::util::Status ret = bfrt_table_manager_->WriteTableEntry(
       session_mock, ::p4::v1::Update::INSERT, entry);
   ASSERT_FALSE(ret.ok());
@@ -872,10 +856,6 @@ TEST_F(BfrtTableManagerTest, RejectWriteTableDefaultActionTest) {
   )pb";
   ::p4::v1::TableEntry entry;
   ASSERT_OK(ParseProtoFromString(kTableEntryText2, &entry));
-  EXPECT_CALL(*bfrt_p4runtime_translator_mock_,
-              TranslateTableEntry(EqualsProto(entry), true))
-      .WillOnce(Return(::util::StatusOr<::p4::v1::TableEntry>(entry)));
-
   ::util::Status ret = bfrt_table_manager_->WriteTableEntry(
       session_mock, ::p4::v1::Update::INSERT, entry);
   ASSERT_FALSE(ret.ok());
@@ -902,10 +882,6 @@ TEST_F(BfrtTableManagerTest, RejectModifyTableDefaultActionWithMatchTest) {
   )pb";
   ::p4::v1::TableEntry entry;
   ASSERT_OK(ParseProtoFromString(kTableEntryText2, &entry));
-  EXPECT_CALL(*bfrt_p4runtime_translator_mock_,
-              TranslateTableEntry(EqualsProto(entry), true))
-      .WillOnce(Return(::util::StatusOr<::p4::v1::TableEntry>(entry)));
-
   ::util::Status ret = bfrt_table_manager_->WriteTableEntry(
       session_mock, ::p4::v1::Update::MODIFY, entry);
   ASSERT_FALSE(ret.ok());
@@ -932,10 +908,6 @@ TEST_F(BfrtTableManagerTest, RejectModifyTableDefaultActionWithPriorityTest) {
   )pb";
   ::p4::v1::TableEntry entry;
   ASSERT_OK(ParseProtoFromString(kTableEntryText2, &entry));
-  EXPECT_CALL(*bfrt_p4runtime_translator_mock_,
-              TranslateTableEntry(EqualsProto(entry), true))
-      .WillOnce(Return(::util::StatusOr<::p4::v1::TableEntry>(entry)));
-
   ::util::Status ret = bfrt_table_manager_->WriteTableEntry(
       session_mock, ::p4::v1::Update::MODIFY, entry);
   ASSERT_FALSE(ret.ok());
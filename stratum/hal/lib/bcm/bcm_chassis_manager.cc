@@ -7,12 +7,17 @@
 #include <pthread.h>
 
 #include <algorithm>
+#include <map>
 #include <set>
 #include <sstream>  // IWYU pragma: keep
+#include <thread>  // NOLINT
+#include <vector>
 
 #include "absl/container/flat_hash_map.h"
 #include "absl/memory/memory.h"
 #include "absl/synchronization/mutex.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
 #include "gflags/gflags.h"
 #include "google/protobuf/message.h"
 #include "stratum/glue/gtl/map_util.h"
@@ -43,6 +48,12 @@ DEFINE_string(bcm_sdk_shell_log_file, "/var/log/stratum/bcm.log",
 DEFINE_string(bcm_sdk_checkpoint_dir, "",
               "The dir used by SDK to save checkpoints. Default is empty and "
               "it is expected to be explicitly given by flags.");
+DEFINE_bool(bcm_parallel_unit_init, false,
+            "If true, the units are attached and their ports initialized in "
+            "parallel, one thread per unit, on coldboot. The SDK calls for "
+            "different units must be thread-safe. The ports of a unit, and "
+            "the port options set on config push, are still handled one at "
+            "a time.");
 
 namespace stratum {
 namespace hal {
@@ -1078,34 +1089,98 @@ bool IsGePortOnTridentPlus(const BcmPort& bcm_port,
   RETURN_IF_ERROR(RecursivelyCreateDir(FLAGS_bcm_sdk_checkpoint_dir));
 
   // Initialize the SDK.
+  absl::Time start_time = absl::Now();
   RETURN_IF_ERROR(bcm_sdk_interface_->InitializeSdk(
       FLAGS_bcm_sdk_config_file, FLAGS_bcm_sdk_config_flush_file,
       FLAGS_bcm_sdk_shell_log_file));
+  LOG(INFO) << "Initialized the BCM SDK in "
+            << absl::FormatDuration(absl::Now() - start_time) << ".";
 
-  // Attach all the units. Note that we keep the things simple. We will move
-  // forward iff all the units are attched successfully.
+  // Group the ports (flex or not) by unit, keeping their order. The map is
+  // not modified once the units are being initialized.
+  std::map<int, std::vector<int>> unit_to_logical_ports;
   for (const auto& bcm_chip : target_bcm_chassis_map.bcm_chips()) {
-    RETURN_IF_ERROR(
-        bcm_sdk_interface_->FindUnit(bcm_chip.unit(), bcm_chip.pci_bus(),
-                                     bcm_chip.pci_slot(), bcm_chip.type()));
-    RETURN_IF_ERROR(bcm_sdk_interface_->InitializeUnit(bcm_chip.unit(),
-                                                       /*warm_boot=*/false));
-    RETURN_IF_ERROR(
-        bcm_sdk_interface_->SetModuleId(bcm_chip.unit(), bcm_chip.module()));
+    unit_to_logical_ports[bcm_chip.unit()];
   }
-
-  // Initialize all the ports (flex or not).
+  std::vector<std::pair<int, int>> unattached_ports;
   for (const auto& bcm_port : target_bcm_chassis_map.bcm_ports()) {
-    RETURN_IF_ERROR(bcm_sdk_interface_->InitializePort(
-        bcm_port.unit(), bcm_port.logical_port()));
+    auto* logical_ports =
+        gtl::FindOrNull(unit_to_logical_ports, bcm_port.unit());
+    if (logical_ports != nullptr) {
+      logical_ports->push_back(bcm_port.logical_port());
+    } else {
+      unattached_ports.emplace_back(bcm_port.unit(), bcm_port.logical_port());
+    }
   }
 
+  // Attach all the units and initialize their ports. Note that we keep the
+  // things simple. We will move forward iff all the units are attached and
+  // all their ports initialized successfully.
+  start_time = absl::Now();
+  const int num_units = target_bcm_chassis_map.bcm_chips_size();
+  std::vector<::util::Status> unit_statuses(num_units);
+  if (FLAGS_bcm_parallel_unit_init && num_units > 1) {
+    std::vector<std::thread> threads;
+    threads.reserve(num_units);
+    for (int i = 0; i < num_units; ++i) {
+      threads.emplace_back([this, i, &target_bcm_chassis_map,
+                            &unit_to_logical_ports, &unit_statuses]() {
+        const auto& bcm_chip = target_bcm_chassis_map.bcm_chips(i);
+        unit_statuses[i] = InitializeBcmUnit(
+            bcm_chip, unit_to_logical_ports.at(bcm_chip.unit()));
+      });
+    }
+    for (auto& thread : threads) thread.join();
+  } else {
+    for (int i = 0; i < num_units; ++i) {
+      const auto& bcm_chip = target_bcm_chassis_map.bcm_chips(i);
+      RETURN_IF_ERROR(InitializeBcmUnit(
+          bcm_chip, unit_to_logical_ports.at(bcm_chip.unit())));
+    }
+  }
+  ::util::Status status = ::util::OkStatus();
+  for (const auto& unit_status : unit_statuses) {
+    APPEND_STATUS_IF_ERROR(status, unit_status);
+  }
+  RETURN_IF_ERROR(status);
+  // Ports of units missing from bcm_chips are left to the SDK to reject.
+  for (const auto& e : unattached_ports) {
+    RETURN_IF_ERROR(bcm_sdk_interface_->InitializePort(e.first, e.second));
+  }
+  LOG(INFO) << "Initialized " << num_units << " units"
+            << (FLAGS_bcm_parallel_unit_init ? " in parallel" : "") << " in "
+            << absl::FormatDuration(absl::Now() - start_time) << ".";
+
   // Start the diag thread.
   RETURN_IF_ERROR(bcm_sdk_interface_->StartDiagShellServer());
 
   return ::util::OkStatus();
 }
 
+::util::Status BcmChassisManager::InitializeBcmUnit(
+    const BcmChip& bcm_chip, const std::vector<int>& logical_ports) const {
+  const int unit = bcm_chip.unit();
+  absl::Time start_time = absl::Now();
+  RETURN_IF_ERROR(bcm_sdk_interface_->FindUnit(
+      unit, bcm_chip.pci_bus(), bcm_chip.pci_slot(), bcm_chip.type()));
+  absl::Time find_time = absl::Now();
+  RETURN_IF_ERROR(bcm_sdk_interface_->InitializeUnit(unit,
+                                                     /*warm_boot=*/false));
+  RETURN_IF_ERROR(bcm_sdk_interface_->SetModuleId(unit, bcm_chip.module()));
+  absl::Time attach_time = absl::Now();
+  for (int logical_port : logical_ports) {
+    RETURN_IF_ERROR(bcm_sdk_interface_->InitializePort(unit, logical_port));
+  }
+  LOG(INFO) << "Unit " << unit << ": found in "
+            << absl::FormatDuration(find_time - start_time)
+            << ", initialized in "
+            << absl::FormatDuration(attach_time - find_time) << ", "
+            << logical_ports.size() << " ports initialized in "
+            << absl::FormatDuration(absl::Now() - attach_time) << ".";
+
+  return ::util::OkStatus();
+}
+
 ::util::Status BcmChassisManager::InitializeInternalState(
     const BcmChassisMap& base_bcm_chassis_map,
     const BcmChassisMap& target_bcm_chassis_map) {
@@ -262,6 +262,13 @@ class BcmChassisManager : public BcmChassisRoInterface {
       const BcmChassisMap& base_bcm_chassis_map,
       const BcmChassisMap& target_bcm_chassis_map);
 
+  // Attaches to the unit of the given BcmChip and initializes the given
+  // logical ports on it. Units are independent, so InitializeBcmChips() may
+  // call this for several units in parallel. The ports of a unit are
+  // initialized in order, on the calling thread.
+  ::util::Status InitializeBcmUnit(const BcmChip& bcm_chip,
+                                   const std::vector<int>& logical_ports) const;
+
   // One time initialization of the internal state. Need to be called after
   // InitializeBcmChips() completes successfully.
   ::util::Status InitializeInternalState(
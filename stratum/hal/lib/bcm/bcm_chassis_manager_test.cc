@@ -37,6 +37,7 @@ DECLARE_string(bcm_sdk_config_file);
 DECLARE_string(bcm_sdk_config_flush_file);
 DECLARE_string(bcm_sdk_shell_log_file);
 DECLARE_string(bcm_sdk_checkpoint_dir);
+DECLARE_bool(bcm_parallel_unit_init);
 DECLARE_string(test_tmpdir);
 
 namespace stratum {
@@ -46,6 +47,7 @@ namespace bcm {
 using ::testing::_;
 using ::testing::DoAll;
 using ::testing::HasSubstr;
+using ::testing::InSequence;
 using ::testing::Invoke;
 using ::testing::Matcher;
 using ::testing::Mock;
@@ -5173,6 +5175,128 @@ TEST_P(BcmChassisManagerTest, InitializeBcmChipsFailure) {
   EXPECT_FALSE(Initialized());
 }
 
+TEST_P(BcmChassisManagerTest, InitializeBcmChipsInParallel) {
+  const std::string kBcmChassisMapText = R"(
+      bcm_chips {
+        type: TOMAHAWK
+        slot: 1
+        unit: 0
+        module: 0
+        pci_bus: 7
+        pci_slot: 1
+      }
+      bcm_chips {
+        type: TOMAHAWK
+        slot: 1
+        unit: 1
+        module: 1
+        pci_bus: 8
+        pci_slot: 1
+      }
+      bcm_ports {
+        type: CE
+        slot: 1
+        port: 1
+        unit: 0
+        speed_bps: 100000000000
+        logical_port: 34
+        physical_port: 33
+        diag_port: 0
+        serdes_lane: 0
+        num_serdes_lanes: 4
+      }
+      bcm_ports {
+        type: CE
+        slot: 1
+        port: 2
+        unit: 0
+        speed_bps: 100000000000
+        logical_port: 38
+        physical_port: 37
+        diag_port: 4
+        serdes_lane: 0
+        num_serdes_lanes: 4
+      }
+      bcm_ports {
+        type: CE
+        slot: 1
+        port: 3
+        unit: 1
+        speed_bps: 100000000000
+        logical_port: 34
+        physical_port: 33
+        diag_port: 0
+        serdes_lane: 0
+        num_serdes_lanes: 4
+      }
+  )";
+
+  BcmChassisMap bcm_chassis_map;
+  ASSERT_OK(ParseProtoFromString(kBcmChassisMapText, &bcm_chassis_map));
+  FLAGS_bcm_parallel_unit_init = true;
+
+  // Each unit is attached before its own ports are initialized.
+  EXPECT_CALL(*bcm_sdk_mock_, InitializeSdk(FLAGS_bcm_sdk_config_file,
+                                            FLAGS_bcm_sdk_config_flush_file,
+                                            FLAGS_bcm_sdk_shell_log_file))
+      .WillOnce(Return(::util::OkStatus()));
+  EXPECT_CALL(*bcm_sdk_mock_, GenerateBcmConfigFile(_, _, _))
+      .WillRepeatedly(Return(std::string("")));
+  {
+    InSequence s;
+    EXPECT_CALL(*bcm_sdk_mock_, FindUnit(0, 7, 1, BcmChip::TOMAHAWK))
+        .WillOnce(Return(::util::OkStatus()));
+    EXPECT_CALL(*bcm_sdk_mock_, InitializeUnit(0, false))
+        .WillOnce(Return(::util::OkStatus()));
+    EXPECT_CALL(*bcm_sdk_mock_, SetModuleId(0, 0))
+        .WillOnce(Return(::util::OkStatus()));
+    EXPECT_CALL(*bcm_sdk_mock_, InitializePort(0, 34))
+        .WillOnce(Return(::util::OkStatus()));
+    EXPECT_CALL(*bcm_sdk_mock_, InitializePort(0, 38))
+        .WillOnce(Return(::util::OkStatus()));
+  }
+  {
+    InSequence s;
+    EXPECT_CALL(*bcm_sdk_mock_, FindUnit(1, 8, 1, BcmChip::TOMAHAWK))
+        .WillOnce(Return(::util::OkStatus()));
+    EXPECT_CALL(*bcm_sdk_mock_, InitializeUnit(1, false))
+        .WillOnce(Return(::util::OkStatus()));
+    EXPECT_CALL(*bcm_sdk_mock_, SetModuleId(1, 1))
+        .WillOnce(Return(::util::OkStatus()));
+    EXPECT_CALL(*bcm_sdk_mock_, InitializePort(1, 34))
+        .WillOnce(Return(::util::OkStatus()));
+  }
+  EXPECT_CALL(*bcm_sdk_mock_, StartDiagShellServer())
+      .WillOnce(Return(::util::OkStatus()));
+  EXPECT_OK(InitializeBcmChips(bcm_chassis_map, bcm_chassis_map));
+  Mock::VerifyAndClear(bcm_sdk_mock_.get());
+
+  // A unit failing does not stop the other one, but fails the whole call.
+  ::util::Status error(StratumErrorSpace(), ERR_UNKNOWN, "Test");
+  EXPECT_CALL(*bcm_sdk_mock_, InitializeSdk(_, _, _))
+      .WillOnce(Return(::util::OkStatus()));
+  EXPECT_CALL(*bcm_sdk_mock_, GenerateBcmConfigFile(_, _, _))
+      .WillRepeatedly(Return(std::string("")));
+  EXPECT_CALL(*bcm_sdk_mock_, FindUnit(_, _, _, _))
+      .Times(2)
+      .WillRepeatedly(Return(::util::OkStatus()));
+  EXPECT_CALL(*bcm_sdk_mock_, InitializeUnit(0, false))
+      .WillOnce(Return(::util::OkStatus()));
+  EXPECT_CALL(*bcm_sdk_mock_, InitializeUnit(1, false)).WillOnce(Return(error));
+  EXPECT_CALL(*bcm_sdk_mock_, SetModuleId(0, 0))
+      .WillOnce(Return(::util::OkStatus()));
+  EXPECT_CALL(*bcm_sdk_mock_, InitializePort(0, _))
+      .Times(2)
+      .WillRepeatedly(Return(::util::OkStatus()));
+  EXPECT_CALL(*bcm_sdk_mock_, StartDiagShellServer()).Times(0);
+  ::util::Status status = InitializeBcmChips(bcm_chassis_map, bcm_chassis_map);
+  EXPECT_EQ(ERR_UNKNOWN, status.error_code());
+  EXPECT_THAT(status.error_message(), HasSubstr("Test"));
+  EXPECT_FALSE(Initialized());
+
+  FLAGS_bcm_parallel_unit_init = false;
+}
+
 TEST_P(BcmChassisManagerTest, TestSendTransceiverGnmiEvent) {
   ASSERT_OK(PushTestConfig());
 
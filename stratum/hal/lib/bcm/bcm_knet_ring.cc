@@ -0,0 +1,126 @@
+// Copyright 2024 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#include "stratum/hal/lib/bcm/bcm_knet_ring.h"
+
+#include <errno.h>
+#include <linux/if_packet.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include "absl/memory/memory.h"
+#include "stratum/glue/logging.h"
+#include "stratum/glue/status/status_macros.h"
+#include "stratum/lib/macros.h"
+
+namespace stratum {
+namespace hal {
+namespace bcm {
+
+namespace {
+
+// Frame size given to the kernel for the RX ring. TPACKET_V3 packs packets of
+// variable size in the blocks, but the kernel still checks the frame layout.
+constexpr int kRxFrameSize = TPACKET_ALIGNMENT << 7;
+
+::util::Status SetPacketVersion(int sock) {
+  int version = TPACKET_V3;
+  if (setsockopt(sock, SOL_PACKET, PACKET_VERSION, &version,
+                 sizeof(version)) < 0) {
+    return MAKE_ERROR(ERR_INTERNAL)
+           << "Couldn't call setsockopt(PACKET_VERSION). errno: " << errno
+           << ".";
+  }
+
+  return ::util::OkStatus();
+}
+
+::util::StatusOr<uint8*> MapRing(int sock, size_t size) {
+  void* ring = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, sock, 0);
+  if (ring == MAP_FAILED) {
+    return MAKE_ERROR(ERR_INTERNAL)
+           << "Couldn't mmap a packet ring of " << size
+           << " bytes. errno: " << errno << ".";
+  }
+
+  return static_cast<uint8*>(ring);
+}
+
+}  // namespace
+
+BcmKnetRxRing::BcmKnetRxRing(uint8* ring, int block_size, int num_blocks)
+    : ring_(ring),
+      block_size_(block_size),
+      num_blocks_(num_blocks),
+      next_block_(0) {}
+
+BcmKnetRxRing::~BcmKnetRxRing() {
+  munmap(ring_, static_cast<size_t>(block_size_) * num_blocks_);
+}
+
+::util::StatusOr<std::unique_ptr<BcmKnetRxRing>> BcmKnetRxRing::CreateInstance(
+    int sock, int block_size, int num_blocks, int block_timeout_ms) {
+  RET_CHECK(block_size > 0 && block_size % getpagesize() == 0)
+      << "Block size " << block_size << " of the RX ring is not a multiple "
+      << "of the page size " << getpagesize() << ".";
+  RET_CHECK(num_blocks > 0)
+      << "Invalid number of blocks in the RX ring: " << num_blocks << ".";
+  RET_CHECK(block_timeout_ms >= 0)
+      << "Invalid block timeout of the RX ring: " << block_timeout_ms << ".";
+  RET_CHECK(sock >= 0) << "Invalid socket " << sock << ".";
+  RETURN_IF_ERROR(SetPacketVersion(sock));
+
+  struct tpacket_req3 req;
+  memset(&req, 0, sizeof(req));
+  req.tp_block_size = block_size;
+  req.tp_block_nr = num_blocks;
+  req.tp_frame_size = kRxFrameSize;
+  req.tp_frame_nr = block_size / kRxFrameSize * num_blocks;
+  req.tp_retire_blk_tov = block_timeout_ms;
+  if (setsockopt(sock, SOL_PACKET, PACKET_RX_RING, &req, sizeof(req)) < 0) {
+    return MAKE_ERROR(ERR_INTERNAL)
+           << "Couldn't call setsockopt(PACKET_RX_RING). errno: " << errno
+           << ".";
+  }
+  ASSIGN_OR_RETURN(uint8* ring,
+                   MapRing(sock, static_cast<size_t>(block_size) * num_blocks));
+
+  return absl::WrapUnique(new BcmKnetRxRing(ring, block_size, num_blocks));
+}
+
+int BcmKnetRxRing::ReadPackets(const PacketVisitor& visitor) {
+  int num_packets = 0;
+  for (int i = 0; i < num_blocks_; ++i) {
+    auto* block = reinterpret_cast<struct tpacket_block_desc*>(
+        ring_ + static_cast<size_t>(next_block_) * block_size_);
+    if (!(__atomic_load_n(&block->hdr.bh1.block_status, __ATOMIC_ACQUIRE) &
+          TP_STATUS_USER)) {
+      break;
+    }
+    const uint32 num_block_packets = block->hdr.bh1.num_pkts;
+    auto* hdr = reinterpret_cast<struct tpacket3_hdr*>(
+        reinterpret_cast<uint8*>(block) + block->hdr.bh1.offset_to_first_pkt);
+    for (uint32 j = 0; j < num_block_packets; ++j) {
+      const auto* addr = reinterpret_cast<const struct sockaddr_ll*>(
+          reinterpret_cast<uint8*>(hdr) +
+          TPACKET_ALIGN(sizeof(struct tpacket3_hdr)));
+      absl::string_view frame(reinterpret_cast<char*>(hdr) + hdr->tp_mac,
+                              hdr->tp_snaplen);
+      visitor(frame, *addr, hdr->tp_snaplen < hdr->tp_len);
+      hdr = reinterpret_cast<struct tpacket3_hdr*>(
+          reinterpret_cast<uint8*>(hdr) + hdr->tp_next_offset);
+    }
+    num_packets += num_block_packets;
+    __atomic_store_n(&block->hdr.bh1.block_status, TP_STATUS_KERNEL,
+                     __ATOMIC_RELEASE);
+    next_block_ = (next_block_ + 1) % num_blocks_;
+  }
+
+  return num_packets;
+}
+
+}  // namespace bcm
+}  // namespace hal
+}  // namespace stratum
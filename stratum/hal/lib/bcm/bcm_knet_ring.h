@@ -0,0 +1,72 @@
+// Copyright 2024 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef STRATUM_HAL_LIB_BCM_BCM_KNET_RING_H_
+#define STRATUM_HAL_LIB_BCM_BCM_KNET_RING_H_
+
+#include <functional>
+#include <memory>
+
+#include "absl/strings/string_view.h"
+#include "stratum/glue/integral_types.h"
+#include "stratum/glue/status/status.h"
+#include "stratum/glue/status/statusor.h"
+
+// Defined by <linux/if_packet.h> or <netpacket/packet.h>, which conflict.
+struct sockaddr_ll;
+
+namespace stratum {
+namespace hal {
+namespace bcm {
+
+// A TPACKET_V3 RX ring (PACKET_RX_RING) mapped on an AF_PACKET socket. The
+// kernel writes the received packets into blocks of the ring and hands over a
+// block at once, when it is full or when its timeout expires. The packets are
+// then parsed in place, without a copy or a syscall per packet.
+class BcmKnetRxRing {
+ public:
+  // Called for every packet read from the ring. The frame starts at the MAC
+  // header, points into the ring and is only valid for the duration of the
+  // call. 'truncated' is true if the frame is shorter than the packet.
+  using PacketVisitor =
+      std::function<void(absl::string_view frame,
+                         const struct sockaddr_ll& addr, bool truncated)>;
+
+  virtual ~BcmKnetRxRing();
+
+  // Sets up a ring of 'num_blocks' blocks of 'block_size' bytes on the given
+  // socket, which is not bound yet. 'block_size' must be a multiple of the page
+  // size. A partially filled block is handed over 'block_timeout_ms' after
+  // its first packet (0 means a kernel default derived from the link speed).
+  static ::util::StatusOr<std::unique_ptr<BcmKnetRxRing>> CreateInstance(
+      int sock, int block_size, int num_blocks, int block_timeout_ms);
+
+  // Visits all the packets of the blocks handed over by the kernel, at most
+  // one lap of the ring, and gives the blocks back to the kernel. Never
+  // blocks. Returns the number of visited packets. Must be called from a
+  // single thread.
+  int ReadPackets(const PacketVisitor& visitor);
+
+  // BcmKnetRxRing is neither copyable nor movable.
+  BcmKnetRxRing(const BcmKnetRxRing&) = delete;
+  BcmKnetRxRing& operator=(const BcmKnetRxRing&) = delete;
+
+ private:
+  // Private constructor. Use CreateInstance() to create an instance of this
+  // class.
+  BcmKnetRxRing(uint8* ring, int block_size, int num_blocks);
+
+  // The mapped ring, owned by this class.
+  uint8* const ring_;
+  const int block_size_;
+  const int num_blocks_;
+
+  // Index of the next block to be handed over by the kernel.
+  int next_block_;
+};
+
+}  // namespace bcm
+}  // namespace hal
+}  // namespace stratum
+
+#endif  // STRATUM_HAL_LIB_BCM_BCM_KNET_RING_H_
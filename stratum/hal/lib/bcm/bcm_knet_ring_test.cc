@@ -0,0 +1,141 @@
+// Copyright 2024 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#include "stratum/hal/lib/bcm/bcm_knet_ring.h"
+
+#include <arpa/inet.h>
+#include <linux/if_packet.h>
+#include <net/ethernet.h>
+#include <net/if.h>
+#include <poll.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <string>
+#include <vector>
+
+#include "absl/strings/str_cat.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "stratum/glue/status/status_test_util.h"
+
+namespace stratum {
+namespace hal {
+namespace bcm {
+
+// The ring is tested with real AF_PACKET sockets on the loopback interface,
+// the same way a KNET interface is used. The tests are skipped when the
+// process is not allowed to open such sockets (CAP_NET_RAW).
+class BcmKnetRingTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    lo_index_ = if_nametoindex("lo");
+    rx_sock_ = socket(AF_PACKET, SOCK_RAW, htons(kEtherType));
+    tx_sock_ = socket(AF_PACKET, SOCK_RAW, 0);
+  }
+
+  void TearDown() override {
+    if (rx_sock_ >= 0) close(rx_sock_);
+    if (tx_sock_ >= 0) close(tx_sock_);
+  }
+
+  bool CanOpenPacketSockets() const {
+    return lo_index_ > 0 && rx_sock_ >= 0 && tx_sock_ >= 0;
+  }
+
+  // Binds the RX socket to the loopback interface, after its ring is set up.
+  void BindRxSocket() {
+    struct sockaddr_ll addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sll_family = AF_PACKET;
+    addr.sll_protocol = htons(kEtherType);
+    addr.sll_ifindex = lo_index_;
+    ASSERT_EQ(0, bind(rx_sock_, reinterpret_cast<struct sockaddr*>(&addr),
+                      sizeof(addr)));
+  }
+
+  // Returns an Ethernet header with the test ether type.
+  static std::string EthernetHeader() {
+    std::string header(ETH_ALEN * 2, '\x02');
+    header.push_back(static_cast<char>(kEtherType >> 8));
+    header.push_back(static_cast<char>(kEtherType & 0xff));
+    return header;
+  }
+
+  // Sends a packet with the test ether type to the loopback interface.
+  void SendPacket(const std::string& payload) {
+    const std::string packet = EthernetHeader() + payload;
+    struct sockaddr_ll addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sll_family = AF_PACKET;
+    addr.sll_ifindex = lo_index_;
+    addr.sll_halen = ETH_ALEN;
+    ASSERT_EQ(static_cast<ssize_t>(packet.size()),
+              sendto(tx_sock_, packet.data(), packet.size(), 0,
+                     reinterpret_cast<struct sockaddr*>(&addr), sizeof(addr)));
+  }
+
+  // Reads the packets of the ring until the given number of packets is
+  // received or a timeout expires.
+  std::vector<std::string> ReadPackets(BcmKnetRxRing* ring, size_t count) {
+    std::vector<std::string> payloads;
+    const absl::Time deadline = absl::Now() + absl::Seconds(5);
+    while (payloads.size() < count && absl::Now() < deadline) {
+      struct pollfd pfd = {rx_sock_, POLLIN, 0};
+      poll(&pfd, 1, 100);
+      ring->ReadPackets([this, &payloads](absl::string_view frame,
+                                          const struct sockaddr_ll& addr,
+                                          bool truncated) {
+        EXPECT_FALSE(truncated);
+        EXPECT_EQ(lo_index_, addr.sll_ifindex);
+        EXPECT_NE(PACKET_OUTGOING, addr.sll_pkttype);
+        ASSERT_GE(frame.size(), ETH_HLEN);
+        payloads.emplace_back(frame.substr(ETH_HLEN));
+      });
+    }
+    return payloads;
+  }
+
+  static constexpr uint16 kEtherType = 0x88b5;  // local experimental
+  int lo_index_ = 0;
+  int rx_sock_ = -1;
+  int tx_sock_ = -1;
+};
+
+constexpr uint16 BcmKnetRingTest::kEtherType;
+
+TEST_F(BcmKnetRingTest, RejectsInvalidRingSizes) {
+  EXPECT_FALSE(BcmKnetRxRing::CreateInstance(rx_sock_, getpagesize() + 1, 4, 1)
+                   .ok());
+  EXPECT_FALSE(
+      BcmKnetRxRing::CreateInstance(rx_sock_, getpagesize(), 0, 1).ok());
+  EXPECT_FALSE(BcmKnetRxRing::CreateInstance(-1, getpagesize(), 4, 1).ok());
+}
+
+TEST_F(BcmKnetRingTest, ReceivesInBatches) {
+  if (!CanOpenPacketSockets()) GTEST_SKIP() << "No AF_PACKET sockets.";
+  auto rx_ring_or =
+      BcmKnetRxRing::CreateInstance(rx_sock_, getpagesize() * 4, 4, 1);
+  ASSERT_OK(rx_ring_or.status());
+  auto rx_ring = rx_ring_or.ConsumeValueOrDie();
+  BindRxSocket();
+
+  constexpr int kNumPackets = 20;
+  std::vector<std::string> expected;
+  for (int i = 0; i < kNumPackets; ++i) {
+    expected.push_back(absl::StrCat("packet ", i, std::string(64, 'x')));
+    SendPacket(expected.back());
+  }
+  EXPECT_EQ(expected, ReadPackets(rx_ring.get(), kNumPackets));
+  EXPECT_EQ(0, rx_ring->ReadPackets(
+                   [](absl::string_view, const struct sockaddr_ll&, bool) {
+                     ADD_FAILURE() << "Unexpected packet.";
+                   }));
+}
+
+}  // namespace bcm
+}  // namespace hal
+}  // namespace stratum
@@ -22,6 +22,7 @@
 #include <utility>
 
 #include "absl/container/flat_hash_map.h"
+#include "absl/strings/string_view.h"
 #include "absl/strings/substitute.h"
 #include "absl/synchronization/mutex.h"
 #include "gflags/gflags.h"
@@ -39,6 +40,18 @@ DEFINE_int32(knet_rx_poll_timeout_ms, 100,
 DEFINE_int32(knet_max_num_packets_to_read_at_once, 8,
              "Determines the number of packets we try to read at once as soon "
              "as the socket FD becomes available.");
+DEFINE_bool(knet_use_packet_rings, false,
+            "Use TPACKET_V3 memory mapped RX rings on the KNET sockets. The "
+            "received packets are then read in blocks and parsed in place, "
+            "instead of one recvmsg() per packet.");
+DEFINE_int32(knet_rx_ring_block_size, 256 * 1024,
+             "Size in bytes of a block of the KNET RX rings. Must be a "
+             "multiple of the page size.");
+DEFINE_int32(knet_rx_ring_num_blocks, 16,
+             "Number of blocks of the KNET RX rings.");
+DEFINE_int32(knet_rx_ring_block_timeout_ms, 2,
+             "Max time the kernel holds a partially filled block of the KNET "
+             "RX rings before handing it over (0 = kernel default).");
 
 // TODO(unknown): I really really wish we could use google3 thread libraries.
 namespace stratum {
@@ -71,6 +84,31 @@ namespace {
     purpose_to_rx_stats_[purpose].counter++;   \
   } while (0)
 
+// Assigns the payload of a received frame, without the known VLAN tags.
+void AssignPayloadWithoutKnownVlanTag(absl::string_view frame,
+                                      std::string* payload) {
+  const struct ether_header* ether_header =
+      reinterpret_cast<const struct ether_header*>(frame.data());
+  bool tagged = false;
+  if (frame.size() >= sizeof(struct ether_header) + kVlanIdSize &&
+      ntohs(ether_header->ether_type) == ETHERTYPE_VLAN) {
+    auto* pid =
+        reinterpret_cast<const uint16*>(frame.data() + sizeof(*ether_header));
+    uint16 vlan = ntohs(*pid) & kVlanIdMask;
+    if (vlan == kDefaultVlan || vlan == kArpVlan || vlan == 0) {
+      tagged = true;
+    }
+  }
+
+  if (tagged) {
+    payload->assign(frame.data(), ETH_ALEN * 2);
+    payload->append(frame.data() + ETH_ALEN * 2 + kVlanTagSize,
+                    frame.size() - ETH_ALEN * 2 - kVlanTagSize);
+  } else {
+    payload->assign(frame.data(), frame.size());
+  }
+}
+
 }  // namespace
 
 BcmPacketioManager::BcmPacketioManager(
@@ -931,6 +969,17 @@ std::string BcmPacketioManager::GetKnetIntfNameTemplate(
     }
   }
 
+  // Set up the memory mapped RX ring (if enabled by flags). The ring is set up
+  // before the socket is bound, so that no packet is received by the socket
+  // without the ring.
+  if (FLAGS_knet_use_packet_rings) {
+    ASSIGN_OR_RETURN(intf->rx_ring,
+                     BcmKnetRxRing::CreateInstance(
+                         intf->rx_sock, FLAGS_knet_rx_ring_block_size,
+                         FLAGS_knet_rx_ring_num_blocks,
+                         FLAGS_knet_rx_ring_block_timeout_ms));
+  }
+
   // Now bind socket to the interface. To bind to the interface, we do not use
   // setsockopt(SO_BINDTODEVICE). Instead we use bind with netif_index.
   struct sockaddr_ll addr;
@@ -990,12 +1039,18 @@ std::string BcmPacketioManager::GetKnetIntfNameTemplate(
   // not expect BcmKnetIntf for this purpose to change at all (if it does,
   // VerifyChassisConfig() will return reboot required).
   int rx_sock = -1, netif_index = -1;
+  BcmKnetRxRing* rx_ring = nullptr;
+  size_t header_size = 0;
   {
     absl::ReaderMutexLock l(&chassis_lock);
     if (shutdown) return ::util::OkStatus();
     ASSIGN_OR_RETURN(const BcmKnetIntf* intf, GetBcmKnetIntf(purpose));
     rx_sock = intf->rx_sock;
     netif_index = intf->netif_index;
+    rx_ring = intf->rx_ring.get();
+    if (rx_ring != nullptr) {
+      header_size = bcm_sdk_interface_->GetKnetHeaderSizeForRx(unit_);
+    }
     RET_CHECK(rx_sock > 0)  // MUST NOT HAPPEN!
         << "KNET interface with purpose "
         << GoogleConfig::BcmKnetIntfPurpose_Name(purpose) << " on node with ID "
@@ -1031,88 +1086,36 @@ std::string BcmPacketioManager::GetKnetIntfNameTemplate(
       INCREMENT_RX_COUNTER(purpose, rx_errors_epoll_wait_failures);
       continue;  // let it retry
     } else if (ret > 0 && pevents[0].events & EPOLLIN) {
-      // We have data to receive. Try to read max of
-      // FLAGS_knet_max_num_packets_to_read_at_once packets before we try to
-      // check for exit criteria.
       std::vector<::p4::v1::PacketIn> packets;
-      for (int i = 0; i < FLAGS_knet_max_num_packets_to_read_at_once; ++i) {
+      if (rx_ring != nullptr) {
+        // We have blocks to read from the RX ring. Read all of them at once,
+        // the packets are parsed in place in the ring.
         absl::ReaderMutexLock l(&chassis_lock);
         if (shutdown) break;
-        std::string header = "";
-        ::p4::v1::PacketIn packet;
-        ASSIGN_OR_RETURN(bool retry,
-                         RxPacket(purpose, rx_sock, netif_index, &header,
-                                  packet.mutable_payload()));
-        if (!retry) break;
-        if (!header.empty()) {
-          // We received good data. Process it. The parsing errors will not
+        rx_ring->ReadPackets([&](absl::string_view frame,
+                                 const struct sockaddr_ll& addr,
+                                 bool truncated) {
+          HandleRxRingFrame(purpose, netif_index, header_size, frame, addr,
+                            truncated, &packets);
+        });
+      } else {
+        // We have data to receive. Try to read max of
+        // FLAGS_knet_max_num_packets_to_read_at_once packets before we try to
+        // check for exit criteria.
+        for (int i = 0; i < FLAGS_knet_max_num_packets_to_read_at_once; ++i) {
+          absl::ReaderMutexLock l(&chassis_lock);
+          if (shutdown) break;
+          std::string header = "";
+          ::p4::v1::PacketIn packet;
+          ASSIGN_OR_RETURN(bool retry,
+                           RxPacket(purpose, rx_sock, netif_index, &header,
+                                    packet.mutable_payload()));
+          if (!retry) break;
+          // If we received good data, process it. The parsing errors will not
           // result in RX thread to shutdown.
-          int ingress_logical_port = 0, egress_logical_port = 0;
-          PacketInMetadata meta;
-          ::util::Status status = bcm_sdk_interface_->ParseKnetHeaderForRx(
-              unit_, header, &ingress_logical_port, &egress_logical_port,
-              &meta.cos);
-          if (!status.ok()) {
-            VLOG(1) << "Failed to parse KNET header for a packet on unit "
-                    << unit_ << ": " << status.error_message();
-            INCREMENT_RX_COUNTER(purpose, rx_drops_knet_header_parse_error);
-            continue;  // let it retry
-          }
-          // Find ingress port ID.
-          if (ingress_logical_port == kCpuLogicalPort) {
-            // This means CPU port by default.
-            meta.ingress_port_id = kCpuPortId;
-          } else {
-            uint32* ingress_port_id =
-                gtl::FindOrNull(logical_port_to_port_id_, ingress_logical_port);
-            if (ingress_port_id == nullptr) {
-              VLOG(1) << "Ingress logical port " << ingress_logical_port
-                      << " on unit " << unit_ << " is unknown!";
-              INCREMENT_RX_COUNTER(purpose, rx_drops_unknown_ingress_port);
-              continue;  // let it retry
-            }
-            meta.ingress_port_id = *ingress_port_id;
-            auto ret = bcm_chassis_ro_interface_->GetParentTrunkId(
-                node_id_, *ingress_port_id);
-            if (ret.ok()) {
-              // If status is OK, there is a parent trunk.
-              meta.ingress_trunk_id = ret.ValueOrDie();
-            }
-          }
-          // Find egress port ID.
-          if (egress_logical_port == kCpuLogicalPort) {
-            // This means CPU port by default.
-            meta.egress_port_id = kCpuPortId;
-          } else if (egress_logical_port == 1) {
-            // SDKLT sets egress port to 1 for packets that do not match
-            // MY_STATION table or got dropped by the ASIC?
-            // TODO(unknown): check this and decide what to report upwards
-            meta.egress_port_id = 1;
-          } else {
-            uint32* egress_port_id =
-                gtl::FindOrNull(logical_port_to_port_id_, egress_logical_port);
-            if (egress_port_id == nullptr) {
-              VLOG(1) << "Egress logical port " << egress_logical_port
-                      << " on unit " << unit_ << " is unknown!";
-              INCREMENT_RX_COUNTER(purpose, rx_drops_unknown_egress_port);
-              continue;  // let it retry
-            }
-            meta.egress_port_id = *egress_port_id;
-          }
-          VLOG(1) << "PacketInMetadata.ingress_port_id: "
-                  << meta.ingress_port_id << "\n"
-                  << "PacketInMetadata.ingress_trunk_id: "
-                  << meta.ingress_trunk_id << "\n"
-                  << "PacketInMetadata.egress_port_id: " << meta.egress_port_id
-                  << "\n"
-                  << "PacketInMetadata.cos: " << meta.cos;
-          status = DeparsePacketInMetadata(meta, &packet);
-          if (!status.ok()) {
-            INCREMENT_RX_COUNTER(purpose, rx_drops_metadata_deparse_error);
-            continue;  // let it retry
+          if (!header.empty() && ProcessRxPacket(purpose, header, &packet)) {
+            packets.push_back(std::move(packet));
           }
-          INCREMENT_RX_COUNTER(purpose, rx_accepts);
-          packets.push_back(packet);
         }
       }
       // Send the packet to the packet RX writer.
@@ -1137,6 +1140,104 @@ std::string BcmPacketioManager::GetKnetIntfNameTemplate(
   return ::util::OkStatus();
 }
 
+bool BcmPacketioManager::ProcessRxPacket(
+    GoogleConfig::BcmKnetIntfPurpose purpose, absl::string_view header,
+    ::p4::v1::PacketIn* packet) {
+  int ingress_logical_port = 0, egress_logical_port = 0;
+  PacketInMetadata meta;
+  ::util::Status status = bcm_sdk_interface_->ParseKnetHeaderForRx(
+      unit_, header, &ingress_logical_port, &egress_logical_port, &meta.cos);
+  if (!status.ok()) {
+    VLOG(1) << "Failed to parse KNET header for a packet on unit " << unit_
+            << ": " << status.error_message();
+    INCREMENT_RX_COUNTER(purpose, rx_drops_knet_header_parse_error);
+    return false;
+  }
+  // Find ingress port ID.
+  if (ingress_logical_port == kCpuLogicalPort) {
+    // This means CPU port by default.
+    meta.ingress_port_id = kCpuPortId;
+  } else {
+    uint32* ingress_port_id =
+        gtl::FindOrNull(logical_port_to_port_id_, ingress_logical_port);
+    if (ingress_port_id == nullptr) {
+      VLOG(1) << "Ingress logical port " << ingress_logical_port << " on unit "
+              << unit_ << " is unknown!";
+      INCREMENT_RX_COUNTER(purpose, rx_drops_unknown_ingress_port);
+      return false;
+    }
+    meta.ingress_port_id = *ingress_port_id;
+    auto ret =
+        bcm_chassis_ro_interface_->GetParentTrunkId(node_id_, *ingress_port_id);
+    if (ret.ok()) {
+      // If status is OK, there is a parent trunk.
+      meta.ingress_trunk_id = ret.ValueOrDie();
+    }
+  }
+  // Find egress port ID.
+  if (egress_logical_port == kCpuLogicalPort) {
+    // This means CPU port by default.
+    meta.egress_port_id = kCpuPortId;
+  } else if (egress_logical_port == 1) {
+    // SDKLT sets egress port to 1 for packets that do not match
+    // MY_STATION table or got dropped by the ASIC?
+    // TODO(unknown): check this and decide what to report upwards
+    meta.egress_port_id = 1;
+  } else {
+    uint32* egress_port_id =
+        gtl::FindOrNull(logical_port_to_port_id_, egress_logical_port);
+    if (egress_port_id == nullptr) {
+      VLOG(1) << "Egress logical port " << egress_logical_port << " on unit "
+              << unit_ << " is unknown!";
+      INCREMENT_RX_COUNTER(purpose, rx_drops_unknown_egress_port);
+      return false;
+    }
+    meta.egress_port_id = *egress_port_id;
+  }
+  VLOG(1) << "PacketInMetadata.ingress_port_id: " << meta.ingress_port_id
+          << "\n"
+          << "PacketInMetadata.ingress_trunk_id: " << meta.ingress_trunk_id
+          << "\n"
+          << "PacketInMetadata.egress_port_id: " << meta.egress_port_id << "\n"
+          << "PacketInMetadata.cos: " << meta.cos;
+  status = DeparsePacketInMetadata(meta, packet);
+  if (!status.ok()) {
+    INCREMENT_RX_COUNTER(purpose, rx_drops_metadata_deparse_error);
+    return false;
+  }
+  INCREMENT_RX_COUNTER(purpose, rx_accepts);
+
+  return true;
+}
+
+void BcmPacketioManager::HandleRxRingFrame(
+    GoogleConfig::BcmKnetIntfPurpose purpose, int netif_index,
+    size_t header_size, absl::string_view frame,
+    const struct sockaddr_ll& addr, bool truncated,
+    std::vector<::p4::v1::PacketIn>* packets) {
+  INCREMENT_RX_COUNTER(purpose, all_rx);
+  if (frame.size() < header_size) {
+    VLOG(1) << "Num of received bytes on netif  " << netif_index << " on unit "
+            << unit_ << " < " << header_size << ".";
+    INCREMENT_RX_COUNTER(purpose, rx_errors_incomplete_read);
+    return;
+  }
+  // Try to see if the frame looks OK. If not drop it.
+  if (truncated || addr.sll_ifindex != netif_index ||
+      addr.sll_pkttype == PACKET_OUTGOING) {
+    VLOG(1) << "Received invalid packet on netif  " << netif_index
+            << " on unit " << unit_ << ".";
+    INCREMENT_RX_COUNTER(purpose, rx_errors_invalid_packet);
+    return;
+  }
+  ::p4::v1::PacketIn packet;
+  AssignPayloadWithoutKnownVlanTag(frame.substr(header_size),
+                                   packet.mutable_payload());
+  if (ProcessRxPacket(purpose, frame.substr(0, header_size), &packet)) {
+    packets->push_back(std::move(packet));
+  }
+}
+
 ::util::StatusOr<bool> BcmPacketioManager::RxPacket(
     GoogleConfig::BcmKnetIntfPurpose purpose, int sock, int netif_index,
     std::string* header, std::string* payload) {
@@ -1220,26 +1321,8 @@ std::string BcmPacketioManager::GetKnetIntfNameTemplate(
   }
 
   // Strip some known VLAN tags.
-  struct ether_header* ether_header =
-      reinterpret_cast<struct ether_header*>(payload_buffer.get());
-  bool tagged = false;
-  if (payload_size >= sizeof(struct ether_header) + kVlanIdSize &&
-      ntohs(ether_header->ether_type) == ETHERTYPE_VLAN) {
-    auto* pid = reinterpret_cast<uint16*>(payload_buffer.get() +
-                                          sizeof(struct ether_header));
-    uint16 vlan = ntohs(*pid) & kVlanIdMask;
-    if (vlan == kDefaultVlan || vlan == kArpVlan || vlan == 0) {
-      tagged = true;
-    }
-  }
-
-  if (tagged) {
-    payload->assign(payload_buffer.get(), ETH_ALEN * 2);
-    payload->append(payload_buffer.get() + ETH_ALEN * 2 + kVlanTagSize,
-                    payload_size - ETH_ALEN * 2 - kVlanTagSize);
-  } else {
-    payload->assign(payload_buffer.get(), payload_size);
-  }
+  AssignPayloadWithoutKnownVlanTag(
+      absl::string_view(payload_buffer.get(), payload_size), payload);
   header->assign(header_buffer.get(), header_size);
 
   return true;
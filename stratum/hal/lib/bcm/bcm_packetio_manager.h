@@ -19,6 +19,7 @@
 #include "absl/base/thread_annotations.h"
 #include "absl/container/flat_hash_map.h"
 #include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
 #include "absl/synchronization/mutex.h"
 #include "p4/v1/p4runtime.pb.h"
 #include "stratum/glue/integral_types.h"
@@ -26,6 +27,7 @@
 #include "stratum/hal/lib/bcm/bcm.pb.h"
 #include "stratum/hal/lib/bcm/bcm_chassis_ro_interface.h"
 #include "stratum/hal/lib/bcm/bcm_global_vars.h"
+#include "stratum/hal/lib/bcm/bcm_knet_ring.h"
 #include "stratum/hal/lib/bcm/bcm_sdk_interface.h"
 #include "stratum/hal/lib/bcm/constants.h"
 #include "stratum/hal/lib/common/common.pb.h"
@@ -181,6 +183,8 @@ struct BcmKnetIntf {
   int tx_sock;
   // RX socket fd.
   int rx_sock;
+  // Memory mapped RX ring of the RX socket. Null if the rings are not used.
+  std::unique_ptr<BcmKnetRxRing> rx_ring;
   // The ID of the RX thread which is in charge of receiving the packets.
   pthread_t rx_thread_id;
   BcmKnetIntf()
@@ -194,6 +198,7 @@ struct BcmKnetIntf {
         filter_ids(),
         tx_sock(-1),
         rx_sock(-1),
+        rx_ring(),
         rx_thread_id() {}
 };
 
@@ -400,6 +405,23 @@ class BcmPacketioManager {
                                   int sock, int netif_index,
                                   std::string* header, std::string* payload);
 
+  // Helper called by HandleKnetIntfPacketRx() for every frame read from the RX
+  // ring of a KNET interface. Checks the frame, which points into the ring,
+  // and appends the resulting PacketIn to 'packets' unless it is dropped.
+  void HandleRxRingFrame(GoogleConfig::BcmKnetIntfPurpose purpose,
+                         int netif_index, size_t header_size,
+                         absl::string_view frame,
+                         const struct sockaddr_ll& addr, bool truncated,
+                         std::vector<::p4::v1::PacketIn>* packets)
+      SHARED_LOCKS_REQUIRED(chassis_lock);
+
+  // Parses the KNET header of a received packet and adds the corresponding
+  // metadata to the given PacketIn. Returns false if the packet is dropped,
+  // after incrementing the matching RX counter.
+  bool ProcessRxPacket(GoogleConfig::BcmKnetIntfPurpose purpose,
+                       absl::string_view header, ::p4::v1::PacketIn* packet)
+      SHARED_LOCKS_REQUIRED(chassis_lock);
+
   // Deparses the given PacketInMetadata to the a set of
   // P4 PacketMetadata protos in the given P4 PacketIn which
   // is then sent to the controller.
@@ -4,12 +4,22 @@
 
 #include "stratum/hal/lib/bcm/bcm_packetio_manager.h"
 
+#include <linux/if_packet.h>
+#include <net/if.h>
+#include <sys/ioctl.h>
+#include <sys/socket.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
 #include <functional>
 #include <string>
 
 #include "absl/memory/memory.h"
 #include "absl/strings/substitute.h"
 #include "absl/synchronization/mutex.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
+#include "gflags/gflags.h"
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
 #include "stratum/glue/status/status_test_util.h"
@@ -26,6 +36,8 @@
 // #include "util/libcproxy/libcwrapper.h"
 // #include "util/libcproxy/passthrough_proxy.h"
 
+DECLARE_bool(knet_use_packet_rings);
+
 namespace stratum {
 namespace hal {
 namespace bcm {
@@ -1946,6 +1958,225 @@ TEST_P(BcmPacketioManagerTest, TransmitPacketAfterChassisConfigPush) {
   }
 }
 
+TEST_P(BcmPacketioManagerTest,
+       ReceivePacketThroughRxRingAndTransmitPacketWithSendmsg) {
+  if (mode_ == OPERATION_MODE_SIM) return;  // no need to run in sim mode
+
+  // The RX socket is a real AF_PACKET socket with a real RX ring, bound to the
+  // loopback interface. The TX socket is mocked, TX does not use the rings.
+  // The libc wrapper sends the socket calls to the mock, so the real calls are
+  // made with syscall().
+  ::gflags::FlagSaver flag_saver;
+  FLAGS_knet_use_packet_rings = true;
+  LibcProxyMock* libc = LibcProxyMock::Instance();
+  const int lo_index = if_nametoindex("lo");
+  const int rx_sock = syscall(SYS_socket, AF_PACKET, SOCK_RAW, 0);
+  const int tx_sock = syscall(SYS_socket, AF_PACKET, SOCK_RAW, 0);
+  if (lo_index <= 0 || rx_sock < 0 || tx_sock < 0) {
+    if (rx_sock >= 0) syscall(SYS_close, rx_sock);
+    if (tx_sock >= 0) syscall(SYS_close, tx_sock);
+    GTEST_SKIP() << "No AF_PACKET sockets.";
+  }
+  auto real_close = [](int fd) {
+    return static_cast<int>(syscall(SYS_close, fd));
+  };
+
+  //--------------------------------------------------------------
+  // Config push
+  //--------------------------------------------------------------
+
+  ChassisConfig config;
+  std::map<uint32, SdkPort> port_id_to_sdk_port = {};
+  ASSERT_OK(PopulateChassisConfigAndPortMaps(kNodeId1, &config,
+                                             &port_id_to_sdk_port));
+  config.clear_vendor_config();  // default config
+
+  // Expected calls to BcmChassisManager for first config push.
+  EXPECT_CALL(*bcm_chassis_ro_mock_, GetPortIdToSdkPortMap(kNodeId1))
+      .WillOnce(Return(port_id_to_sdk_port));
+
+  // Track the socket FDs;
+  libc->TrackFds({kSocket1, kEfd, rx_sock});
+
+  // Expected libc calls for config push. The KNET interface is the loopback
+  // interface.
+  EXPECT_CALL(*libc, Socket(_, _, _))
+      .Times(3)
+      .WillOnce(Return(kSocket1))
+      .WillOnce(Return(kSocket1))
+      .WillOnce(Return(rx_sock));
+  EXPECT_CALL(*libc, Ioctl(kSocket1, _, _)).Times(3).WillRepeatedly(Return(0));
+  EXPECT_CALL(*libc, Ioctl(kSocket1, SIOCGIFINDEX, _))
+      .WillOnce(DoAll(WithArgs<2>(Invoke([lo_index](void* arg) {
+                        static_cast<struct ifreq*>(arg)->ifr_ifindex =
+                            lo_index;
+                      })),
+                      Return(0)));
+  EXPECT_CALL(*libc, Close(kSocket1)).WillOnce(Return(0));
+  // The RX ring and the BPF filter are set up for real. SO_RCVBUFFORCE needs
+  // CAP_NET_ADMIN, it is not needed by the test.
+  EXPECT_CALL(*libc, SetSockOpt(rx_sock, _, _, _, _))
+      .WillRepeatedly(Invoke([](int sockfd, int level, int optname,
+                                const void* optval, socklen_t optlen) {
+        return static_cast<int>(
+            syscall(SYS_setsockopt, sockfd, level, optname, optval, optlen));
+      }));
+  EXPECT_CALL(*libc, SetSockOpt(rx_sock, SOL_SOCKET, SO_RCVBUFFORCE, _, _))
+      .WillOnce(Return(0));
+  EXPECT_CALL(*libc, Bind(rx_sock, _, _))
+      .WillOnce(Invoke([](int sockfd, const struct sockaddr* my_addr,
+                          socklen_t addrlen) {
+        return static_cast<int>(syscall(SYS_bind, sockfd, my_addr, addrlen));
+      }));
+
+  // Expected calls to BcmSdkInterface for config push.
+  EXPECT_CALL(*bcm_sdk_mock_, StartRx(kUnit1, _))
+      .WillOnce(Return(::util::OkStatus()));
+  EXPECT_CALL(*bcm_sdk_mock_, CreateKnetIntf(kUnit1, kDefaultVlan, _, _))
+      .WillRepeatedly(
+          DoAll(SetArgPointee<3>(kNetifId), Return(::util::OkStatus())));
+  EXPECT_CALL(*bcm_sdk_mock_, CreateKnetFilter(kUnit1, _, kFilterTypeCatchAll))
+      .WillOnce(Return(kCatchAllFilterId1));
+
+  // libc calls triggered by RX thread.
+  EXPECT_CALL(*libc, EpollCreate1(0)).WillRepeatedly(Return(kEfd));
+  EXPECT_CALL(*libc, EpollCtl(kEfd, EPOLL_CTL_ADD, rx_sock, _))
+      .WillRepeatedly(Return(0));
+  EXPECT_CALL(*libc, EpollWait(kEfd, _, 1, _))
+      .WillRepeatedly(DoAll(WithArgs<1>(Invoke([](struct epoll_event* p) {
+                              p[0].events = EPOLLIN;
+                            })),
+                            Return(1)));  // 1 means RX packet is available
+
+  // BcmSdkInterface calls triggered by RX thread.
+  EXPECT_CALL(*bcm_sdk_mock_, GetKnetHeaderSizeForRx(kUnit1))
+      .WillRepeatedly(Return(kTestKnetHeaderSize));
+  EXPECT_CALL(*bcm_sdk_mock_, ParseKnetHeaderForRx(kUnit1, _, _, _, _))
+      .WillRepeatedly(DoAll(SetArgPointee<2>(kLogicalPort1),
+                            SetArgPointee<3>(kCpuLogicalPort),
+                            SetArgPointee<4>(5), Return(::util::OkStatus())));
+
+  // BcmChassisRoInterface calls triggered by RX thread.
+  EXPECT_CALL(*bcm_chassis_ro_mock_, GetParentTrunkId(kNodeId1, kPortId1))
+      .WillRepeatedly(Return(::util::Status(StratumErrorSpace(),
+                                            ERR_ENTRY_NOT_FOUND, "no trunk")));
+
+  // P4TableMapper calls triggered by RX thread.
+  EXPECT_CALL(*p4_table_mapper_mock_, DeparsePacketInMetadata(_, _))
+      .WillRepeatedly(Return(::util::OkStatus()));
+
+  // Call PushChassisConfig to initialize the class. The RX thread will be
+  // initialized as part of config push.
+  ASSERT_OK(PushChassisConfig(config, kNodeId1));
+
+  //--------------------------------------------------------------
+  // Packet RX
+  //--------------------------------------------------------------
+
+  // The payload has no VLAN tag, so it is received unchanged.
+  const std::string payload =
+      std::string(kTestPacket, ETH_ALEN * 2) +
+      std::string(kTestPacket + ETH_ALEN * 2 + kVlanTagSize,
+                  sizeof(kTestPacket) - ETH_ALEN * 2 - kVlanTagSize);
+  auto writer = std::make_shared<WriterMock<::p4::v1::PacketIn>>();
+  EXPECT_CALL(*writer, Write(_))
+      .WillRepeatedly(Invoke([this, &payload](const ::p4::v1::PacketIn& msg) {
+        // Other packets may be seen on the loopback interface.
+        if (msg.payload() == payload) {
+          absl::WriterMutexLock l(&rx_lock_);
+          rx_complete_ = true;
+        }
+        return true;
+      }));
+  ASSERT_OK(RegisterPacketReceiveWriter(
+      GoogleConfig::BCM_KNET_INTF_PURPOSE_CONTROLLER, writer));
+
+  // The packet is sent on the loopback interface, behind a fake KNET header
+  // starting with an Ethernet header.
+  std::string frame(kTestKnetHeaderSize, '\x02');
+  frame[ETH_ALEN * 2] = '\x88';
+  frame[ETH_ALEN * 2 + 1] = '\xb5';  // local experimental ether type
+  frame += payload;
+  struct sockaddr_ll addr;
+  memset(&addr, 0, sizeof(addr));
+  addr.sll_family = AF_PACKET;
+  addr.sll_ifindex = lo_index;
+  addr.sll_halen = ETH_ALEN;
+  ASSERT_EQ(static_cast<ssize_t>(frame.size()),
+            sendto(tx_sock, frame.data(), frame.size(), 0,
+                   reinterpret_cast<struct sockaddr*>(&addr), sizeof(addr)));
+  for (int i = 0; i < 500 && !RxComplete(); ++i) {
+    absl::SleepFor(absl::Milliseconds(10));
+  }
+  EXPECT_TRUE(RxComplete());
+  real_close(tx_sock);
+
+  {
+    SCOPED_TRACE(bcm_packetio_manager_->DumpStats());
+    CHECK_NON_ZERO_RX_COUNTER(GoogleConfig::BCM_KNET_INTF_PURPOSE_CONTROLLER,
+                              all_rx);
+    CHECK_NON_ZERO_RX_COUNTER(GoogleConfig::BCM_KNET_INTF_PURPOSE_CONTROLLER,
+                              rx_accepts);
+    CHECK_ZERO_RX_COUNTER(GoogleConfig::BCM_KNET_INTF_PURPOSE_CONTROLLER,
+                          rx_errors_internal_read_failures);
+  }
+
+  //--------------------------------------------------------------
+  // Packet TX
+  //--------------------------------------------------------------
+
+  ::p4::v1::PacketOut packet;
+  packet.set_payload(std::string(kTestPacket, sizeof(kTestPacket)));
+  ASSERT_OK(ParseProtoFromString(kTestPacketMetadata1, packet.add_metadata()));
+
+  EXPECT_CALL(*p4_table_mapper_mock_,
+              ParsePacketOutMetadata(EqualsProto(packet.metadata(0)), _))
+      .WillOnce(DoAll(WithArgs<1>(Invoke([](MappedPacketMetadata* x) {
+                        x->set_type(P4_FIELD_TYPE_EGRESS_PORT);
+                        x->set_u32(kPortId1);
+                      })),
+                      Return(::util::OkStatus())));
+  EXPECT_CALL(*bcm_chassis_ro_mock_, GetPortState(kNodeId1, kPortId1))
+      .WillOnce(Return(PORT_STATE_UP));
+  EXPECT_CALL(*bcm_sdk_mock_, GetKnetHeaderForDirectTx(kUnit1, kLogicalPort1,
+                                                       kDefaultCos, _, _, _))
+      .WillOnce(Return(::util::OkStatus()));
+  EXPECT_CALL(*libc, SendMsg(kSocket1, _, _))
+      .WillOnce(Return(64));  // 64 is tot_len of the packet.
+
+  ASSERT_OK(
+      TransmitPacket(GoogleConfig::BCM_KNET_INTF_PURPOSE_CONTROLLER, packet));
+
+  {
+    SCOPED_TRACE(bcm_packetio_manager_->DumpStats());
+    CHECK_NON_ZERO_TX_COUNTER(GoogleConfig::BCM_KNET_INTF_PURPOSE_CONTROLLER,
+                              tx_accepts_direct);
+    CHECK_ZERO_TX_COUNTER(GoogleConfig::BCM_KNET_INTF_PURPOSE_CONTROLLER,
+                          tx_errors_internal_send_failures);
+  }
+
+  //--------------------------------------------------------------
+  // Shutdown
+  //--------------------------------------------------------------
+
+  // Expected libc calls for shutdown.
+  EXPECT_CALL(*libc, Close(kSocket1)).WillOnce(Return(0));
+  EXPECT_CALL(*libc, Close(rx_sock)).WillOnce(Invoke(real_close));
+
+  // Expected calls to BcmSdkInterface for shutdown.
+  EXPECT_CALL(*bcm_sdk_mock_, StopRx(kUnit1))
+      .WillOnce(Return(::util::OkStatus()));
+  EXPECT_CALL(*bcm_sdk_mock_, DestroyKnetFilter(kUnit1, kCatchAllFilterId1))
+      .WillOnce(Return(::util::OkStatus()));
+  EXPECT_CALL(*bcm_sdk_mock_, DestroyKnetIntf(kUnit1, kNetifId))
+      .WillOnce(Return(::util::OkStatus()));
+
+  // libc calls triggered by RX thread.
+  EXPECT_CALL(*libc, Close(kEfd)).WillRepeatedly(Return(0));
+
+  ASSERT_OK(Shutdown());
+}
+
 INSTANTIATE_TEST_SUITE_P(BcmPacketioManagerTestWithMode, BcmPacketioManagerTest,
                          ::testing::Values(OPERATION_MODE_STANDALONE,
                                            OPERATION_MODE_COUPLED,
@@ -12,6 +12,7 @@
 #include <string>
 #include <vector>
 
+#include "absl/strings/string_view.h"
 #include "stratum/glue/integral_types.h"
 #include "stratum/glue/status/status.h"
 #include "stratum/glue/status/statusor.h"
@@ -588,9 +589,10 @@ class BcmSdkInterface {
   virtual size_t GetKnetHeaderSizeForRx(int unit) = 0;
 
   // Parses the fixed-size KNET header from a port and determines where and
-  // how the packet was received.
+  // how the packet was received. The header may point into a packet ring
+  // and is only valid for the duration of the call.
   virtual ::util::Status ParseKnetHeaderForRx(int unit,
-                                              const std::string& header,
+                                              absl::string_view header,
                                               int* ingress_logical_port,
                                               int* egress_logical_port,
                                               int* cos) = 0;
@@ -183,7 +183,7 @@ class BcmSdkMock : public BcmSdkInterface {
                               std::string* header));
   MOCK_METHOD1(GetKnetHeaderSizeForRx, size_t(int unit));
   MOCK_METHOD5(ParseKnetHeaderForRx,
-               ::util::Status(int unit, const std::string& header,
+               ::util::Status(int unit, absl::string_view header,
                               int* ingress_logical_port,
                               int* egress_logical_port, int* cos));
   MOCK_METHOD1(InitAclHardware, ::util::Status(int unit));
@@ -175,7 +175,7 @@ BcmSdkSim::~BcmSdkSim() { ShutdownAllUnits().IgnoreError(); }
 size_t BcmSdkSim::GetKnetHeaderSizeForRx(int unit) { return 0; }
 
 ::util::Status BcmSdkSim::ParseKnetHeaderForRx(int unit,
-                                               const std::string& header,
+                                               absl::string_view header,
                                                int* ingress_logical_port,
                                                int* egress_logical_port,
                                                int* cos) {
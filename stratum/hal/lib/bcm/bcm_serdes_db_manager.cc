@@ -4,8 +4,11 @@
 
 #include "stratum/hal/lib/bcm/bcm_serdes_db_manager.h"
 
+#include <algorithm>
+
 #include "absl/memory/memory.h"
 #include "gflags/gflags.h"
+#include "stratum/glue/gtl/map_util.h"
 #include "stratum/glue/integral_types.h"
 #include "stratum/glue/logging.h"
 #include "stratum/hal/lib/bcm/utils.h"
@@ -22,29 +25,9 @@ namespace bcm {
 
 namespace {
 
-// A helper that returns true if a given front panel port info and port speed
-// matches a given BcmSerdesDbEntry.
-static bool PortMatch(const FrontPanelPortInfo& fp_port_info, uint64 speed_bps,
-                      const BcmSerdesDbEntry& serdes_db_entry) {
-  if (serdes_db_entry.media_type() == fp_port_info.media_type() &&
-      serdes_db_entry.vendor_name() == fp_port_info.vendor_name() &&
-      serdes_db_entry.speed_bps() == speed_bps) {
-    // See if we match any of the part_numbers in BcmSerdesDbEntry matches the
-    // one in FrontPanelPortInfo. If there is no part_number, we make sure
-    // BcmSerdesDbEntry does not have any part number either. An example of
-    // such case is backplane ports in superchassis like BG16.
-    if (fp_port_info.part_number().empty() &&
-        serdes_db_entry.part_numbers_size() == 0) {
-      return true;
-    }
-    for (const auto& part_number : serdes_db_entry.part_numbers()) {
-      if (fp_port_info.part_number() == part_number) {
-        return true;
-      }
-    }
-  }
-  return false;
-}
+// Upper bound of the unit, serdes core, and serdes lane numbers in the serdes
+// DB, which are used as indexes of the flattened configs.
+constexpr int kMaxSerdesDbIndex = 1024;
 
 }  // namespace
 
@@ -53,55 +36,125 @@ BcmSerdesDbManager::BcmSerdesDbManager() {}
 BcmSerdesDbManager::~BcmSerdesDbManager() {}
 
 ::util::Status BcmSerdesDbManager::Load() {
+  serdes_board_indexes_.clear();
+  serdes_db_entry_indexes_.clear();
   RETURN_IF_ERROR(
       ReadProtoFromBinFile(FLAGS_bcm_serdes_db_proto_file, &bcm_serdes_db_));
-  return ::util::OkStatus();
+  ::util::Status status = BuildSerdesDbIndex();
+  if (!status.ok()) {
+    serdes_board_indexes_.clear();
+    serdes_db_entry_indexes_.clear();
+  }
+
+  return status;
 }
 
 ::util::Status BcmSerdesDbManager::LookupSerdesConfigForPort(
     const BcmPort& bcm_port, const FrontPanelPortInfo& fp_port_info,
     BcmSerdesLaneConfig* bcm_serdes_lane_config) const {
+  const int* entry_index = gtl::FindOrNull(
+      serdes_db_entry_indexes_,
+      SerdesDbKey(fp_port_info.media_type(), fp_port_info.vendor_name(),
+                  fp_port_info.part_number(), bcm_port.speed_bps()));
+  if (entry_index == nullptr) {
+    return MAKE_ERROR(ERR_INTERNAL)
+           << "Could not find serdes lane info for " << PrintBcmPort(bcm_port)
+           << " with following front panel port info: "
+           << fp_port_info.ShortDebugString();
+  }
+  const SerdesBoardIndex& board = serdes_board_indexes_[*entry_index];
+  const int unit = bcm_port.unit();
+  RET_CHECK(unit >= 0 && unit < static_cast<int>(board.size()) &&
+            board[unit].chip_config != nullptr)
+      << "Unit " << unit << " not found in serdes DB for "
+      << PrintBcmPort(bcm_port) << " with following front panel port info: "
+      << fp_port_info.ShortDebugString();
+  const int core = bcm_port.serdes_core();
+  const auto& cores = board[unit].cores;
+  RET_CHECK(core >= 0 && core < static_cast<int>(cores.size()) &&
+            cores[core].core_config != nullptr)
+      << "Serdes core " << core << " not found in serdes "
+      << "DB for " << PrintBcmPort(bcm_port) << " with following front "
+      << "panel port info: " << fp_port_info.ShortDebugString();
+  const SerdesCoreIndex& core_index = cores[core];
+  const auto& lane_configs = core_index.lane_configs;
+  const int first_lane = bcm_port.serdes_lane();
+  for (int l = 0; l < std::max(bcm_port.num_serdes_lanes(), 1); ++l) {
+    const int lane = first_lane + l;
+    RET_CHECK(lane >= 0 && lane < static_cast<int>(lane_configs.size()) &&
+              lane_configs[lane] != nullptr)
+        << "Serdes lane " << lane << " not found in "
+        << "serdes DB for " << PrintBcmPort(bcm_port) << " with following "
+        << "front panel port info: " << fp_port_info.ShortDebugString();
+    // All the lanes must have the same config, i.e. each lane must have the
+    // same config as the previous one.
+    RET_CHECK(l == 0 || core_index.same_as_previous_lane[lane])
+        << "Serdes lane configs found for " << PrintBcmPort(bcm_port)
+        << " do not have the same value for all the lanes: "
+        << core_index.core_config->ShortDebugString();
+  }
+  *bcm_serdes_lane_config = *lane_configs[first_lane];
+
+  return ::util::OkStatus();
+}
+
+::util::Status BcmSerdesDbManager::BuildSerdesDbIndex() {
   for (const auto& e : bcm_serdes_db_.bcm_serdes_db_entries()) {
-    if (PortMatch(fp_port_info, bcm_port.speed_bps(), e)) {
-      const auto& serdes_chip_configs =
-          e.bcm_serdes_board_config().bcm_serdes_chip_configs();
-      auto i = serdes_chip_configs.find(bcm_port.unit());
-      RET_CHECK(i != serdes_chip_configs.end())
-          << "Unit " << bcm_port.unit() << " not found in serdes DB for "
-          << PrintBcmPort(bcm_port) << " with following front panel port info: "
-          << fp_port_info.ShortDebugString();
-      const auto& serdes_core_configs = i->second.bcm_serdes_core_configs();
-      auto j = serdes_core_configs.find(bcm_port.serdes_core());
-      RET_CHECK(j != serdes_core_configs.end())
-          << "Serdes core " << bcm_port.serdes_core() << " not found in serdes "
-          << "DB for " << PrintBcmPort(bcm_port) << " with following front "
-          << "panel port info: " << fp_port_info.ShortDebugString();
-      const auto& serdes_lane_configs = j->second.bcm_serdes_lane_configs();
-      auto k = serdes_lane_configs.find(bcm_port.serdes_lane());
-      RET_CHECK(k != serdes_lane_configs.end())
-          << "Serdes lane " << bcm_port.serdes_lane() << " not found in "
-          << "serdes DB for " << PrintBcmPort(bcm_port) << " with following "
-          << "front panel port info: " << fp_port_info.ShortDebugString();
-      *bcm_serdes_lane_config = k->second;
-      for (int l = 1; l < bcm_port.num_serdes_lanes(); ++l) {
-        auto k = serdes_lane_configs.find(bcm_port.serdes_lane() + l);
-        RET_CHECK(k != serdes_lane_configs.end())
-            << "Serdes lane " << bcm_port.serdes_lane() + l << " not found in "
-            << "serdes DB for " << PrintBcmPort(bcm_port) << " with following "
-            << "front panel port info: " << fp_port_info.ShortDebugString();
-        RET_CHECK(ProtoEqual(*bcm_serdes_lane_config, k->second))
-            << "Serdes lane configs found for " << PrintBcmPort(bcm_port)
-            << " do not have the same value for all the lanes: "
-            << j->second.ShortDebugString();
+    const int entry_index = serdes_board_indexes_.size();
+    serdes_board_indexes_.emplace_back();
+    SerdesBoardIndex* board = &serdes_board_indexes_.back();
+    const auto& serdes_chip_configs =
+        e.bcm_serdes_board_config().bcm_serdes_chip_configs();
+    for (const auto& chip : serdes_chip_configs) {
+      const int unit = chip.first;
+      RET_CHECK(unit >= 0 && unit < kMaxSerdesDbIndex)
+          << "Invalid unit " << unit << " in serdes DB.";
+      if (unit >= static_cast<int>(board->size())) board->resize(unit + 1);
+      SerdesChipIndex* chip_index = &(*board)[unit];
+      chip_index->chip_config = &chip.second;
+      for (const auto& core : chip.second.bcm_serdes_core_configs()) {
+        const int core_id = core.first;
+        RET_CHECK(core_id >= 0 && core_id < kMaxSerdesDbIndex)
+            << "Invalid serdes core " << core_id << " in serdes DB.";
+        if (core_id >= static_cast<int>(chip_index->cores.size())) {
+          chip_index->cores.resize(core_id + 1);
+        }
+        SerdesCoreIndex* core_index = &chip_index->cores[core_id];
+        core_index->core_config = &core.second;
+        auto& lane_configs = core_index->lane_configs;
+        for (const auto& lane : core.second.bcm_serdes_lane_configs()) {
+          RET_CHECK(lane.first >= 0 && lane.first < kMaxSerdesDbIndex)
+              << "Invalid serdes lane " << lane.first << " in serdes DB.";
+          if (lane.first >= static_cast<int>(lane_configs.size())) {
+            lane_configs.resize(lane.first + 1, nullptr);
+          }
+          lane_configs[lane.first] = &lane.second;
+        }
+        core_index->same_as_previous_lane.resize(lane_configs.size(), false);
+        for (size_t l = 1; l < lane_configs.size(); ++l) {
+          core_index->same_as_previous_lane[l] =
+              lane_configs[l] != nullptr && lane_configs[l - 1] != nullptr &&
+              ProtoEqual(*lane_configs[l], *lane_configs[l - 1]);
+        }
       }
-      return ::util::OkStatus();
+    }
+
+    // An entry without part numbers matches the ports without part number,
+    // e.g. the backplane ports in superchassis like BG16.
+    if (e.part_numbers_size() == 0) {
+      serdes_db_entry_indexes_.emplace(
+          SerdesDbKey(e.media_type(), e.vendor_name(), "", e.speed_bps()),
+          entry_index);
+    }
+    for (const auto& part_number : e.part_numbers()) {
+      serdes_db_entry_indexes_.emplace(
+          SerdesDbKey(e.media_type(), e.vendor_name(), part_number,
+                      e.speed_bps()),
+          entry_index);
     }
   }
 
-  return MAKE_ERROR(ERR_INTERNAL)
-         << "Could not find serdes lane info for " << PrintBcmPort(bcm_port)
-         << " with following front panel port info: "
-         << fp_port_info.ShortDebugString();
+  return ::util::OkStatus();
 }
 
 std::unique_ptr<BcmSerdesDbManager> BcmSerdesDbManager::CreateInstance() {
@@ -6,8 +6,13 @@
 #define STRATUM_HAL_LIB_BCM_BCM_SERDES_DB_MANAGER_H_
 
 #include <memory>
+#include <string>
+#include <tuple>
+#include <vector>
 
+#include "absl/container/flat_hash_map.h"
 #include "absl/synchronization/mutex.h"
+#include "stratum/glue/integral_types.h"
 #include "stratum/glue/status/status.h"
 #include "stratum/hal/lib/bcm/bcm.pb.h"
 #include "stratum/hal/lib/common/common.pb.h"
@@ -22,11 +27,11 @@ class BcmSerdesDbManager {
  public:
   virtual ~BcmSerdesDbManager();
 
-  // Loades bcm_serdes_db_ from file.
+  // Loades bcm_serdes_db_ from file and indexes it for the lookups.
   virtual ::util::Status Load();
 
   // Looks up the serdes config for a given BCM port given its frontpanel port
-  // info.
+  // info. The lookup does not depend on the size of the serdes DB.
   virtual ::util::Status LookupSerdesConfigForPort(
       const BcmPort& bcm_port, const FrontPanelPortInfo& fp_port_info,
       BcmSerdesLaneConfig* bcm_serdes_lane_config) const;
@@ -43,8 +48,45 @@ class BcmSerdesDbManager {
   BcmSerdesDbManager();
 
  private:
+  // The serdes configs of a serdes core, by serdes lane.
+  struct SerdesCoreIndex {
+    // nullptr if the core is not in the serdes DB.
+    const BcmSerdesCoreConfig* core_config = nullptr;
+    // The config of each lane, nullptr if the lane is not in the serdes DB.
+    std::vector<const BcmSerdesLaneConfig*> lane_configs;
+    // Whether the config of each lane is the same as the one of the previous
+    // lane.
+    std::vector<bool> same_as_previous_lane;
+  };
+
+  // The serdes configs of a chip, by serdes core.
+  struct SerdesChipIndex {
+    // nullptr if the chip is not in the serdes DB.
+    const BcmSerdesChipConfig* chip_config = nullptr;
+    std::vector<SerdesCoreIndex> cores;
+  };
+
+  // The serdes configs of a serdes DB entry, flattened by unit, serdes core
+  // and serdes lane.
+  using SerdesBoardIndex = std::vector<SerdesChipIndex>;
+
+  // The media type, vendor name, part number and speed in bps of a port.
+  using SerdesDbKey = std::tuple<int, std::string, std::string, uint64>;
+
+  // Builds serdes_board_indexes_ and serdes_db_entry_indexes_ from
+  // bcm_serdes_db_.
+  ::util::Status BuildSerdesDbIndex();
+
   // A copy of the running version of the serdes DB, read from file.
   BcmSerdesDb bcm_serdes_db_;
+
+  // The flattened serdes configs of each entry of bcm_serdes_db_, in the same
+  // order.
+  std::vector<SerdesBoardIndex> serdes_board_indexes_;
+
+  // Map from the key of a port to the index of its serdes DB entry. If several
+  // entries match a port, the first one is used.
+  absl::flat_hash_map<SerdesDbKey, int> serdes_db_entry_indexes_;
 };
 
 }  // namespace bcm
@@ -208,6 +208,38 @@ TEST_F(BcmSerdesDbManagerTest, LoadFailure) {
   EXPECT_FALSE(bcm_serdes_db_manager_->Load().ok());
 }
 
+TEST_F(BcmSerdesDbManagerTest, LoadFailureWhenSerdesLaneIsInvalid) {
+  BcmSerdesDb bcm_serdes_db;
+  const std::string bcm_serdes_db_text = R"(
+    bcm_serdes_db_entries {
+      media_type: MEDIA_TYPE_QSFP_SR4
+      vendor_name: "vendor_1"
+      speed_bps: 20000000000
+      bcm_serdes_board_config {
+        bcm_serdes_chip_configs {
+          value {
+            bcm_serdes_core_configs {
+              value {
+                bcm_serdes_lane_configs {
+                  key: -1
+                  value {
+                    intf_type: "sr"
+                  }
+                }
+              }
+            }
+          }
+        }
+      }
+    }
+  )";
+  ASSERT_OK(ParseProtoFromString(bcm_serdes_db_text, &bcm_serdes_db));
+  ASSERT_OK(WriteProtoToBinFile(bcm_serdes_db, FLAGS_bcm_serdes_db_proto_file));
+  ::util::Status status = bcm_serdes_db_manager_->Load();
+  EXPECT_FALSE(status.ok());
+  EXPECT_THAT(status.error_message(), HasSubstr("Invalid serdes lane -1"));
+}
+
 TEST_F(BcmSerdesDbManagerTest, LookupSerdesConfigForPortSuccess) {
   SaveTestBcmSerdesDb();
   ASSERT_OK(bcm_serdes_db_manager_->Load());
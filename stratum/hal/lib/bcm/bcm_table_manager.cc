@@ -10,6 +10,7 @@
 #include "absl/container/flat_hash_set.h"
 #include "absl/memory/memory.h"
 #include "absl/strings/str_cat.h"
+#include "google/protobuf/arena.h"
 #include "google/protobuf/message.h"
 #include "google/protobuf/repeated_field.h"
 #include "stratum/glue/gtl/map_util.h"
@@ -628,25 +629,39 @@ BcmTableManager::ConstConditionsToBcmFields(const AclTable& table) {
 ::util::Status BcmTableManager::FillBcmFlowEntry(
     const ::p4::v1::TableEntry& table_entry, ::p4::v1::Update::Type type,
     BcmFlowEntry* bcm_flow_entry) const {
-  std::string error_message =
-      " TableEntry is " + table_entry.ShortDebugString() + ".";
+  // The TableEntry is only printed on the error paths, so the debug string is
+  // built lazily rather than for every flow.
+  auto error_message = [&table_entry]() {
+    return absl::StrCat(" TableEntry is ", table_entry.ShortDebugString(),
+                        ".");
+  };
 
   RET_CHECK(table_entry.table_id())
-      << "Must specify table_id for each TableEntry." << error_message;
+      << "Must specify table_id for each TableEntry." << error_message();
   // Fill the CommonFlowEntry by calling P4TableMapper::MapFlowEntry(). This
-  // will include all the mappings that are common to all the platforms.
-  CommonFlowEntry common_flow_entry;
+  // will include all the mappings that are common to all the platforms. The
+  // CommonFlowEntry is only needed for the duration of this call, so it and
+  // its sub-messages are allocated in an arena whose first block lives on the
+  // stack. Typical flows are therefore mapped without heap allocations.
+  constexpr size_t kCommonFlowEntryArenaBlockSize = 2048;
+  char arena_block[kCommonFlowEntryArenaBlockSize];
+  ::google::protobuf::ArenaOptions arena_options;
+  arena_options.initial_block = arena_block;
+  arena_options.initial_block_size = sizeof(arena_block);
+  ::google::protobuf::Arena arena(arena_options);
+  CommonFlowEntry* common_flow_entry =
+      ::google::protobuf::Arena::CreateMessage<CommonFlowEntry>(&arena);
   RETURN_IF_ERROR_WITH_APPEND(
-      p4_table_mapper_->MapFlowEntry(table_entry, type, &common_flow_entry))
-      << error_message;
+      p4_table_mapper_->MapFlowEntry(table_entry, type, common_flow_entry))
+      << error_message();
   RETURN_IF_ERROR_WITH_APPEND(
-      CommonFlowEntryToBcmFlowEntry(common_flow_entry, type, bcm_flow_entry))
-      << error_message;
+      CommonFlowEntryToBcmFlowEntry(*common_flow_entry, type, bcm_flow_entry))
+      << error_message();
 
   // We do not support initializing flow packet counter values.
   RET_CHECK(!table_entry.has_counter_data())
       << "Unsupported counter initialization given in TableEntry."
-      << error_message;
+      << error_message();
 
   // Transfer meter configuration. For DELETE, this is redundant data and is
   // not used.
@@ -654,11 +669,11 @@ BcmTableManager::ConstConditionsToBcmFields(const AclTable& table) {
     // Meters are only available for ACL flows.
     if (bcm_flow_entry->bcm_table_type() != BcmFlowEntry::BCM_TABLE_ACL) {
       return MAKE_ERROR(ERR_INVALID_PARAM)
-             << "Metering is only supported for ACL flows." << error_message;
+             << "Metering is only supported for ACL flows." << error_message();
     }
     RETURN_IF_ERROR_WITH_APPEND(FillBcmMeterConfig(
         table_entry.meter_config(), bcm_flow_entry->mutable_meter()))
-        << error_message;
+        << error_message();
   }
 
   return ::util::OkStatus();
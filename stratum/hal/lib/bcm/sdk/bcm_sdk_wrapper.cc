@@ -2638,7 +2638,7 @@ size_t BcmSdkWrapper::GetKnetHeaderSizeForRx(int unit) {
 }
 
 ::util::Status BcmSdkWrapper::ParseKnetHeaderForRx(int unit,
-                                                   const std::string& header,
+                                                   absl::string_view header,
                                                    int* ingress_logical_port,
                                                    int* egress_logical_port,
                                                    int* cos) {
@@ -4799,7 +4799,7 @@ static void dumpRxpmdHeaderRaw(const void* rxpmd) {
 }
 
 ::util::Status BcmSdkWrapper::ParseKnetHeaderForRx(int unit,
-                                                   const std::string& header,
+                                                   absl::string_view header,
                                                    int* ingress_logical_port,
                                                    int* egress_logical_port,
                                                    int* cos) {
@@ -4844,7 +4844,7 @@ static void dumpRxpmdHeaderRaw(const void* rxpmd) {
   bcmdrd_dev_type_t dev_type;
   uint32 val;
   RETURN_IF_BCM_ERROR(bcmpkt_dev_type_get(unit, &dev_type));
-  uint32* meta = reinterpret_cast<uint32*>(const_cast<char*>(&header[0]) +
+  uint32* meta = reinterpret_cast<uint32*>(const_cast<char*>(header.data()) +
                                            sizeof(RcpuHeader));
   RETURN_IF_BCM_ERROR(
       bcmpkt_rxpmd_field_get(dev_type, meta, BCMPKT_RXPMD_CPU_COS, &val));
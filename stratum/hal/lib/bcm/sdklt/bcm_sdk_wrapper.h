@@ -226,7 +226,7 @@ class BcmSdkWrapper : public BcmSdkInterface {
   ::util::Status GetKnetHeaderForIngressPipelineTx(
       int unit, uint64 smac, size_t packet_len, std::string* header) override;
   size_t GetKnetHeaderSizeForRx(int unit) override;
-  ::util::Status ParseKnetHeaderForRx(int unit, const std::string& header,
+  ::util::Status ParseKnetHeaderForRx(int unit, absl::string_view header,
                                       int* ingress_logical_port,
                                       int* egress_logical_port,
                                       int* cos) override;
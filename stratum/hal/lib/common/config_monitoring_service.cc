@@ -21,6 +21,7 @@
 #include "stratum/glue/status/status_macros.h"
 #include "stratum/hal/lib/common/gnmi_publisher.h"
 #include "stratum/hal/lib/common/openconfig_converter.h"
+#include "stratum/hal/lib/common/server_stream_reactor.h"
 #include "stratum/hal/lib/common/target_options.h"
 #include "stratum/lib/macros.h"
 #include "stratum/lib/utils.h"
@@ -34,6 +35,13 @@ DEFINE_string(chassis_config_file, "",
               "flags.");
 DEFINE_string(gnmi_capabilities_file, "/etc/stratum/gnmi_caps.pb.txt",
               "Path to the file containing the gNMI capabilities proto.");
+DEFINE_uint32(gnmi_subscribe_max_pending_responses, 1024,
+              "Max number of responses queued for sending on a gNMI Subscribe "
+              "stream. Updates to a client that can't keep up are dropped "
+              "beyond this. 0 means no limit.");
+DEFINE_int32(gnmi_subscribe_num_threads, 4,
+             "Number of threads handling the requests of the gNMI Subscribe "
+             "streams, e.g. the polls, which can block on the switch.");
 
 namespace stratum {
 namespace hal {
@@ -55,7 +63,8 @@ ConfigMonitoringService::ConfigMonitoringService(
       auth_policy_checker_(ABSL_DIE_IF_NULL(auth_policy_checker)),
       error_buffer_(ABSL_DIE_IF_NULL(error_buffer)),
       gnmi_publisher_(switch_interface),
-      target_options_(target_options) {
+      target_options_(target_options),
+      subscribe_executor_(FLAGS_gnmi_subscribe_num_threads) {
   if (TimerDaemon::Start() != ::util::OkStatus()) {
     LOG(ERROR) << "Could not start the timer subsystem.";
   }
@@ -388,19 +397,12 @@ bool ContainsUniqueNames(const T& values) {
   return ::grpc::Status::OK;
 }
 
-::grpc::Status ConfigMonitoringService::Subscribe(
-    ::grpc::ServerContext* context, ServerSubscribeReaderWriter* stream) {
-  RETURN_IF_NOT_AUTHORIZED(auth_policy_checker_, ConfigMonitoringService,
-                           Subscribe, context);
-  return DoSubscribe(&gnmi_publisher_, context, stream);
-}
-
 namespace {
 
 // A helper method that logs an error message and then sends the same message to
 // the client.
 void ReportError(const std::string& msg,
-                 ServerSubscribeReaderWriterInterface* stream) {
+                 GnmiSubscribeStream* stream) {
   LOG(ERROR) << msg;
   // Report error to the remote side.
   ::gnmi::Error error;
@@ -409,27 +411,23 @@ void ReportError(const std::string& msg,
   error.set_message(msg);
   ::gnmi::SubscribeResponse resp;
   *resp.mutable_error() = error;
-  stream->Write(resp, ::grpc::WriteOptions());
+  stream->Write(resp);
 }
 
 constexpr int kThousandMilliseconds = 1000 /* milliseconds */;
 
+// Handles the first request received on a Subscribe stream, which must be a
+// subscription request. 'uri' is the remote connection uri.
 ::util::Status HandleInitialSubscribeRequest(
-    GnmiPublisher* publisher, ::grpc::ServerContext* context,
-    ServerSubscribeReaderWriterInterface* stream,
+    GnmiPublisher* publisher, const std::string& uri,
+    const ::gnmi::SubscribeRequest& req,
+    GnmiSubscribeStream* stream,
     PathToHandleMap* subscriptions, PathToHandleMap* polls) {
   // Setting send_sync_response to `true` triggers sending a notification to the
   // client that all nodes have been processed. It is required by the gNMI spec
   // for initial ON_CHANGE values and the ONCE operation.
   bool send_sync_response = false;
   ::util::Status status;
-  ::gnmi::SubscribeRequest req;
-  if (!stream->Read(&req)) {
-    // The client called WritesDone() or the stream has been closed.
-    // Report error to the remote side.
-    ReportError("No subscription request received.", stream);
-    return MAKE_ERROR(ERR_INVALID_PARAM) << "No subscription request received.";
-  }
   if (!req.has_subscribe()) {
     // The request did not contain actual subscribe request.
     // Report error to the remote side.
@@ -438,7 +436,6 @@ constexpr int kThousandMilliseconds = 1000 /* milliseconds */;
            << "No valid subscription request received.";
   }
 
-  std::string uri = context->peer();  // remote connection uri
   LOG(INFO) << "Initial Subscribe request from " << uri << " over stream "
             << stream << ".";
   VLOG(1) << "SubscribeRequest: " << req.ShortDebugString();
@@ -579,73 +576,138 @@ constexpr int kThousandMilliseconds = 1000 /* milliseconds */;
   return ::util::OkStatus();
 }
 
+// Handles a request received on a Subscribe stream after the initial
+// subscription request. Now the only valid requests can be either POLL or
+// ALIAS.
+void HandleSubscribeRequest(GnmiPublisher* publisher, const std::string& uri,
+                            const ::gnmi::SubscribeRequest& req,
+                            GnmiSubscribeStream* stream,
+                            const PathToHandleMap& polls) {
+  LOG(INFO) << "Subscribe request from " << uri << " over stream " << stream
+            << ".";
+  VLOG(1) << "SubscribeRequest: " << req.ShortDebugString();
+  if (req.has_subscribe()) {
+    // Invalid type of request at this stage! Such message is valid only
+    // once at the very beginning.
+    // Report error to the remote side.
+    ReportError(
+        "Invalid subscription request received. Only one per call "
+        "allowed.",
+        stream);
+  } else if (req.has_poll()) {
+    // A poll request. Get updates on all subscribed paths.
+    VLOG(1) << "poll";
+    for (const auto& mapping : polls) {
+      if (publisher->HandlePoll(mapping.second) != ::util::OkStatus()) {
+        ReportError("Error while executing POLL.", stream);
+      }
+    }
+  } else if (req.has_aliases()) {
+    // Received aliases to be created.
+    ReportError("Received an alias request. Unsupported.", stream);
+  } else {
+    // Empty request!?
+    ReportError("Received an empty request.", stream);
+  }
+}
+
+// Unsubscribes and deletes all subscriptions and polls. This stops scheduled
+// timers and prevents access to freed gRPC resources.
+void UnsubscribeAll(GnmiPublisher* publisher, PathToHandleMap* subscriptions,
+                    PathToHandleMap* polls) {
+  for (auto& subscription : *subscriptions) {
+    publisher->UnSubscribe(subscription.second);
+  }
+  subscriptions->clear();
+  polls->clear();
+}
+
 }  // namespace
 
-::grpc::Status ConfigMonitoringService::DoSubscribe(
-    GnmiPublisher* publisher, ::grpc::ServerContext* context,
-    ServerSubscribeReaderWriterInterface* stream) {
-  PathToHandleMap subscriptions;
-  PathToHandleMap polls;
-  ::util::Status status;
-  // First process the subscription request. According to the spec there can be
-  // only one!
-  if ((status = HandleInitialSubscribeRequest(publisher, context, stream,
-                                              &subscriptions, &polls)) !=
-      ::util::OkStatus()) {
-    return ::grpc::Status(::grpc::StatusCode::INTERNAL, status.ToString());
+// The handler of a Subscribe RPC. It lives until the RPC is done, and holds
+// the subscriptions made by the client on the other side of the stream.
+class ConfigMonitoringService::SubscribeReactor
+    : public ServerStreamReactor<::gnmi::SubscribeRequest,
+                                 ::gnmi::SubscribeResponse> {
+ public:
+  SubscribeReactor(GnmiPublisher* publisher,
+                   ServerStreamExecutor* executor,
+                   ::grpc::CallbackServerContext* context,
+                   const ::grpc::Status& status)
+      // Polls read the switch state, which can block.
+      : ServerStreamReactor(FLAGS_gnmi_subscribe_max_pending_responses,
+                            executor),
+        publisher_(publisher),
+        uri_(context->peer()),
+        initial_request_handled_(false) {
+    Start(status);
   }
 
-  std::string uri = context->peer();  // remote connection uri
-  // Now the only valid requests can be either POLL or ALIAS.
-  ::gnmi::SubscribeRequest req;
-  while (true) {
-    if (stream->Read(&req)) {
-      // All good! The message has been received! Let's process it!
-      LOG(INFO) << "Subscribe request from " << uri << " over stream " << stream
-                << ".";
-      VLOG(1) << "SubscribeRequest: " << req.ShortDebugString();
-      if (req.has_subscribe()) {
-        // Invalid type of request at this stage! Such message is valid only
-        // once at the very beginning.
-        // Report error to the remote side.
-        ReportError(
-            "Invalid subscription request received. Only one per call "
-            "allowed.",
-            stream);
-      } else if (req.has_poll()) {
-        // A poll request. Get updates on all subscribed paths.
-        VLOG(1) << "poll";
-        for (const auto& mapping : polls) {
-          if (publisher->HandlePoll(mapping.second) != ::util::OkStatus()) {
-            ReportError("Error while executing POLL.", stream);
-          }
-        }
-      } else if (req.has_aliases()) {
-        // Received aliases to be created.
-        ReportError("Received an alias request. Unsupported.", stream);
-      } else {
-        // Empty request!?
-        ReportError("Received an empty request.", stream);
-      }
-    } else {
+ protected:
+  ::grpc::Status HandleRequest(const ::gnmi::SubscribeRequest& req) override {
+    if (initial_request_handled_) {
+      HandleSubscribeRequest(publisher_, uri_, req, this, polls_);
+      return ::grpc::Status::OK;
+    }
+    // First process the subscription request. According to the spec there
+    // can be only one!
+    initial_request_handled_ = true;
+    ::util::Status status = HandleInitialSubscribeRequest(
+        publisher_, uri_, req, this, &subscriptions_, &polls_);
+    if (!status.ok()) {
+      return ::grpc::Status(::grpc::StatusCode::INTERNAL, status.ToString());
+    }
+    return ::grpc::Status::OK;
+  }
+
+  ::grpc::Status HandleReadsDone() override {
+    if (!initial_request_handled_) {
       // The client called WritesDone() or the stream has been closed.
-      // Now the infinite loop should be stopped - no more requests will be
-      // received.
-      LOG(INFO) << "Subscribe stream " << stream << " from " << uri
-                << " has been closed.";
-      break;
+      // Report error to the remote side.
+      ReportError("No subscription request received.", this);
+      ::util::Status status = MAKE_ERROR(ERR_INVALID_PARAM)
+                              << "No subscription request received.";
+      return ::grpc::Status(::grpc::StatusCode::INTERNAL, status.ToString());
     }
+    LOG(INFO) << "Subscribe stream " << this << " from " << uri_
+              << " has been closed.";
+    return ::grpc::Status::OK;
   }
 
-  // Unsubscribe and delete all subscriptions and polls. This stops scheduled
-  // timers and prevents access to freed gRPC resources.
-  for (auto& subscription : subscriptions) {
-    publisher->UnSubscribe(subscription.second);
+  void OnClose() override {
+    UnsubscribeAll(publisher_, &subscriptions_, &polls_);
   }
-  subscriptions.clear();
-  polls.clear();
 
-  return ::grpc::Status::OK;
+ private:
+  GnmiPublisher* publisher_;  // not owned by this class.
+
+  // The remote connection uri.
+  const std::string uri_;
+
+  // Set once the subscription request has been processed.
+  bool initial_request_handled_;
+
+  // The subscriptions and polls of this stream. Only accessed by the read
+  // callbacks of the stream.
+  PathToHandleMap subscriptions_;
+  PathToHandleMap polls_;
+};
+
+ServerSubscribeReactor* ConfigMonitoringService::Subscribe(
+    ::grpc::CallbackServerContext* context) {
+  auto authorize = [this, context]() -> ::grpc::Status {
+    RETURN_IF_NOT_AUTHORIZED(auth_policy_checker_, ConfigMonitoringService,
+                             Subscribe, context);
+    return ::grpc::Status::OK;
+  };
+  return DoSubscribe(&gnmi_publisher_, context, authorize());
+}
+
+ServerSubscribeReactor* ConfigMonitoringService::DoSubscribe(
+    GnmiPublisher* publisher, ::grpc::CallbackServerContext* context,
+    const ::grpc::Status& status) {
+  return new SubscribeReactor(publisher, &subscribe_executor_, context,
+                              status);
 }
 
 }  // namespace hal
@@ -17,6 +17,7 @@
 #include "stratum/hal/lib/common/common.pb.h"
 #include "stratum/hal/lib/common/error_buffer.h"
 #include "stratum/hal/lib/common/gnmi_publisher.h"
+#include "stratum/hal/lib/common/server_stream_reactor.h"
 #include "stratum/hal/lib/common/switch_interface.h"
 #include "stratum/hal/lib/common/target_options.h"
 #include "stratum/lib/security/auth_policy_checker.h"
@@ -24,17 +25,17 @@
 namespace stratum {
 namespace hal {
 
-using ServerSubscribeReaderWriter =
-    ::grpc::ServerReaderWriter<::gnmi::SubscribeResponse,
-                               ::gnmi::SubscribeRequest>;
-using ServerSubscribeReaderWriterInterface =
-    ::grpc::ServerReaderWriterInterface<::gnmi::SubscribeResponse,
-                                        ::gnmi::SubscribeRequest>;
+using ServerSubscribeReactor =
+    ::grpc::ServerBidiReactor<::gnmi::SubscribeRequest,
+                              ::gnmi::SubscribeResponse>;
 
 // The "ConfigMonitoringService" class implements ::gnmi::gNMI::Service. It
 // handles all the RPCs that are part of the gRPC Network Management Interface
 // (gNMI) which are in charge of configuration and monitoring/telemetry.
-class ConfigMonitoringService final : public ::gnmi::gNMI::Service {
+// Subscribe uses the gRPC callback API, so that the open subscriptions do not
+// pin server threads.
+class ConfigMonitoringService final
+    : public ::gnmi::gNMI::WithCallbackMethod_Subscribe<::gnmi::gNMI::Service> {
  public:
   ConfigMonitoringService(OperationMode mode, SwitchInterface* switch_interface,
                           AuthPolicyChecker* auth_policy_checker,
@@ -98,8 +99,8 @@ class ConfigMonitoringService final : public ::gnmi::gNMI::Service {
   // of particular paths within the config/state tree. These values may be
   // streamed at a particular cadence (STREAM), sent one off on a long-lived
   // channel (POLL), or sent as a one-off retrieval (ONCE).
-  ::grpc::Status Subscribe(::grpc::ServerContext* context,
-                           ServerSubscribeReaderWriter* stream) override
+  ServerSubscribeReactor* Subscribe(
+      ::grpc::CallbackServerContext* context) override
       LOCKS_EXCLUDED(config_lock_);
 
   // ConfigMonitoringService is neither copyable nor movable.
@@ -114,17 +115,16 @@ class ConfigMonitoringService final : public ::gnmi::gNMI::Service {
   ::grpc::Status DoCapabilities(::grpc::ServerContext* context,
                                 const ::gnmi::CapabilityRequest* req,
                                 ::gnmi::CapabilityResponse* resp);
-  // The actual method that implements 'Subscribe' that allows a client to
-  // request the switch to send it values of particular paths within the
-  // config/state tree. These values may be streamed at a particular cadence
-  // (STREAM), sent one off on a long-lived channel (POLL), or sent as a one-off
-  // retrieval (ONCE). This is implemented this way to enable unit tests of the
-  // Subscribe method whose 'stream' parameter type is marked 'final' and
-  // therefore cannot be mocked.
-  ::grpc::Status DoSubscribe(GnmiPublisher* publisher,
-                             ::grpc::ServerContext* context,
-                             ServerSubscribeReaderWriterInterface* stream)
-      LOCKS_EXCLUDED(config_lock_);
+  // The handler of a Subscribe RPC.
+  class SubscribeReactor;
+
+  // Creates the handler of a Subscribe RPC, which subscribes the client to the
+  // paths through the given publisher, or finishes the RPC with the given
+  // status if it is not OK. This is implemented this way to enable unit tests
+  // of the Subscribe method with a mock publisher.
+  ServerSubscribeReactor* DoSubscribe(GnmiPublisher* publisher,
+                                      ::grpc::CallbackServerContext* context,
+                                      const ::grpc::Status& status);
 
   // The actual method that implements 'Get' that allows a client to
   // request the switch to send it values of particular paths within the
@@ -177,6 +177,11 @@ class ConfigMonitoringService final : public ::gnmi::gNMI::Service {
   // Target-specific options.
   const TargetOptions target_options_;
 
+  // The threads handling the requests of the Subscribe streams, off the gRPC
+  // callback threads. Declared last, as the scheduled requests still use the
+  // other members when it is destroyed.
+  ServerStreamExecutor subscribe_executor_;
+
   friend class ConfigMonitoringServiceTest;
 };
 
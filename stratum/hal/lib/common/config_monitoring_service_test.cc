@@ -7,6 +7,7 @@
 
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "absl/memory/memory.h"
 #include "absl/strings/substitute.h"
@@ -22,7 +23,6 @@
 #include "stratum/hal/lib/common/gnmi_events.h"
 #include "stratum/hal/lib/common/gnmi_publisher.h"
 #include "stratum/hal/lib/common/gnmi_publisher_mock.h"
-#include "stratum/hal/lib/common/subscribe_reader_writer_mock.h"
 #include "stratum/hal/lib/common/switch_mock.h"
 #include "stratum/lib/security/auth_policy_checker_mock.h"
 #include "stratum/lib/test_utils/matchers.h"
@@ -42,8 +42,6 @@ using ::testing::HasSubstr;
 using ::testing::Invoke;
 using ::testing::NiceMock;
 using ::testing::Return;
-using ::testing::SaveArg;
-using ::testing::SetArgPointee;
 using ::testing::WithArgs;
 
 class Event;
@@ -65,8 +63,18 @@ class ConfigMonitoringServiceTest
         error_buffer_.get());
     gnmi_publisher_ =
         absl::make_unique<NiceMock<GnmiPublisherMock>>(switch_mock_.get());
+    subscribe_service_ = absl::make_unique<SubscribeService>(this);
+    ::grpc::ServerBuilder builder;
+    builder.RegisterService(subscribe_service_.get());
+    server_ = builder.BuildAndStart();
+    ASSERT_NE(server_, nullptr);
+    stub_ = ::gnmi::gNMI::NewStub(
+        server_->InProcessChannel(::grpc::ChannelArguments()));
+    ASSERT_NE(stub_, nullptr);
   }
 
+  void TearDown() override { server_->Shutdown(); }
+
   void FillTestChassisConfigAndSave(ChassisConfig* config) {
     const std::string& config_text = absl::Substitute(
         kChassisConfigTemplate, kNodeId1, kUnit1 + 1, kNodeId2, kUnit2 + 1);
@@ -89,11 +97,43 @@ class ConfigMonitoringServiceTest
     }
   }
 
+  // A gNMI service which handles the Subscribe RPCs with the service under
+  // test and the mock publisher.
+  class SubscribeService
+      : public ::gnmi::gNMI::WithCallbackMethod_Subscribe<
+            ::gnmi::gNMI::Service> {
+   public:
+    explicit SubscribeService(ConfigMonitoringServiceTest* test)
+        : test_(test) {}
+    ServerSubscribeReactor* Subscribe(
+        ::grpc::CallbackServerContext* context) override {
+      return test_->DoSubscribe(context);
+    }
+
+   private:
+    ConfigMonitoringServiceTest* test_;  // not owned by this class.
+  };
+
   // A proxy to private method of ConfigMonitoringService class.
-  ::grpc::Status DoSubscribe(::grpc::ServerContext* context,
-                             ServerSubscribeReaderWriterInterface* stream) {
-    return config_monitoring_service_->DoSubscribe(gnmi_publisher_.get(),
-                                                   context, stream);
+  ServerSubscribeReactor* DoSubscribe(::grpc::CallbackServerContext* context) {
+    return config_monitoring_service_->DoSubscribe(
+        gnmi_publisher_.get(), context, ::grpc::Status::OK);
+  }
+
+  // Opens a Subscribe stream to the in-process server, sends the requests and
+  // closes the stream. Saves the responses to 'resps' and returns the final
+  // status of the RPC.
+  ::grpc::Status Subscribe(const std::vector<::gnmi::SubscribeRequest>& reqs,
+                           std::vector<::gnmi::SubscribeResponse>* resps) {
+    ::grpc::ClientContext context;
+    auto stream = stub_->Subscribe(&context);
+    for (const auto& req : reqs) {
+      if (!stream->Write(req)) break;
+    }
+    stream->WritesDone();
+    ::gnmi::SubscribeResponse resp;
+    while (stream->Read(&resp)) resps->push_back(resp);
+    return stream->Finish();
   }
 
   // A proxy to private method of ConfigMonitoringService class.
@@ -155,6 +195,9 @@ class ConfigMonitoringServiceTest
   std::unique_ptr<AuthPolicyCheckerMock> auth_policy_checker_mock_;
   std::unique_ptr<ErrorBuffer> error_buffer_;
   std::unique_ptr<NiceMock<GnmiPublisherMock>> gnmi_publisher_;
+  std::unique_ptr<SubscribeService> subscribe_service_;
+  std::unique_ptr<::grpc::Server> server_;
+  std::unique_ptr<::gnmi::gNMI::Stub> stub_;
 };
 
 constexpr char ConfigMonitoringServiceTest::kChassisConfigTemplate[];
@@ -342,9 +385,6 @@ TEST_P(ConfigMonitoringServiceTest, SetupAndThenTeardownSuccess) {
 }
 
 TEST_P(ConfigMonitoringServiceTest, SubscribeExistingPathSuccess) {
-  SubscribeReaderWriterMock stream;
-  ::grpc::ServerContext context;
-
   // Build a stream subscription request for subtree that is supported.
   ::gnmi::SubscribeRequest req;
   constexpr char kReq[] = R"pb(
@@ -363,25 +403,19 @@ TEST_P(ConfigMonitoringServiceTest, SubscribeExistingPathSuccess) {
   ASSERT_TRUE(google::protobuf::TextFormat::ParseFromString(kReq, &req))
       << "Failed to parse proto from the following string: " << kReq;
 
-  // Two Read() calls are expected:
-  // - first simulates reception of the original subscribe message.
-  // - second simulates closure of the connection.
-  EXPECT_CALL(stream, Read(_))
-      .WillOnce(DoAll(SetArgPointee<0>(req), Return(true)))
-      .WillOnce(Return(false));
-
   // Simulate path being found.
   EXPECT_CALL(*gnmi_publisher_, SubscribePeriodic(_, _, _, _))
       .WillOnce(Return(::util::OkStatus()));
 
-  // Actual test. Simulates reception of a Subscribe gRPC call.
-  EXPECT_TRUE(DoSubscribe(&context, &stream).ok());
+  // Actual test. Sends the subscribe message, then closes the stream.
+  std::vector<::gnmi::SubscribeResponse> resps;
+  EXPECT_TRUE(Subscribe({req}, &resps).ok());
+
+  // The mock publisher does not send any updates.
+  EXPECT_TRUE(resps.empty());
 }
 
 TEST_P(ConfigMonitoringServiceTest, SubscribeExistingPathFail) {
-  SubscribeReaderWriterMock stream;
-  ::grpc::ServerContext context;
-
   // Build a stream subscription request for subtree that is not supported.
   ::gnmi::SubscribeRequest req;
   constexpr char kReq[] = R"pb(
@@ -399,36 +433,22 @@ TEST_P(ConfigMonitoringServiceTest, SubscribeExistingPathFail) {
   ASSERT_TRUE(google::protobuf::TextFormat::ParseFromString(kReq, &req))
       << "Failed to parse proto from the following string: " << kReq;
 
-  // Two Read() calls are expected:
-  // - first simulates reception of the original subscribe message.
-  // - second simulates closure of the connection.
-  EXPECT_CALL(stream, Read(_))
-      .WillOnce(DoAll(SetArgPointee<0>(req), Return(true)))
-      .WillOnce(Return(false));
-
   // Simulate path not being found.
   ::util::Status error = MAKE_ERROR(ERR_INVALID_PARAM) << "path not supported.";
   EXPECT_CALL(*gnmi_publisher_, SubscribePeriodic(_, _, _, _))
       .WillOnce(Return(error));
 
-  // Invalid subscription request triggers one response, therefore one call to
-  // Write() is expected. The message written into the stream is saved to local
-  // variable 'resp' for further examination.
-  ::gnmi::SubscribeResponse resp;
-  EXPECT_CALL(stream, Write(_, _))
-      .WillOnce(DoAll(SaveArg<0>(&resp), Return(true)));
-
-  // Actual test. Simulates reception of a Subscribe gRPC call.
-  EXPECT_TRUE(DoSubscribe(&context, &stream).ok());
+  // Actual test. Sends the subscribe message, then closes the stream.
+  std::vector<::gnmi::SubscribeResponse> resps;
+  EXPECT_TRUE(Subscribe({req}, &resps).ok());
 
-  // The response should include an error message!
-  ASSERT_TRUE(resp.has_error());
+  // Invalid subscription request triggers one response, which should include
+  // an error message!
+  ASSERT_EQ(1, resps.size());
+  EXPECT_TRUE(resps[0].has_error());
 }
 
 TEST_P(ConfigMonitoringServiceTest, SubscribeExistingPathPassFail) {
-  SubscribeReaderWriterMock stream;
-  ::grpc::ServerContext context;
-
   // Build a stream subscription request for subtree that is not supported.
   ::gnmi::SubscribeRequest req;
   constexpr char kReq[] = R"pb(
@@ -454,37 +474,23 @@ TEST_P(ConfigMonitoringServiceTest, SubscribeExistingPathPassFail) {
   ASSERT_TRUE(google::protobuf::TextFormat::ParseFromString(kReq, &req))
       << "Failed to parse proto from the following string: " << kReq;
 
-  // Two Read() calls are expected:
-  // - first simulates reception of the original subscribe message.
-  // - second simulates closure of the connection.
-  EXPECT_CALL(stream, Read(_))
-      .WillOnce(DoAll(SetArgPointee<0>(req), Return(true)))
-      .WillOnce(Return(false));
-
   // Simulate path not being found.
   ::util::Status error = MAKE_ERROR(ERR_INVALID_PARAM) << "path not supported.";
   EXPECT_CALL(*gnmi_publisher_, SubscribePeriodic(_, _, _, _))
       .WillOnce(Return(::util::OkStatus()))
       .WillOnce(Return(error));
 
-  // Invalid subscription request triggers one response, therefore one call to
-  // Write() is expected. The message written into the stream is saved to local
-  // variable 'resp' for further examination.
-  ::gnmi::SubscribeResponse resp;
-  EXPECT_CALL(stream, Write(_, _))
-      .WillOnce(DoAll(SaveArg<0>(&resp), Return(true)));
+  // Actual test. Sends the subscribe message, then closes the stream.
+  std::vector<::gnmi::SubscribeResponse> resps;
+  EXPECT_TRUE(Subscribe({req}, &resps).ok());
 
-  // Actual test. Simulates reception of a Subscribe gRPC call.
-  EXPECT_TRUE(DoSubscribe(&context, &stream).ok());
-
-  // The response should include an error message!
-  ASSERT_TRUE(resp.has_error());
+  // Invalid subscription request triggers one response, which should include
+  // an error message!
+  ASSERT_EQ(1, resps.size());
+  EXPECT_TRUE(resps[0].has_error());
 }
 
 TEST_P(ConfigMonitoringServiceTest, SubscribeAndPollSuccess) {
-  SubscribeReaderWriterMock stream;
-  ::grpc::ServerContext context;
-
   // Build a poll subscription request for subtree that is supported.
   ::gnmi::SubscribeRequest req1;
   constexpr char kReq1[] = R"pb(
@@ -510,15 +516,6 @@ TEST_P(ConfigMonitoringServiceTest, SubscribeAndPollSuccess) {
   ASSERT_TRUE(google::protobuf::TextFormat::ParseFromString(kReq2, &req2))
       << "Failed to parse proto from the following string: " << kReq2;
 
-  // Three Read() calls are expected:
-  // - first simulates reception of the original subscribe message.
-  // - second simulates reception of the poll request message.
-  // - third simulates closure of the connection.
-  EXPECT_CALL(stream, Read(_))
-      .WillOnce(DoAll(SetArgPointee<0>(req1), Return(true)))
-      .WillOnce(DoAll(SetArgPointee<0>(req2), Return(true)))
-      .WillOnce(Return(false));
-
   // Simulate path being found.
   EXPECT_CALL(*gnmi_publisher_, SubscribePoll(_, _, _))
       .WillOnce(Return(::util::OkStatus()));
@@ -527,14 +524,13 @@ TEST_P(ConfigMonitoringServiceTest, SubscribeAndPollSuccess) {
   EXPECT_CALL(*gnmi_publisher_, HandlePoll(_))
       .WillOnce(Return(::util::OkStatus()));
 
-  // Actual test. Simulates reception of a Subscribe gRPC call.
-  EXPECT_TRUE(DoSubscribe(&context, &stream).ok());
+  // Actual test. Sends the subscribe and the poll messages, then closes the
+  // stream.
+  std::vector<::gnmi::SubscribeResponse> resps;
+  EXPECT_TRUE(Subscribe({req1, req2}, &resps).ok());
 }
 
 TEST_P(ConfigMonitoringServiceTest, DoubleSubscribeFail) {
-  SubscribeReaderWriterMock stream;
-  ::grpc::ServerContext context;
-
   // Build a stream subscription request for subtree that is supported.
   ::gnmi::SubscribeRequest req;
   constexpr char kReq[] = R"pb(
@@ -553,37 +549,22 @@ TEST_P(ConfigMonitoringServiceTest, DoubleSubscribeFail) {
   ASSERT_TRUE(google::protobuf::TextFormat::ParseFromString(kReq, &req))
       << "Failed to parse proto from the following string: " << kReq;
 
-  // Three Read() calls are expected:
-  // - first simulates reception of the original subscribe message.
-  // - second simulates reception of the additional invalid subscribe message.
-  // - third simulates closure of the connection.
-  EXPECT_CALL(stream, Read(_))
-      .WillOnce(DoAll(SetArgPointee<0>(req), Return(true)))
-      .WillOnce(DoAll(SetArgPointee<0>(req), Return(true)))
-      .WillOnce(Return(false));
-
-  // An invalid request that results in an error triggers one response,
-  // therefore one call to Write() is expected. The message written into
-  // the stream is saved to local  variable 'resp' for further examination.
-  ::gnmi::SubscribeResponse resp;
-  EXPECT_CALL(stream, Write(_, _))
-      .WillOnce(DoAll(SaveArg<0>(&resp), Return(true)));
-
   // Simulate path being found.
   EXPECT_CALL(*gnmi_publisher_, SubscribePeriodic(_, _, _, _))
       .WillOnce(Return(::util::OkStatus()));
 
-  // Actual test. Simulates reception of a Subscribe gRPC call.
-  EXPECT_TRUE(DoSubscribe(&context, &stream).ok());
+  // Actual test. Sends the original subscribe message and an additional
+  // invalid one, then closes the stream.
+  std::vector<::gnmi::SubscribeResponse> resps;
+  EXPECT_TRUE(Subscribe({req, req}, &resps).ok());
 
-  // The response should include an error message!
-  ASSERT_TRUE(resp.has_error());
+  // The invalid request triggers one response, which should include an error
+  // message!
+  ASSERT_EQ(1, resps.size());
+  EXPECT_TRUE(resps[0].has_error());
 }
 
 TEST_P(ConfigMonitoringServiceTest, DuplicateSubscribeFail) {
-  SubscribeReaderWriterMock stream;
-  ::grpc::ServerContext context;
-
   // Build a stream subscription request for subtree that is supported.
   // Add another request for the same path. This is illeagal combination.
   ::gnmi::SubscribeRequest req;
@@ -611,20 +592,6 @@ TEST_P(ConfigMonitoringServiceTest, DuplicateSubscribeFail) {
   ASSERT_TRUE(google::protobuf::TextFormat::ParseFromString(kReq, &req))
       << "Failed to parse proto from the following string: " << kReq;
 
-  // Two Read() calls are expected:
-  // - first simulates reception of the original subscribe message.
-  // - second simulates closure of the connection.
-  EXPECT_CALL(stream, Read(_))
-      .WillOnce(DoAll(SetArgPointee<0>(req), Return(true)))
-      .WillOnce(Return(false));
-
-  // An invalid request that results in an error triggers one response,
-  // therefore one call to Write() is expected. The message written into
-  // the stream is saved to local  variable 'resp' for further examination.
-  ::gnmi::SubscribeResponse resp;
-  EXPECT_CALL(stream, Write(_, _))
-      .WillOnce(DoAll(SaveArg<0>(&resp), Return(true)));
-
   // Simulate path being found.
   EXPECT_CALL(*gnmi_publisher_, SubscribePeriodic(_, _, _, _))
       .WillOnce(Return(::util::OkStatus()));
@@ -636,17 +603,17 @@ TEST_P(ConfigMonitoringServiceTest, DuplicateSubscribeFail) {
   ASSERT_OK(
       gnmi_publisher_->HandleChange(ConfigHasBeenPushedEvent(hal_config)));
 
-  // Actual test. Simulates reception of a Subscribe gRPC call.
-  EXPECT_TRUE(DoSubscribe(&context, &stream).ok());
+  // Actual test. Sends the subscribe message, then closes the stream.
+  std::vector<::gnmi::SubscribeResponse> resps;
+  EXPECT_TRUE(Subscribe({req}, &resps).ok());
 
-  // The response should include an error message!
-  ASSERT_TRUE(resp.has_error());
+  // The invalid request triggers one response, which should include an error
+  // message!
+  ASSERT_EQ(1, resps.size());
+  EXPECT_TRUE(resps[0].has_error());
 }
 
 TEST_P(ConfigMonitoringServiceTest, SubscribeOnChangeWithInitialValueSuccess) {
-  SubscribeReaderWriterMock stream;
-  ::grpc::ServerContext context;
-
   // Build a on_change subscription request for subtree that is supported.
   ::gnmi::SubscribeRequest req;
   constexpr char kReq[] = R"pb(
@@ -664,18 +631,6 @@ TEST_P(ConfigMonitoringServiceTest, SubscribeOnChangeWithInitialValueSuccess) {
   ASSERT_TRUE(google::protobuf::TextFormat::ParseFromString(kReq, &req))
       << "Failed to parse proto from the following string: " << kReq;
 
-  // Two Read() calls are expected:
-  // - first simulates reception of the original subscribe message.
-  // - second simulates closure of the connection.
-  EXPECT_CALL(stream, Read(_))
-      .WillOnce(DoAll(SetArgPointee<0>(req), Return(true)))
-      .WillOnce(Return(false));
-
-  // One Write() call is expected: the sync_response message.
-  ::gnmi::SubscribeResponse resp;
-  EXPECT_CALL(stream, Write(_, _))
-      .WillOnce(DoAll(SaveArg<0>(&resp), Return(true)));
-
   // Simulate path being found.
   EXPECT_CALL(*gnmi_publisher_, SubscribeOnChange(_, _, _))
       .WillOnce(Return(::util::OkStatus()));
@@ -686,17 +641,16 @@ TEST_P(ConfigMonitoringServiceTest, SubscribeOnChangeWithInitialValueSuccess) {
   EXPECT_CALL(*gnmi_publisher_, HandlePoll(_))
       .WillOnce(Return(::util::OkStatus()));
 
-  // Actual test. Simulates reception of a Subscribe gRPC call.
-  EXPECT_TRUE(DoSubscribe(&context, &stream).ok());
+  // Actual test. Sends the subscribe message, then closes the stream.
+  std::vector<::gnmi::SubscribeResponse> resps;
+  EXPECT_TRUE(Subscribe({req}, &resps).ok());
 
-  // Check if the response mesage has been sent.
-  EXPECT_TRUE(resp.sync_response());
+  // Check if the sync_response message has been sent.
+  ASSERT_EQ(1, resps.size());
+  EXPECT_TRUE(resps[0].sync_response());
 }
 
 TEST_P(ConfigMonitoringServiceTest, CheckConvertTargetDefinedToOnChange) {
-  SubscribeReaderWriterMock stream;
-  ::grpc::ServerContext context;
-
   // One of the subscription modes, TARGET_DEFINED, leaves the decision how to
   // treat the received subscription request to the switch.
   // GnmiPublisher::UpdateSubscritionWithTargetSpecficModeSpecification() method
@@ -739,18 +693,6 @@ TEST_P(ConfigMonitoringServiceTest, CheckConvertTargetDefinedToOnChange) {
   // TARGET_DEFINED subscription request is received and changed into a
   // ON_CHANGE subscription request.
 
-  // Two Read() calls are expected:
-  // - first simulates reception of the original subscribe message.
-  // - second simulates closure of the connection.
-  EXPECT_CALL(stream, Read(_))
-      .WillOnce(DoAll(SetArgPointee<0>(req), Return(true)))
-      .WillOnce(Return(false));
-
-  // One Write() call is expected: the sync_response message.
-  ::gnmi::SubscribeResponse resp;
-  EXPECT_CALL(stream, Write(_, _))
-      .WillOnce(DoAll(SaveArg<0>(&resp), Return(true)));
-
   // Simulate successful initial value poll operation.
   EXPECT_CALL(*gnmi_publisher_, SubscribePoll(_, _, _))
       .WillOnce(Return(::util::OkStatus()));
@@ -760,15 +702,29 @@ TEST_P(ConfigMonitoringServiceTest, CheckConvertTargetDefinedToOnChange) {
   // Make sure that only the ON_CHANGE subcription is called.
   EXPECT_CALL(*gnmi_publisher_, SubscribePeriodic(_, _, _, _)).Times(0);
 
-  // Triggering of the test scenario. Simulates reception of a Subscribe gRPC
-  // call.
-  EXPECT_TRUE(DoSubscribe(&context, &stream).ok());
+  // Triggering of the test scenario. Sends the subscribe message, then closes
+  // the stream.
+  std::vector<::gnmi::SubscribeResponse> resps;
+  EXPECT_TRUE(Subscribe({req}, &resps).ok());
+
+  // Check if the sync_response message has been sent.
+  ASSERT_EQ(1, resps.size());
+  EXPECT_TRUE(resps[0].sync_response());
+}
 
-  // Check if the response message has been sent.
-  EXPECT_TRUE(resp.sync_response());
+TEST_P(ConfigMonitoringServiceTest, SubscribeWithoutRequestFail) {
+  // Actual test. Closes the stream without sending a subscribe message.
+  std::vector<::gnmi::SubscribeResponse> resps;
+  ::grpc::Status status = Subscribe({}, &resps);
+  EXPECT_EQ(::grpc::StatusCode::INTERNAL, status.error_code());
+  EXPECT_THAT(status.error_message(),
+              HasSubstr("No subscription request received."));
+
+  // The error is also reported on the stream.
+  ASSERT_EQ(1, resps.size());
+  EXPECT_TRUE(resps[0].has_error());
 }
 
-// DoGet() should fail if executed before a config is pushed.
 TEST_P(ConfigMonitoringServiceTest, GnmiGetRootConfigBeforePush) {
   // Prepare a GET request.
   ::gnmi::GetRequest req;
@@ -6,7 +6,6 @@
 #ifndef STRATUM_HAL_LIB_COMMON_GNMI_EVENTS_H_
 #define STRATUM_HAL_LIB_COMMON_GNMI_EVENTS_H_
 
-#include <list>
 #include <memory>
 #include <set>
 #include <string>
@@ -19,6 +18,7 @@
 #include "stratum/glue/integral_types.h"
 #include "stratum/glue/status/status.h"
 #include "stratum/hal/lib/common/common.pb.h"
+#include "stratum/hal/lib/common/writer_interface.h"
 #include "stratum/lib/timer_daemon.h"
 #include "stratum/lib/utils.h"
 
@@ -497,9 +497,8 @@ class ConfigHasBeenPushedEvent
   const ChassisConfig& new_config_;
 };
 
-using GnmiSubscribeStream =
-    ::grpc::ServerReaderWriterInterface<::gnmi::SubscribeResponse,
-                                        ::gnmi::SubscribeRequest>;
+// The stream the responses to a gNMI subscription are written to.
+using GnmiSubscribeStream = WriterInterface<::gnmi::SubscribeResponse>;
 
 // A helper class that is used to implement gNMI GET operation using code that
 // is designed to handle streaming POLL requests and which expects a
@@ -512,18 +511,11 @@ class InlineGnmiSubscribeStream : public GnmiSubscribeStream {
   explicit InlineGnmiSubscribeStream(const WriteFunctor& w) : write_func_(w) {}
 
   // A method that is called by the OnPoll handers.
-  bool Write(const ::gnmi::SubscribeResponse& msg,
-             ::grpc::WriteOptions options) override {
+  bool Write(const ::gnmi::SubscribeResponse& msg) override {
     return write_func_(msg);
   }
 
  private:
-  // Required by the interface but not used. Made private to prevent their
-  // accidental usage.
-  void SendInitialMetadata() override { CHECK(false); }
-  bool NextMessageSize(uint32_t* sz) override { CHECK(false); }
-  bool Read(::gnmi::SubscribeRequest* msg) override { CHECK(false); }
-
   // A functor that implements the Write() method.
   WriteFunctor write_func_;
 };
@@ -672,12 +664,35 @@ class EventHandlerListBase {
     return ::util::OkStatus();
   }
 
+  // Adds a event handler to a list of handlers interested in this ('E') type of
+  // events of a single port. Per-port events are only passed to the handlers
+  // registered for their port and to the handlers registered for all ports,
+  // so a port event does not have to visit the handlers of all other ports.
+  ::util::Status Register(uint64 node_id, uint32 port_id,
+                          const EventHandlerRecordPtr& record)
+      LOCKS_EXCLUDED(access_lock_) {
+    absl::WriterMutexLock l(&access_lock_);
+    HandlerSet* handlers = &port_handlers_[std::make_pair(node_id, port_id)];
+    // Handlers which are never called are only cleaned up here.
+    CleanUpInactiveRegistrations(handlers);
+    handlers->insert(record);
+    return ::util::OkStatus();
+  }
+
   // Removes a event handler from a list of handlers interested in this  ('E')
   // type of events.
   ::util::Status UnRegister(const EventHandlerRecordPtr& record)
       LOCKS_EXCLUDED(access_lock_) {
     absl::WriterMutexLock l(&access_lock_);
     handlers_.erase(record);
+    for (auto it = port_handlers_.begin(); it != port_handlers_.end();) {
+      it->second.erase(record);
+      if (it->second.empty()) {
+        port_handlers_.erase(it++);
+      } else {
+        ++it;
+      }
+    }
     return ::util::OkStatus();
   }
 
@@ -686,34 +701,65 @@ class EventHandlerListBase {
     absl::WriterMutexLock l(&access_lock_);
     // To return acurate information remove all expired subscriptions.
     CleanUpInactiveRegistrations();
-    // Return the number of still active registrations.
-    return handlers_.size();
+    // Return the number of still active registrations. A handler registered
+    // for several ports is counted once.
+    HandlerSet all_handlers = handlers_;
+    for (auto& entry : port_handlers_) {
+      CleanUpInactiveRegistrations(&entry.second);
+      all_handlers.insert(entry.second.begin(), entry.second.end());
+    }
+    return all_handlers.size();
   }
 
  protected:
+  using HandlerSet =
+      std::set<EventHandlerRecordPtr, std::owner_less<EventHandlerRecordPtr>>;
+  using PortKey = std::pair<uint64, uint32>;
+
   // Removes pointers that are expired.
   void CleanUpInactiveRegistrations() EXCLUSIVE_LOCKS_REQUIRED(access_lock_) {
-    std::list<EventHandlerRecordPtr> entries_to_be_removed;
-    for (const auto& entry : handlers_) {
-      if (entry.expired()) {
+    CleanUpInactiveRegistrations(&handlers_);
+  }
+
+  static void CleanUpInactiveRegistrations(HandlerSet* handlers) {
+    for (auto it = handlers->begin(); it != handlers->end();) {
+      if (it->expired()) {
         // The subscription has been silently (without calling UnRegister())
-        // canceled by deleting the handle. Make a note of this record and
-        // then delete it after all entries in handlers_ are processed.
-        entries_to_be_removed.push_back(entry);
+        // canceled by deleting the handle.
+        it = handlers->erase(it);
+      } else {
+        ++it;
       }
     }
-    // Remove all subscriptions that have been silently canceled.
-    for (const auto& handler : entries_to_be_removed) {
-      handlers_.erase(handler);
-    }
+  }
+
+  // Returns the handlers registered for the port of a per-port event, or
+  // nullptr if there are none or if the event is not a per-port event.
+  template <typename E>
+  HandlerSet* FindPortHandlers(const PerPortGnmiEvent<E>& event)
+      EXCLUSIVE_LOCKS_REQUIRED(access_lock_) {
+    auto it = port_handlers_.find(std::make_pair(
+        event.GetNodeId(), static_cast<uint32>(event.GetPortId())));
+    if (it == port_handlers_.end()) return nullptr;
+    CleanUpInactiveRegistrations(&it->second);
+    return &it->second;
+  }
+  HandlerSet* FindPortHandlers(const GnmiEvent& event)
+      EXCLUSIVE_LOCKS_REQUIRED(access_lock_) {
+    return nullptr;
   }
 
   // A Mutex used to guard access to the map of pointers to handlers.
   mutable absl::Mutex access_lock_;
 
-  // A set of event handlers that are interested in this ('E') type of events.
-  std::set<EventHandlerRecordPtr, std::owner_less<EventHandlerRecordPtr>>
-      handlers_ GUARDED_BY(access_lock_);
+  // A set of event handlers that are interested in all events of this ('E')
+  // type.
+  HandlerSet handlers_ GUARDED_BY(access_lock_);
+
+  // Sets of event handlers that are interested in the events of this ('E')
+  // type of a single port, keyed by node ID and port ID.
+  absl::flat_hash_map<PortKey, HandlerSet> port_handlers_
+      GUARDED_BY(access_lock_);
 };
 
 // A class that keeps track of all event handlers that are interested in
@@ -734,13 +780,26 @@ class EventHandlerList : public EventHandlerListBase {
   // The dispatcher based on the type of the event to be processed selects one
   // specialized event handler list and calls its Process() method. This method.
   // It goes through the list of registered event handlers and calls each of
-  // them with the 'event' to be processed.
+  // them with the 'event' to be processed. Per-port events are only passed to
+  // the handlers registered for the port of the event (and to the handlers of
+  // all ports).
   ::util::Status Process(const GnmiEvent& base_event) override {
     absl::WriterMutexLock l(&access_lock_);
     if (const E* event = dynamic_cast<const E*>(&base_event)) {
       VLOG(1) << "Handling " << Demangle(typeid(E).name());
       CleanUpInactiveRegistrations();
+      const HandlerSet* port_handlers = FindPortHandlers(*event);
+      if (port_handlers != nullptr) {
+        for (const auto& entry : *port_handlers) {
+          if (auto handler = entry.lock()) {
+            (*handler)(*event).IgnoreError();
+          }
+        }
+      }
       for (const auto& entry : handlers_) {
+        // Do not call handlers registered for all ports and for this port
+        // twice.
+        if (port_handlers != nullptr && port_handlers->count(entry)) continue;
         if (auto handler = entry.lock()) {
           (*handler)(*event).IgnoreError();
         }
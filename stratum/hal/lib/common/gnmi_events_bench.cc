@@ -0,0 +1,140 @@
+// Copyright 2024 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+// Benchmark of the dispatch of per-port gNMI events. Flaps the link of every
+// port of a full chassis, with several ON_CHANGE leaves per port subscribed by
+// several collectors, and compares the handlers indexed by port with the
+// handlers registered for all ports, which filter on the port themselves. The
+// latter is how every handler was dispatched before the lists were indexed.
+
+#include <iostream>
+#include <memory>
+#include <vector>
+
+#include "absl/strings/str_format.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
+#include "gflags/gflags.h"
+#include "stratum/glue/init_google.h"
+#include "stratum/glue/integral_types.h"
+#include "stratum/glue/logging.h"
+#include "stratum/glue/status/status.h"
+#include "stratum/glue/status/status_macros.h"
+#include "stratum/hal/lib/common/common.pb.h"
+#include "stratum/hal/lib/common/gnmi_events.h"
+
+DEFINE_int32(num_ports, 256, "Number of ports of the chassis.");
+DEFINE_int32(num_handlers_per_port, 16,
+             "Number of event handlers of each port, i.e. the number of "
+             "subscribed ON_CHANGE leaves times the number of collectors.");
+DEFINE_int32(num_flaps, 10, "Number of link flaps of every port.");
+
+namespace stratum {
+namespace hal {
+
+const char kUsage[] = R"USAGE(
+Usage: gnmi_events_bench [options]
+  This tool dispatches a link flap of every port of a full chassis to the gNMI
+  event handlers, first indexed by port and then in one list for all ports, and
+  reports the dispatched events per second of both.
+)USAGE";
+
+constexpr uint64 kNodeId = 1;
+
+::util::Status Main(int argc, char** argv) {
+  RET_CHECK(FLAGS_num_ports > 0) << "--num_ports must be > 0.";
+  RET_CHECK(FLAGS_num_handlers_per_port > 0)
+      << "--num_handlers_per_port must be > 0.";
+  RET_CHECK(FLAGS_num_flaps > 0) << "--num_flaps must be > 0.";
+
+  // The two dispatch modes use different event types, as the handler lists
+  // are singletons.
+  auto* indexed = EventHandlerList<PortOperStateChangedEvent>::GetInstance();
+  auto* flat =
+      EventHandlerList<PortForwardingViabilityChangedEvent>::GetInstance();
+  int64 indexed_calls = 0;
+  int64 flat_calls = 0;
+  int64 flat_matches = 0;
+  std::vector<SubscriptionHandle> handles;
+  for (uint32 port_id = 1; port_id <= FLAGS_num_ports; ++port_id) {
+    for (int i = 0; i < FLAGS_num_handlers_per_port; ++i) {
+      handles.push_back(std::make_shared<EventHandlerRecord>(
+          [&indexed_calls](const GnmiEvent& event,
+                           GnmiSubscribeStream* stream) {
+            ++indexed_calls;
+            return ::util::OkStatus();
+          },
+          nullptr));
+      RETURN_IF_ERROR(indexed->Register(kNodeId, port_id, handles.back()));
+      handles.push_back(std::make_shared<EventHandlerRecord>(
+          [port_id, &flat_calls, &flat_matches](const GnmiEvent& event,
+                                                GnmiSubscribeStream* stream) {
+            ++flat_calls;
+            const auto* change =
+                dynamic_cast<const PortForwardingViabilityChangedEvent*>(
+                    &event);
+            if (change != nullptr && change->GetPortId() == port_id) {
+              ++flat_matches;
+            }
+            return ::util::OkStatus();
+          },
+          nullptr));
+      RETURN_IF_ERROR(flat->Register(handles.back()));
+    }
+  }
+
+  absl::Time start = absl::Now();
+  for (int flap = 0; flap < FLAGS_num_flaps; ++flap) {
+    for (uint32 port_id = 1; port_id <= FLAGS_num_ports; ++port_id) {
+      RETURN_IF_ERROR(
+          PortOperStateChangedEvent(kNodeId, port_id,
+                                    flap % 2 ? PORT_STATE_UP : PORT_STATE_DOWN,
+                                    0)
+              .Process());
+    }
+  }
+  const absl::Duration indexed_elapsed = absl::Now() - start;
+
+  start = absl::Now();
+  for (int flap = 0; flap < FLAGS_num_flaps; ++flap) {
+    for (uint32 port_id = 1; port_id <= FLAGS_num_ports; ++port_id) {
+      RETURN_IF_ERROR(PortForwardingViabilityChangedEvent(
+                          kNodeId, port_id,
+                          flap % 2 ? TRUNK_MEMBER_BLOCK_STATE_FORWARDING
+                                   : TRUNK_MEMBER_BLOCK_STATE_BLOCKED)
+                          .Process());
+    }
+  }
+  const absl::Duration flat_elapsed = absl::Now() - start;
+
+  const int64 num_events =
+      static_cast<int64>(FLAGS_num_flaps) * FLAGS_num_ports;
+  const int64 num_handler_calls = num_events * FLAGS_num_handlers_per_port;
+  RET_CHECK(indexed_calls == num_handler_calls)
+      << "Indexed dispatch called " << indexed_calls << " handlers, expected "
+      << num_handler_calls << ".";
+  RET_CHECK(flat_matches == num_handler_calls)
+      << "Single-list dispatch matched " << flat_matches
+      << " handlers, expected " << num_handler_calls << ".";
+
+  std::cout << absl::StrFormat(
+      "%d port events dispatched to %d handlers per event type\n"
+      "  indexed by port:        %s (%.0f events/sec, %d handler calls)\n"
+      "  one list for all ports: %s (%.0f events/sec, %d handler calls)\n",
+      num_events, handles.size() / 2, absl::FormatDuration(indexed_elapsed),
+      num_events / absl::ToDoubleSeconds(indexed_elapsed), indexed_calls,
+      absl::FormatDuration(flat_elapsed),
+      num_events / absl::ToDoubleSeconds(flat_elapsed), flat_calls);
+
+  return ::util::OkStatus();
+}
+
+}  // namespace hal
+}  // namespace stratum
+
+int main(int argc, char** argv) {
+  ::gflags::SetUsageMessage(stratum::hal::kUsage);
+  InitGoogle(argv[0], &argc, &argv, true);
+  stratum::InitStratumLogging();
+  return stratum::hal::Main(argc, argv).error_code();
+}
@@ -0,0 +1,89 @@
+// Copyright 2024 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#include "stratum/hal/lib/common/gnmi_events.h"
+
+#include <memory>
+
+#include "gtest/gtest.h"
+#include "stratum/glue/status/status_test_util.h"
+
+namespace stratum {
+namespace hal {
+namespace {
+
+constexpr uint64 kNodeId = 1;
+
+// Returns a subscription which counts the events it receives.
+SubscriptionHandle CountingSubscription(int* counter) {
+  return std::make_shared<EventHandlerRecord>(
+      [counter](const GnmiEvent& event, GnmiSubscribeStream* stream) {
+        ++*counter;
+        return ::util::OkStatus();
+      },
+      nullptr);
+}
+
+// Each test uses its own event type, as the handler lists are singletons.
+
+TEST(EventHandlerListTest, PortEventOnlyReachesHandlersOfItsPort) {
+  auto* list = EventHandlerList<PortAdminStateChangedEvent>::GetInstance();
+  int port1_count = 0;
+  int port2_count = 0;
+  int all_count = 0;
+  SubscriptionHandle port1 = CountingSubscription(&port1_count);
+  SubscriptionHandle port2 = CountingSubscription(&port2_count);
+  SubscriptionHandle all = CountingSubscription(&all_count);
+  ASSERT_OK(list->Register(kNodeId, 1, EventHandlerRecordPtr(port1)));
+  ASSERT_OK(list->Register(kNodeId, 2, EventHandlerRecordPtr(port2)));
+  ASSERT_OK(list->Register(EventHandlerRecordPtr(all)));
+  EXPECT_EQ(3, list->GetNumberOfRegisteredHandlers());
+
+  ASSERT_OK(PortAdminStateChangedEvent(kNodeId, 1, ADMIN_STATE_ENABLED)
+                .Process());
+  EXPECT_EQ(1, port1_count);
+  EXPECT_EQ(0, port2_count);
+  EXPECT_EQ(1, all_count);
+
+  // Same port ID on another node.
+  ASSERT_OK(PortAdminStateChangedEvent(kNodeId + 1, 2, ADMIN_STATE_ENABLED)
+                .Process());
+  EXPECT_EQ(1, port1_count);
+  EXPECT_EQ(0, port2_count);
+  EXPECT_EQ(2, all_count);
+
+  ASSERT_OK(list->UnRegister(EventHandlerRecordPtr(port1)));
+  ASSERT_OK(PortAdminStateChangedEvent(kNodeId, 1, ADMIN_STATE_ENABLED)
+                .Process());
+  EXPECT_EQ(1, port1_count);
+  EXPECT_EQ(3, all_count);
+
+  // Deleting the handles cancels the remaining subscriptions.
+  port2.reset();
+  all.reset();
+  EXPECT_EQ(0, list->GetNumberOfRegisteredHandlers());
+}
+
+TEST(EventHandlerListTest, HandlerOfSeveralPortsIsCalledOncePerEvent) {
+  auto* list = EventHandlerList<PortLoopbackStateChangedEvent>::GetInstance();
+  int count = 0;
+  SubscriptionHandle handle = CountingSubscription(&count);
+  ASSERT_OK(list->Register(kNodeId, 1, EventHandlerRecordPtr(handle)));
+  ASSERT_OK(list->Register(kNodeId, 2, EventHandlerRecordPtr(handle)));
+  ASSERT_OK(list->Register(EventHandlerRecordPtr(handle)));
+  EXPECT_EQ(1, list->GetNumberOfRegisteredHandlers());
+
+  ASSERT_OK(
+      PortLoopbackStateChangedEvent(kNodeId, 1, LOOPBACK_STATE_NONE).Process());
+  EXPECT_EQ(1, count);
+  ASSERT_OK(
+      PortLoopbackStateChangedEvent(kNodeId, 3, LOOPBACK_STATE_NONE).Process());
+  EXPECT_EQ(2, count);
+
+  handle.reset();
+  EXPECT_EQ(0, list->GetNumberOfRegisteredHandlers());
+}
+
+}  // namespace
+}  // namespace hal
+}  // namespace stratum
@@ -214,7 +214,7 @@ TEST_F(SubscriptionTest, HandleTimer) {
   EXPECT_OK(
       gnmi_publisher_->SubscribePeriodic(Periodic(1000), path, &stream, &h));
 
-  EXPECT_CALL(stream, Write(_, _)).WillOnce(Return(true));
+  EXPECT_CALL(stream, Write(_)).WillOnce(Return(true));
 
   // Mock implementation of RetrieveValue() that sends a response set to
   // ADMIN_STATE_ENABLED.
@@ -275,7 +275,7 @@ TEST_F(SubscriptionTest, OnDeleteUnSupportedPath) {
 TEST_F(SubscriptionTest, SyncResponseMsgIsCorrect) {
   SubscribeReaderWriterMock stream;
   ::gnmi::SubscribeResponse resp;
-  EXPECT_CALL(stream, Write(_, _))
+  EXPECT_CALL(stream, Write(_))
       .WillOnce(DoAll(SaveArg<0>(&resp), Return(true)));
 
   EXPECT_OK(gnmi_publisher_->SendSyncResponse(&stream));
@@ -293,7 +293,7 @@ TEST_F(SubscriptionTest, SyncResponseStreamNullptr) {
 // reporting error.
 TEST_F(SubscriptionTest, SyncResponseWriteError) {
   SubscribeReaderWriterMock stream;
-  EXPECT_CALL(stream, Write(_, _)).WillOnce(Return(false));
+  EXPECT_CALL(stream, Write(_)).WillOnce(Return(false));
 
   EXPECT_THAT(gnmi_publisher_->SendSyncResponse(&stream).error_message(),
               HasSubstr("failed"));
@@ -9,7 +9,6 @@
 #include <sstream>  // IWYU pragma: keep
 #include <utility>
 
-#include "absl/cleanup/cleanup.h"
 #include "absl/memory/memory.h"
 #include "absl/numeric/int128.h"
 #include "absl/strings/str_cat.h"
@@ -19,13 +18,16 @@
 #include "google/protobuf/any.pb.h"
 #include "google/rpc/code.pb.h"
 #include "google/rpc/status.pb.h"
+#include "grpcpp/impl/codegen/proto_utils.h"
 #include "stratum/glue/gtl/map_util.h"
 #include "stratum/glue/logging.h"
 #include "stratum/glue/status/status_macros.h"
+#include "stratum/hal/lib/common/server_stream_reactor.h"
 #include "stratum/hal/lib/common/server_writer_wrapper.h"
 #include "stratum/hal/lib/common/target_options.h"
 #include "stratum/lib/channel/channel.h"
 #include "stratum/lib/macros.h"
+#include "stratum/lib/metrics.h"
 #include "stratum/lib/utils.h"
 #include "stratum/public/lib/error.h"
 
@@ -48,6 +50,10 @@ DEFINE_int32(max_num_controllers_per_node, 5,
 DEFINE_int32(max_num_controller_connections, 20,
              "Max number of active/inactive streaming connections from outside "
              "controllers (for all of the nodes combined).");
+DEFINE_uint32(stream_channel_max_pending_responses, 1024,
+              "Max number of responses queued for sending on a StreamChannel. "
+              "Responses to a controller that can't keep up are dropped "
+              "beyond this. 0 means no limit.");
 
 namespace stratum {
 namespace hal {
@@ -77,6 +83,8 @@ P4Service::P4Service(OperationMode mode, SwitchInterface* switch_interface,
 P4Service::~P4Service() {}
 
 ::util::Status P4Service::Setup(bool warmboot) {
+  RETURN_IF_ERROR(MetricRegistry::GetInstance()->StartTextFileExport());
+
   // If we are in coupled mode and are coldbooting, we wait for the controller
   // to push the forwarding pipeline config. We do not do anything here.
   // TODO(unknown): This will be removed when we transition completely to
@@ -91,6 +99,7 @@ P4Service::~P4Service() {}
 }
 
 ::util::Status P4Service::Teardown() {
+  MetricRegistry::GetInstance()->StopTextFileExport();
   {
     absl::WriterMutexLock l(&controller_lock_);
     node_id_to_controller_manager_.clear();
@@ -298,6 +307,21 @@ void LogReadRequest(uint64 node_id, const ::p4::v1::ReadRequest& req,
       << "Failed to log the read request: " << status.error_message();
 }
 
+// Returns the latency histogram of the given P4Runtime RPC.
+LatencyHistogram* RpcLatencyHistogram(const std::string& rpc) {
+  return MetricRegistry::GetInstance()->GetHistogram(
+      "stratum_p4rt_rpc_latency_seconds",
+      "Time spent by the switch in the P4Runtime RPCs.", {{"rpc", rpc}});
+}
+
+// Returns the counter of the packets of the given direction.
+MetricCounter* PacketCounter(const std::string& direction) {
+  return MetricRegistry::GetInstance()->GetCounter(
+      "stratum_p4rt_packets_total",
+      "Packets sent to and received from the P4Runtime controllers.",
+      {{"direction", direction}});
+}
+
 // Helper function to generate a StreamMessageResponse from a failed Status.
 ::p4::v1::StreamMessageResponse ToStreamMessageResponse(
     const ::util::Status& status) {
@@ -345,10 +369,12 @@ void LogReadRequest(uint64 node_id, const ::p4::v1::ReadRequest& req,
   // Verify the request comes from the primary connection.
   RETURN_IF_GRPC_ERROR(IsWritePermitted(req->device_id(), *req));
 
+  static LatencyHistogram* latency = RpcLatencyHistogram("Write");
   std::vector<::util::Status> results = {};
   absl::Time timestamp = absl::Now();
   ::util::Status status =
       switch_interface_->WriteForwardingEntries(*req, &results);
+  latency->Record(absl::Now() - timestamp);
   if (!status.ok()) {
     LOG(ERROR) << "Failed to write forwarding entries to node " << node_id
                << ": " << status.error_message();
@@ -399,10 +425,12 @@ void LogReadRequest(uint64 node_id, const ::p4::v1::ReadRequest& req,
   RETURN_IF_GRPC_ERROR(IsReadPermitted(req->device_id(), *req));
 
   ServerWriterWrapper<::p4::v1::ReadResponse> wrapper(writer);
+  static LatencyHistogram* latency = RpcLatencyHistogram("Read");
   std::vector<::util::Status> details = {};
   absl::Time timestamp = absl::Now();
   ::util::Status status =
       switch_interface_->ReadForwardingEntries(*req, &wrapper, &details);
+  latency->Record(absl::Now() - timestamp);
   if (!status.ok()) {
     LOG(ERROR) << "Failed to read forwarding entries from node " << node_id
                << ": " << status.error_message();
@@ -572,8 +600,83 @@ void LogReadRequest(uint64 node_id, const ::p4::v1::ReadRequest& req,
   return ::grpc::Status::OK;
 }
 
-::grpc::Status P4Service::StreamChannel(
-    ::grpc::ServerContext* context, ServerStreamChannelReaderWriter* stream) {
+// The handler of a StreamChannel RPC. It lives until the RPC is done, and
+// holds the SDN connection of the controller on the other side of the stream.
+// The messages are exchanged serialized: the requests are parsed here, and the
+// responses are either serialized here, or serialized once by the
+// SdnControllerManager for all the connections they are fanned out to.
+class P4Service::StreamChannelReactor
+    : public ServerStreamReactor<::grpc::ByteBuffer, ::grpc::ByteBuffer>,
+      public p4runtime::StreamMessageResponseWriter {
+ public:
+  StreamChannelReactor(P4Service* p4_service,
+                       ::grpc::CallbackServerContext* context)
+      // Packet outs are handled inline, a hand-off to an executor thread would
+      // cost more than the hand-off to the switch.
+      : ServerStreamReactor(FLAGS_stream_channel_max_pending_responses,
+                            /*executor=*/nullptr),
+        p4_service_(p4_service),
+        sdn_connection_(context, this),
+        node_id_(0) {
+    Start(p4_service_->OpenStreamChannel(context));
+  }
+
+  // Serializes and queues a response for writing. Thread-safe.
+  bool Write(const ::p4::v1::StreamMessageResponse& msg) override {
+    ::grpc::ByteBuffer buffer;
+    bool own_buffer;
+    ::grpc::Status status =
+        ::grpc::SerializationTraits<::p4::v1::StreamMessageResponse>::Serialize(
+            msg, &buffer, &own_buffer);
+    if (!status.ok()) {
+      LOG(ERROR) << "Failed to serialize StreamMessageResponse: "
+                 << status.error_message();
+      return false;
+    }
+    return ServerStreamReactor::Write(buffer);
+  }
+
+  // Queues an already serialized response for writing. The buffer slices are
+  // shared with the caller. Thread-safe.
+  bool WriteSerialized(const ::grpc::ByteBuffer& response) override {
+    return ServerStreamReactor::Write(response);
+  }
+
+ protected:
+  ::grpc::Status HandleRequest(const ::grpc::ByteBuffer& buffer) override {
+    // Deserialize() consumes the buffer, the copy only references its slices.
+    ::grpc::ByteBuffer request_buffer(buffer);
+    ::p4::v1::StreamMessageRequest req;
+    ::grpc::Status status =
+        ::grpc::SerializationTraits<::p4::v1::StreamMessageRequest>::
+            Deserialize(&request_buffer, &req);
+    if (!status.ok()) return status;
+    return p4_service_->HandleStreamChannelRequest(req, &node_id_,
+                                                   &sdn_connection_);
+  }
+
+  void OnClose() override {
+    p4_service_->RemoveController(node_id_, &sdn_connection_);
+  }
+
+ private:
+  P4Service* p4_service_;  // not owned by this class.
+
+  // We create a unique SDN connection object for every active connection.
+  p4runtime::SdnConnection sdn_connection_;
+
+  // The ID of the node this stream channel corresponds to. This is MUST NOT
+  // change after it is set for the first time.
+  uint64 node_id_;
+};
+
+ServerStreamChannelReactor* P4Service::StreamChannel(
+    ::grpc::CallbackServerContext* context) {
+  return new StreamChannelReactor(this, context);
+}
+
+::grpc::Status P4Service::OpenStreamChannel(
+    ::grpc::CallbackServerContext* context) {
   RETURN_IF_NOT_AUTHORIZED(auth_policy_checker_, P4Service, StreamChannel,
                            context);
 
@@ -586,109 +689,102 @@ void LogReadRequest(uint64 node_id, const ::p4::v1::ReadRequest& req,
   //    and receiving packets.
 
   // First thing to do is to ensure that we're not already handling too many
-  // connections and increment the counter by one.
+  // connections and increment the counter by one. The count is decremented by
+  // RemoveController() when the stream is closed.
   auto ret = CheckAndIncrementConnectionCount();
   if (!ret.ok()) {
     return ::grpc::Status(ToGrpcCode(ret.CanonicalCode()), ret.error_message());
   }
 
-  // We create a unique SDN connection object for every active connection.
-  auto sdn_connection =
-      absl::make_unique<p4runtime::SdnConnection>(context, stream);
+  return ::grpc::Status::OK;
+}
 
-  // The ID of the node this stream channel corresponds to. This is MUST NOT
-  // change after it is set for the first time.
-  uint64 node_id = 0;
-
-  // The cleanup object. Will call RemoveController() upon exit.
-  auto cleaner = absl::MakeCleanup([this, &node_id, &sdn_connection]() {
-    this->RemoveController(node_id, sdn_connection.get());
-  });
-
-  ::p4::v1::StreamMessageRequest req;
-  while (stream->Read(&req)) {
-    switch (req.update_case()) {
-      case ::p4::v1::StreamMessageRequest::kArbitration: {
-        if (req.arbitration().device_id() == 0) {
-          return ::grpc::Status(::grpc::StatusCode::INVALID_ARGUMENT,
-                                "Invalid node (aka device) ID.");
-        } else if (node_id == 0) {
-          node_id = req.arbitration().device_id();
-        }
-        absl::uint128 election_id =
-            absl::MakeUint128(req.arbitration().election_id().high(),
-                              req.arbitration().election_id().low());
-        if (election_id == 0) {
-          return ::grpc::Status(::grpc::StatusCode::INVALID_ARGUMENT,
-                                "Invalid election ID.");
-        }
-        // Try to add the controller to controllers_.
-        auto status = AddOrModifyController(node_id, req.arbitration(),
-                                            sdn_connection.get());
-        if (!status.ok()) {
-          return ::grpc::Status(ToGrpcCode(status.CanonicalCode()),
-                                status.error_message());
-        }
-        LOG(INFO) << "Controller " << sdn_connection->GetName()
-                  << " is connected as "
-                  << (IsMasterController(node_id, sdn_connection->GetRoleName(),
-                                         sdn_connection->GetElectionId())
-                          ? "MASTER"
-                          : "SLAVE")
-                  << " for node (aka device) with ID " << node_id << ".";
-        break;
+::grpc::Status P4Service::HandleStreamChannelRequest(
+    const ::p4::v1::StreamMessageRequest& req, uint64* node_id,
+    p4runtime::SdnConnection* sdn_connection) {
+  switch (req.update_case()) {
+    case ::p4::v1::StreamMessageRequest::kArbitration: {
+      if (req.arbitration().device_id() == 0) {
+        return ::grpc::Status(::grpc::StatusCode::INVALID_ARGUMENT,
+                              "Invalid node (aka device) ID.");
+      } else if (*node_id == 0) {
+        *node_id = req.arbitration().device_id();
+      }
+      absl::uint128 election_id =
+          absl::MakeUint128(req.arbitration().election_id().high(),
+                            req.arbitration().election_id().low());
+      if (election_id == 0) {
+        return ::grpc::Status(::grpc::StatusCode::INVALID_ARGUMENT,
+                              "Invalid election ID.");
+      }
+      // Try to add the controller to controllers_.
+      auto status = AddOrModifyController(*node_id, req.arbitration(),
+                                          sdn_connection);
+      if (!status.ok()) {
+        return ::grpc::Status(ToGrpcCode(status.CanonicalCode()),
+                              status.error_message());
+      }
+      LOG(INFO) << "Controller " << sdn_connection->GetName()
+                << " is connected as "
+                << (IsMasterController(*node_id, sdn_connection->GetRoleName(),
+                                       sdn_connection->GetElectionId())
+                        ? "MASTER"
+                        : "SLAVE")
+                << " for node (aka device) with ID " << *node_id << ".";
+      break;
+    }
+    case ::p4::v1::StreamMessageRequest::kPacket: {
+      static MetricCounter* packet_out_counter = PacketCounter("out");
+      packet_out_counter->Increment();
+      // If this stream is not the master stream generate a stream error.
+      ::util::Status status;
+      if (!IsMasterController(*node_id, sdn_connection->GetRoleName(),
+                              sdn_connection->GetElectionId())) {
+        status = MAKE_ERROR(ERR_PERMISSION_DENIED).without_logging()
+                 << "Controller " << sdn_connection->GetName()
+                 << " is not a master";
+      } else {
+        // If master, try to transmit the packet.
+        status = switch_interface_->HandleStreamMessageRequest(*node_id, req);
       }
-      case ::p4::v1::StreamMessageRequest::kPacket: {
-        // If this stream is not the master stream generate a stream error.
-        ::util::Status status;
-        if (!IsMasterController(node_id, sdn_connection->GetRoleName(),
-                                sdn_connection->GetElectionId())) {
-          status = MAKE_ERROR(ERR_PERMISSION_DENIED).without_logging()
-                   << "Controller " << sdn_connection->GetName()
-                   << " is not a master";
-        } else {
-          // If master, try to transmit the packet.
-          status = switch_interface_->HandleStreamMessageRequest(node_id, req);
-        }
-        if (!status.ok()) {
-          LOG_EVERY_N(INFO, 500) << "Failed to transmit packet: " << status;
-          auto resp = ToStreamMessageResponse(status);
-          *resp.mutable_error()->mutable_packet_out()->mutable_packet_out() =
-              req.packet();
-          sdn_connection->SendStreamMessageResponse(resp);  // Best effort.
-        }
-        break;
+      if (!status.ok()) {
+        LOG_EVERY_N(INFO, 500) << "Failed to transmit packet: " << status;
+        auto resp = ToStreamMessageResponse(status);
+        *resp.mutable_error()->mutable_packet_out()->mutable_packet_out() =
+            req.packet();
+        sdn_connection->SendStreamMessageResponse(resp);  // Best effort.
       }
-      case ::p4::v1::StreamMessageRequest::kDigestAck: {
-        // If this stream is not the master stream generate a stream error.
-        ::util::Status status;
-        if (!IsMasterController(node_id, sdn_connection->GetRoleName(),
-                                sdn_connection->GetElectionId())) {
-          status = MAKE_ERROR(ERR_PERMISSION_DENIED).without_logging()
-                   << "Controller " << sdn_connection->GetName()
-                   << " is not a master";
-        } else {
-          // If master, try to ack the digest.
-          status = switch_interface_->HandleStreamMessageRequest(node_id, req);
-        }
-        if (!status.ok()) {
-          LOG(INFO) << "Failed to ack digest: " << status;
-          // TODO(max): investigate if creating responses for every failure is
-          // too resource intensive.
-          auto resp = ToStreamMessageResponse(status);
-          *resp.mutable_error()
-               ->mutable_digest_list_ack()
-               ->mutable_digest_list_ack() = req.digest_ack();
-          sdn_connection->SendStreamMessageResponse(resp);  // Best effort.
-        }
-        break;
+      break;
+    }
+    case ::p4::v1::StreamMessageRequest::kDigestAck: {
+      // If this stream is not the master stream generate a stream error.
+      ::util::Status status;
+      if (!IsMasterController(*node_id, sdn_connection->GetRoleName(),
+                              sdn_connection->GetElectionId())) {
+        status = MAKE_ERROR(ERR_PERMISSION_DENIED).without_logging()
+                 << "Controller " << sdn_connection->GetName()
+                 << " is not a master";
+      } else {
+        // If master, try to ack the digest.
+        status = switch_interface_->HandleStreamMessageRequest(*node_id, req);
       }
-      case ::p4::v1::StreamMessageRequest::UPDATE_NOT_SET:
-      case ::p4::v1::StreamMessageRequest::kOther:
-        return ::grpc::Status(
-            ::grpc::StatusCode::INVALID_ARGUMENT,
-            "Need to specify either arbitration, packet or digest ack.");
+      if (!status.ok()) {
+        LOG(INFO) << "Failed to ack digest: " << status;
+        // TODO(max): investigate if creating responses for every failure is
+        // too resource intensive.
+        auto resp = ToStreamMessageResponse(status);
+        *resp.mutable_error()
+             ->mutable_digest_list_ack()
+             ->mutable_digest_list_ack() = req.digest_ack();
+        sdn_connection->SendStreamMessageResponse(resp);  // Best effort.
+      }
+      break;
     }
+    case ::p4::v1::StreamMessageRequest::UPDATE_NOT_SET:
+    case ::p4::v1::StreamMessageRequest::kOther:
+      return ::grpc::Status(
+          ::grpc::StatusCode::INVALID_ARGUMENT,
+          "Need to specify either arbitration, packet or digest ack.");
   }
 
   return ::grpc::Status::OK;
@@ -890,6 +986,10 @@ void P4Service::StreamResponseReceiveHandler(
     LOG(FATAL) << "Received MasterArbitrationUpdate from switch. This should "
                   "never happen!";
   }
+  if (resp.has_packet()) {
+    static MetricCounter* packet_in_counter = PacketCounter("in");
+    packet_in_counter->Increment();
+  }
   // We send the responses only to the master controller stream for this node.
   absl::ReaderMutexLock l(&controller_lock_);
   auto it = node_id_to_controller_manager_.find(node_id);
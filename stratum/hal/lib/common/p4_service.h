@@ -36,14 +36,17 @@
 namespace stratum {
 namespace hal {
 
-// Typedefs for more readable reference.
-typedef ::grpc::ServerReaderWriter<::p4::v1::StreamMessageResponse,
-                                   ::p4::v1::StreamMessageRequest>
-    ServerStreamChannelReaderWriter;
+// Typedefs for more readable reference. StreamChannel messages are exchanged
+// serialized, see P4Service::StreamChannel().
+typedef ::grpc::ServerBidiReactor<::grpc::ByteBuffer, ::grpc::ByteBuffer>
+    ServerStreamChannelReactor;
 
 // The "P4Service" class implements P4Runtime::Service. It handles all
-// the RPCs that are part of the P4-based PI API.
-class P4Service final : public ::p4::v1::P4Runtime::Service {
+// the RPCs that are part of the P4-based PI API. StreamChannel uses the gRPC
+// callback API, so that the open streams do not pin server threads.
+class P4Service final
+    : public ::p4::v1::P4Runtime::WithRawCallbackMethod_StreamChannel<
+          ::p4::v1::P4Runtime::Service> {
  public:
   P4Service(OperationMode mode, SwitchInterface* switch_interface,
             AuthPolicyChecker* auth_policy_checker, ErrorBuffer* error_buffer);
@@ -99,10 +102,11 @@ class P4Service final : public ::p4::v1::P4Runtime::Service {
       LOCKS_EXCLUDED(config_lock_);
 
   // Bidirectional channel between controller and the switch for packet I/O,
-  // master arbitration and stream errors.
-  ::grpc::Status StreamChannel(
-      ::grpc::ServerContext* context,
-      ServerStreamChannelReaderWriter* stream) override;
+  // master arbitration and stream errors. The handler works on the serialized
+  // messages, so that a response sent to several controllers (e.g. a PacketIn
+  // for multiple roles) is serialized once and its buffer shared.
+  ServerStreamChannelReactor* StreamChannel(
+      ::grpc::CallbackServerContext* context) override;
 
   // Offers a mechanism through which a P4Runtime client can discover the
   // capabilities of the P4Runtime server implementation.
@@ -124,9 +128,25 @@ class P4Service final : public ::p4::v1::P4Runtime::Service {
     uint64 node_id;
   };
 
+  // The handler of a StreamChannel RPC.
+  class StreamChannelReactor;
+
   // Specifies the max number of controllers that can connect for a node.
   static constexpr size_t kMaxNumControllerPerNode = 5;
 
+  // Authorizes a new StreamChannel and accounts for it in the connection
+  // count. Called when the stream is opened.
+  ::grpc::Status OpenStreamChannel(::grpc::CallbackServerContext* context)
+      LOCKS_EXCLUDED(controller_lock_);
+
+  // Handles a request received on a StreamChannel. 'node_id' is the node the
+  // stream belongs to, set by the first arbitration update. Returning an error
+  // closes the stream.
+  ::grpc::Status HandleStreamChannelRequest(
+      const ::p4::v1::StreamMessageRequest& req, uint64* node_id,
+      p4runtime::SdnConnection* sdn_connection)
+      LOCKS_EXCLUDED(controller_lock_);
+
   // Checks and increments the number of active connections to make sure we do
   // not end with so many dangling threads. Called for every newly connected
   // controller, and before `AddOrModifyController`.
@@ -0,0 +1,52 @@
+// Copyright 2024 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#include "stratum/hal/lib/common/server_stream_reactor.h"
+
+#include <utility>
+
+#include "stratum/glue/logging.h"
+
+namespace stratum {
+namespace hal {
+
+ServerStreamExecutor::ServerStreamExecutor(int num_threads)
+    : shutdown_(false) {
+  CHECK_GT(num_threads, 0) << "A ServerStreamExecutor needs a thread.";
+  threads_.reserve(num_threads);
+  for (int i = 0; i < num_threads; ++i) {
+    threads_.emplace_back([this]() { Run(); });
+  }
+}
+
+ServerStreamExecutor::~ServerStreamExecutor() {
+  {
+    absl::MutexLock l(&lock_);
+    shutdown_ = true;
+  }
+  for (auto& thread : threads_) thread.join();
+}
+
+void ServerStreamExecutor::Schedule(std::function<void()> task) {
+  absl::MutexLock l(&lock_);
+  tasks_.push_back(std::move(task));
+}
+
+void ServerStreamExecutor::Run() {
+  while (true) {
+    std::function<void()> task;
+    {
+      absl::MutexLock l(&lock_);
+      lock_.Await(
+          absl::Condition(this, &ServerStreamExecutor::HasTaskOrShutdown));
+      // The tasks still scheduled at shutdown are run first.
+      if (tasks_.empty()) return;
+      task = std::move(tasks_.front());
+      tasks_.pop_front();
+    }
+    task();
+  }
+}
+
+}  // namespace hal
+}  // namespace stratum
@@ -0,0 +1,234 @@
+// Copyright 2024 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef STRATUM_HAL_LIB_COMMON_SERVER_STREAM_REACTOR_H_
+#define STRATUM_HAL_LIB_COMMON_SERVER_STREAM_REACTOR_H_
+
+#include <deque>
+#include <functional>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/synchronization/mutex.h"
+#include "grpcpp/grpcpp.h"
+#include "grpcpp/support/server_callback.h"
+#include "stratum/hal/lib/common/writer_interface.h"
+
+namespace stratum {
+namespace hal {
+
+// A fixed set of threads which handles the requests of the streams that can
+// block, e.g. on the switch, so that they do not stall the gRPC callback
+// threads. Owned by a service and shared by all its streams. The tasks are run
+// in the order they are scheduled.
+class ServerStreamExecutor {
+ public:
+  explicit ServerStreamExecutor(int num_threads);
+
+  // Runs the tasks still scheduled, then stops the threads.
+  ~ServerStreamExecutor();
+
+  // Schedules a task to run on one of the threads. Thread-safe.
+  void Schedule(std::function<void()> task) LOCKS_EXCLUDED(lock_);
+
+  // ServerStreamExecutor is neither copyable nor movable.
+  ServerStreamExecutor(const ServerStreamExecutor&) = delete;
+  ServerStreamExecutor& operator=(const ServerStreamExecutor&) = delete;
+
+ private:
+  // The loop of the threads, which runs the tasks until shutdown.
+  void Run() LOCKS_EXCLUDED(lock_);
+
+  // Returns true if a task is scheduled or the executor is shutting down.
+  bool HasTaskOrShutdown() const EXCLUSIVE_LOCKS_REQUIRED(lock_) {
+    return !tasks_.empty() || shutdown_;
+  }
+
+  // Protects the scheduled tasks and the shutdown state.
+  absl::Mutex lock_;
+
+  // The tasks waiting for a thread.
+  std::deque<std::function<void()>> tasks_ GUARDED_BY(lock_);
+
+  // Set once the executor is being destroyed.
+  bool shutdown_ GUARDED_BY(lock_);
+
+  // The threads running the tasks.
+  std::vector<std::thread> threads_;
+};
+
+// Base class of the handlers of the bidirectional streaming RPCs implemented
+// with the gRPC callback API. The callbacks run on the small, fixed set of
+// threads polling the gRPC completion queues, so an open stream does not pin a
+// server thread for its lifetime. The reactor deletes itself once the RPC is
+// done.
+//
+// The reactor is the WriterInterface of its stream, so it can be handed to the
+// code that writes the responses. Write() does not block: the responses are
+// queued and sent in order, one at a time. The requests are passed to
+// HandleRequest(), one at a time, in order. Requests that can block are
+// handled on the executor of the service instead of a callback thread.
+template <typename Request, typename Response>
+class ServerStreamReactor : public ::grpc::ServerBidiReactor<Request, Response>,
+                            public WriterInterface<Response> {
+ public:
+  // At most 'max_pending_writes' responses are queued for a slow client, the
+  // writes beyond that fail. 0 means no limit. 'executor' handles the requests
+  // if HandleRequest() can block, it must outlive the RPC. Null if the
+  // requests are handled on the gRPC callback threads.
+  ServerStreamReactor(size_t max_pending_writes,
+                      ServerStreamExecutor* executor)
+      : max_pending_writes_(max_pending_writes),
+        executor_(executor),
+        write_in_flight_(false),
+        write_failed_(false),
+        finish_requested_(false),
+        finish_status_() {}
+  ~ServerStreamReactor() override {}
+
+  // Queues a response to be written to the stream. Thread-safe. Returns false
+  // if the stream is broken or finishing, or if too many responses are queued.
+  bool Write(const Response& msg) override LOCKS_EXCLUDED(lock_) {
+    const Response* next = nullptr;
+    {
+      absl::MutexLock l(&lock_);
+      if (write_failed_ || finish_requested_) return false;
+      if (max_pending_writes_ != 0 &&
+          pending_writes_.size() >= max_pending_writes_) {
+        return false;
+      }
+      // References to the elements of a deque stay valid while elements are
+      // added at the back.
+      pending_writes_.push_back(msg);
+      if (!write_in_flight_) {
+        write_in_flight_ = true;
+        next = &pending_writes_.front();
+      }
+    }
+    // Only one write can be in flight, and the callback may run inline.
+    if (next != nullptr) this->StartWrite(next);
+    return true;
+  }
+
+  // ServerStreamReactor is neither copyable nor movable.
+  ServerStreamReactor(const ServerStreamReactor&) = delete;
+  ServerStreamReactor& operator=(const ServerStreamReactor&) = delete;
+
+ protected:
+  // Starts the stream: reads the requests if the status is OK, or finishes the
+  // RPC with the status otherwise. To be called once, when the derived class
+  // is fully constructed.
+  void Start(const ::grpc::Status& status) {
+    if (status.ok()) {
+      this->StartRead(&request_);
+    } else {
+      FinishStream(status);
+    }
+  }
+
+  // Handles a request received from the client. Returning an error closes the
+  // stream with that status.
+  virtual ::grpc::Status HandleRequest(const Request& req) = 0;
+
+  // Called when the client is done writing or the stream is broken. Returns
+  // the final status of the RPC.
+  virtual ::grpc::Status HandleReadsDone() { return ::grpc::Status::OK; }
+
+  // Called once, after the last request and before the RPC is finished. Must
+  // release everything that can still write to this stream.
+  virtual void OnClose() {}
+
+ private:
+  void OnReadDone(bool ok) override {
+    if (executor_ != nullptr) {
+      // The reactor outlives the task, as the RPC is only finished by it.
+      executor_->Schedule([this, ok]() { ProcessRead(ok); });
+    } else {
+      ProcessRead(ok);
+    }
+  }
+
+  // Handles the outcome of a read, then reads the next request or finishes
+  // the RPC.
+  void ProcessRead(bool ok) {
+    ::grpc::Status status = ok ? HandleRequest(request_) : HandleReadsDone();
+    if (ok && status.ok()) {
+      this->StartRead(&request_);
+      return;
+    }
+    OnClose();
+    FinishStream(status);
+  }
+
+  void OnWriteDone(bool ok) override LOCKS_EXCLUDED(lock_) {
+    const Response* next = nullptr;
+    bool finish = false;
+    {
+      absl::MutexLock l(&lock_);
+      pending_writes_.pop_front();
+      if (!ok) {
+        // The stream is broken, the remaining responses can't be sent.
+        write_failed_ = true;
+        pending_writes_.clear();
+      }
+      if (!pending_writes_.empty()) {
+        next = &pending_writes_.front();
+      } else {
+        write_in_flight_ = false;
+        finish = finish_requested_;
+      }
+    }
+    if (next != nullptr) {
+      this->StartWrite(next);
+    } else if (finish) {
+      this->Finish(finish_status_);
+    }
+  }
+
+  void OnDone() override { delete this; }
+
+  // Finishes the RPC with the given status once the queued responses are sent.
+  void FinishStream(const ::grpc::Status& status) LOCKS_EXCLUDED(lock_) {
+    {
+      absl::MutexLock l(&lock_);
+      if (finish_requested_) return;
+      finish_requested_ = true;
+      finish_status_ = status;
+      // Otherwise OnWriteDone() finishes the RPC after the last write.
+      if (write_in_flight_) return;
+    }
+    this->Finish(status);
+  }
+
+  // Maximum number of queued responses, 0 for no limit.
+  const size_t max_pending_writes_;
+
+  // Handles the requests off the gRPC callback threads if not null. Not owned
+  // by this class.
+  ServerStreamExecutor* const executor_;
+
+  // Protects the write queue and the finish state.
+  absl::Mutex lock_;
+
+  // Responses waiting to be written. The front one is in flight if
+  // write_in_flight_ is true.
+  std::deque<Response> pending_writes_ GUARDED_BY(lock_);
+  bool write_in_flight_ GUARDED_BY(lock_);
+
+  // Set when a write failed, i.e. the stream is broken.
+  bool write_failed_ GUARDED_BY(lock_);
+
+  // Set once FinishStream() is called. The final status is not modified
+  // afterwards.
+  bool finish_requested_ GUARDED_BY(lock_);
+  ::grpc::Status finish_status_;
+
+  // The request being read. Only accessed by the read callbacks.
+  Request request_;
+};
+
+}  // namespace hal
+}  // namespace stratum
+
+#endif  // STRATUM_HAL_LIB_COMMON_SERVER_STREAM_REACTOR_H_
@@ -0,0 +1,256 @@
+// Copyright 2024 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#include "stratum/hal/lib/common/server_stream_reactor.h"
+
+#include <memory>
+#include <set>
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "absl/memory/memory.h"
+#include "absl/strings/numbers.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/synchronization/notification.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
+#include "grpcpp/generic/async_generic_service.h"
+#include "grpcpp/grpcpp.h"
+#include "grpcpp/support/sync_stream.h"
+#include "gtest/gtest.h"
+
+namespace stratum {
+namespace hal {
+namespace {
+
+constexpr char kMethod[] = "/stratum.test.Stream/Chat";
+
+// Large enough for the first response to stay in flight until the client
+// reads it, as the client does not grant the flow control window before.
+constexpr size_t kLargeResponseSize = 1 << 20;
+
+::grpc::ByteBuffer ToByteBuffer(const std::string& str) {
+  ::grpc::Slice slice(str);
+  return ::grpc::ByteBuffer(&slice, 1);
+}
+
+std::string FromByteBuffer(const ::grpc::ByteBuffer& buffer) {
+  std::vector<::grpc::Slice> slices;
+  EXPECT_TRUE(buffer.Dump(&slices).ok());
+  std::string str;
+  for (const auto& slice : slices) {
+    str.append(reinterpret_cast<const char*>(slice.begin()), slice.size());
+  }
+  return str;
+}
+
+// What the test reactors saw, checked by the tests once the RPC is done.
+struct ReactorResult {
+  absl::Mutex lock;
+  // The return values of the Write() calls made by the reactor.
+  std::vector<bool> writes GUARDED_BY(lock);
+  bool closed GUARDED_BY(lock) = false;
+  absl::Notification done;
+};
+
+// A reactor which answers each request "<n>" with n large responses. A
+// request "<n> finish" also finishes the RPC with an ABORTED status right after
+// queueing the responses.
+class TestReactor
+    : public ServerStreamReactor<::grpc::ByteBuffer, ::grpc::ByteBuffer> {
+ public:
+  TestReactor(size_t max_pending_writes, ServerStreamExecutor* executor,
+              ReactorResult* result)
+      : ServerStreamReactor(max_pending_writes, executor),
+        result_(result) {
+    Start(::grpc::Status::OK);
+  }
+  ~TestReactor() override { result_->done.Notify(); }
+
+ protected:
+  ::grpc::Status HandleRequest(const ::grpc::ByteBuffer& req) override {
+    const std::string request = FromByteBuffer(req);
+    const bool finish = request.find(" finish") != std::string::npos;
+    int num_responses = 0;
+    EXPECT_TRUE(absl::SimpleAtoi(request.substr(0, request.find(' ')),
+                                 &num_responses));
+    for (int i = 0; i < num_responses; ++i) {
+      std::string response(kLargeResponseSize, 'x');
+      response.replace(0, std::to_string(i).size(), std::to_string(i));
+      const bool ok = Write(ToByteBuffer(response));
+      absl::MutexLock l(&result_->lock);
+      result_->writes.push_back(ok);
+    }
+    if (finish) return ::grpc::Status(::grpc::StatusCode::ABORTED, "finish");
+    return ::grpc::Status::OK;
+  }
+
+  void OnClose() override {
+    absl::MutexLock l(&result_->lock);
+    result_->closed = true;
+  }
+
+ private:
+  ReactorResult* result_;  // not owned by this class.
+};
+
+class TestService : public ::grpc::CallbackGenericService {
+ public:
+  // The requests are handled on the gRPC callback threads if 'executor' is
+  // null.
+  TestService(size_t max_pending_writes, ServerStreamExecutor* executor)
+      : max_pending_writes_(max_pending_writes), executor_(executor) {}
+
+  ::grpc::ServerGenericBidiReactor* CreateReactor(
+      ::grpc::GenericCallbackServerContext* context) override {
+    return new TestReactor(max_pending_writes_, executor_, &result_);
+  }
+
+  ReactorResult* result() { return &result_; }
+
+ private:
+  const size_t max_pending_writes_;
+  ServerStreamExecutor* executor_;  // not owned by this class.
+  ReactorResult result_;
+};
+
+typedef ::grpc::ClientReaderWriter<::grpc::ByteBuffer, ::grpc::ByteBuffer>
+    ClientStream;
+
+class ServerStreamReactorTest : public ::testing::TestWithParam<bool> {
+ protected:
+  static constexpr size_t kMaxPendingWrites = 4;
+
+  void SetUp() override {
+    if (GetParam()) executor_ = absl::make_unique<ServerStreamExecutor>(2);
+    service_ = absl::make_unique<TestService>(kMaxPendingWrites,
+                                              executor_.get());
+    ::grpc::ServerBuilder builder;
+    builder.RegisterCallbackGenericService(service_.get());
+    server_ = builder.BuildAndStart();
+    ASSERT_NE(server_, nullptr);
+    channel_ = server_->InProcessChannel(::grpc::ChannelArguments());
+  }
+
+  void TearDown() override { server_->Shutdown(); }
+
+  std::unique_ptr<ClientStream> OpenStream(::grpc::ClientContext* context) {
+    return std::unique_ptr<ClientStream>(
+        ::grpc::internal::ClientReaderWriterFactory<
+            ::grpc::ByteBuffer, ::grpc::ByteBuffer>::
+            Create(channel_.get(),
+                   ::grpc::internal::RpcMethod(
+                       kMethod, ::grpc::internal::RpcMethod::BIDI_STREAMING),
+                   context));
+  }
+
+  // Reads the responses until the server finishes the stream.
+  static std::vector<std::string> ReadAll(ClientStream* stream) {
+    std::vector<std::string> responses;
+    ::grpc::ByteBuffer buffer;
+    while (stream->Read(&buffer)) {
+      responses.push_back(FromByteBuffer(buffer).substr(0, 1));
+    }
+    return responses;
+  }
+
+  // Waits until the reactor of the test stream is destroyed.
+  bool WaitForReactorDone() {
+    return service_->result()->done.WaitForNotificationWithTimeout(
+        absl::Seconds(10));
+  }
+
+  std::unique_ptr<ServerStreamExecutor> executor_;
+  std::unique_ptr<TestService> service_;
+  std::unique_ptr<::grpc::Server> server_;
+  std::shared_ptr<::grpc::Channel> channel_;
+};
+
+constexpr size_t ServerStreamReactorTest::kMaxPendingWrites;
+
+TEST_P(ServerStreamReactorTest, WritesBeyondMaxPendingWritesFail) {
+  ::grpc::ClientContext context;
+  auto stream = OpenStream(&context);
+  ASSERT_TRUE(stream->Write(ToByteBuffer("10")));
+  ASSERT_TRUE(stream->WritesDone());
+
+  // The client does not read before the server queued all the responses, so
+  // only the first kMaxPendingWrites fit in the queue.
+  absl::SleepFor(absl::Milliseconds(100));
+  EXPECT_EQ(std::vector<std::string>({"0", "1", "2", "3"}),
+            ReadAll(stream.get()));
+  EXPECT_TRUE(stream->Finish().ok());
+  ASSERT_TRUE(WaitForReactorDone());
+
+  absl::MutexLock l(&service_->result()->lock);
+  std::vector<bool> expected_writes(10, false);
+  for (size_t i = 0; i < kMaxPendingWrites; ++i) expected_writes[i] = true;
+  EXPECT_EQ(expected_writes, service_->result()->writes);
+  EXPECT_TRUE(service_->result()->closed);
+}
+
+TEST_P(ServerStreamReactorTest, FinishWaitsForPendingWrites) {
+  ::grpc::ClientContext context;
+  auto stream = OpenStream(&context);
+  ASSERT_TRUE(stream->Write(ToByteBuffer("3 finish")));
+
+  // The responses queued before the error are all delivered, the error is
+  // only reported after them.
+  EXPECT_EQ(std::vector<std::string>({"0", "1", "2"}), ReadAll(stream.get()));
+  ::grpc::Status status = stream->Finish();
+  EXPECT_EQ(::grpc::StatusCode::ABORTED, status.error_code());
+  EXPECT_EQ("finish", status.error_message());
+  ASSERT_TRUE(WaitForReactorDone());
+
+  absl::MutexLock l(&service_->result()->lock);
+  EXPECT_EQ(std::vector<bool>({true, true, true}),
+            service_->result()->writes);
+  EXPECT_TRUE(service_->result()->closed);
+}
+
+TEST_P(ServerStreamReactorTest, CancelDropsPendingWrites) {
+  ::grpc::ClientContext context;
+  auto stream = OpenStream(&context);
+  ASSERT_TRUE(stream->Write(ToByteBuffer("3")));
+  ::grpc::ByteBuffer buffer;
+  ASSERT_TRUE(stream->Read(&buffer));
+
+  // The remaining responses are never read, the reactor must still be done.
+  context.TryCancel();
+  EXPECT_EQ(::grpc::StatusCode::CANCELLED, stream->Finish().error_code());
+  ASSERT_TRUE(WaitForReactorDone());
+
+  absl::MutexLock l(&service_->result()->lock);
+  EXPECT_EQ(3, service_->result()->writes.size());
+  EXPECT_TRUE(service_->result()->closed);
+}
+
+INSTANTIATE_TEST_SUITE_P(ServerStreamReactorTestWithExecutor,
+                         ServerStreamReactorTest, ::testing::Bool());
+
+TEST(ServerStreamExecutorTest, RunsTasksOnItsThreads) {
+  constexpr int kNumTasks = 100;
+  absl::Mutex lock;
+  std::set<std::thread::id> thread_ids;
+  int num_run = 0;
+  {
+    ServerStreamExecutor executor(2);
+    for (int i = 0; i < kNumTasks; ++i) {
+      executor.Schedule([&lock, &thread_ids, &num_run]() {
+        absl::SleepFor(absl::Microseconds(100));
+        absl::MutexLock l(&lock);
+        thread_ids.insert(std::this_thread::get_id());
+        ++num_run;
+      });
+    }
+    // The destructor runs the tasks still scheduled.
+  }
+  EXPECT_EQ(kNumTasks, num_run);
+  EXPECT_GE(2, thread_ids.size());
+  EXPECT_EQ(0, thread_ids.count(std::this_thread::get_id()));
+}
+
+}  // namespace
+}  // namespace hal
+}  // namespace stratum
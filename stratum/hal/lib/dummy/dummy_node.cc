@@ -8,6 +8,7 @@
 
 #include "absl/memory/memory.h"
 #include "stratum/glue/logging.h"
+#include "stratum/glue/status/status_macros.h"
 #include "stratum/public/lib/error.h"
 
 namespace stratum {
@@ -37,21 +38,19 @@ namespace dummy_switch {
 
 ::util::Status DummyNode::PushForwardingPipelineConfig(
     const ::p4::v1::ForwardingPipelineConfig& config) {
-  // TODO(Yi Tseng): Implement this method.
   absl::WriterMutexLock l(&node_lock_);
-  return ::util::OkStatus();
+  return table_store_->PushP4Info(config.p4info());
 }
 
 ::util::Status DummyNode::VerifyForwardingPipelineConfig(
     const ::p4::v1::ForwardingPipelineConfig& config) {
-  // TODO(Yi Tseng): Implement this method.
   absl::ReaderMutexLock l(&node_lock_);
-  return ::util::OkStatus();
+  return DummyTableStore::VerifyP4Info(config.p4info());
 }
 
 ::util::Status DummyNode::Shutdown() {
-  // TODO(Yi Tseng): Implement this method.
   absl::WriterMutexLock l(&node_lock_);
+  table_store_->Clear();
   return ::util::OkStatus();
 }
 
@@ -68,8 +67,23 @@ namespace dummy_switch {
 
 ::util::Status DummyNode::WriteForwardingEntries(
     const ::p4::v1::WriteRequest& req, std::vector<::util::Status>* results) {
-  // TODO(Yi Tseng): Implement this method.
+  RET_CHECK(results) << "Results pointer must be non-null.";
   absl::WriterMutexLock l(&node_lock_);
+  RET_CHECK(req.atomicity() == ::p4::v1::WriteRequest::CONTINUE_ON_ERROR)
+      << "Request atomicity "
+      << ::p4::v1::WriteRequest::Atomicity_Name(req.atomicity())
+      << " is not supported.";
+  bool success = true;
+  for (const auto& update : req.updates()) {
+    ::util::Status status =
+        table_store_->WriteEntity(update.type(), update.entity());
+    success &= status.ok();
+    results->push_back(status);
+  }
+  if (!success) {
+    return MAKE_ERROR(ERR_AT_LEAST_ONE_OPER_FAILED)
+           << "One or more write operations failed.";
+  }
   return ::util::OkStatus();
 }
 
@@ -77,8 +91,21 @@ namespace dummy_switch {
     const ::p4::v1::ReadRequest& req,
     WriterInterface<::p4::v1::ReadResponse>* writer,
     std::vector<::util::Status>* details) {
-  // TODO(Yi Tseng): Implement this method.
+  RET_CHECK(writer) << "Channel writer must be non-null.";
+  RET_CHECK(details) << "Details pointer must be non-null.";
   absl::ReaderMutexLock l(&node_lock_);
+  ::p4::v1::ReadResponse resp;
+  bool success = true;
+  for (const auto& entity : req.entities()) {
+    ::util::Status status = table_store_->ReadEntity(entity, &resp);
+    success &= status.ok();
+    details->push_back(status);
+  }
+  RET_CHECK(writer->Write(resp)) << "Write to stream channel failed.";
+  if (!success) {
+    return MAKE_ERROR(ERR_AT_LEAST_ONE_OPER_FAILED)
+           << "One or more read operations failed.";
+  }
   return ::util::OkStatus();
 }
 
@@ -324,7 +351,8 @@ DummyNode::DummyNode(const uint64 id, const std::string& name, const int32 slot,
       name_(name),
       slot_(slot),
       index_(index),
-      dummy_box_(DummyBox::GetSingleton()) {}
+      dummy_box_(DummyBox::GetSingleton()),
+      table_store_(DummyTableStore::CreateInstance()) {}
 
 }  // namespace dummy_switch
 }  // namespace hal
@@ -19,6 +19,7 @@
 #include "stratum/hal/lib/common/writer_interface.h"
 #include "stratum/hal/lib/dummy/dummy_box.h"
 #include "stratum/hal/lib/dummy/dummy_global_vars.h"
+#include "stratum/hal/lib/dummy/dummy_table_store.h"
 
 namespace stratum {
 namespace hal {
@@ -81,6 +82,8 @@ class DummyNode {
   // Read and Write forwarding entries to the node.
   // The node should be able to handle tranlation between forwarding entry
   // from P4Runtime and the real binary format of the dataplane.
+  // The dummy node keeps all entries in an in-memory DummyTableStore built
+  // from the P4Info of the last pushed pipeline.
   ::util::Status WriteForwardingEntries(const ::p4::v1::WriteRequest& req,
                                         std::vector<::util::Status>* results)
       SHARED_LOCKS_REQUIRED(chassis_lock) LOCKS_EXCLUDED(node_lock_);
@@ -161,6 +164,8 @@ class DummyNode {
  protected:
   ::absl::Mutex node_lock_;
   ::absl::flat_hash_map<uint64, SingletonPortStatus> ports_state_;
+  // In-memory forwarding state of the node.
+  std::unique_ptr<DummyTableStore> table_store_ GUARDED_BY(node_lock_);
 
   // An event writer which updates node status (e.g. port status)
   // And forwards the event.
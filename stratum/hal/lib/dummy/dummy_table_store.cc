@@ -0,0 +1,996 @@
+// Copyright 2018-present Open Networking Foundation
+// SPDX-License-Identifier: Apache-2.0
+
+#include "stratum/hal/lib/dummy/dummy_table_store.h"
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/memory/memory.h"
+#include "absl/strings/str_cat.h"
+#include "stratum/glue/gtl/map_util.h"
+#include "stratum/glue/logging.h"
+#include "stratum/glue/status/status_macros.h"
+#include "stratum/public/lib/error.h"
+
+namespace stratum {
+namespace hal {
+namespace dummy_switch {
+
+namespace {
+
+// Appends a length-prefixed byte string to a match key, so that the keys of
+// two different matches can never collide.
+void AppendBytes(const std::string& bytes, std::string* key) {
+  absl::StrAppend(key, bytes.size(), ":", bytes);
+}
+
+// Returns true if the match field carries the match type from the P4Info.
+bool IsMatchTypeValid(::p4::config::v1::MatchField::MatchType match_type,
+                      const ::p4::v1::FieldMatch& field_match) {
+  switch (match_type) {
+    case ::p4::config::v1::MatchField::EXACT:
+      return field_match.has_exact();
+    case ::p4::config::v1::MatchField::LPM:
+      return field_match.has_lpm();
+    case ::p4::config::v1::MatchField::TERNARY:
+      return field_match.has_ternary();
+    case ::p4::config::v1::MatchField::RANGE:
+      return field_match.has_range();
+    case ::p4::config::v1::MatchField::OPTIONAL:
+      return field_match.has_optional();
+    default:
+      return false;
+  }
+}
+
+::util::Status CheckModifyOnly(::p4::v1::Update::Type type,
+                               const std::string& entity_name) {
+  if (type != ::p4::v1::Update::MODIFY) {
+    return MAKE_ERROR(ERR_INVALID_PARAM)
+           << "Update type " << ::p4::v1::Update::Type_Name(type)
+           << " is not supported for " << entity_name << ", only MODIFY is.";
+  }
+  return ::util::OkStatus();
+}
+
+::util::Status CheckIndex(const ::p4::v1::Index& index, int64 size,
+                          uint32 id) {
+  if (index.index() < 0 || index.index() >= size) {
+    return MAKE_ERROR(ERR_OUT_OF_RANGE)
+           << "Index " << index.index() << " is out of range for resource "
+           << id << " of size " << size << ".";
+  }
+  return ::util::OkStatus();
+}
+
+}  // namespace
+
+::util::Status DummyTableStore::VerifyP4Info(
+    const ::p4::config::v1::P4Info& p4_info) {
+  absl::flat_hash_set<uint32> table_ids;
+  absl::flat_hash_set<uint32> action_profile_ids;
+  for (const auto& action_profile : p4_info.action_profiles()) {
+    if (!action_profile_ids.insert(action_profile.preamble().id()).second) {
+      return MAKE_ERROR(ERR_INVALID_P4_INFO)
+             << "Duplicate action profile ID "
+             << action_profile.preamble().id() << ".";
+    }
+    if (action_profile.size() < 0) {
+      return MAKE_ERROR(ERR_INVALID_P4_INFO)
+             << "Action profile " << action_profile.preamble().name()
+             << " has a negative size.";
+    }
+  }
+  for (const auto& table : p4_info.tables()) {
+    if (!table_ids.insert(table.preamble().id()).second) {
+      return MAKE_ERROR(ERR_INVALID_P4_INFO)
+             << "Duplicate table ID " << table.preamble().id() << ".";
+    }
+    if (table.size() < 0) {
+      return MAKE_ERROR(ERR_INVALID_P4_INFO)
+             << "Table " << table.preamble().name() << " has a negative size.";
+    }
+    if (table.implementation_id() != 0 &&
+        !action_profile_ids.contains(table.implementation_id())) {
+      return MAKE_ERROR(ERR_INVALID_P4_INFO)
+             << "Table " << table.preamble().name()
+             << " uses unknown action profile " << table.implementation_id()
+             << ".";
+    }
+    for (const auto& match_field : table.match_fields()) {
+      switch (match_field.match_type()) {
+        case ::p4::config::v1::MatchField::EXACT:
+        case ::p4::config::v1::MatchField::LPM:
+        case ::p4::config::v1::MatchField::TERNARY:
+        case ::p4::config::v1::MatchField::RANGE:
+        case ::p4::config::v1::MatchField::OPTIONAL:
+          break;
+        default:
+          return MAKE_ERROR(ERR_INVALID_P4_INFO)
+                 << "Match field " << match_field.name() << " of table "
+                 << table.preamble().name()
+                 << " has an unsupported match type.";
+      }
+    }
+  }
+  absl::flat_hash_set<uint32> resource_ids;
+  for (const auto& counter : p4_info.counters()) {
+    if (!resource_ids.insert(counter.preamble().id()).second ||
+        counter.size() < 0) {
+      return MAKE_ERROR(ERR_INVALID_P4_INFO)
+             << "Invalid counter " << counter.ShortDebugString() << ".";
+    }
+  }
+  for (const auto& meter : p4_info.meters()) {
+    if (!resource_ids.insert(meter.preamble().id()).second ||
+        meter.size() < 0) {
+      return MAKE_ERROR(ERR_INVALID_P4_INFO)
+             << "Invalid meter " << meter.ShortDebugString() << ".";
+    }
+  }
+  for (const auto& direct_counter : p4_info.direct_counters()) {
+    if (!resource_ids.insert(direct_counter.preamble().id()).second ||
+        !table_ids.contains(direct_counter.direct_table_id())) {
+      return MAKE_ERROR(ERR_INVALID_P4_INFO)
+             << "Invalid direct counter " << direct_counter.ShortDebugString()
+             << ".";
+    }
+  }
+  for (const auto& direct_meter : p4_info.direct_meters()) {
+    if (!resource_ids.insert(direct_meter.preamble().id()).second ||
+        !table_ids.contains(direct_meter.direct_table_id())) {
+      return MAKE_ERROR(ERR_INVALID_P4_INFO)
+             << "Invalid direct meter " << direct_meter.ShortDebugString()
+             << ".";
+    }
+  }
+  return ::util::OkStatus();
+}
+
+::util::Status DummyTableStore::PushP4Info(
+    const ::p4::config::v1::P4Info& p4_info) {
+  RETURN_IF_ERROR(VerifyP4Info(p4_info));
+  Clear();
+  for (const auto& table : p4_info.tables()) {
+    auto& state = tables_[table.preamble().id()];
+    state.p4_info = table;
+    for (const auto& match_field : table.match_fields()) {
+      state.match_types[match_field.id()] = match_field.match_type();
+      if (match_field.match_type() == ::p4::config::v1::MatchField::EXACT) {
+        ++state.num_exact_fields;
+      }
+      if (match_field.match_type() == ::p4::config::v1::MatchField::TERNARY ||
+          match_field.match_type() == ::p4::config::v1::MatchField::RANGE ||
+          match_field.match_type() == ::p4::config::v1::MatchField::OPTIONAL) {
+        state.requires_priority = true;
+      }
+    }
+    for (const auto& action_ref : table.action_refs()) {
+      state.action_scopes[action_ref.id()] = action_ref.scope();
+    }
+  }
+  for (const auto& action_profile : p4_info.action_profiles()) {
+    auto& state = action_profiles_[action_profile.preamble().id()];
+    state.p4_info = action_profile;
+    for (const auto table_id : action_profile.table_ids()) {
+      const auto* table = gtl::FindOrNull(tables_, table_id);
+      if (table == nullptr) continue;
+      for (const auto& action_scope : table->action_scopes) {
+        state.action_ids.insert(action_scope.first);
+      }
+    }
+  }
+  for (const auto& counter : p4_info.counters()) {
+    auto& state = counters_[counter.preamble().id()];
+    state.size = counter.size();
+    state.data.resize(counter.size());
+  }
+  for (const auto& meter : p4_info.meters()) {
+    meters_[meter.preamble().id()].size = meter.size();
+  }
+  for (const auto& direct_counter : p4_info.direct_counters()) {
+    tables_[direct_counter.direct_table_id()].direct_counter_id =
+        direct_counter.preamble().id();
+  }
+  for (const auto& direct_meter : p4_info.direct_meters()) {
+    tables_[direct_meter.direct_table_id()].direct_meter_id =
+        direct_meter.preamble().id();
+  }
+  return ::util::OkStatus();
+}
+
+void DummyTableStore::Clear() {
+  tables_.clear();
+  action_profiles_.clear();
+  counters_.clear();
+  meters_.clear();
+}
+
+::util::Status DummyTableStore::WriteEntity(::p4::v1::Update::Type type,
+                                            const ::p4::v1::Entity& entity) {
+  switch (entity.entity_case()) {
+    case ::p4::v1::Entity::kTableEntry:
+      return WriteTableEntry(type, entity.table_entry());
+    case ::p4::v1::Entity::kActionProfileMember:
+      return WriteActionProfileMember(type, entity.action_profile_member());
+    case ::p4::v1::Entity::kActionProfileGroup:
+      return WriteActionProfileGroup(type, entity.action_profile_group());
+    case ::p4::v1::Entity::kCounterEntry:
+      return WriteCounterEntry(type, entity.counter_entry());
+    case ::p4::v1::Entity::kMeterEntry:
+      return WriteMeterEntry(type, entity.meter_entry());
+    case ::p4::v1::Entity::kDirectCounterEntry:
+      return WriteDirectCounterEntry(type, entity.direct_counter_entry());
+    case ::p4::v1::Entity::kDirectMeterEntry:
+      return WriteDirectMeterEntry(type, entity.direct_meter_entry());
+    default:
+      return MAKE_ERROR(ERR_UNIMPLEMENTED)
+             << "Unsupported entity type: " << entity.ShortDebugString();
+  }
+}
+
+::util::Status DummyTableStore::ReadEntity(const ::p4::v1::Entity& entity,
+                                           ::p4::v1::ReadResponse* resp) const {
+  switch (entity.entity_case()) {
+    case ::p4::v1::Entity::kTableEntry:
+      return ReadTableEntry(entity.table_entry(), resp);
+    case ::p4::v1::Entity::kActionProfileMember:
+      return ReadActionProfileMember(entity.action_profile_member(), resp);
+    case ::p4::v1::Entity::kActionProfileGroup:
+      return ReadActionProfileGroup(entity.action_profile_group(), resp);
+    case ::p4::v1::Entity::kCounterEntry:
+      return ReadCounterEntry(entity.counter_entry(), resp);
+    case ::p4::v1::Entity::kMeterEntry:
+      return ReadMeterEntry(entity.meter_entry(), resp);
+    case ::p4::v1::Entity::kDirectCounterEntry:
+      return ReadDirectCounterEntry(entity.direct_counter_entry(), resp);
+    case ::p4::v1::Entity::kDirectMeterEntry:
+      return ReadDirectMeterEntry(entity.direct_meter_entry(), resp);
+    default:
+      return MAKE_ERROR(ERR_UNIMPLEMENTED)
+             << "Unsupported entity type: " << entity.ShortDebugString();
+  }
+}
+
+size_t DummyTableStore::TableEntryCount(uint32 table_id) const {
+  const auto* table = gtl::FindOrNull(tables_, table_id);
+  return table == nullptr ? 0 : table->entries.size();
+}
+
+::util::Status DummyTableStore::WriteTableEntry(
+    ::p4::v1::Update::Type type, const ::p4::v1::TableEntry& entry) {
+  auto* table = gtl::FindOrNull(tables_, entry.table_id());
+  if (table == nullptr) {
+    return MAKE_ERROR(ERR_INVALID_PARAM)
+           << "Unknown table ID " << entry.table_id() << ".";
+  }
+  if (table->p4_info.is_const_table()) {
+    return MAKE_ERROR(ERR_PERMISSION_DENIED)
+           << "Table " << table->p4_info.preamble().name()
+           << " is const and cannot be written.";
+  }
+  if (entry.is_default_action()) {
+    return WriteDefaultEntry(type, table, entry);
+  }
+  std::string key;
+  RETURN_IF_ERROR(BuildMatchKey(*table, entry, &key));
+
+  switch (type) {
+    case ::p4::v1::Update::INSERT: {
+      if (table->entries.contains(key)) {
+        return MAKE_ERROR(ERR_ENTRY_EXISTS)
+               << "Entry already exists: " << entry.ShortDebugString();
+      }
+      if (IsFull(table->p4_info.size(), table->entries.size())) {
+        return MAKE_ERROR(ERR_TABLE_FULL)
+               << "Table " << table->p4_info.preamble().name() << " is full ("
+               << table->p4_info.size() << " entries).";
+      }
+      RETURN_IF_ERROR(ValidateTableAction(*table, entry.action(), false));
+      auto& stored = table->entries[key];
+      stored = entry;
+      if (table->direct_counter_id != 0 && !stored.has_counter_data()) {
+        stored.mutable_counter_data();
+      }
+      UpdateActionProfileRefs(*table, stored.action(), 1);
+      break;
+    }
+    case ::p4::v1::Update::MODIFY: {
+      auto* stored = gtl::FindOrNull(table->entries, key);
+      if (stored == nullptr) {
+        return MAKE_ERROR(ERR_ENTRY_NOT_FOUND)
+               << "Entry not found: " << entry.ShortDebugString();
+      }
+      RETURN_IF_ERROR(ValidateTableAction(*table, entry.action(), false));
+      UpdateActionProfileRefs(*table, stored->action(), -1);
+      *stored->mutable_action() = entry.action();
+      UpdateActionProfileRefs(*table, stored->action(), 1);
+      if (entry.has_counter_data()) {
+        *stored->mutable_counter_data() = entry.counter_data();
+      }
+      if (entry.has_meter_config()) {
+        *stored->mutable_meter_config() = entry.meter_config();
+      }
+      stored->set_idle_timeout_ns(entry.idle_timeout_ns());
+      stored->set_metadata(entry.metadata());
+      break;
+    }
+    case ::p4::v1::Update::DELETE: {
+      auto it = table->entries.find(key);
+      if (it == table->entries.end()) {
+        return MAKE_ERROR(ERR_ENTRY_NOT_FOUND)
+               << "Entry not found: " << entry.ShortDebugString();
+      }
+      UpdateActionProfileRefs(*table, it->second.action(), -1);
+      table->entries.erase(it);
+      break;
+    }
+    default:
+      return MAKE_ERROR(ERR_INVALID_PARAM)
+             << "Unsupported update type: " << type << ".";
+  }
+  return ::util::OkStatus();
+}
+
+::util::Status DummyTableStore::WriteDefaultEntry(
+    ::p4::v1::Update::Type type, TableState* table,
+    const ::p4::v1::TableEntry& entry) {
+  RETURN_IF_ERROR(CheckModifyOnly(type, "default entries"));
+  if (entry.match_size() != 0 || entry.priority() != 0) {
+    return MAKE_ERROR(ERR_INVALID_PARAM)
+           << "Default entries must not have a match or priority: "
+           << entry.ShortDebugString();
+  }
+  if (table->p4_info.const_default_action_id() != 0) {
+    return MAKE_ERROR(ERR_PERMISSION_DENIED)
+           << "Table " << table->p4_info.preamble().name()
+           << " has a const default action.";
+  }
+  // An update without action resets the default entry.
+  if (entry.action().type_case() != ::p4::v1::TableAction::TYPE_NOT_SET) {
+    RETURN_IF_ERROR(ValidateTableAction(*table, entry.action(), true));
+  }
+  if (table->default_entry != nullptr) {
+    UpdateActionProfileRefs(*table, table->default_entry->action(), -1);
+    table->default_entry.reset();
+  }
+  if (entry.action().type_case() != ::p4::v1::TableAction::TYPE_NOT_SET) {
+    table->default_entry = absl::make_unique<::p4::v1::TableEntry>(entry);
+    UpdateActionProfileRefs(*table, entry.action(), 1);
+  }
+  return ::util::OkStatus();
+}
+
+::util::Status DummyTableStore::WriteActionProfileMember(
+    ::p4::v1::Update::Type type, const ::p4::v1::ActionProfileMember& member) {
+  auto* profile = gtl::FindOrNull(action_profiles_, member.action_profile_id());
+  if (profile == nullptr) {
+    return MAKE_ERROR(ERR_INVALID_PARAM)
+           << "Unknown action profile ID " << member.action_profile_id() << ".";
+  }
+  if (type == ::p4::v1::Update::INSERT || type == ::p4::v1::Update::MODIFY) {
+    if (!profile->action_ids.contains(member.action().action_id())) {
+      return MAKE_ERROR(ERR_INVALID_PARAM)
+             << "Action " << member.action().action_id()
+             << " cannot be used in action profile "
+             << profile->p4_info.preamble().name() << ".";
+    }
+  }
+  switch (type) {
+    case ::p4::v1::Update::INSERT:
+      if (profile->members.contains(member.member_id())) {
+        return MAKE_ERROR(ERR_ENTRY_EXISTS)
+               << "Member already exists: " << member.ShortDebugString();
+      }
+      if (IsFull(profile->p4_info.size(), profile->members.size())) {
+        return MAKE_ERROR(ERR_TABLE_FULL)
+               << "Action profile " << profile->p4_info.preamble().name()
+               << " is full (" << profile->p4_info.size() << " members).";
+      }
+      profile->members[member.member_id()] = member;
+      break;
+    case ::p4::v1::Update::MODIFY: {
+      auto* stored = gtl::FindOrNull(profile->members, member.member_id());
+      if (stored == nullptr) {
+        return MAKE_ERROR(ERR_ENTRY_NOT_FOUND)
+               << "Member not found: " << member.ShortDebugString();
+      }
+      *stored = member;
+      break;
+    }
+    case ::p4::v1::Update::DELETE:
+      if (!profile->members.contains(member.member_id())) {
+        return MAKE_ERROR(ERR_ENTRY_NOT_FOUND)
+               << "Member not found: " << member.ShortDebugString();
+      }
+      if (profile->member_refs.contains(member.member_id())) {
+        return MAKE_ERROR(ERR_FAILED_PRECONDITION)
+               << "Member " << member.member_id()
+               << " is still used by groups or table entries.";
+      }
+      profile->members.erase(member.member_id());
+      break;
+    default:
+      return MAKE_ERROR(ERR_INVALID_PARAM)
+             << "Unsupported update type: " << type << ".";
+  }
+  return ::util::OkStatus();
+}
+
+::util::Status DummyTableStore::WriteActionProfileGroup(
+    ::p4::v1::Update::Type type, const ::p4::v1::ActionProfileGroup& group) {
+  auto* profile = gtl::FindOrNull(action_profiles_, group.action_profile_id());
+  if (profile == nullptr) {
+    return MAKE_ERROR(ERR_INVALID_PARAM)
+           << "Unknown action profile ID " << group.action_profile_id() << ".";
+  }
+  if (!profile->p4_info.with_selector()) {
+    return MAKE_ERROR(ERR_INVALID_PARAM)
+           << "Action profile " << profile->p4_info.preamble().name()
+           << " has no selector and does not support groups.";
+  }
+  if (type == ::p4::v1::Update::INSERT || type == ::p4::v1::Update::MODIFY) {
+    const int max_group_size = profile->p4_info.max_group_size();
+    if (max_group_size > 0 && group.members_size() > max_group_size) {
+      return MAKE_ERROR(ERR_INVALID_PARAM)
+             << "Group " << group.group_id() << " has " << group.members_size()
+             << " members, the maximum is " << max_group_size << ".";
+    }
+    if (group.max_size() > 0 && group.members_size() > group.max_size()) {
+      return MAKE_ERROR(ERR_INVALID_PARAM)
+             << "Group " << group.group_id() << " exceeds its max_size.";
+    }
+    absl::flat_hash_set<uint32> member_ids;
+    for (const auto& member : group.members()) {
+      if (!profile->members.contains(member.member_id())) {
+        return MAKE_ERROR(ERR_ENTRY_NOT_FOUND)
+               << "Member " << member.member_id() << " of group "
+               << group.group_id() << " does not exist.";
+      }
+      if (!member_ids.insert(member.member_id()).second) {
+        return MAKE_ERROR(ERR_INVALID_PARAM)
+               << "Duplicate member " << member.member_id() << " in group "
+               << group.group_id() << ".";
+      }
+    }
+  }
+  auto update_member_refs = [profile](const ::p4::v1::ActionProfileGroup& g,
+                                      int delta) {
+    for (const auto& member : g.members()) {
+      int& refs = profile->member_refs[member.member_id()];
+      refs += delta;
+      if (refs <= 0) profile->member_refs.erase(member.member_id());
+    }
+  };
+  switch (type) {
+    case ::p4::v1::Update::INSERT:
+      if (profile->groups.contains(group.group_id())) {
+        return MAKE_ERROR(ERR_ENTRY_EXISTS)
+               << "Group already exists: " << group.ShortDebugString();
+      }
+      if (IsFull(profile->p4_info.size(), profile->groups.size())) {
+        return MAKE_ERROR(ERR_TABLE_FULL)
+               << "Action profile " << profile->p4_info.preamble().name()
+               << " is full (" << profile->p4_info.size() << " groups).";
+      }
+      profile->groups[group.group_id()] = group;
+      update_member_refs(group, 1);
+      break;
+    case ::p4::v1::Update::MODIFY: {
+      auto* stored = gtl::FindOrNull(profile->groups, group.group_id());
+      if (stored == nullptr) {
+        return MAKE_ERROR(ERR_ENTRY_NOT_FOUND)
+               << "Group not found: " << group.ShortDebugString();
+      }
+      update_member_refs(*stored, -1);
+      *stored = group;
+      update_member_refs(*stored, 1);
+      break;
+    }
+    case ::p4::v1::Update::DELETE: {
+      auto it = profile->groups.find(group.group_id());
+      if (it == profile->groups.end()) {
+        return MAKE_ERROR(ERR_ENTRY_NOT_FOUND)
+               << "Group not found: " << group.ShortDebugString();
+      }
+      if (profile->group_refs.contains(group.group_id())) {
+        return MAKE_ERROR(ERR_FAILED_PRECONDITION)
+               << "Group " << group.group_id()
+               << " is still used by table entries.";
+      }
+      update_member_refs(it->second, -1);
+      profile->groups.erase(it);
+      break;
+    }
+    default:
+      return MAKE_ERROR(ERR_INVALID_PARAM)
+             << "Unsupported update type: " << type << ".";
+  }
+  return ::util::OkStatus();
+}
+
+::util::Status DummyTableStore::WriteCounterEntry(
+    ::p4::v1::Update::Type type, const ::p4::v1::CounterEntry& entry) {
+  RETURN_IF_ERROR(CheckModifyOnly(type, "counter entries"));
+  auto* counter = gtl::FindOrNull(counters_, entry.counter_id());
+  if (counter == nullptr) {
+    return MAKE_ERROR(ERR_INVALID_PARAM)
+           << "Unknown counter ID " << entry.counter_id() << ".";
+  }
+  if (!entry.has_index()) {
+    // A wildcard write sets all counters of the array.
+    for (auto& data : counter->data) data = entry.data();
+    return ::util::OkStatus();
+  }
+  RETURN_IF_ERROR(CheckIndex(entry.index(), counter->size, entry.counter_id()));
+  counter->data[entry.index().index()] = entry.data();
+  return ::util::OkStatus();
+}
+
+::util::Status DummyTableStore::WriteMeterEntry(
+    ::p4::v1::Update::Type type, const ::p4::v1::MeterEntry& entry) {
+  RETURN_IF_ERROR(CheckModifyOnly(type, "meter entries"));
+  auto* meter = gtl::FindOrNull(meters_, entry.meter_id());
+  if (meter == nullptr) {
+    return MAKE_ERROR(ERR_INVALID_PARAM)
+           << "Unknown meter ID " << entry.meter_id() << ".";
+  }
+  if (!entry.has_index()) {
+    return MAKE_ERROR(ERR_UNIMPLEMENTED)
+           << "Wildcard meter writes are not supported: "
+           << entry.ShortDebugString();
+  }
+  RETURN_IF_ERROR(CheckIndex(entry.index(), meter->size, entry.meter_id()));
+  // A meter entry without config resets the meter to its default.
+  if (entry.has_config()) {
+    meter->configs[entry.index().index()] = entry.config();
+  } else {
+    meter->configs.erase(entry.index().index());
+  }
+  return ::util::OkStatus();
+}
+
+::util::Status DummyTableStore::WriteDirectCounterEntry(
+    ::p4::v1::Update::Type type, const ::p4::v1::DirectCounterEntry& entry) {
+  RETURN_IF_ERROR(CheckModifyOnly(type, "direct counter entries"));
+  TableState* table = nullptr;
+  ASSIGN_OR_RETURN(auto* stored, FindStoredEntry(entry.table_entry(), &table));
+  if (table->direct_counter_id == 0) {
+    return MAKE_ERROR(ERR_INVALID_PARAM)
+           << "Table " << table->p4_info.preamble().name()
+           << " has no direct counter.";
+  }
+  *stored->mutable_counter_data() = entry.data();
+  return ::util::OkStatus();
+}
+
+::util::Status DummyTableStore::WriteDirectMeterEntry(
+    ::p4::v1::Update::Type type, const ::p4::v1::DirectMeterEntry& entry) {
+  RETURN_IF_ERROR(CheckModifyOnly(type, "direct meter entries"));
+  TableState* table = nullptr;
+  ASSIGN_OR_RETURN(auto* stored, FindStoredEntry(entry.table_entry(), &table));
+  if (table->direct_meter_id == 0) {
+    return MAKE_ERROR(ERR_INVALID_PARAM)
+           << "Table " << table->p4_info.preamble().name()
+           << " has no direct meter.";
+  }
+  if (entry.has_config()) {
+    *stored->mutable_meter_config() = entry.config();
+  } else {
+    stored->clear_meter_config();
+  }
+  return ::util::OkStatus();
+}
+
+::util::Status DummyTableStore::ReadTableEntry(
+    const ::p4::v1::TableEntry& entry, ::p4::v1::ReadResponse* resp) const {
+  std::vector<const ::p4::v1::TableEntry*> entries;
+  RETURN_IF_ERROR(FindEntries(entry, &entries));
+  for (const auto* stored : entries) {
+    AppendTableEntry(*stored, entry, resp);
+  }
+  return ::util::OkStatus();
+}
+
+::util::Status DummyTableStore::ReadActionProfileMember(
+    const ::p4::v1::ActionProfileMember& member,
+    ::p4::v1::ReadResponse* resp) const {
+  auto append_members = [&member, resp](const ActionProfileState& profile) {
+    if (member.member_id() == 0) {
+      for (const auto& e : profile.members) {
+        *resp->add_entities()->mutable_action_profile_member() = e.second;
+      }
+    } else if (const auto* stored =
+                   gtl::FindOrNull(profile.members, member.member_id())) {
+      *resp->add_entities()->mutable_action_profile_member() = *stored;
+    }
+  };
+  if (member.action_profile_id() == 0) {
+    for (const auto& e : action_profiles_) append_members(e.second);
+    return ::util::OkStatus();
+  }
+  const auto* profile =
+      gtl::FindOrNull(action_profiles_, member.action_profile_id());
+  if (profile == nullptr) {
+    return MAKE_ERROR(ERR_INVALID_PARAM)
+           << "Unknown action profile ID " << member.action_profile_id() << ".";
+  }
+  append_members(*profile);
+  return ::util::OkStatus();
+}
+
+::util::Status DummyTableStore::ReadActionProfileGroup(
+    const ::p4::v1::ActionProfileGroup& group,
+    ::p4::v1::ReadResponse* resp) const {
+  auto append_groups = [&group, resp](const ActionProfileState& profile) {
+    if (group.group_id() == 0) {
+      for (const auto& e : profile.groups) {
+        *resp->add_entities()->mutable_action_profile_group() = e.second;
+      }
+    } else if (const auto* stored =
+                   gtl::FindOrNull(profile.groups, group.group_id())) {
+      *resp->add_entities()->mutable_action_profile_group() = *stored;
+    }
+  };
+  if (group.action_profile_id() == 0) {
+    for (const auto& e : action_profiles_) append_groups(e.second);
+    return ::util::OkStatus();
+  }
+  const auto* profile =
+      gtl::FindOrNull(action_profiles_, group.action_profile_id());
+  if (profile == nullptr) {
+    return MAKE_ERROR(ERR_INVALID_PARAM)
+           << "Unknown action profile ID " << group.action_profile_id() << ".";
+  }
+  append_groups(*profile);
+  return ::util::OkStatus();
+}
+
+::util::Status DummyTableStore::ReadCounterEntry(
+    const ::p4::v1::CounterEntry& entry, ::p4::v1::ReadResponse* resp) const {
+  auto append_counters = [&entry, resp](uint32 counter_id,
+                                        const CounterState& counter) {
+    for (int64 i = 0; i < counter.size; ++i) {
+      if (entry.has_index() && entry.index().index() != i) continue;
+      auto* counter_entry = resp->add_entities()->mutable_counter_entry();
+      counter_entry->set_counter_id(counter_id);
+      counter_entry->mutable_index()->set_index(i);
+      *counter_entry->mutable_data() = counter.data[i];
+    }
+  };
+  if (entry.counter_id() == 0) {
+    for (const auto& e : counters_) append_counters(e.first, e.second);
+    return ::util::OkStatus();
+  }
+  const auto* counter = gtl::FindOrNull(counters_, entry.counter_id());
+  if (counter == nullptr) {
+    return MAKE_ERROR(ERR_INVALID_PARAM)
+           << "Unknown counter ID " << entry.counter_id() << ".";
+  }
+  if (entry.has_index()) {
+    RETURN_IF_ERROR(
+        CheckIndex(entry.index(), counter->size, entry.counter_id()));
+    auto* counter_entry = resp->add_entities()->mutable_counter_entry();
+    *counter_entry = entry;
+    *counter_entry->mutable_data() = counter->data[entry.index().index()];
+    return ::util::OkStatus();
+  }
+  append_counters(entry.counter_id(), *counter);
+  return ::util::OkStatus();
+}
+
+::util::Status DummyTableStore::ReadMeterEntry(
+    const ::p4::v1::MeterEntry& entry, ::p4::v1::ReadResponse* resp) const {
+  auto append_meter = [resp](uint32 meter_id, const MeterState& meter,
+                             int64 index) {
+    auto* meter_entry = resp->add_entities()->mutable_meter_entry();
+    meter_entry->set_meter_id(meter_id);
+    meter_entry->mutable_index()->set_index(index);
+    if (const auto* config = gtl::FindOrNull(meter.configs, index)) {
+      *meter_entry->mutable_config() = *config;
+    }
+  };
+  auto append_meters = [&append_meter](uint32 meter_id,
+                                       const MeterState& meter) {
+    for (int64 i = 0; i < meter.size; ++i) append_meter(meter_id, meter, i);
+  };
+  if (entry.meter_id() == 0) {
+    for (const auto& e : meters_) append_meters(e.first, e.second);
+    return ::util::OkStatus();
+  }
+  const auto* meter = gtl::FindOrNull(meters_, entry.meter_id());
+  if (meter == nullptr) {
+    return MAKE_ERROR(ERR_INVALID_PARAM)
+           << "Unknown meter ID " << entry.meter_id() << ".";
+  }
+  if (entry.has_index()) {
+    RETURN_IF_ERROR(CheckIndex(entry.index(), meter->size, entry.meter_id()));
+    append_meter(entry.meter_id(), *meter, entry.index().index());
+    return ::util::OkStatus();
+  }
+  append_meters(entry.meter_id(), *meter);
+  return ::util::OkStatus();
+}
+
+::util::Status DummyTableStore::ReadDirectCounterEntry(
+    const ::p4::v1::DirectCounterEntry& entry,
+    ::p4::v1::ReadResponse* resp) const {
+  std::vector<const ::p4::v1::TableEntry*> entries;
+  RETURN_IF_ERROR(FindEntries(entry.table_entry(), &entries));
+  for (const auto* stored : entries) {
+    // Entries of tables without direct counters have no counter data.
+    if (!stored->has_counter_data()) continue;
+    auto* counter_entry = resp->add_entities()->mutable_direct_counter_entry();
+    *counter_entry->mutable_table_entry() = *stored;
+    counter_entry->mutable_table_entry()->clear_counter_data();
+    counter_entry->mutable_table_entry()->clear_meter_config();
+    *counter_entry->mutable_data() = stored->counter_data();
+  }
+  return ::util::OkStatus();
+}
+
+::util::Status DummyTableStore::ReadDirectMeterEntry(
+    const ::p4::v1::DirectMeterEntry& entry,
+    ::p4::v1::ReadResponse* resp) const {
+  std::vector<const ::p4::v1::TableEntry*> entries;
+  RETURN_IF_ERROR(FindEntries(entry.table_entry(), &entries));
+  for (const auto* stored : entries) {
+    const auto* table = gtl::FindOrNull(tables_, stored->table_id());
+    if (table == nullptr || table->direct_meter_id == 0) continue;
+    auto* meter_entry = resp->add_entities()->mutable_direct_meter_entry();
+    *meter_entry->mutable_table_entry() = *stored;
+    meter_entry->mutable_table_entry()->clear_counter_data();
+    meter_entry->mutable_table_entry()->clear_meter_config();
+    if (stored->has_meter_config()) {
+      *meter_entry->mutable_config() = stored->meter_config();
+    }
+  }
+  return ::util::OkStatus();
+}
+
+::util::Status DummyTableStore::BuildMatchKey(const TableState& table,
+                                              const ::p4::v1::TableEntry& entry,
+                                              std::string* key) const {
+  if (table.requires_priority && entry.priority() <= 0) {
+    return MAKE_ERROR(ERR_INVALID_PARAM)
+           << "Table " << table.p4_info.preamble().name()
+           << " requires a positive priority: " << entry.ShortDebugString();
+  }
+  if (!table.requires_priority && entry.priority() != 0) {
+    return MAKE_ERROR(ERR_INVALID_PARAM)
+           << "Table " << table.p4_info.preamble().name()
+           << " does not support priorities: " << entry.ShortDebugString();
+  }
+  std::vector<const ::p4::v1::FieldMatch*> field_matches;
+  field_matches.reserve(entry.match_size());
+  for (const auto& field_match : entry.match()) {
+    field_matches.push_back(&field_match);
+  }
+  std::sort(field_matches.begin(), field_matches.end(),
+            [](const ::p4::v1::FieldMatch* a, const ::p4::v1::FieldMatch* b) {
+              return a->field_id() < b->field_id();
+            });
+
+  key->clear();
+  size_t num_exact_matches = 0;
+  for (size_t i = 0; i < field_matches.size(); ++i) {
+    const auto& field_match = *field_matches[i];
+    if (i > 0 && field_matches[i - 1]->field_id() == field_match.field_id()) {
+      return MAKE_ERROR(ERR_INVALID_PARAM)
+             << "Duplicate match field " << field_match.field_id() << ": "
+             << entry.ShortDebugString();
+    }
+    const auto* match_type =
+        gtl::FindOrNull(table.match_types, field_match.field_id());
+    if (match_type == nullptr) {
+      return MAKE_ERROR(ERR_INVALID_PARAM)
+             << "Unknown match field " << field_match.field_id()
+             << " for table " << table.p4_info.preamble().name() << ".";
+    }
+    if (!IsMatchTypeValid(*match_type, field_match)) {
+      return MAKE_ERROR(ERR_INVALID_PARAM)
+             << "Match field " << field_match.field_id()
+             << " has the wrong match type: " << entry.ShortDebugString();
+    }
+    absl::StrAppend(key, field_match.field_id(), "/",
+                    field_match.field_match_type_case(), "/");
+    switch (field_match.field_match_type_case()) {
+      case ::p4::v1::FieldMatch::kExact:
+        ++num_exact_matches;
+        AppendBytes(field_match.exact().value(), key);
+        break;
+      case ::p4::v1::FieldMatch::kLpm:
+        AppendBytes(field_match.lpm().value(), key);
+        absl::StrAppend(key, field_match.lpm().prefix_len(), "/");
+        break;
+      case ::p4::v1::FieldMatch::kTernary:
+        AppendBytes(field_match.ternary().value(), key);
+        AppendBytes(field_match.ternary().mask(), key);
+        break;
+      case ::p4::v1::FieldMatch::kRange:
+        AppendBytes(field_match.range().low(), key);
+        AppendBytes(field_match.range().high(), key);
+        break;
+      case ::p4::v1::FieldMatch::kOptional:
+        AppendBytes(field_match.optional().value(), key);
+        break;
+      default:
+        break;
+    }
+  }
+  // Only exact match fields are mandatory, all other fields can be omitted
+  // to express a don't care match.
+  if (num_exact_matches != table.num_exact_fields) {
+    return MAKE_ERROR(ERR_INVALID_PARAM)
+           << "Missing exact match field: " << entry.ShortDebugString();
+  }
+  absl::StrAppend(key, "p", entry.priority());
+  return ::util::OkStatus();
+}
+
+::util::Status DummyTableStore::ValidateTableAction(
+    const TableState& table, const ::p4::v1::TableAction& action,
+    bool is_default_action) const {
+  const uint32 implementation_id = table.p4_info.implementation_id();
+  switch (action.type_case()) {
+    case ::p4::v1::TableAction::kAction: {
+      if (implementation_id != 0) {
+        return MAKE_ERROR(ERR_INVALID_PARAM)
+               << "Table " << table.p4_info.preamble().name()
+               << " requires an action profile member or group.";
+      }
+      const auto* scope =
+          gtl::FindOrNull(table.action_scopes, action.action().action_id());
+      if (scope == nullptr ||
+          (is_default_action &&
+           *scope == ::p4::config::v1::ActionRef::TABLE_ONLY) ||
+          (!is_default_action &&
+           *scope == ::p4::config::v1::ActionRef::DEFAULT_ONLY)) {
+        return MAKE_ERROR(ERR_INVALID_PARAM)
+               << "Action " << action.action().action_id()
+               << " cannot be used in table " << table.p4_info.preamble().name()
+               << (is_default_action ? " as default action." : ".");
+      }
+      return ::util::OkStatus();
+    }
+    case ::p4::v1::TableAction::kActionProfileMemberId:
+    case ::p4::v1::TableAction::kActionProfileGroupId: {
+      const auto* profile =
+          gtl::FindOrNull(action_profiles_, implementation_id);
+      if (profile == nullptr) {
+        return MAKE_ERROR(ERR_INVALID_PARAM)
+               << "Table " << table.p4_info.preamble().name()
+               << " has no action profile.";
+      }
+      if (action.type_case() == ::p4::v1::TableAction::kActionProfileMemberId &&
+          !profile->members.contains(action.action_profile_member_id())) {
+        return MAKE_ERROR(ERR_ENTRY_NOT_FOUND)
+               << "Action profile member " << action.action_profile_member_id()
+               << " does not exist.";
+      }
+      if (action.type_case() == ::p4::v1::TableAction::kActionProfileGroupId &&
+          !profile->groups.contains(action.action_profile_group_id())) {
+        return MAKE_ERROR(ERR_ENTRY_NOT_FOUND)
+               << "Action profile group " << action.action_profile_group_id()
+               << " does not exist.";
+      }
+      return ::util::OkStatus();
+    }
+    case ::p4::v1::TableAction::kActionProfileActionSet:
+      return MAKE_ERROR(ERR_UNIMPLEMENTED)
+             << "One-shot action selector programming is not supported.";
+    default:
+      return MAKE_ERROR(ERR_INVALID_PARAM)
+             << "Table entry for table " << table.p4_info.preamble().name()
+             << " has no action.";
+  }
+}
+
+void DummyTableStore::UpdateActionProfileRefs(
+    const TableState& table, const ::p4::v1::TableAction& action, int delta) {
+  auto* profile =
+      gtl::FindOrNull(action_profiles_, table.p4_info.implementation_id());
+  if (profile == nullptr) return;
+  absl::flat_hash_map<uint32, int>* refs = nullptr;
+  uint32 id = 0;
+  if (action.type_case() == ::p4::v1::TableAction::kActionProfileMemberId) {
+    refs = &profile->member_refs;
+    id = action.action_profile_member_id();
+  } else if (action.type_case() ==
+             ::p4::v1::TableAction::kActionProfileGroupId) {
+    refs = &profile->group_refs;
+    id = action.action_profile_group_id();
+  } else {
+    return;
+  }
+  int& count = (*refs)[id];
+  count += delta;
+  if (count <= 0) refs->erase(id);
+}
+
+::util::StatusOr<::p4::v1::TableEntry*> DummyTableStore::FindStoredEntry(
+    const ::p4::v1::TableEntry& entry, TableState** table) {
+  *table = gtl::FindOrNull(tables_, entry.table_id());
+  if (*table == nullptr) {
+    return MAKE_ERROR(ERR_INVALID_PARAM)
+           << "Unknown table ID " << entry.table_id() << ".";
+  }
+  if (entry.is_default_action()) {
+    if ((*table)->default_entry == nullptr) {
+      return MAKE_ERROR(ERR_ENTRY_NOT_FOUND)
+             << "Table " << (*table)->p4_info.preamble().name()
+             << " has no default entry.";
+    }
+    return (*table)->default_entry.get();
+  }
+  std::string key;
+  RETURN_IF_ERROR(BuildMatchKey(**table, entry, &key));
+  auto* stored = gtl::FindOrNull((*table)->entries, key);
+  if (stored == nullptr) {
+    return MAKE_ERROR(ERR_ENTRY_NOT_FOUND)
+           << "Entry not found: " << entry.ShortDebugString();
+  }
+  return stored;
+}
+
+::util::Status DummyTableStore::FindEntries(
+    const ::p4::v1::TableEntry& request,
+    std::vector<const ::p4::v1::TableEntry*>* entries) const {
+  auto append_all = [entries](const TableState& table) {
+    entries->reserve(entries->size() + table.entries.size());
+    for (const auto& e : table.entries) entries->push_back(&e.second);
+  };
+  if (request.table_id() == 0) {
+    for (const auto& e : tables_) append_all(e.second);
+    return ::util::OkStatus();
+  }
+  const auto* table = gtl::FindOrNull(tables_, request.table_id());
+  if (table == nullptr) {
+    return MAKE_ERROR(ERR_INVALID_PARAM)
+           << "Unknown table ID " << request.table_id() << ".";
+  }
+  if (request.is_default_action()) {
+    if (table->default_entry != nullptr) {
+      entries->push_back(table->default_entry.get());
+    }
+    return ::util::OkStatus();
+  }
+  // Partial wildcards are not supported, a read either matches all entries of
+  // the table or a single one.
+  if (request.match_size() == 0 && request.priority() == 0) {
+    append_all(*table);
+    return ::util::OkStatus();
+  }
+  std::string key;
+  RETURN_IF_ERROR(BuildMatchKey(*table, request, &key));
+  const auto* stored = gtl::FindOrNull(table->entries, key);
+  if (stored != nullptr) entries->push_back(stored);
+  return ::util::OkStatus();
+}
+
+void DummyTableStore::AppendTableEntry(const ::p4::v1::TableEntry& stored,
+                                       const ::p4::v1::TableEntry& request,
+                                       ::p4::v1::ReadResponse* resp) {
+  auto* entry = resp->add_entities()->mutable_table_entry();
+  *entry = stored;
+  if (!request.has_counter_data()) entry->clear_counter_data();
+  if (!request.has_meter_config()) entry->clear_meter_config();
+}
+
+bool DummyTableStore::IsFull(int64 size, size_t count) {
+  return size > 0 && count >= static_cast<size_t>(size);
+}
+
+std::unique_ptr<DummyTableStore> DummyTableStore::CreateInstance() {
+  return absl::WrapUnique(new DummyTableStore());
+}
+
+DummyTableStore::DummyTableStore() {}
+
+}  // namespace dummy_switch
+}  // namespace hal
+}  // namespace stratum
@@ -0,0 +1,197 @@
+// Copyright 2018-present Open Networking Foundation
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef STRATUM_HAL_LIB_DUMMY_DUMMY_TABLE_STORE_H_
+#define STRATUM_HAL_LIB_DUMMY_DUMMY_TABLE_STORE_H_
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/container/flat_hash_set.h"
+#include "p4/config/v1/p4info.pb.h"
+#include "p4/v1/p4runtime.pb.h"
+#include "stratum/glue/integral_types.h"
+#include "stratum/glue/status/status.h"
+#include "stratum/glue/status/statusor.h"
+
+namespace stratum {
+namespace hal {
+namespace dummy_switch {
+
+/*
+ * In-memory forwarding state of a dummy node.
+ * The store is built from the P4Info of the pushed pipeline and keeps table
+ * entries (exact, LPM, ternary, range and optional matches), action profile
+ * members and groups, indirect counters and meters and direct counters and
+ * meters. All writes are validated against the P4Info and the capacity of
+ * the resource given in the P4Info, so controller and capacity tests see the
+ * same errors they would see on a real target. A table or action profile size
+ * of zero in the P4Info means the resource is unbounded.
+ * This class is not thread-safe, the DummyNode owning it serializes all
+ * accesses with its node lock.
+ */
+class DummyTableStore {
+ public:
+  // Verifies that the P4Info can be used to build a store.
+  static ::util::Status VerifyP4Info(const ::p4::config::v1::P4Info& p4_info);
+
+  // Replaces the P4Info of the store. All existing state is dropped.
+  ::util::Status PushP4Info(const ::p4::config::v1::P4Info& p4_info);
+
+  // Drops all forwarding state and the P4Info.
+  void Clear();
+
+  // Writes and reads a single entity. Reads append the matching entities to
+  // the given response. Wildcard reads follow the P4Runtime spec, e.g. a zero
+  // table ID reads all tables and an empty match reads all entries of a table.
+  ::util::Status WriteEntity(::p4::v1::Update::Type type,
+                             const ::p4::v1::Entity& entity);
+  ::util::Status ReadEntity(const ::p4::v1::Entity& entity,
+                            ::p4::v1::ReadResponse* resp) const;
+
+  // Returns the number of entries in a table, 0 if the table is unknown.
+  size_t TableEntryCount(uint32 table_id) const;
+
+  // Factory function for creating the instance of the class.
+  static std::unique_ptr<DummyTableStore> CreateInstance();
+
+  // DummyTableStore is neither copyable nor movable.
+  DummyTableStore(const DummyTableStore&) = delete;
+  DummyTableStore& operator=(const DummyTableStore&) = delete;
+  DummyTableStore(DummyTableStore&&) = delete;
+  DummyTableStore& operator=(DummyTableStore&&) = delete;
+
+ private:
+  // State of a single P4 table.
+  struct TableState {
+    ::p4::config::v1::Table p4_info;
+    // Match type by match field ID.
+    absl::flat_hash_map<uint32, ::p4::config::v1::MatchField::MatchType>
+        match_types;
+    // Scope of each action which can be used in the table.
+    absl::flat_hash_map<uint32, ::p4::config::v1::ActionRef::Scope>
+        action_scopes;
+    // Number of exact match fields, which must be present in every entry.
+    size_t num_exact_fields = 0;
+    // True if the table has ternary, range or optional match fields.
+    bool requires_priority = false;
+    uint32 direct_counter_id = 0;
+    uint32 direct_meter_id = 0;
+    // Entries by their canonical match key.
+    absl::flat_hash_map<std::string, ::p4::v1::TableEntry> entries;
+    // The default entry, only set after it was modified by the controller.
+    std::unique_ptr<::p4::v1::TableEntry> default_entry;
+  };
+
+  // State of an action profile or selector.
+  struct ActionProfileState {
+    ::p4::config::v1::ActionProfile p4_info;
+    // Actions allowed in members, i.e. the actions of all tables using the
+    // action profile.
+    absl::flat_hash_set<uint32> action_ids;
+    absl::flat_hash_map<uint32, ::p4::v1::ActionProfileMember> members;
+    absl::flat_hash_map<uint32, ::p4::v1::ActionProfileGroup> groups;
+    // Number of references from groups and table entries.
+    absl::flat_hash_map<uint32, int> member_refs;
+    absl::flat_hash_map<uint32, int> group_refs;
+  };
+
+  // State of an indirect counter array.
+  struct CounterState {
+    int64 size = 0;
+    std::vector<::p4::v1::CounterData> data;
+  };
+
+  // State of an indirect meter array. Only configured meters are stored.
+  struct MeterState {
+    int64 size = 0;
+    absl::flat_hash_map<int64, ::p4::v1::MeterConfig> configs;
+  };
+
+  // Private constructor, use CreateInstance() instead.
+  DummyTableStore();
+
+  // Per entity type write and read helpers.
+  ::util::Status WriteTableEntry(::p4::v1::Update::Type type,
+                                 const ::p4::v1::TableEntry& entry);
+  ::util::Status WriteDefaultEntry(::p4::v1::Update::Type type,
+                                   TableState* table,
+                                   const ::p4::v1::TableEntry& entry);
+  ::util::Status WriteActionProfileMember(
+      ::p4::v1::Update::Type type, const ::p4::v1::ActionProfileMember& member);
+  ::util::Status WriteActionProfileGroup(
+      ::p4::v1::Update::Type type, const ::p4::v1::ActionProfileGroup& group);
+  ::util::Status WriteCounterEntry(::p4::v1::Update::Type type,
+                                   const ::p4::v1::CounterEntry& entry);
+  ::util::Status WriteMeterEntry(::p4::v1::Update::Type type,
+                                 const ::p4::v1::MeterEntry& entry);
+  ::util::Status WriteDirectCounterEntry(
+      ::p4::v1::Update::Type type, const ::p4::v1::DirectCounterEntry& entry);
+  ::util::Status WriteDirectMeterEntry(::p4::v1::Update::Type type,
+                                       const ::p4::v1::DirectMeterEntry& entry);
+  ::util::Status ReadTableEntry(const ::p4::v1::TableEntry& entry,
+                                ::p4::v1::ReadResponse* resp) const;
+  ::util::Status ReadActionProfileMember(
+      const ::p4::v1::ActionProfileMember& member,
+      ::p4::v1::ReadResponse* resp) const;
+  ::util::Status ReadActionProfileGroup(
+      const ::p4::v1::ActionProfileGroup& group,
+      ::p4::v1::ReadResponse* resp) const;
+  ::util::Status ReadCounterEntry(const ::p4::v1::CounterEntry& entry,
+                                  ::p4::v1::ReadResponse* resp) const;
+  ::util::Status ReadMeterEntry(const ::p4::v1::MeterEntry& entry,
+                                ::p4::v1::ReadResponse* resp) const;
+  ::util::Status ReadDirectCounterEntry(
+      const ::p4::v1::DirectCounterEntry& entry,
+      ::p4::v1::ReadResponse* resp) const;
+  ::util::Status ReadDirectMeterEntry(const ::p4::v1::DirectMeterEntry& entry,
+                                      ::p4::v1::ReadResponse* resp) const;
+
+  // Validates the match of a table entry against the table and builds the
+  // canonical key of the entry, independent of the match field order.
+  ::util::Status BuildMatchKey(const TableState& table,
+                               const ::p4::v1::TableEntry& entry,
+                               std::string* key) const;
+
+  // Validates the action of a table entry and, for action profile tables,
+  // checks that the referenced member or group exists.
+  ::util::Status ValidateTableAction(const TableState& table,
+                                     const ::p4::v1::TableAction& action,
+                                     bool is_default_action) const;
+
+  // Updates the reference count of the member or group used by the action.
+  void UpdateActionProfileRefs(const TableState& table,
+                               const ::p4::v1::TableAction& action, int delta);
+
+  // Looks up the stored entry referenced by a direct counter or meter entry.
+  ::util::StatusOr<::p4::v1::TableEntry*> FindStoredEntry(
+      const ::p4::v1::TableEntry& entry, TableState** table);
+
+  // Collects the stored entries matched by a (possibly wildcard) read request
+  // for table entries, direct counters or direct meters.
+  ::util::Status FindEntries(const ::p4::v1::TableEntry& request,
+                             std::vector<const ::p4::v1::TableEntry*>* entries)
+      const;
+
+  // Appends a table entry to the response, omitting direct resource data
+  // which was not requested.
+  static void AppendTableEntry(const ::p4::v1::TableEntry& stored,
+                               const ::p4::v1::TableEntry& request,
+                               ::p4::v1::ReadResponse* resp);
+
+  // Returns true if a resource of the given size cannot take another entry.
+  static bool IsFull(int64 size, size_t count);
+
+  absl::flat_hash_map<uint32, TableState> tables_;
+  absl::flat_hash_map<uint32, ActionProfileState> action_profiles_;
+  absl::flat_hash_map<uint32, CounterState> counters_;
+  absl::flat_hash_map<uint32, MeterState> meters_;
+};
+
+}  // namespace dummy_switch
+}  // namespace hal
+}  // namespace stratum
+
+#endif  // STRATUM_HAL_LIB_DUMMY_DUMMY_TABLE_STORE_H_
@@ -0,0 +1,478 @@
+// Copyright 2018-present Open Networking Foundation
+// SPDX-License-Identifier: Apache-2.0
+
+#include "stratum/hal/lib/dummy/dummy_table_store.h"
+
+#include <memory>
+#include <string>
+
+#include "absl/strings/str_cat.h"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "stratum/glue/status/status_test_util.h"
+#include "stratum/lib/test_utils/matchers.h"
+#include "stratum/lib/utils.h"
+#include "stratum/public/lib/error.h"
+
+namespace stratum {
+namespace hal {
+namespace dummy_switch {
+
+using test_utils::EqualsProto;
+
+constexpr char kTestP4Info[] = R"pb(
+  tables {
+    preamble { id: 1 name: "exact_table" }
+    match_fields { id: 1 name: "port" bitwidth: 9 match_type: EXACT }
+    action_refs { id: 100 }
+    action_refs { id: 101 scope: DEFAULT_ONLY }
+    size: 2
+  }
+  tables {
+    preamble { id: 2 name: "lpm_table" }
+    match_fields { id: 1 name: "dst_addr" bitwidth: 32 match_type: LPM }
+    action_refs { id: 100 }
+    size: 1024
+  }
+  tables {
+    preamble { id: 3 name: "acl_table" }
+    match_fields { id: 1 name: "eth_type" bitwidth: 16 match_type: TERNARY }
+    match_fields { id: 2 name: "l4_port" bitwidth: 16 match_type: RANGE }
+    action_refs { id: 100 }
+    direct_resource_ids: 500
+    direct_resource_ids: 600
+    size: 1024
+  }
+  tables {
+    preamble { id: 4 name: "ecmp_table" }
+    match_fields { id: 1 name: "hash" bitwidth: 16 match_type: EXACT }
+    action_refs { id: 100 }
+    implementation_id: 200
+    size: 1024
+  }
+  actions { preamble { id: 100 name: "fwd" } }
+  actions { preamble { id: 101 name: "drop" } }
+  action_profiles {
+    preamble { id: 200 name: "ecmp_selector" }
+    table_ids: 4
+    with_selector: true
+    size: 16
+    max_group_size: 2
+  }
+  counters {
+    preamble { id: 300 name: "port_counter" }
+    spec { unit: BOTH }
+    size: 4
+  }
+  meters {
+    preamble { id: 400 name: "port_meter" }
+    spec { unit: BYTES }
+    size: 4
+  }
+  direct_counters {
+    preamble { id: 500 name: "acl_counter" }
+    spec { unit: BOTH }
+    direct_table_id: 3
+  }
+  direct_meters {
+    preamble { id: 600 name: "acl_meter" }
+    spec { unit: BYTES }
+    direct_table_id: 3
+  }
+)pb";
+
+class DummyTableStoreTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    table_store_ = DummyTableStore::CreateInstance();
+    ::p4::config::v1::P4Info p4_info;
+    ASSERT_OK(ParseProtoFromString(kTestP4Info, &p4_info));
+    ASSERT_OK(table_store_->PushP4Info(p4_info));
+  }
+
+  ::util::Status Write(::p4::v1::Update::Type type,
+                       const std::string& entity_text) {
+    ::p4::v1::Entity entity;
+    RETURN_IF_ERROR(ParseProtoFromString(entity_text, &entity));
+    return table_store_->WriteEntity(type, entity);
+  }
+
+  ::util::StatusOr<::p4::v1::ReadResponse> Read(
+      const std::string& entity_text) {
+    ::p4::v1::Entity entity;
+    RETURN_IF_ERROR(ParseProtoFromString(entity_text, &entity));
+    ::p4::v1::ReadResponse resp;
+    RETURN_IF_ERROR(table_store_->ReadEntity(entity, &resp));
+    return resp;
+  }
+
+  std::unique_ptr<DummyTableStore> table_store_;
+};
+
+TEST_F(DummyTableStoreTest, ExactTableInsertModifyDelete) {
+  const std::string kEntry = R"pb(
+    table_entry {
+      table_id: 1
+      match { field_id: 1 exact { value: "\x01" } }
+      action { action { action_id: 100 } }
+    }
+  )pb";
+  EXPECT_OK(Write(::p4::v1::Update::INSERT, kEntry));
+  EXPECT_EQ(ERR_ENTRY_EXISTS,
+            Write(::p4::v1::Update::INSERT, kEntry).error_code());
+  EXPECT_OK(Write(::p4::v1::Update::MODIFY, kEntry));
+  EXPECT_EQ(1, table_store_->TableEntryCount(1));
+
+  auto resp = Read("table_entry { table_id: 1 }");
+  ASSERT_OK(resp);
+  ::p4::v1::ReadResponse expected;
+  ASSERT_OK(ParseProtoFromString("entities { " + kEntry + " }", &expected));
+  EXPECT_THAT(resp.ValueOrDie(), EqualsProto(expected));
+
+  EXPECT_OK(Write(::p4::v1::Update::DELETE, kEntry));
+  EXPECT_EQ(ERR_ENTRY_NOT_FOUND,
+            Write(::p4::v1::Update::DELETE, kEntry).error_code());
+  EXPECT_EQ(0, table_store_->TableEntryCount(1));
+}
+
+TEST_F(DummyTableStoreTest, TableCapacityIsEnforced) {
+  for (const char* port : {"\\x01", "\\x02"}) {
+    EXPECT_OK(Write(::p4::v1::Update::INSERT,
+                    absl::StrCat("table_entry { table_id: 1 match { field_id: "
+                                 "1 exact { value: \"",
+                                 port,
+                                 "\" } } action { action { action_id: 100 } "
+                                 "} }")));
+  }
+  EXPECT_EQ(ERR_TABLE_FULL, Write(::p4::v1::Update::INSERT, R"pb(
+                              table_entry {
+                                table_id: 1
+                                match { field_id: 1 exact { value: "\x03" } }
+                                action { action { action_id: 100 } }
+                              }
+                            )pb")
+                                .error_code());
+}
+
+TEST_F(DummyTableStoreTest, InvalidEntriesAreRejected) {
+  // Unknown table.
+  EXPECT_EQ(ERR_INVALID_PARAM, Write(::p4::v1::Update::INSERT, R"pb(
+                                 table_entry {
+                                   table_id: 99
+                                   action { action { action_id: 100 } }
+                                 }
+                               )pb")
+                                   .error_code());
+  // Missing exact match field.
+  EXPECT_EQ(ERR_INVALID_PARAM, Write(::p4::v1::Update::INSERT, R"pb(
+                                 table_entry {
+                                   table_id: 1
+                                   action { action { action_id: 100 } }
+                                 }
+                               )pb")
+                                   .error_code());
+  // Wrong match type.
+  EXPECT_EQ(ERR_INVALID_PARAM,
+            Write(::p4::v1::Update::INSERT, R"pb(
+              table_entry {
+                table_id: 2
+                match { field_id: 1 exact { value: "\x0a\x00\x00\x00" } }
+                action { action { action_id: 100 } }
+              }
+            )pb")
+                .error_code());
+  // Default only action used in a regular entry.
+  EXPECT_EQ(ERR_INVALID_PARAM, Write(::p4::v1::Update::INSERT, R"pb(
+                                 table_entry {
+                                   table_id: 1
+                                   match { field_id: 1 exact { value: "\x01" } }
+                                   action { action { action_id: 101 } }
+                                 }
+                               )pb")
+                                   .error_code());
+  // Ternary table without priority.
+  EXPECT_EQ(ERR_INVALID_PARAM,
+            Write(::p4::v1::Update::INSERT, R"pb(
+              table_entry {
+                table_id: 3
+                match {
+                  field_id: 1
+                  ternary { value: "\x08\x00" mask: "\xff\xff" }
+                }
+                action { action { action_id: 100 } }
+              }
+            )pb")
+                .error_code());
+}
+
+TEST_F(DummyTableStoreTest, LpmAndTernaryKeysDependOnPrefixAndPriority) {
+  EXPECT_OK(Write(::p4::v1::Update::INSERT, R"pb(
+    table_entry {
+      table_id: 2
+      match { field_id: 1 lpm { value: "\x0a\x00\x00\x00" prefix_len: 8 } }
+      action { action { action_id: 100 } }
+    }
+  )pb"));
+  EXPECT_OK(Write(::p4::v1::Update::INSERT, R"pb(
+    table_entry {
+      table_id: 2
+      match { field_id: 1 lpm { value: "\x0a\x00\x00\x00" prefix_len: 16 } }
+      action { action { action_id: 100 } }
+    }
+  )pb"));
+  EXPECT_EQ(2, table_store_->TableEntryCount(2));
+
+  // The match field order does not matter.
+  EXPECT_OK(Write(::p4::v1::Update::INSERT, R"pb(
+    table_entry {
+      table_id: 3
+      match { field_id: 1 ternary { value: "\x08\x00" mask: "\xff\xff" } }
+      match { field_id: 2 range { low: "\x00\x50" high: "\x00\x51" } }
+      priority: 10
+      action { action { action_id: 100 } }
+    }
+  )pb"));
+  const std::string kReorderedEntry = R"pb(
+    table_entry {
+      table_id: 3
+      match { field_id: 2 range { low: "\x00\x50" high: "\x00\x51" } }
+      match { field_id: 1 ternary { value: "\x08\x00" mask: "\xff\xff" } }
+      priority: 10
+      action { action { action_id: 100 } }
+    }
+  )pb";
+  EXPECT_EQ(ERR_ENTRY_EXISTS,
+            Write(::p4::v1::Update::INSERT, kReorderedEntry).error_code());
+  EXPECT_OK(Write(::p4::v1::Update::INSERT, R"pb(
+    table_entry {
+      table_id: 3
+      match { field_id: 1 ternary { value: "\x08\x00" mask: "\xff\xff" } }
+      match { field_id: 2 range { low: "\x00\x50" high: "\x00\x51" } }
+      priority: 20
+      action { action { action_id: 100 } }
+    }
+  )pb"));
+  EXPECT_EQ(2, table_store_->TableEntryCount(3));
+}
+
+TEST_F(DummyTableStoreTest, DirectCounterAndMeter) {
+  const std::string kMatch = R"pb(
+    table_id: 3
+    match { field_id: 1 ternary { value: "\x08\x00" mask: "\xff\xff" } }
+    priority: 10
+  )pb";
+  EXPECT_OK(Write(::p4::v1::Update::INSERT,
+                  absl::StrCat("table_entry { ", kMatch,
+                               " action { action { action_id: 100 } } }")));
+  EXPECT_OK(Write(
+      ::p4::v1::Update::MODIFY,
+      absl::StrCat("direct_counter_entry { table_entry { ", kMatch,
+                   " } data { byte_count: 10 packet_count: 1 } }")));
+  EXPECT_OK(Write(::p4::v1::Update::MODIFY,
+                  absl::StrCat("direct_meter_entry { table_entry { ", kMatch,
+                               " } config { cir: 100 cburst: 10 } }")));
+
+  auto resp = Read("direct_counter_entry { table_entry { table_id: 3 } }");
+  ASSERT_OK(resp);
+  ASSERT_EQ(1, resp.ValueOrDie().entities_size());
+  ::p4::v1::CounterData expected_data;
+  expected_data.set_byte_count(10);
+  expected_data.set_packet_count(1);
+  EXPECT_THAT(resp.ValueOrDie().entities(0).direct_counter_entry().data(),
+              EqualsProto(expected_data));
+
+  resp = Read("direct_meter_entry { table_entry { table_id: 3 } }");
+  ASSERT_OK(resp);
+  ASSERT_EQ(1, resp.ValueOrDie().entities_size());
+  ::p4::v1::MeterConfig expected_config;
+  expected_config.set_cir(100);
+  expected_config.set_cburst(10);
+  EXPECT_THAT(resp.ValueOrDie().entities(0).direct_meter_entry().config(),
+              EqualsProto(expected_config));
+
+  // Direct resources are only part of a table entry read if requested.
+  resp = Read("table_entry { table_id: 3 }");
+  ASSERT_OK(resp);
+  ASSERT_EQ(1, resp.ValueOrDie().entities_size());
+  EXPECT_FALSE(resp.ValueOrDie().entities(0).table_entry().has_counter_data());
+  resp = Read("table_entry { table_id: 3 counter_data {} }");
+  ASSERT_OK(resp);
+  ASSERT_EQ(1, resp.ValueOrDie().entities_size());
+  EXPECT_EQ(10, resp.ValueOrDie()
+                    .entities(0)
+                    .table_entry()
+                    .counter_data()
+                    .byte_count());
+}
+
+TEST_F(DummyTableStoreTest, IndirectCountersAndMeters) {
+  EXPECT_OK(Write(::p4::v1::Update::MODIFY, R"pb(
+    counter_entry {
+      counter_id: 300
+      index { index: 2 }
+      data { byte_count: 20 packet_count: 2 }
+    }
+  )pb"));
+  EXPECT_EQ(ERR_OUT_OF_RANGE, Write(::p4::v1::Update::MODIFY, R"pb(
+                                counter_entry {
+                                  counter_id: 300
+                                  index { index: 4 }
+                                }
+                              )pb")
+                                  .error_code());
+  auto resp = Read("counter_entry { counter_id: 300 }");
+  ASSERT_OK(resp);
+  ASSERT_EQ(4, resp.ValueOrDie().entities_size());
+  resp = Read("counter_entry { counter_id: 300 index { index: 2 } }");
+  ASSERT_OK(resp);
+  ASSERT_EQ(1, resp.ValueOrDie().entities_size());
+  EXPECT_EQ(20,
+            resp.ValueOrDie().entities(0).counter_entry().data().byte_count());
+
+  EXPECT_OK(Write(::p4::v1::Update::MODIFY, R"pb(
+    meter_entry {
+      meter_id: 400
+      index { index: 1 }
+      config { cir: 1000 cburst: 100 pir: 2000 pburst: 200 }
+    }
+  )pb"));
+  resp = Read("meter_entry { meter_id: 400 index { index: 1 } }");
+  ASSERT_OK(resp);
+  ASSERT_EQ(1, resp.ValueOrDie().entities_size());
+  EXPECT_EQ(1000, resp.ValueOrDie().entities(0).meter_entry().config().cir());
+  EXPECT_EQ(ERR_INVALID_PARAM,
+            Write(::p4::v1::Update::INSERT,
+                  "meter_entry { meter_id: 400 index { index: 1 } }")
+                .error_code());
+}
+
+TEST_F(DummyTableStoreTest, ActionProfileMembersAndGroups) {
+  for (int member_id : {1, 2, 3}) {
+    EXPECT_OK(Write(
+        ::p4::v1::Update::INSERT,
+        absl::StrCat("action_profile_member { action_profile_id: 200 "
+                     "member_id: ",
+                     member_id, " action { action_id: 100 } }")));
+  }
+  // Group exceeding the max group size.
+  EXPECT_EQ(ERR_INVALID_PARAM, Write(::p4::v1::Update::INSERT, R"pb(
+                                 action_profile_group {
+                                   action_profile_id: 200
+                                   group_id: 1
+                                   members { member_id: 1 weight: 1 }
+                                   members { member_id: 2 weight: 1 }
+                                   members { member_id: 3 weight: 1 }
+                                 }
+                               )pb")
+                                   .error_code());
+  // Group with unknown member.
+  EXPECT_EQ(ERR_ENTRY_NOT_FOUND, Write(::p4::v1::Update::INSERT, R"pb(
+                                   action_profile_group {
+                                     action_profile_id: 200
+                                     group_id: 1
+                                     members { member_id: 4 weight: 1 }
+                                   }
+                                 )pb")
+                                     .error_code());
+  EXPECT_OK(Write(::p4::v1::Update::INSERT, R"pb(
+    action_profile_group {
+      action_profile_id: 200
+      group_id: 1
+      members { member_id: 1 weight: 1 }
+      members { member_id: 2 weight: 1 }
+    }
+  )pb"));
+  const std::string kEntry = R"pb(
+    table_entry {
+      table_id: 4
+      match { field_id: 1 exact { value: "\x00\x01" } }
+      action { action_profile_group_id: 1 }
+    }
+  )pb";
+  EXPECT_OK(Write(::p4::v1::Update::INSERT, kEntry));
+
+  // Members and groups in use cannot be deleted.
+  EXPECT_EQ(ERR_FAILED_PRECONDITION,
+            Write(::p4::v1::Update::DELETE,
+                  "action_profile_member { action_profile_id: 200 "
+                  "member_id: 1 }")
+                .error_code());
+  EXPECT_EQ(ERR_FAILED_PRECONDITION,
+            Write(::p4::v1::Update::DELETE,
+                  "action_profile_group { action_profile_id: 200 group_id: 1 }")
+                .error_code());
+
+  EXPECT_OK(Write(::p4::v1::Update::DELETE, kEntry));
+  EXPECT_OK(Write(
+      ::p4::v1::Update::DELETE,
+      "action_profile_group { action_profile_id: 200 group_id: 1 }"));
+  EXPECT_OK(Write(
+      ::p4::v1::Update::DELETE,
+      "action_profile_member { action_profile_id: 200 member_id: 1 }"));
+
+  auto resp = Read("action_profile_member { action_profile_id: 200 }");
+  ASSERT_OK(resp);
+  EXPECT_EQ(2, resp.ValueOrDie().entities_size());
+}
+
+TEST_F(DummyTableStoreTest, DefaultEntry) {
+  EXPECT_EQ(ERR_INVALID_PARAM, Write(::p4::v1::Update::INSERT, R"pb(
+                                 table_entry {
+                                   table_id: 1
+                                   is_default_action: true
+                                   action { action { action_id: 101 } }
+                                 }
+                               )pb")
+                                   .error_code());
+  EXPECT_OK(Write(::p4::v1::Update::MODIFY, R"pb(
+    table_entry {
+      table_id: 1
+      is_default_action: true
+      action { action { action_id: 101 } }
+    }
+  )pb"));
+  auto resp = Read("table_entry { table_id: 1 is_default_action: true }");
+  ASSERT_OK(resp);
+  ASSERT_EQ(1, resp.ValueOrDie().entities_size());
+  EXPECT_EQ(101, resp.ValueOrDie()
+                     .entities(0)
+                     .table_entry()
+                     .action()
+                     .action()
+                     .action_id());
+  // Default entries are not part of wildcard reads.
+  resp = Read("table_entry { table_id: 1 }");
+  ASSERT_OK(resp);
+  EXPECT_EQ(0, resp.ValueOrDie().entities_size());
+}
+
+TEST_F(DummyTableStoreTest, PushP4InfoClearsState) {
+  EXPECT_OK(Write(::p4::v1::Update::INSERT, R"pb(
+    table_entry {
+      table_id: 1
+      match { field_id: 1 exact { value: "\x01" } }
+      action { action { action_id: 100 } }
+    }
+  )pb"));
+  ::p4::config::v1::P4Info p4_info;
+  ASSERT_OK(ParseProtoFromString(kTestP4Info, &p4_info));
+  ASSERT_OK(table_store_->PushP4Info(p4_info));
+  EXPECT_EQ(0, table_store_->TableEntryCount(1));
+}
+
+TEST_F(DummyTableStoreTest, VerifyP4InfoRejectsInvalidP4Info) {
+  ::p4::config::v1::P4Info p4_info;
+  ASSERT_OK(ParseProtoFromString(kTestP4Info, &p4_info));
+  p4_info.mutable_tables(1)->mutable_preamble()->set_id(1);
+  EXPECT_EQ(ERR_INVALID_P4_INFO,
+            DummyTableStore::VerifyP4Info(p4_info).error_code());
+
+  ASSERT_OK(ParseProtoFromString(kTestP4Info, &p4_info));
+  p4_info.mutable_direct_counters(0)->set_direct_table_id(99);
+  EXPECT_EQ(ERR_INVALID_P4_INFO,
+            DummyTableStore::VerifyP4Info(p4_info).error_code());
+}
+
+}  // namespace dummy_switch
+}  // namespace hal
+}  // namespace stratum
@@ -9,6 +9,7 @@
 
 #include <utility>
 
+#include "absl/memory/memory.h"
 #include "absl/strings/ascii.h"
 #include "absl/strings/strip.h"
 #include "absl/strings/substitute.h"
@@ -124,6 +125,7 @@ P4InfoManager::~P4InfoManager() {}
   }
 
   APPEND_STATUS_IF_ERROR(status, VerifyTableXrefs());
+  BuildTableMetadata();
 
   return status;
 }
@@ -175,6 +177,17 @@ void P4InfoManager::InitPacketModMeters(
   return table_map_.FindByName(table_name);
 }
 
+::util::StatusOr<const P4TableMetadata*>
+P4InfoManager::FindTableMetadataByID(uint32 table_id) const {
+  auto iter = table_metadata_.find(table_id);
+  if (iter == table_metadata_.end()) {
+    return MAKE_ERROR(ERR_INVALID_P4_INFO)
+           << "P4Info " << table_map_.resource_type() << " ID "
+           << PrintP4ObjectID(table_id) << " is not found";
+  }
+  return static_cast<const P4TableMetadata*>(iter->second.get());
+}
+
 // FindAction
 ::util::StatusOr<const ::p4::config::v1::Action> P4InfoManager::FindActionByID(
     uint32 action_id) const {
@@ -514,6 +527,15 @@ void P4InfoManager::DumpNamesToIDs() const {
   return status;
 }
 
+void P4InfoManager::BuildTableMetadata() {
+  for (const auto& table : p4_info_.tables()) {
+    // Skips tables that were invalid in the initial pass.
+    if (!table_map_.HasID(table.preamble().id())) continue;
+    table_metadata_.emplace(table.preamble().id(),
+                         absl::make_unique<P4TableMetadata>(table));
+  }
+}
+
 ::util::Status P4InfoManager::VerifyID(
     const ::p4::config::v1::Preamble& preamble,
     const std::string& resource_type) {
@@ -10,6 +10,7 @@
 #define STRATUM_HAL_LIB_P4_P4_INFO_MANAGER_H_
 
 #include <functional>
+#include <memory>
 #include <string>
 
 #include "absl/container/flat_hash_map.h"
@@ -24,6 +25,7 @@
 #include "stratum/glue/status/statusor.h"
 #include "stratum/hal/lib/p4/p4_extern_manager.h"
 #include "stratum/hal/lib/p4/p4_resource_map.h"
+#include "stratum/hal/lib/p4/p4_table_metadata.h"
 #include "stratum/hal/lib/p4/utils.h"
 #include "stratum/lib/macros.h"
 #include "stratum/public/proto/p4_annotation.pb.h"
@@ -78,6 +80,12 @@ class P4InfoManager {
   virtual ::util::StatusOr<const ::p4::config::v1::Table> FindTableByName(
       const std::string& table_name) const;
 
+  // Looks up the precomputed lookup structures of the table with the input
+  // ID. Unlike FindTableByID, this does not copy the table. The returned
+  // pointer is valid for the lifetime of this P4InfoManager.
+  virtual ::util::StatusOr<const P4TableMetadata*> FindTableMetadataByID(
+      uint32 table_id) const;
+
   virtual ::util::StatusOr<const ::p4::config::v1::Action> FindActionByID(
       uint32 action_id) const;
   virtual ::util::StatusOr<const ::p4::config::v1::Action> FindActionByName(
@@ -194,6 +202,9 @@ class P4InfoManager {
   // Verifies cross-references from Tables to Actions and Header Fields.
   ::util::Status VerifyTableXrefs();
 
+  // Builds the P4TableMetadata of every valid table.
+  void BuildTableMetadata();
+
   void InitDirectPacketModMeters(const p4::config::v1::Extern& p4extern);
   void InitPacketModMeters(const p4::config::v1::Extern& p4extern);
 
@@ -221,6 +232,10 @@ class P4InfoManager {
   P4ResourceMap<::p4::config::v1::Register> register_map_;
   P4ResourceMap<::p4::config::v1::Digest> digest_map_;
 
+  // Per-table lookup structures, keyed by table ID.
+  absl::flat_hash_map<uint32, std::unique_ptr<P4TableMetadata>>
+      table_metadata_;
+
   // These containers verify that all P4 names and IDs are unique across all
   // types of resources that have an embedded Preamble.
   absl::flat_hash_set<uint32> all_resource_ids_;
@@ -28,6 +28,10 @@ class P4InfoManagerMock : public P4InfoManager {
                      ::util::StatusOr<const ::p4::config::v1::Table>(
                          const std::string& table_name));
 
+  MOCK_CONST_METHOD1(
+      FindTableMetadataByID,
+      ::util::StatusOr<const P4TableMetadata*>(uint32 table_id));
+
   // FindAction
   MOCK_CONST_METHOD1(
       FindActionByID,
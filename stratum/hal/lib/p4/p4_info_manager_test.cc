@@ -490,6 +490,79 @@ TEST_F(P4InfoManagerTest, TestFindTableUnknownName) {
   EXPECT_THAT(status.status().error_message(), HasSubstr("not found"));
 }
 
+// Verifies the precomputed match field, action and priority lookups of a
+// table.
+TEST_F(P4InfoManagerTest, TestFindTableMetadata) {
+  SetUpTestP4Tables(false);
+  auto* table = p4_test_info_.mutable_tables(0);
+  const uint32 kFieldIds[] = {1, 2, 5000};
+  for (uint32 field_id : kFieldIds) {
+    auto* match_field = table->add_match_fields();
+    match_field->set_id(field_id);
+    match_field->set_name(absl::Substitute("field-$0", field_id));
+    match_field->set_match_type(field_id == 2
+                                    ? ::p4::config::v1::MatchField::TERNARY
+                                    : ::p4::config::v1::MatchField::EXACT);
+  }
+  table->add_action_refs()->set_id(kFirstActionID);
+  auto* action_ref = table->add_action_refs();
+  action_ref->set_id(kFirstActionID + 1);
+  action_ref->set_scope(::p4::config::v1::ActionRef::DEFAULT_ONLY);
+  action_ref = table->add_action_refs();
+  action_ref->set_id(kFirstActionID + 2);
+  action_ref->set_scope(::p4::config::v1::ActionRef::TABLE_ONLY);
+  table->set_const_default_action_id(kFirstActionID + 1);
+  SetUpTestP4Actions();
+  ASSERT_TRUE(p4_test_manager_->InitializeAndVerify().ok());
+
+  auto metadata_status =
+      p4_test_manager_->FindTableMetadataByID(table->preamble().id());
+  ASSERT_TRUE(metadata_status.ok());
+  const P4TableMetadata* metadata = metadata_status.ValueOrDie();
+  EXPECT_TRUE(ProtoEqual(*table, metadata->table()));
+  EXPECT_EQ(3, metadata->num_match_fields());
+  for (int i = 0; i < table->match_fields_size(); ++i) {
+    const uint32 field_id = table->match_fields(i).id();
+    EXPECT_EQ(i, metadata->MatchFieldIndex(field_id));
+    ASSERT_NE(nullptr, metadata->FindMatchField(field_id));
+    EXPECT_TRUE(ProtoEqual(table->match_fields(i),
+                           *metadata->FindMatchField(field_id)));
+  }
+  EXPECT_EQ(-1, metadata->MatchFieldIndex(0));
+  EXPECT_EQ(-1, metadata->MatchFieldIndex(3));
+  EXPECT_EQ(-1, metadata->MatchFieldIndex(4999));
+  EXPECT_EQ(nullptr, metadata->FindMatchField(123456));
+  EXPECT_TRUE(metadata->requires_priority());
+  EXPECT_FALSE(metadata->is_const_table());
+  EXPECT_TRUE(metadata->has_const_default_action());
+
+  EXPECT_TRUE(metadata->IsTableAction(kFirstActionID));
+  EXPECT_TRUE(metadata->IsDefaultAction(kFirstActionID));
+  EXPECT_FALSE(metadata->IsTableAction(kFirstActionID + 1));
+  EXPECT_TRUE(metadata->IsDefaultAction(kFirstActionID + 1));
+  EXPECT_TRUE(metadata->IsTableAction(kFirstActionID + 2));
+  EXPECT_FALSE(metadata->IsDefaultAction(kFirstActionID + 2));
+  EXPECT_FALSE(metadata->IsTableAction(kFirstActionID + 3));
+  EXPECT_FALSE(metadata->IsDefaultAction(kFirstActionID + 3));
+
+  // The other table has no match fields which need a priority.
+  metadata_status = p4_test_manager_->FindTableMetadataByID(
+      p4_test_info_.tables(1).preamble().id());
+  ASSERT_TRUE(metadata_status.ok());
+  EXPECT_FALSE(metadata_status.ValueOrDie()->requires_priority());
+  EXPECT_FALSE(metadata_status.ValueOrDie()->has_const_default_action());
+}
+
+// Verifies table metadata lookup failure with an unknown table ID.
+TEST_F(P4InfoManagerTest, TestFindTableMetadataUnknownID) {
+  SetUpTestP4Tables(false);
+  ASSERT_TRUE(p4_test_manager_->InitializeAndVerify().ok());
+  auto status = p4_test_manager_->FindTableMetadataByID(123456);
+  EXPECT_FALSE(status.ok());
+  EXPECT_EQ(ERR_INVALID_P4_INFO, status.status().error_code());
+  EXPECT_THAT(status.status().error_message(), HasSubstr("not found"));
+}
+
 // All valid actions in p4_test_info_ should have successful name/ID lookups,
 // and the returned data should match the action's original p4_test_info_ entry.
 TEST_F(P4InfoManagerTest, TestFindAction) {
@@ -71,6 +71,9 @@ class P4ResourceMap {
     return *iter->second;
   }
 
+  // Returns true if a P4 resource with the input ID exists.
+  bool HasID(uint32 id) const { return id_to_resource_map_.count(id) != 0; }
+
   // Attempts to find the P4 resource matching the input name.
   ::util::StatusOr<const T> FindByName(const std::string& name) const {
     auto iter = name_to_resource_map_.find(name);
@@ -107,7 +107,17 @@ P4TableMapper::~P4TableMapper() { Shutdown().IgnoreError(); }
   param_mapper_ = absl::make_unique<P4ActionParamMapper>(
       *p4_info_manager_, global_id_table_map_, p4_pipeline_config_);
 
-  for (const auto& table : p4_info.tables()) {
+  for (const auto& table : p4_info_manager_->p4_info().tables()) {
+    // MapFlowEntry refers to the table's P4Info and don't care match values
+    // through table_info_by_id_ for every request.
+    auto& table_info = table_info_by_id_[table.preamble().id()];
+    table_info.table_p4_info = &table;
+    table_info.dont_care_matches.reserve(table.match_fields_size());
+    for (const auto& match_field : table.match_fields()) {
+      table_info.dont_care_matches.emplace_back();
+      table_info.dont_care_matches.back().set_field_id(match_field.id());
+    }
+
     ::util::Status table_status = AddMapEntryFromPreamble(table.preamble());
     if (!table_status.ok()) {
       // Since there are discrepancies caused by hidden p4c internal objects
@@ -317,11 +327,18 @@ P4TableMapper::~P4TableMapper() { Shutdown().IgnoreError(); }
   // The table should be recognized in the P4Info, and it must contain a
   // valid set of match fields and one action.
   int p4_table_id = table_entry.table_id();
-  ASSIGN_OR_RETURN(::p4::config::v1::Table table_p4_info,
-                   p4_info_manager_->FindTableByID(p4_table_id));
-  std::vector<::p4::v1::FieldMatch> all_match_fields;
+  const P4TableMapperTableInfo* table_info =
+      gtl::FindOrNull(table_info_by_id_, p4_table_id);
+  if (table_info == nullptr) {
+    return MAKE_ERROR(ERR_INVALID_P4_INFO)
+           << "P4Info Table ID " << PrintP4ObjectID(p4_table_id)
+           << " is not found";
+  }
+  const ::p4::config::v1::Table& table_p4_info = *table_info->table_p4_info;
+  std::vector<const ::p4::v1::FieldMatch*> all_match_fields;
+  all_match_fields.reserve(table_p4_info.match_fields_size());
   RETURN_IF_ERROR(
-      PrepareMatchFields(table_p4_info, table_entry, &all_match_fields));
+      PrepareMatchFields(*table_info, table_entry, &all_match_fields));
   if (update_type == ::p4::v1::Update::INSERT && !table_entry.has_action()) {
     return MAKE_ERROR(ERR_INVALID_PARAM)
            << "P4 TableEntry update has no action";
@@ -330,9 +347,9 @@ P4TableMapper::~P4TableMapper() { Shutdown().IgnoreError(); }
   APPEND_STATUS_IF_ERROR(
       status, ProcessTableID(table_p4_info, p4_table_id, flow_entry));
 
-  for (const auto& match_field : all_match_fields) {
+  for (const auto* match_field : all_match_fields) {
     APPEND_STATUS_IF_ERROR(
-        status, ProcessMatchField(table_p4_info, match_field, flow_entry));
+        status, ProcessMatchField(table_p4_info, *match_field, flow_entry));
   }
 
   if (table_entry.has_action()) {
@@ -601,9 +618,11 @@ std::string P4TableMapper::GetMapperNameKey(
 }
 
 ::util::Status P4TableMapper::PrepareMatchFields(
-    const ::p4::config::v1::Table& table_p4_info,
+    const P4TableMapperTableInfo& table_info,
     const ::p4::v1::TableEntry& table_entry,
-    std::vector<::p4::v1::FieldMatch>* all_match_fields) const {
+    std::vector<const ::p4::v1::FieldMatch*>* all_match_fields) const {
+  const ::p4::config::v1::Table& table_p4_info = *table_info.table_p4_info;
+
   // An empty set of match fields changes the default action for tables
   // that were not defined with a const default action in the P4 program.
   if (table_entry.match_size() == 0) {
@@ -619,33 +638,40 @@ std::string P4TableMapper::GetMapperNameKey(
   // Per field validations:
   //  - Every field_id must be non-zero.
   //  - A field_id can appear in a match field at most once.
-  std::set<uint32> requested_field_ids;
-  for (const auto& match_field : table_entry.match()) {
+  // Tables have few match fields, so a linear scan of the fields seen so far
+  // is cheaper than building a set for every request.
+  for (int i = 0; i < table_entry.match_size(); ++i) {
+    const auto& match_field = table_entry.match(i);
     if (match_field.field_id() == 0) {
       return MAKE_ERROR(ERR_INVALID_PARAM)
              << "P4 TableEntry match field has no field_id. "
              << table_entry.ShortDebugString();
     }
-    if (!requested_field_ids.insert(match_field.field_id()).second) {
-      return MAKE_ERROR(ERR_INVALID_PARAM)
-             << "P4 TableEntry update of table "
-             << table_p4_info.preamble().name() << " has multiple match field "
-             << "entries for field_id " << match_field.field_id() << ". "
-             << table_entry.ShortDebugString();
+    for (int j = 0; j < i; ++j) {
+      if (table_entry.match(j).field_id() == match_field.field_id()) {
+        return MAKE_ERROR(ERR_INVALID_PARAM)
+               << "P4 TableEntry update of table "
+               << table_p4_info.preamble().name()
+               << " has multiple match field entries for field_id "
+               << match_field.field_id() << ". "
+               << table_entry.ShortDebugString();
+      }
     }
-    all_match_fields->push_back(match_field);
+    all_match_fields->push_back(&match_field);
   }
 
   // Any missing fields in the request are added with don't care values below.
   // The P4MatchKey instance in ProcessMatchField ultimately determines whether
   // don't-care/default usage is permissible for each field.
-  for (const auto& p4info_match_field : table_p4_info.match_fields()) {
-    if (requested_field_ids.find(p4info_match_field.id()) ==
-        requested_field_ids.end()) {
-      ::p4::v1::FieldMatch dont_care_match;
-      dont_care_match.set_field_id(p4info_match_field.id());
-      all_match_fields->push_back(dont_care_match);
+  for (const auto& dont_care_match : table_info.dont_care_matches) {
+    bool requested = false;
+    for (const auto& match_field : table_entry.match()) {
+      if (match_field.field_id() == dont_care_match.field_id()) {
+        requested = true;
+        break;
+      }
     }
+    if (!requested) all_match_fields->push_back(&dont_care_match);
   }
 
   return ::util::OkStatus();
@@ -899,6 +925,7 @@ std::string P4TableMapper::GetMapperNameKey(
 void P4TableMapper::ClearMaps() {
   global_id_table_map_.clear();
   field_convert_by_table_.clear();
+  table_info_by_id_.clear();
   packetin_metadata_type_to_id_bitwidth_pair_.clear();
   packetin_metadata_id_to_type_bitwidth_pair_.clear();
   packetout_metadata_type_to_id_bitwidth_pair_.clear();
@@ -14,6 +14,7 @@
 #include <vector>
 
 #include "absl/container/flat_hash_map.h"
+#include "absl/container/flat_hash_set.h"
 #include "p4/config/v1/p4info.pb.h"
 #include "stratum/glue/status/status.h"
 #include "stratum/hal/lib/common/common.pb.h"
@@ -271,9 +272,25 @@ class P4TableMapper {
     P4FieldDescriptor::P4FieldConversionEntry conversion_entry;
     MappedField mapped_field;
   };
-  typedef std::map<P4FieldConvertKey, P4FieldConvertValue>
+  typedef absl::flat_hash_map<P4FieldConvertKey, P4FieldConvertValue>
       P4FieldConvertByTable;
 
+  // This struct contains the per-table data that MapFlowEntry needs for
+  // every request.  It is built once per pipeline config push:
+  //  table_p4_info - points to the table in the P4Info owned by
+  //      p4_info_manager_, so MapFlowEntry can borrow it instead of copying
+  //      the Table message for every flow.
+  //  dont_care_matches - contains one FieldMatch with only the field_id set
+  //      for each match field in table_p4_info, in P4Info order.  These are
+  //      the default values for fields that a request omits.
+  struct P4TableMapperTableInfo {
+    P4TableMapperTableInfo() : table_p4_info(nullptr) {}
+
+    const ::p4::config::v1::Table* table_p4_info;
+    std::vector<::p4::v1::FieldMatch> dont_care_matches;
+  };
+  typedef absl::flat_hash_map<int, P4TableMapperTableInfo> P4TableInfoByID;
+
   // P4FieldConvertKey generators.
   inline static P4FieldConvertKey MakeP4FieldConvertKey(int table_id,
                                                         uint32 match_field_id) {
@@ -357,7 +374,8 @@ class P4TableMapper {
     // is a combination of the action ID and the action parameter ID.  The
     // action ID is globally unique, but the parameter ID is unique only
     // within the scope of its action.
-    typedef std::map<std::pair<int, int>, P4ActionParamEntry> P4ActionParamMap;
+    typedef absl::flat_hash_map<std::pair<int, int>, P4ActionParamEntry>
+        P4ActionParamMap;
 
     // The P4ActionConstantMap supports actions that use constants to assign
     // fields or pass to other actions.  The action ID is the key, and the
@@ -407,7 +425,7 @@ class P4TableMapper {
     // pairs, i.e. the action ID is defined in P4Info as one of the table's
     // possible actions.  The first pair member is the table ID, and the second
     // member is the action ID.
-    std::set<std::pair<int, int>> valid_table_actions_;
+    absl::flat_hash_set<std::pair<int, int>> valid_table_actions_;
   };
 
   // Creates the global_id_table_map_ entry for the object represented by the
@@ -421,17 +439,19 @@ class P4TableMapper {
   std::string GetMapperNameKey(const ::p4::config::v1::Preamble& preamble);
 
   // Validates all of the match fields in the table_entry from a P4Runtime
-  // WriteRequest message.  The input table_p4_info provides information
+  // WriteRequest message.  The input table_info provides information
   // about the expected match fields for the applicable table.  If the
   // P4Runtime request omits some match fields as "don't care" values,
-  // PrepareMatchFields appends them to the all_match_fields output vector.
-  // Upon successful return, all_match_fields combines the match fields
-  // in the original WriteRequest with any additional don't care fields,
-  // yielding the full set of match fields as specified by table_p4_info.
+  // PrepareMatchFields appends their table_info defaults to the
+  // all_match_fields output vector.  Upon successful return, all_match_fields
+  // refers to the match fields in the original WriteRequest plus any
+  // additional don't care fields, yielding the full set of match fields as
+  // specified by the table's P4Info.  The output points into table_entry and
+  // table_info; no FieldMatch data is copied.
   ::util::Status PrepareMatchFields(
-      const ::p4::config::v1::Table& table_p4_info,
+      const P4TableMapperTableInfo& table_info,
       const ::p4::v1::TableEntry& table_entry,
-      std::vector<::p4::v1::FieldMatch>* all_match_fields) const;
+      std::vector<const ::p4::v1::FieldMatch*>* all_match_fields) const;
 
   // Processes the identified table and updates table-level flow_entry output.
   // Output always includes table_info with id, name, and type.  If the table's
@@ -493,6 +513,9 @@ class P4TableMapper {
   // This map facilitates table-dependent match field conversions.
   P4FieldConvertByTable field_convert_by_table_;
 
+  // Provides the per-table P4Info data for MapFlowEntry, keyed by table ID.
+  P4TableInfoByID table_info_by_id_;
+
   // Map from packet in (out) metadata ID to the corresponding (type, bitwidth)
   // pair used for parsing the packet in (out) metadata. The ID and bitwidth of
   // metadata are available from P4Info and the type (P4FieldType) is found from
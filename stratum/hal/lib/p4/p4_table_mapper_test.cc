@@ -1731,6 +1731,29 @@ TEST_F(P4TableMapperTest, TestHiddenTableActionID) {
   EXPECT_EQ(TRI_STATE_UNKNOWN, hidden_state);
 }
 
+// Tests that a CommonFlowEntry reused across requests, as a switch
+// implementation would do across the updates in one WriteRequest, holds the
+// same result as a fresh one.
+TEST_F(P4TableMapperTest, MapFlowEntryReusesFlowEntry) {
+  ASSERT_OK(p4_table_mapper_->PushForwardingPipelineConfig(
+      forwarding_pipeline_config_));
+  SetUpMultiMatchFieldTest("test-multi-match-table");
+  CommonFlowEntry flow_entry;
+  ASSERT_OK(p4_table_mapper_->MapFlowEntry(
+      table_entry_, ::p4::v1::Update::INSERT, &flow_entry));
+  EXPECT_EQ(3, flow_entry.fields_size());
+
+  // Leave the ternary field out so the second request takes the don't care
+  // path.
+  table_entry_.mutable_match()->RemoveLast();
+  CommonFlowEntry expected_flow_entry;
+  ASSERT_OK(p4_table_mapper_->MapFlowEntry(
+      table_entry_, ::p4::v1::Update::INSERT, &expected_flow_entry));
+  ASSERT_OK(p4_table_mapper_->MapFlowEntry(
+      table_entry_, ::p4::v1::Update::INSERT, &flow_entry));
+  EXPECT_THAT(flow_entry, EqualsProto(expected_flow_entry));
+}
+
 // Tests null pointer checks.
 TEST_F(P4TableMapperTest, TestNullPtrChecks) {
   ::util::Status status = p4_table_mapper_->MapFlowEntry(
@@ -0,0 +1,68 @@
+// Copyright 2024 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#include "stratum/hal/lib/p4/p4_table_metadata.h"
+
+#include <algorithm>
+
+#include "stratum/glue/gtl/map_util.h"
+
+namespace stratum {
+namespace hal {
+
+constexpr uint32 P4TableMetadata::kMaxDenseMatchFieldId;
+
+P4TableMetadata::P4TableMetadata(const ::p4::config::v1::Table& table)
+    : table_(table), requires_priority_(false) {
+  uint32 max_dense_id = 0;
+  for (const auto& match_field : table_.match_fields()) {
+    if (match_field.id() <= kMaxDenseMatchFieldId) {
+      max_dense_id = std::max(max_dense_id, match_field.id());
+    }
+  }
+  match_field_index_by_id_.assign(max_dense_id + 1, -1);
+  for (int i = 0; i < table_.match_fields_size(); ++i) {
+    const auto& match_field = table_.match_fields(i);
+    if (match_field.id() <= kMaxDenseMatchFieldId) {
+      match_field_index_by_id_[match_field.id()] = i;
+    } else {
+      sparse_match_field_index_by_id_[match_field.id()] = i;
+    }
+    switch (match_field.match_type()) {
+      case ::p4::config::v1::MatchField::TERNARY:
+      case ::p4::config::v1::MatchField::RANGE:
+      case ::p4::config::v1::MatchField::OPTIONAL:
+        requires_priority_ = true;
+        break;
+      default:
+        break;
+    }
+  }
+
+  for (const auto& action_ref : table_.action_refs()) {
+    action_scopes_[action_ref.id()] = action_ref.scope();
+  }
+}
+
+int P4TableMetadata::MatchFieldIndex(uint32 field_id) const {
+  if (field_id < match_field_index_by_id_.size()) {
+    return match_field_index_by_id_[field_id];
+  }
+  if (field_id <= kMaxDenseMatchFieldId) return -1;
+  const int* index = gtl::FindOrNull(sparse_match_field_index_by_id_, field_id);
+  return index == nullptr ? -1 : *index;
+}
+
+bool P4TableMetadata::IsTableAction(uint32 action_id) const {
+  const auto* scope = gtl::FindOrNull(action_scopes_, action_id);
+  return scope != nullptr &&
+         *scope != ::p4::config::v1::ActionRef::DEFAULT_ONLY;
+}
+
+bool P4TableMetadata::IsDefaultAction(uint32 action_id) const {
+  const auto* scope = gtl::FindOrNull(action_scopes_, action_id);
+  return scope != nullptr && *scope != ::p4::config::v1::ActionRef::TABLE_ONLY;
+}
+
+}  // namespace hal
+}  // namespace stratum
@@ -0,0 +1,91 @@
+// Copyright 2024 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+// The P4TableMetadata class holds the per-table lookup structures that
+// P4InfoManager derives from the P4Info when a pipeline is pushed.
+
+#ifndef STRATUM_HAL_LIB_P4_P4_TABLE_METADATA_H_
+#define STRATUM_HAL_LIB_P4_P4_TABLE_METADATA_H_
+
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "p4/config/v1/p4info.pb.h"
+#include "stratum/glue/integral_types.h"
+
+namespace stratum {
+namespace hal {
+
+// A P4TableMetadata answers the questions that the write and read paths ask
+// about a P4 table for every entry in constant time: the match field with a
+// given ID, whether an action is valid for the table entries or the default
+// entry, and whether the table entries need a priority. It refers to the
+// Table in the P4Info of its P4InfoManager, which must outlive it.
+class P4TableMetadata {
+ public:
+  explicit P4TableMetadata(const ::p4::config::v1::Table& table);
+  virtual ~P4TableMetadata() {}
+
+  // Returns the match field with the given ID, or nullptr if the table has no
+  // such match field.
+  const ::p4::config::v1::MatchField* FindMatchField(uint32 field_id) const {
+    int index = MatchFieldIndex(field_id);
+    return index < 0 ? nullptr : &table_.match_fields(index);
+  }
+
+  // Returns the position of the match field with the given ID in the table
+  // match_fields, or -1 if the table has no such match field.
+  int MatchFieldIndex(uint32 field_id) const;
+
+  // Returns true if the action can be used by the table entries, i.e. it is
+  // one of the table actions and not restricted to the default entry.
+  bool IsTableAction(uint32 action_id) const;
+
+  // Returns true if the action can be used by the default entry of the table,
+  // i.e. it is one of the table actions and not restricted to table entries.
+  bool IsDefaultAction(uint32 action_id) const;
+
+  // Accessors.
+  const ::p4::config::v1::Table& table() const { return table_; }
+  uint32 id() const { return table_.preamble().id(); }
+  int num_match_fields() const { return table_.match_fields_size(); }
+  // True if the table entries are defined by the P4 program.
+  bool is_const_table() const { return table_.is_const_table(); }
+  // True if the default action of the table cannot be changed.
+  bool has_const_default_action() const {
+    return table_.const_default_action_id() != 0;
+  }
+  // True if the table has ternary, range or optional match fields, so that
+  // its entries need a priority.
+  bool requires_priority() const { return requires_priority_; }
+
+  // P4TableMetadata is neither copyable nor movable, as the P4InfoManager
+  // hands out pointers to it.
+  P4TableMetadata(const P4TableMetadata&) = delete;
+  P4TableMetadata& operator=(const P4TableMetadata&) = delete;
+
+ private:
+  // Match field IDs up to this value are looked up in a dense array. The
+  // P4 compiler numbers the match fields of a table from 1, so the array
+  // stays small. Larger IDs fall back to a hash map.
+  static constexpr uint32 kMaxDenseMatchFieldId = 1024;
+
+  const ::p4::config::v1::Table& table_;
+
+  // Match field positions indexed by field ID, -1 for unused IDs.
+  std::vector<int> match_field_index_by_id_;
+  // Match field positions of the field IDs beyond the dense array.
+  absl::flat_hash_map<uint32, int> sparse_match_field_index_by_id_;
+
+  // Scope of the actions of the table, keyed by action ID. P4Info action IDs
+  // are sparse 32-bit values, so they are hashed rather than indexed.
+  absl::flat_hash_map<uint32, ::p4::config::v1::ActionRef::Scope>
+      action_scopes_;
+
+  bool requires_priority_;
+};
+
+}  // namespace hal
+}  // namespace stratum
+
+#endif  // STRATUM_HAL_LIB_P4_P4_TABLE_METADATA_H_
@@ -2,13 +2,18 @@
 // Copyright 2018-present Open Networking Foundation
 // SPDX-License-Identifier: Apache-2.0
 
-// This file contains the P4WriteRequestDiffer and P4WriteRequestReporter
-// implementations.
+// This file contains the P4WriteRequestDiffer implementation.
 
 #include "stratum/hal/lib/p4/p4_write_request_differ.h"
 
-#include "google/protobuf/generated_message_reflection.h"
-#include "stratum/glue/logging.h"
+#include <algorithm>
+#include <string>
+
+#include "absl/container/flat_hash_map.h"
+#include "google/protobuf/io/coded_stream.h"
+#include "google/protobuf/io/zero_copy_stream_impl_lite.h"
+#include "google/protobuf/util/message_differencer.h"
+#include "stratum/glue/gtl/map_util.h"
 #include "stratum/glue/status/status_macros.h"
 #include "stratum/lib/macros.h"
 #include "stratum/public/lib/error.h"
@@ -33,158 +38,110 @@ P4WriteRequestDiffer::P4WriteRequestDiffer(
     ::p4::v1::WriteRequest* delete_request, ::p4::v1::WriteRequest* add_request,
     ::p4::v1::WriteRequest* modify_request,
     ::p4::v1::WriteRequest* unchanged_request) {
-  ::google::protobuf::util::MessageDifferencer msg_differencer;
-  P4WriteRequestReporter reporter;
-  msg_differencer.ReportDifferencesTo(&reporter);
-  if (unchanged_request) {
-    msg_differencer.set_report_matches(true);
+  // The new updates are indexed by key, so each old update finds its match
+  // with a single lookup.  Each index list is in descending order, and an old
+  // update takes the first unmatched new update from the back of the list.
+  absl::flat_hash_map<std::string, std::vector<int>> new_indexes_by_key;
+  new_indexes_by_key.reserve(new_request_.updates_size());
+  std::string key;
+  for (int i = new_request_.updates_size() - 1; i >= 0; --i) {
+    if (GetUpdateKey(new_request_.updates(i), &key)) {
+      new_indexes_by_key[key].push_back(i);
+    }
   }
 
-  // The custom comparator treats table_id and all match fields as the
-  // key value for comparing updates.
-  auto write_desc = ::p4::v1::WriteRequest::default_instance().GetDescriptor();
-  P4WriteRequestComparator comparator;
-  msg_differencer.TreatAsMapUsingKeyComparator(
-      write_desc->FindFieldByName("updates"), &comparator);
+  // Updates with the same key are compared field by field, ignoring the
+  // update type and the order of repeated fields.
+  ::google::protobuf::util::MessageDifferencer msg_differencer;
   msg_differencer.set_repeated_field_comparison(
       ::google::protobuf::util::MessageDifferencer::AS_SET);
   auto update_desc = ::p4::v1::Update::default_instance().GetDescriptor();
   msg_differencer.IgnoreField(update_desc->FindFieldByName("type"));
 
-  if (!msg_differencer.Compare(old_request_, new_request_)) {
-    // When differences occur, the output messages are formed from the
-    // updates field indices accumulated by the P4WriteRequestReporter.
-    if (delete_request) {
-      FillOutputFromReporterIndexes(old_request_, reporter.deleted_indexes(),
-                                    ::p4::v1::Update::DELETE, delete_request);
+  std::vector<int> deleted_indexes;
+  std::vector<int> modified_indexes;  // Relative to new_request_.
+  std::vector<int> unchanged_indexes;
+  std::vector<bool> new_matched(new_request_.updates_size(), false);
+  for (int i = 0; i < old_request_.updates_size(); ++i) {
+    std::vector<int>* new_indexes = nullptr;
+    if (GetUpdateKey(old_request_.updates(i), &key)) {
+      new_indexes = gtl::FindOrNull(new_indexes_by_key, key);
     }
-    if (add_request) {
-      FillOutputFromReporterIndexes(new_request_, reporter.added_indexes(),
-                                    ::p4::v1::Update::INSERT, add_request);
+    if (new_indexes == nullptr || new_indexes->empty()) {
+      deleted_indexes.push_back(i);
+      continue;
     }
-    if (modify_request) {
-      FillOutputFromReporterIndexes(new_request_, reporter.modified_indexes(),
-                                    ::p4::v1::Update::MODIFY, modify_request);
+    const int j = new_indexes->back();
+    new_indexes->pop_back();
+    new_matched[j] = true;
+    if (msg_differencer.Compare(old_request_.updates(i),
+                                new_request_.updates(j))) {
+      unchanged_indexes.push_back(i);
+    } else {
+      modified_indexes.push_back(j);
     }
   }
+  std::vector<int> added_indexes;
+  for (int j = 0; j < new_request_.updates_size(); ++j) {
+    if (!new_matched[j]) added_indexes.push_back(j);
+  }
 
+  if (delete_request) {
+    FillOutputFromIndexes(old_request_, deleted_indexes,
+                          ::p4::v1::Update::DELETE, delete_request);
+  }
+  if (add_request) {
+    FillOutputFromIndexes(new_request_, added_indexes,
+                          ::p4::v1::Update::INSERT, add_request);
+  }
+  if (modify_request) {
+    FillOutputFromIndexes(new_request_, modified_indexes,
+                          ::p4::v1::Update::MODIFY, modify_request);
+  }
   if (unchanged_request) {
     unchanged_request->Clear();
-    const std::set<int>& unchanged_indexes = reporter.unchanged_indexes();
-    for (int u = 0; u < old_request_.updates_size(); ++u) {
-      if (unchanged_indexes.find(u) != unchanged_indexes.end())
-        *(unchanged_request->add_updates()) = old_request_.updates(u);
+    for (int u : unchanged_indexes) {
+      *(unchanged_request->add_updates()) = old_request_.updates(u);
     }
   }
 
-  return reporter.status();
+  return ::util::OkStatus();
 }
 
-void P4WriteRequestDiffer::FillOutputFromReporterIndexes(
+void P4WriteRequestDiffer::FillOutputFromIndexes(
     const ::p4::v1::WriteRequest& source_request,
-    const std::vector<int>& reporter_indexes, ::p4::v1::Update::Type type,
+    const std::vector<int>& indexes, ::p4::v1::Update::Type type,
     ::p4::v1::WriteRequest* output_request) {
   output_request->Clear();
-  for (int i : reporter_indexes) {
+  for (int i : indexes) {
     ::p4::v1::Update* update = output_request->add_updates();
     *update = source_request.updates(i);
     update->set_type(type);
   }
 }
 
-P4WriteRequestReporter::P4WriteRequestReporter()
-    : status_(::util::OkStatus()) {}
-
-// ReportAdded and ReportDeleted are interested only in changes that roll up
-// to the first-level repeated Update message nested inside the compared
-// P4 WriteRequests.   Details at lower levels of the field_path are not
-// processed.
-void P4WriteRequestReporter::ReportAdded(
-    const ::google::protobuf::Message& message1,
-    const ::google::protobuf::Message& message2,
-    const FieldVector& field_path) {
-  if (field_path.size() != 1) return;
-  VLOG(1) << "ReportAdded " << field_path[0].field->full_name() << " index "
-          << field_path[0].index;
-  added_indexes_.push_back(field_path[0].index);
-}
-
-void P4WriteRequestReporter::ReportDeleted(
-    const ::google::protobuf::Message& message1,
-    const ::google::protobuf::Message& message2,
-    const FieldVector& field_path) {
-  if (field_path.size() != 1) return;
-  VLOG(1) << "ReportAdded " << field_path[0].field->full_name() << " index "
-          << field_path[0].index;
-  deleted_indexes_.push_back(field_path[0].index);
-}
-
-void P4WriteRequestReporter::ReportModified(
-    const ::google::protobuf::Message& message1,
-    const ::google::protobuf::Message& message2,
-    const FieldVector& field_path) {
-  if (field_path.size() != 2) return;
-  VLOG(1) << "ReportModified " << field_path[0].field->full_name() << " index "
-          << field_path[0].new_index;
-  modified_indexes_.push_back(field_path[0].new_index);
-}
-
-void P4WriteRequestReporter::ReportMoved(
-    const ::google::protobuf::Message& message1,
-    const ::google::protobuf::Message& message2,
-    const FieldVector& field_path) {
-  if (field_path.size() != 1) return;
-  VLOG(1) << "ReportMoved " << field_path[0].field->full_name() << " index "
-          << field_path[0].index;
-  unchanged_indexes_.insert(field_path[0].index);
-}
-
-void P4WriteRequestReporter::ReportMatched(
-    const ::google::protobuf::Message& message1,
-    const ::google::protobuf::Message& message2,
-    const FieldVector& field_path) {
-  if (field_path.size() != 1) return;
-  VLOG(1) << "ReportMatched " << field_path[0].field->full_name() << " index "
-          << field_path[0].index;
-  unchanged_indexes_.insert(field_path[0].index);
-}
-
-// To match, both messages must:
-//  - Have a table_entry.
-//  - Table IDs must be equal.
-//  - Both entries must have the same match fields.
-bool P4WriteRequestComparator::IsMatch(
-    const google::protobuf::Message& message1,
-    const google::protobuf::Message& message2,  // NOLINTNEXTLINE
-    const std::vector<
-        google::protobuf::util::MessageDifferencer::SpecificField>&
-        parent_fields) const {
-  const ::p4::v1::Update& update1 =
-      *google::protobuf::DynamicCastToGenerated<const ::p4::v1::Update>(
-          &message1);
-  const ::p4::v1::Update& update2 =
-      *google::protobuf::DynamicCastToGenerated<const ::p4::v1::Update>(
-          &message2);
-  if (!update1.entity().has_table_entry()) return false;
-  if (!update2.entity().has_table_entry()) return false;
-  const auto& table_entry1 = update1.entity().table_entry();
-  const auto& table_entry2 = update2.entity().table_entry();
-  if (table_entry1.table_id() != table_entry2.table_id()) return false;
-  if (table_entry1.match_size() != table_entry2.match_size()) return false;
-
-  // Another MessageDifferencer compares the match fields.  The match fields
-  // can be in any order, so the comparison treats them as a map with field_id
-  // as the key.
-  ::google::protobuf::util::MessageDifferencer msg_differencer;
-  auto entry_desc = ::p4::v1::TableEntry::default_instance().GetDescriptor();
-  auto match_desc = ::p4::v1::FieldMatch::default_instance().GetDescriptor();
-  auto match_field_desc = entry_desc->FindFieldByName("match");
-  msg_differencer.TreatAsMap(match_field_desc,
-                             match_desc->FindFieldByName("field_id"));
-  std::vector<const ::google::protobuf::FieldDescriptor*> compare_fields = {
-      match_field_desc};
-  return msg_differencer.CompareWithFields(table_entry1, table_entry2,
-                                           compare_fields, compare_fields);
+// The key is a serialized TableEntry with only the table_id and the match
+// fields, sorted by field_id since their order in the update is irrelevant.
+bool P4WriteRequestDiffer::GetUpdateKey(const ::p4::v1::Update& update,
+                                        std::string* key) {
+  if (!update.entity().has_table_entry()) return false;
+  const auto& table_entry = update.entity().table_entry();
+  std::vector<const ::p4::v1::FieldMatch*> matches;
+  matches.reserve(table_entry.match_size());
+  for (const auto& match : table_entry.match()) matches.push_back(&match);
+  std::stable_sort(
+      matches.begin(), matches.end(),
+      [](const ::p4::v1::FieldMatch* a, const ::p4::v1::FieldMatch* b) {
+        return a->field_id() < b->field_id();
+      });
+  ::p4::v1::TableEntry key_entry;
+  key_entry.set_table_id(table_entry.table_id());
+  for (const auto* match : matches) *key_entry.add_match() = *match;
+  key->clear();
+  ::google::protobuf::io::StringOutputStream output(key);
+  ::google::protobuf::io::CodedOutputStream coded_output(&output);
+  coded_output.SetSerializationDeterministic(true);
+  return key_entry.SerializeToCodedStream(&coded_output);
 }
 
 }  // namespace hal
@@ -0,0 +1,138 @@
+// Copyright 2024 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+// Benchmark of P4WriteRequestDiffer::Compare(). Compares requests of static
+// table entries of growing sizes, where one in ten entries is modified,
+// deleted, or added in the new request, and the new request is in reverse
+// order, and reports the comparison time of each size.
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "absl/strings/numbers.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_format.h"
+#include "absl/strings/str_split.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
+#include "gflags/gflags.h"
+#include "p4/v1/p4runtime.pb.h"
+#include "stratum/glue/init_google.h"
+#include "stratum/glue/logging.h"
+#include "stratum/glue/status/status.h"
+#include "stratum/glue/status/status_macros.h"
+#include "stratum/glue/status/statusor.h"
+#include "stratum/hal/lib/p4/p4_write_request_differ.h"
+#include "stratum/public/lib/error.h"
+
+DEFINE_string(num_entries, "1000,10000,100000",
+              "Comma-separated numbers of entries of the compared requests.");
+
+namespace stratum {
+namespace hal {
+
+const char kUsage[] = R"USAGE(
+Usage: p4_write_request_differ_bench [options]
+  This tool measures the time of P4WriteRequestDiffer::Compare() for requests
+  of static table entries of each of the given sizes.
+)USAGE";
+
+// Returns an update of a ternary table entry with the given exact key.
+::p4::v1::Update MakeUpdate(const std::string& key) {
+  ::p4::v1::Update update;
+  update.set_type(::p4::v1::Update::INSERT);
+  auto* table_entry = update.mutable_entity()->mutable_table_entry();
+  table_entry->set_table_id(33576594);
+  auto* match = table_entry->add_match();
+  match->set_field_id(1);
+  match->mutable_exact()->set_value(key);
+  match = table_entry->add_match();
+  match->set_field_id(2);
+  match->mutable_ternary()->set_value(std::string(1, '\x00'));
+  match->mutable_ternary()->set_mask("\xe0");
+  table_entry->mutable_action()->mutable_action()->set_action_id(16781933);
+  table_entry->set_priority(5);
+  return update;
+}
+
+// Compares an old and a new request of num_entries entries and returns the
+// comparison time.
+::util::StatusOr<absl::Duration> TimeCompare(int num_entries) {
+  ::p4::v1::WriteRequest old_request;
+  for (int i = 0; i < num_entries; ++i) {
+    *old_request.add_updates() = MakeUpdate(absl::StrCat(i));
+  }
+  ::p4::v1::WriteRequest new_request;
+  for (int i = num_entries - 1; i >= 0; --i) {
+    if (i % 10 == 1) continue;
+    ::p4::v1::Update* new_update = new_request.add_updates();
+    *new_update = old_request.updates(i);
+    if (i % 10 == 0) {
+      new_update->mutable_entity()
+          ->mutable_table_entry()
+          ->mutable_action()
+          ->mutable_action()
+          ->set_action_id(1);
+    } else if (i % 10 == 2) {
+      *new_request.add_updates() = MakeUpdate(absl::StrCat(i + num_entries));
+    }
+  }
+
+  ::p4::v1::WriteRequest deletions;
+  ::p4::v1::WriteRequest additions;
+  ::p4::v1::WriteRequest modified;
+  ::p4::v1::WriteRequest unchanged;
+  const absl::Time start = absl::Now();
+  P4WriteRequestDiffer differ(old_request, new_request);
+  RETURN_IF_ERROR(
+      differ.Compare(&deletions, &additions, &modified, &unchanged));
+  const absl::Duration elapsed = absl::Now() - start;
+
+  // Entries i with i % 10 == 1 are deleted, i % 10 == 2 get a new entry added
+  // and i % 10 == 0 are modified.
+  const int num_deleted = (num_entries + 8) / 10;
+  const int num_added = (num_entries + 7) / 10;
+  const int num_modified = (num_entries + 9) / 10;
+  RET_CHECK(deletions.updates_size() == num_deleted &&
+            additions.updates_size() == num_added &&
+            modified.updates_size() == num_modified &&
+            unchanged.updates_size() ==
+                num_entries - num_deleted - num_modified)
+      << "Unexpected diff of " << num_entries << " entries: "
+      << deletions.updates_size() << " deletions, "
+      << additions.updates_size() << " additions, "
+      << modified.updates_size() << " modified, "
+      << unchanged.updates_size() << " unchanged.";
+  return elapsed;
+}
+
+::util::Status Main(int argc, char** argv) {
+  std::vector<int> sizes;
+  for (absl::string_view size : absl::StrSplit(FLAGS_num_entries, ',')) {
+    int num_entries;
+    RET_CHECK(absl::SimpleAtoi(size, &num_entries) && num_entries > 0)
+        << "Invalid number of entries " << size << " in --num_entries.";
+    sizes.push_back(num_entries);
+  }
+
+  for (int num_entries : sizes) {
+    ASSIGN_OR_RETURN(const absl::Duration elapsed, TimeCompare(num_entries));
+    std::cout << absl::StrFormat(
+        "Compared %d entries in %s: %s per entry\n", num_entries,
+        absl::FormatDuration(elapsed),
+        absl::FormatDuration(elapsed / num_entries));
+  }
+
+  return ::util::OkStatus();
+}
+
+}  // namespace hal
+}  // namespace stratum
+
+int main(int argc, char** argv) {
+  ::gflags::SetUsageMessage(stratum::hal::kUsage);
+  InitGoogle(argv[0], &argc, &argv, true);
+  stratum::InitStratumLogging();
+  return stratum::hal::Main(argc, argv).error_code();
+}
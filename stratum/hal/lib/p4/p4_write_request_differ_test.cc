@@ -6,8 +6,10 @@
 
 #include "stratum/hal/lib/p4/p4_write_request_differ.h"
 
+#include <string>
 #include <vector>
 
+#include "absl/strings/str_cat.h"
 #include "gmock/gmock.h"
 #include "google/protobuf/util/message_differencer.h"
 #include "gtest/gtest.h"
@@ -579,5 +581,187 @@ TEST_F(P4WriteRequestDifferTest, TestIgnoreUpdateType) {
   EXPECT_EQ(3, unchanged_.updates_size());
 }
 
+// Compares requests with many static entries, where one in ten entries is
+// modified, deleted, or added in the new request, and the new request is in
+// reverse order.  Verifies the exact content and order of every output.
+TEST_F(P4WriteRequestDifferTest, TestManyEntries) {
+  constexpr int kNumEntries = 200;
+  ::p4::v1::Update update;
+  ASSERT_OK(ParseProtoFromString(kTestUpdate2, &update));
+  for (int i = 0; i < kNumEntries; ++i) {
+    update.mutable_entity()
+        ->mutable_table_entry()
+        ->mutable_match(0)
+        ->mutable_exact()
+        ->set_value(absl::StrCat(i));
+    *old_request_.add_updates() = update;
+  }
+  ::p4::v1::WriteRequest expected_deletions;
+  ::p4::v1::WriteRequest expected_additions;
+  ::p4::v1::WriteRequest expected_modified;
+  ::p4::v1::WriteRequest expected_unchanged;
+  for (int i = kNumEntries - 1; i >= 0; --i) {
+    if (i % 10 == 1) continue;
+    ::p4::v1::Update* new_update = new_request_.add_updates();
+    *new_update = old_request_.updates(i);
+    if (i % 10 == 0) {
+      new_update->mutable_entity()
+          ->mutable_table_entry()
+          ->mutable_action()
+          ->mutable_action()
+          ->set_action_id(1);
+    } else if (i % 10 == 2) {
+      ::p4::v1::Update* added_update = new_request_.add_updates();
+      *added_update = old_request_.updates(i);
+      added_update->mutable_entity()
+          ->mutable_table_entry()
+          ->mutable_match(0)
+          ->mutable_exact()
+          ->set_value(absl::StrCat(i + kNumEntries));
+      *expected_additions.add_updates() = *added_update;
+    }
+  }
+  // The additions follow the order of new_request_, the other outputs that
+  // of old_request_.
+  for (int i = 0; i < kNumEntries; ++i) {
+    if (i % 10 == 0) {
+      ::p4::v1::Update* modified_update = expected_modified.add_updates();
+      *modified_update = old_request_.updates(i);
+      modified_update->mutable_entity()
+          ->mutable_table_entry()
+          ->mutable_action()
+          ->mutable_action()
+          ->set_action_id(1);
+    } else if (i % 10 == 1) {
+      *expected_deletions.add_updates() = old_request_.updates(i);
+    } else {
+      *expected_unchanged.add_updates() = old_request_.updates(i);
+    }
+  }
+  for (auto& expected_update : *expected_deletions.mutable_updates()) {
+    expected_update.set_type(::p4::v1::Update::DELETE);
+  }
+  for (auto& expected_update : *expected_modified.mutable_updates()) {
+    expected_update.set_type(::p4::v1::Update::MODIFY);
+  }
+
+  P4WriteRequestDiffer test_differ(old_request_, new_request_);
+  EXPECT_OK(
+      test_differ.Compare(&deletions_, &additions_, &modified_, &unchanged_));
+  EXPECT_EQ(kNumEntries / 10, deletions_.updates_size());
+  EXPECT_EQ(kNumEntries / 10, additions_.updates_size());
+  EXPECT_EQ(kNumEntries / 10, modified_.updates_size());
+  EXPECT_TRUE(msg_differencer_.Compare(expected_deletions, deletions_));
+  EXPECT_TRUE(msg_differencer_.Compare(expected_additions, additions_));
+  EXPECT_TRUE(msg_differencer_.Compare(expected_modified, modified_));
+  EXPECT_TRUE(msg_differencer_.Compare(expected_unchanged, unchanged_));
+}
+
+// Verifies that updates with duplicate keys are paired in order, and that the
+// extra updates on either side become deletions or additions.
+TEST_F(P4WriteRequestDifferTest, TestDuplicateKeys) {
+  ::p4::v1::Update update;
+  ASSERT_OK(ParseProtoFromString(kTestUpdate1, &update));
+  const uint32 action_id =
+      update.entity().table_entry().action().action().action_id();
+  auto set_action_id = [](uint32 id, ::p4::v1::Update* u) {
+    u->mutable_entity()
+        ->mutable_table_entry()
+        ->mutable_action()
+        ->mutable_action()
+        ->set_action_id(id);
+  };
+
+  // old_request_ has the key three times with different actions, and
+  // new_request_ twice.  The first old update pairs with the first new one
+  // and is unchanged, the second pairs with the second new one and is
+  // modified, and the third has no pair left.
+  for (uint32 id : {action_id, action_id + 1, action_id + 2}) {
+    set_action_id(id, &update);
+    *old_request_.add_updates() = update;
+  }
+  for (uint32 id : {action_id, action_id + 2}) {
+    set_action_id(id, &update);
+    *new_request_.add_updates() = update;
+  }
+
+  P4WriteRequestDiffer test_differ(old_request_, new_request_);
+  EXPECT_OK(
+      test_differ.Compare(&deletions_, &additions_, &modified_, &unchanged_));
+  ASSERT_EQ(1, unchanged_.updates_size());
+  EXPECT_TRUE(
+      msg_differencer_.Compare(old_request_.updates(0), unchanged_.updates(0)));
+  ASSERT_EQ(1, modified_.updates_size());
+  ::p4::v1::Update expected_update = new_request_.updates(1);
+  expected_update.set_type(::p4::v1::Update::MODIFY);
+  EXPECT_TRUE(msg_differencer_.Compare(expected_update, modified_.updates(0)));
+  ASSERT_EQ(1, deletions_.updates_size());
+  expected_update = old_request_.updates(2);
+  expected_update.set_type(::p4::v1::Update::DELETE);
+  EXPECT_TRUE(msg_differencer_.Compare(expected_update, deletions_.updates(0)));
+  EXPECT_EQ(0, additions_.updates_size());
+
+  // With the requests swapped, the extra update is an addition instead.
+  P4WriteRequestDiffer swapped_differ(new_request_, old_request_);
+  EXPECT_OK(swapped_differ.Compare(&deletions_, &additions_, &modified_,
+                                   &unchanged_));
+  EXPECT_EQ(1, unchanged_.updates_size());
+  EXPECT_EQ(1, modified_.updates_size());
+  EXPECT_EQ(0, deletions_.updates_size());
+  ASSERT_EQ(1, additions_.updates_size());
+  expected_update = old_request_.updates(2);
+  expected_update.set_type(::p4::v1::Update::INSERT);
+  EXPECT_TRUE(msg_differencer_.Compare(expected_update, additions_.updates(0)));
+}
+
+// Verifies that updates are only paired when their keys are equal, also when
+// the keys share everything but the table_id, a field_id, the match type, or
+// the match value, as would happen if entries were paired by key hash alone.
+TEST_F(P4WriteRequestDifferTest, TestSimilarKeysDoNotPair) {
+  ::p4::v1::Update update;
+  ASSERT_OK(ParseProtoFromString(kTestUpdate1, &update));
+  *old_request_.add_updates() = update;
+  auto* table_entry = update.mutable_entity()->mutable_table_entry();
+
+  ::p4::v1::Update other_table = update;
+  other_table.mutable_entity()->mutable_table_entry()->set_table_id(
+      table_entry->table_id() + 1);
+  *new_request_.add_updates() = other_table;
+  ::p4::v1::Update other_field = update;
+  other_field.mutable_entity()
+      ->mutable_table_entry()
+      ->mutable_match(0)
+      ->set_field_id(2);
+  *new_request_.add_updates() = other_field;
+  ::p4::v1::Update other_type = update;
+  auto* match =
+      other_type.mutable_entity()->mutable_table_entry()->mutable_match(0);
+  match->mutable_lpm()->set_value(table_entry->match(0).exact().value());
+  match->mutable_lpm()->set_prefix_len(8);
+  *new_request_.add_updates() = other_type;
+  ::p4::v1::Update other_value = update;
+  other_value.mutable_entity()
+      ->mutable_table_entry()
+      ->mutable_match(0)
+      ->mutable_exact()
+      ->set_value("\004");
+  *new_request_.add_updates() = other_value;
+  // An update that is not a table entry never pairs either.
+  ::p4::v1::Update no_table_entry;
+  no_table_entry.set_type(::p4::v1::Update::INSERT);
+  no_table_entry.mutable_entity()->mutable_counter_entry()->set_counter_id(
+      table_entry->table_id());
+  *old_request_.add_updates() = no_table_entry;
+  *new_request_.add_updates() = no_table_entry;
+
+  P4WriteRequestDiffer test_differ(old_request_, new_request_);
+  EXPECT_OK(
+      test_differ.Compare(&deletions_, &additions_, &modified_, &unchanged_));
+  EXPECT_EQ(2, deletions_.updates_size());
+  EXPECT_EQ(5, additions_.updates_size());
+  EXPECT_EQ(0, modified_.updates_size());
+  EXPECT_EQ(0, unchanged_.updates_size());
+}
+
 }  // namespace hal
 }  // namespace stratum
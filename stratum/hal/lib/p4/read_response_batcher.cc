@@ -0,0 +1,99 @@
+// Copyright 2024 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#include "stratum/hal/lib/p4/read_response_batcher.h"
+
+#include "gflags/gflags.h"
+#include "google/protobuf/io/coded_stream.h"
+#include "stratum/glue/logging.h"
+#include "stratum/glue/status/status_macros.h"
+#include "stratum/lib/macros.h"
+#include "stratum/public/lib/error.h"
+
+DEFINE_uint32(read_response_max_entities, 1000,
+              "Maximum number of entities in a single ReadResponse message. "
+              "Larger reads are streamed in several messages. 0 disables "
+              "the limit.");
+DEFINE_uint32(read_response_max_bytes, 1024 * 1024,
+              "Approximate maximum encoded size in bytes of a single "
+              "ReadResponse message. Keep it below the gRPC maximum message "
+              "size of the clients. 0 disables the limit.");
+
+namespace stratum {
+namespace hal {
+
+ReadResponseBatcher::ReadResponseBatcher(
+    WriterInterface<::p4::v1::ReadResponse>* writer)
+    : ReadResponseBatcher(writer, FLAGS_read_response_max_entities,
+                          FLAGS_read_response_max_bytes) {}
+
+ReadResponseBatcher::ReadResponseBatcher(
+    WriterInterface<::p4::v1::ReadResponse>* writer, size_t max_entities,
+    size_t max_bytes)
+    : writer_(writer),
+      max_entities_(max_entities),
+      max_bytes_(max_bytes),
+      response_(
+          ::google::protobuf::Arena::CreateMessage<::p4::v1::ReadResponse>(
+              &arena_)),
+      num_sized_entities_(0),
+      batch_bytes_(0),
+      num_responses_written_(0) {}
+
+::util::StatusOr<::p4::v1::Entity*> ReadResponseBatcher::AddEntity() {
+  UpdateBatchSize();
+  const size_t num_entities = response_->entities_size();
+  if ((max_entities_ != 0 && num_entities >= max_entities_) ||
+      (max_bytes_ != 0 && batch_bytes_ >= max_bytes_)) {
+    RETURN_IF_ERROR(WriteBatch());
+  }
+
+  return response_->add_entities();
+}
+
+void ReadResponseBatcher::RemoveLastEntity() {
+  if (response_->entities_size() > num_sized_entities_) {
+    response_->mutable_entities()->RemoveLast();
+  }
+}
+
+::util::Status ReadResponseBatcher::Finish() {
+  if (response_->entities_size() > 0 || num_responses_written_ == 0) {
+    RETURN_IF_ERROR(WriteBatch());
+  }
+
+  return ::util::OkStatus();
+}
+
+void ReadResponseBatcher::UpdateBatchSize() {
+  for (; num_sized_entities_ < response_->entities_size();
+       ++num_sized_entities_) {
+    // Each entity is encoded as a one byte tag, its length and its content.
+    size_t entity_bytes =
+        response_->entities(num_sized_entities_).ByteSizeLong();
+    batch_bytes_ +=
+        1 +
+        ::google::protobuf::io::CodedOutputStream::VarintSize64(entity_bytes) +
+        entity_bytes;
+  }
+}
+
+::util::Status ReadResponseBatcher::WriteBatch() {
+  RET_CHECK(writer_ != nullptr) << "Null writer.";
+  VLOG(2) << "Writing ReadResponse with " << response_->entities_size()
+          << " entities.";
+  if (!writer_->Write(*response_)) {
+    return MAKE_ERROR(ERR_INTERNAL) << "Write to stream failed.";
+  }
+  ++num_responses_written_;
+  arena_.Reset();
+  response_ =
+      ::google::protobuf::Arena::CreateMessage<::p4::v1::ReadResponse>(&arena_);
+  num_sized_entities_ = 0;
+  batch_bytes_ = 0;
+
+  return ::util::OkStatus();
+}
+
+}  // namespace hal
+}  // namespace stratum
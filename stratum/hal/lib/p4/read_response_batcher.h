@@ -0,0 +1,101 @@
+// Copyright 2024 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+// The ReadResponseBatcher builds the ReadResponse messages of a P4Runtime
+// read in place and streams them in bounded batches.
+
+#ifndef STRATUM_HAL_LIB_P4_READ_RESPONSE_BATCHER_H_
+#define STRATUM_HAL_LIB_P4_READ_RESPONSE_BATCHER_H_
+
+#include <stddef.h>
+
+#include "google/protobuf/arena.h"
+#include "p4/v1/p4runtime.pb.h"
+#include "stratum/glue/status/status.h"
+#include "stratum/glue/status/statusor.h"
+#include "stratum/hal/lib/common/writer_interface.h"
+
+namespace stratum {
+namespace hal {
+
+// The ReadResponseBatcher collects the entities of a read into a ReadResponse
+// allocated in a protobuf arena. Callers fill each entity in place instead of
+// copying a separately built message into the response. The response is
+// written to the stream and the arena released whenever the batch reaches a
+// maximum number of entities or an approximate maximum encoded size, so that
+// reads of large tables neither exceed the gRPC message size limit nor keep
+// every entry in memory. The size of an entity is only known once it has been
+// filled, so a batch can exceed the byte limit by at most one entity.
+//
+// Typical usage:
+//   ReadResponseBatcher batcher(writer);
+//   for (...) {
+//     ASSIGN_OR_RETURN(::p4::v1::Entity* entity, batcher.AddEntity());
+//     ... fill entity->mutable_table_entry() ...
+//     if (filtered out) batcher.RemoveLastEntity();
+//   }
+//   RETURN_IF_ERROR(batcher.Finish());
+class ReadResponseBatcher {
+ public:
+  // Uses the batch limits given by the read_response_max_entities and
+  // read_response_max_bytes flags. A zero limit disables the limit.
+  explicit ReadResponseBatcher(WriterInterface<::p4::v1::ReadResponse>* writer);
+  ReadResponseBatcher(WriterInterface<::p4::v1::ReadResponse>* writer,
+                      size_t max_entities, size_t max_bytes);
+  virtual ~ReadResponseBatcher() {}
+
+  // Returns a new empty entity of the current batch, to be filled by the
+  // caller. The current batch is written first if the entities added so far
+  // reached one of the limits. The returned pointer stays valid until the
+  // next call to AddEntity() or Finish().
+  ::util::StatusOr<::p4::v1::Entity*> AddEntity();
+
+  // Removes the entity returned by the last AddEntity() call, e.g. when it
+  // does not pass the filters of the read request.
+  void RemoveLastEntity();
+
+  // Writes the last batch. A single empty response is written if the read
+  // did not return any entity.
+  ::util::Status Finish();
+
+  // Returns the number of ReadResponse messages written so far.
+  int num_responses_written() const { return num_responses_written_; }
+
+  // ReadResponseBatcher is neither copyable nor movable.
+  ReadResponseBatcher(const ReadResponseBatcher&) = delete;
+  ReadResponseBatcher& operator=(const ReadResponseBatcher&) = delete;
+
+ private:
+  // Adds the encoded size of the entities added since the last call to the
+  // size of the batch.
+  void UpdateBatchSize();
+
+  // Writes the current batch and starts a new one in a cleared arena.
+  ::util::Status WriteBatch();
+
+  // The writer the batches are written to. Not owned by this class.
+  WriterInterface<::p4::v1::ReadResponse>* const writer_;
+
+  // Batch limits, zero if unlimited.
+  const size_t max_entities_;
+  const size_t max_bytes_;
+
+  // The arena holding the current batch.
+  ::google::protobuf::Arena arena_;
+
+  // The current batch, owned by the arena.
+  ::p4::v1::ReadResponse* response_;
+
+  // Number of entities of the current batch whose size is in batch_bytes_.
+  int num_sized_entities_;
+
+  // Approximate encoded size of the current batch.
+  size_t batch_bytes_;
+
+  int num_responses_written_;
+};
+
+}  // namespace hal
+}  // namespace stratum
+
+#endif  // STRATUM_HAL_LIB_P4_READ_RESPONSE_BATCHER_H_
@@ -0,0 +1,105 @@
+// Copyright 2024 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#include "stratum/hal/lib/p4/read_response_batcher.h"
+
+#include <string>
+#include <vector>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "stratum/glue/integral_types.h"
+#include "stratum/glue/status/status_macros.h"
+#include "stratum/glue/status/status_test_util.h"
+#include "stratum/hal/lib/common/writer_mock.h"
+
+namespace stratum {
+namespace hal {
+
+using ::testing::_;
+using ::testing::Invoke;
+using ::testing::Return;
+
+class ReadResponseBatcherTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    ON_CALL(writer_mock_, Write(_))
+        .WillByDefault(Invoke([this](const ::p4::v1::ReadResponse& resp) {
+          responses_.push_back(resp);
+          return true;
+        }));
+  }
+
+  // Adds a table entry with the given table ID and metadata.
+  ::util::Status AddTableEntry(ReadResponseBatcher* batcher, uint32 table_id,
+                               const std::string& metadata = "") {
+    ASSIGN_OR_RETURN(::p4::v1::Entity* entity, batcher->AddEntity());
+    entity->mutable_table_entry()->set_table_id(table_id);
+    entity->mutable_table_entry()->set_metadata(metadata);
+    return ::util::OkStatus();
+  }
+
+  WriterMock<::p4::v1::ReadResponse> writer_mock_;
+  std::vector<::p4::v1::ReadResponse> responses_;
+};
+
+TEST_F(ReadResponseBatcherTest, EmptyReadWritesOneEmptyResponse) {
+  EXPECT_CALL(writer_mock_, Write(_)).Times(1);
+  ReadResponseBatcher batcher(&writer_mock_, 2, 0);
+  ASSERT_OK(batcher.Finish());
+  ASSERT_EQ(1, responses_.size());
+  EXPECT_EQ(0, responses_[0].entities_size());
+}
+
+TEST_F(ReadResponseBatcherTest, FlushesAtEntityLimit) {
+  EXPECT_CALL(writer_mock_, Write(_)).Times(3);
+  ReadResponseBatcher batcher(&writer_mock_, 2, 0);
+  for (uint32 i = 1; i <= 5; ++i) {
+    ASSERT_OK(AddTableEntry(&batcher, i));
+  }
+  ASSERT_OK(batcher.Finish());
+  EXPECT_EQ(3, batcher.num_responses_written());
+  ASSERT_EQ(3, responses_.size());
+  EXPECT_EQ(2, responses_[0].entities_size());
+  EXPECT_EQ(2, responses_[1].entities_size());
+  ASSERT_EQ(1, responses_[2].entities_size());
+  EXPECT_EQ(5, responses_[2].entities(0).table_entry().table_id());
+}
+
+TEST_F(ReadResponseBatcherTest, FlushesAtByteLimit) {
+  const std::string metadata(100, 'x');
+  EXPECT_CALL(writer_mock_, Write(_)).Times(2);
+  ReadResponseBatcher batcher(&writer_mock_, 0, 250);
+  for (uint32 i = 1; i <= 4; ++i) {
+    ASSERT_OK(AddTableEntry(&batcher, i, metadata));
+  }
+  ASSERT_OK(batcher.Finish());
+  ASSERT_EQ(2, responses_.size());
+  // The batch reaches the limit with its third entity.
+  EXPECT_EQ(3, responses_[0].entities_size());
+  EXPECT_EQ(1, responses_[1].entities_size());
+}
+
+TEST_F(ReadResponseBatcherTest, RemovedEntitiesAreNotWritten) {
+  EXPECT_CALL(writer_mock_, Write(_)).Times(1);
+  ReadResponseBatcher batcher(&writer_mock_, 2, 0);
+  for (uint32 i = 1; i <= 4; ++i) {
+    ASSERT_OK(AddTableEntry(&batcher, i));
+    if (i % 2) batcher.RemoveLastEntity();
+  }
+  ASSERT_OK(batcher.Finish());
+  ASSERT_EQ(1, responses_.size());
+  ASSERT_EQ(2, responses_[0].entities_size());
+  EXPECT_EQ(2, responses_[0].entities(0).table_entry().table_id());
+  EXPECT_EQ(4, responses_[0].entities(1).table_entry().table_id());
+}
+
+TEST_F(ReadResponseBatcherTest, WriteFailureIsReported) {
+  EXPECT_CALL(writer_mock_, Write(_)).WillOnce(Return(false));
+  ReadResponseBatcher batcher(&writer_mock_, 1, 0);
+  ASSERT_OK(AddTableEntry(&batcher, 1));
+  EXPECT_FALSE(AddTableEntry(&batcher, 2).ok());
+}
+
+}  // namespace hal
+}  // namespace stratum
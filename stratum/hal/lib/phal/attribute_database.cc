@@ -12,7 +12,6 @@
 #include "absl/memory/memory.h"
 #include "absl/synchronization/mutex.h"
 #include "absl/time/time.h"
-#include "google/protobuf/util/message_differencer.h"
 #include "stratum/glue/status/status_macros.h"
 #include "stratum/hal/lib/phal/dummy_threadpool.h"
 #include "stratum/lib/constants.h"
@@ -54,13 +53,13 @@ DatabaseQuery::~DatabaseQuery() {
   // If the query is already marked as updated (e.g. due to a runtime
   // configurator), it's a waste of time to check for updates.
   if (!query_.IsUpdated()) {
-    // If the result of this query has changed, set the update bit.
-    ASSIGN_OR_RETURN(auto polling_result, Get());
-    if (last_polling_result_ == nullptr ||
-        !google::protobuf::util::MessageDifferencer::Equals(
-            *last_polling_result_, *polling_result)) {
+    // If any attribute in this query has changed, set the update bit. We rely
+    // on attribute version stamps here rather than building and comparing the
+    // full query result, which is expensive for large idle queries.
+    ASSIGN_OR_RETURN(bool changed, query_.Refresh());
+    if (changed || !has_polling_result_) {
       query_.MarkUpdated();
-      last_polling_result_ = std::move(polling_result);
+      has_polling_result_ = true;
     }
   }
   return ::util::OkStatus();
@@ -117,7 +116,7 @@ void DatabaseQuery::RecalculatePollingInterval() {
   }
   if (subscribers_removed) RecalculatePollingInterval();
   query_.ClearUpdated();
-  last_polling_result_ = std::move(polling_result);
+  has_polling_result_ = true;
   return ::util::OkStatus();
 }
 
@@ -150,7 +150,8 @@ class DatabaseQuery : public Query {
 
   // Polls this query to see if the result has changed since the last time Poll
   // was called. If the result has changed, sets the update bit in the internal
-  // AttributeGroupQuery.
+  // AttributeGroupQuery. Changes are detected through attribute version stamps,
+  // so polling an unchanged query does not build a new PhalDB.
   ::util::Status Poll(absl::Time poll_time);
   AttributeGroupQuery* InternalQuery() { return &query_; }
   // Returns the next time we're supposed to poll this query, based on the
@@ -182,7 +183,9 @@ class DatabaseQuery : public Query {
   absl::Duration polling_interval_ = absl::InfiniteDuration();
 
   absl::Time last_polling_time_;
-  std::unique_ptr<PhalDB> last_polling_result_;
+  // Set once the result of this query has been evaluated at least once. Until
+  // then, the first poll always marks the query as updated.
+  bool has_polling_result_ = false;
 };
 
 }  // namespace phal
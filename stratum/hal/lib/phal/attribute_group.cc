@@ -383,6 +383,18 @@ void AttributeGroupQueryNode::RemoveAllFields() {
 }
 
 ::util::Status AttributeGroupQuery::Get(google::protobuf::Message* out) {
+  bool changed = false;
+  return Execute(false, &changed, out);
+}
+
+::util::StatusOr<bool> AttributeGroupQuery::Refresh() {
+  bool changed = false;
+  RETURN_IF_ERROR(Execute(true, &changed, nullptr));
+  return changed;
+}
+
+::util::Status AttributeGroupQuery::Execute(bool changed_only, bool* changed,
+                                            google::protobuf::Message* out) {
   std::queue<std::unique_ptr<ReadableAttributeGroup>> group_locks;
   absl::flat_hash_map<
       DataSource*,
@@ -404,6 +416,8 @@ void AttributeGroupQueryNode::RemoveAllFields() {
   // We can now execute our query in a threadpool.
   ::util::Status output_status;
   absl::Mutex output_status_lock;
+  absl::flat_hash_map<const AttributeSetterFunction*, uint64>
+      attribute_versions;
   {
     // We acquire our query lock to avoid messy interleaving with other calls to
     // Get().
@@ -416,8 +430,20 @@ void AttributeGroupQueryNode::RemoveAllFields() {
             datasource_and_attributes.first->UpdateValuesAndLock();
         if (update_status.ok()) {
           for (auto& attribute_and_setter : datasource_and_attributes.second) {
-            update_status = (*attribute_and_setter.second)(
-                attribute_and_setter.first->GetValue());
+            const AttributeSetterFunction* setter = attribute_and_setter.second;
+            uint64 version = attribute_and_setter.first->GetVersion();
+            {
+              absl::MutexLock l(&output_status_lock);
+              attribute_versions[setter] = version;
+              if (changed_only) {
+                const uint64* last_version =
+                    gtl::FindOrNull(attribute_versions_, setter);
+                if (last_version != nullptr && *last_version == version)
+                  continue;
+              }
+              *changed = true;
+            }
+            update_status = (*setter)(attribute_and_setter.first->GetValue());
           }
         }
         if (!update_status.ok()) {
@@ -428,7 +454,9 @@ void AttributeGroupQueryNode::RemoveAllFields() {
       }));
     }
     threadpool_->WaitAll(task_ids);
-    out->CopyFrom(*query_result_);
+    // Attributes that are no longer part of this query are dropped here.
+    attribute_versions_ = std::move(attribute_versions);
+    if (out != nullptr) out->CopyFrom(*query_result_);
   }
   while (!group_locks.empty()) group_locks.pop();
   return output_status;
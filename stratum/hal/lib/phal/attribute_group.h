@@ -220,6 +220,12 @@ class AttributeGroupQuery {
   // same type used for the descriptor of root_group.
   ::util::Status Get(google::protobuf::Message* out)
       LOCKS_EXCLUDED(query_lock_);
+  // Executes this query, but only writes the values of attributes whose
+  // version has changed since the last call to Get or Refresh into the
+  // internal query result. Returns true iff any such attribute was found. This
+  // is much cheaper than calling Get and comparing the results when nothing
+  // has changed.
+  ::util::StatusOr<bool> Refresh() LOCKS_EXCLUDED(query_lock_);
   ::util::Status Subscribe(std::unique_ptr<ChannelWriter<PhalDB>> subscriber,
                            absl::Duration polling_interval)
       LOCKS_EXCLUDED(query_lock_);
@@ -231,10 +237,24 @@ class AttributeGroupQuery {
  private:
   friend class AttributeGroupQueryNode;
 
+  // Shared implementation of Get and Refresh. If changed_only is true, only
+  // attributes whose version differs from attribute_versions_ are written into
+  // query_result_. Sets *changed to true iff any attribute was written. If out
+  // is not null, the query result is copied into it.
+  ::util::Status Execute(bool changed_only, bool* changed,
+                         google::protobuf::Message* out)
+      LOCKS_EXCLUDED(query_lock_);
+
   AttributeGroup* root_group_;
   ThreadpoolInterface* threadpool_;
   std::unique_ptr<google::protobuf::Message> query_result_;
   absl::Mutex query_lock_;
+  // The version of each queried attribute at the time its value was last
+  // written into query_result_, keyed by the setter of the query path. Since
+  // versions are unique across attributes, this also catches the attribute of
+  // a query path being replaced by another one.
+  absl::flat_hash_map<const AttributeSetterFunction*, uint64>
+      attribute_versions_ GUARDED_BY(query_lock_);
   // If true, the result of this query has changed and a streaming message
   // should shortly be sent to all subscribers.
   bool query_updated_ GUARDED_BY(query_lock_) = false;
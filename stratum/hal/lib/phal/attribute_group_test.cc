@@ -775,6 +775,71 @@ TEST_F(AttributeGroupQueryTest, CanGetAllFieldTypes) {
   EXPECT_EQ(result.top_val(), TopEnum::TWO);
 }
 
+TEST_F(AttributeGroupQueryTest, RefreshOnlyReportsChangedAttributes) {
+  auto datasource = FixedDataSource<int32>::Make(kInt32TestVal);
+  auto attribute =
+      static_cast<TypedAttribute<int32>*>(datasource->GetAttribute());
+  ASSERT_OK(group_->AcquireMutable()->AddAttribute("int32_val", attribute));
+  DummyThreadpool threadpool;
+  AttributeGroupQuery query(group_.get(), &threadpool);
+  ASSERT_OK(group_->AcquireReadable()->RegisterQuery(
+      &query, {{PathEntry("int32_val")}}));
+
+  TestTop result;
+  ASSERT_OK(query.Get(&result));
+  EXPECT_EQ(result.int32_val(), kInt32TestVal);
+
+  // Nothing has changed since the last Get.
+  ASSERT_OK_AND_ASSIGN(bool changed, query.Refresh());
+  EXPECT_FALSE(changed);
+
+  // Assigning the same value does not bump the attribute version.
+  uint64 version = attribute->GetVersion();
+  attribute->AssignValue(kInt32TestVal);
+  EXPECT_EQ(attribute->GetVersion(), version);
+  ASSERT_OK_AND_ASSIGN(changed, query.Refresh());
+  EXPECT_FALSE(changed);
+
+  attribute->AssignValue(kInt32TestVal + 1);
+  EXPECT_GT(attribute->GetVersion(), version);
+  ASSERT_OK_AND_ASSIGN(changed, query.Refresh());
+  EXPECT_TRUE(changed);
+  ASSERT_OK(query.Get(&result));
+  EXPECT_EQ(result.int32_val(), kInt32TestVal + 1);
+
+  ASSERT_OK_AND_ASSIGN(changed, query.Refresh());
+  EXPECT_FALSE(changed);
+}
+
+TEST_F(AttributeGroupQueryTest, RefreshReportsReplacedAttributes) {
+  // Both attributes are assigned a value once, so a per-attribute counter
+  // would give them the same version.
+  auto datasource = FixedDataSource<int32>::Make(kInt32TestVal);
+  auto replacement = FixedDataSource<int32>::Make(kInt32TestVal + 1);
+  ASSERT_OK(group_->AcquireMutable()->AddAttribute(
+      "int32_val", datasource->GetAttribute()));
+  DummyThreadpool threadpool;
+  AttributeGroupQuery query(group_.get(), &threadpool);
+  ASSERT_OK(group_->AcquireReadable()->RegisterQuery(
+      &query, {{PathEntry("int32_val")}}));
+
+  TestTop result;
+  ASSERT_OK(query.Get(&result));
+  EXPECT_EQ(result.int32_val(), kInt32TestVal);
+  EXPECT_NE(datasource->GetAttribute()->GetVersion(),
+            replacement->GetAttribute()->GetVersion());
+
+  ASSERT_OK(group_->AcquireMutable()->AddAttribute(
+      "int32_val", replacement->GetAttribute()));
+  ASSERT_OK_AND_ASSIGN(bool changed, query.Refresh());
+  EXPECT_TRUE(changed);
+  ASSERT_OK(query.Get(&result));
+  EXPECT_EQ(result.int32_val(), kInt32TestVal + 1);
+
+  ASSERT_OK_AND_ASSIGN(changed, query.Refresh());
+  EXPECT_FALSE(changed);
+}
+
 TEST_F(AttributeGroupQueryTest, CanCallQueryGetAfterModification) {
   DummyThreadpool threadpool;
   AttributeGroupQuery query(group_.get(), &threadpool);
@@ -5,10 +5,12 @@
 #ifndef STRATUM_HAL_LIB_PHAL_MANAGED_ATTRIBUTE_H_
 #define STRATUM_HAL_LIB_PHAL_MANAGED_ATTRIBUTE_H_
 
+#include <atomic>
 #include <functional>
 #include <memory>
 
 #include "google/protobuf/descriptor.h"
+#include "stratum/glue/integral_types.h"
 #include "stratum/glue/status/status.h"
 #include "stratum/glue/status/status_macros.h"
 #include "stratum/hal/lib/phal/attribute_database_interface.h"
@@ -21,6 +23,14 @@ namespace phal {
 class DataSource;
 // class TypedAttribute;
 
+// Returns a new attribute version stamp. Stamps come from a single process-wide
+// counter, so two different attributes never share a stamp and replacing the
+// attribute behind a query path always changes the version seen by the query.
+inline uint64 NextAttributeVersion() {
+  static std::atomic<uint64> last_version{0};
+  return last_version.fetch_add(1, std::memory_order_relaxed) + 1;
+}
+
 // A single attribute in an attribute database.
 // Allows accessing the stored value, and can provide a data source if
 // one exists.
@@ -44,6 +54,12 @@ class ManagedAttribute {
         << "Attempted to read an attribute with the incorrect type.";
     return *typed_value;
   }
+  // Returns a version stamp, taken from NextAttributeVersion(), that changes
+  // every time the value of this attribute changes. Like GetValue, this should
+  // only be called while the owning datasource is locked. Streaming queries use
+  // this to skip attributes whose value has not changed since they were last
+  // polled.
+  virtual uint64 GetVersion() const = 0;
   // Returns the data source for this attribute if it exists. If the caller of
   // GetDataSource wants to hold this pointer, it should acquire a shared_ptr
   // instead by calling GetDataSource()->GetSharedPointer().
@@ -65,6 +81,7 @@ class TypedAttribute : public ManagedAttribute {
   explicit TypedAttribute(DataSource* datasource) : datasource_(datasource) {}
   ~TypedAttribute() override {}
   Attribute GetValue() const override { return value_; }
+  uint64 GetVersion() const override { return version_; }
   DataSource* GetDataSource() const override { return datasource_; }
   bool CanSet() const override { return setter_ != nullptr; }
   ::util::Status Set(Attribute value) override {
@@ -77,11 +94,17 @@ class TypedAttribute : public ManagedAttribute {
   void AddSetter(std::function<::util::Status(T value)> setter) {
     setter_ = setter;
   }
-  void AssignValue(const T& value) { value_ = value; }
+  void AssignValue(const T& value) {
+    if (value_ != value) {
+      value_ = value;
+      version_ = NextAttributeVersion();
+    }
+  }
 
  protected:
   DataSource* datasource_;
   T value_{};
+  uint64 version_ = NextAttributeVersion();
   std::function<::util::Status(T value)> setter_;
 };
 
@@ -105,11 +128,11 @@ class EnumAttribute
                           << " to enum attribute of type "
                           << value_->type()->name();
     }
-    value_ = value;
+    TypedAttribute::AssignValue(value);
     return ::util::OkStatus();
   }
   EnumAttribute& operator=(int number) {
-    value_ = value_->type()->FindValueByNumber(number);
+    TypedAttribute::AssignValue(value_->type()->FindValueByNumber(number));
     return *this;
   }
   template <typename E>
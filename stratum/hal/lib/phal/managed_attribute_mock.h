@@ -19,6 +19,7 @@ namespace phal {
 class ManagedAttributeMock : public ManagedAttribute {
  public:
   MOCK_CONST_METHOD0(GetValue, Attribute());
+  MOCK_CONST_METHOD0(GetVersion, uint64());
   MOCK_CONST_METHOD0(GetDataSource, DataSource*());
   MOCK_CONST_METHOD0(CanSet, bool());
   MOCK_METHOD1(Set, ::util::Status(Attribute value));
@@ -4,6 +4,10 @@
 
 #include "stratum/hal/lib/phal/system_fake.h"
 
+#include <errno.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
 #include "absl/memory/memory.h"
 #include "absl/synchronization/mutex.h"
 #include "stratum/lib/macros.h"
@@ -28,6 +32,13 @@ void SystemFake::SendUdevUpdate(const std::string& udev_filter,
     updated_udev_devices_.insert(
         std::make_pair(udev_filter, std::set<std::string>()));
     updated_udev_devices_[udev_filter].insert(dev_path);
+    // Wake up anyone waiting on the monitors.
+    for (UdevMonitorFake* monitor : udev_monitors_) {
+      uint64_t value = 1;
+      if (write(monitor->event_fd_, &value, sizeof(value)) != sizeof(value)) {
+        LOG(ERROR) << "Failed to signal fake udev monitor.";
+      }
+    }
   }
 }
 
@@ -76,6 +87,20 @@ UdevFake::EnumerateSubsystem(const std::string& subsystem) {
   return enumeration;
 }
 
+UdevMonitorFake::UdevMonitorFake(const SystemFake* system)
+    : system_(system), event_fd_(eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC)) {
+  absl::MutexLock lock(&system_->udev_mutex_);
+  system_->udev_monitors_.insert(this);
+}
+
+UdevMonitorFake::~UdevMonitorFake() {
+  {
+    absl::MutexLock lock(&system_->udev_mutex_);
+    system_->udev_monitors_.erase(this);
+  }
+  if (event_fd_ >= 0) close(event_fd_);
+}
+
 ::util::Status UdevMonitorFake::AddFilter(const std::string& subsystem) {
   RET_CHECK(!receiving_);
   // This currently only supports testing subsystem filters. We'll need to
@@ -92,6 +117,12 @@ UdevFake::EnumerateSubsystem(const std::string& subsystem) {
 ::util::StatusOr<bool> UdevMonitorFake::GetUdevEvent(Udev::Event* event) {
   absl::MutexLock lock(&system_->udev_mutex_);
   RET_CHECK(receiving_);
+  // Clear the eventfd before looking for updates. Updates sent from now on
+  // signal it again, so none can be missed by a waiter.
+  uint64_t value;
+  if (read(event_fd_, &value, sizeof(value)) < 0 && errno != EAGAIN) {
+    return MAKE_ERROR() << "Failed to read fake udev monitor eventfd.";
+  }
   for (const auto& udev_filter : filters_) {
     auto filter_updates = system_->updated_udev_devices_.find(udev_filter);
     if (filter_updates != system_->updated_udev_devices_.end()) {
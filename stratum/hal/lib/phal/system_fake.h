@@ -36,15 +36,21 @@ class UdevFake : public Udev {
 
 class UdevMonitorFake : public UdevMonitor {
  public:
-  explicit UdevMonitorFake(const SystemFake* system) : system_(system) {}
+  explicit UdevMonitorFake(const SystemFake* system);
+  ~UdevMonitorFake() override;
   ::util::Status AddFilter(const std::string& subsystem) override;
   ::util::Status EnableReceiving() override;
   ::util::StatusOr<bool> GetUdevEvent(Udev::Event* event) override;
+  int GetFd() const override { return event_fd_; }
 
  private:
+  friend class SystemFake;
   const SystemFake* system_;
   std::set<std::string> filters_;
   bool receiving_ = false;
+  // An eventfd signaled by SystemFake::SendUdevUpdate, so that the fake can be
+  // waited on like a real udev monitor.
+  int event_fd_;
 };
 
 // A fake system for testing the attribute database.
@@ -88,6 +94,8 @@ class SystemFake : public SystemInterface {
       udev_state_ GUARDED_BY(udev_mutex_);
   mutable std::map<std::string, std::set<std::string>> updated_udev_devices_
       GUARDED_BY(udev_mutex_);
+  // All the existing monitors, signaled whenever an event is sent.
+  mutable std::set<UdevMonitorFake*> udev_monitors_ GUARDED_BY(udev_mutex_);
 };
 
 }  // namespace phal
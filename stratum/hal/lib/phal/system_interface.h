@@ -66,6 +66,11 @@ class UdevMonitor {
   // filled with the new udev event's information. If false is returned,
   // the passed event is unchanged.
   virtual ::util::StatusOr<bool> GetUdevEvent(Udev::Event* event) = 0;
+
+  // Returns a file descriptor that becomes readable when a new udev event can
+  // be received with GetUdevEvent, e.g. to wait for events with epoll. Returns
+  // -1 if the monitor has no such descriptor, in which case it must be polled.
+  virtual int GetFd() const { return -1; }
 };
 
 // A mockable interface for all system interactions performed by
@@ -44,6 +44,7 @@ class UdevMonitorReal : public UdevMonitor {
   ::util::Status AddFilter(const std::string& subsystem) override;
   ::util::Status EnableReceiving() override;
   ::util::StatusOr<bool> GetUdevEvent(Udev::Event* event) override;
+  int GetFd() const override { return fd_; }
 
  protected:
   bool receiving_;
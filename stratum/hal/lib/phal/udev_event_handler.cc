@@ -4,16 +4,23 @@
 
 #include "stratum/hal/lib/phal/udev_event_handler.h"
 
+#include <string.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
 #include <utility>
 
 #include "absl/synchronization/mutex.h"
 #include "gflags/gflags.h"
 #include "stratum/glue/gtl/map_util.h"
+#include "stratum/glue/status/posix_error_space.h"
 #include "stratum/hal/lib/common/constants.h"
 #include "stratum/lib/macros.h"
 
 DEFINE_int32(udev_polling_interval_ms, 200,
-             "Polling interval for checking udev events in the udev thread.");
+             "Polling interval for checking udev events in the udev thread, "
+             "for the udev monitors that cannot be waited on.");
 
 namespace stratum {
 namespace hal {
@@ -21,6 +28,8 @@ namespace phal {
 
 // TODO(unknown): Add a udev action type enum for ADD, REMOVE, and CHANGE.
 
+constexpr int UdevEventHandler::kMaxEpollEvents;
+
 UdevEventCallback::UdevEventCallback(const std::string& udev_filter,
                                      const std::string& dev_path)
     : udev_filter_(udev_filter), dev_path_(dev_path) {}
@@ -39,7 +48,12 @@ UdevEventHandler::~UdevEventHandler() {
     absl::MutexLock lock(&udev_lock_);
     std::swap(running, udev_monitor_loop_running_);
   }
-  if (running) pthread_join(udev_monitor_loop_thread_id_, nullptr);
+  if (running) {
+    WakeUpMonitorLoop();
+    pthread_join(udev_monitor_loop_thread_id_, nullptr);
+  }
+  if (epoll_fd_ >= 0) close(epoll_fd_);
+  if (wakeup_fd_ >= 0) close(wakeup_fd_);
 
   // Unregister any remaining event callbacks.
   absl::MutexLock lock(&udev_lock_);
@@ -63,6 +77,19 @@ UdevEventHandler::~UdevEventHandler() {
   ASSIGN_OR_RETURN(udev_monitor, udev_->MakeUdevMonitor());
   RETURN_IF_ERROR(udev_monitor->AddFilter(udev_filter));
   RETURN_IF_ERROR(udev_monitor->EnableReceiving());
+  int fd = udev_monitor->GetFd();
+  if (fd >= 0) {
+    struct epoll_event event = {};
+    event.events = EPOLLIN;
+    event.data.fd = fd;
+    if (epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, fd, &event) != 0) {
+      return ::util::PosixErrorToStatus(
+          errno, "Failed to add udev monitor for " + udev_filter + " to epoll");
+    }
+  } else {
+    // The loop falls back to polling while such a monitor exists.
+    ++num_polled_udev_monitors_;
+  }
   UdevMonitorInfo monitor_info;
   // We've successfully started listening, so we can enumerate devices.
   ASSIGN_OR_RETURN(auto existing_dev_paths_and_actions,
@@ -134,6 +161,8 @@ void UdevEventHandler::AddUpdateCallback(
   found_monitor->dev_path_to_last_action.insert(
       std::make_pair(callback->GetDevPath(), fake_action));
   callback->SetUdevEventHandler(this);
+  // Send the initial callback right away.
+  WakeUpMonitorLoop();
   return ::util::OkStatus();
 }
 
@@ -173,6 +202,20 @@ UdevEventHandler::MakeUdevEventHandler(
 ::util::Status UdevEventHandler::InitializeUdev() {
   absl::MutexLock lock(&udev_lock_);
   ASSIGN_OR_RETURN(udev_, system_interface_->MakeUdev());
+  epoll_fd_ = epoll_create1(EPOLL_CLOEXEC);
+  if (epoll_fd_ < 0) {
+    return ::util::PosixErrorToStatus(errno, "epoll_create1 failed");
+  }
+  wakeup_fd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+  if (wakeup_fd_ < 0) {
+    return ::util::PosixErrorToStatus(errno, "eventfd failed");
+  }
+  struct epoll_event event = {};
+  event.events = EPOLLIN;
+  event.data.fd = wakeup_fd_;
+  if (epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, wakeup_fd_, &event) != 0) {
+    return ::util::PosixErrorToStatus(errno, "Failed to add eventfd to epoll");
+  }
   return ::util::OkStatus();
 }
 
@@ -191,14 +234,40 @@ void* UdevEventHandler::RunUdevMonitorLoop(void* udev_event_handler_ptr) {
   return nullptr;
 }
 
+void UdevEventHandler::WakeUpMonitorLoop() {
+  uint64_t value = 1;
+  if (write(wakeup_fd_, &value, sizeof(value)) != sizeof(value)) {
+    LOG(ERROR) << "Failed to wake up the udev monitor loop: "
+               << strerror(errno);
+  }
+}
+
 void UdevEventHandler::UdevMonitorLoop() {
+  struct epoll_event events[kMaxEpollEvents];
   while (true) {
+    int timeout_ms;
     {
       // Check if the thread should stop.
       absl::MutexLock lock(&udev_lock_);
       if (!udev_monitor_loop_running_) break;
+      timeout_ms =
+          num_polled_udev_monitors_ > 0 ? FLAGS_udev_polling_interval_ms : -1;
+    }
+    int num_events = epoll_wait(epoll_fd_, events, kMaxEpollEvents, timeout_ms);
+    if (num_events < 0) {
+      if (errno == EINTR) continue;
+      LOG(ERROR) << "epoll_wait failed: " << strerror(errno);
+      usleep(FLAGS_udev_polling_interval_ms * 1000);
+      continue;
+    }
+    for (int i = 0; i < num_events; ++i) {
+      // Reset the wakeup eventfd. The udev monitors are drained below.
+      uint64_t value;
+      if (events[i].data.fd == wakeup_fd_ &&
+          read(wakeup_fd_, &value, sizeof(value)) < 0 && errno != EAGAIN) {
+        LOG(ERROR) << "Failed to read the wakeup eventfd: " << strerror(errno);
+      }
     }
-    usleep(FLAGS_udev_polling_interval_ms * 1000);
     ::util::Status poll_status = PollUdevMonitors();
     if (!poll_status.ok()) {
       LOG(ERROR) << "PollUdevMonitors failed: " << poll_status.error_message();
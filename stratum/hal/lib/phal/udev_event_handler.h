@@ -89,7 +89,10 @@ class UdevEventHandler {
 
  protected:
   explicit UdevEventHandler(const SystemInterface* system_interface)
-      : system_interface_(system_interface), udev_monitor_loop_thread_id_() {}
+      : system_interface_(system_interface),
+        epoll_fd_(-1),
+        wakeup_fd_(-1),
+        udev_monitor_loop_thread_id_() {}
 
  private:
   friend class UdevEventHandlerTest;
@@ -106,6 +109,9 @@ class UdevEventHandler {
     // dev_path_to_callback, the callback will be called.
     absl::flat_hash_set<std::string> dev_paths_to_update;
   };
+  // Maximum number of ready file descriptors handled per epoll_wait call.
+  static constexpr int kMaxEpollEvents = 16;
+
   // Initializes everything necessary to listen for udev events.
   ::util::Status InitializeUdev();
   // Initializes and starts the thread that monitors udev events.
@@ -125,8 +131,12 @@ class UdevEventHandler {
   // This is a helper function for pthread_create.
   static void* RunUdevMonitorLoop(void* udev_event_handler_ptr);
   // Runs the main udev monitor loop. Does not return until
-  // udev_monitor_loop_running_ is set to false.
+  // udev_monitor_loop_running_ is set to false. The loop blocks until one of
+  // the udev monitors has an event or wakeup_fd_ is signaled. Monitors without
+  // a file descriptor are polled every FLAGS_udev_polling_interval_ms.
   void UdevMonitorLoop() LOCKS_EXCLUDED(udev_lock_);
+  // Makes the udev monitor loop run a pass without waiting for an event.
+  void WakeUpMonitorLoop();
   // Searches for an event that has occurred and requires a callback. If no such
   // event is found, returns false. Otherwise, returns true and sets
   // callback_to_execute and action_to_send to the values appropriate for this
@@ -152,6 +162,13 @@ class UdevEventHandler {
   // the one that is currently executing.
   UdevEventCallback* executing_callback_ GUARDED_BY(udev_lock_) = nullptr;
   bool udev_monitor_loop_running_ GUARDED_BY(udev_lock_) = false;
+  // Number of udev monitors that have no file descriptor to wait on.
+  int num_polled_udev_monitors_ GUARDED_BY(udev_lock_) = 0;
+  // The epoll instance waiting on the udev monitors and wakeup_fd_.
+  int epoll_fd_;
+  // An eventfd signaled to wake the udev monitor loop up, e.g. when a callback
+  // is registered or the handler is destroyed.
+  int wakeup_fd_;
   pthread_t udev_monitor_loop_thread_id_;
 };
 
@@ -6,6 +6,9 @@
 
 #include "absl/memory/memory.h"
 #include "absl/synchronization/mutex.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
+#include "gflags/gflags.h"
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
 #include "stratum/glue/status/status.h"
@@ -16,6 +19,8 @@
 #include "stratum/lib/macros.h"
 #include "stratum/lib/test_utils/matchers.h"
 
+DECLARE_int32(udev_polling_interval_ms);
+
 namespace stratum {
 namespace hal {
 namespace phal {
@@ -237,6 +242,51 @@ TEST_F(UdevEventHandlerTest, CallbackCanDeleteAnotherCallback) {
   EXPECT_OK(RunMonitorLoop());
 }
 
+TEST(UdevEventHandlerLoopTest, EventsAreHandledWithoutPolling) {
+  // No callback can be sent late by waiting for a poll that never comes.
+  const int polling_interval_ms = FLAGS_udev_polling_interval_ms;
+  FLAGS_udev_polling_interval_ms = 3600 * 1000;
+  SystemFake system_fake;
+  auto handler_or = UdevEventHandler::MakeUdevEventHandler(&system_fake);
+  ASSERT_TRUE(handler_or.ok());
+  auto handler = handler_or.ConsumeValueOrDie();
+
+  absl::Mutex event_lock;
+  absl::CondVar event_cond_var;
+  std::vector<std::string> actions;
+  UdevEventCallbackMock callback("foo", "bar");
+  EXPECT_CALL(callback, HandleUdevEvent(_))
+      .WillRepeatedly(Invoke([&](std::string action) -> ::util::Status {
+        absl::MutexLock lock(&event_lock);
+        actions.push_back(action);
+        event_cond_var.Signal();
+        return ::util::OkStatus();
+      }));
+  // Waits for the given number of callbacks, returns false on timeout.
+  auto wait_for_actions = [&](size_t num_actions) {
+    absl::MutexLock lock(&event_lock);
+    absl::Time deadline = absl::Now() + absl::Seconds(10);
+    while (actions.size() < num_actions) {
+      if (event_cond_var.WaitWithDeadline(&event_lock, deadline)) break;
+    }
+    return actions.size() == num_actions;
+  };
+
+  // The initial callback is sent when the callback is registered.
+  ASSERT_OK(handler->RegisterEventCallback(&callback));
+  ASSERT_TRUE(wait_for_actions(1));
+  system_fake.SendUdevUpdate("foo", "bar", 1, "add", true);
+  ASSERT_TRUE(wait_for_actions(2));
+  {
+    absl::MutexLock lock(&event_lock);
+    EXPECT_EQ("remove", actions[0]);
+    EXPECT_EQ("add", actions[1]);
+  }
+  EXPECT_OK(handler->UnregisterEventCallback(&callback));
+  handler.reset();
+  FLAGS_udev_polling_interval_ms = polling_interval_ms;
+}
+
 class ConcurrentUdevEventHandlerTest : public ::testing::Test {
  public:
   void SetUp() override {
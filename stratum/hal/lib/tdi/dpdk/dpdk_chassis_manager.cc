@@ -4,19 +4,25 @@
 
 #include "stratum/hal/lib/tdi/dpdk/dpdk_chassis_manager.h"
 
+#include <algorithm>
+#include <atomic>
 #include <map>
 #include <memory>
 #include <ostream>
 #include <set>
 #include <string>
+#include <thread>  // NOLINT
 #include <utility>
+#include <vector>
 
 #include "absl/base/attributes.h"
 #include "absl/base/const_init.h"
 #include "absl/memory/memory.h"
 #include "absl/synchronization/mutex.h"
+#include "absl/time/clock.h"
 #include "absl/time/time.h"
 #include "absl/types/optional.h"
+#include "gflags/gflags.h"
 #include "stratum/glue/gtl/map_util.h"
 #include "stratum/glue/integral_types.h"
 #include "stratum/glue/logging.h"
@@ -33,6 +39,11 @@
 #include "stratum/lib/macros.h"
 #include "stratum/public/proto/error.pb.h"
 
+DEFINE_int32(dpdk_port_add_threads, 1,
+             "Maximum number of ports added concurrently by a bulk port "
+             "provisioning request. The SDE must support adding ports from "
+             "several threads for values above 1.");
+
 namespace stratum {
 namespace hal {
 namespace tdi {
@@ -93,6 +104,16 @@ bool IsConfigComplete(const DpdkPortConfig& config) {
   return false;
 }
 
+// Determines whether a new port comes with all the parameters required to
+// add it. Ports which don't are left to SetPortParam().
+bool HasCompleteConfig(const SingletonPort& singleton_port) {
+  if (singleton_port.config_params().port_type() == PORT_TYPE_NONE) {
+    return false;
+  }
+  DpdkPortConfig config;
+  return config.SetParams(singleton_port).ok() && IsConfigComplete(config);
+}
+
 void SupplyDefaultParams(DpdkPortConfig& config) {
   if (!config.HasAnyOf(GNMI_CONFIG_PIPELINE_NAME)) {
     config.cfg.pipeline_name = DEFAULT_PIPELINE;
@@ -223,6 +244,140 @@ bool DpdkChassisManager::IsPortParamSet(
   return ::util::OkStatus();
 }
 
+::util::Status DpdkChassisManager::ValidatePortToAdd(
+    uint64 node_id, const SingletonPort& singleton_port,
+    DpdkPortConfig* config) {
+  const uint32 port_id = singleton_port.id();
+  const auto* port_id_to_port_config =
+      gtl::FindOrNull(node_id_to_port_id_to_port_config_, node_id);
+  const auto* existing_config =
+      port_id_to_port_config == nullptr
+          ? nullptr
+          : gtl::FindOrNull(*port_id_to_port_config, port_id);
+  if (existing_config != nullptr && existing_config->port_done) {
+    return MAKE_ERROR(ERR_ENTRY_EXISTS)
+           << "Port " << port_id << " in node " << node_id
+           << " has already been added.";
+  }
+  RETURN_IF_ERROR(config->SetParams(singleton_port));
+  if (!config->HasAnyOf(GNMI_CONFIG_PORT_TYPE) || !IsConfigComplete(*config)) {
+    return MAKE_ERROR(ERR_INVALID_PARAM)
+           << "Missing required parameters for port " << port_id
+           << " in node " << node_id << ".";
+  }
+  SupplyDefaultParams(*config);
+  if (HasUnsupportedParams(*config)) {
+    return MAKE_ERROR(ERR_INVALID_PARAM)
+           << "Unsupported parameter list for given Port Type of port "
+           << port_id << " in node " << node_id << ".";
+  }
+  return ::util::OkStatus();
+}
+
+::util::Status DpdkChassisManager::AddPorts(
+    uint64 node_id, const std::vector<SingletonPort>& singleton_ports,
+    std::vector<::util::Status>* results) {
+  RET_CHECK(results != nullptr);
+  results->assign(singleton_ports.size(), ::util::OkStatus());
+  const int* device = gtl::FindOrNull(node_id_to_device_, node_id);
+  if (device == nullptr) {
+    return MAKE_ERROR(ERR_INVALID_PARAM) << "Unknown node " << node_id << ".";
+  }
+  const auto& port_id_to_sdk_port_id =
+      node_id_to_port_id_to_sdk_port_id_[node_id];
+
+  // Validate all the ports first, including against each other, so that a
+  // bad request does not leave half of its ports added.
+  struct PortToAdd {
+    size_t index;
+    uint32 sdk_port_id;
+    DpdkPortConfig config;
+  };
+  std::vector<PortToAdd> ports_to_add;
+  std::set<uint32> port_ids;
+  std::set<std::string> port_names;
+  std::set<std::string> socket_paths;
+  for (size_t i = 0; i < singleton_ports.size(); ++i) {
+    const SingletonPort& singleton_port = singleton_ports[i];
+    const uint32 port_id = singleton_port.id();
+    const uint32* sdk_port_id =
+        gtl::FindOrNull(port_id_to_sdk_port_id, port_id);
+    PortToAdd port_to_add = {i, 0, DpdkPortConfig()};
+    ::util::Status status;
+    if (sdk_port_id == nullptr) {
+      status = MAKE_ERROR(ERR_INVALID_PARAM)
+               << "Unknown port " << port_id << " in node " << node_id << ".";
+    } else if (!port_ids.insert(port_id).second) {
+      status = MAKE_ERROR(ERR_INVALID_PARAM)
+               << "Port " << port_id << " is given more than once.";
+    } else if (!singleton_port.name().empty() &&
+               !port_names.insert(singleton_port.name()).second) {
+      status = MAKE_ERROR(ERR_INVALID_PARAM)
+               << "Port name " << singleton_port.name()
+               << " is given more than once.";
+    } else {
+      status =
+          ValidatePortToAdd(node_id, singleton_port, &port_to_add.config);
+    }
+    const std::string& socket_path = port_to_add.config.cfg.socket_path;
+    if (status.ok() && !socket_path.empty() &&
+        !socket_paths.insert(socket_path).second) {
+      status = MAKE_ERROR(ERR_INVALID_PARAM)
+               << "Socket path " << socket_path << " of port " << port_id
+               << " is given more than once.";
+    }
+    if (!status.ok()) {
+      (*results)[i] = status;
+      continue;
+    }
+    port_to_add.sdk_port_id = *sdk_port_id;
+    ports_to_add.push_back(std::move(port_to_add));
+  }
+
+  // Add the valid ports. The ports are independent of each other, so they
+  // are added by a few threads taking the next port in turn.
+  const int num_threads = std::max(
+      1, std::min<int>(FLAGS_dpdk_port_add_threads, ports_to_add.size()));
+  std::atomic<size_t> next_port(0);
+  auto add_ports = [&]() {
+    for (size_t j = next_port++; j < ports_to_add.size(); j = next_port++) {
+      PortToAdd& port_to_add = ports_to_add[j];
+      (*results)[port_to_add.index] =
+          AddPortHelper(node_id, *device, port_to_add.sdk_port_id,
+                        singleton_ports[port_to_add.index],
+                        &port_to_add.config);
+    }
+  };
+  absl::Time start_time = absl::Now();
+  std::vector<std::thread> threads;
+  for (int i = 1; i < num_threads; ++i) threads.emplace_back(add_ports);
+  add_ports();
+  for (auto& thread : threads) thread.join();
+
+  auto& port_id_to_port_config = node_id_to_port_id_to_port_config_[node_id];
+  for (auto& port_to_add : ports_to_add) {
+    if (!(*results)[port_to_add.index].ok()) continue;
+    port_to_add.config.port_done = true;
+    port_id_to_port_config[singleton_ports[port_to_add.index].id()] =
+        port_to_add.config;
+  }
+  int num_failed = 0;
+  for (const auto& status : *results) {
+    if (!status.ok()) ++num_failed;
+  }
+  LOG(INFO) << "Added " << singleton_ports.size() - num_failed << " of "
+            << singleton_ports.size() << " ports in node " << node_id
+            << " in " << absl::FormatDuration(absl::Now() - start_time)
+            << " with " << num_threads << " threads.";
+  if (num_failed > 0) {
+    return MAKE_ERROR(ERR_AT_LEAST_ONE_OPER_FAILED)
+           << "Failed to add " << num_failed << " of "
+           << singleton_ports.size() << " ports in node " << node_id << ".";
+  }
+
+  return ::util::OkStatus();
+}
+
 ::util::Status DpdkChassisManager::AddPortHelper(
     uint64 node_id, int device, uint32 sdk_port_id,
     const SingletonPort& singleton_port /* desired config */,
@@ -407,6 +562,9 @@ bool DpdkChassisManager::IsPortParamSet(
     PortKey port_group_key(singleton_port.slot(), singleton_port.port());
   }
 
+  // New ports given with their configuration parameters, added once the new
+  // config is in place.
+  std::map<uint64, std::vector<SingletonPort>> node_id_to_new_ports;
   for (const auto& singleton_port : config.singleton_ports()) {
     uint32 port_id = singleton_port.id();
     uint64 node_id = singleton_port.node();
@@ -427,12 +585,11 @@ bool DpdkChassisManager::IsPortParamSet(
     auto& config = node_id_to_port_id_to_port_config[node_id][port_id];
     uint32 sdk_port_id = node_id_to_port_id_to_sdk_port_id[node_id][port_id];
     if (config_old == nullptr) {
-      // new port
-      // if anything fails, config.admin_state will be set to
-      // ADMIN_STATE_UNKNOWN (invalid)
-      // RETURN_IF_ERROR(
-      //    AddPortHelper(node_id, device, sdk_port_id, singleton_port,
-      //    &config));
+      // new port. Ports without all their required parameters are
+      // configured later, one parameter at a time with SetPortParam().
+      if (HasCompleteConfig(singleton_port)) {
+        node_id_to_new_ports[node_id].push_back(singleton_port);
+      }
       continue;
     } else {
       // port already exists, config may have changed
@@ -486,7 +643,27 @@ bool DpdkChassisManager::IsPortParamSet(
   node_id_to_sdk_port_id_to_port_id_ = node_id_to_sdk_port_id_to_port_id;
   initialized_ = true;
 
-  return ::util::OkStatus();
+  // Add the new ports of each node in one batch. A port which fails is left
+  // unconfigured, it can still be configured with SetPortParam(). The error
+  // returned lists every port which failed.
+  ::util::Status status = ::util::OkStatus();
+  for (const auto& e : node_id_to_new_ports) {
+    std::vector<::util::Status> results;
+    ::util::Status node_status = AddPorts(e.first, e.second, &results);
+    if (node_status.ok()) continue;
+    for (size_t i = 0; i < results.size(); ++i) {
+      if (results[i].ok()) continue;
+      ::util::Status port_status =
+          MAKE_ERROR(static_cast<ErrorCode>(results[i].error_code()))
+              .without_logging()
+          << "Port " << e.second[i].id() << ": "
+          << results[i].error_message();
+      APPEND_STATUS_IF_ERROR(node_status, port_status);
+    }
+    APPEND_STATUS_IF_ERROR(status, node_status);
+  }
+
+  return status;
 }
 
 ::util::Status DpdkChassisManager::VerifyChassisConfig(
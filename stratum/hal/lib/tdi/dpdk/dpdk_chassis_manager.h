@@ -7,6 +7,7 @@
 
 #include <map>
 #include <memory>
+#include <vector>
 
 #include "absl/base/thread_annotations.h"
 #include "absl/synchronization/mutex.h"
@@ -90,6 +91,18 @@ class DpdkChassisManager {
                                  const SingletonPort& singleton_port,
                                  DpdkHotplugParam param_type);
 
+  // Adds a batch of ports to a node, each given with all its configuration
+  // parameters, instead of one parameter at a time with SetPortParam(). Used
+  // by PushChassisConfig() for the new ports with a complete configuration,
+  // and by DpdkSwitch::AddPorts() for bulk requests. All the ports
+  // are validated before any is added, and the valid ones are added
+  // concurrently. 'results' gets one status per port, in order. Returns
+  // ERR_AT_LEAST_ONE_OPER_FAILED if any port could not be added.
+  ::util::Status AddPorts(uint64 node_id,
+                          const std::vector<SingletonPort>& singleton_ports,
+                          std::vector<::util::Status>* results)
+      EXCLUSIVE_LOCKS_REQUIRED(chassis_lock);
+
   // DpdkChassisManager is neither copyable nor movable.
   DpdkChassisManager(const DpdkChassisManager&) = delete;
   DpdkChassisManager& operator=(const DpdkChassisManager&) = delete;
@@ -143,6 +156,12 @@ class DpdkChassisManager {
                                const SingletonPort& singleton_port,
                                DpdkPortConfig* config);
 
+  // Validates a port given to AddPorts() and fills its configuration.
+  ::util::Status ValidatePortToAdd(uint64 node_id,
+                                   const SingletonPort& singleton_port,
+                                   DpdkPortConfig* config)
+      SHARED_LOCKS_REQUIRED(chassis_lock);
+
   // helper to hotplug add / delete a port with DpdkPortManager
   ::util::Status HotplugPortHelper(uint64 node_id, int device, uint32 port_id,
                                    const SingletonPort& singleton_port,
@@ -8,11 +8,13 @@
 
 #include <string>
 #include <utility>
+#include <vector>
 
 #include "absl/strings/match.h"
 #include "absl/synchronization/notification.h"
 #include "absl/time/clock.h"
 #include "absl/time/time.h"
+#include "gflags/gflags.h"
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
 #include "stratum/glue/integral_types.h"
@@ -27,6 +29,8 @@
 #include "stratum/lib/test_utils/matchers.h"
 #include "stratum/lib/utils.h"
 
+DECLARE_int32(dpdk_port_add_threads);
+
 #undef IPU_ADD_NEW_PORT
 
 #if !defined(IPU_ADD_NEW_PORT)
@@ -56,6 +60,7 @@ using ::testing::Invoke;
 using ::testing::Matcher;
 using ::testing::Mock;
 using ::testing::NiceMock;
+using ::testing::Not;
 using ::testing::Return;
 using ::testing::SaveArg;
 using ::testing::SetArgPointee;
@@ -213,6 +218,12 @@ class DpdkChassisManagerTest : public ::testing::Test {
     return ::util::OkStatus();
   }
 
+  ::util::Status AddPorts(const std::vector<SingletonPort>& singleton_ports,
+                          std::vector<::util::Status>* results) {
+    absl::WriterMutexLock l(&chassis_lock);
+    return chassis_manager_->AddPorts(kNodeId, singleton_ports, results);
+  }
+
   ::util::Status ReplayChassisConfig(uint64 node_id) {
     absl::WriterMutexLock l(&chassis_lock);
     return chassis_manager_->ReplayChassisConfig(node_id);
@@ -323,6 +334,121 @@ TEST_F(DpdkChassisManagerTest, SetPortParam) {
                   .ok());
 }
 
+// Sets the parameters of a vhost port to be added.
+void SetVhostPortParams(int i, SingletonPort* sport) {
+  sport->set_name("vhost" + std::to_string(i));
+  PortConfigParams* config_params = sport->mutable_config_params();
+  config_params->set_port_type(PORT_TYPE_VHOST);
+  config_params->set_device_type(DEVICE_TYPE_VIRTIO_NET);
+  config_params->set_queues(2);
+  config_params->set_socket_path("/socket/to/vhost" + std::to_string(i));
+  config_params->set_host_name("host" + std::to_string(i));
+}
+
+TEST_F(DpdkChassisManagerTest, AddPorts) {
+  ChassisConfigBuilder builder;
+  std::vector<SingletonPort> sports;
+  for (int i = 1; i <= 5; ++i) {
+    auto* sport = builder.AddPort(kPortId + i, kPort + i, ADMIN_STATE_ENABLED);
+    RegisterSdkPortId(sport);
+    sports.push_back(*sport);
+    SetVhostPortParams(i, &sports.back());
+  }
+  ASSERT_OK(PushBaseChassisConfig(&builder));
+
+  // Port 2 misses a required parameter, port 3 reuses the socket of port 1,
+  // port 5 is unknown and the SDE fails to add port 4.
+  sports[1].mutable_config_params()->clear_host_name();
+  sports[2].mutable_config_params()->set_socket_path("/socket/to/vhost1");
+  sports[4].set_id(kPortId + 100);
+  const ::util::Status error(StratumErrorSpace(), ERR_INTERNAL, "SDE error");
+  EXPECT_CALL(*port_manager_, AddPort(kDevice, kDefaultPortId + 1, _))
+      .WillOnce(Return(::util::OkStatus()));
+  EXPECT_CALL(*port_manager_, AddPort(kDevice, kDefaultPortId + 4, _))
+      .WillOnce(Return(error));
+
+  FLAGS_dpdk_port_add_threads = 4;
+  std::vector<::util::Status> results;
+  ::util::Status status = AddPorts(sports, &results);
+  FLAGS_dpdk_port_add_threads = 1;
+  EXPECT_EQ(ERR_AT_LEAST_ONE_OPER_FAILED, status.error_code());
+  ASSERT_EQ(5, results.size());
+  EXPECT_OK(results[0]);
+  EXPECT_EQ(ERR_INVALID_PARAM, results[1].error_code());
+  EXPECT_EQ(ERR_INVALID_PARAM, results[2].error_code());
+  EXPECT_EQ(error, results[3]);
+  EXPECT_EQ(ERR_INVALID_PARAM, results[4].error_code());
+
+  // Only the added port is done and can't be added again.
+  EXPECT_CALL(*port_manager_, AddPort(kDevice, kDefaultPortId + 4, _))
+      .WillOnce(Return(::util::OkStatus()));
+  status = AddPorts({sports[0], sports[3]}, &results);
+  EXPECT_EQ(ERR_AT_LEAST_ONE_OPER_FAILED, status.error_code());
+  ASSERT_EQ(2, results.size());
+  EXPECT_EQ(ERR_ENTRY_EXISTS, results[0].error_code());
+  EXPECT_OK(results[1]);
+
+  ASSERT_OK(ShutdownAndTestCleanState());
+}
+
+TEST_F(DpdkChassisManagerTest, PushChassisConfigAddsConfiguredPorts) {
+  // Ports 1 and 2 come with their parameters and are added by the push, port
+  // 3 is left to SetPortParam() and the SDE fails to add port 2.
+  ChassisConfigBuilder builder;
+  for (int i = 1; i <= 3; ++i) {
+    auto* sport = builder.AddPort(kPortId + i, kPort + i, ADMIN_STATE_ENABLED);
+    RegisterSdkPortId(sport);
+    if (i < 3) SetVhostPortParams(i, sport);
+  }
+  const ::util::Status error(StratumErrorSpace(), ERR_INTERNAL, "SDE error");
+  EXPECT_CALL(*port_manager_, AddPort(kDevice, kDefaultPortId + 1, _))
+      .WillOnce(Return(::util::OkStatus()));
+  EXPECT_CALL(*port_manager_, AddPort(kDevice, kDefaultPortId + 2, _))
+      .WillOnce(Return(error));
+  ::util::Status status = PushBaseChassisConfig(&builder);
+  EXPECT_EQ(ERR_AT_LEAST_ONE_OPER_FAILED, status.error_code());
+  EXPECT_THAT(status.error_message(),
+              HasSubstr("Port " + std::to_string(kPortId + 2) + ": SDE error"));
+  EXPECT_THAT(status.error_message(),
+              Not(HasSubstr("Port " + std::to_string(kPortId + 1))));
+  EXPECT_TRUE(Initialized());
+
+  // Only the added port is done.
+  std::vector<::util::Status> results;
+  EXPECT_EQ(ERR_AT_LEAST_ONE_OPER_FAILED,
+            AddPorts({*builder.GetPort(kPortId + 1)}, &results).error_code());
+  ASSERT_EQ(1, results.size());
+  EXPECT_EQ(ERR_ENTRY_EXISTS, results[0].error_code());
+
+  ASSERT_OK(ShutdownAndTestCleanState());
+}
+
+TEST_F(DpdkChassisManagerTest, PushChassisConfigLeavesIncompletePorts) {
+  // The port comes with a port type, but its host name is set later.
+  ChassisConfigBuilder builder;
+  auto* sport = builder.AddPort(kPortId + 1, kPort + 1, ADMIN_STATE_ENABLED);
+  RegisterSdkPortId(sport);
+  SetVhostPortParams(1, sport);
+  sport->mutable_config_params()->clear_host_name();
+  EXPECT_CALL(*port_manager_, AddPort(kDevice, kDefaultPortId + 1, _))
+      .Times(0);
+  ASSERT_OK(PushBaseChassisConfig(&builder));
+
+  // The port is added once its last required parameter is set.
+  for (auto value_case : {ValueCase::kPortType, ValueCase::kDeviceType,
+                          ValueCase::kQueueCount, ValueCase::kSockPath}) {
+    ASSERT_OK(chassis_manager_->SetPortParam(kNodeId, kPortId + 1, *sport,
+                                             value_case));
+  }
+  EXPECT_CALL(*port_manager_, AddPort(kDevice, kDefaultPortId + 1, _))
+      .WillOnce(Return(::util::OkStatus()));
+  sport->mutable_config_params()->set_host_name("host1");
+  ASSERT_OK(chassis_manager_->SetPortParam(kNodeId, kPortId + 1, *sport,
+                                           ValueCase::kHostConfig));
+
+  ASSERT_OK(ShutdownAndTestCleanState());
+}
+
 TEST_F(DpdkChassisManagerTest, SetHotplugParam) {
   SingletonPort sport;
   PortConfigParams* config_params = sport.mutable_config_params();
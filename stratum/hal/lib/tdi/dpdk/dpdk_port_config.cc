@@ -5,6 +5,7 @@
 
 #include <cstdint>
 #include <ostream>
+#include <vector>
 
 #include "glog/logging.h"
 #include "stratum/glue/status/status.h"
@@ -130,6 +131,48 @@ uint32_t DpdkPortConfig::ParamMaskForCase(ValueCase value_case) {
   return ::util::OkStatus();
 }
 
+::util::Status DpdkPortConfig::SetParams(const SingletonPort& singleton_port) {
+  const auto& config_params = singleton_port.config_params();
+  std::vector<ValueCase> value_cases;
+  if (config_params.port_type() != PORT_TYPE_NONE) {
+    value_cases.push_back(ValueCase::kPortType);
+  }
+  if (config_params.device_type() != DEVICE_TYPE_NONE) {
+    value_cases.push_back(ValueCase::kDeviceType);
+  }
+  if (config_params.queues() != 0) {
+    value_cases.push_back(ValueCase::kQueueCount);
+  }
+  if (!config_params.socket_path().empty()) {
+    value_cases.push_back(ValueCase::kSockPath);
+  }
+  if (!config_params.host_name().empty()) {
+    value_cases.push_back(ValueCase::kHostConfig);
+  }
+  if (!config_params.pipeline_name().empty()) {
+    value_cases.push_back(ValueCase::kPipelineName);
+  }
+  if (!config_params.mempool_name().empty()) {
+    value_cases.push_back(ValueCase::kMempoolName);
+  }
+  if (!config_params.control_port().empty()) {
+    value_cases.push_back(ValueCase::kControlPort);
+  }
+  if (!config_params.pci_bdf().empty()) {
+    value_cases.push_back(ValueCase::kPciBdf);
+  }
+  if (config_params.mtu() != 0) {
+    value_cases.push_back(ValueCase::kMtuValue);
+  }
+  if (config_params.packet_dir() != DEFAULT_PACKET_DIR) {
+    value_cases.push_back(ValueCase::kPacketDir);
+  }
+  for (const auto value_case : value_cases) {
+    RETURN_IF_ERROR(SetParam(value_case, singleton_port));
+  }
+  return ::util::OkStatus();
+}
+
 ::util::Status DpdkPortConfig::SetHotplugParam(
     DpdkHotplugParam param_type, const SingletonPort& singleton_port) {
   const auto& params = singleton_port.config_params().hotplug_config();
@@ -49,6 +49,10 @@ class DpdkPortConfig {
   ::util::Status SetParam(ValueCase value_case,
                           const SingletonPort& singleton_port);
 
+  // Stores all the parameters given in the SingletonPort at once. Parameters
+  // left to their default (zero) value are considered not given.
+  ::util::Status SetParams(const SingletonPort& singleton_port);
+
   // Stores the specified hotplug parameter.
   ::util::Status SetHotplugParam(DpdkHotplugParam param_type,
                                  const SingletonPort& singleton_port);
@@ -11,11 +11,16 @@
 #include <string.h>
 
 #include <algorithm>
+#include <iterator>
 #include <memory>
 #include <ostream>
+#include <set>
 #include <string>
 #include <utility>
 
+#include "absl/base/attributes.h"
+#include "absl/base/const_init.h"
+#include "absl/base/thread_annotations.h"
 #include "absl/synchronization/mutex.h"
 #include "stratum/glue/integral_types.h"
 #include "stratum/glue/logging.h"
@@ -37,6 +42,43 @@ namespace tdi {
 
 DpdkPortManager* DpdkPortManager::singleton_ = nullptr;
 
+namespace {
+
+// Protects the pipeline port IDs assigned to the new ports, as ports may be
+// added from several threads.
+ABSL_CONST_INIT absl::Mutex port_id_lock(absl::kConstInit);
+
+// The pipeline port IDs are assigned in order, the same ID is used as the
+// input and the output port ID of a port. The DPDK pipeline expects the IDs of
+// its ports to be contiguous, so the ID of a port which failed to be added is
+// given to the next port instead of leaving a gap.
+int next_port_id GUARDED_BY(port_id_lock) = 0;
+std::set<int>* released_port_ids GUARDED_BY(port_id_lock) = nullptr;
+
+int AllocatePortId() LOCKS_EXCLUDED(port_id_lock) {
+  absl::MutexLock l(&port_id_lock);
+  if (released_port_ids != nullptr && !released_port_ids->empty()) {
+    int port_id = *released_port_ids->begin();
+    released_port_ids->erase(released_port_ids->begin());
+    return port_id;
+  }
+  return next_port_id++;
+}
+
+void ReleasePortId(int port_id) LOCKS_EXCLUDED(port_id_lock) {
+  absl::MutexLock l(&port_id_lock);
+  if (released_port_ids == nullptr) released_port_ids = new std::set<int>();
+  released_port_ids->insert(port_id);
+  // Shrink the range if its last IDs are not used.
+  while (!released_port_ids->empty() &&
+         *released_port_ids->rbegin() == next_port_id - 1) {
+    released_port_ids->erase(std::prev(released_port_ids->end()));
+    next_port_id--;
+  }
+}
+
+}  // namespace
+
 DpdkPortManager* DpdkPortManager::CreateSingleton() {
   absl::WriterMutexLock l(&init_lock_);
   if (!singleton_) {
@@ -177,9 +219,6 @@ dpdk_port_type_t get_target_port_type(DpdkPortType type) {
 
 ::util::Status DpdkPortManager::AddPort(int device, int port,
                                         const PortConfigParams& config) {
-  static int port_in;
-  static int port_out;
-
   auto port_attrs = absl::make_unique<port_attributes_t>();
   strncpy(port_attrs->port_name, config.port_name.c_str(),
           sizeof(port_attrs->port_name));
@@ -191,8 +230,9 @@ dpdk_port_type_t get_target_port_type(DpdkPortType type) {
           sizeof(port_attrs->mempool_name));
   port_attrs->port_type = get_target_port_type(config.port_type);
   port_attrs->port_dir = PM_PORT_DIR_DEFAULT;
-  port_attrs->port_in_id = port_in++;
-  port_attrs->port_out_id = port_out++;
+  const int port_id = AllocatePortId();
+  port_attrs->port_in_id = port_id;
+  port_attrs->port_out_id = port_id;
   port_attrs->net_port = config.packet_dir;
 
   LOG(INFO) << "Parameters for DPDK are:"
@@ -230,9 +270,8 @@ dpdk_port_type_t get_target_port_type(DpdkPortType type) {
       bf_pal_port_add(static_cast<bf_dev_id_t>(device),
                       static_cast<bf_dev_port_t>(port), port_attrs.get());
   if (bf_status != BF_SUCCESS) {
-    // Revert the port_in and port_out values
-    port_in--;
-    port_out--;
+    // Give the port_in and port_out values to the next port.
+    ReleasePortId(port_id);
     RETURN_IF_TDI_ERROR(bf_status);
   }
 
@@ -142,6 +142,7 @@ std::string DpdkSdeWrapper::GetSdeVersion() const {
   RET_CHECK(device_config.programs_size() > 0);
 
   tdi_id_mapper_.reset();
+  ClearHandleCache();
 
   RETURN_IF_TDI_ERROR(bf_pal_device_warm_init_begin(dev_id,
                                                     BF_DEV_WARM_INIT_FAST_RECFG,
@@ -210,6 +211,7 @@ std::string DpdkSdeWrapper::GetSdeVersion() const {
   tdi_id_mapper_ = TdiIdMapper::CreateInstance();
   RETURN_IF_ERROR(
       tdi_id_mapper_->PushForwardingPipelineConfig(device_config, tdi_info_));
+  RETURN_IF_ERROR(BuildHandleCache(dev_id));
 
   return ::util::OkStatus();
 }
@@ -258,6 +258,13 @@ bool DpdkSwitch::IsPortParamSet(
                                            param_type);
 }
 
+::util::Status DpdkSwitch::AddPorts(
+    uint64 node_id, const std::vector<SingletonPort>& singleton_ports,
+    std::vector<::util::Status>* results) {
+  absl::WriterMutexLock l(&chassis_lock);
+  return chassis_manager_->AddPorts(node_id, singleton_ports, results);
+}
+
 std::unique_ptr<DpdkSwitch> DpdkSwitch::CreateInstance(
     DpdkChassisManager* chassis_manager, TdiSdeInterface* sde_interface,
     const std::map<int, TdiNode*>& device_id_to_tdi_node) {
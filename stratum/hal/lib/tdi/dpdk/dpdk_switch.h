@@ -38,6 +38,10 @@ class PortParamInterface {
   virtual ::util::Status SetHotplugParam(uint64 node_id, uint32 port_id,
                                          const SingletonPort& singleton_port,
                                          DpdkHotplugParam param_type) = 0;
+
+  virtual ::util::Status AddPorts(
+      uint64 node_id, const std::vector<SingletonPort>& singleton_ports,
+      std::vector<::util::Status>* results) = 0;
 };
 
 class DpdkSwitch : virtual public SwitchInterface,
@@ -110,6 +114,13 @@ class DpdkSwitch : virtual public SwitchInterface,
                                  const SingletonPort& singleton_port,
                                  DpdkHotplugParam param_type) override;
 
+  // Adds a batch of fully configured ports with a single request, see
+  // DpdkChassisManager::AddPorts(). 'results' gets one status per port.
+  ::util::Status AddPorts(uint64 node_id,
+                          const std::vector<SingletonPort>& singleton_ports,
+                          std::vector<::util::Status>* results) override
+      LOCKS_EXCLUDED(chassis_lock);
+
   // Factory function for creating the instance of the class.
   static std::unique_ptr<DpdkSwitch> CreateInstance(
       DpdkChassisManager* chassis_manager, TdiSdeInterface* sde_interface,
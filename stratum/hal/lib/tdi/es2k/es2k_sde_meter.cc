@@ -29,8 +29,7 @@ using namespace stratum::hal::tdi::helpers;
   auto real_session = std::dynamic_pointer_cast<Session>(session);
   RET_CHECK(real_session);
 
-  const ::tdi::Table* table;
-  RETURN_IF_TDI_ERROR(tdi_info_->tableFromIdGet(table_id, &table));
+  ASSIGN_OR_RETURN(const ::tdi::Table* table, GetTable(table_id));
 
   std::unique_ptr<::tdi::TableKey> table_key;
   std::unique_ptr<::tdi::TableData> table_data;
@@ -69,10 +68,7 @@ using namespace stratum::hal::tdi::helpers;
 
   //    RETURN_IF_ERROR(SetPktModMeterConfig(config));
   // write code here of set config
-  const ::tdi::Device* device = nullptr;
-  ::tdi::DevMgr::getInstance().deviceGet(dev_id, &device);
-  std::unique_ptr<::tdi::Target> dev_tgt;
-  device->createTarget(&dev_tgt);
+  ASSIGN_OR_RETURN(const ::tdi::Target* dev_tgt, GetDeviceTarget(dev_id));
 
   const auto flags = ::tdi::Flags(0);
   if (meter_index) {
@@ -179,17 +175,13 @@ static ::util::Status GetMeterField(
   auto real_session = std::dynamic_pointer_cast<Session>(session);
   RET_CHECK(real_session);
 
-  const ::tdi::Table* table;
-  RETURN_IF_TDI_ERROR(tdi_info_->tableFromIdGet(table_id, &table));
+  ASSIGN_OR_RETURN(const ::tdi::Table* table, GetTable(table_id));
 
   std::unique_ptr<::tdi::TableKey> table_key;
   std::unique_ptr<::tdi::TableData> table_data;
   RETURN_IF_TDI_ERROR(table->keyAllocate(&table_key));
   RETURN_IF_TDI_ERROR(table->dataAllocate(&table_data));
-  const ::tdi::Device* device = nullptr;
-  ::tdi::DevMgr::getInstance().deviceGet(dev_id, &device);
-  std::unique_ptr<::tdi::Target> dev_tgt;
-  device->createTarget(&dev_tgt);
+  ASSIGN_OR_RETURN(const ::tdi::Target* dev_tgt, GetDeviceTarget(dev_id));
 
   const auto flags = ::tdi::Flags(0);
   RETURN_IF_ERROR(
@@ -224,14 +216,10 @@ static ::util::Status GetMeterField(
   auto real_session = std::dynamic_pointer_cast<Session>(session);
   RET_CHECK(real_session);
 
-  const ::tdi::Device* device = nullptr;
-  ::tdi::DevMgr::getInstance().deviceGet(dev_id, &device);
-  std::unique_ptr<::tdi::Target> dev_tgt;
-  device->createTarget(&dev_tgt);
+  ASSIGN_OR_RETURN(const ::tdi::Target* dev_tgt, GetDeviceTarget(dev_id));
 
   const auto flags = ::tdi::Flags(0);
-  const ::tdi::Table* table;
-  RETURN_IF_TDI_ERROR(tdi_info_->tableFromIdGet(table_id, &table));
+  ASSIGN_OR_RETURN(const ::tdi::Table* table, GetTable(table_id));
   std::vector<std::unique_ptr<::tdi::TableKey>> keys;
   std::vector<std::unique_ptr<::tdi::TableData>> datums;
 
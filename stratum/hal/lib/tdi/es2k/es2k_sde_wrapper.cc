@@ -134,6 +134,7 @@ std::string Es2kSdeWrapper::GetChipType(int device) const {
   RET_CHECK(device_config.programs_size() > 0);
 
   tdi_id_mapper_.reset();
+  ClearHandleCache();
 
   RETURN_IF_TDI_ERROR(
       ipu_pal_device_warm_init_begin(dev_id, TDI_DEV_WARM_INIT_FAST_RECFG,
@@ -216,6 +217,7 @@ std::string Es2kSdeWrapper::GetChipType(int device) const {
   tdi_id_mapper_ = TdiIdMapper::CreateInstance();
   RETURN_IF_ERROR(
       tdi_id_mapper_->PushForwardingPipelineConfig(device_config, tdi_info_));
+  RETURN_IF_ERROR(BuildHandleCache(dev_id));
 
   return ::util::OkStatus();
 }
@@ -0,0 +1,163 @@
+// Copyright 2024 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#include "stratum/hal/lib/tdi/tdi_counter_sync_scheduler.h"
+
+#include <utility>
+#include <vector>
+
+#include "absl/memory/memory.h"
+#include "absl/time/clock.h"
+#include "stratum/glue/logging.h"
+#include "stratum/glue/status/status_macros.h"
+#include "stratum/lib/macros.h"
+
+namespace stratum {
+namespace hal {
+namespace tdi {
+
+TdiCounterSyncScheduler::TdiCounterSyncScheduler(
+    TdiSdeInterface* tdi_sde_interface, int device)
+    : tdi_sde_interface_(ABSL_DIE_IF_NULL(tdi_sde_interface)),
+      device_(device) {}
+
+TdiCounterSyncScheduler::~TdiCounterSyncScheduler() { StopBackgroundSync(); }
+
+std::unique_ptr<TdiCounterSyncScheduler>
+TdiCounterSyncScheduler::CreateInstance(TdiSdeInterface* tdi_sde_interface,
+                                        int device) {
+  return absl::WrapUnique(
+      new TdiCounterSyncScheduler(tdi_sde_interface, device));
+}
+
+::util::Status TdiCounterSyncScheduler::SyncCounters(
+    std::shared_ptr<TdiSdeInterface::SessionInterface> session,
+    uint32 table_id, absl::Duration max_staleness, absl::Duration timeout) {
+  const absl::Time oldest_acceptable_sync = absl::Now() - max_staleness;
+  absl::MutexLock l(&lock_);
+  TableSyncState* state = &table_states_[table_id];
+  state->background = true;
+  // A failed sync is only reported to the requests that waited for it, later
+  // requests try again.
+  bool waited = false;
+  while (state->last_sync_time < oldest_acceptable_sync ||
+         (!state->last_status.ok() && !waited)) {
+    if (state->in_progress) {
+      // Coalesce with the sync in progress. If it started too early for this
+      // request, the loop starts or joins another one.
+      cond_var_.Wait(&lock_);
+      waited = true;
+      continue;
+    }
+    state->in_progress = true;
+    const uint64 reset_count = reset_count_;
+    const absl::Time sync_time = absl::Now();
+    lock_.Unlock();
+    ::util::Status status = tdi_sde_interface_->SynchronizeCounters(
+        device_, session, table_id, timeout);
+    lock_.Lock();
+    state->in_progress = false;
+    // Results of syncs started before a pipeline push are not reused.
+    if (reset_count == reset_count_) {
+      state->last_sync_time = sync_time;
+      state->last_status = status;
+    }
+    cond_var_.SignalAll();
+    return status;
+  }
+
+  return state->last_status;
+}
+
+void TdiCounterSyncScheduler::Reset() {
+  absl::MutexLock l(&lock_);
+  ++reset_count_;
+  for (auto& e : table_states_) {
+    e.second.background = false;
+    e.second.last_sync_time = absl::InfinitePast();
+    e.second.last_status = ::util::OkStatus();
+  }
+}
+
+::util::Status TdiCounterSyncScheduler::StartBackgroundSync(
+    absl::Duration interval, absl::Duration timeout) {
+  absl::MutexLock l(&lock_);
+  RET_CHECK(interval > absl::ZeroDuration())
+      << "Invalid counter sync interval " << interval << ".";
+  if (background_thread_running_) return ::util::OkStatus();
+  background_interval_ = interval;
+  background_timeout_ = timeout;
+  background_thread_running_ = true;
+  if (pthread_create(&background_thread_id_, nullptr,
+                     &TdiCounterSyncScheduler::BackgroundSyncThreadFunc,
+                     this)) {
+    background_thread_running_ = false;
+    return MAKE_ERROR(ERR_INTERNAL)
+           << "Failed to create the counter sync thread.";
+  }
+  LOG(INFO) << "Syncing the direct counters of device " << device_
+            << " every " << interval << ".";
+
+  return ::util::OkStatus();
+}
+
+void TdiCounterSyncScheduler::StopBackgroundSync() {
+  bool running = false;
+  {
+    absl::MutexLock l(&lock_);
+    std::swap(running, background_thread_running_);
+    cond_var_.SignalAll();
+  }
+  if (running) pthread_join(background_thread_id_, nullptr);
+}
+
+void* TdiCounterSyncScheduler::BackgroundSyncThreadFunc(void* self) {
+  static_cast<TdiCounterSyncScheduler*>(self)->RunBackgroundSync();
+  return nullptr;
+}
+
+void TdiCounterSyncScheduler::RunBackgroundSync() {
+  std::shared_ptr<TdiSdeInterface::SessionInterface> session;
+  absl::MutexLock l(&lock_);
+  absl::Time next_sync_time = absl::Now() + background_interval_;
+  while (background_thread_running_) {
+    // The condition variable is also signalled by completed on-demand syncs.
+    if (absl::Now() < next_sync_time) {
+      cond_var_.WaitWithDeadline(&lock_, next_sync_time);
+      continue;
+    }
+    next_sync_time = absl::Now() + background_interval_;
+    std::vector<uint32> table_ids;
+    for (const auto& e : table_states_) {
+      if (e.second.background) table_ids.push_back(e.first);
+    }
+    if (table_ids.empty()) continue;
+    const absl::Duration max_staleness = background_interval_ / 2;
+    const absl::Duration timeout = background_timeout_;
+    lock_.Unlock();
+    if (session == nullptr) {
+      auto session_or = tdi_sde_interface_->CreateSession();
+      if (session_or.ok()) {
+        session = session_or.ConsumeValueOrDie();
+      } else {
+        LOG(ERROR) << "Failed to create a counter sync session: "
+                   << session_or.status();
+      }
+    }
+    // Tables synced on demand during the last half interval are skipped.
+    for (uint32 table_id : table_ids) {
+      if (session == nullptr) break;
+      ::util::Status status =
+          SyncCounters(session, table_id, max_staleness, timeout);
+      if (!status.ok()) {
+        LOG(ERROR) << "Failed to sync the counters of table " << table_id
+                   << ": " << status;
+      }
+    }
+    lock_.Lock();
+  }
+}
+
+}  // namespace tdi
+}  // namespace hal
+}  // namespace stratum
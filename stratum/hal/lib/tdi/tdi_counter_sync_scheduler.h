@@ -0,0 +1,117 @@
+// Copyright 2024 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef STRATUM_HAL_LIB_TDI_TDI_COUNTER_SYNC_SCHEDULER_H_
+#define STRATUM_HAL_LIB_TDI_TDI_COUNTER_SYNC_SCHEDULER_H_
+
+#include <pthread.h>
+
+#include <memory>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/container/node_hash_map.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/time/time.h"
+#include "stratum/glue/integral_types.h"
+#include "stratum/glue/status/status.h"
+#include "stratum/hal/lib/tdi/tdi_sde_interface.h"
+
+namespace stratum {
+namespace hal {
+namespace tdi {
+
+// The TdiCounterSyncScheduler serializes the synchronization of the driver
+// cached direct counter values with the hardware, per TDI table. Concurrent
+// sync requests for the same table are coalesced into a single hardware sync,
+// and a request is served from the last sync without touching the hardware
+// when that sync started no longer than the requested staleness ago. An
+// optional background thread periodically re-syncs every table that has been
+// synced on demand, so that readers accepting a staleness larger than the
+// refresh interval never wait for the hardware.
+class TdiCounterSyncScheduler {
+ public:
+  virtual ~TdiCounterSyncScheduler();
+
+  // Makes sure the counters of the given TDI table reflect the hardware state
+  // of at most max_staleness ago, synchronizing them if needed. A zero
+  // staleness only accepts a sync that started after this call. The timeout
+  // is passed on to the SDE for hardware syncs.
+  ::util::Status SyncCounters(
+      std::shared_ptr<TdiSdeInterface::SessionInterface> session,
+      uint32 table_id, absl::Duration max_staleness, absl::Duration timeout)
+      LOCKS_EXCLUDED(lock_);
+
+  // Forgets the previous syncs and the set of tables to refresh in the
+  // background. Called when a new pipeline is pushed.
+  void Reset() LOCKS_EXCLUDED(lock_);
+
+  // Starts the background thread which syncs every known table each interval.
+  // Does nothing if the thread is already running.
+  ::util::Status StartBackgroundSync(absl::Duration interval,
+                                     absl::Duration timeout)
+      LOCKS_EXCLUDED(lock_);
+
+  // Stops the background thread, if running.
+  void StopBackgroundSync() LOCKS_EXCLUDED(lock_);
+
+  // Creates a scheduler instance.
+  static std::unique_ptr<TdiCounterSyncScheduler> CreateInstance(
+      TdiSdeInterface* tdi_sde_interface, int device);
+
+  // TdiCounterSyncScheduler is neither copyable nor movable.
+  TdiCounterSyncScheduler(const TdiCounterSyncScheduler&) = delete;
+  TdiCounterSyncScheduler& operator=(const TdiCounterSyncScheduler&) = delete;
+
+ private:
+  // The sync state of a single TDI table.
+  struct TableSyncState {
+    // True while a hardware sync of the table is in progress.
+    bool in_progress = false;
+    // True if the table is refreshed by the background thread.
+    bool background = false;
+    // Start time and result of the last completed hardware sync.
+    absl::Time last_sync_time = absl::InfinitePast();
+    ::util::Status last_status;
+  };
+
+  // Private constructor, use CreateInstance() to create an instance.
+  TdiCounterSyncScheduler(TdiSdeInterface* tdi_sde_interface, int device);
+
+  // Background thread entry point.
+  static void* BackgroundSyncThreadFunc(void* self);
+
+  // Syncs all known tables once per interval until the thread is stopped.
+  void RunBackgroundSync() LOCKS_EXCLUDED(lock_);
+
+  // Protects the table states and the background thread state.
+  absl::Mutex lock_;
+
+  // Signalled when a hardware sync completes or the background thread is
+  // asked to stop.
+  absl::CondVar cond_var_;
+
+  // Map from TDI table ID to its sync state. Entries are never removed, which
+  // keeps pointers to them valid while the lock is released.
+  absl::node_hash_map<uint32, TableSyncState> table_states_ GUARDED_BY(lock_);
+
+  // Incremented by Reset(), to drop the results of the syncs in progress.
+  uint64 reset_count_ GUARDED_BY(lock_) = 0;
+
+  // Background thread state.
+  pthread_t background_thread_id_;
+  bool background_thread_running_ GUARDED_BY(lock_) = false;
+  absl::Duration background_interval_ GUARDED_BY(lock_);
+  absl::Duration background_timeout_ GUARDED_BY(lock_);
+
+  // Pointer to a TdiSdeInterface implementation that wraps all the SDE calls.
+  TdiSdeInterface* tdi_sde_interface_;  // not owned by this class.
+
+  // Fixed zero-based device number of the node/ASIC.
+  const int device_;
+};
+
+}  // namespace tdi
+}  // namespace hal
+}  // namespace stratum
+
+#endif  // STRATUM_HAL_LIB_TDI_TDI_COUNTER_SYNC_SCHEDULER_H_
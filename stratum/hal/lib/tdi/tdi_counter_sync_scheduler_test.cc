@@ -0,0 +1,175 @@
+// Copyright 2024 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#include "stratum/hal/lib/tdi/tdi_counter_sync_scheduler.h"
+
+#include <pthread.h>
+
+#include <memory>
+#include <vector>
+
+#include "absl/memory/memory.h"
+#include "absl/synchronization/notification.h"
+#include "absl/time/clock.h"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "stratum/glue/status/status_test_util.h"
+#include "stratum/hal/lib/tdi/tdi_sde_mock.h"
+
+namespace stratum {
+namespace hal {
+namespace tdi {
+
+using ::testing::_;
+using ::testing::Invoke;
+using ::testing::NiceMock;
+using ::testing::Return;
+
+class TdiCounterSyncSchedulerTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    tdi_sde_wrapper_mock_ = absl::make_unique<NiceMock<TdiSdeMock>>();
+    scheduler_ = TdiCounterSyncScheduler::CreateInstance(
+        tdi_sde_wrapper_mock_.get(), kDevice1);
+    session_mock_ = std::make_shared<SessionMock>();
+  }
+
+  static constexpr int kDevice1 = 0;
+  static constexpr uint32 kTableId = 20;
+  static constexpr absl::Duration kTimeout = absl::Seconds(1);
+  std::unique_ptr<TdiSdeMock> tdi_sde_wrapper_mock_;
+  std::unique_ptr<TdiCounterSyncScheduler> scheduler_;
+  std::shared_ptr<SessionMock> session_mock_;
+};
+
+constexpr int TdiCounterSyncSchedulerTest::kDevice1;
+constexpr uint32 TdiCounterSyncSchedulerTest::kTableId;
+constexpr absl::Duration TdiCounterSyncSchedulerTest::kTimeout;
+
+TEST_F(TdiCounterSyncSchedulerTest, ReadsWithinStalenessReuseLastSync) {
+  EXPECT_CALL(*tdi_sde_wrapper_mock_,
+              SynchronizeCounters(kDevice1, _, kTableId, kTimeout))
+      .Times(2)
+      .WillRepeatedly(Return(::util::OkStatus()));
+  EXPECT_CALL(*tdi_sde_wrapper_mock_,
+              SynchronizeCounters(kDevice1, _, kTableId + 1, kTimeout))
+      .WillOnce(Return(::util::OkStatus()));
+
+  EXPECT_OK(scheduler_->SyncCounters(session_mock_, kTableId,
+                                     absl::Hours(1), kTimeout));
+  EXPECT_OK(scheduler_->SyncCounters(session_mock_, kTableId,
+                                     absl::Hours(1), kTimeout));
+  // Other tables have their own sync state.
+  EXPECT_OK(scheduler_->SyncCounters(session_mock_, kTableId + 1,
+                                     absl::Hours(1), kTimeout));
+  // A zero staleness always needs a new sync.
+  EXPECT_OK(scheduler_->SyncCounters(session_mock_, kTableId,
+                                     absl::ZeroDuration(), kTimeout));
+}
+
+TEST_F(TdiCounterSyncSchedulerTest, FailedSyncIsRetried) {
+  EXPECT_CALL(*tdi_sde_wrapper_mock_,
+              SynchronizeCounters(kDevice1, _, kTableId, kTimeout))
+      .WillOnce(Return(
+          ::util::Status(StratumErrorSpace(), ERR_INTERNAL, "sync failed")))
+      .WillOnce(Return(::util::OkStatus()));
+
+  EXPECT_FALSE(scheduler_->SyncCounters(session_mock_, kTableId,
+                                        absl::Hours(1), kTimeout)
+                   .ok());
+  EXPECT_OK(scheduler_->SyncCounters(session_mock_, kTableId,
+                                     absl::Hours(1), kTimeout));
+}
+
+TEST_F(TdiCounterSyncSchedulerTest, ResetDropsLastSync) {
+  EXPECT_CALL(*tdi_sde_wrapper_mock_,
+              SynchronizeCounters(kDevice1, _, kTableId, kTimeout))
+      .Times(2)
+      .WillRepeatedly(Return(::util::OkStatus()));
+
+  EXPECT_OK(scheduler_->SyncCounters(session_mock_, kTableId,
+                                     absl::Hours(1), kTimeout));
+  scheduler_->Reset();
+  EXPECT_OK(scheduler_->SyncCounters(session_mock_, kTableId,
+                                     absl::Hours(1), kTimeout));
+}
+
+namespace {
+
+struct SyncThreadArgs {
+  TdiCounterSyncScheduler* scheduler;
+  std::shared_ptr<TdiSdeInterface::SessionInterface> session;
+  uint32 table_id;
+  ::util::Status status;
+};
+
+void* SyncThreadFunc(void* arg) {
+  auto* args = static_cast<SyncThreadArgs*>(arg);
+  args->status = args->scheduler->SyncCounters(
+      args->session, args->table_id, absl::Hours(1), absl::Seconds(1));
+  return nullptr;
+}
+
+}  // namespace
+
+TEST_F(TdiCounterSyncSchedulerTest, ConcurrentSyncsAreCoalesced) {
+  constexpr int kNumReaders = 8;
+  absl::Notification sync_started;
+  absl::Notification finish_sync;
+  EXPECT_CALL(*tdi_sde_wrapper_mock_,
+              SynchronizeCounters(kDevice1, _, kTableId, kTimeout))
+      .WillOnce(Invoke(
+          [&](int, std::shared_ptr<TdiSdeInterface::SessionInterface>, uint32,
+              absl::Duration) {
+            sync_started.Notify();
+            finish_sync.WaitForNotification();
+            return ::util::OkStatus();
+          }));
+
+  std::vector<SyncThreadArgs> args(kNumReaders,
+                                   {scheduler_.get(), session_mock_, kTableId,
+                                    ::util::OkStatus()});
+  std::vector<pthread_t> threads(kNumReaders);
+  ASSERT_EQ(0,
+            pthread_create(&threads[0], nullptr, &SyncThreadFunc, &args[0]));
+  sync_started.WaitForNotification();
+  for (int i = 1; i < kNumReaders; ++i) {
+    ASSERT_EQ(0,
+              pthread_create(&threads[i], nullptr, &SyncThreadFunc, &args[i]));
+  }
+  // Give the other readers time to join the sync in progress.
+  absl::SleepFor(absl::Milliseconds(50));
+  finish_sync.Notify();
+  for (int i = 0; i < kNumReaders; ++i) {
+    pthread_join(threads[i], nullptr);
+    EXPECT_OK(args[i].status);
+  }
+}
+
+TEST_F(TdiCounterSyncSchedulerTest, BackgroundSyncRefreshesReadTables) {
+  constexpr int kNumBackgroundSyncs = 3;
+  absl::Notification done;
+  int num_syncs = 0;
+  EXPECT_CALL(*tdi_sde_wrapper_mock_, CreateSession())
+      .WillOnce(Return(std::shared_ptr<TdiSdeInterface::SessionInterface>(
+          std::make_shared<SessionMock>())));
+  EXPECT_CALL(*tdi_sde_wrapper_mock_,
+              SynchronizeCounters(kDevice1, _, kTableId, kTimeout))
+      .WillRepeatedly(Invoke(
+          [&](int, std::shared_ptr<TdiSdeInterface::SessionInterface>, uint32,
+              absl::Duration) {
+            // The first sync is the on-demand one.
+            if (++num_syncs == kNumBackgroundSyncs + 1) done.Notify();
+            return ::util::OkStatus();
+          }));
+
+  EXPECT_OK(scheduler_->SyncCounters(session_mock_, kTableId,
+                                     absl::ZeroDuration(), kTimeout));
+  ASSERT_OK(scheduler_->StartBackgroundSync(absl::Milliseconds(10), kTimeout));
+  EXPECT_TRUE(done.WaitForNotificationWithTimeout(absl::Seconds(10)));
+  scheduler_->StopBackgroundSync();
+}
+
+}  // namespace tdi
+}  // namespace hal
+}  // namespace stratum
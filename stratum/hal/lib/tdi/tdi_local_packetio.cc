@@ -0,0 +1,819 @@
+// Copyright 2024 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#include "stratum/hal/lib/tdi/tdi_local_packetio.h"
+
+#include <errno.h>
+#include <stdint.h>
+#include <poll.h>
+#include <string.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <limits>
+#include <new>
+#include <utility>
+
+#include "absl/cleanup/cleanup.h"
+#include "absl/memory/memory.h"
+#include "absl/strings/str_cat.h"
+#include "stratum/glue/gtl/map_util.h"
+#include "stratum/glue/logging.h"
+#include "stratum/glue/status/status_macros.h"
+#include "stratum/lib/macros.h"
+
+namespace stratum {
+namespace hal {
+namespace tdi {
+
+namespace {
+
+constexpr size_t kCacheLineSize = 64;
+
+// Each slot starts with the size of its record.
+constexpr size_t kSlotHeaderSize = sizeof(uint32);
+
+constexpr uint32 kRingMagic = 0x74646972;  // "tdir"
+
+// The message sent by the endpoint to an agent when it connects, along with
+// the file descriptors of the shared memory and of the eventfds.
+struct HelloMessage {
+  uint32 magic;
+  uint32 version;
+  uint64 memory_size;
+};
+constexpr uint32 kHelloMagic = 0x7464696c;  // "tdil"
+constexpr uint32 kHelloVersion = 1;
+constexpr int kNumSharedFds = 3;
+enum SharedFd { kMemoryFd = 0, kRxEventFd = 1, kTxEventFd = 2 };
+
+constexpr char kDropsMetricName[] = "tdi_local_packetio_dropped_packets_total";
+constexpr char kDropsMetricHelp[] =
+    "PacketIns dropped on the way to the local PacketIO agents.";
+
+size_t RoundUp(size_t size, size_t alignment) {
+  return (size + alignment - 1) / alignment * alignment;
+}
+
+// A packet record is the number of metadata (uint16), every metadata as its
+// ID (uint32), the size of its value (uint16) and the value, then the
+// payload. The integers are in host order, as the record never leaves the
+// host. Returns the maximum size_t if the packet can't be encoded.
+template <typename T>
+size_t RecordSize(const T& packet) {
+  constexpr size_t kMaxSize = std::numeric_limits<size_t>::max();
+  if (packet.metadata_size() > std::numeric_limits<uint16>::max()) {
+    return kMaxSize;
+  }
+  size_t size = sizeof(uint16) + packet.payload().size();
+  for (const auto& metadata : packet.metadata()) {
+    if (metadata.value().size() > std::numeric_limits<uint16>::max()) {
+      return kMaxSize;
+    }
+    size += sizeof(uint32) + sizeof(uint16) + metadata.value().size();
+  }
+  return size;
+}
+
+// Encodes a packet in a record of RecordSize() bytes.
+template <typename T>
+void EncodeRecord(const T& packet, char* record) {
+  const uint16 num_metadata = packet.metadata_size();
+  memcpy(record, &num_metadata, sizeof(num_metadata));
+  record += sizeof(num_metadata);
+  for (const auto& metadata : packet.metadata()) {
+    const uint32 id = metadata.metadata_id();
+    const uint16 size = metadata.value().size();
+    memcpy(record, &id, sizeof(id));
+    record += sizeof(id);
+    memcpy(record, &size, sizeof(size));
+    record += sizeof(size);
+    memcpy(record, metadata.value().data(), size);
+    record += size;
+  }
+  memcpy(record, packet.payload().data(), packet.payload().size());
+}
+
+// Decodes a record into a packet. Returns false if the record is malformed.
+template <typename T>
+bool DecodeRecord(absl::string_view record, T* packet) {
+  packet->Clear();
+  uint16 num_metadata;
+  if (record.size() < sizeof(num_metadata)) return false;
+  memcpy(&num_metadata, record.data(), sizeof(num_metadata));
+  record.remove_prefix(sizeof(num_metadata));
+  for (uint16 i = 0; i < num_metadata; ++i) {
+    uint32 id;
+    uint16 size;
+    if (record.size() < sizeof(id) + sizeof(size)) return false;
+    memcpy(&id, record.data(), sizeof(id));
+    memcpy(&size, record.data() + sizeof(id), sizeof(size));
+    record.remove_prefix(sizeof(id) + sizeof(size));
+    if (record.size() < size) return false;
+    auto* metadata = packet->add_metadata();
+    metadata->set_metadata_id(id);
+    metadata->set_value(record.data(), size);
+    record.remove_prefix(size);
+  }
+  packet->set_payload(record.data(), record.size());
+  return true;
+}
+
+::util::Status SignalEventFd(int fd) {
+  const uint64 value = 1;
+  if (write(fd, &value, sizeof(value)) < 0 && errno != EAGAIN) {
+    return MAKE_ERROR(ERR_INTERNAL)
+           << "Failed to signal eventfd " << fd << ": " << strerror(errno);
+  }
+
+  return ::util::OkStatus();
+}
+
+// Resets an eventfd.
+void ClearEventFd(int fd) {
+  uint64 value;
+  while (read(fd, &value, sizeof(value)) < 0 && errno == EINTR) {
+  }
+}
+
+::util::Status VerifyRingSize(uint32 num_slots, uint32 slot_size) {
+  RET_CHECK(num_slots > 0 && (num_slots & (num_slots - 1)) == 0)
+      << "The number of slots " << num_slots << " is not a power of two.";
+  RET_CHECK(slot_size > kSlotHeaderSize && slot_size % sizeof(uint64) == 0)
+      << "Invalid slot size " << slot_size << ".";
+
+  return ::util::OkStatus();
+}
+
+::util::Status ToUnixSocketAddress(const std::string& path,
+                                   struct sockaddr_un* addr) {
+  RET_CHECK(!path.empty() && path.size() < sizeof(addr->sun_path))
+      << "Invalid Unix socket path '" << path << "'.";
+  memset(addr, 0, sizeof(*addr));
+  addr->sun_family = AF_UNIX;
+  memcpy(addr->sun_path, path.data(), path.size());
+
+  return ::util::OkStatus();
+}
+
+}  // namespace
+
+struct TdiLocalPacketRing::Header {
+  uint32 magic;
+  uint32 num_slots;
+  uint32 slot_size;
+  // Sequence number of the next record written by the producer.
+  alignas(kCacheLineSize) std::atomic<uint64> head;
+  // Sequence number of the next record read by the consumer.
+  alignas(kCacheLineSize) std::atomic<uint64> tail;
+  // Set by the consumer before it waits for a wakeup.
+  alignas(kCacheLineSize) std::atomic<uint32> consumer_waiting;
+};
+
+// The atomics are shared by two processes.
+static_assert(std::atomic<uint64>::is_always_lock_free &&
+                  std::atomic<uint32>::is_always_lock_free,
+              "The ring needs lock-free atomics.");
+
+TdiLocalPacketRing::TdiLocalPacketRing(Header* header)
+    : header_(header),
+      slots_(reinterpret_cast<char*>(header) +
+             RoundUp(sizeof(Header), kCacheLineSize)),
+      num_slots_(header->num_slots),
+      slot_size_(header->slot_size),
+      pending_size_(0) {}
+
+TdiLocalPacketRing::~TdiLocalPacketRing() {}
+
+size_t TdiLocalPacketRing::MemorySize(uint32 num_slots, uint32 slot_size) {
+  return RoundUp(sizeof(Header), kCacheLineSize) +
+         RoundUp(static_cast<size_t>(num_slots) * slot_size, kCacheLineSize);
+}
+
+::util::StatusOr<std::unique_ptr<TdiLocalPacketRing>>
+TdiLocalPacketRing::Create(void* memory, uint32 num_slots, uint32 slot_size) {
+  RET_CHECK(memory != nullptr &&
+            reinterpret_cast<uintptr_t>(memory) % alignof(Header) == 0)
+      << "Invalid memory region for a ring.";
+  RETURN_IF_ERROR(VerifyRingSize(num_slots, slot_size));
+  auto* header = new (memory) Header();
+  header->magic = kRingMagic;
+  header->num_slots = num_slots;
+  header->slot_size = slot_size;
+  header->head.store(0, std::memory_order_relaxed);
+  header->tail.store(0, std::memory_order_relaxed);
+  header->consumer_waiting.store(0, std::memory_order_release);
+
+  return absl::WrapUnique(new TdiLocalPacketRing(header));
+}
+
+::util::StatusOr<std::unique_ptr<TdiLocalPacketRing>>
+TdiLocalPacketRing::Attach(void* memory, size_t memory_size) {
+  RET_CHECK(memory != nullptr &&
+            reinterpret_cast<uintptr_t>(memory) % alignof(Header) == 0 &&
+            memory_size >= sizeof(Header))
+      << "Invalid memory region of " << memory_size << " bytes for a ring.";
+  auto* header = static_cast<Header*>(memory);
+  RET_CHECK(header->magic == kRingMagic) << "No ring in the memory region.";
+  const uint32 num_slots = header->num_slots;
+  const uint32 slot_size = header->slot_size;
+  RETURN_IF_ERROR(VerifyRingSize(num_slots, slot_size));
+  RET_CHECK(MemorySize(num_slots, slot_size) <= memory_size)
+      << "Ring of " << num_slots << " slots of " << slot_size
+      << " bytes overflows a memory region of " << memory_size << " bytes.";
+
+  return absl::WrapUnique(new TdiLocalPacketRing(header));
+}
+
+char* TdiLocalPacketRing::BeginPush(size_t size) {
+  if (size > MaxRecordSize()) return nullptr;
+  const uint64 head = header_->head.load(std::memory_order_relaxed);
+  if (head - header_->tail.load(std::memory_order_acquire) >= num_slots_) {
+    return nullptr;
+  }
+  pending_size_ = size;
+
+  return GetSlot(head) + kSlotHeaderSize;
+}
+
+bool TdiLocalPacketRing::CommitPush() {
+  const uint64 head = header_->head.load(std::memory_order_relaxed);
+  const uint32 size = pending_size_;
+  memcpy(GetSlot(head), &size, sizeof(size));
+  // Pairs with ArmWakeup(): either the consumer sees the new record, or the
+  // producer sees the consumer waiting and wakes it up.
+  header_->head.store(head + 1, std::memory_order_seq_cst);
+
+  return header_->consumer_waiting.load(std::memory_order_seq_cst) &&
+         header_->consumer_waiting.exchange(0, std::memory_order_seq_cst);
+}
+
+bool TdiLocalPacketRing::Front(absl::string_view* record) const {
+  const uint64 tail = header_->tail.load(std::memory_order_relaxed);
+  if (header_->head.load(std::memory_order_acquire) == tail) return false;
+  const char* slot = GetSlot(tail);
+  uint32 size;
+  memcpy(&size, slot, sizeof(size));
+  // The producer may be another process, the size is not trusted.
+  *record = absl::string_view(slot + kSlotHeaderSize,
+                              std::min<size_t>(size, MaxRecordSize()));
+
+  return true;
+}
+
+void TdiLocalPacketRing::Pop() {
+  header_->tail.fetch_add(1, std::memory_order_release);
+}
+
+bool TdiLocalPacketRing::ArmWakeup() {
+  header_->consumer_waiting.store(1, std::memory_order_seq_cst);
+  if (header_->head.load(std::memory_order_seq_cst) !=
+      header_->tail.load(std::memory_order_relaxed)) {
+    header_->consumer_waiting.store(0, std::memory_order_relaxed);
+    return false;
+  }
+
+  return true;
+}
+
+size_t TdiLocalPacketRing::MaxRecordSize() const {
+  return slot_size_ - kSlotHeaderSize;
+}
+
+size_t TdiLocalPacketRing::memory_size() const {
+  return MemorySize(num_slots_, slot_size_);
+}
+
+char* TdiLocalPacketRing::GetSlot(uint64 seq) const {
+  return slots_ + (seq & (num_slots_ - 1)) * slot_size_;
+}
+
+struct TdiLocalPacketioEndpoint::Agent {
+  ~Agent() {
+    rx_ring.reset();
+    tx_ring.reset();
+    if (memory != nullptr) munmap(memory, memory_size);
+    // Closing the descriptors also removes them from the epoll instance.
+    for (int fd : {sock, rx_event_fd, tx_event_fd}) {
+      if (fd >= 0) close(fd);
+    }
+  }
+
+  int sock = -1;
+  int rx_event_fd = -1;
+  int tx_event_fd = -1;
+  void* memory = nullptr;
+  size_t memory_size = 0;
+  std::unique_ptr<TdiLocalPacketRing> rx_ring;
+  std::unique_ptr<TdiLocalPacketRing> tx_ring;
+};
+
+TdiLocalPacketioEndpoint::TdiLocalPacketioEndpoint(
+    int device, const std::string& socket_path, uint32 num_slots,
+    uint32 slot_size, TransmitFunction transmit)
+    : device_(device),
+      socket_path_(socket_path),
+      num_slots_(num_slots),
+      slot_size_(slot_size),
+      transmit_(std::move(transmit)),
+      listen_sock_(-1),
+      epoll_fd_(-1),
+      stop_event_fd_(-1),
+      serve_thread_id_(),
+      agents_(),
+      tx_event_fd_to_sock_() {
+  const std::string device_label = absl::StrCat(device_);
+  auto* registry = MetricRegistry::GetInstance();
+  ring_full_drops_ =
+      registry->GetCounter(kDropsMetricName, kDropsMetricHelp,
+                           {{"device", device_label}, {"reason", "ring_full"}});
+  too_large_drops_ =
+      registry->GetCounter(kDropsMetricName, kDropsMetricHelp,
+                           {{"device", device_label}, {"reason", "too_large"}});
+  CHECK(ring_full_drops_ != nullptr && too_large_drops_ != nullptr)
+      << "Metric " << kDropsMetricName << " is not a counter.";
+}
+
+TdiLocalPacketioEndpoint::~TdiLocalPacketioEndpoint() {
+  ::util::Status status = Shutdown();
+  if (!status.ok()) {
+    LOG(ERROR) << "Failed to shut down the local PacketIO endpoint of device "
+               << device_ << ": " << status.error_message();
+  }
+}
+
+::util::StatusOr<std::unique_ptr<TdiLocalPacketioEndpoint>>
+TdiLocalPacketioEndpoint::CreateInstance(int device,
+                                         const std::string& socket_path,
+                                         uint32 num_slots, uint32 slot_size,
+                                         TransmitFunction transmit) {
+  RET_CHECK(transmit != nullptr);
+  RETURN_IF_ERROR(VerifyRingSize(num_slots, slot_size));
+  auto endpoint = absl::WrapUnique(new TdiLocalPacketioEndpoint(
+      device, socket_path, num_slots, slot_size, std::move(transmit)));
+  RETURN_IF_ERROR(endpoint->Start());
+
+  return endpoint;
+}
+
+::util::Status TdiLocalPacketioEndpoint::Start() {
+  struct sockaddr_un addr;
+  RETURN_IF_ERROR(ToUnixSocketAddress(socket_path_, &addr));
+  listen_sock_ = socket(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0);
+  if (listen_sock_ < 0) {
+    return MAKE_ERROR(ERR_INTERNAL)
+           << "Failed to create a Unix socket: " << strerror(errno);
+  }
+  // Removes the socket left behind by a previous run.
+  unlink(socket_path_.c_str());
+  if (bind(listen_sock_, reinterpret_cast<struct sockaddr*>(&addr),
+           sizeof(addr)) < 0 ||
+      listen(listen_sock_, SOMAXCONN) < 0) {
+    return MAKE_ERROR(ERR_INTERNAL) << "Failed to listen on Unix socket "
+                                    << socket_path_ << ": " << strerror(errno);
+  }
+  epoll_fd_ = epoll_create1(EPOLL_CLOEXEC);
+  stop_event_fd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+  if (epoll_fd_ < 0 || stop_event_fd_ < 0) {
+    return MAKE_ERROR(ERR_INTERNAL)
+           << "Failed to create the epoll instance or the stop eventfd: "
+           << strerror(errno);
+  }
+  for (int fd : {listen_sock_, stop_event_fd_}) {
+    struct epoll_event event = {};
+    event.events = EPOLLIN;
+    event.data.fd = fd;
+    if (epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, fd, &event) < 0) {
+      return MAKE_ERROR(ERR_INTERNAL)
+             << "Failed to add fd " << fd << " to epoll: " << strerror(errno);
+    }
+  }
+  int ret = pthread_create(&serve_thread_id_, nullptr,
+                           &TdiLocalPacketioEndpoint::ServeThreadFunc, this);
+  if (ret != 0) {
+    serve_thread_id_ = 0;
+    return MAKE_ERROR(ERR_INTERNAL)
+           << "Failed to spawn local PacketIO thread for device with ID "
+           << device_ << ". Err: " << ret << ".";
+  }
+  LOG(INFO) << "Local PacketIO of device " << device_ << " listening on "
+            << socket_path_ << ".";
+
+  return ::util::OkStatus();
+}
+
+::util::Status TdiLocalPacketioEndpoint::Shutdown() {
+  ::util::Status status;
+  if (serve_thread_id_ != 0) {
+    APPEND_STATUS_IF_ERROR(status, SignalEventFd(stop_event_fd_));
+    if (pthread_join(serve_thread_id_, nullptr) != 0) {
+      ::util::Status error = MAKE_ERROR(ERR_INTERNAL)
+                             << "Failed to join thread " << serve_thread_id_;
+      APPEND_STATUS_IF_ERROR(status, error);
+    }
+    serve_thread_id_ = 0;
+  }
+  {
+    absl::MutexLock l(&agents_lock_);
+    agents_.clear();
+  }
+  tx_event_fd_to_sock_.clear();
+  if (listen_sock_ >= 0) {
+    close(listen_sock_);
+    unlink(socket_path_.c_str());
+    listen_sock_ = -1;
+  }
+  for (int* fd : {&epoll_fd_, &stop_event_fd_}) {
+    if (*fd >= 0) close(*fd);
+    *fd = -1;
+  }
+
+  return status;
+}
+
+bool TdiLocalPacketioEndpoint::Write(const ::p4::v1::PacketIn& packet) {
+  const size_t size = RecordSize(packet);
+  bool written = false;
+  absl::MutexLock l(&agents_lock_);
+  for (const auto& e : agents_) {
+    Agent* agent = e.second.get();
+    if (size > agent->rx_ring->MaxRecordSize()) {
+      too_large_drops_->Increment();
+      continue;
+    }
+    char* record = agent->rx_ring->BeginPush(size);
+    if (record == nullptr) {
+      ring_full_drops_->Increment();
+      continue;
+    }
+    EncodeRecord(packet, record);
+    if (agent->rx_ring->CommitPush()) {
+      ::util::Status status = SignalEventFd(agent->rx_event_fd);
+      if (!status.ok()) LOG(ERROR) << status.error_message();
+    }
+    written = true;
+  }
+
+  return written;
+}
+
+int TdiLocalPacketioEndpoint::NumAgents() const {
+  absl::MutexLock l(&agents_lock_);
+  return agents_.size();
+}
+
+::util::Status TdiLocalPacketioEndpoint::AcceptAgent() {
+  auto agent = absl::make_unique<Agent>();
+  agent->sock = accept4(listen_sock_, nullptr, nullptr, SOCK_CLOEXEC);
+  if (agent->sock < 0) {
+    return MAKE_ERROR(ERR_INTERNAL)
+           << "Failed to accept an agent: " << strerror(errno);
+  }
+
+  // Every agent gets its own memory region, so that an agent which crashed
+  // mid-record never corrupts the rings of its successor.
+  const size_t ring_size =
+      TdiLocalPacketRing::MemorySize(num_slots_, slot_size_);
+  agent->memory_size = 2 * ring_size;
+  int memory_fd = memfd_create("tdi_local_packetio", MFD_CLOEXEC);
+  if (memory_fd < 0) {
+    return MAKE_ERROR(ERR_INTERNAL)
+           << "Failed to create shared memory: " << strerror(errno);
+  }
+  auto memory_fd_closer = absl::MakeCleanup([memory_fd] { close(memory_fd); });
+  if (ftruncate(memory_fd, agent->memory_size) < 0) {
+    return MAKE_ERROR(ERR_INTERNAL) << "Failed to size shared memory to "
+                                    << agent->memory_size
+                                    << " bytes: " << strerror(errno);
+  }
+  void* memory = mmap(nullptr, agent->memory_size, PROT_READ | PROT_WRITE,
+                      MAP_SHARED, memory_fd, 0);
+  if (memory == MAP_FAILED) {
+    return MAKE_ERROR(ERR_INTERNAL)
+           << "Failed to map shared memory: " << strerror(errno);
+  }
+  agent->memory = memory;
+  ASSIGN_OR_RETURN(agent->rx_ring, TdiLocalPacketRing::Create(
+                                       memory, num_slots_, slot_size_));
+  ASSIGN_OR_RETURN(agent->tx_ring,
+                   TdiLocalPacketRing::Create(static_cast<char*>(memory) +
+                                                  ring_size,
+                                              num_slots_, slot_size_));
+  agent->rx_event_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+  agent->tx_event_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+  if (agent->rx_event_fd < 0 || agent->tx_event_fd < 0) {
+    return MAKE_ERROR(ERR_INTERNAL)
+           << "Failed to create the eventfds: " << strerror(errno);
+  }
+  // The serving thread sleeps until the agent sends a packet.
+  agent->tx_ring->ArmWakeup();
+
+  struct epoll_event event = {};
+  event.events = EPOLLIN | EPOLLRDHUP;
+  event.data.fd = agent->sock;
+  if (epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, agent->sock, &event) < 0) {
+    return MAKE_ERROR(ERR_INTERNAL)
+           << "Failed to add an agent to epoll: " << strerror(errno);
+  }
+  event.events = EPOLLIN;
+  event.data.fd = agent->tx_event_fd;
+  if (epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, agent->tx_event_fd, &event) < 0) {
+    return MAKE_ERROR(ERR_INTERNAL)
+           << "Failed to add an agent to epoll: " << strerror(errno);
+  }
+
+  // The agent gets the PacketIns as soon as Connect() returns.
+  const int sock = agent->sock;
+  HelloMessage hello = {kHelloMagic, kHelloVersion, agent->memory_size};
+  int fds[kNumSharedFds];
+  fds[kMemoryFd] = memory_fd;
+  fds[kRxEventFd] = agent->rx_event_fd;
+  fds[kTxEventFd] = agent->tx_event_fd;
+  tx_event_fd_to_sock_[agent->tx_event_fd] = sock;
+  {
+    absl::MutexLock l(&agents_lock_);
+    agents_[sock] = std::move(agent);
+  }
+  struct iovec iov = {&hello, sizeof(hello)};
+  alignas(struct cmsghdr) char control[CMSG_SPACE(sizeof(fds))];
+  struct msghdr msg = {};
+  msg.msg_iov = &iov;
+  msg.msg_iovlen = 1;
+  msg.msg_control = control;
+  msg.msg_controllen = sizeof(control);
+  struct cmsghdr* cmsg = CMSG_FIRSTHDR(&msg);
+  cmsg->cmsg_level = SOL_SOCKET;
+  cmsg->cmsg_type = SCM_RIGHTS;
+  cmsg->cmsg_len = CMSG_LEN(sizeof(fds));
+  memcpy(CMSG_DATA(cmsg), fds, sizeof(fds));
+  if (sendmsg(sock, &msg, MSG_NOSIGNAL) != sizeof(hello)) {
+    ::util::Status error = MAKE_ERROR(ERR_INTERNAL)
+                           << "Failed to send the shared memory to an agent: "
+                           << strerror(errno);
+    RemoveAgent(sock);
+    return error;
+  }
+  LOG(INFO) << "Local PacketIO agent connected to device " << device_ << ".";
+
+  return ::util::OkStatus();
+}
+
+void TdiLocalPacketioEndpoint::RemoveAgent(int sock) {
+  std::unique_ptr<Agent> agent;
+  {
+    absl::MutexLock l(&agents_lock_);
+    auto it = agents_.find(sock);
+    if (it == agents_.end()) return;
+    agent = std::move(it->second);
+    agents_.erase(it);
+  }
+  tx_event_fd_to_sock_.erase(agent->tx_event_fd);
+  LOG(INFO) << "Local PacketIO agent disconnected from device " << device_
+            << ".";
+}
+
+void TdiLocalPacketioEndpoint::TransmitAgentPackets(Agent* agent) {
+  // Reset the eventfd first, the ring is read below.
+  ClearEventFd(agent->tx_event_fd);
+  uint32 num_records = 0;
+  do {
+    absl::string_view record;
+    while (agent->tx_ring->Front(&record)) {
+      // At most one lap of the ring per wakeup, so that an agent which keeps
+      // its ring full does not starve the other agents, the new agents and
+      // Shutdown(). The agent is served again after the pending events.
+      if (num_records++ == num_slots_) {
+        ::util::Status status = SignalEventFd(agent->tx_event_fd);
+        if (!status.ok()) {
+          LOG(ERROR) << "Failed to reschedule a local agent: "
+                     << status.error_message();
+        }
+        return;
+      }
+      ::p4::v1::PacketOut packet;
+      const bool decoded = DecodeRecord(record, &packet);
+      agent->tx_ring->Pop();
+      if (!decoded) {
+        VLOG(1) << "Dropped a malformed PacketOut of a local agent.";
+        continue;
+      }
+      ::util::Status status = transmit_(packet);
+      if (!status.ok()) {
+        VLOG(1) << "Failed to transmit a PacketOut of a local agent: "
+                << status.error_message();
+      }
+    }
+  } while (!agent->tx_ring->ArmWakeup());
+}
+
+void TdiLocalPacketioEndpoint::Serve() {
+  constexpr int kMaxEvents = 16;
+  struct epoll_event events[kMaxEvents];
+  while (true) {
+    int num_events = epoll_wait(epoll_fd_, events, kMaxEvents, -1);
+    if (num_events < 0) {
+      if (errno == EINTR) continue;
+      LOG(ERROR) << "epoll_wait failed: " << strerror(errno);
+      return;
+    }
+    for (int i = 0; i < num_events; ++i) {
+      const int fd = events[i].data.fd;
+      if (fd == stop_event_fd_) return;
+      if (fd == listen_sock_) {
+        ::util::Status status = AcceptAgent();
+        if (!status.ok()) {
+          LOG(ERROR) << "Failed to accept a local PacketIO agent: "
+                     << status.error_message();
+        }
+        continue;
+      }
+      const int* sock = gtl::FindOrNull(tx_event_fd_to_sock_, fd);
+      if (sock != nullptr) {
+        Agent* agent = nullptr;
+        {
+          absl::MutexLock l(&agents_lock_);
+          auto* entry = gtl::FindOrNull(agents_, *sock);
+          if (entry != nullptr) agent = entry->get();
+        }
+        // Only this thread removes agents, it's safe to use it unlocked.
+        if (agent != nullptr) TransmitAgentPackets(agent);
+        continue;
+      }
+      // Agents don't send anything on their socket, so the socket is only
+      // readable once the agent hangs up.
+      char buffer[sizeof(HelloMessage)];
+      ssize_t ret = recv(fd, buffer, sizeof(buffer), MSG_DONTWAIT);
+      if (ret == 0 || (ret < 0 && errno != EAGAIN && errno != EINTR)) {
+        RemoveAgent(fd);
+      }
+    }
+  }
+}
+
+void* TdiLocalPacketioEndpoint::ServeThreadFunc(void* arg) {
+  TdiLocalPacketioEndpoint* endpoint =
+      reinterpret_cast<TdiLocalPacketioEndpoint*>(arg);
+  endpoint->Serve();
+
+  return nullptr;
+}
+
+TdiLocalPacketioClient::TdiLocalPacketioClient(int sock, int rx_event_fd,
+                                               int tx_event_fd, void* memory,
+                                               size_t memory_size)
+    : sock_(sock),
+      rx_event_fd_(rx_event_fd),
+      tx_event_fd_(tx_event_fd),
+      memory_(memory),
+      memory_size_(memory_size),
+      rx_ring_(nullptr),
+      tx_ring_(nullptr) {}
+
+TdiLocalPacketioClient::~TdiLocalPacketioClient() {
+  rx_ring_.reset();
+  tx_ring_.reset();
+  munmap(memory_, memory_size_);
+  close(rx_event_fd_);
+  close(tx_event_fd_);
+  close(sock_);
+}
+
+::util::StatusOr<std::unique_ptr<TdiLocalPacketioClient>>
+TdiLocalPacketioClient::Connect(const std::string& socket_path) {
+  struct sockaddr_un addr;
+  RETURN_IF_ERROR(ToUnixSocketAddress(socket_path, &addr));
+  int sock = socket(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0);
+  if (sock < 0) {
+    return MAKE_ERROR(ERR_INTERNAL)
+           << "Failed to create a Unix socket: " << strerror(errno);
+  }
+  auto sock_closer = absl::MakeCleanup([sock] { close(sock); });
+  if (connect(sock, reinterpret_cast<struct sockaddr*>(&addr), sizeof(addr)) <
+      0) {
+    return MAKE_ERROR(ERR_INTERNAL) << "Failed to connect to " << socket_path
+                                    << ": " << strerror(errno);
+  }
+
+  // Receives the shared memory and the eventfds.
+  HelloMessage hello = {};
+  struct iovec iov = {&hello, sizeof(hello)};
+  alignas(struct cmsghdr) char control[CMSG_SPACE(sizeof(int) *
+                                                  kNumSharedFds)];
+  struct msghdr msg = {};
+  msg.msg_iov = &iov;
+  msg.msg_iovlen = 1;
+  msg.msg_control = control;
+  msg.msg_controllen = sizeof(control);
+  ssize_t ret;
+  do {
+    ret = recvmsg(sock, &msg, MSG_CMSG_CLOEXEC);
+  } while (ret < 0 && errno == EINTR);
+  if (ret < 0) {
+    return MAKE_ERROR(ERR_INTERNAL) << "Failed to receive from " << socket_path
+                                    << ": " << strerror(errno);
+  }
+  struct cmsghdr* cmsg = CMSG_FIRSTHDR(&msg);
+  if (cmsg == nullptr || cmsg->cmsg_level != SOL_SOCKET ||
+      cmsg->cmsg_type != SCM_RIGHTS ||
+      cmsg->cmsg_len != CMSG_LEN(sizeof(int) * kNumSharedFds)) {
+    return MAKE_ERROR(ERR_INTERNAL)
+           << "Got no shared memory from the endpoint at " << socket_path
+           << ".";
+  }
+  int fds[kNumSharedFds];
+  memcpy(fds, CMSG_DATA(cmsg), sizeof(fds));
+  auto fds_closer = absl::MakeCleanup([&fds] {
+    for (int fd : fds) close(fd);
+  });
+  if (ret != sizeof(hello) || hello.magic != kHelloMagic ||
+      hello.version != kHelloVersion) {
+    return MAKE_ERROR(ERR_INTERNAL)
+           << "Unexpected hello from the endpoint at " << socket_path << ".";
+  }
+  void* memory = mmap(nullptr, hello.memory_size, PROT_READ | PROT_WRITE,
+                      MAP_SHARED, fds[kMemoryFd], 0);
+  if (memory == MAP_FAILED) {
+    return MAKE_ERROR(ERR_INTERNAL)
+           << "Failed to map shared memory: " << strerror(errno);
+  }
+  close(fds[kMemoryFd]);
+  std::move(fds_closer).Cancel();
+  std::move(sock_closer).Cancel();
+  auto client = absl::WrapUnique(
+      new TdiLocalPacketioClient(sock, fds[kRxEventFd], fds[kTxEventFd],
+                                 memory, hello.memory_size));
+
+  ASSIGN_OR_RETURN(client->rx_ring_,
+                   TdiLocalPacketRing::Attach(memory, hello.memory_size));
+  const size_t rx_ring_size = client->rx_ring_->memory_size();
+  ASSIGN_OR_RETURN(
+      client->tx_ring_,
+      TdiLocalPacketRing::Attach(static_cast<char*>(memory) + rx_ring_size,
+                                 hello.memory_size - rx_ring_size));
+
+  return client;
+}
+
+::util::Status TdiLocalPacketioClient::Receive(::p4::v1::PacketIn* packet,
+                                               absl::Duration timeout) {
+  const absl::Time deadline = absl::Now() + timeout;
+  while (true) {
+    absl::string_view record;
+    if (rx_ring_->Front(&record)) {
+      const bool decoded = DecodeRecord(record, packet);
+      rx_ring_->Pop();
+      if (!decoded) {
+        return MAKE_ERROR(ERR_INTERNAL) << "Received a malformed PacketIn.";
+      }
+      return ::util::OkStatus();
+    }
+    if (!rx_ring_->ArmWakeup()) continue;
+
+    int timeout_ms = -1;
+    if (deadline != absl::InfiniteFuture()) {
+      timeout_ms = std::max<int64>(
+          0, absl::Ceil(deadline - absl::Now(), absl::Milliseconds(1)) /
+                 absl::Milliseconds(1));
+    }
+    struct pollfd fds[2] = {{rx_event_fd_, POLLIN, 0},
+                            {sock_, POLLIN | POLLRDHUP, 0}};
+    int ret = poll(fds, 2, timeout_ms);
+    if (ret < 0) {
+      if (errno == EINTR) continue;
+      return MAKE_ERROR(ERR_INTERNAL) << "poll failed: " << strerror(errno);
+    }
+    if (ret == 0) {
+      return MAKE_ERROR(ERR_ENTRY_NOT_FOUND) << "No PacketIn received.";
+    }
+    if (fds[0].revents & POLLIN) ClearEventFd(rx_event_fd_);
+    // Once the endpoint hangs up, the queued packets are still received.
+    if (fds[1].revents != 0 && !rx_ring_->Front(&record)) {
+      return MAKE_ERROR(ERR_CANCELLED) << "The endpoint is shut down.";
+    }
+  }
+}
+
+::util::Status TdiLocalPacketioClient::Send(const ::p4::v1::PacketOut& packet) {
+  const size_t size = RecordSize(packet);
+  RET_CHECK(size <= tx_ring_->MaxRecordSize())
+      << "PacketOut of " << packet.payload().size()
+      << " bytes doesn't fit in a ring slot.";
+  char* record = tx_ring_->BeginPush(size);
+  if (record == nullptr) {
+    return MAKE_ERROR(ERR_NO_RESOURCE) << "The TX ring is full.";
+  }
+  EncodeRecord(packet, record);
+  if (tx_ring_->CommitPush()) RETURN_IF_ERROR(SignalEventFd(tx_event_fd_));
+
+  return ::util::OkStatus();
+}
+
+}  // namespace tdi
+}  // namespace hal
+}  // namespace stratum
@@ -0,0 +1,246 @@
+// Copyright 2024 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef STRATUM_HAL_LIB_TDI_TDI_LOCAL_PACKETIO_H_
+#define STRATUM_HAL_LIB_TDI_TDI_LOCAL_PACKETIO_H_
+
+#include <pthread.h>
+#include <stddef.h>
+
+#include <functional>
+#include <memory>
+#include <string>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/time/time.h"
+#include "p4/v1/p4runtime.pb.h"
+#include "stratum/glue/integral_types.h"
+#include "stratum/glue/status/status.h"
+#include "stratum/glue/status/statusor.h"
+#include "stratum/hal/lib/common/writer_interface.h"
+#include "stratum/lib/metrics.h"
+
+namespace stratum {
+namespace hal {
+namespace tdi {
+
+// A single-producer single-consumer ring of records in a memory region shared
+// by two processes. The ring has a fixed number of slots of a fixed size, and
+// every record takes one slot. The producer and the consumer never block and
+// never make a syscall; the owner of the ring signals the consumer as told by
+// CommitPush() and ArmWakeup().
+class TdiLocalPacketRing {
+ public:
+  virtual ~TdiLocalPacketRing();
+
+  // Returns the size of the memory region of a ring with the given number of
+  // slots of the given size.
+  static size_t MemorySize(uint32 num_slots, uint32 slot_size);
+
+  // Lays out a new empty ring in the given memory region, which must be at
+  // least MemorySize() bytes long. The number of slots must be a power of two.
+  static ::util::StatusOr<std::unique_ptr<TdiLocalPacketRing>> Create(
+      void* memory, uint32 num_slots, uint32 slot_size);
+
+  // Attaches to a ring laid out by Create(), possibly in another process. The
+  // memory region is 'memory_size' bytes long.
+  static ::util::StatusOr<std::unique_ptr<TdiLocalPacketRing>> Attach(
+      void* memory, size_t memory_size);
+
+  // Producer side. Returns a buffer for a record of 'size' bytes in the next
+  // free slot, or nullptr if the ring is full or the record doesn't fit in a
+  // slot. The record is only visible to the consumer after CommitPush(),
+  // which returns true if the consumer waits for a wakeup.
+  char* BeginPush(size_t size);
+  bool CommitPush();
+
+  // Consumer side. Returns false if the ring is empty, else sets 'record' to
+  // the oldest record. The record stays valid until Pop() is called.
+  bool Front(absl::string_view* record) const;
+  void Pop();
+
+  // Consumer side. Tells the producer to ask for a wakeup on the next record.
+  // Returns false, without waiting for a wakeup, if the ring is not empty.
+  bool ArmWakeup();
+
+  // Returns the maximum size of a record.
+  size_t MaxRecordSize() const;
+
+  // Returns the size of the memory region of the ring.
+  size_t memory_size() const;
+
+  // TdiLocalPacketRing is neither copyable nor movable.
+  TdiLocalPacketRing(const TdiLocalPacketRing&) = delete;
+  TdiLocalPacketRing& operator=(const TdiLocalPacketRing&) = delete;
+
+ private:
+  // The header of the ring at the start of the shared memory region.
+  struct Header;
+
+  // Private constructor. Use Create() or Attach() to create an instance.
+  explicit TdiLocalPacketRing(Header* header);
+
+  // Returns the slot with the given sequence number.
+  char* GetSlot(uint64 seq) const;
+
+  // The ring in shared memory, not owned by this class.
+  Header* const header_;
+  char* const slots_;
+  const uint32 num_slots_;
+  const uint32 slot_size_;
+
+  // Size of the record started by BeginPush().
+  size_t pending_size_;
+};
+
+// The TdiLocalPacketioEndpoint exports the PacketIO of a device to agents
+// running on the same host (e.g. a routing daemon or a DHCP relay), without
+// the protobuf encoding and the HTTP/2 framing of the P4Runtime StreamChannel.
+// Agents connect to a Unix socket with TdiLocalPacketioClient and get a pair
+// of TdiLocalPacketRing in shared memory: the PacketIns are copied into the
+// RX ring of every agent, and the PacketOuts queued by an agent in its TX
+// ring are handed over to the transmit function. Each ring direction is
+// signalled with an eventfd, only when its consumer sleeps.
+class TdiLocalPacketioEndpoint : public WriterInterface<::p4::v1::PacketIn> {
+ public:
+  // The function called to transmit the PacketOuts of the agents.
+  using TransmitFunction =
+      std::function<::util::Status(const ::p4::v1::PacketOut& packet)>;
+
+  ~TdiLocalPacketioEndpoint() override;
+
+  // Creates an endpoint listening on the Unix socket at the given path. Every
+  // agent gets rings of 'num_slots' slots of 'slot_size' bytes, which bound
+  // the size of a packet and its metadata.
+  static ::util::StatusOr<std::unique_ptr<TdiLocalPacketioEndpoint>>
+  CreateInstance(int device, const std::string& socket_path, uint32 num_slots,
+                 uint32 slot_size, TransmitFunction transmit);
+
+  // Copies a PacketIn into the RX rings of all the connected agents. Never
+  // blocks: the packet is dropped for an agent whose ring is full. Returns
+  // false if no agent got the packet.
+  bool Write(const ::p4::v1::PacketIn& packet) override
+      LOCKS_EXCLUDED(agents_lock_);
+
+  // Disconnects the agents and stops listening. Called by the destructor.
+  ::util::Status Shutdown() LOCKS_EXCLUDED(agents_lock_);
+
+  // Returns the number of connected agents.
+  int NumAgents() const LOCKS_EXCLUDED(agents_lock_);
+
+  // TdiLocalPacketioEndpoint is neither copyable nor movable.
+  TdiLocalPacketioEndpoint(const TdiLocalPacketioEndpoint&) = delete;
+  TdiLocalPacketioEndpoint& operator=(const TdiLocalPacketioEndpoint&) = delete;
+
+ private:
+  // A connected agent and its rings.
+  struct Agent;
+
+  // Private constructor. Use CreateInstance() to create an instance.
+  TdiLocalPacketioEndpoint(int device, const std::string& socket_path,
+                           uint32 num_slots, uint32 slot_size,
+                           TransmitFunction transmit);
+
+  // Binds and listens on the socket, and starts the serving thread.
+  ::util::Status Start();
+
+  // Accepts an agent and sends it the shared memory and the eventfds.
+  ::util::Status AcceptAgent() LOCKS_EXCLUDED(agents_lock_);
+
+  // Disconnects the agent with the given socket.
+  void RemoveAgent(int sock) LOCKS_EXCLUDED(agents_lock_);
+
+  // Transmits the PacketOuts queued in the TX ring of an agent, at most one
+  // ring's worth per call.
+  void TransmitAgentPackets(Agent* agent);
+
+  // Accepts the agents and serves their TX rings until Shutdown().
+  void Serve() LOCKS_EXCLUDED(agents_lock_);
+
+  // Serving thread function.
+  static void* ServeThreadFunc(void* arg);
+
+  // Fixed zero-based device number, used as metric label.
+  const int device_;
+  const std::string socket_path_;
+  const uint32 num_slots_;
+  const uint32 slot_size_;
+  const TransmitFunction transmit_;
+
+  // The listening socket, the epoll instance of the serving thread and the
+  // eventfd which stops it. Only changed by Start() and Shutdown().
+  int listen_sock_;
+  int epoll_fd_;
+  int stop_event_fd_;
+  pthread_t serve_thread_id_;
+
+  // Protects the agents. The serving thread is the only one which adds and
+  // removes agents, and the only consumer of their TX rings.
+  mutable absl::Mutex agents_lock_;
+
+  // The connected agents, keyed by their socket.
+  absl::flat_hash_map<int, std::unique_ptr<Agent>> agents_
+      GUARDED_BY(agents_lock_);
+
+  // Maps the TX eventfd of an agent to its socket. Only used by the serving
+  // thread.
+  absl::flat_hash_map<int, int> tx_event_fd_to_sock_;
+
+  // PacketIns dropped because an RX ring was full or too small, never null.
+  MetricCounter* ring_full_drops_;
+  MetricCounter* too_large_drops_;
+};
+
+// The agent side of a TdiLocalPacketioEndpoint. Receive() and Send() can be
+// called from different threads, but each of them from a single thread at a
+// time, as every ring has a single producer and a single consumer.
+class TdiLocalPacketioClient {
+ public:
+  virtual ~TdiLocalPacketioClient();
+
+  // Connects to the endpoint listening on the Unix socket at the given path.
+  static ::util::StatusOr<std::unique_ptr<TdiLocalPacketioClient>> Connect(
+      const std::string& socket_path);
+
+  // Waits up to 'timeout' for a PacketIn. Returns ERR_ENTRY_NOT_FOUND if the
+  // timeout expires, and ERR_CANCELLED once the endpoint is shut down and all
+  // its packets are received.
+  ::util::Status Receive(::p4::v1::PacketIn* packet, absl::Duration timeout);
+
+  // Queues a PacketOut for transmission. Never blocks. Returns
+  // ERR_NO_RESOURCE if the TX ring is full.
+  ::util::Status Send(const ::p4::v1::PacketOut& packet);
+
+  // TdiLocalPacketioClient is neither copyable nor movable.
+  TdiLocalPacketioClient(const TdiLocalPacketioClient&) = delete;
+  TdiLocalPacketioClient& operator=(const TdiLocalPacketioClient&) = delete;
+
+ private:
+  // Private constructor. Use Connect() to create an instance.
+  TdiLocalPacketioClient(int sock, int rx_event_fd, int tx_event_fd,
+                         void* memory, size_t memory_size);
+
+  // The socket connected to the endpoint and the eventfds of the rings, all
+  // owned by this class.
+  const int sock_;
+  const int rx_event_fd_;
+  const int tx_event_fd_;
+
+  // The shared memory region holding the rings, owned by this class.
+  void* const memory_;
+  const size_t memory_size_;
+
+  // The ring of the PacketIns, read by this class, and the ring of the
+  // PacketOuts, written by this class.
+  std::unique_ptr<TdiLocalPacketRing> rx_ring_;
+  std::unique_ptr<TdiLocalPacketRing> tx_ring_;
+};
+
+}  // namespace tdi
+}  // namespace hal
+}  // namespace stratum
+
+#endif  // STRATUM_HAL_LIB_TDI_TDI_LOCAL_PACKETIO_H_
@@ -0,0 +1,179 @@
+// Copyright 2024 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+// Benchmark of the local PacketIO. Compares the per-packet cost of the
+// PacketIns received by a co-located agent over the shared memory rings of
+// the local PacketIO and over a loopback P4Runtime StreamChannel.
+
+#include <unistd.h>
+
+#include <atomic>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>  // NOLINT
+
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_format.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
+#include "gflags/gflags.h"
+#include "grpcpp/grpcpp.h"
+#include "p4/v1/p4runtime.grpc.pb.h"
+#include "p4/v1/p4runtime.pb.h"
+#include "stratum/glue/init_google.h"
+#include "stratum/glue/logging.h"
+#include "stratum/glue/net_util/ports.h"
+#include "stratum/glue/status/status.h"
+#include "stratum/glue/status/status_macros.h"
+#include "stratum/hal/lib/tdi/tdi_local_packetio.h"
+
+DEFINE_int32(num_packets, 20000, "Number of PacketIns sent by each run.");
+DEFINE_int32(payload_size, 128, "Payload size of the PacketIns in bytes.");
+DEFINE_uint32(num_slots, 1024, "Number of slots of the local PacketIO rings.");
+DEFINE_uint32(slot_size, 4096,
+              "Size of a slot of the local PacketIO rings in bytes.");
+DEFINE_string(socket_path, "",
+              "Path of the local PacketIO socket. Defaults to a path in /tmp "
+              "unique to this process.");
+
+namespace stratum {
+namespace hal {
+namespace tdi {
+
+const char kUsage[] = R"USAGE(
+Usage: tdi_local_packetio_bench [options]
+  This tool sends the same PacketIn to a co-located agent, first over the local
+  PacketIO and then over a loopback P4Runtime StreamChannel, and reports the
+  per-packet cost of both.
+)USAGE";
+
+// A P4Runtime service which streams the same PacketIn a number of times, the
+// way the P4Service sends the PacketIns to a controller.
+class PacketInStreamService : public ::p4::v1::P4Runtime::Service {
+ public:
+  PacketInStreamService(const ::p4::v1::PacketIn& packet, int num_packets)
+      : packet_(packet), num_packets_(num_packets) {}
+
+  ::grpc::Status StreamChannel(
+      ::grpc::ServerContext* context,
+      ::grpc::ServerReaderWriter<::p4::v1::StreamMessageResponse,
+                                 ::p4::v1::StreamMessageRequest>* stream)
+      override {
+    ::p4::v1::StreamMessageRequest request;
+    if (!stream->Read(&request)) return ::grpc::Status::OK;
+    ::p4::v1::StreamMessageResponse response;
+    *response.mutable_packet() = packet_;
+    for (int i = 0; i < num_packets_; ++i) {
+      if (!stream->Write(response)) break;
+    }
+    return ::grpc::Status::OK;
+  }
+
+ private:
+  const ::p4::v1::PacketIn packet_;
+  const int num_packets_;
+};
+
+// Returns the time the agent takes to receive the PacketIns over the local
+// PacketIO. The endpoint writes in a thread, waiting for the agent instead of
+// dropping when the ring is full, to measure the throughput.
+::util::StatusOr<absl::Duration> TimeLocalPacketio(
+    const ::p4::v1::PacketIn& packet) {
+  const std::string socket_path =
+      FLAGS_socket_path.empty()
+          ? absl::StrCat("/tmp/tdi_local_packetio_bench.", getpid())
+          : FLAGS_socket_path;
+  ASSIGN_OR_RETURN(auto endpoint,
+                   TdiLocalPacketioEndpoint::CreateInstance(
+                       /*device=*/0, socket_path, FLAGS_num_slots,
+                       FLAGS_slot_size, [](const ::p4::v1::PacketOut&) {
+                         return ::util::OkStatus();
+                       }));
+  ASSIGN_OR_RETURN(auto client, TdiLocalPacketioClient::Connect(socket_path));
+  std::atomic<bool> stop(false);
+  const absl::Time start = absl::Now();
+  std::thread writer([&endpoint, &packet, &stop] {
+    for (int i = 0; i < FLAGS_num_packets && !stop; ++i) {
+      while (!endpoint->Write(packet) && !stop) std::this_thread::yield();
+    }
+  });
+  ::util::Status status = ::util::OkStatus();
+  ::p4::v1::PacketIn received;
+  for (int i = 0; i < FLAGS_num_packets && status.ok(); ++i) {
+    status = client->Receive(&received, absl::Seconds(5));
+  }
+  const absl::Duration elapsed = absl::Now() - start;
+  stop = true;
+  writer.join();
+  RETURN_IF_ERROR(status);
+  RETURN_IF_ERROR(endpoint->Shutdown());
+  return elapsed;
+}
+
+// Returns the time a P4Runtime client of a loopback server takes to receive
+// the PacketIns over its StreamChannel.
+::util::StatusOr<absl::Duration> TimeGrpcStream(
+    const ::p4::v1::PacketIn& packet) {
+  PacketInStreamService service(packet, FLAGS_num_packets);
+  const std::string url = absl::StrCat("localhost:", PickUnusedPortOrDie());
+  ::grpc::ServerBuilder builder;
+  builder.AddListeningPort(url, ::grpc::InsecureServerCredentials());
+  builder.RegisterService(&service);
+  std::unique_ptr<::grpc::Server> server = builder.BuildAndStart();
+  RET_CHECK(server != nullptr)
+      << "Failed to start the gRPC server on " << url << ".";
+  auto stub = ::p4::v1::P4Runtime::NewStub(
+      ::grpc::CreateChannel(url, ::grpc::InsecureChannelCredentials()));
+  ::grpc::ClientContext context;
+  auto stream = stub->StreamChannel(&context);
+  const absl::Time start = absl::Now();
+  stream->Write(::p4::v1::StreamMessageRequest());
+  ::p4::v1::StreamMessageResponse response;
+  int num_received = 0;
+  while (num_received < FLAGS_num_packets && stream->Read(&response)) {
+    ++num_received;
+  }
+  const absl::Duration elapsed = absl::Now() - start;
+  stream->WritesDone();
+  ::grpc::Status grpc_status = stream->Finish();
+  server->Shutdown();
+  RET_CHECK(num_received == FLAGS_num_packets)
+      << "Received " << num_received << " of " << FLAGS_num_packets
+      << " PacketIns: " << grpc_status.error_message();
+  return elapsed;
+}
+
+::util::Status Main(int argc, char** argv) {
+  RET_CHECK(FLAGS_num_packets > 0) << "--num_packets must be > 0.";
+  ::p4::v1::PacketIn packet;
+  auto* metadata = packet.add_metadata();
+  metadata->set_metadata_id(1);
+  metadata->set_value(std::string("\x00\x01", 2));
+  packet.set_payload(std::string(FLAGS_payload_size, 'x'));
+
+  ASSIGN_OR_RETURN(const absl::Duration local_time, TimeLocalPacketio(packet));
+  ASSIGN_OR_RETURN(const absl::Duration grpc_time, TimeGrpcStream(packet));
+
+  std::cout << absl::StrFormat(
+      "%d PacketIns of %d bytes\n"
+      "  local PacketIO:        %s per packet\n"
+      "  P4Runtime gRPC stream: %s per packet (%.1fx)\n",
+      FLAGS_num_packets, FLAGS_payload_size,
+      absl::FormatDuration(local_time / FLAGS_num_packets),
+      absl::FormatDuration(grpc_time / FLAGS_num_packets),
+      absl::FDivDuration(grpc_time, local_time));
+
+  return ::util::OkStatus();
+}
+
+}  // namespace tdi
+}  // namespace hal
+}  // namespace stratum
+
+int main(int argc, char** argv) {
+  ::gflags::SetUsageMessage(stratum::hal::tdi::kUsage);
+  InitGoogle(argv[0], &argc, &argv, true);
+  stratum::InitStratumLogging();
+  return stratum::hal::tdi::Main(argc, argv).error_code();
+}
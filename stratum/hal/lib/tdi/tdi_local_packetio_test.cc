@@ -0,0 +1,360 @@
+// Copyright 2024 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#include "stratum/hal/lib/tdi/tdi_local_packetio.h"
+
+#include <unistd.h>
+
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "absl/strings/str_cat.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "stratum/glue/status/status_test_util.h"
+#include "stratum/lib/test_utils/matchers.h"
+#include "stratum/lib/utils.h"
+#include "stratum/public/lib/error.h"
+
+namespace stratum {
+namespace hal {
+namespace tdi {
+
+using test_utils::EqualsProto;
+using test_utils::StatusIs;
+using ::testing::_;
+using ::testing::HasSubstr;
+
+TEST(TdiLocalPacketRingTest, PushAndPopAcrossTheEndOfTheRing) {
+  constexpr uint32 kNumSlots = 4;
+  constexpr uint32 kSlotSize = 64;
+  alignas(64) char memory[4096];
+  ASSERT_LE(TdiLocalPacketRing::MemorySize(kNumSlots, kSlotSize),
+            sizeof(memory));
+  auto producer_or = TdiLocalPacketRing::Create(memory, kNumSlots, kSlotSize);
+  ASSERT_OK(producer_or.status());
+  auto producer = producer_or.ConsumeValueOrDie();
+  auto consumer_or = TdiLocalPacketRing::Attach(memory, sizeof(memory));
+  ASSERT_OK(consumer_or.status());
+  auto consumer = consumer_or.ConsumeValueOrDie();
+
+  absl::string_view record;
+  EXPECT_FALSE(consumer->Front(&record));
+  EXPECT_EQ(nullptr, producer->BeginPush(producer->MaxRecordSize() + 1));
+  for (int i = 0; i < 10; ++i) {
+    const std::string data = absl::StrCat("record ", i);
+    char* buffer = producer->BeginPush(data.size());
+    ASSERT_NE(nullptr, buffer);
+    memcpy(buffer, data.data(), data.size());
+    producer->CommitPush();
+    ASSERT_TRUE(consumer->Front(&record));
+    EXPECT_EQ(data, record);
+    consumer->Pop();
+  }
+
+  // The ring holds as many records as slots.
+  for (uint32 i = 0; i < kNumSlots; ++i) {
+    ASSERT_NE(nullptr, producer->BeginPush(1));
+    producer->CommitPush();
+  }
+  EXPECT_EQ(nullptr, producer->BeginPush(1));
+  consumer->Pop();
+  EXPECT_NE(nullptr, producer->BeginPush(1));
+}
+
+TEST(TdiLocalPacketRingTest, WakeupOnlyWhenTheConsumerWaits) {
+  constexpr uint32 kNumSlots = 4;
+  constexpr uint32 kSlotSize = 64;
+  alignas(64) char memory[4096];
+  auto ring_or = TdiLocalPacketRing::Create(memory, kNumSlots, kSlotSize);
+  ASSERT_OK(ring_or.status());
+  auto ring = ring_or.ConsumeValueOrDie();
+
+  ASSERT_NE(nullptr, ring->BeginPush(1));
+  EXPECT_FALSE(ring->CommitPush());
+  // The ring is not empty, the consumer must not wait.
+  EXPECT_FALSE(ring->ArmWakeup());
+  ring->Pop();
+  EXPECT_TRUE(ring->ArmWakeup());
+  ASSERT_NE(nullptr, ring->BeginPush(1));
+  EXPECT_TRUE(ring->CommitPush());
+  // A single wakeup per wait.
+  ASSERT_NE(nullptr, ring->BeginPush(1));
+  EXPECT_FALSE(ring->CommitPush());
+}
+
+TEST(TdiLocalPacketRingTest, RejectsInvalidRings) {
+  alignas(64) char memory[8192] = {};
+  EXPECT_THAT(TdiLocalPacketRing::Create(memory, 3, 64).status(),
+              StatusIs(StratumErrorSpace(), ERR_INVALID_PARAM,
+                       HasSubstr("not a power of two")));
+  EXPECT_THAT(TdiLocalPacketRing::Create(memory, 4, 60).status(),
+              StatusIs(StratumErrorSpace(), ERR_INVALID_PARAM,
+                       HasSubstr("Invalid slot size")));
+  EXPECT_THAT(TdiLocalPacketRing::Attach(memory, 8192).status(),
+              StatusIs(StratumErrorSpace(), ERR_INVALID_PARAM,
+                       HasSubstr("No ring")));
+  ASSERT_OK(TdiLocalPacketRing::Create(memory, 128, 64).status());
+  EXPECT_THAT(TdiLocalPacketRing::Attach(memory, 8192).status(),
+              StatusIs(StratumErrorSpace(), ERR_INVALID_PARAM,
+                       HasSubstr("overflows a memory region")));
+}
+
+class TdiLocalPacketioTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    socket_path_ = absl::StrCat("/tmp/tdi_local_packetio_test_", getpid(),
+                                ".sock");
+    auto endpoint_or = TdiLocalPacketioEndpoint::CreateInstance(
+        kDevice, socket_path_, kNumSlots, kSlotSize,
+        [this](const ::p4::v1::PacketOut& packet) {
+          absl::MutexLock l(&lock_);
+          transmitted_packets_.push_back(packet);
+          return ::util::OkStatus();
+        });
+    ASSERT_OK(endpoint_or.status());
+    endpoint_ = endpoint_or.ConsumeValueOrDie();
+  }
+
+  void TearDown() override {
+    if (endpoint_) {
+      EXPECT_OK(endpoint_->Shutdown());
+    }
+  }
+
+  std::unique_ptr<TdiLocalPacketioClient> ConnectClient() {
+    auto client_or = TdiLocalPacketioClient::Connect(socket_path_);
+    EXPECT_OK(client_or.status());
+    if (!client_or.ok()) return nullptr;
+    return client_or.ConsumeValueOrDie();
+  }
+
+  // Waits for the endpoint to see the given number of agents.
+  bool WaitForAgents(int num_agents) {
+    const absl::Time deadline = absl::Now() + absl::Seconds(5);
+    while (endpoint_->NumAgents() != num_agents) {
+      if (absl::Now() > deadline) return false;
+      absl::SleepFor(absl::Milliseconds(1));
+    }
+    return true;
+  }
+
+  static ::p4::v1::PacketIn MakePacketIn(int i) {
+    ::p4::v1::PacketIn packet;
+    auto* metadata = packet.add_metadata();
+    metadata->set_metadata_id(1);
+    metadata->set_value(std::string("\x00\x01", 2));
+    metadata = packet.add_metadata();
+    metadata->set_metadata_id(2);
+    metadata->set_value(absl::StrCat(i));
+    packet.set_payload(absl::StrCat("packet ", i));
+    return packet;
+  }
+
+  static constexpr int kDevice = 0;
+  static constexpr uint32 kNumSlots = 16;
+  static constexpr uint32 kSlotSize = 256;
+  std::string socket_path_;
+  std::unique_ptr<TdiLocalPacketioEndpoint> endpoint_;
+  absl::Mutex lock_;
+  std::vector<::p4::v1::PacketOut> transmitted_packets_ GUARDED_BY(lock_);
+};
+
+constexpr int TdiLocalPacketioTest::kDevice;
+constexpr uint32 TdiLocalPacketioTest::kNumSlots;
+constexpr uint32 TdiLocalPacketioTest::kSlotSize;
+
+TEST_F(TdiLocalPacketioTest, AgentsReceivePacketIns) {
+  // Without agents the packets go nowhere.
+  EXPECT_FALSE(endpoint_->Write(MakePacketIn(0)));
+
+  auto client1 = ConnectClient();
+  auto client2 = ConnectClient();
+  ASSERT_NE(nullptr, client1);
+  ASSERT_NE(nullptr, client2);
+  EXPECT_EQ(2, endpoint_->NumAgents());
+  for (int i = 0; i < 3; ++i) EXPECT_TRUE(endpoint_->Write(MakePacketIn(i)));
+  for (auto* client : {client1.get(), client2.get()}) {
+    for (int i = 0; i < 3; ++i) {
+      ::p4::v1::PacketIn packet;
+      ASSERT_OK(client->Receive(&packet, absl::Seconds(5)));
+      EXPECT_THAT(packet, EqualsProto(MakePacketIn(i)));
+    }
+    ::p4::v1::PacketIn packet;
+    EXPECT_THAT(client->Receive(&packet, absl::Milliseconds(10)),
+                StatusIs(StratumErrorSpace(), ERR_ENTRY_NOT_FOUND, _));
+  }
+}
+
+TEST_F(TdiLocalPacketioTest, ReceiveWaitsForPacketIns) {
+  auto client = ConnectClient();
+  ASSERT_NE(nullptr, client);
+  EXPECT_EQ(1, endpoint_->NumAgents());
+  std::thread writer([this] {
+    absl::SleepFor(absl::Milliseconds(50));
+    EXPECT_TRUE(endpoint_->Write(MakePacketIn(1)));
+  });
+  ::p4::v1::PacketIn packet;
+  EXPECT_OK(client->Receive(&packet, absl::InfiniteDuration()));
+  EXPECT_THAT(packet, EqualsProto(MakePacketIn(1)));
+  writer.join();
+}
+
+TEST_F(TdiLocalPacketioTest, DropsPacketInsWhenTheRingIsFull) {
+  auto client = ConnectClient();
+  ASSERT_NE(nullptr, client);
+  EXPECT_EQ(1, endpoint_->NumAgents());
+  for (uint32 i = 0; i < kNumSlots; ++i) {
+    EXPECT_TRUE(endpoint_->Write(MakePacketIn(i)));
+  }
+  EXPECT_FALSE(endpoint_->Write(MakePacketIn(kNumSlots)));
+  ::p4::v1::PacketIn large_packet = MakePacketIn(0);
+  large_packet.set_payload(std::string(kSlotSize, 'x'));
+  EXPECT_FALSE(endpoint_->Write(large_packet));
+
+  ::p4::v1::PacketIn packet;
+  ASSERT_OK(client->Receive(&packet, absl::Seconds(5)));
+  EXPECT_THAT(packet, EqualsProto(MakePacketIn(0)));
+  EXPECT_TRUE(endpoint_->Write(MakePacketIn(0)));
+}
+
+TEST_F(TdiLocalPacketioTest, AgentsTransmitPacketOuts) {
+  auto client = ConnectClient();
+  ASSERT_NE(nullptr, client);
+  constexpr int kNumPackets = 100;
+  std::vector<::p4::v1::PacketOut> expected;
+  for (int i = 0; i < kNumPackets; ++i) {
+    ::p4::v1::PacketOut packet;
+    auto* metadata = packet.add_metadata();
+    metadata->set_metadata_id(1);
+    metadata->set_value(absl::StrCat(i));
+    packet.set_payload(absl::StrCat("packet ", i));
+    // Retries until the endpoint drains the ring.
+    ::util::Status status;
+    while ((status = client->Send(packet)).error_code() == ERR_NO_RESOURCE) {
+      absl::SleepFor(absl::Milliseconds(1));
+    }
+    ASSERT_OK(status);
+    expected.push_back(packet);
+  }
+  absl::MutexLock l(&lock_);
+  lock_.AwaitWithTimeout(absl::Condition(
+                             +[](std::vector<::p4::v1::PacketOut>* packets) {
+                               return packets->size() == kNumPackets;
+                             },
+                             &transmitted_packets_),
+                         absl::Seconds(5));
+  ASSERT_EQ(expected.size(), transmitted_packets_.size());
+  for (int i = 0; i < kNumPackets; ++i) {
+    EXPECT_THAT(transmitted_packets_[i], EqualsProto(expected[i]));
+  }
+
+  ::p4::v1::PacketOut large_packet;
+  large_packet.set_payload(std::string(kSlotSize, 'x'));
+  EXPECT_THAT(client->Send(large_packet),
+              StatusIs(StratumErrorSpace(), ERR_INVALID_PARAM,
+                       HasSubstr("doesn't fit")));
+}
+
+TEST_F(TdiLocalPacketioTest, DisconnectedAgentsAreRemoved) {
+  auto client = ConnectClient();
+  ASSERT_NE(nullptr, client);
+  EXPECT_EQ(1, endpoint_->NumAgents());
+  client.reset();
+  EXPECT_TRUE(WaitForAgents(0));
+  EXPECT_FALSE(endpoint_->Write(MakePacketIn(0)));
+}
+
+TEST_F(TdiLocalPacketioTest, ReceiveIsCancelledByShutdown) {
+  auto client = ConnectClient();
+  ASSERT_NE(nullptr, client);
+  EXPECT_EQ(1, endpoint_->NumAgents());
+  EXPECT_TRUE(endpoint_->Write(MakePacketIn(0)));
+  EXPECT_OK(endpoint_->Shutdown());
+  // The queued packet is still received.
+  ::p4::v1::PacketIn packet;
+  EXPECT_OK(client->Receive(&packet, absl::Seconds(5)));
+  EXPECT_THAT(client->Receive(&packet, absl::Seconds(5)),
+              StatusIs(StratumErrorSpace(), ERR_CANCELLED, _));
+  EXPECT_FALSE(TdiLocalPacketioClient::Connect(socket_path_).ok());
+}
+
+TEST_F(TdiLocalPacketioTest, RejectsInvalidParameters) {
+  auto noop = [](const ::p4::v1::PacketOut&) { return ::util::OkStatus(); };
+  EXPECT_FALSE(TdiLocalPacketioEndpoint::CreateInstance(
+                   kDevice, socket_path_ + ".1", 3, kSlotSize, noop)
+                   .ok());
+  EXPECT_FALSE(TdiLocalPacketioEndpoint::CreateInstance(
+                   kDevice, std::string(200, 'x'), kNumSlots, kSlotSize, noop)
+                   .ok());
+  EXPECT_FALSE(TdiLocalPacketioClient::Connect(socket_path_ + ".none").ok());
+}
+
+TEST_F(TdiLocalPacketioTest, FloodingAgentDoesNotStarveTheEndpoint) {
+  // An agent which queues a new PacketOut for every transmitted one, so its
+  // ring is never empty.
+  const std::string socket_path = socket_path_ + ".flood";
+  TdiLocalPacketioClient* flooding_client = nullptr;
+  absl::Mutex lock;
+  int num_flooding_packets = 0;
+  std::vector<::p4::v1::PacketOut> other_packets;
+  auto endpoint_or = TdiLocalPacketioEndpoint::CreateInstance(
+      kDevice, socket_path, kNumSlots, kSlotSize,
+      [&](const ::p4::v1::PacketOut& packet) {
+        if (packet.payload() == "flood") {
+          flooding_client->Send(packet).IgnoreError();
+          absl::MutexLock l(&lock);
+          ++num_flooding_packets;
+        } else {
+          absl::MutexLock l(&lock);
+          other_packets.push_back(packet);
+        }
+        return ::util::OkStatus();
+      });
+  ASSERT_OK(endpoint_or.status());
+  auto endpoint = endpoint_or.ConsumeValueOrDie();
+  auto client_or = TdiLocalPacketioClient::Connect(socket_path);
+  ASSERT_OK(client_or.status());
+  auto client = client_or.ConsumeValueOrDie();
+  flooding_client = client.get();
+  ::p4::v1::PacketOut packet;
+  packet.set_payload("flood");
+  ASSERT_OK(client->Send(packet));
+  {
+    absl::MutexLock l(&lock);
+    ASSERT_TRUE(lock.AwaitWithTimeout(
+        absl::Condition(
+            +[](int* n) { return *n > static_cast<int>(kNumSlots) * 4; },
+            &num_flooding_packets),
+        absl::Seconds(5)));
+  }
+
+  // A new agent is still accepted and its PacketOuts are transmitted.
+  client_or = TdiLocalPacketioClient::Connect(socket_path);
+  ASSERT_OK(client_or.status());
+  auto other_client = client_or.ConsumeValueOrDie();
+  packet.set_payload("other");
+  ASSERT_OK(other_client->Send(packet));
+  {
+    absl::MutexLock l(&lock);
+    ASSERT_TRUE(lock.AwaitWithTimeout(
+        absl::Condition(
+            +[](std::vector<::p4::v1::PacketOut>* packets) {
+              return !packets->empty();
+            },
+            &other_packets),
+        absl::Seconds(5)));
+    EXPECT_THAT(other_packets[0], EqualsProto(packet));
+  }
+
+  // The endpoint still stops while the agent floods it.
+  EXPECT_OK(endpoint->Shutdown());
+}
+
+}  // namespace tdi
+}  // namespace hal
+}  // namespace stratum
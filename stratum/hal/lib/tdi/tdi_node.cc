@@ -10,7 +10,11 @@
 #include <string>
 #include <utility>
 
+#include "absl/container/flat_hash_map.h"
 #include "absl/memory/memory.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
+#include "stratum/glue/gtl/map_util.h"
 #include "stratum/glue/status/status_macros.h"
 #include "stratum/hal/lib/common/proto_oneof_writer_wrapper.h"
 #include "stratum/hal/lib/common/writer_interface.h"
@@ -18,6 +22,7 @@
 #include "stratum/hal/lib/tdi/tdi_pipeline_utils.h"
 #include "stratum/hal/lib/tdi/tdi_sde_interface.h"
 #include "stratum/lib/macros.h"
+#include "stratum/lib/metrics.h"
 #include "stratum/lib/utils.h"
 #include "stratum/public/proto/error.pb.h"
 
@@ -25,6 +30,43 @@ namespace stratum {
 namespace hal {
 namespace tdi {
 
+namespace {
+
+// Returns the histogram of the time spent waiting for the node lock by the
+// given operation.
+LatencyHistogram* LockWaitHistogram(const std::string& operation) {
+  return MetricRegistry::GetInstance()->GetHistogram(
+      "stratum_tdi_node_lock_wait_seconds",
+      "Time spent waiting for the TDI node lock.",
+      {{"operation", operation}});
+}
+
+// Returns the write latency histogram of the given entity type, or nullptr
+// for an unknown entity type.
+LatencyHistogram* EntityWriteLatencyHistogram(
+    ::p4::v1::Entity::EntityCase entity_case) {
+  // The histograms of all the entity types are looked up once, so that the
+  // write path does not go through the registry.
+  static const auto* histograms = []() {
+    auto* histograms = new absl::flat_hash_map<int, LatencyHistogram*>();
+    const auto* oneof =
+        ::p4::v1::Entity::descriptor()->FindOneofByName("entity");
+    for (int i = 0; i < oneof->field_count(); ++i) {
+      const auto* field = oneof->field(i);
+      (*histograms)[field->number()] =
+          MetricRegistry::GetInstance()->GetHistogram(
+              "stratum_tdi_entity_write_latency_seconds",
+              "Latency of the P4Runtime entity writes on the TDI node.",
+              {{"entity", field->name()}});
+    }
+    return histograms;
+  }();
+  auto* histogram = gtl::FindOrNull(*histograms, entity_case);
+  return histogram == nullptr ? nullptr : *histogram;
+}
+
+}  // namespace
+
 TdiNode::TdiNode(TdiTableManager* tdi_table_manager,
                  TdiActionProfileManager* tdi_action_profile_manager,
                  TdiPacketioManager* tdi_packetio_manager,
@@ -140,7 +182,9 @@ std::unique_ptr<TdiNode> TdiNode::CreateInstance(
   }
   RET_CHECK(tdi_config_.programs_size() > 0);
 
-  // Calling AddDevice() overwrites any previous pipeline.
+  // Calling AddDevice() overwrites any previous pipeline. The table IDs known
+  // to the counter sync thread are stale from here on.
+  tdi_table_manager_->StopBackgroundCounterSync();
   RETURN_IF_ERROR(tdi_sde_interface_->AddDevice(device_id_, tdi_config_));
 
   // Push pipeline config to the managers.
@@ -191,7 +235,10 @@ std::unique_ptr<TdiNode> TdiNode::CreateInstance(
 
 ::util::Status TdiNode::WriteForwardingEntries(
     const ::p4::v1::WriteRequest& req, std::vector<::util::Status>* results) {
+  static LatencyHistogram* lock_wait = LockWaitHistogram("write");
+  const absl::Time lock_start_time = absl::Now();
   absl::WriterMutexLock l(&lock_);
+  lock_wait->Record(absl::Now() - lock_start_time);
   RET_CHECK(req.device_id() == node_id_)
       << "Request device id must be same as id of this TdiNode.";
   RET_CHECK(req.atomicity() == ::p4::v1::WriteRequest::CONTINUE_ON_ERROR)
@@ -207,6 +254,8 @@ std::unique_ptr<TdiNode> TdiNode::CreateInstance(
   RETURN_IF_ERROR(session->BeginBatch());
   for (const auto& update : req.updates()) {
     ::util::Status status = ::util::OkStatus();
+    ScopedLatencyRecorder latency_recorder(
+        EntityWriteLatencyHistogram(update.entity().entity_case()));
     switch (update.entity().entity_case()) {
       case ::p4::v1::Entity::kTableEntry:
         status = tdi_table_manager_->WriteTableEntry(
@@ -280,7 +329,10 @@ std::unique_ptr<TdiNode> TdiNode::CreateInstance(
   RET_CHECK(writer) << "Channel writer must be non-null.";
   RET_CHECK(details) << "Details pointer must be non-null.";
 
+  static LatencyHistogram* lock_wait = LockWaitHistogram("read");
+  const absl::Time lock_start_time = absl::Now();
   absl::ReaderMutexLock l(&lock_);
+  lock_wait->Record(absl::Now() - lock_start_time);
   RET_CHECK(req.device_id() == node_id_)
       << "Request device id must be same as id of this TdiNode.";
   if (!initialized_ || !pipeline_initialized_) {
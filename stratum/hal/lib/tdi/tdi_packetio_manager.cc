@@ -12,14 +12,29 @@
 
 #include <deque>
 #include <string>
+#include <utility>
 
 #include "absl/cleanup/cleanup.h"
+#include "absl/strings/str_cat.h"
+#include "gflags/gflags.h"
 #include "stratum/glue/gtl/map_util.h"
 #include "stratum/hal/lib/common/constants.h"
 #include "stratum/hal/lib/p4/utils.h"
 #include "stratum/hal/lib/tdi/tdi_sde_flags.h"
 #include "stratum/lib/utils.h"
 
+DEFINE_string(tdi_local_packetio_socket, "",
+              "Path of the Unix socket on which the PacketIO of device 0 is "
+              "exported to the agents on the same host, through shared "
+              "memory. The device number is appended to the path for the "
+              "other devices, e.g. <path>.1. Empty to disable.");
+DEFINE_int32(tdi_local_packetio_ring_slots, 1024,
+             "Number of packets in each ring of a local PacketIO agent. Must "
+             "be a power of two.");
+DEFINE_int32(tdi_local_packetio_slot_size, 4096,
+             "Size in bytes of the slots of the local PacketIO rings. Bounds "
+             "the size of a packet and its metadata.");
+
 namespace stratum {
 namespace hal {
 namespace tdi {
@@ -34,6 +49,9 @@ TdiPacketioManager::TdiPacketioManager(TdiSdeInterface* tdi_sde_interface,
       packetout_header_size_(),
       packet_receive_channel_(nullptr),
       sde_rx_thread_id_(),
+      punt_dispatch_thread_id_(),
+      punt_scheduler_(TdiPuntScheduler::CreateInstance(device)),
+      local_packetio_endpoint_(nullptr),
       tdi_sde_interface_(ABSL_DIE_IF_NULL(tdi_sde_interface)),
       device_(device) {}
 
@@ -46,6 +64,11 @@ std::unique_ptr<TdiPacketioManager> TdiPacketioManager::CreateInstance(
 
 ::util::Status TdiPacketioManager::PushChassisConfig(
     const ChassisConfig& config, uint64 node_id) {
+  const auto* punt_config = gtl::FindOrNull(
+      config.vendor_config().tdi_config().node_id_to_punt_config(), node_id);
+  RETURN_IF_ERROR(punt_scheduler_->PushConfig(
+      punt_config ? *punt_config : TdiConfig::PuntConfig()));
+
   return ::util::OkStatus();
 }
 
@@ -60,6 +83,29 @@ std::unique_ptr<TdiPacketioManager> TdiPacketioManager::CreateInstance(
     RETURN_IF_ERROR(tdi_sde_interface_->StartPacketIo(device_));
     if (!initialized_) {
       packet_receive_channel_ = Channel<std::string>::Create(128);
+      punt_scheduler_->Start();
+      if (!FLAGS_tdi_local_packetio_socket.empty()) {
+        std::string socket_path = FLAGS_tdi_local_packetio_socket;
+        if (device_ != 0) absl::StrAppend(&socket_path, ".", device_);
+        ASSIGN_OR_RETURN(
+            local_packetio_endpoint_,
+            TdiLocalPacketioEndpoint::CreateInstance(
+                device_, socket_path, FLAGS_tdi_local_packetio_ring_slots,
+                FLAGS_tdi_local_packetio_slot_size,
+                [this](const ::p4::v1::PacketOut& packet) {
+                  return TransmitPacket(packet);
+                }));
+      }
+      if (punt_dispatch_thread_id_ == 0) {
+        int ret = pthread_create(&punt_dispatch_thread_id_, nullptr,
+                                 &TdiPacketioManager::PuntDispatchThreadFunc,
+                                 this);
+        if (ret != 0) {
+          return MAKE_ERROR(ERR_INTERNAL)
+                 << "Failed to spawn punt dispatch thread for device with ID "
+                 << device_ << ". Err: " << ret << ".";
+        }
+      }
       if (sde_rx_thread_id_ == 0) {
         int ret = pthread_create(&sde_rx_thread_id_, nullptr,
                                  &TdiPacketioManager::SdeRxThreadFunc, this);
@@ -81,6 +127,12 @@ std::unique_ptr<TdiPacketioManager> TdiPacketioManager::CreateInstance(
 
 ::util::Status TdiPacketioManager::VerifyChassisConfig(
     const ChassisConfig& config, uint64 node_id) {
+  const auto* punt_config = gtl::FindOrNull(
+      config.vendor_config().tdi_config().node_id_to_punt_config(), node_id);
+  if (punt_config) {
+    RETURN_IF_ERROR(TdiPuntScheduler::VerifyConfig(*punt_config));
+  }
+
   return ::util::OkStatus();
 }
 
@@ -90,6 +142,16 @@ std::unique_ptr<TdiPacketioManager> TdiPacketioManager::CreateInstance(
     absl::WriterMutexLock l(&rx_writer_lock_);
     rx_writer_ = nullptr;
   }
+  // The local PacketIO endpoint transmits packets with the data lock held as
+  // reader, so it is shut down without holding the lock.
+  std::unique_ptr<TdiLocalPacketioEndpoint> local_packetio_endpoint;
+  {
+    absl::WriterMutexLock l(&data_lock_);
+    local_packetio_endpoint = std::move(local_packetio_endpoint_);
+  }
+  if (local_packetio_endpoint) {
+    APPEND_STATUS_IF_ERROR(status, local_packetio_endpoint->Shutdown());
+  }
   {
     absl::WriterMutexLock l(&data_lock_);
     if (initialized_) {
@@ -109,6 +171,8 @@ std::unique_ptr<TdiPacketioManager> TdiPacketioManager::CreateInstance(
     packet_receive_channel_.reset();
     initialized_ = false;
   }
+  // Wakes up the punt dispatch thread.
+  punt_scheduler_->Stop();
   // TODO(max): we release the locks between closing the channel and joining the
   // thread to prevent deadlocks with the RX handler. But there might still be a
   // bug hiding here.
@@ -120,10 +184,18 @@ std::unique_ptr<TdiPacketioManager> TdiPacketioManager::CreateInstance(
                              << "Failed to join thread " << sde_rx_thread_id_;
       APPEND_STATUS_IF_ERROR(status, error);
     }
+    if (punt_dispatch_thread_id_ != 0 &&
+        pthread_join(punt_dispatch_thread_id_, nullptr) != 0) {
+      ::util::Status error = MAKE_ERROR(ERR_INTERNAL)
+                             << "Failed to join thread "
+                             << punt_dispatch_thread_id_;
+      APPEND_STATUS_IF_ERROR(status, error);
+    }
   }
   {
     absl::WriterMutexLock l(&data_lock_);
     sde_rx_thread_id_ = 0;
+    punt_dispatch_thread_id_ = 0;
   }
   return ::util::OkStatus();
 }
@@ -313,14 +385,29 @@ class BitBuffer {
     // FIXME: returning here in case of parsing errors might not be the best
     // solution.
     RETURN_IF_ERROR(ParsePacketIn(buffer, &packet_in));
+    // The scheduler counts the dropped packets.
+    punt_scheduler_->Enqueue(std::move(packet_in));
+  }
+
+  return ::util::OkStatus();
+}
+
+void TdiPacketioManager::HandlePuntDispatch() {
+  ::p4::v1::PacketIn packet_in;
+  while (punt_scheduler_->Dequeue(&packet_in)) {
+    {
+      absl::ReaderMutexLock l(&data_lock_);
+      if (local_packetio_endpoint_ != nullptr) {
+        local_packetio_endpoint_->Write(packet_in);
+      }
+    }
     {
       absl::WriterMutexLock l(&rx_writer_lock_);
+      if (rx_writer_ == nullptr) continue;
       rx_writer_->Write(packet_in);
     }
     VLOG(1) << "Handled PacketIn: " << packet_in.ShortDebugString();
   }
-
-  return ::util::OkStatus();
 }
 
 // This function is based on P4TableMapper and implements a subset of its
@@ -376,6 +463,13 @@ void* TdiPacketioManager::SdeRxThreadFunc(void* arg) {
   return nullptr;
 }
 
+void* TdiPacketioManager::PuntDispatchThreadFunc(void* arg) {
+  TdiPacketioManager* mgr = reinterpret_cast<TdiPacketioManager*>(arg);
+  mgr->HandlePuntDispatch();
+
+  return nullptr;
+}
+
 }  // namespace tdi
 }  // namespace hal
 }  // namespace stratum
@@ -19,6 +19,8 @@
 #include "stratum/hal/lib/common/common.pb.h"
 #include "stratum/hal/lib/common/writer_interface.h"
 #include "stratum/hal/lib/tdi/tdi.pb.h"
+#include "stratum/hal/lib/tdi/tdi_local_packetio.h"
+#include "stratum/hal/lib/tdi/tdi_punt_scheduler.h"
 #include "stratum/hal/lib/tdi/tdi_sde_interface.h"
 #include "stratum/lib/utils.h"
 
@@ -98,13 +100,19 @@ class TdiPacketioManager {
                                ::p4::v1::PacketIn* packet)
       LOCKS_EXCLUDED(data_lock_);
 
-  // Handles a received packets and hands it over the registered receive writer.
-  ::util::Status HandleSdePacketRx()
-      LOCKS_EXCLUDED(data_lock_, rx_writer_lock_);
+  // Handles the received packets and hands them over to the punt scheduler.
+  ::util::Status HandleSdePacketRx() LOCKS_EXCLUDED(data_lock_);
+
+  // Hands the packets of the punt scheduler over to the local PacketIO agents
+  // and to the registered receive writer, in priority order.
+  void HandlePuntDispatch() LOCKS_EXCLUDED(rx_writer_lock_);
 
   // SDE cpu interface RX thread function.
   static void* SdeRxThreadFunc(void* arg);
 
+  // Punt dispatch thread function.
+  static void* PuntDispatchThreadFunc(void* arg);
+
   // Mutex lock for protecting rx_writer_.
   mutable absl::Mutex rx_writer_lock_;
 
@@ -132,6 +140,18 @@ class TdiPacketioManager {
   // The ID of the RX thread which handles receiving packets from the SDE.
   pthread_t sde_rx_thread_id_ GUARDED_BY(data_lock_);
 
+  // The ID of the thread which dispatches the packets of the punt scheduler.
+  pthread_t punt_dispatch_thread_id_ GUARDED_BY(data_lock_);
+
+  // Classifies, polices and queues the received packets before they are sent
+  // to the controller, as given by the punt config of the node.
+  std::unique_ptr<TdiPuntScheduler> punt_scheduler_;
+
+  // Exports the PacketIO to the agents on the same host, if enabled by the
+  // --tdi_local_packetio_socket flag.
+  std::unique_ptr<TdiLocalPacketioEndpoint> local_packetio_endpoint_
+      GUARDED_BY(data_lock_);
+
   // Pointer to a TdiSdeInterface implementation that wraps all the SDE calls.
   TdiSdeInterface* tdi_sde_interface_ = nullptr;  // not owned by this class.
 
@@ -6,7 +6,11 @@
 
 #include "stratum/hal/lib/tdi/tdi_packetio_manager.h"
 
+#include <unistd.h>
+
+#include "absl/cleanup/cleanup.h"
 #include "absl/memory/memory.h"
+#include "absl/strings/str_cat.h"
 #include "absl/synchronization/notification.h"
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
@@ -17,6 +21,8 @@
 #include "stratum/lib/test_utils/matchers.h"
 #include "stratum/lib/utils.h"
 
+DECLARE_string(tdi_local_packetio_socket);
+
 namespace stratum {
 namespace hal {
 namespace tdi {
@@ -148,10 +154,50 @@ class TdiPacketioManagerTest : public ::testing::Test {
 constexpr int TdiPacketioManagerTest::kDevice1;
 constexpr char TdiPacketioManagerTest::kP4Info[];
 
-// TODO(Yi Tseng): These two methods will always return OK status
-// We can add tests for these methods if we modify them.
-// TEST_F(TdiPacketioManagerTest, PushChassisConfig) {}
-// TEST_F(TdiPacketioManagerTest, VerifyChassisConfig) {}
+TEST_F(TdiPacketioManagerTest, PushAndVerifyChassisConfigWithPuntConfig) {
+  const uint64 kNodeId = 1;
+  ChassisConfig config;
+  EXPECT_OK(tdi_packetio_manager_->VerifyChassisConfig(config, kNodeId));
+  EXPECT_OK(tdi_packetio_manager_->PushChassisConfig(config, kNodeId));
+
+  const char punt_config_str[] = R"pb(
+    vendor_config {
+      tdi_config {
+        node_id_to_punt_config {
+          key: 1
+          value {
+            punt_classes {
+              name: "lldp"
+              priority: 7
+              ether_type: 0x88cc
+            }
+            punt_classes {
+              name: "arp"
+              priority: 1
+              ether_type: 0x0806
+              max_rate_pps: 100
+            }
+          }
+        }
+      }
+    }
+  )pb";
+  ASSERT_OK(ParseProtoFromString(punt_config_str, &config));
+  EXPECT_OK(tdi_packetio_manager_->VerifyChassisConfig(config, kNodeId));
+  EXPECT_OK(tdi_packetio_manager_->PushChassisConfig(config, kNodeId));
+
+  // A class without match field is rejected.
+  auto* punt_config = &(*config.mutable_vendor_config()
+                             ->mutable_tdi_config()
+                             ->mutable_node_id_to_punt_config())[kNodeId];
+  punt_config->add_punt_classes()->set_name("any");
+  EXPECT_THAT(tdi_packetio_manager_->VerifyChassisConfig(config, kNodeId),
+              StatusIs(StratumErrorSpace(), ERR_INVALID_PARAM,
+                       HasSubstr("has no match field")));
+  EXPECT_FALSE(tdi_packetio_manager_->PushChassisConfig(config, kNodeId).ok());
+  // The config of other nodes is ignored.
+  EXPECT_OK(tdi_packetio_manager_->VerifyChassisConfig(config, kNodeId + 1));
+}
 
 // Basic set up and shutdown test.
 TEST_F(TdiPacketioManagerTest, PushForwardingPipelineConfigAndShutdown) {
@@ -345,6 +391,79 @@ TEST_F(TdiPacketioManagerTest, TestPacketIn) {
   EXPECT_OK(Shutdown());
 }
 
+TEST_F(TdiPacketioManagerTest, LocalPacketioAgentReceivesAndTransmits) {
+  const std::string socket_path =
+      absl::StrCat("/tmp/tdi_packetio_manager_test_", getpid(), ".sock");
+  FLAGS_tdi_local_packetio_socket = socket_path;
+  auto flag_resetter =
+      absl::MakeCleanup([] { FLAGS_tdi_local_packetio_socket = ""; });
+  EXPECT_OK(PushPipelineConfig());
+  auto client_or = TdiLocalPacketioClient::Connect(socket_path);
+  ASSERT_OK(client_or.status());
+  auto client = client_or.ConsumeValueOrDie();
+
+  // The PacketIns go to the agent even without controller.
+  const char expected_packet_in_str[] = R"pb(
+    payload: "abcde"
+    metadata {
+      metadata_id: 1
+      value: "\000\001"
+    }
+    metadata {
+      metadata_id: 2
+      value: "\000"
+    }
+  )pb";
+  ::p4::v1::PacketIn expected_packet_in;
+  EXPECT_OK(ParseProtoFromString(expected_packet_in_str, &expected_packet_in));
+  const std::string packet_from_asic(
+      "\0\x80"
+      "abcde",
+      7);
+  EXPECT_OK(packet_rx_writer->Write(packet_from_asic, absl::Milliseconds(100)));
+  ::p4::v1::PacketIn packet_in;
+  ASSERT_OK(client->Receive(&packet_in, absl::Seconds(5)));
+  EXPECT_THAT(packet_in, EqualsProto(expected_packet_in));
+
+  // The PacketOuts of the agent are deparsed and transmitted.
+  const char packet_out_str[] = R"pb(
+    payload: "abcde"
+    metadata {
+      metadata_id: 1
+      value: "\x1"
+    }
+    metadata {
+      metadata_id: 2
+      value: "\x0"
+    }
+    metadata {
+      metadata_id: 3
+      value: "\x0"
+    }
+    metadata {
+      metadata_id: 4
+      value: "\xbf\x01"
+    }
+  )pb";
+  ::p4::v1::PacketOut packet_out;
+  EXPECT_OK(ParseProtoFromString(packet_out_str, &packet_out));
+  const std::string expected_packet(
+      "\0\x80\0\0\0\0\0\0\0\0\0\0\xBF\x1"
+      "abcde",
+      19);
+  absl::Notification transmitted;
+  EXPECT_CALL(*tdi_sde_wrapper_mock_, TxPacket(kDevice1, expected_packet))
+      .WillOnce(
+          DoAll(InvokeWithoutArgs([&transmitted] { transmitted.Notify(); }),
+                Return(::util::OkStatus())));
+  EXPECT_OK(client->Send(packet_out));
+  EXPECT_TRUE(transmitted.WaitForNotificationWithTimeout(absl::Seconds(5)));
+
+  EXPECT_OK(Shutdown());
+  EXPECT_THAT(client->Receive(&packet_in, absl::Seconds(5)),
+              StatusIs(StratumErrorSpace(), ERR_CANCELLED, _));
+}
+
 }  // namespace tdi
 }  // namespace hal
 }  // namespace stratum
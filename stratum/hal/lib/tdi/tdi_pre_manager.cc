@@ -5,7 +5,9 @@
 #include "stratum/hal/lib/tdi/tdi_pre_manager.h"
 
 #include <algorithm>
+#include <map>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "absl/container/flat_hash_map.h"
@@ -25,6 +27,8 @@ TdiPreManager::TdiPreManager(TdiSdeInterface* tdi_sde_interface, int device)
 ::util::Status TdiPreManager::PushForwardingPipelineConfig(
     const TdiDeviceConfig& config) {
   absl::WriterMutexLock l(&lock_);
+  // The node index is rebuilt from the SDE state on the next modify.
+  multicast_groups_.clear();
   return ::util::OkStatus();
 }
 
@@ -72,32 +76,90 @@ std::unique_ptr<TdiPreManager> TdiPreManager::CreateInstance(
   return absl::WrapUnique(new TdiPreManager(tdi_sde_interface, device));
 }
 
-::util::StatusOr<std::vector<uint32>> TdiPreManager::InsertMulticastNodes(
+namespace {
+
+// Returns the IDs of the given multicast nodes.
+template <typename T>
+std::vector<uint32> MulticastNodeIds(const T& nodes) {
+  std::vector<uint32> node_ids;
+  node_ids.reserve(nodes.size());
+  for (const auto& e : nodes) node_ids.push_back(e.second.node_id);
+  return node_ids;
+}
+
+}  // namespace
+
+::util::Status TdiPreManager::InsertMulticastNodes(
     std::shared_ptr<TdiSdeInterface::SessionInterface> session,
-    const ::p4::v1::MulticastGroupEntry& entry) {
+    const MulticastGroupNodes& current_nodes,
+    const ::p4::v1::MulticastGroupEntry& entry, MulticastGroupNodes* new_nodes,
+    std::vector<uint32>* stale_node_ids) {
   const uint32 group_id = entry.multicast_group_id();
   RET_CHECK(group_id <= kMaxMulticastGroupId);
 
   // Collect instance (rid) -> egress ports mapping
-  absl::flat_hash_map<uint32, std::vector<uint32>> instance_to_egress_ports;
+  std::map<uint32, std::vector<uint32>> instance_to_egress_ports;
   for (const auto& replica : entry.replicas()) {
     RET_CHECK(replica.instance() <= UINT16_MAX);
     instance_to_egress_ports[replica.instance()].push_back(
         replica.egress_port());
   }
-  std::vector<uint32> new_nodes = {};
+  new_nodes->clear();
   // FIXME: We need to revert partial modifications in case of failures.
-  for (const auto& replica : instance_to_egress_ports) {
+  for (auto& replica : instance_to_egress_ports) {
     const uint32 instance = replica.first;
-    const std::vector<uint32>& egress_ports = replica.second;
+    std::vector<uint32>& egress_ports = replica.second;
+    std::sort(egress_ports.begin(), egress_ports.end());
+    const MulticastNode* current = gtl::FindOrNull(current_nodes, instance);
+    if (current != nullptr && current->egress_ports == egress_ports) {
+      (*new_nodes)[instance] = *current;
+      continue;
+    }
     std::vector<uint32> mc_lag_ids;
     ASSIGN_OR_RETURN(uint32 mc_node_id,
                      tdi_sde_interface_->CreateMulticastNode(
                          device_, session, instance, mc_lag_ids, egress_ports));
-    new_nodes.push_back(mc_node_id);
+    (*new_nodes)[instance] = MulticastNode{mc_node_id, egress_ports};
+  }
+  for (const auto& e : current_nodes) {
+    const MulticastNode* node = gtl::FindOrNull(*new_nodes, e.first);
+    if (node == nullptr || node->node_id != e.second.node_id) {
+      stale_node_ids->push_back(e.second.node_id);
+    }
   }
 
-  return new_nodes;
+  return ::util::OkStatus();
+}
+
+::util::StatusOr<TdiPreManager::MulticastGroupNodes>
+TdiPreManager::GetMulticastGroupNodes(
+    std::shared_ptr<TdiSdeInterface::SessionInterface> session,
+    uint32 group_id, std::vector<uint32>* other_node_ids) {
+  const MulticastGroupNodes* known =
+      gtl::FindOrNull(multicast_groups_, group_id);
+  if (known != nullptr) return *known;
+
+  // The group was not written through this manager, read its nodes back.
+  ASSIGN_OR_RETURN(
+      auto node_ids,
+      tdi_sde_interface_->GetNodesInMulticastGroup(device_, session, group_id));
+  MulticastGroupNodes nodes;
+  for (const auto& node_id : node_ids) {
+    int replication_id;
+    std::vector<uint32> lag_ids;
+    std::vector<uint32> ports;
+    RETURN_IF_ERROR(tdi_sde_interface_->GetMulticastNode(
+        device_, session, node_id, &replication_id, &lag_ids, &ports));
+    // Nodes with LAG members or sharing an instance are never reused.
+    if (!lag_ids.empty() || nodes.count(replication_id)) {
+      other_node_ids->push_back(node_id);
+      continue;
+    }
+    std::sort(ports.begin(), ports.end());
+    nodes[replication_id] = MulticastNode{node_id, ports};
+  }
+
+  return nodes;
 }
 
 // FIXME: We need to revert partial modifications in case of failures.
@@ -107,47 +169,67 @@ std::unique_ptr<TdiPreManager> TdiPreManager::CreateInstance(
     const ::p4::v1::MulticastGroupEntry& entry) {
   VLOG(1) << ::p4::v1::Update_Type_Name(type) << " "
           << entry.ShortDebugString();
-  ::util::Status status;
+  const uint32 group_id = entry.multicast_group_id();
   switch (type) {
     case ::p4::v1::Update::INSERT: {
-      ASSIGN_OR_RETURN(std::vector<uint32> mc_node_ids,
-                       InsertMulticastNodes(session, entry));
+      MulticastGroupNodes nodes;
+      std::vector<uint32> stale_node_ids;
+      RETURN_IF_ERROR(InsertMulticastNodes(session, MulticastGroupNodes(),
+                                           entry, &nodes, &stale_node_ids));
       RETURN_IF_ERROR(tdi_sde_interface_->InsertMulticastGroup(
-          device_, session, entry.multicast_group_id(), mc_node_ids));
+          device_, session, group_id, MulticastNodeIds(nodes)));
+      multicast_groups_[group_id] = std::move(nodes);
       break;
     }
     case ::p4::v1::Update::MODIFY: {
-      ASSIGN_OR_RETURN(auto current_node_ids,
-                       tdi_sde_interface_->GetNodesInMulticastGroup(
-                           device_, session, entry.multicast_group_id()));
-      ASSIGN_OR_RETURN(std::vector<uint32> new_node_ids,
-                       InsertMulticastNodes(session, entry));
+      std::vector<uint32> stale_node_ids;
+      ASSIGN_OR_RETURN(
+          MulticastGroupNodes current_nodes,
+          GetMulticastGroupNodes(session, group_id, &stale_node_ids));
+      MulticastGroupNodes new_nodes;
+      RETURN_IF_ERROR(InsertMulticastNodes(session, current_nodes, entry,
+                                           &new_nodes, &stale_node_ids));
+      // Only the nodes of the changed instances are replaced.
+      if (stale_node_ids.empty() && new_nodes.size() == current_nodes.size()) {
+        multicast_groups_[group_id] = std::move(new_nodes);
+        break;
+      }
       RETURN_IF_ERROR_WITH_APPEND(
           tdi_sde_interface_->ModifyMulticastGroup(
-              device_, session, entry.multicast_group_id(), new_node_ids))
+              device_, session, group_id, MulticastNodeIds(new_nodes)))
               .with_logging()
           << "Failed to write multicast group for request "
           << entry.ShortDebugString() << ".";
-      RETURN_IF_ERROR_WITH_APPEND(tdi_sde_interface_->DeleteMulticastNodes(
-                                      device_, session, current_node_ids))
-              .with_logging()
-          << "Failed to delete multicast nodes for request "
-          << entry.ShortDebugString() << ".";
+      multicast_groups_[group_id] = std::move(new_nodes);
+      if (!stale_node_ids.empty()) {
+        RETURN_IF_ERROR_WITH_APPEND(tdi_sde_interface_->DeleteMulticastNodes(
+                                        device_, session, stale_node_ids))
+                .with_logging()
+            << "Failed to delete multicast nodes for request "
+            << entry.ShortDebugString() << ".";
+      }
       break;
     }
     case ::p4::v1::Update::DELETE: {
       LOG_IF(WARNING, entry.replicas_size() != 0)
           << "Replicas are ignored on MulticastGroupEntry delete requests: "
           << entry.ShortDebugString() << ".";
-      ASSIGN_OR_RETURN(auto node_ids,
-                       tdi_sde_interface_->GetNodesInMulticastGroup(
-                           device_, session, entry.multicast_group_id()));
+      std::vector<uint32> node_ids;
+      const MulticastGroupNodes* known =
+          gtl::FindOrNull(multicast_groups_, group_id);
+      if (known != nullptr) {
+        node_ids = MulticastNodeIds(*known);
+      } else {
+        ASSIGN_OR_RETURN(node_ids,
+                         tdi_sde_interface_->GetNodesInMulticastGroup(
+                             device_, session, group_id));
+      }
       RETURN_IF_ERROR_WITH_APPEND(
-          tdi_sde_interface_->DeleteMulticastGroup(device_, session,
-                                                   entry.multicast_group_id()))
+          tdi_sde_interface_->DeleteMulticastGroup(device_, session, group_id))
               .with_logging()
           << "Failed to delete multicast group for request "
           << entry.ShortDebugString() << ".";
+      multicast_groups_.erase(group_id);
       RETURN_IF_ERROR_WITH_APPEND(
           tdi_sde_interface_->DeleteMulticastNodes(device_, session, node_ids))
               .with_logging()
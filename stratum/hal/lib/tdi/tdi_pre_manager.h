@@ -5,9 +5,11 @@
 #ifndef STRATUM_HAL_LIB_TDI_TDI_PRE_MANAGER_H_
 #define STRATUM_HAL_LIB_TDI_TDI_PRE_MANAGER_H_
 
+#include <map>
 #include <memory>
 #include <vector>
 
+#include "absl/container/flat_hash_map.h"
 #include "absl/container/flat_hash_set.h"
 #include "absl/synchronization/mutex.h"
 #include "p4/v1/p4runtime.grpc.pb.h"
@@ -48,6 +50,17 @@ class TdiPreManager {
       TdiSdeInterface* tdi_sde_interface, int device);
 
  private:
+  // A multicast node, replicating packets to the egress ports of a single
+  // instance (replication ID) of a multicast group.
+  struct MulticastNode {
+    uint32 node_id;
+    // Sorted egress ports of the node.
+    std::vector<uint32> egress_ports;
+  };
+
+  // The multicast nodes of a group, keyed by instance.
+  using MulticastGroupNodes = std::map<uint32, MulticastNode>;
+
   // Private constructor, we can create the instance by using `CreateInstance`
   // function only.
   explicit TdiPreManager(TdiSdeInterface* tdi_sde_interface, int device);
@@ -81,15 +94,34 @@ class TdiPreManager {
       WriterInterface<::p4::v1::ReadResponse>* writer)
       SHARED_LOCKS_REQUIRED(lock_);
 
-  // Insert new multicast nodes of a given multicast group.
-  ::util::StatusOr<std::vector<uint32>> InsertMulticastNodes(
+  // Builds the multicast nodes for the replicas of the given entry. Nodes of
+  // current_nodes whose instance replicates to the same egress ports are
+  // reused, new nodes are created for the other instances. The IDs of the
+  // current nodes which are not reused are appended to stale_node_ids.
+  ::util::Status InsertMulticastNodes(
       std::shared_ptr<TdiSdeInterface::SessionInterface> session,
-      const ::p4::v1::MulticastGroupEntry& entry)
+      const MulticastGroupNodes& current_nodes,
+      const ::p4::v1::MulticastGroupEntry& entry,
+      MulticastGroupNodes* new_nodes, std::vector<uint32>* stale_node_ids)
       EXCLUSIVE_LOCKS_REQUIRED(lock_);
 
+  // Returns the multicast nodes of the given group, from the node index if
+  // the group is known, else read back from the SDE. The IDs of nodes which
+  // cannot be indexed by instance are appended to other_node_ids.
+  ::util::StatusOr<MulticastGroupNodes> GetMulticastGroupNodes(
+      std::shared_ptr<TdiSdeInterface::SessionInterface> session,
+      uint32 group_id, std::vector<uint32>* other_node_ids)
+      SHARED_LOCKS_REQUIRED(lock_);
+
   // Reader-writer lock used to protect access to pipeline state.
   mutable absl::Mutex lock_;
 
+  // Map from multicast group ID to the nodes of the group, for the groups
+  // written through this manager. Used to update the group membership
+  // incrementally instead of replacing all nodes on every modify.
+  absl::flat_hash_map<uint32, MulticastGroupNodes> multicast_groups_
+      GUARDED_BY(lock_);
+
   // Pointer to a TdiSdeInterface implementation that wraps all the SDE calls.
   TdiSdeInterface* tdi_sde_interface_ = nullptr;  // not owned by this class.
 
@@ -25,6 +25,7 @@ using ::testing::HasSubstr;
 using ::testing::Invoke;
 using ::testing::InvokeWithoutArgs;
 using ::testing::Return;
+using ::testing::SetArgPointee;
 
 class TdiPreManagerTest : public ::testing::Test {
  protected:
@@ -81,6 +82,141 @@ TEST_F(TdiPreManagerTest, DeleteMulticastGroupTest) {
                                             ::p4::v1::Update::DELETE, entry));
 }
 
+TEST_F(TdiPreManagerTest, ModifyMulticastGroupOnlyReplacesChangedNodes) {
+  constexpr int kGroupId = 55;
+  auto session_mock = std::make_shared<SessionMock>();
+  const std::vector<uint32> kNoLags = {};
+
+  {
+    ::testing::InSequence s;
+    EXPECT_CALL(*tdi_sde_wrapper_mock_,
+                CreateMulticastNode(kDevice1, _, 1, kNoLags,
+                                    std::vector<uint32>({1, 2})))
+        .WillOnce(Return(10));
+    EXPECT_CALL(*tdi_sde_wrapper_mock_,
+                CreateMulticastNode(kDevice1, _, 2, kNoLags,
+                                    std::vector<uint32>({3})))
+        .WillOnce(Return(11));
+    EXPECT_CALL(*tdi_sde_wrapper_mock_,
+                InsertMulticastGroup(kDevice1, _, kGroupId,
+                                     std::vector<uint32>({10, 11})))
+        .WillOnce(Return(::util::OkStatus()));
+    // Adding a port to instance 2 only replaces the node of instance 2.
+    EXPECT_CALL(*tdi_sde_wrapper_mock_,
+                CreateMulticastNode(kDevice1, _, 2, kNoLags,
+                                    std::vector<uint32>({3, 4})))
+        .WillOnce(Return(12));
+    EXPECT_CALL(*tdi_sde_wrapper_mock_,
+                ModifyMulticastGroup(kDevice1, _, kGroupId,
+                                     std::vector<uint32>({10, 12})))
+        .WillOnce(Return(::util::OkStatus()));
+    EXPECT_CALL(*tdi_sde_wrapper_mock_,
+                DeleteMulticastNodes(kDevice1, _, std::vector<uint32>({11})))
+        .WillOnce(Return(::util::OkStatus()));
+    // Removing instance 1 only deletes its node.
+    EXPECT_CALL(*tdi_sde_wrapper_mock_,
+                ModifyMulticastGroup(kDevice1, _, kGroupId,
+                                     std::vector<uint32>({12})))
+        .WillOnce(Return(::util::OkStatus()));
+    EXPECT_CALL(*tdi_sde_wrapper_mock_,
+                DeleteMulticastNodes(kDevice1, _, std::vector<uint32>({10})))
+        .WillOnce(Return(::util::OkStatus()));
+    EXPECT_CALL(*tdi_sde_wrapper_mock_,
+                DeleteMulticastGroup(kDevice1, _, kGroupId))
+        .WillOnce(Return(::util::OkStatus()));
+    EXPECT_CALL(*tdi_sde_wrapper_mock_,
+                DeleteMulticastNodes(kDevice1, _, std::vector<uint32>({12})))
+        .WillOnce(Return(::util::OkStatus()));
+  }
+  // The node index makes reading back the group unnecessary.
+  EXPECT_CALL(*tdi_sde_wrapper_mock_, GetNodesInMulticastGroup(_, _, _))
+      .Times(0);
+
+  ::p4::v1::PacketReplicationEngineEntry entry;
+  ASSERT_OK(ParseProtoFromString(R"pb(
+    multicast_group_entry {
+      multicast_group_id: 55
+      replicas { egress_port: 2 instance: 1 }
+      replicas { egress_port: 1 instance: 1 }
+      replicas { egress_port: 3 instance: 2 }
+    }
+  )pb", &entry));
+  EXPECT_OK(tdi_pre_manager_->WritePreEntry(session_mock,
+                                            ::p4::v1::Update::INSERT, entry));
+
+  ASSERT_OK(ParseProtoFromString(R"pb(
+    multicast_group_entry {
+      multicast_group_id: 55
+      replicas { egress_port: 1 instance: 1 }
+      replicas { egress_port: 2 instance: 1 }
+      replicas { egress_port: 3 instance: 2 }
+      replicas { egress_port: 4 instance: 2 }
+    }
+  )pb", &entry));
+  EXPECT_OK(tdi_pre_manager_->WritePreEntry(session_mock,
+                                            ::p4::v1::Update::MODIFY, entry));
+  // Same membership again, nothing to write.
+  EXPECT_OK(tdi_pre_manager_->WritePreEntry(session_mock,
+                                            ::p4::v1::Update::MODIFY, entry));
+
+  ASSERT_OK(ParseProtoFromString(R"pb(
+    multicast_group_entry {
+      multicast_group_id: 55
+      replicas { egress_port: 4 instance: 2 }
+      replicas { egress_port: 3 instance: 2 }
+    }
+  )pb", &entry));
+  EXPECT_OK(tdi_pre_manager_->WritePreEntry(session_mock,
+                                            ::p4::v1::Update::MODIFY, entry));
+
+  entry.mutable_multicast_group_entry()->clear_replicas();
+  EXPECT_OK(tdi_pre_manager_->WritePreEntry(session_mock,
+                                            ::p4::v1::Update::DELETE, entry));
+}
+
+TEST_F(TdiPreManagerTest, ModifyUnknownMulticastGroupReadsBackNodes) {
+  constexpr int kGroupId = 55;
+  auto session_mock = std::make_shared<SessionMock>();
+  const std::vector<uint32> kNoLags = {};
+
+  EXPECT_CALL(*tdi_sde_wrapper_mock_,
+              GetNodesInMulticastGroup(kDevice1, _, kGroupId))
+      .WillOnce(Return(std::vector<uint32>({10, 11})));
+  EXPECT_CALL(*tdi_sde_wrapper_mock_,
+              GetMulticastNode(kDevice1, _, 10, _, _, _))
+      .WillOnce(DoAll(SetArgPointee<3>(1),
+                      SetArgPointee<5>(std::vector<uint32>({2, 1})),
+                      Return(::util::OkStatus())));
+  EXPECT_CALL(*tdi_sde_wrapper_mock_,
+              GetMulticastNode(kDevice1, _, 11, _, _, _))
+      .WillOnce(DoAll(SetArgPointee<3>(2),
+                      SetArgPointee<5>(std::vector<uint32>({3})),
+                      Return(::util::OkStatus())));
+  EXPECT_CALL(*tdi_sde_wrapper_mock_,
+              CreateMulticastNode(kDevice1, _, 3, kNoLags,
+                                  std::vector<uint32>({5})))
+      .WillOnce(Return(12));
+  EXPECT_CALL(*tdi_sde_wrapper_mock_,
+              ModifyMulticastGroup(kDevice1, _, kGroupId,
+                                   std::vector<uint32>({10, 12})))
+      .WillOnce(Return(::util::OkStatus()));
+  EXPECT_CALL(*tdi_sde_wrapper_mock_,
+              DeleteMulticastNodes(kDevice1, _, std::vector<uint32>({11})))
+      .WillOnce(Return(::util::OkStatus()));
+
+  ::p4::v1::PacketReplicationEngineEntry entry;
+  ASSERT_OK(ParseProtoFromString(R"pb(
+    multicast_group_entry {
+      multicast_group_id: 55
+      replicas { egress_port: 1 instance: 1 }
+      replicas { egress_port: 2 instance: 1 }
+      replicas { egress_port: 5 instance: 3 }
+    }
+  )pb", &entry));
+  EXPECT_OK(tdi_pre_manager_->WritePreEntry(session_mock,
+                                            ::p4::v1::Update::MODIFY, entry));
+}
+
 }  // namespace tdi
 }  // namespace hal
 }  // namespace stratum
@@ -0,0 +1,286 @@
+// Copyright 2024 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#include "stratum/hal/lib/tdi/tdi_punt_scheduler.h"
+
+#include <algorithm>
+#include <set>
+#include <utility>
+
+#include "absl/memory/memory.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
+#include "absl/time/clock.h"
+#include "stratum/glue/logging.h"
+#include "stratum/glue/status/status_macros.h"
+#include "stratum/hal/lib/p4/utils.h"
+#include "stratum/lib/macros.h"
+
+namespace stratum {
+namespace hal {
+namespace tdi {
+
+constexpr uint32 TdiPuntScheduler::kDefaultQueueSize;
+constexpr char TdiPuntScheduler::kDefaultClassName[];
+
+namespace {
+
+constexpr char kDropsMetricName[] = "tdi_punt_dropped_packets_total";
+constexpr char kDropsMetricHelp[] =
+    "Packets punted to the controller and dropped on the CPU path.";
+
+// Ether types of the VLAN tags skipped to find the ether type of a packet.
+constexpr uint16 kEtherTypeVlan = 0x8100;
+constexpr uint16 kEtherTypeQinQ = 0x88a8;
+
+// Returns true if the byte string equals the canonical byte string once its
+// leading zeros are removed.
+bool ByteStringMatches(absl::string_view value, absl::string_view canonical) {
+  if (value.empty()) return canonical.empty();
+  size_t first_non_zero = value.find_first_not_of('\x00');
+  if (first_non_zero == absl::string_view::npos) {
+    first_non_zero = value.size() - 1;
+  }
+  value.remove_prefix(first_non_zero);
+  return value == canonical;
+}
+
+// Returns the ether type of an Ethernet frame, after an optional VLAN tag, or
+// 0 if the frame is too short.
+uint32 GetEtherType(const std::string& payload) {
+  size_t offset = 12;
+  if (payload.size() < offset + 2) return 0;
+  uint16 ether_type = (static_cast<uint8>(payload[offset]) << 8) |
+                      static_cast<uint8>(payload[offset + 1]);
+  if (ether_type == kEtherTypeVlan || ether_type == kEtherTypeQinQ) {
+    offset += 4;
+    if (payload.size() < offset + 2) return 0;
+    ether_type = (static_cast<uint8>(payload[offset]) << 8) |
+                 static_cast<uint8>(payload[offset + 1]);
+  }
+  return ether_type;
+}
+
+}  // namespace
+
+TdiPuntScheduler::TdiPuntScheduler(int device)
+    : num_queued_packets_(0), stopped_(false), device_(device) {
+  classes_.push_back(CreateClass(kDefaultClassName, 0, 0, 0));
+  service_order_.push_back(classes_.back().get());
+}
+
+TdiPuntScheduler::~TdiPuntScheduler() { Stop(); }
+
+std::unique_ptr<TdiPuntScheduler> TdiPuntScheduler::CreateInstance(
+    int device) {
+  return absl::WrapUnique(new TdiPuntScheduler(device));
+}
+
+::util::Status TdiPuntScheduler::VerifyConfig(
+    const TdiConfig::PuntConfig& config) {
+  std::set<std::string> names = {kDefaultClassName};
+  for (const auto& punt_class : config.punt_classes()) {
+    RET_CHECK(!punt_class.name().empty())
+        << "Punt class without name: " << punt_class.ShortDebugString() << ".";
+    RET_CHECK(names.insert(punt_class.name()).second)
+        << "Punt class name '" << punt_class.name()
+        << "' is reserved or not unique.";
+    RET_CHECK(punt_class.metadata_id() != 0 || punt_class.ether_type() != 0)
+        << "Punt class '" << punt_class.name() << "' has no match field.";
+    RET_CHECK(punt_class.metadata_id() != 0 ||
+              punt_class.metadata_value().empty())
+        << "Punt class '" << punt_class.name()
+        << "' has a metadata value without metadata ID.";
+    RET_CHECK(punt_class.ether_type() <= 0xffff)
+        << "Invalid ether type " << punt_class.ether_type()
+        << " in punt class '" << punt_class.name() << "'.";
+    RET_CHECK(punt_class.max_rate_pps() != 0 ||
+              punt_class.max_burst_pkts() == 0)
+        << "Punt class '" << punt_class.name()
+        << "' has a burst size without rate.";
+  }
+  RET_CHECK(config.default_max_rate_pps() != 0 ||
+            config.default_max_burst_pkts() == 0)
+      << "The default punt class has a burst size without rate.";
+
+  return ::util::OkStatus();
+}
+
+::util::Status TdiPuntScheduler::PushConfig(
+    const TdiConfig::PuntConfig& config) {
+  RETURN_IF_ERROR(VerifyConfig(config));
+
+  std::vector<std::unique_ptr<PuntClass>> classes;
+  for (const auto& punt_class_config : config.punt_classes()) {
+    auto punt_class = CreateClass(
+        punt_class_config.name(), punt_class_config.queue_size(),
+        punt_class_config.max_rate_pps(), punt_class_config.max_burst_pkts());
+    punt_class->priority = punt_class_config.priority();
+    punt_class->metadata_id = punt_class_config.metadata_id();
+    punt_class->metadata_value =
+        ByteStringToP4RuntimeByteString(punt_class_config.metadata_value());
+    punt_class->ether_type = punt_class_config.ether_type();
+    classes.push_back(std::move(punt_class));
+  }
+  classes.push_back(CreateClass(kDefaultClassName, config.default_queue_size(),
+                                config.default_max_rate_pps(),
+                                config.default_max_burst_pkts()));
+  std::vector<PuntClass*> service_order;
+  for (const auto& punt_class : classes) {
+    service_order.push_back(punt_class.get());
+  }
+  // The default class is last among the classes of priority 0.
+  std::stable_sort(service_order.begin(), service_order.end(),
+                   [](const PuntClass* a, const PuntClass* b) {
+                     return a->priority > b->priority;
+                   });
+
+  absl::MutexLock l(&lock_);
+  classes_.swap(classes);
+  service_order_.swap(service_order);
+  // Re-queue the pending packets, in their previous service order. They have
+  // been policed already.
+  num_queued_packets_ = 0;
+  for (PuntClass* old_class : service_order) {
+    for (auto& packet : old_class->queue) {
+      PuntClass* punt_class = Classify(packet);
+      if (punt_class->queue.size() >= punt_class->queue_size) {
+        punt_class->queue_drops->Increment();
+        continue;
+      }
+      punt_class->queue.push_back(std::move(packet));
+      ++num_queued_packets_;
+    }
+  }
+  LOG(INFO) << "Pushed punt config with " << config.punt_classes_size()
+            << " classes for device " << device_ << ".";
+
+  return ::util::OkStatus();
+}
+
+bool TdiPuntScheduler::Enqueue(::p4::v1::PacketIn packet) {
+  const absl::Time now = absl::Now();
+  absl::MutexLock l(&lock_);
+  if (stopped_) return false;
+  PuntClass* punt_class = Classify(packet);
+  if (!Police(punt_class, now)) {
+    punt_class->policer_drops->Increment();
+    VLOG(2) << "Policer of punt class " << punt_class->name
+            << " dropped PacketIn " << packet.ShortDebugString();
+    return false;
+  }
+  if (punt_class->queue.size() >= punt_class->queue_size) {
+    punt_class->queue_drops->Increment();
+    VLOG(2) << "Queue of punt class " << punt_class->name
+            << " is full, dropped PacketIn " << packet.ShortDebugString();
+    return false;
+  }
+  punt_class->queue.push_back(std::move(packet));
+  ++num_queued_packets_;
+  cond_var_.Signal();
+
+  return true;
+}
+
+bool TdiPuntScheduler::Dequeue(::p4::v1::PacketIn* packet) {
+  absl::MutexLock l(&lock_);
+  while (num_queued_packets_ == 0 && !stopped_) cond_var_.Wait(&lock_);
+  if (stopped_) return false;
+  for (PuntClass* punt_class : service_order_) {
+    if (punt_class->queue.empty()) continue;
+    *packet = std::move(punt_class->queue.front());
+    punt_class->queue.pop_front();
+    --num_queued_packets_;
+    return true;
+  }
+  LOG(DFATAL) << "Found no packet in the punt queues, but "
+              << num_queued_packets_ << " are accounted.";
+  num_queued_packets_ = 0;
+
+  return false;
+}
+
+void TdiPuntScheduler::Start() {
+  absl::MutexLock l(&lock_);
+  stopped_ = false;
+}
+
+void TdiPuntScheduler::Stop() {
+  absl::MutexLock l(&lock_);
+  stopped_ = true;
+  for (const auto& punt_class : classes_) punt_class->queue.clear();
+  num_queued_packets_ = 0;
+  cond_var_.SignalAll();
+}
+
+std::unique_ptr<TdiPuntScheduler::PuntClass> TdiPuntScheduler::CreateClass(
+    const std::string& name, uint32 queue_size, uint32 rate_pps,
+    uint32 burst_pkts) const {
+  auto punt_class = absl::make_unique<PuntClass>();
+  punt_class->name = name;
+  punt_class->queue_size = queue_size > 0 ? queue_size : kDefaultQueueSize;
+  punt_class->rate_pps = rate_pps;
+  punt_class->burst = burst_pkts > 0 ? burst_pkts : std::max(rate_pps, 1u);
+  punt_class->tokens = punt_class->burst;
+  punt_class->last_refill_time = absl::Now();
+  const std::string device = absl::StrCat(device_);
+  auto* registry = MetricRegistry::GetInstance();
+  punt_class->policer_drops = registry->GetCounter(
+      kDropsMetricName, kDropsMetricHelp,
+      {{"device", device}, {"class", name}, {"reason", "policer"}});
+  punt_class->queue_drops = registry->GetCounter(
+      kDropsMetricName, kDropsMetricHelp,
+      {{"device", device}, {"class", name}, {"reason", "queue_full"}});
+  CHECK(punt_class->policer_drops != nullptr &&
+        punt_class->queue_drops != nullptr)
+      << "Metric " << kDropsMetricName << " is not a counter.";
+
+  return punt_class;
+}
+
+TdiPuntScheduler::PuntClass* TdiPuntScheduler::Classify(
+    const ::p4::v1::PacketIn& packet) const {
+  // The ether type is only extracted if a class matches on it.
+  int ether_type = -1;
+  for (const auto& punt_class : classes_) {
+    if (punt_class->metadata_id != 0) {
+      auto it = std::find_if(packet.metadata().begin(),
+                             packet.metadata().end(),
+                             [&punt_class](const ::p4::v1::PacketMetadata& m) {
+                               return m.metadata_id() ==
+                                      punt_class->metadata_id;
+                             });
+      if (it == packet.metadata().end() ||
+          !ByteStringMatches(it->value(), punt_class->metadata_value)) {
+        continue;
+      }
+    }
+    if (punt_class->ether_type != 0) {
+      if (ether_type < 0) ether_type = GetEtherType(packet.payload());
+      if (static_cast<uint32>(ether_type) != punt_class->ether_type) continue;
+    }
+    return punt_class.get();
+  }
+  // Not reached, the default class has no match field.
+  return classes_.back().get();
+}
+
+bool TdiPuntScheduler::Police(PuntClass* punt_class, absl::Time now) {
+  if (punt_class->rate_pps == 0) return true;
+  if (now > punt_class->last_refill_time) {
+    punt_class->tokens = std::min(
+        punt_class->burst,
+        punt_class->tokens +
+            absl::ToDoubleSeconds(now - punt_class->last_refill_time) *
+                punt_class->rate_pps);
+    punt_class->last_refill_time = now;
+  }
+  if (punt_class->tokens < 1) return false;
+  punt_class->tokens -= 1;
+
+  return true;
+}
+
+}  // namespace tdi
+}  // namespace hal
+}  // namespace stratum
@@ -0,0 +1,139 @@
+// Copyright 2024 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef STRATUM_HAL_LIB_TDI_TDI_PUNT_SCHEDULER_H_
+#define STRATUM_HAL_LIB_TDI_TDI_PUNT_SCHEDULER_H_
+
+#include <deque>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/time/time.h"
+#include "p4/v1/p4runtime.pb.h"
+#include "stratum/glue/integral_types.h"
+#include "stratum/glue/status/status.h"
+#include "stratum/hal/lib/common/common.pb.h"
+#include "stratum/lib/metrics.h"
+
+namespace stratum {
+namespace hal {
+namespace tdi {
+
+// The TdiPuntScheduler sits between the RX thread of the TdiPacketioManager
+// and the controller. It classifies the PacketIns as given by the PuntConfig
+// of the node, polices every class with a token bucket and queues the packets
+// in a bounded queue per class. The queues are served in strict priority
+// order, so a flood of low priority packets (e.g. ARP) neither delays nor
+// drops the critical control packets (e.g. LLDP or BFD). The packets dropped
+// by the policers and the full queues are counted per class in the
+// MetricRegistry.
+class TdiPuntScheduler {
+ public:
+  // Default queue size of a class.
+  static constexpr uint32 kDefaultQueueSize = 128;
+
+  // Name of the class of the packets which match no configured class.
+  static constexpr char kDefaultClassName[] = "default";
+
+  virtual ~TdiPuntScheduler();
+
+  // Verifies a punt config.
+  static ::util::Status VerifyConfig(const TdiConfig::PuntConfig& config);
+
+  // Replaces the punt classes with the ones of the given config. The queued
+  // packets are kept and re-queued into the new classes.
+  ::util::Status PushConfig(const TdiConfig::PuntConfig& config)
+      LOCKS_EXCLUDED(lock_);
+
+  // Classifies, polices and queues a packet. Never blocks. Returns false if
+  // the packet is dropped.
+  bool Enqueue(::p4::v1::PacketIn packet) LOCKS_EXCLUDED(lock_);
+
+  // Waits until a packet is queued and returns the first packet of the
+  // highest priority non-empty queue. Returns false once the scheduler is
+  // stopped.
+  bool Dequeue(::p4::v1::PacketIn* packet) LOCKS_EXCLUDED(lock_);
+
+  // Starts accepting packets. The scheduler is created started.
+  void Start() LOCKS_EXCLUDED(lock_);
+
+  // Drops the queued packets and wakes up the waiting Dequeue() calls. The
+  // packets given to Enqueue() are dropped until Start() is called.
+  void Stop() LOCKS_EXCLUDED(lock_);
+
+  // Creates a scheduler instance for the given device, with only the default
+  // class.
+  static std::unique_ptr<TdiPuntScheduler> CreateInstance(int device);
+
+  // TdiPuntScheduler is neither copyable nor movable.
+  TdiPuntScheduler(const TdiPuntScheduler&) = delete;
+  TdiPuntScheduler& operator=(const TdiPuntScheduler&) = delete;
+
+ private:
+  // A class of punted packets, with its policer and queue.
+  struct PuntClass {
+    std::string name;
+    uint32 priority = 0;
+    // Match fields. A zero ID or ether type matches any packet. The metadata
+    // value is canonical, i.e. without leading zeros.
+    uint32 metadata_id = 0;
+    std::string metadata_value;
+    uint32 ether_type = 0;
+    size_t queue_size = kDefaultQueueSize;
+    // Token bucket state. A zero rate means the class is not policed.
+    double rate_pps = 0;
+    double burst = 0;
+    double tokens = 0;
+    absl::Time last_refill_time;
+    std::deque<::p4::v1::PacketIn> queue;
+    // Counters in the MetricRegistry, never null.
+    MetricCounter* policer_drops = nullptr;
+    MetricCounter* queue_drops = nullptr;
+  };
+
+  // Private constructor, use CreateInstance() to create an instance.
+  explicit TdiPuntScheduler(int device);
+
+  // Builds a class and its counters. The match fields are set by the caller.
+  std::unique_ptr<PuntClass> CreateClass(const std::string& name,
+                                         uint32 queue_size, uint32 rate_pps,
+                                         uint32 burst_pkts) const;
+
+  // Returns the class of the given packet.
+  PuntClass* Classify(const ::p4::v1::PacketIn& packet) const
+      SHARED_LOCKS_REQUIRED(lock_);
+
+  // Returns true if the token bucket of the class admits a packet at the
+  // given time, and takes a token.
+  static bool Police(PuntClass* punt_class, absl::Time now);
+
+  // Protects the classes and their queues.
+  mutable absl::Mutex lock_;
+
+  // Signalled when a packet is queued or the scheduler is stopped.
+  absl::CondVar cond_var_;
+
+  // The configured classes in match order, followed by the default class.
+  std::vector<std::unique_ptr<PuntClass>> classes_ GUARDED_BY(lock_);
+
+  // The classes sorted by decreasing priority, i.e. in service order.
+  std::vector<PuntClass*> service_order_ GUARDED_BY(lock_);
+
+  // Total number of queued packets.
+  size_t num_queued_packets_ GUARDED_BY(lock_);
+
+  // True between Stop() and Start().
+  bool stopped_ GUARDED_BY(lock_);
+
+  // Fixed zero-based device number of the node/ASIC, used as metric label.
+  const int device_;
+};
+
+}  // namespace tdi
+}  // namespace hal
+}  // namespace stratum
+
+#endif  // STRATUM_HAL_LIB_TDI_TDI_PUNT_SCHEDULER_H_
@@ -0,0 +1,193 @@
+// Copyright 2024 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#include "stratum/hal/lib/tdi/tdi_punt_scheduler.h"
+
+#include <memory>
+#include <string>
+#include <thread>  // NOLINT
+
+#include "absl/synchronization/notification.h"
+#include "absl/time/time.h"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "stratum/glue/status/status_test_util.h"
+#include "stratum/lib/metrics.h"
+#include "stratum/lib/utils.h"
+
+namespace stratum {
+namespace hal {
+namespace tdi {
+
+class TdiPuntSchedulerTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    scheduler_ = TdiPuntScheduler::CreateInstance(kDevice1);
+  }
+
+  ::util::Status PushConfig(const std::string& config_str) {
+    TdiConfig::PuntConfig config;
+    RETURN_IF_ERROR(ParseProtoFromString(config_str, &config));
+    return scheduler_->PushConfig(config);
+  }
+
+  // Returns a PacketIn with the given ingress port metadata and ether type.
+  static ::p4::v1::PacketIn MakePacketIn(const std::string& port,
+                                         uint16 ether_type) {
+    ::p4::v1::PacketIn packet;
+    auto* metadata = packet.add_metadata();
+    metadata->set_metadata_id(kIngressPortMetadataId);
+    metadata->set_value(port);
+    std::string payload(14, '\0');
+    payload[12] = static_cast<char>(ether_type >> 8);
+    payload[13] = static_cast<char>(ether_type & 0xff);
+    packet.set_payload(payload);
+    return packet;
+  }
+
+  // Returns the number of packets of a class dropped for the given reason.
+  static uint64 GetDrops(const std::string& class_name,
+                         const std::string& reason) {
+    return MetricRegistry::GetInstance()
+        ->GetCounter("tdi_punt_dropped_packets_total", "",
+                     {{"device", std::to_string(kDevice1)},
+                      {"class", class_name},
+                      {"reason", reason}})
+        ->value();
+  }
+
+  // Dequeues a packet and returns its ether type, or -1 on failure.
+  int DequeueEtherType() {
+    ::p4::v1::PacketIn packet;
+    if (!scheduler_->Dequeue(&packet)) return -1;
+    return (static_cast<uint8>(packet.payload()[12]) << 8) |
+           static_cast<uint8>(packet.payload()[13]);
+  }
+
+  static constexpr int kDevice1 = 7;
+  static constexpr uint32 kIngressPortMetadataId = 1;
+  static constexpr uint16 kEtherTypeArp = 0x0806;
+  static constexpr uint16 kEtherTypeLldp = 0x88cc;
+  static constexpr uint16 kEtherTypeIpv4 = 0x0800;
+  std::unique_ptr<TdiPuntScheduler> scheduler_;
+};
+
+constexpr int TdiPuntSchedulerTest::kDevice1;
+constexpr uint32 TdiPuntSchedulerTest::kIngressPortMetadataId;
+constexpr uint16 TdiPuntSchedulerTest::kEtherTypeArp;
+constexpr uint16 TdiPuntSchedulerTest::kEtherTypeLldp;
+constexpr uint16 TdiPuntSchedulerTest::kEtherTypeIpv4;
+
+TEST_F(TdiPuntSchedulerTest, DefaultClassIsFifo) {
+  EXPECT_TRUE(scheduler_->Enqueue(MakePacketIn("\x01", kEtherTypeArp)));
+  EXPECT_TRUE(scheduler_->Enqueue(MakePacketIn("\x01", kEtherTypeLldp)));
+  EXPECT_EQ(kEtherTypeArp, DequeueEtherType());
+  EXPECT_EQ(kEtherTypeLldp, DequeueEtherType());
+}
+
+TEST_F(TdiPuntSchedulerTest, ServesClassesInPriorityOrder) {
+  ASSERT_OK(PushConfig(R"pb(
+    punt_classes { name: "arp" priority: 1 ether_type: 0x0806 }
+    punt_classes { name: "lldp" priority: 7 ether_type: 0x88cc }
+  )pb"));
+  EXPECT_TRUE(scheduler_->Enqueue(MakePacketIn("\x01", kEtherTypeIpv4)));
+  EXPECT_TRUE(scheduler_->Enqueue(MakePacketIn("\x01", kEtherTypeArp)));
+  EXPECT_TRUE(scheduler_->Enqueue(MakePacketIn("\x01", kEtherTypeLldp)));
+  EXPECT_EQ(kEtherTypeLldp, DequeueEtherType());
+  EXPECT_EQ(kEtherTypeArp, DequeueEtherType());
+  EXPECT_EQ(kEtherTypeIpv4, DequeueEtherType());
+}
+
+TEST_F(TdiPuntSchedulerTest, PolicesClasses) {
+  ASSERT_OK(PushConfig(R"pb(
+    punt_classes {
+      name: "policed_arp"
+      ether_type: 0x0806
+      max_rate_pps: 1
+      max_burst_pkts: 2
+    }
+  )pb"));
+  const uint64 drops = GetDrops("policed_arp", "policer");
+  EXPECT_TRUE(scheduler_->Enqueue(MakePacketIn("\x01", kEtherTypeArp)));
+  EXPECT_TRUE(scheduler_->Enqueue(MakePacketIn("\x01", kEtherTypeArp)));
+  EXPECT_FALSE(scheduler_->Enqueue(MakePacketIn("\x01", kEtherTypeArp)));
+  EXPECT_FALSE(scheduler_->Enqueue(MakePacketIn("\x01", kEtherTypeArp)));
+  // Other classes are not affected.
+  EXPECT_TRUE(scheduler_->Enqueue(MakePacketIn("\x01", kEtherTypeLldp)));
+  EXPECT_EQ(drops + 2, GetDrops("policed_arp", "policer"));
+}
+
+TEST_F(TdiPuntSchedulerTest, DropsPacketsOfFullQueues) {
+  ASSERT_OK(PushConfig(R"pb(
+    punt_classes { name: "small_queue" ether_type: 0x0806 queue_size: 2 }
+  )pb"));
+  const uint64 drops = GetDrops("small_queue", "queue_full");
+  EXPECT_TRUE(scheduler_->Enqueue(MakePacketIn("\x01", kEtherTypeArp)));
+  EXPECT_TRUE(scheduler_->Enqueue(MakePacketIn("\x01", kEtherTypeArp)));
+  EXPECT_FALSE(scheduler_->Enqueue(MakePacketIn("\x01", kEtherTypeArp)));
+  EXPECT_EQ(drops + 1, GetDrops("small_queue", "queue_full"));
+  EXPECT_EQ(kEtherTypeArp, DequeueEtherType());
+  EXPECT_TRUE(scheduler_->Enqueue(MakePacketIn("\x01", kEtherTypeArp)));
+}
+
+TEST_F(TdiPuntSchedulerTest, MatchesCanonicalMetadataValues) {
+  ASSERT_OK(PushConfig(R"pb(
+    punt_classes {
+      name: "port_2"
+      priority: 1
+      metadata_id: 1
+      metadata_value: "\x00\x02"
+    }
+  )pb"));
+  EXPECT_TRUE(scheduler_->Enqueue(MakePacketIn("\x01", kEtherTypeArp)));
+  EXPECT_TRUE(scheduler_->Enqueue(MakePacketIn(std::string("\x00\x02", 2),
+                                               kEtherTypeLldp)));
+  EXPECT_EQ(kEtherTypeLldp, DequeueEtherType());
+  EXPECT_EQ(kEtherTypeArp, DequeueEtherType());
+}
+
+TEST_F(TdiPuntSchedulerTest, RequeuesPendingPacketsOnConfigPush) {
+  EXPECT_TRUE(scheduler_->Enqueue(MakePacketIn("\x01", kEtherTypeArp)));
+  EXPECT_TRUE(scheduler_->Enqueue(MakePacketIn("\x01", kEtherTypeLldp)));
+  ASSERT_OK(PushConfig(R"pb(
+    punt_classes { name: "lldp" priority: 7 ether_type: 0x88cc }
+  )pb"));
+  EXPECT_EQ(kEtherTypeLldp, DequeueEtherType());
+  EXPECT_EQ(kEtherTypeArp, DequeueEtherType());
+}
+
+TEST_F(TdiPuntSchedulerTest, StopWakesUpDequeue) {
+  absl::Notification done;
+  std::thread t([this, &done]() {
+    ::p4::v1::PacketIn packet;
+    EXPECT_FALSE(scheduler_->Dequeue(&packet));
+    done.Notify();
+  });
+  EXPECT_FALSE(done.WaitForNotificationWithTimeout(absl::Milliseconds(50)));
+  scheduler_->Stop();
+  EXPECT_TRUE(done.WaitForNotificationWithTimeout(absl::Seconds(5)));
+  t.join();
+  EXPECT_FALSE(scheduler_->Enqueue(MakePacketIn("\x01", kEtherTypeArp)));
+  scheduler_->Start();
+  EXPECT_TRUE(scheduler_->Enqueue(MakePacketIn("\x01", kEtherTypeArp)));
+  EXPECT_EQ(kEtherTypeArp, DequeueEtherType());
+}
+
+TEST_F(TdiPuntSchedulerTest, RejectsInvalidConfigs) {
+  EXPECT_FALSE(PushConfig(R"pb(punt_classes { name: "no_match" })pb").ok());
+  EXPECT_FALSE(
+      PushConfig(R"pb(punt_classes { name: "default" ether_type: 1 })pb").ok());
+  EXPECT_FALSE(PushConfig(R"pb(
+                 punt_classes { name: "arp" ether_type: 0x0806 }
+                 punt_classes { name: "arp" ether_type: 0x0806 }
+               )pb")
+                   .ok());
+  EXPECT_FALSE(PushConfig(R"pb(
+                 punt_classes { name: "burst" ether_type: 1 max_burst_pkts: 1 }
+               )pb")
+                   .ok());
+}
+
+}  // namespace tdi
+}  // namespace hal
+}  // namespace stratum
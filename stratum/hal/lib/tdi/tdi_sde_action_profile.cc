@@ -41,8 +41,7 @@ using namespace stratum::hal::tdi::helpers;
   auto real_table_data = dynamic_cast<const TableData*>(table_data);
   RET_CHECK(real_table_data);
 
-  const ::tdi::Table* table;
-  RETURN_IF_TDI_ERROR(tdi_info_->tableFromIdGet(table_id, &table));
+  ASSIGN_OR_RETURN(const ::tdi::Table* table, GetTable(table_id));
 
   std::unique_ptr<::tdi::TableKey> table_key;
   RETURN_IF_TDI_ERROR(table->keyAllocate(&table_key));
@@ -60,10 +59,7 @@ using namespace stratum::hal::tdi::helpers;
   // Key: $ACTION_MEMBER_ID
   RETURN_IF_ERROR(SetFieldExact(table_key.get(), kActionMemberId, member_id));
 
-  const ::tdi::Device* device = nullptr;
-  ::tdi::DevMgr::getInstance().deviceGet(dev_id, &device);
-  std::unique_ptr<::tdi::Target> dev_tgt;
-  device->createTarget(&dev_tgt);
+  ASSIGN_OR_RETURN(const ::tdi::Target* dev_tgt, GetDeviceTarget(dev_id));
 
   const auto flags = ::tdi::Flags(0);
   if (insert) {
@@ -103,8 +99,7 @@ using namespace stratum::hal::tdi::helpers;
   auto real_session = std::dynamic_pointer_cast<Session>(session);
   RET_CHECK(real_session);
 
-  const ::tdi::Table* table;
-  RETURN_IF_TDI_ERROR(tdi_info_->tableFromIdGet(table_id, &table));
+  ASSIGN_OR_RETURN(const ::tdi::Table* table, GetTable(table_id));
 
   std::unique_ptr<::tdi::TableKey> table_key;
   RETURN_IF_TDI_ERROR(table->keyAllocate(&table_key));
@@ -119,10 +114,7 @@ using namespace stratum::hal::tdi::helpers;
   // Key: $ACTION_MEMBER_ID
   RETURN_IF_ERROR(SetFieldExact(table_key.get(), kActionMemberId, member_id));
 
-  const ::tdi::Device* device = nullptr;
-  ::tdi::DevMgr::getInstance().deviceGet(dev_id, &device);
-  std::unique_ptr<::tdi::Target> dev_tgt;
-  device->createTarget(&dev_tgt);
+  ASSIGN_OR_RETURN(const ::tdi::Target* dev_tgt, GetDeviceTarget(dev_id));
 
   const auto flags = ::tdi::Flags(0);
   RETURN_IF_TDI_ERROR(
@@ -141,14 +133,10 @@ using namespace stratum::hal::tdi::helpers;
   auto real_session = std::dynamic_pointer_cast<Session>(session);
   RET_CHECK(real_session);
 
-  const ::tdi::Device* device = nullptr;
-  ::tdi::DevMgr::getInstance().deviceGet(dev_id, &device);
-  std::unique_ptr<::tdi::Target> dev_tgt;
-  device->createTarget(&dev_tgt);
+  ASSIGN_OR_RETURN(const ::tdi::Target* dev_tgt, GetDeviceTarget(dev_id));
 
   const auto flags = ::tdi::Flags(0);
-  const ::tdi::Table* table;
-  RETURN_IF_TDI_ERROR(tdi_info_->tableFromIdGet(table_id, &table));
+  ASSIGN_OR_RETURN(const ::tdi::Table* table, GetTable(table_id));
   std::vector<std::unique_ptr<::tdi::TableKey>> keys;
   std::vector<std::unique_ptr<::tdi::TableData>> datums;
   // Is this a wildcard read?
@@ -193,8 +181,7 @@ using namespace stratum::hal::tdi::helpers;
   auto real_session = std::dynamic_pointer_cast<Session>(session);
   RET_CHECK(real_session);
 
-  const ::tdi::Table* table;
-  RETURN_IF_TDI_ERROR(tdi_info_->tableFromIdGet(table_id, &table));
+  ASSIGN_OR_RETURN(const ::tdi::Table* table, GetTable(table_id));
 
   std::unique_ptr<::tdi::TableKey> table_key;
   std::unique_ptr<::tdi::TableData> table_data;
@@ -222,10 +209,7 @@ using namespace stratum::hal::tdi::helpers;
   RETURN_IF_ERROR(
       SetField(table_data.get(), "$MAX_GROUP_SIZE", max_group_size));
 
-  const ::tdi::Device* device = nullptr;
-  ::tdi::DevMgr::getInstance().deviceGet(dev_id, &device);
-  std::unique_ptr<::tdi::Target> dev_tgt;
-  device->createTarget(&dev_tgt);
+  ASSIGN_OR_RETURN(const ::tdi::Target* dev_tgt, GetDeviceTarget(dev_id));
 
   const auto flags = ::tdi::Flags(0);
   if (insert) {
@@ -270,8 +254,7 @@ using namespace stratum::hal::tdi::helpers;
   auto real_session = std::dynamic_pointer_cast<Session>(session);
   RET_CHECK(real_session);
 
-  const ::tdi::Table* table;
-  RETURN_IF_TDI_ERROR(tdi_info_->tableFromIdGet(table_id, &table));
+  ASSIGN_OR_RETURN(const ::tdi::Table* table, GetTable(table_id));
   std::unique_ptr<::tdi::TableKey> table_key;
   RETURN_IF_TDI_ERROR(table->keyAllocate(&table_key));
 
@@ -285,10 +268,7 @@ using namespace stratum::hal::tdi::helpers;
   // Key: $SELECTOR_GROUP_ID
   RETURN_IF_ERROR(SetFieldExact(table_key.get(), kSelectorGroupId, group_id));
 
-  const ::tdi::Device* device = nullptr;
-  ::tdi::DevMgr::getInstance().deviceGet(dev_id, &device);
-  std::unique_ptr<::tdi::Target> dev_tgt;
-  device->createTarget(&dev_tgt);
+  ASSIGN_OR_RETURN(const ::tdi::Target* dev_tgt, GetDeviceTarget(dev_id));
 
   const auto flags = ::tdi::Flags(0);
   RETURN_IF_TDI_ERROR(
@@ -312,14 +292,10 @@ using namespace stratum::hal::tdi::helpers;
   auto real_session = std::dynamic_pointer_cast<Session>(session);
   RET_CHECK(real_session);
 
-  const ::tdi::Device* device = nullptr;
-  ::tdi::DevMgr::getInstance().deviceGet(dev_id, &device);
-  std::unique_ptr<::tdi::Target> dev_tgt;
-  device->createTarget(&dev_tgt);
+  ASSIGN_OR_RETURN(const ::tdi::Target* dev_tgt, GetDeviceTarget(dev_id));
 
   const auto flags = ::tdi::Flags(0);
-  const ::tdi::Table* table;
-  RETURN_IF_TDI_ERROR(tdi_info_->tableFromIdGet(table_id, &table));
+  ASSIGN_OR_RETURN(const ::tdi::Table* table, GetTable(table_id));
   std::vector<std::unique_ptr<::tdi::TableKey>> keys;
   std::vector<std::unique_ptr<::tdi::TableData>> datums;
   // Is this a wildcard read?
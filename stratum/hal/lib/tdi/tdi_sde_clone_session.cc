@@ -35,14 +35,11 @@ using namespace stratum::hal::tdi::helpers;
   RET_CHECK(real_session);
 
   const ::tdi::Table* table;
-  const ::tdi::Device* device = nullptr;
   const ::tdi::ActionInfo* actionInfo;
-  ::tdi::DevMgr::getInstance().deviceGet(dev_id, &device);
-  std::unique_ptr<::tdi::Target> dev_tgt;
-  device->createTarget(&dev_tgt);
+  ASSIGN_OR_RETURN(const ::tdi::Target* dev_tgt, GetDeviceTarget(dev_id));
 
   const auto flags = ::tdi::Flags(0);
-  RETURN_IF_TDI_ERROR(tdi_info_->tableFromNameGet(kMirrorConfigTable, &table));
+  ASSIGN_OR_RETURN(table, GetTableByName(kMirrorConfigTable));
   std::unique_ptr<::tdi::TableKey> table_key;
   std::unique_ptr<::tdi::TableData> table_data;
   RETURN_IF_TDI_ERROR(table->keyAllocate(&table_key));
@@ -103,8 +100,8 @@ using namespace stratum::hal::tdi::helpers;
   const ::tdi::ActionInfo* actionInfo;
   RET_CHECK(real_session);
 
-  const ::tdi::Table* table;
-  RETURN_IF_TDI_ERROR(tdi_info_->tableFromNameGet(kMirrorConfigTable, &table));
+  ASSIGN_OR_RETURN(const ::tdi::Table* table,
+                   GetTableByName(kMirrorConfigTable));
   std::unique_ptr<::tdi::TableKey> table_key;
   std::unique_ptr<::tdi::TableData> table_data;
   RETURN_IF_TDI_ERROR(table->keyAllocate(&table_key));
@@ -116,10 +113,7 @@ using namespace stratum::hal::tdi::helpers;
   // Key: $sid
   RETURN_IF_ERROR(SetFieldExact(table_key.get(), "sid", session_id));
 
-  const ::tdi::Device* device = nullptr;
-  ::tdi::DevMgr::getInstance().deviceGet(dev_id, &device);
-  std::unique_ptr<::tdi::Target> dev_tgt;
-  device->createTarget(&dev_tgt);
+  ASSIGN_OR_RETURN(const ::tdi::Target* dev_tgt, GetDeviceTarget(dev_id));
 
   const auto flags = ::tdi::Flags(0);
   RETURN_IF_TDI_ERROR(table->entryDel(*real_session->tdi_session_, *dev_tgt,
@@ -142,14 +136,11 @@ using namespace stratum::hal::tdi::helpers;
   const ::tdi::ActionInfo* actionInfo;
   RET_CHECK(real_session);
 
-  const ::tdi::Device* device = nullptr;
-  ::tdi::DevMgr::getInstance().deviceGet(dev_id, &device);
-  std::unique_ptr<::tdi::Target> dev_tgt;
-  device->createTarget(&dev_tgt);
+  ASSIGN_OR_RETURN(const ::tdi::Target* dev_tgt, GetDeviceTarget(dev_id));
 
   const auto flags = ::tdi::Flags(0);
-  const ::tdi::Table* table;
-  RETURN_IF_TDI_ERROR(tdi_info_->tableFromNameGet(kMirrorConfigTable, &table));
+  ASSIGN_OR_RETURN(const ::tdi::Table* table,
+                   GetTableByName(kMirrorConfigTable));
   tdi_id_t action_id;
   actionInfo = table->tableInfoGet()->actionGet("normal");
   RETURN_IF_NULL(actionInfo);
@@ -40,8 +40,7 @@ using namespace stratum::hal::tdi::helpers;
   const ::tdi::DataFieldInfo* dataFieldInfo;
   RET_CHECK(real_session);
 
-  const ::tdi::Table* table;
-  RETURN_IF_TDI_ERROR(tdi_info_->tableFromIdGet(counter_id, &table));
+  ASSIGN_OR_RETURN(const ::tdi::Table* table, GetTable(counter_id));
 
   std::unique_ptr<::tdi::TableKey> table_key;
   std::unique_ptr<::tdi::TableData> table_data;
@@ -69,10 +68,7 @@ using namespace stratum::hal::tdi::helpers;
       RETURN_IF_TDI_ERROR(table_data->setValue(field_id, packet_count.value()));
     }
   }
-  const ::tdi::Device* device = nullptr;
-  ::tdi::DevMgr::getInstance().deviceGet(dev_id, &device);
-  std::unique_ptr<::tdi::Target> dev_tgt;
-  device->createTarget(&dev_tgt);
+  ASSIGN_OR_RETURN(const ::tdi::Target* dev_tgt, GetDeviceTarget(dev_id));
 
   const auto flags = ::tdi::Flags(0);
   RETURN_IF_TDI_ERROR(table->entryMod(*real_session->tdi_session_, *dev_tgt,
@@ -95,14 +91,10 @@ using namespace stratum::hal::tdi::helpers;
   auto real_session = std::dynamic_pointer_cast<Session>(session);
   RET_CHECK(real_session);
 
-  const ::tdi::Device* device = nullptr;
-  ::tdi::DevMgr::getInstance().deviceGet(dev_id, &device);
-  std::unique_ptr<::tdi::Target> dev_tgt;
-  device->createTarget(&dev_tgt);
+  ASSIGN_OR_RETURN(const ::tdi::Target* dev_tgt, GetDeviceTarget(dev_id));
 
   const auto flags = ::tdi::Flags(0);
-  const ::tdi::Table* table;
-  RETURN_IF_TDI_ERROR(tdi_info_->tableFromIdGet(counter_id, &table));
+  ASSIGN_OR_RETURN(const ::tdi::Table* table, GetTable(counter_id));
   std::vector<std::unique_ptr<::tdi::TableKey>> keys;
   std::vector<std::unique_ptr<::tdi::TableData>> datums;
 
@@ -181,13 +173,9 @@ using namespace stratum::hal::tdi::helpers;
   auto real_session = std::dynamic_pointer_cast<Session>(session);
   RET_CHECK(real_session);
 
-  const ::tdi::Table* table;
-  RETURN_IF_TDI_ERROR(tdi_info_->tableFromIdGet(table_id, &table));
+  ASSIGN_OR_RETURN(const ::tdi::Table* table, GetTable(table_id));
 
-  const ::tdi::Device* device = nullptr;
-  ::tdi::DevMgr::getInstance().deviceGet(dev_id, &device);
-  std::unique_ptr<::tdi::Target> dev_tgt;
-  device->createTarget(&dev_tgt);
+  ASSIGN_OR_RETURN(const ::tdi::Target* dev_tgt, GetDeviceTarget(dev_id));
 
   // Sync table counter
   std::set<tdi_operations_type_e> supported_ops;
@@ -203,7 +191,7 @@ using namespace stratum::hal::tdi::helpers;
         static_cast<tdi_operations_type_e>(
           tdi_rt_operations_type_e::COUNTER_SYNC), &table_op));
     RETURN_IF_TDI_ERROR(table_op->counterSyncSet(
-        *real_session->tdi_session_, dev_tgt,
+        *real_session->tdi_session_, *dev_tgt,
         [table_id, weak_ref](const ::tdi::Target& dev_tgt, void* cookie) {
           if (auto notifier = weak_ref.lock()) {
             VLOG(1) << "Table counter for table " << table_id << " synced.";
@@ -417,7 +417,7 @@ namespace {
  * GetNumberOfEntries - Returns the number of entries in the table.
  */
 ::util::Status GetNumberOfEntries(std::shared_ptr<::tdi::Session>& tdi_session,
-                                  ::tdi::Target& tdi_dev_target,
+                                  const ::tdi::Target& tdi_dev_target,
                                   const ::tdi::Flags& flags,
                                   const ::tdi::Table*& table, uint32& entries) {
   entries = 0;
@@ -439,24 +439,18 @@ namespace {
  * GetFirstEntry() - Fetches the first entry in the table.
  */
 ::util::Status GetFirstEntry(
-    std::shared_ptr<::tdi::Session>& tdi_session, const ::tdi::Flags& flags,
+    std::shared_ptr<::tdi::Session>& tdi_session,
+    const ::tdi::Target& tdi_dev_target, const ::tdi::Flags& flags,
     const ::tdi::Table*& table,
     std::vector<std::unique_ptr<::tdi::TableKey>>*& table_keys,
     std::vector<std::unique_ptr<::tdi::TableData>>*& table_values) {
-  // QUESTION: Why does GetFirstEntry() define its own ::tdi::Target
-  // instead of using the one passed to GetAllEntries()?
-  const ::tdi::Device* device = nullptr;
-  ::tdi::DevMgr::getInstance().deviceGet(0, &device);
-  std::unique_ptr<::tdi::Target> dev_tgt;
-  device->createTarget(&dev_tgt);
-
   std::unique_ptr<::tdi::TableKey> table_key;
   std::unique_ptr<::tdi::TableData> table_data;
 
   RETURN_IF_TDI_ERROR(table->keyAllocate(&table_key));
   RETURN_IF_TDI_ERROR(table->dataAllocate(&table_data));
 
-  auto tdi_status = table->entryGetFirst(*tdi_session, *dev_tgt, flags,
+  auto tdi_status = table->entryGetFirst(*tdi_session, tdi_dev_target, flags,
                                          table_key.get(), table_data.get());
   if (ObjectNotFound(tdi_status)) {
     // Table is empty.
@@ -475,9 +469,9 @@ namespace {
  * The first entry has already been fetched.
  */
 ::util::Status GetNextEntries(
-    std::shared_ptr<::tdi::Session>& tdi_session, ::tdi::Target& tdi_dev_target,
-    const ::tdi::Flags& flags, const ::tdi::Table*& table,
-    const uint32 num_entries,
+    std::shared_ptr<::tdi::Session>& tdi_session,
+    const ::tdi::Target& tdi_dev_target, const ::tdi::Flags& flags,
+    const ::tdi::Table*& table, const uint32 num_entries,
     std::vector<std::unique_ptr<::tdi::TableKey>>*& table_keys,
     std::vector<std::unique_ptr<::tdi::TableData>>*& table_values) {
   // Input and output vectors for GetNextN.
@@ -526,8 +520,9 @@ namespace {
  * request multiple entries.
  */
 ::util::Status GetExtraEntries(
-    std::shared_ptr<::tdi::Session>& tdi_session, ::tdi::Target& tdi_dev_target,
-    const ::tdi::Flags& flags, const ::tdi::Table*& table,
+    std::shared_ptr<::tdi::Session>& tdi_session,
+    const ::tdi::Target& tdi_dev_target, const ::tdi::Flags& flags,
+    const ::tdi::Table*& table,
     std::vector<std::unique_ptr<::tdi::TableKey>>*& table_keys,
     std::vector<std::unique_ptr<::tdi::TableData>>*& table_values) {
   constexpr uint32 NUM_ENTRIES = 1;
@@ -560,16 +555,17 @@ namespace {
  * the number of entries in the table and then reading that many entries.
  */
 ::util::Status GetAllEntriesByCount(
-    std::shared_ptr<::tdi::Session>& tdi_session, ::tdi::Target& tdi_dev_target,
-    const ::tdi::Flags& flags, const ::tdi::Table*& table,
+    std::shared_ptr<::tdi::Session>& tdi_session,
+    const ::tdi::Target& tdi_dev_target, const ::tdi::Flags& flags,
+    const ::tdi::Table*& table,
     std::vector<std::unique_ptr<::tdi::TableKey>>*& table_keys,
     std::vector<std::unique_ptr<::tdi::TableData>>*& table_values) {
   uint32 entries = 0;
   RETURN_IF_ERROR(
       GetNumberOfEntries(tdi_session, tdi_dev_target, flags, table, entries));
 
-  RETURN_IF_ERROR(
-      GetFirstEntry(tdi_session, flags, table, table_keys, table_values));
+  RETURN_IF_ERROR(GetFirstEntry(tdi_session, tdi_dev_target, flags, table,
+                                table_keys, table_values));
 
   if (table_keys->size() == 0) {
     // Table is empty.
@@ -596,8 +592,8 @@ namespace {
  * GetAllEntries() - Fetches all the entries in a table.
  */
 ::util::Status GetAllEntries(
-    std::shared_ptr<::tdi::Session> tdi_session, ::tdi::Target& tdi_dev_target,
-    const ::tdi::Table* table,
+    std::shared_ptr<::tdi::Session> tdi_session,
+    const ::tdi::Target& tdi_dev_target, const ::tdi::Table* table,
     std::vector<std::unique_ptr<::tdi::TableKey>>* table_keys,
     std::vector<std::unique_ptr<::tdi::TableData>>* table_values) {
   // Sanity check.
@@ -621,6 +617,12 @@ bool IsPreallocatedTable(const ::tdi::Table& table) {
           table_type == TDI_SDE_TABLE_TYPE_METER);
 }
 
+LatencyHistogram* SdeCallLatencyHistogram(const std::string& call) {
+  return MetricRegistry::GetInstance()->GetHistogram(
+      "stratum_tdi_sde_call_latency_seconds",
+      "Latency of the TDI SDE table entry calls.", {{"call", call}});
+}
+
 }  // namespace helpers
 }  // namespace tdi
 }  // namespace hal
@@ -18,6 +18,7 @@
 #include "stratum/glue/status/statusor.h"
 #include "stratum/hal/lib/tdi/tdi_sde_common.h"
 #include "stratum/hal/lib/tdi/tdi_sde_wrapper.h"
+#include "stratum/lib/metrics.h"
 
 namespace stratum {
 namespace hal {
@@ -113,13 +114,17 @@ template <typename T>
 }
 
 ::util::Status GetAllEntries(
-    std::shared_ptr<::tdi::Session> tdi_session, ::tdi::Target& tdi_dev_target,
-    const ::tdi::Table* table,
+    std::shared_ptr<::tdi::Session> tdi_session,
+    const ::tdi::Target& tdi_dev_target, const ::tdi::Table* table,
     std::vector<std::unique_ptr<::tdi::TableKey>>* table_keys,
     std::vector<std::unique_ptr<::tdi::TableData>>* table_values);
 
 bool IsPreallocatedTable(const ::tdi::Table& table);
 
+// Returns the latency histogram of the given SDE wrapper call, e.g.
+// "InsertTableEntry".
+LatencyHistogram* SdeCallLatencyHistogram(const std::string& call);
+
 }  // namespace helpers
 }  // namespace tdi
 }  // namespace hal
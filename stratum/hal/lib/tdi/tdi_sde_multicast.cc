@@ -92,17 +92,13 @@ namespace {
     RET_CHECK(real_session);
 
     const ::tdi::Table* table;
-    const ::tdi::Device* device = nullptr;
-    ::tdi::DevMgr::getInstance().deviceGet(dev_id, &device);
-    std::unique_ptr<::tdi::Target> dev_tgt;
-    device->createTarget(&dev_tgt);
+    ASSIGN_OR_RETURN(const ::tdi::Target* dev_tgt, GetDeviceTarget(dev_id));
 
     // Dump group table
     LOG(INFO) << "#### $pre.mgid ####";
-    RETURN_IF_TDI_ERROR(tdi_info_->tableFromNameGet(kPreMgidTable, &table));
+    ASSIGN_OR_RETURN(table, GetTableByName(kPreMgidTable));
     std::vector<std::unique_ptr<::tdi::TableKey>> keys;
     std::vector<std::unique_ptr<::tdi::TableData>> datums;
-    RETURN_IF_TDI_ERROR(tdi_info_->tableFromNameGet(kPreMgidTable, &table));
     RETURN_IF_ERROR(GetAllEntries(real_session->tdi_session_, *dev_tgt, table,
                                   &keys, &datums));
     for (size_t i = 0; i < keys.size(); ++i) {
@@ -114,7 +110,7 @@ namespace {
 
     // Dump node table
     LOG(INFO) << "#### $pre.node ####";
-    RETURN_IF_TDI_ERROR(tdi_info_->tableFromNameGet(kPreNodeTable, &table));
+    ASSIGN_OR_RETURN(table, GetTableByName(kPreNodeTable));
     RETURN_IF_ERROR(GetAllEntries(real_session->tdi_session_, *dev_tgt, table,
                                   &keys, &datums));
     for (size_t i = 0; i < keys.size(); ++i) {
@@ -132,15 +128,10 @@ namespace {
   auto real_session = std::dynamic_pointer_cast<Session>(session);
   RET_CHECK(real_session);
 
-  const ::tdi::Device* device = nullptr;
-  ::tdi::DevMgr::getInstance().deviceGet(dev_id, &device);
-
-  std::unique_ptr<::tdi::Target> dev_tgt;
-  device->createTarget(&dev_tgt);
+  ASSIGN_OR_RETURN(const ::tdi::Target* dev_tgt, GetDeviceTarget(dev_id));
 
   const auto flags = ::tdi::Flags(0);
-  const ::tdi::Table* table;
-  RETURN_IF_TDI_ERROR(tdi_info_->tableFromNameGet(kPreNodeTable, &table));
+  ASSIGN_OR_RETURN(const ::tdi::Table* table, GetTableByName(kPreNodeTable));
   size_t table_size;
 
   RETURN_IF_TDI_ERROR(table->sizeGet(*real_session->tdi_session_, *dev_tgt,
@@ -182,7 +173,7 @@ namespace {
   RET_CHECK(real_session);
 
   const ::tdi::Table* table;  // PRE node table.
-  RETURN_IF_TDI_ERROR(tdi_info_->tableFromNameGet(kPreNodeTable, &table));
+  ASSIGN_OR_RETURN(table, GetTableByName(kPreNodeTable));
   auto table_id = table->tableInfoGet()->idGet();
 
   std::unique_ptr<::tdi::TableKey> table_key;
@@ -190,10 +181,7 @@ namespace {
   RETURN_IF_TDI_ERROR(table->keyAllocate(&table_key));
   RETURN_IF_TDI_ERROR(table->dataAllocate(&table_data));
 
-  const ::tdi::Device* device = nullptr;
-  ::tdi::DevMgr::getInstance().deviceGet(dev_id, &device);
-  std::unique_ptr<::tdi::Target> dev_tgt;
-  device->createTarget(&dev_tgt);
+  ASSIGN_OR_RETURN(const ::tdi::Target* dev_tgt, GetDeviceTarget(dev_id));
 
   const auto flags = ::tdi::Flags(0);
 
@@ -221,14 +209,10 @@ namespace {
   auto real_session = std::dynamic_pointer_cast<Session>(session);
   RET_CHECK(real_session);
 
-  const ::tdi::Device* device = nullptr;
-  ::tdi::DevMgr::getInstance().deviceGet(dev_id, &device);
-  std::unique_ptr<::tdi::Target> dev_tgt;
-  device->createTarget(&dev_tgt);
+  ASSIGN_OR_RETURN(const ::tdi::Target* dev_tgt, GetDeviceTarget(dev_id));
 
   const auto flags = ::tdi::Flags(0);
-  const ::tdi::Table* table;
-  RETURN_IF_TDI_ERROR(tdi_info_->tableFromNameGet(kPreMgidTable, &table));
+  ASSIGN_OR_RETURN(const ::tdi::Table* table, GetTableByName(kPreMgidTable));
 
   std::unique_ptr<::tdi::TableKey> table_key;
   std::unique_ptr<::tdi::TableData> table_data;
@@ -251,14 +235,10 @@ namespace {
   auto real_session = std::dynamic_pointer_cast<Session>(session);
   RET_CHECK(real_session);
 
-  const ::tdi::Device* device = nullptr;
-  ::tdi::DevMgr::getInstance().deviceGet(dev_id, &device);
-  std::unique_ptr<::tdi::Target> dev_tgt;
-  device->createTarget(&dev_tgt);
+  ASSIGN_OR_RETURN(const ::tdi::Target* dev_tgt, GetDeviceTarget(dev_id));
 
   const auto flags = ::tdi::Flags(0);
-  const ::tdi::Table* table;
-  RETURN_IF_TDI_ERROR(tdi_info_->tableFromNameGet(kPreNodeTable, &table));
+  ASSIGN_OR_RETURN(const ::tdi::Table* table, GetTableByName(kPreNodeTable));
   auto table_id = table->tableInfoGet()->idGet();
 
   // TODO(max): handle partial delete failures
@@ -284,14 +264,11 @@ namespace {
   auto real_session = std::dynamic_pointer_cast<Session>(session);
   RET_CHECK(real_session);
 
-  const ::tdi::Device* device = nullptr;
-  ::tdi::DevMgr::getInstance().deviceGet(dev_id, &device);
-  std::unique_ptr<::tdi::Target> dev_tgt;
-  device->createTarget(&dev_tgt);
+  ASSIGN_OR_RETURN(const ::tdi::Target* dev_tgt, GetDeviceTarget(dev_id));
 
   const auto flags = ::tdi::Flags(0);
   const ::tdi::Table* table;  // PRE node table.
-  RETURN_IF_TDI_ERROR(tdi_info_->tableFromNameGet(kPreNodeTable, &table));
+  ASSIGN_OR_RETURN(table, GetTableByName(kPreNodeTable));
   auto table_id = table->tableInfoGet()->idGet();
 
   std::unique_ptr<::tdi::TableKey> table_key;
@@ -324,14 +301,11 @@ namespace {
   auto real_session = std::dynamic_pointer_cast<Session>(session);
   RET_CHECK(real_session);
 
-  const ::tdi::Device* device = nullptr;
-  ::tdi::DevMgr::getInstance().deviceGet(dev_id, &device);
-  std::unique_ptr<::tdi::Target> dev_tgt;
-  device->createTarget(&dev_tgt);
+  ASSIGN_OR_RETURN(const ::tdi::Target* dev_tgt, GetDeviceTarget(dev_id));
 
   const auto flags = ::tdi::Flags(0);
   const ::tdi::Table* table = nullptr;  // PRE MGID table.
-  RETURN_IF_TDI_ERROR(tdi_info_->tableFromNameGet(kPreMgidTable, &table));
+  ASSIGN_OR_RETURN(table, GetTableByName(kPreMgidTable));
   auto table_id = table->tableInfoGet()->idGet();
   std::unique_ptr<::tdi::TableKey> table_key;
   std::unique_ptr<::tdi::TableData> table_data;
@@ -389,14 +363,11 @@ namespace {
   auto real_session = std::dynamic_pointer_cast<Session>(session);
   RET_CHECK(real_session);
 
-  const ::tdi::Device* device = nullptr;
-  ::tdi::DevMgr::getInstance().deviceGet(dev_id, &device);
-  std::unique_ptr<::tdi::Target> dev_tgt;
-  device->createTarget(&dev_tgt);
+  ASSIGN_OR_RETURN(const ::tdi::Target* dev_tgt, GetDeviceTarget(dev_id));
 
   const auto flags = ::tdi::Flags(0);
   const ::tdi::Table* table;  // PRE MGID table.
-  RETURN_IF_TDI_ERROR(tdi_info_->tableFromNameGet(kPreMgidTable, &table));
+  ASSIGN_OR_RETURN(table, GetTableByName(kPreMgidTable));
   std::unique_ptr<::tdi::TableKey> table_key;
   RETURN_IF_TDI_ERROR(table->keyAllocate(&table_key));
   // Key: $MGID
@@ -417,14 +388,11 @@ namespace {
   auto real_session = std::dynamic_pointer_cast<Session>(session);
   RET_CHECK(real_session);
 
-  const ::tdi::Device* device = nullptr;
-  ::tdi::DevMgr::getInstance().deviceGet(dev_id, &device);
-  std::unique_ptr<::tdi::Target> dev_tgt;
-  device->createTarget(&dev_tgt);
+  ASSIGN_OR_RETURN(const ::tdi::Target* dev_tgt, GetDeviceTarget(dev_id));
 
   const auto flags = ::tdi::Flags(0);
   const ::tdi::Table* table;  // PRE MGID table.
-  RETURN_IF_TDI_ERROR(tdi_info_->tableFromNameGet(kPreMgidTable, &table));
+  ASSIGN_OR_RETURN(table, GetTableByName(kPreMgidTable));
   std::vector<std::unique_ptr<::tdi::TableKey>> keys;
   std::vector<std::unique_ptr<::tdi::TableData>> datums;
   // Is this a wildcard read?
@@ -72,8 +72,7 @@ namespace {
   auto real_session = std::dynamic_pointer_cast<Session>(session);
   RET_CHECK(real_session);
 
-  const ::tdi::Table* table;
-  RETURN_IF_TDI_ERROR(tdi_info_->tableFromIdGet(table_id, &table));
+  ASSIGN_OR_RETURN(const ::tdi::Table* table, GetTable(table_id));
 
   std::unique_ptr<::tdi::TableKey> table_key;
   std::unique_ptr<::tdi::TableData> table_data;
@@ -96,10 +95,7 @@ namespace {
   RETURN_IF_TDI_ERROR(table_data->setValue(
       field_id, reinterpret_cast<const uint8*>(value.data()), value.size()));
 
-  const ::tdi::Device* device = nullptr;
-  ::tdi::DevMgr::getInstance().deviceGet(dev_id, &device);
-  std::unique_ptr<::tdi::Target> dev_tgt;
-  device->createTarget(&dev_tgt);
+  ASSIGN_OR_RETURN(const ::tdi::Target* dev_tgt, GetDeviceTarget(dev_id));
 
   const auto flags = ::tdi::Flags(0);
   if (register_index) {
@@ -138,14 +134,10 @@ namespace {
 
   RETURN_IF_ERROR(SynchronizeRegisters(dev_id, session, table_id, timeout));
 
-  const ::tdi::Device* device = nullptr;
-  ::tdi::DevMgr::getInstance().deviceGet(dev_id, &device);
-  std::unique_ptr<::tdi::Target> dev_tgt;
-  device->createTarget(&dev_tgt);
+  ASSIGN_OR_RETURN(const ::tdi::Target* dev_tgt, GetDeviceTarget(dev_id));
 
   const auto flags = ::tdi::Flags(0);
-  const ::tdi::Table* table;
-  RETURN_IF_TDI_ERROR(tdi_info_->tableFromIdGet(table_id, &table));
+  ASSIGN_OR_RETURN(const ::tdi::Table* table, GetTable(table_id));
   std::vector<std::unique_ptr<::tdi::TableKey>> keys;
   std::vector<std::unique_ptr<::tdi::TableData>> datums;
 
@@ -214,13 +206,9 @@ namespace {
   auto real_session = std::dynamic_pointer_cast<Session>(session);
   RET_CHECK(real_session);
 
-  const ::tdi::Table* table;
-  RETURN_IF_TDI_ERROR(tdi_info_->tableFromIdGet(table_id, &table));
+  ASSIGN_OR_RETURN(const ::tdi::Table* table, GetTable(table_id));
 
-  const ::tdi::Device* device = nullptr;
-  ::tdi::DevMgr::getInstance().deviceGet(dev_id, &device);
-  std::unique_ptr<::tdi::Target> dev_tgt;
-  device->createTarget(&dev_tgt);
+  ASSIGN_OR_RETURN(const ::tdi::Target* dev_tgt, GetDeviceTarget(dev_id));
 
   // Sync table registers.
   // TDI comments ; its supposed to be tdi_rt_operations_type_e ??
@@ -240,7 +228,7 @@ namespace {
     RETURN_IF_TDI_ERROR(table->operationsAllocate(
           static_cast<tdi_operations_type_e>(tdi_rt_operations_type_e::REGISTER_SYNC), &table_op));
     RETURN_IF_TDI_ERROR(table_op->registerSyncSet(
-        *real_session->tdi_session_, dev_tgt,
+        *real_session->tdi_session_, *dev_tgt,
         [table_id, weak_ref](const ::tdi::Target& dev_tgt, void* cookie) {
           if (auto notifier = weak_ref.lock()) {
             VLOG(1) << "Table registers for table " << table_id << " synced.";
@@ -250,10 +250,8 @@ using namespace stratum::hal::tdi::helpers;
 }
 
 ::util::StatusOr<std::unique_ptr<TdiSdeInterface::TableDataInterface>>
-TableData::CreateTableData(const ::tdi::TdiInfo* tdi_info, uint32 table_id,
-                           uint32 action_id) {
-  const ::tdi::Table* table;
-  RETURN_IF_TDI_ERROR(tdi_info->tableFromIdGet(table_id, &table));
+TableData::CreateTableData(const ::tdi::Table* table, uint32 action_id) {
+  RET_CHECK(table);
   std::unique_ptr<::tdi::TableData> table_data;
   if (action_id) {
     RETURN_IF_TDI_ERROR(table->dataAllocate(action_id, &table_data));
@@ -21,6 +21,7 @@
 #include "stratum/hal/lib/tdi/tdi_sde_helpers.h"
 #include "stratum/hal/lib/tdi/tdi_sde_wrapper.h"
 #include "stratum/hal/lib/tdi/tdi_status.h"
+#include "stratum/lib/metrics.h"
 
 namespace stratum {
 namespace hal {
@@ -33,6 +34,9 @@ using namespace stratum::hal::tdi::helpers;
     uint32 table_id, const TableKeyInterface* table_key,
     const TableDataInterface* table_data) {
   ::absl::ReaderMutexLock l(&data_lock_);
+  static LatencyHistogram* latency =
+      SdeCallLatencyHistogram("InsertTableEntry");
+  ScopedLatencyRecorder latency_recorder(latency);
   auto real_session = std::dynamic_pointer_cast<Session>(session);
   RET_CHECK(real_session);
   auto real_table_key = dynamic_cast<const TableKey*>(table_key);
@@ -40,8 +44,7 @@ using namespace stratum::hal::tdi::helpers;
   auto real_table_data = dynamic_cast<const TableData*>(table_data);
   RET_CHECK(real_table_data);
 
-  const ::tdi::Table* table;
-  RETURN_IF_TDI_ERROR(tdi_info_->tableFromIdGet(table_id, &table));
+  ASSIGN_OR_RETURN(const ::tdi::Table* table, GetTable(table_id));
 
   auto dump_args = [&]() -> std::string {
     return absl::StrCat(
@@ -53,10 +56,7 @@ using namespace stratum::hal::tdi::helpers;
             .ValueOr("<error parsing data>"));
   };
 
-  const ::tdi::Device* device = nullptr;
-  ::tdi::DevMgr::getInstance().deviceGet(dev_id, &device);
-  std::unique_ptr<::tdi::Target> dev_tgt;
-  device->createTarget(&dev_tgt);
+  ASSIGN_OR_RETURN(const ::tdi::Target* dev_tgt, GetDeviceTarget(dev_id));
 
   /* Note: When multiple pipeline support is added, for device target
    * pipeline id also should be set
@@ -87,6 +87,9 @@ using namespace stratum::hal::tdi::helpers;
     uint32 table_id, const TableKeyInterface* table_key,
     const TableDataInterface* table_data) {
   ::absl::ReaderMutexLock l(&data_lock_);
+  static LatencyHistogram* latency =
+      SdeCallLatencyHistogram("ModifyTableEntry");
+  ScopedLatencyRecorder latency_recorder(latency);
   auto real_session = std::dynamic_pointer_cast<Session>(session);
   RET_CHECK(real_session);
   auto real_table_key = dynamic_cast<const TableKey*>(table_key);
@@ -94,8 +97,7 @@ using namespace stratum::hal::tdi::helpers;
   auto real_table_data = dynamic_cast<const TableData*>(table_data);
   RET_CHECK(real_table_data);
 
-  const ::tdi::Table* table;
-  RETURN_IF_TDI_ERROR(tdi_info_->tableFromIdGet(table_id, &table));
+  ASSIGN_OR_RETURN(const ::tdi::Table* table, GetTable(table_id));
 
   auto dump_args = [&]() -> std::string {
     return absl::StrCat(
@@ -107,10 +109,7 @@ using namespace stratum::hal::tdi::helpers;
             .ValueOr("<error parsing data>"));
   };
 
-  const ::tdi::Device* device = nullptr;
-  ::tdi::DevMgr::getInstance().deviceGet(dev_id, &device);
-  std::unique_ptr<::tdi::Target> dev_tgt;
-  device->createTarget(&dev_tgt);
+  ASSIGN_OR_RETURN(const ::tdi::Target* dev_tgt, GetDeviceTarget(dev_id));
 
   const auto flags = ::tdi::Flags(0);
   RETURN_IF_TDI_ERROR(table->entryMod(*real_session->tdi_session_, *dev_tgt,
@@ -124,13 +123,15 @@ using namespace stratum::hal::tdi::helpers;
     int dev_id, std::shared_ptr<TdiSdeInterface::SessionInterface> session,
     uint32 table_id, const TableKeyInterface* table_key) {
   ::absl::ReaderMutexLock l(&data_lock_);
+  static LatencyHistogram* latency =
+      SdeCallLatencyHistogram("DeleteTableEntry");
+  ScopedLatencyRecorder latency_recorder(latency);
   auto real_session = std::dynamic_pointer_cast<Session>(session);
   RET_CHECK(real_session);
   auto real_table_key = dynamic_cast<const TableKey*>(table_key);
   RET_CHECK(real_table_key);
 
-  const ::tdi::Table* table;
-  RETURN_IF_TDI_ERROR(tdi_info_->tableFromIdGet(table_id, &table));
+  ASSIGN_OR_RETURN(const ::tdi::Table* table, GetTable(table_id));
 
   auto dump_args = [&]() -> std::string {
     return absl::StrCat(
@@ -140,10 +141,7 @@ using namespace stratum::hal::tdi::helpers;
   };
 
   // TDI comments; Hardcoding device = 0
-  const ::tdi::Device* device = nullptr;
-  ::tdi::DevMgr::getInstance().deviceGet(dev_id, &device);
-  std::unique_ptr<::tdi::Target> dev_tgt;
-  device->createTarget(&dev_tgt);
+  ASSIGN_OR_RETURN(const ::tdi::Target* dev_tgt, GetDeviceTarget(dev_id));
 
   const auto flags = ::tdi::Flags(0);
   tdi_status_t status = table->entryDel(*real_session->tdi_session_, *dev_tgt,
@@ -165,18 +163,16 @@ using namespace stratum::hal::tdi::helpers;
     uint32 table_id, const TableKeyInterface* table_key,
     TableDataInterface* table_data) {
   ::absl::ReaderMutexLock l(&data_lock_);
+  static LatencyHistogram* latency = SdeCallLatencyHistogram("GetTableEntry");
+  ScopedLatencyRecorder latency_recorder(latency);
   auto real_session = std::dynamic_pointer_cast<Session>(session);
   RET_CHECK(real_session);
   auto real_table_key = dynamic_cast<const TableKey*>(table_key);
   RET_CHECK(real_table_key);
   auto real_table_data = dynamic_cast<const TableData*>(table_data);
   RET_CHECK(real_table_data);
-  const ::tdi::Table* table;
-  RETURN_IF_TDI_ERROR(tdi_info_->tableFromIdGet(table_id, &table));
-  const ::tdi::Device* device = nullptr;
-  ::tdi::DevMgr::getInstance().deviceGet(dev_id, &device);
-  std::unique_ptr<::tdi::Target> dev_tgt;
-  device->createTarget(&dev_tgt);
+  ASSIGN_OR_RETURN(const ::tdi::Table* table, GetTable(table_id));
+  ASSIGN_OR_RETURN(const ::tdi::Target* dev_tgt, GetDeviceTarget(dev_id));
 
   const auto flags = ::tdi::Flags(0);
   tdi_status_t status = table->entryGet(*real_session->tdi_session_, *dev_tgt,
@@ -200,15 +196,14 @@ using namespace stratum::hal::tdi::helpers;
     std::vector<std::unique_ptr<TableKeyInterface>>* table_keys,
     std::vector<std::unique_ptr<TableDataInterface>>* table_values) {
   ::absl::ReaderMutexLock l(&data_lock_);
+  static LatencyHistogram* latency =
+      SdeCallLatencyHistogram("GetAllTableEntries");
+  ScopedLatencyRecorder latency_recorder(latency);
   auto real_session = std::dynamic_pointer_cast<Session>(session);
   RET_CHECK(real_session);
-  const ::tdi::Table* table;
-  RETURN_IF_TDI_ERROR(tdi_info_->tableFromIdGet(table_id, &table));
+  ASSIGN_OR_RETURN(const ::tdi::Table* table, GetTable(table_id));
 
-  const ::tdi::Device* device = nullptr;
-  ::tdi::DevMgr::getInstance().deviceGet(dev_id, &device);
-  std::unique_ptr<::tdi::Target> dev_tgt;
-  device->createTarget(&dev_tgt);
+  ASSIGN_OR_RETURN(const ::tdi::Target* dev_tgt, GetDeviceTarget(dev_id));
 
   std::vector<std::unique_ptr<::tdi::TableKey>> keys;
   std::vector<std::unique_ptr<::tdi::TableData>> datums;
@@ -231,17 +226,16 @@ using namespace stratum::hal::tdi::helpers;
     int dev_id, std::shared_ptr<TdiSdeInterface::SessionInterface> session,
     uint32 table_id, const TableDataInterface* table_data) {
   ::absl::ReaderMutexLock l(&data_lock_);
+  static LatencyHistogram* latency =
+      SdeCallLatencyHistogram("SetDefaultTableEntry");
+  ScopedLatencyRecorder latency_recorder(latency);
   auto real_session = std::dynamic_pointer_cast<Session>(session);
   RET_CHECK(real_session);
   auto real_table_data = dynamic_cast<const TableData*>(table_data);
   RET_CHECK(real_table_data);
-  const ::tdi::Table* table;
-  RETURN_IF_TDI_ERROR(tdi_info_->tableFromIdGet(table_id, &table));
+  ASSIGN_OR_RETURN(const ::tdi::Table* table, GetTable(table_id));
 
-  const ::tdi::Device* device = nullptr;
-  ::tdi::DevMgr::getInstance().deviceGet(dev_id, &device);
-  std::unique_ptr<::tdi::Target> dev_tgt;
-  device->createTarget(&dev_tgt);
+  ASSIGN_OR_RETURN(const ::tdi::Target* dev_tgt, GetDeviceTarget(dev_id));
 
   const auto flags = ::tdi::Flags(0);
   RETURN_IF_TDI_ERROR(table->defaultEntrySet(*real_session->tdi_session_,
@@ -254,15 +248,14 @@ using namespace stratum::hal::tdi::helpers;
     int dev_id, std::shared_ptr<TdiSdeInterface::SessionInterface> session,
     uint32 table_id) {
   ::absl::ReaderMutexLock l(&data_lock_);
+  static LatencyHistogram* latency =
+      SdeCallLatencyHistogram("ResetDefaultTableEntry");
+  ScopedLatencyRecorder latency_recorder(latency);
   auto real_session = std::dynamic_pointer_cast<Session>(session);
   RET_CHECK(real_session);
-  const ::tdi::Table* table;
-  RETURN_IF_TDI_ERROR(tdi_info_->tableFromIdGet(table_id, &table));
+  ASSIGN_OR_RETURN(const ::tdi::Table* table, GetTable(table_id));
 
-  const ::tdi::Device* device = nullptr;
-  ::tdi::DevMgr::getInstance().deviceGet(dev_id, &device);
-  std::unique_ptr<::tdi::Target> dev_tgt;
-  device->createTarget(&dev_tgt);
+  ASSIGN_OR_RETURN(const ::tdi::Target* dev_tgt, GetDeviceTarget(dev_id));
 
   const auto flags = ::tdi::Flags(0);
   RETURN_IF_TDI_ERROR(
@@ -275,17 +268,16 @@ using namespace stratum::hal::tdi::helpers;
     int dev_id, std::shared_ptr<TdiSdeInterface::SessionInterface> session,
     uint32 table_id, TableDataInterface* table_data) {
   ::absl::ReaderMutexLock l(&data_lock_);
+  static LatencyHistogram* latency =
+      SdeCallLatencyHistogram("GetDefaultTableEntry");
+  ScopedLatencyRecorder latency_recorder(latency);
   auto real_session = std::dynamic_pointer_cast<Session>(session);
   RET_CHECK(real_session);
   auto real_table_data = dynamic_cast<const TableData*>(table_data);
   RET_CHECK(real_table_data);
-  const ::tdi::Table* table;
-  RETURN_IF_TDI_ERROR(tdi_info_->tableFromIdGet(table_id, &table));
+  ASSIGN_OR_RETURN(const ::tdi::Table* table, GetTable(table_id));
 
-  const ::tdi::Device* device = nullptr;
-  ::tdi::DevMgr::getInstance().deviceGet(dev_id, &device);
-  std::unique_ptr<::tdi::Target> dev_tgt;
-  device->createTarget(&dev_tgt);
+  ASSIGN_OR_RETURN(const ::tdi::Target* dev_tgt, GetDeviceTarget(dev_id));
 
   const auto flags = ::tdi::Flags(0);
   RETURN_IF_TDI_ERROR(
@@ -269,9 +269,8 @@ using namespace stratum::hal::tdi::helpers;
 }
 
 ::util::StatusOr<std::unique_ptr<TdiSdeInterface::TableKeyInterface>>
-TableKey::CreateTableKey(const ::tdi::TdiInfo* tdi_info, uint32 table_id) {
-  const ::tdi::Table* table;
-  RETURN_IF_TDI_ERROR(tdi_info->tableFromIdGet(table_id, &table));
+TableKey::CreateTableKey(const ::tdi::Table* table) {
+  RET_CHECK(table);
   std::unique_ptr<::tdi::TableKey> table_key;
   RETURN_IF_TDI_ERROR(table->keyAllocate(&table_key));
   auto key = std::unique_ptr<TdiSdeInterface::TableKeyInterface>(
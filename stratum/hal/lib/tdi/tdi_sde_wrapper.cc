@@ -11,11 +11,14 @@
 #include <memory>
 #include <ostream>
 #include <set>
+#include <string>
 #include <utility>
+#include <vector>
 
 #include "absl/hash/hash.h"
 #include "absl/synchronization/mutex.h"
 #include "absl/time/time.h"
+#include "stratum/glue/gtl/map_util.h"
 #include "stratum/glue/integral_types.h"
 #include "stratum/glue/logging.h"
 #include "stratum/glue/status/status.h"
@@ -48,13 +51,15 @@ TdiSdeWrapper::CreateSession() {
 ::util::StatusOr<std::unique_ptr<TdiSdeInterface::TableKeyInterface>>
 TdiSdeWrapper::CreateTableKey(uint32 table_id) {
   ::absl::ReaderMutexLock l(&data_lock_);
-  return TableKey::CreateTableKey(tdi_info_, table_id);
+  ASSIGN_OR_RETURN(const ::tdi::Table* table, GetTable(table_id));
+  return TableKey::CreateTableKey(table);
 }
 
 ::util::StatusOr<std::unique_ptr<TdiSdeInterface::TableDataInterface>>
 TdiSdeWrapper::CreateTableData(uint32 table_id, uint32 action_id) {
   ::absl::ReaderMutexLock l(&data_lock_);
-  return TableData::CreateTableData(tdi_info_, table_id, action_id);
+  ASSIGN_OR_RETURN(const ::tdi::Table* table, GetTable(table_id));
+  return TableData::CreateTableData(table, action_id);
 }
 
 ::util::StatusOr<uint32> TdiSdeWrapper::GetTdiRtId(uint32 p4info_id) const {
@@ -81,15 +86,75 @@ TdiSdeWrapper::CreateTableData(uint32 table_id, uint32 action_id) {
 
 ::util::StatusOr<uint32> TdiSdeWrapper::GetTableId(
     std::string& table_name) const {
-  const ::tdi::Table* table;
+  ::absl::ReaderMutexLock l(&data_lock_);
   if (nullptr != tdi_info_) {
-    RETURN_IF_TDI_ERROR(tdi_info_->tableFromNameGet(table_name, &table));
+    ASSIGN_OR_RETURN(const ::tdi::Table* table, GetTableByName(table_name));
     return (table->tableInfoGet()->idGet());
   }
 
   return MAKE_ERROR(ERR_INTERNAL) << "Error retrieving information from TDI";
 }
 
+::util::Status TdiSdeWrapper::BuildHandleCache(int dev_id) {
+  RET_CHECK(tdi_info_) << "TDI info not initialized for device " << dev_id
+                       << ".";
+  const ::tdi::Device* device = nullptr;
+  RETURN_IF_TDI_ERROR(::tdi::DevMgr::getInstance().deviceGet(dev_id, &device));
+  std::unique_ptr<::tdi::Target> dev_tgt;
+  RETURN_IF_TDI_ERROR(device->createTarget(&dev_tgt));
+  device_targets_[dev_id] = std::move(dev_tgt);
+
+  // The table handles are owned by the TdiInfo of the new pipeline.
+  std::vector<const ::tdi::Table*> tdi_tables;
+  RETURN_IF_TDI_ERROR(tdi_info_->tablesGet(&tdi_tables));
+  ClearHandleCache();
+  for (const auto* table : tdi_tables) {
+    tables_by_id_[table->tableInfoGet()->idGet()] = table;
+    tables_by_name_[table->tableInfoGet()->nameGet()] = table;
+  }
+  VLOG(1) << "Cached the target and " << tables_by_id_.size()
+          << " table handles of device " << dev_id << ".";
+
+  return ::util::OkStatus();
+}
+
+void TdiSdeWrapper::ClearHandleCache() {
+  tables_by_id_.clear();
+  tables_by_name_.clear();
+}
+
+::util::StatusOr<const ::tdi::Target*> TdiSdeWrapper::GetDeviceTarget(
+    int dev_id) const {
+  const std::unique_ptr<::tdi::Target>* dev_tgt =
+      gtl::FindOrNull(device_targets_, dev_id);
+  if (dev_tgt == nullptr) {
+    return MAKE_ERROR(ERR_NOT_INITIALIZED)
+           << "No target for device " << dev_id << ".";
+  }
+  return dev_tgt->get();
+}
+
+::util::StatusOr<const ::tdi::Table*> TdiSdeWrapper::GetTable(
+    uint32 table_id) const {
+  const ::tdi::Table* const* cached = gtl::FindOrNull(tables_by_id_, table_id);
+  if (cached != nullptr) return *cached;
+  RET_CHECK(tdi_info_) << "TDI info not initialized.";
+  const ::tdi::Table* table;
+  RETURN_IF_TDI_ERROR(tdi_info_->tableFromIdGet(table_id, &table));
+  return table;
+}
+
+::util::StatusOr<const ::tdi::Table*> TdiSdeWrapper::GetTableByName(
+    const std::string& table_name) const {
+  const ::tdi::Table* const* cached =
+      gtl::FindOrNull(tables_by_name_, table_name);
+  if (cached != nullptr) return *cached;
+  RET_CHECK(tdi_info_) << "TDI info not initialized.";
+  const ::tdi::Table* table;
+  RETURN_IF_TDI_ERROR(tdi_info_->tableFromNameGet(table_name, &table));
+  return table;
+}
+
 //------------------------------------------------------------------------------
 // Packet i/o
 // Return ERR_OPER_NOT_SUPPORTED?
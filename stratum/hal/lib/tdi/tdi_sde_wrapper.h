@@ -11,6 +11,7 @@
 #include <utility>
 #include <vector>
 
+#include "absl/container/flat_hash_map.h"
 #include "absl/synchronization/mutex.h"
 #include "stratum/glue/integral_types.h"
 #include "stratum/glue/status/status.h"
@@ -53,7 +54,7 @@ class TableKey : public TdiSdeInterface::TableKeyInterface {
 
   // Allocates a new table key object.
   static ::util::StatusOr<std::unique_ptr<TdiSdeInterface::TableKeyInterface>>
-  CreateTableKey(const ::tdi::TdiInfo* tdi_info, uint32 table_id);
+  CreateTableKey(const ::tdi::Table* table);
 
   // Stores the underlying SDE object.
   std::unique_ptr<::tdi::TableKey> table_key_;
@@ -91,8 +92,7 @@ class TableData : public TdiSdeInterface::TableDataInterface {
 
   // Allocates a new table data object.
   static ::util::StatusOr<std::unique_ptr<TdiSdeInterface::TableDataInterface>>
-  CreateTableData(const ::tdi::TdiInfo* tdi_info, uint32 table_id,
-                  uint32 action_id);
+  CreateTableData(const ::tdi::Table* table, uint32 action_id);
 
   // Stores the underlying SDE object.
   std::unique_ptr<::tdi::TableData> table_data_;
@@ -386,6 +386,37 @@ class TdiSdeWrapper : public TdiSdeInterface {
   // Pointer to the current BfRt info object. Not owned by this class.
   const ::tdi::TdiInfo* tdi_info_ GUARDED_BY(data_lock_);
 
+  // Resolves the device target and the table handles of the current pipeline
+  // once, so that the per-call paths do not go through the SDE device manager
+  // and the TdiInfo lookups. Called by AddDevice after tdi_info_ is set.
+  ::util::Status BuildHandleCache(int dev_id)
+      EXCLUSIVE_LOCKS_REQUIRED(data_lock_);
+
+  // Drops the cached handles, which become invalid with the old pipeline.
+  void ClearHandleCache() EXCLUSIVE_LOCKS_REQUIRED(data_lock_);
+
+  // Returns the cached target of the given device.
+  ::util::StatusOr<const ::tdi::Target*> GetDeviceTarget(int dev_id) const
+      SHARED_LOCKS_REQUIRED(data_lock_);
+
+  // Returns the table with the given TDI ID or name, from the cache if
+  // possible.
+  ::util::StatusOr<const ::tdi::Table*> GetTable(uint32 table_id) const
+      SHARED_LOCKS_REQUIRED(data_lock_);
+  ::util::StatusOr<const ::tdi::Table*> GetTableByName(
+      const std::string& table_name) const SHARED_LOCKS_REQUIRED(data_lock_);
+
+  // Map from device ID to the target of all pipes of the device.
+  absl::flat_hash_map<int, std::unique_ptr<::tdi::Target>> device_targets_
+      GUARDED_BY(data_lock_);
+
+  // Maps from TDI table ID and name to the tables of the current pipeline.
+  // The tables are owned by tdi_info_.
+  absl::flat_hash_map<uint32, const ::tdi::Table*> tables_by_id_
+      GUARDED_BY(data_lock_);
+  absl::flat_hash_map<std::string, const ::tdi::Table*> tables_by_name_
+      GUARDED_BY(data_lock_);
+
  private:
   // RM Mutex to protect the port status writer.
   mutable absl::Mutex port_status_event_writer_lock_;
@@ -11,16 +11,21 @@
 #include <vector>
 
 #include "absl/strings/match.h"
+#include "absl/strings/str_cat.h"
 #include "absl/synchronization/notification.h"
 #include "gflags/gflags.h"
 #include "idpf/p4info.pb.h"
 #include "p4/config/v1/p4info.pb.h"
+#include "stratum/glue/gtl/map_util.h"
 #include "stratum/glue/status/status_macros.h"
+#include "stratum/hal/lib/p4/p4_table_metadata.h"
+#include "stratum/hal/lib/p4/read_response_batcher.h"
 #include "stratum/hal/lib/p4/utils.h"
 #include "stratum/hal/lib/tdi/tdi_constants.h"
 #include "stratum/hal/lib/tdi/tdi_get_meter_units.h"
 #include "stratum/hal/lib/tdi/tdi_pkt_mod_meter_config.h"
 #include "stratum/hal/lib/tdi/utils.h"
+#include "stratum/lib/metrics.h"
 #include "stratum/lib/utils.h"
 
 // Special version of RETURN_IF_ERROR() that logs an abbreviated message
@@ -43,6 +48,13 @@ DEFINE_uint32(
     tdi_table_sync_timeout_ms,
     stratum::hal::tdi::kDefaultSyncTimeout / absl::Milliseconds(1),
     "The timeout for table sync operation like counters and registers.");
+DEFINE_uint32(tdi_counter_sync_max_staleness_ms, 0,
+              "Maximum age of the last direct counter sync of a table for a "
+              "counter read to be served from it without a new hardware "
+              "sync. 0 syncs on every read, coalescing concurrent reads.");
+DEFINE_uint32(tdi_counter_sync_interval_ms, 0,
+              "Interval of the background sync of the direct counters of the "
+              "tables read with counter data. 0 disables background syncs.");
 
 namespace stratum {
 namespace hal {
@@ -53,6 +65,8 @@ TdiTableManager::TdiTableManager(OperationMode mode,
     : mode_(mode),
       tdi_sde_interface_(ABSL_DIE_IF_NULL(tdi_sde_interface)),
       p4_info_manager_(nullptr),
+      counter_sync_scheduler_(
+          TdiCounterSyncScheduler::CreateInstance(tdi_sde_interface, device)),
       device_(device) {}
 
 std::unique_ptr<TdiTableManager> TdiTableManager::CreateInstance(
@@ -70,10 +84,34 @@ std::unique_ptr<TdiTableManager> TdiTableManager::CreateInstance(
       absl::make_unique<P4InfoManager>(p4_info);
   RETURN_IF_ERROR(p4_info_manager->InitializeAndVerify());
   p4_info_manager_ = std::move(p4_info_manager);
+  write_latency_histograms_.clear();
+  for (const auto& table : p4_info.tables()) {
+    auto& histograms = write_latency_histograms_[table.preamble().id()];
+    for (int type = 0; type < ::p4::v1::Update::Type_ARRAYSIZE; ++type) {
+      histograms[type] = MetricRegistry::GetInstance()->GetHistogram(
+          "stratum_p4rt_table_write_latency_seconds",
+          "Latency of the P4Runtime table entry writes.",
+          {{"table_id", absl::StrCat(table.preamble().id())},
+           {"type", ::p4::v1::Update::Type_Name(type)}});
+    }
+  }
+  // Table IDs may refer to other tables in the new pipeline. The background
+  // sync is stopped before the new tables become visible and restarted below.
+  counter_sync_scheduler_->StopBackgroundSync();
+  counter_sync_scheduler_->Reset();
+  if (FLAGS_tdi_counter_sync_interval_ms > 0) {
+    RETURN_IF_ERROR(counter_sync_scheduler_->StartBackgroundSync(
+        absl::Milliseconds(FLAGS_tdi_counter_sync_interval_ms),
+        absl::Milliseconds(FLAGS_tdi_table_sync_timeout_ms)));
+  }
 
   return ::util::OkStatus();
 }
 
+void TdiTableManager::StopBackgroundCounterSync() {
+  counter_sync_scheduler_->StopBackgroundSync();
+}
+
 ::util::Status TdiTableManager::VerifyForwardingPipelineConfig(
     const ::p4::v1::ForwardingPipelineConfig& config) const {
   // TODO(unknown): Implement if needed.
@@ -84,24 +122,29 @@ std::unique_ptr<TdiTableManager> TdiTableManager::CreateInstance(
     const ::p4::v1::TableEntry& table_entry,
     TdiSdeInterface::TableKeyInterface* table_key) {
   RET_CHECK(table_key);
-  bool needs_priority = false;
-  ASSIGN_OR_RETURN(auto table,
-                   p4_info_manager_->FindTableByID(table_entry.table_id()));
+  ASSIGN_OR_RETURN(
+      const P4TableMetadata* table_metadata,
+      p4_info_manager_->FindTableMetadataByID(table_entry.table_id()));
+  const bool needs_priority = table_metadata->requires_priority();
+
+  // Index the request matches by the position of their field in the table.
+  std::vector<const ::p4::v1::FieldMatch*> matches(
+      table_metadata->num_match_fields(), nullptr);
+  for (const auto& match : table_entry.match()) {
+    int index = table_metadata->MatchFieldIndex(match.field_id());
+    if (index < 0) {
+      return MAKE_ERROR(ERR_INVALID_PARAM)
+             << "Unknown match field " << match.field_id() << " in table "
+             << table_entry.table_id() << ".";
+    }
+    matches[index] = &match;
+  }
 
-  for (const auto& expected_match_field : table.match_fields()) {
-    needs_priority = needs_priority ||
-                     expected_match_field.match_type() ==
-                         ::p4::config::v1::MatchField::TERNARY ||
-                     expected_match_field.match_type() ==
-                         ::p4::config::v1::MatchField::RANGE;
+  for (int i = 0; i < table_metadata->num_match_fields(); ++i) {
+    const auto& expected_match_field = table_metadata->table().match_fields(i);
     auto expected_field_id = expected_match_field.id();
-    auto it =
-        std::find_if(table_entry.match().begin(), table_entry.match().end(),
-                     [expected_field_id](const ::p4::v1::FieldMatch& match) {
-                       return match.field_id() == expected_field_id;
-                     });
-    if (it != table_entry.match().end()) {
-      auto mk = *it;
+    if (matches[i] != nullptr) {
+      const auto& mk = *matches[i];
       switch (mk.field_match_type_case()) {
         case ::p4::v1::FieldMatch::kExact: {
           RET_CHECK(expected_match_field.match_type() ==
@@ -202,9 +245,35 @@ std::unique_ptr<TdiTableManager> TdiTableManager::CreateInstance(
   return ::util::OkStatus();
 }
 
+namespace {
+// Checks that the action of a table entry or default entry is one of the
+// actions the table allows for it.
+::util::Status CheckTableAction(const P4TableMetadata& table_metadata,
+                                const ::p4::v1::TableEntry& table_entry) {
+  if (!table_entry.action().has_action()) return ::util::OkStatus();
+  const uint32 action_id = table_entry.action().action().action_id();
+  if (table_entry.is_default_action()) {
+    if (!table_metadata.IsDefaultAction(action_id)) {
+      return MAKE_ERROR(ERR_INVALID_PARAM)
+             << "Action " << action_id << " is not a valid default action "
+             << "of table " << table_metadata.table().preamble().name() << ".";
+    }
+  } else if (!table_metadata.IsTableAction(action_id)) {
+    return MAKE_ERROR(ERR_INVALID_PARAM)
+           << "Action " << action_id << " is not a valid action of table "
+           << table_metadata.table().preamble().name() << ".";
+  }
+  return ::util::OkStatus();
+}
+}  // namespace
+
 ::util::Status TdiTableManager::BuildTableData(
     const ::p4::v1::TableEntry& table_entry,
     TdiSdeInterface::TableDataInterface* table_data) {
+  ASSIGN_OR_RETURN(
+      const P4TableMetadata* table_metadata,
+      p4_info_manager_->FindTableMetadataByID(table_entry.table_id()));
+  RETURN_IF_ERROR(CheckTableAction(*table_metadata, table_entry));
   switch (table_entry.action().type_case()) {
     case ::p4::v1::TableAction::kAction:
       RETURN_IF_ERROR(
@@ -224,8 +293,7 @@ std::unique_ptr<TdiTableManager> TdiTableManager::CreateInstance(
              << "Unsupported action type: " << table_entry.action().type_case();
   }
 
-  ASSIGN_OR_RETURN(auto table,
-                   p4_info_manager_->FindTableByID(table_entry.table_id()));
+  const auto& table = table_metadata->table();
 
   for (const auto& resource_id : table.direct_resource_ids()) {
     ASSIGN_OR_RETURN(auto resource_type,
@@ -268,14 +336,25 @@ std::unique_ptr<TdiTableManager> TdiTableManager::CreateInstance(
     std::shared_ptr<TdiSdeInterface::SessionInterface> session,
     const ::p4::v1::Update::Type type,
     const ::p4::v1::TableEntry& table_entry) {
-  RET_CHECK(type != ::p4::v1::Update::UNSPECIFIED)
+  RET_CHECK(type != ::p4::v1::Update::UNSPECIFIED &&
+            ::p4::v1::Update::Type_IsValid(type))
       << "Invalid update type " << type;
 
   absl::ReaderMutexLock l(&lock_);
-  ASSIGN_OR_RETURN(auto table,
-                   p4_info_manager_->FindTableByID(table_entry.table_id()));
+  const auto* histograms =
+      gtl::FindOrNull(write_latency_histograms_, table_entry.table_id());
+  ScopedLatencyRecorder latency_recorder(
+      histograms != nullptr ? (*histograms)[type] : nullptr);
+  ASSIGN_OR_RETURN(
+      const P4TableMetadata* table_metadata,
+      p4_info_manager_->FindTableMetadataByID(table_entry.table_id()));
+  const auto& table = table_metadata->table();
   ASSIGN_OR_RETURN(uint32 table_id,
                    tdi_sde_interface_->GetTdiRtId(table_entry.table_id()));
+  // Foreign actions are rejected before the SDE allocates table data for them.
+  if (type != ::p4::v1::Update::DELETE) {
+    RETURN_IF_ERROR(CheckTableAction(*table_metadata, table_entry));
+  }
 
   if (!table_entry.is_default_action()) {
     if (table.is_const_table()) {
@@ -340,15 +419,17 @@ std::unique_ptr<TdiTableManager> TdiTableManager::CreateInstance(
 
 // TODO(max): the need for the original request might go away when the table
 // data is correctly initialized with only the fields we care about.
-::util::StatusOr<::p4::v1::TableEntry> TdiTableManager::BuildP4TableEntry(
+::util::Status TdiTableManager::BuildP4TableEntry(
     const ::p4::v1::TableEntry& request,
     const TdiSdeInterface::TableKeyInterface* table_key,
-    const TdiSdeInterface::TableDataInterface* table_data) {
-  ::p4::v1::TableEntry result;
+    const TdiSdeInterface::TableDataInterface* table_data,
+    ::p4::v1::TableEntry* result) {
+  RET_CHECK(result);
 
-  ASSIGN_OR_RETURN(auto table,
-                   p4_info_manager_->FindTableByID(request.table_id()));
-  result.set_table_id(request.table_id());
+  ASSIGN_OR_RETURN(const P4TableMetadata* table_metadata,
+                   p4_info_manager_->FindTableMetadataByID(request.table_id()));
+  const auto& table = table_metadata->table();
+  result->set_table_id(request.table_id());
 
   bool has_priority_field = false;
   // Match keys
@@ -360,7 +441,7 @@ std::unique_ptr<TdiTableManager> TdiTableManager::CreateInstance(
         MATCH_FIELD_RETURN_IF_ERROR(table_key->GetExact(
             expected_match_field.id(), match.mutable_exact()->mutable_value()));
         if (!IsDontCareMatch(match.exact())) {
-          *result.add_match() = match;
+          *result->add_match() = match;
         }
         break;
       }
@@ -372,7 +453,7 @@ std::unique_ptr<TdiTableManager> TdiTableManager::CreateInstance(
         match.mutable_ternary()->set_value(value);
         match.mutable_ternary()->set_mask(mask);
         if (!IsDontCareMatch(match.ternary())) {
-          *result.add_match() = match;
+          *result->add_match() = match;
         }
         break;
       }
@@ -384,7 +465,7 @@ std::unique_ptr<TdiTableManager> TdiTableManager::CreateInstance(
         match.mutable_lpm()->set_value(prefix);
         match.mutable_lpm()->set_prefix_len(prefix_length);
         if (!IsDontCareMatch(match.lpm())) {
-          *result.add_match() = match;
+          *result->add_match() = match;
         }
         break;
       }
@@ -396,7 +477,7 @@ std::unique_ptr<TdiTableManager> TdiTableManager::CreateInstance(
         match.mutable_range()->set_low(low);
         match.mutable_range()->set_high(high);
         if (!IsDontCareMatch(match.range(), expected_match_field.bitwidth())) {
-          *result.add_match() = match;
+          *result->add_match() = match;
         }
         break;
       }
@@ -421,20 +502,19 @@ std::unique_ptr<TdiTableManager> TdiTableManager::CreateInstance(
     RETURN_IF_ERROR(table_key->GetPriority(&bf_priority));
     ASSIGN_OR_RETURN(uint64 p4rt_priority,
                      ConvertPriorityFromTdiToP4rt(bf_priority));
-    result.set_priority(p4rt_priority);
+    result->set_priority(p4rt_priority);
   }
 
   // Action and action data
   int action_id;
   RETURN_IF_ERROR(table_data->GetActionId(&action_id));
-  // TODO(max): perform check if action id is valid for this table.
   if (action_id) {
     ASSIGN_OR_RETURN(auto action, p4_info_manager_->FindActionByID(action_id));
-    result.mutable_action()->mutable_action()->set_action_id(action_id);
+    result->mutable_action()->mutable_action()->set_action_id(action_id);
     for (const auto& expected_param : action.params()) {
       std::string value;
       RETURN_IF_ERROR(table_data->GetParam(expected_param.id(), &value));
-      auto* param = result.mutable_action()->mutable_action()->add_params();
+      auto* param = result->mutable_action()->mutable_action()->add_params();
       param->set_param_id(expected_param.id());
       param->set_value(value);
     }
@@ -442,13 +522,13 @@ std::unique_ptr<TdiTableManager> TdiTableManager::CreateInstance(
     // Action profile member id
     uint64 action_member_id;
     if (table_data->GetActionMemberId(&action_member_id).ok()) {
-      result.mutable_action()->set_action_profile_member_id(action_member_id);
+      result->mutable_action()->set_action_profile_member_id(action_member_id);
     }
 
     // Action profile group id
     uint64 selector_group_id;
     if (table_data->GetSelectorGroupId(&selector_group_id).ok()) {
-      result.mutable_action()->set_action_profile_group_id(selector_group_id);
+      result->mutable_action()->set_action_profile_group_id(selector_group_id);
     }
   }
 
@@ -468,21 +548,21 @@ std::unique_ptr<TdiTableManager> TdiTableManager::CreateInstance(
       uint64 pburst = 0;
       RETURN_IF_ERROR(
           table_data->GetMeterConfig(false, &cir, &cburst, &pir, &pburst));
-      result.mutable_meter_config()->set_cir(static_cast<int64>(cir));
-      result.mutable_meter_config()->set_cburst(static_cast<int64>(cburst));
-      result.mutable_meter_config()->set_pir(static_cast<int64>(pir));
-      result.mutable_meter_config()->set_pburst(static_cast<int64>(pburst));
+      result->mutable_meter_config()->set_cir(static_cast<int64>(cir));
+      result->mutable_meter_config()->set_cburst(static_cast<int64>(cburst));
+      result->mutable_meter_config()->set_pir(static_cast<int64>(pir));
+      result->mutable_meter_config()->set_pburst(static_cast<int64>(pburst));
     }
     if (resource_type == "Direct-Counter" && request.has_counter_data()) {
       uint64 bytes = 0;
       uint64 packets = 0;
       RETURN_IF_ERROR(table_data->GetCounterData(&bytes, &packets));
-      result.mutable_counter_data()->set_byte_count(bytes);
-      result.mutable_counter_data()->set_packet_count(packets);
+      result->mutable_counter_data()->set_byte_count(bytes);
+      result->mutable_counter_data()->set_packet_count(packets);
     }
   }
 
-  return result;
+  return ::util::OkStatus();
 }
 
 ::util::Status TdiTableManager::ReadSingleTableEntry(
@@ -499,11 +579,10 @@ std::unique_ptr<TdiTableManager> TdiTableManager::CreateInstance(
   RETURN_IF_ERROR(BuildTableKey(table_entry, table_key.get()));
   RETURN_IF_ERROR(tdi_sde_interface_->GetTableEntry(
       device_, session, table_id, table_key.get(), table_data.get()));
-  ASSIGN_OR_RETURN(
-      ::p4::v1::TableEntry result,
-      BuildP4TableEntry(table_entry, table_key.get(), table_data.get()));
   ::p4::v1::ReadResponse resp;
-  *resp.add_entities()->mutable_table_entry() = result;
+  RETURN_IF_ERROR(BuildP4TableEntry(
+      table_entry, table_key.get(), table_data.get(),
+      resp.add_entities()->mutable_table_entry()));
   VLOG(1) << "ReadSingleTableEntry resp " << resp.DebugString();
   if (!writer->Write(resp)) {
     return MAKE_ERROR(ERR_INTERNAL) << "Write to stream for failed.";
@@ -530,14 +609,13 @@ std::unique_ptr<TdiTableManager> TdiTableManager::CreateInstance(
   RETURN_IF_ERROR(tdi_sde_interface_->GetDefaultTableEntry(
       device_, session, table_id, table_data.get()));
   // FIXME: BuildP4TableEntry is not suitable for default entries.
-  ASSIGN_OR_RETURN(
-      ::p4::v1::TableEntry result,
-      BuildP4TableEntry(table_entry, table_key.get(), table_data.get()));
-  result.set_is_default_action(true);
-  result.clear_match();
-
   ::p4::v1::ReadResponse resp;
-  *resp.add_entities()->mutable_table_entry() = result;
+  ::p4::v1::TableEntry* result = resp.add_entities()->mutable_table_entry();
+  RETURN_IF_ERROR(BuildP4TableEntry(table_entry, table_key.get(),
+                                    table_data.get(), result));
+  result->set_is_default_action(true);
+  result->clear_match();
+
   VLOG(1) << "ReadDefaultTableEntry resp " << resp.DebugString();
   if (!writer->Write(resp)) {
     return MAKE_ERROR(ERR_INTERNAL) << "Write to stream for failed.";
@@ -550,39 +628,39 @@ std::unique_ptr<TdiTableManager> TdiTableManager::CreateInstance(
     std::shared_ptr<TdiSdeInterface::SessionInterface> session,
     const ::p4::v1::TableEntry& table_entry,
     WriterInterface<::p4::v1::ReadResponse>* writer) {
-  RET_CHECK(table_entry.match_size() == 0)
-      << "Match filters on wildcard reads are not supported.";
-  RET_CHECK(table_entry.priority() == 0)
-      << "Priority filters on wildcard reads are not supported.";
-  RET_CHECK(table_entry.has_action() == false)
-      << "Action filters on wildcard reads are not supported.";
-  RET_CHECK(table_entry.metadata() == "")
-      << "Metadata filters on wildcard reads are not supported.";
+  // The match fields, priority and action of the request filter the entries.
+  // Controller metadata is not stored by the SDE, so it cannot be filtered on.
+  if (!table_entry.metadata().empty()) {
+    return MAKE_ERROR(ERR_UNIMPLEMENTED)
+           << "Metadata filters on wildcard reads are not supported.";
+  }
   RET_CHECK(table_entry.is_default_action() == false)
       << "Default action filters on wildcard reads are not supported.";
 
+  ASSIGN_OR_RETURN(
+      const P4TableMetadata* table_metadata,
+      p4_info_manager_->FindTableMetadataByID(table_entry.table_id()));
+  RETURN_IF_ERROR(ValidateReadFilter(*table_metadata, table_entry));
   ASSIGN_OR_RETURN(uint32 table_id,
                    tdi_sde_interface_->GetTdiRtId(table_entry.table_id()));
   std::vector<std::unique_ptr<TdiSdeInterface::TableKeyInterface>> keys;
   std::vector<std::unique_ptr<TdiSdeInterface::TableDataInterface>> datas;
   RETURN_IF_ERROR(tdi_sde_interface_->GetAllTableEntries(
       device_, session, table_id, &keys, &datas));
-  ::p4::v1::ReadResponse resp;
+  ReadResponseBatcher batcher(writer);
   for (size_t i = 0; i < keys.size(); ++i) {
-    const std::unique_ptr<TdiSdeInterface::TableKeyInterface>& table_key =
-        keys[i];
-    const std::unique_ptr<TdiSdeInterface::TableDataInterface>& table_data =
-        datas[i];
-    ASSIGN_OR_RETURN(
-        auto result,
-        BuildP4TableEntry(table_entry, table_key.get(), table_data.get()));
-    *resp.add_entities()->mutable_table_entry() = result;
-  }
-
-  VLOG(1) << "ReadAllTableEntries resp " << resp.DebugString();
-  if (!writer->Write(resp)) {
-    return MAKE_ERROR(ERR_INTERNAL) << "Write to stream for failed.";
+    ASSIGN_OR_RETURN(::p4::v1::Entity* entity, batcher.AddEntity());
+    ::p4::v1::TableEntry* result = entity->mutable_table_entry();
+    RETURN_IF_ERROR(BuildP4TableEntry(table_entry, keys[i].get(),
+                                      datas[i].get(), result));
+    if (!MatchesReadFilter(*table_metadata, table_entry, *result)) {
+      batcher.RemoveLastEntity();
+    }
   }
+  RETURN_IF_ERROR(batcher.Finish());
+  VLOG(1) << "ReadAllTableEntries wrote " << batcher.num_responses_written()
+          << " responses for " << keys.size() << " entries of table "
+          << table_entry.table_id() << ".";
 
   return ::util::OkStatus();
 }
@@ -598,7 +676,8 @@ std::unique_ptr<TdiTableManager> TdiTableManager::CreateInstance(
   // 1. table id not set: return all table entries from all tables
   // 2. table id set, no match key: return all table entries of that table
   // 3. table id set, no match key, is_default_action set: return default action
-  // 4. table id and match key: return single entry
+  // 4. table id and match key: return single entry, or all table entries
+  //    matching the key fields if the key is partial
 
   if (table_entry.match_size() == 0 && !table_entry.is_default_action()) {
     // No match keys, and not a default action.
@@ -625,9 +704,10 @@ std::unique_ptr<TdiTableManager> TdiTableManager::CreateInstance(
     if (table_entry.has_counter_data()) {
       // Refresh counter data from hardware.
       for (const auto& wanted_table_entry : wanted_tables) {
-        RETURN_IF_ERROR(tdi_sde_interface_->SynchronizeCounters(
-            device_, session, wanted_table_entry.table_id(),
-            absl::Milliseconds(FLAGS_tdi_table_sync_timeout_ms)));
+        ASSIGN_OR_RETURN(
+            uint32 table_id,
+            tdi_sde_interface_->GetTdiRtId(wanted_table_entry.table_id()));
+        RETURN_IF_ERROR(SyncTableCounters(session, table_id));
       }
     }
     for (const auto& wanted_table_entry : wanted_tables) {
@@ -645,9 +725,20 @@ std::unique_ptr<TdiTableManager> TdiTableManager::CreateInstance(
     // 4. Have table id, have match keys, not default action.
     if (table_entry.has_counter_data()) {
       // Synchronize counter data before reading.
-      RETURN_IF_ERROR(tdi_sde_interface_->SynchronizeCounters(
-          device_, session, table_entry.table_id(),
-          absl::Milliseconds(FLAGS_tdi_table_sync_timeout_ms)));
+      ASSIGN_OR_RETURN(uint32 table_id,
+                       tdi_sde_interface_->GetTdiRtId(table_entry.table_id()));
+      RETURN_IF_ERROR(SyncTableCounters(session, table_id));
+    }
+    ASSIGN_OR_RETURN(
+        const P4TableMetadata* table_metadata,
+        p4_info_manager_->FindTableMetadataByID(table_entry.table_id()));
+    if (!IsCompleteTableKey(*table_metadata, table_entry)) {
+      RETURN_IF_ERROR_WITH_APPEND(
+          ReadAllTableEntries(session, table_entry, writer))
+              .with_logging()
+          << "Failed to read the table entries matching "
+          << table_entry.ShortDebugString() << ".";
+      return ::util::OkStatus();
     }
     return ReadSingleTableEntry(session, table_entry, writer);
   }
@@ -655,6 +746,15 @@ std::unique_ptr<TdiTableManager> TdiTableManager::CreateInstance(
   return MAKE_ERROR(ERR_INTERNAL) << "This should never happen.";
 }
 
+::util::Status TdiTableManager::SyncTableCounters(
+    std::shared_ptr<TdiSdeInterface::SessionInterface> session,
+    uint32 table_id) {
+  return counter_sync_scheduler_->SyncCounters(
+      session, table_id,
+      absl::Milliseconds(FLAGS_tdi_counter_sync_max_staleness_ms),
+      absl::Milliseconds(FLAGS_tdi_table_sync_timeout_ms));
+}
+
 // Modify the counter data of a table entry.
 ::util::Status TdiTableManager::WriteDirectCounterEntry(
     std::shared_ptr<TdiSdeInterface::SessionInterface> session,
@@ -743,8 +843,10 @@ std::unique_ptr<TdiTableManager> TdiTableManager::CreateInstance(
     return ::util::OkStatus();
   }
 
-  ASSIGN_OR_RETURN(auto table,
-                   p4_info_manager_->FindTableByID(table_entry.table_id()));
+  ASSIGN_OR_RETURN(
+      const P4TableMetadata* table_metadata,
+      p4_info_manager_->FindTableMetadataByID(table_entry.table_id()));
+  const auto& table = table_metadata->table();
 
   for (const auto& resource_id : table.direct_resource_ids()) {
     ASSIGN_OR_RETURN(auto resource_type,
@@ -794,9 +896,7 @@ TdiTableManager::ReadDirectCounterEntry(
   }
 
   // Sync table counters.
-  RETURN_IF_ERROR(tdi_sde_interface_->SynchronizeCounters(
-      device_, session, table_id,
-      absl::Milliseconds(FLAGS_tdi_table_sync_timeout_ms)));
+  RETURN_IF_ERROR(SyncTableCounters(session, table_id));
 
   RETURN_IF_ERROR(tdi_sde_interface_->GetTableEntry(
       device_, session, table_id, table_key.get(), table_data.get()));
@@ -839,7 +939,9 @@ TdiTableManager::ReadDirectMeterEntry(
   RETURN_IF_ERROR(tdi_sde_interface_->GetTableEntry(
       device_, session, table_id, table_key.get(), table_data.get()));
 
-  ASSIGN_OR_RETURN(auto table, p4_info_manager_->FindTableByID(table_id));
+  ASSIGN_OR_RETURN(const P4TableMetadata* table_metadata,
+                   p4_info_manager_->FindTableMetadataByID(table_id));
+  const auto& table = table_metadata->table();
 
   ::p4::v1::DirectMeterEntry result = direct_meter_entry;
   for (const auto& resource_id : table.direct_resource_ids()) {
@@ -5,6 +5,7 @@
 #ifndef STRATUM_HAL_LIB_TDI_TDI_TABLE_MANAGER_H_
 #define STRATUM_HAL_LIB_TDI_TDI_TABLE_MANAGER_H_
 
+#include <array>
 #include <memory>
 #include <vector>
 
@@ -19,7 +20,9 @@
 #include "stratum/hal/lib/common/writer_interface.h"
 #include "stratum/hal/lib/p4/p4_info_manager.h"
 #include "stratum/hal/lib/tdi/tdi.pb.h"
+#include "stratum/hal/lib/tdi/tdi_counter_sync_scheduler.h"
 #include "stratum/hal/lib/tdi/tdi_sde_interface.h"
+#include "stratum/lib/metrics.h"
 
 namespace stratum {
 namespace hal {
@@ -31,6 +34,11 @@ class TdiTableManager {
   ::util::Status PushForwardingPipelineConfig(const TdiDeviceConfig& config)
       LOCKS_EXCLUDED(lock_);
 
+  // Stops the background counter sync ahead of a pipeline push, so that no
+  // table is synced while the SDE replaces the pipeline. The next call to
+  // PushForwardingPipelineConfig() restarts it.
+  void StopBackgroundCounterSync() LOCKS_EXCLUDED(lock_);
+
   // Verifies a P4-based forwarding pipeline configuration intended for this
   // manager.
   ::util::Status VerifyForwardingPipelineConfig(
@@ -141,13 +149,19 @@ class TdiTableManager {
       WriterInterface<::p4::v1::ReadResponse>* writer)
       SHARED_LOCKS_REQUIRED(lock_);
 
+  // Synchronizes the direct counters of the given TDI table with the hardware,
+  // unless the last sync is recent enough for the configured staleness.
+  ::util::Status SyncTableCounters(
+      std::shared_ptr<TdiSdeInterface::SessionInterface> session,
+      uint32 table_id);
+
   // Construct a P4RT table entry from a table entry request, table key and
-  // table data.
-  ::util::StatusOr<::p4::v1::TableEntry> BuildP4TableEntry(
+  // table data. The entry is built in place in the given result.
+  ::util::Status BuildP4TableEntry(
       const ::p4::v1::TableEntry& request,
       const TdiSdeInterface::TableKeyInterface* table_key,
-      const TdiSdeInterface::TableDataInterface* table_data)
-      SHARED_LOCKS_REQUIRED(lock_);
+      const TdiSdeInterface::TableDataInterface* table_data,
+      ::p4::v1::TableEntry* result) SHARED_LOCKS_REQUIRED(lock_);
 
   // Determines the mode of operation:
   // - OPERATION_MODE_STANDALONE: when Stratum stack runs independently and
@@ -170,6 +184,16 @@ class TdiTableManager {
   // to all feature managers.
   std::unique_ptr<P4InfoManager> p4_info_manager_ GUARDED_BY(lock_);
 
+  // Write latency histograms per P4 table ID, indexed by update type. Resolved
+  // at pipeline push, so that writes do not touch the metric registry.
+  absl::flat_hash_map<uint32, std::array<LatencyHistogram*,
+                                         ::p4::v1::Update::Type_ARRAYSIZE>>
+      write_latency_histograms_ GUARDED_BY(lock_);
+
+  // Coalesces and rate-limits the hardware syncs of direct counters. Has its
+  // own lock, so it is not guarded by lock_.
+  std::unique_ptr<TdiCounterSyncScheduler> counter_sync_scheduler_;
+
   // Fixed zero-based Tofino device number corresponding to the node/ASIC
   // managed by this class instance. Assigned in the class constructor.
   const int device_;
@@ -10,6 +10,9 @@
 #include <utility>
 
 #include "absl/memory/memory.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/synchronization/notification.h"
+#include "absl/time/clock.h"
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
 #include "stratum/glue/status/status_test_util.h"
@@ -21,6 +24,7 @@
 // FIXME
 DEFINE_string(tdi_sde_config_dir, "/var/run/stratum/tdi_config",
               "The dir used by the SDE to load the device configuration.");
+DECLARE_uint32(tdi_counter_sync_interval_ms);
 
 namespace stratum {
 namespace hal {
@@ -483,6 +487,142 @@ TEST_F(TdiTableManagerTest, RejectMeterEntryReadWithoutId) {
   EXPECT_EQ(ERR_INVALID_PARAM, ret.error_code());
 }
 
+TEST_F(TdiTableManagerTest, RejectForeignTableActions) {
+  ASSERT_OK(PushTestConfig());
+  constexpr int kP4TableId = 33583783;
+  constexpr int kTdiRtTableId = 20;
+  auto session_mock = std::make_shared<SessionMock>();
+  EXPECT_CALL(*tdi_sde_wrapper_mock_, GetTdiRtId(kP4TableId))
+      .WillRepeatedly(Return(kTdiRtTableId));
+  EXPECT_CALL(*tdi_sde_wrapper_mock_, CreateTableData(_, _)).Times(0);
+
+  // The constant default action is not one of the actions of the table.
+  const std::string kTableEntryText = R"pb(
+    table_id: 33583783
+    match {
+      field_id: 1
+      exact { value: "\000\001" }
+    }
+    priority: 10
+    action { action { action_id: 16836487 } }
+  )pb";
+  ::p4::v1::TableEntry entry;
+  ASSERT_OK(ParseProtoFromString(kTableEntryText, &entry));
+  ::util::Status ret = tdi_table_manager_->WriteTableEntry(
+      session_mock, ::p4::v1::Update::INSERT, entry);
+  EXPECT_EQ(ERR_INVALID_PARAM, ret.error_code());
+  EXPECT_THAT(ret.error_message(), HasSubstr("not a valid action"));
+
+  entry.clear_match();
+  entry.clear_priority();
+  entry.set_is_default_action(true);
+  ret = tdi_table_manager_->WriteTableEntry(
+      session_mock, ::p4::v1::Update::MODIFY, entry);
+  EXPECT_EQ(ERR_INVALID_PARAM, ret.error_code());
+  EXPECT_THAT(ret.error_message(), HasSubstr("not a valid default action"));
+}
+
+TEST_F(TdiTableManagerTest, BackgroundCounterSyncIsStoppedDuringPipelinePush) {
+  constexpr int kP4TableId = 33583783;
+  constexpr int kTdiRtTableId = 20;
+  const uint32 saved_interval_ms = FLAGS_tdi_counter_sync_interval_ms;
+  FLAGS_tdi_counter_sync_interval_ms = 1;
+  ASSERT_OK(PushTestConfig());
+
+  absl::Mutex mu;
+  bool push_in_progress = false;
+  int num_syncs = 0;
+  absl::Notification background_sync_done;
+  absl::Notification background_sync_resumed;
+  auto session_mock = std::make_shared<SessionMock>();
+  EXPECT_CALL(*tdi_sde_wrapper_mock_, CreateSession())
+      .WillRepeatedly(Return(std::shared_ptr<TdiSdeInterface::SessionInterface>(
+          std::make_shared<SessionMock>())));
+  EXPECT_CALL(*tdi_sde_wrapper_mock_, GetTdiRtId(kP4TableId))
+      .WillRepeatedly(Return(kTdiRtTableId));
+  EXPECT_CALL(*tdi_sde_wrapper_mock_, CreateTableKey(kTdiRtTableId))
+      .WillRepeatedly(InvokeWithoutArgs([]() {
+        return ::util::StatusOr<
+            std::unique_ptr<TdiSdeInterface::TableKeyInterface>>(
+            absl::make_unique<NiceMock<TableKeyMock>>());
+      }));
+  EXPECT_CALL(*tdi_sde_wrapper_mock_, CreateTableData(kTdiRtTableId, _))
+      .WillRepeatedly(InvokeWithoutArgs([]() {
+        return ::util::StatusOr<
+            std::unique_ptr<TdiSdeInterface::TableDataInterface>>(
+            absl::make_unique<NiceMock<TableDataMock>>());
+      }));
+  EXPECT_CALL(*tdi_sde_wrapper_mock_,
+              GetTableEntry(kDevice1, _, kTdiRtTableId, _, _))
+      .WillRepeatedly(Return(::util::OkStatus()));
+  // No sync may reach the SDE while the pipeline is being replaced.
+  EXPECT_CALL(*tdi_sde_wrapper_mock_,
+              SynchronizeCounters(kDevice1, _, kTdiRtTableId, _))
+      .WillRepeatedly(Invoke([&](int,
+                                 std::shared_ptr<
+                                     TdiSdeInterface::SessionInterface>,
+                                 uint32, absl::Duration) {
+        absl::MutexLock l(&mu);
+        EXPECT_FALSE(push_in_progress);
+        // The first sync after each read is the on-demand one.
+        if (++num_syncs == 3) {
+          if (!background_sync_done.HasBeenNotified()) {
+            background_sync_done.Notify();
+          } else {
+            background_sync_resumed.Notify();
+          }
+        }
+        return ::util::OkStatus();
+      }));
+
+  const std::string kDirectCounterEntryText = R"pb(
+    table_entry {
+      table_id: 33583783
+      match {
+        field_id: 1
+        exact { value: "\000\001" }
+      }
+      match {
+        field_id: 2
+        ternary { value: "\x000" mask: "\xfff" }
+      }
+      priority: 10
+    }
+  )pb";
+  ::p4::v1::DirectCounterEntry entry;
+  ASSERT_OK(ParseProtoFromString(kDirectCounterEntryText, &entry));
+
+  // Register the table with the background sync and let it run.
+  EXPECT_OK(tdi_table_manager_->ReadDirectCounterEntry(session_mock, entry)
+                .status());
+  ASSERT_TRUE(
+      background_sync_done.WaitForNotificationWithTimeout(absl::Seconds(10)));
+
+  // Push a new pipeline the way TdiNode does, giving a running sync thread
+  // plenty of intervals to hit the SDE while the pipeline is replaced.
+  tdi_table_manager_->StopBackgroundCounterSync();
+  {
+    absl::MutexLock l(&mu);
+    push_in_progress = true;
+  }
+  absl::SleepFor(absl::Milliseconds(20));
+  {
+    absl::MutexLock l(&mu);
+    push_in_progress = false;
+    num_syncs = 0;
+  }
+  ASSERT_OK(PushTestConfig());
+
+  // The sync thread is running again after the push.
+  EXPECT_OK(tdi_table_manager_->ReadDirectCounterEntry(session_mock, entry)
+                .status());
+  EXPECT_TRUE(
+      background_sync_resumed.WaitForNotificationWithTimeout(absl::Seconds(10)));
+
+  tdi_table_manager_->StopBackgroundCounterSync();
+  FLAGS_tdi_counter_sync_interval_ms = saved_interval_ms;
+}
+
 }  // namespace tdi
 }  // namespace hal
 }  // namespace stratum
@@ -180,6 +180,7 @@ std::string TofinoSdeWrapper::GetSdeVersion() const { return "9.11.0"; }
   RET_CHECK(device_config.programs_size() > 0);
 
   tdi_id_mapper_.reset();
+  ClearHandleCache();
 
   RETURN_IF_TDI_ERROR(bf_pal_device_warm_init_begin(
       dev_id, BF_DEV_WARM_INIT_FAST_RECFG, BF_DEV_SERDES_UPD_NONE,
@@ -264,6 +265,7 @@ std::string TofinoSdeWrapper::GetSdeVersion() const { return "9.11.0"; }
   tdi_id_mapper_ = TdiIdMapper::CreateInstance();
   RETURN_IF_ERROR(
       tdi_id_mapper_->PushForwardingPipelineConfig(device_config, tdi_info_));
+  RETURN_IF_ERROR(BuildHandleCache(dev_id));
 
   int port = p4_devport_mgr_pcie_cpu_port_get(dev_id);
   RET_CHECK(port != -1);
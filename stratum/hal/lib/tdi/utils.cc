@@ -6,6 +6,7 @@
 #include "stratum/hal/lib/tdi/utils.h"
 
 #include <algorithm>
+#include <string>
 #include <utility>
 
 #include "stratum/hal/lib/tdi/tdi_constants.h"
@@ -77,6 +78,168 @@ int NumBitsToNumBytes(int num_bits) {
   return (num_bits + 7) / 8;  // ceil(num_bits/8)
 }
 
+namespace {
+// Returns true if the two byte strings encode the same unsigned value.
+bool EqualByteStrings(const std::string& a, const std::string& b) {
+  size_t a_start = std::min(a.find_first_not_of('\x00'), a.size());
+  size_t b_start = std::min(b.find_first_not_of('\x00'), b.size());
+  return a.compare(a_start, std::string::npos, b, b_start, std::string::npos) ==
+         0;
+}
+
+// Returns true if the first prefix_len bits of the two values of a field of
+// the given width are equal.
+bool EqualPrefixes(std::string a, std::string b, int prefix_len,
+                   int bitwidth) {
+  const size_t num_bytes = std::max(
+      {static_cast<size_t>(NumBitsToNumBytes(bitwidth)), a.size(), b.size()});
+  a.insert(0, num_bytes - a.size(), '\x00');
+  b.insert(0, num_bytes - b.size(), '\x00');
+  // The prefix starts at the most significant bit of the field.
+  const int num_bits = num_bytes * 8 - bitwidth + prefix_len;
+  const int num_full_bytes = std::min<int>(num_bits / 8, num_bytes);
+  if (a.compare(0, num_full_bytes, b, 0, num_full_bytes) != 0) return false;
+  if (num_full_bytes == static_cast<int>(num_bytes) || num_bits % 8 == 0) {
+    return true;
+  }
+  const uint8 mask = 0xff << (8 - num_bits % 8);
+  return ((a[num_full_bytes] ^ b[num_full_bytes]) & mask) == 0;
+}
+
+const ::p4::v1::FieldMatch* FindFieldMatch(
+    const ::p4::v1::TableEntry& table_entry, uint32 field_id) {
+  for (const auto& match : table_entry.match()) {
+    if (match.field_id() == field_id) return &match;
+  }
+  return nullptr;
+}
+
+// Returns true if the match of a table entry passes a match field filter. A
+// null match is the "don't care" match of the field.
+bool MatchesFieldFilter(const ::p4::config::v1::MatchField& field,
+                        const ::p4::v1::FieldMatch& filter,
+                        const ::p4::v1::FieldMatch* match) {
+  switch (filter.field_match_type_case()) {
+    case ::p4::v1::FieldMatch::kExact:
+      // An entry without the field has the zero value, which is never written
+      // as an explicit match.
+      if (match == nullptr) return EqualByteStrings(filter.exact().value(), "");
+      return match->has_exact() &&
+             EqualByteStrings(filter.exact().value(), match->exact().value());
+    case ::p4::v1::FieldMatch::kLpm: {
+      if (match == nullptr) return IsDontCareMatch(filter.lpm());
+      return match->has_lpm() &&
+             match->lpm().prefix_len() >= filter.lpm().prefix_len() &&
+             EqualPrefixes(filter.lpm().value(), match->lpm().value(),
+                           filter.lpm().prefix_len(), field.bitwidth());
+    }
+    case ::p4::v1::FieldMatch::kTernary:
+      if (match == nullptr) return IsDontCareMatch(filter.ternary());
+      return match->has_ternary() &&
+             EqualByteStrings(filter.ternary().value(),
+                              match->ternary().value()) &&
+             EqualByteStrings(filter.ternary().mask(), match->ternary().mask());
+    case ::p4::v1::FieldMatch::kRange:
+      if (match == nullptr) {
+        return IsDontCareMatch(filter.range(), field.bitwidth());
+      }
+      return match->has_range() &&
+             EqualByteStrings(filter.range().low(), match->range().low()) &&
+             EqualByteStrings(filter.range().high(), match->range().high());
+    case ::p4::v1::FieldMatch::kOptional:
+      return match != nullptr && match->has_optional() &&
+             EqualByteStrings(filter.optional().value(),
+                              match->optional().value());
+    default:
+      return false;
+  }
+}
+
+// Returns true if the action of a table entry passes an action filter. Only
+// the action ID and the parameters set in the filter are compared.
+bool MatchesActionFilter(const ::p4::v1::TableAction& filter,
+                         const ::p4::v1::TableAction& action) {
+  switch (filter.type_case()) {
+    case ::p4::v1::TableAction::kAction: {
+      if (!action.has_action()) return false;
+      if (filter.action().action_id() != 0 &&
+          filter.action().action_id() != action.action().action_id()) {
+        return false;
+      }
+      for (const auto& filter_param : filter.action().params()) {
+        auto it = std::find_if(
+            action.action().params().begin(), action.action().params().end(),
+            [&filter_param](const ::p4::v1::Action::Param& param) {
+              return param.param_id() == filter_param.param_id();
+            });
+        if (it == action.action().params().end() ||
+            !EqualByteStrings(filter_param.value(), it->value())) {
+          return false;
+        }
+      }
+      return true;
+    }
+    case ::p4::v1::TableAction::kActionProfileMemberId:
+      return action.has_action_profile_member_id() &&
+             action.action_profile_member_id() ==
+                 filter.action_profile_member_id();
+    case ::p4::v1::TableAction::kActionProfileGroupId:
+      return action.has_action_profile_group_id() &&
+             action.action_profile_group_id() ==
+                 filter.action_profile_group_id();
+    default:
+      return true;
+  }
+}
+}  // namespace
+
+bool IsCompleteTableKey(const P4TableMetadata& table_metadata,
+                        const ::p4::v1::TableEntry& request) {
+  // A missing field is a wildcard of the read, even if a write would take it
+  // as the "don't care" match. The wildcard read still returns that entry.
+  for (const auto& field : table_metadata.table().match_fields()) {
+    if (FindFieldMatch(request, field.id()) == nullptr) return false;
+  }
+
+  return !table_metadata.requires_priority() || request.priority() != 0;
+}
+
+::util::Status ValidateReadFilter(const P4TableMetadata& table_metadata,
+                                  const ::p4::v1::TableEntry& filter) {
+  for (const auto& filter_match : filter.match()) {
+    if (table_metadata.FindMatchField(filter_match.field_id()) == nullptr) {
+      return MAKE_ERROR(ERR_INVALID_PARAM)
+             << "Unknown match field " << filter_match.field_id()
+             << " in read request for table " << filter.table_id() << ".";
+    }
+  }
+
+  return ::util::OkStatus();
+}
+
+bool MatchesReadFilter(const P4TableMetadata& table_metadata,
+                       const ::p4::v1::TableEntry& filter,
+                       const ::p4::v1::TableEntry& table_entry) {
+  if (filter.priority() != 0 && filter.priority() != table_entry.priority()) {
+    return false;
+  }
+  if (filter.has_action() &&
+      !MatchesActionFilter(filter.action(), table_entry.action())) {
+    return false;
+  }
+  for (const auto& filter_match : filter.match()) {
+    const auto* field = table_metadata.FindMatchField(filter_match.field_id());
+    if (field == nullptr) return false;
+    if (!MatchesFieldFilter(
+            *field, filter_match,
+            FindFieldMatch(table_entry, filter_match.field_id()))) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
 }  // namespace tdi
 }  // namespace hal
 }  // namespace stratum
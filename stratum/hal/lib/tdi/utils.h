@@ -10,10 +10,12 @@
 #include <vector>
 
 #include "absl/synchronization/mutex.h"
+#include "p4/config/v1/p4info.pb.h"
 #include "p4/v1/p4runtime.pb.h"
 #include "stratum/glue/integral_types.h"
 #include "stratum/glue/status/status.h"
 #include "stratum/glue/status/statusor.h"
+#include "stratum/hal/lib/p4/p4_table_metadata.h"
 #include "stratum/hal/lib/tdi/tdi.pb.h"
 #include "stratum/lib/utils.h"
 
@@ -49,6 +51,29 @@ std::string RangeDefaultHigh(size_t bitwidth);
 // byte string.
 int NumBitsToNumBytes(int num_bits);
 
+// Returns true if the match fields of a read request name a single entry of
+// the given table: all match fields are set, and so is the priority if the
+// table needs one. Otherwise the match fields only filter the entries of a
+// wildcard read, and a missing field matches any value.
+bool IsCompleteTableKey(const P4TableMetadata& table_metadata,
+                        const ::p4::v1::TableEntry& request);
+
+// Checks that the match fields of a wildcard read request exist in the given
+// table. Returns ERR_INVALID_PARAM otherwise.
+::util::Status ValidateReadFilter(const P4TableMetadata& table_metadata,
+                                  const ::p4::v1::TableEntry& filter);
+
+// Returns true if a table entry passes the filters of a wildcard read request.
+// The match fields, priority and action of the request are compared when set.
+// An LPM filter also selects the entries with longer prefixes inside its
+// prefix, e.g. 10.1.0.0/16 selects 10.1.2.0/24. The entry must have been
+// built from the table key and data, which omits "don't care" matches. A
+// missing exact match is the zero value of the field. The filter must have
+// passed ValidateReadFilter().
+bool MatchesReadFilter(const P4TableMetadata& table_metadata,
+                       const ::p4::v1::TableEntry& filter,
+                       const ::p4::v1::TableEntry& table_entry);
+
 }  // namespace tdi
 }  // namespace hal
 }  // namespace stratum
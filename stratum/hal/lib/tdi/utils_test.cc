@@ -7,6 +7,10 @@
 
 #include "stratum/hal/lib/tdi/utils.h"
 
+#include <string>
+#include <utility>
+#include <vector>
+
 #include "absl/strings/substitute.h"
 #include "gtest/gtest.h"
 #include "p4/config/v1/p4info.pb.h"
@@ -232,6 +236,185 @@ TEST(ConvertPriorityTest, InvalidTdiPriority) {
               stratum::ErrorCode::ERR_INVALID_PARAM);
 }
 
+namespace {
+
+// A table with an exact, an LPM and a ternary match field.
+constexpr char kReadFilterTable[] = R"pb(
+  preamble { id: 1 }
+  match_fields { id: 1 bitwidth: 9 match_type: EXACT }
+  match_fields { id: 2 bitwidth: 32 match_type: LPM }
+  match_fields { id: 3 bitwidth: 16 match_type: TERNARY }
+)pb";
+
+// An entry of that table, as built from the SDE table key and data.
+constexpr char kReadFilterEntry[] = R"pb(
+  table_id: 1
+  match { field_id: 1 exact { value: "\x00\x05" } }
+  match { field_id: 2 lpm { value: "\x0a\x01\x02\x00" prefix_len: 24 } }
+  priority: 10
+  action {
+    action {
+      action_id: 7
+      params { param_id: 1 value: "\x01" }
+      params { param_id: 2 value: "\x00\x02" }
+    }
+  }
+)pb";
+
+}  // namespace
+
+TEST(IsCompleteTableKeyTest, NeedsAllFieldsAndPriority) {
+  ::p4::config::v1::Table table;
+  ASSERT_OK(ParseProtoFromString(kReadFilterTable, &table));
+  P4TableMetadata table_metadata(table);
+  ::p4::v1::TableEntry request;
+  ASSERT_OK(ParseProtoFromString(kReadFilterEntry, &request));
+  EXPECT_FALSE(IsCompleteTableKey(table_metadata, request));
+  auto* ternary = request.add_match();
+  ternary->set_field_id(3);
+  ternary->mutable_ternary()->set_value(std::string("\x00\x01", 2));
+  ternary->mutable_ternary()->set_mask(std::string("\x00\xff", 2));
+  EXPECT_TRUE(IsCompleteTableKey(table_metadata, request));
+  request.set_priority(0);
+  EXPECT_FALSE(IsCompleteTableKey(table_metadata, request));
+  request.set_priority(10);
+  request.mutable_match()->erase(request.mutable_match()->begin());
+  EXPECT_FALSE(IsCompleteTableKey(table_metadata, request));
+}
+
+TEST(IsCompleteTableKeyTest, MissingLpmFieldIsWildcard) {
+  ::p4::config::v1::Table table;
+  ASSERT_OK(ParseProtoFromString(kReadFilterTable, &table));
+  P4TableMetadata table_metadata(table);
+  ::p4::v1::TableEntry request;
+  ASSERT_OK(ParseProtoFromString(kReadFilterEntry, &request));
+  request.mutable_match()->RemoveLast();
+  EXPECT_FALSE(IsCompleteTableKey(table_metadata, request));
+  // The wildcard read still returns the /0 entry.
+  ::p4::v1::TableEntry entry;
+  ASSERT_OK(ParseProtoFromString(kReadFilterEntry, &entry));
+  entry.mutable_match()->RemoveLast();
+  EXPECT_TRUE(MatchesReadFilter(table_metadata, request, entry));
+}
+
+TEST(ValidateReadFilterTest, RejectsUnknownMatchField) {
+  ::p4::config::v1::Table table;
+  ASSERT_OK(ParseProtoFromString(kReadFilterTable, &table));
+  P4TableMetadata table_metadata(table);
+  ::p4::v1::TableEntry filter;
+  ASSERT_OK(ParseProtoFromString(kReadFilterEntry, &filter));
+  EXPECT_OK(ValidateReadFilter(table_metadata, filter));
+  filter.add_match()->set_field_id(4);
+  ::util::Status status = ValidateReadFilter(table_metadata, filter);
+  EXPECT_EQ(ERR_INVALID_PARAM, status.error_code());
+  EXPECT_THAT(status.error_message(), HasSubstr("Unknown match field 4"));
+}
+
+TEST(MatchesReadFilterTest, EmptyFilterMatchesAllEntries) {
+  ::p4::config::v1::Table table;
+  ASSERT_OK(ParseProtoFromString(kReadFilterTable, &table));
+  P4TableMetadata table_metadata(table);
+  ::p4::v1::TableEntry entry;
+  ASSERT_OK(ParseProtoFromString(kReadFilterEntry, &entry));
+  ::p4::v1::TableEntry filter;
+  filter.set_table_id(1);
+  EXPECT_TRUE(MatchesReadFilter(table_metadata, filter, entry));
+}
+
+TEST(MatchesReadFilterTest, FiltersOnMatchFields) {
+  ::p4::config::v1::Table table;
+  ASSERT_OK(ParseProtoFromString(kReadFilterTable, &table));
+  P4TableMetadata table_metadata(table);
+  ::p4::v1::TableEntry entry;
+  ASSERT_OK(ParseProtoFromString(kReadFilterEntry, &entry));
+  const std::vector<std::pair<std::string, bool>> filters = {
+      // Exact values are compared without leading zeros.
+      {R"pb(match { field_id: 1 exact { value: "\x05" } })pb", true},
+      {R"pb(match { field_id: 1 exact { value: "\x06" } })pb", false},
+      // An LPM filter selects the entries inside its prefix.
+      {R"pb(match { field_id: 2 lpm { value: "\x0a\x01\x00\x00"
+                                      prefix_len: 16 } })pb",
+       true},
+      {R"pb(match { field_id: 2 lpm { value: "\x0a\x01\x02\x00"
+                                      prefix_len: 24 } })pb",
+       true},
+      {R"pb(match { field_id: 2 lpm { value: "\x0a\x02\x00\x00"
+                                      prefix_len: 16 } })pb",
+       false},
+      {R"pb(match { field_id: 2 lpm { value: "\x0a\x01\x02\x00"
+                                      prefix_len: 28 } })pb",
+       false},
+      {R"pb(match { field_id: 2 lpm { value: "\x0a\x00\x00\x00"
+                                      prefix_len: 15 } })pb",
+       true},
+      // The ternary field of the entry is a "don't care".
+      {R"pb(match { field_id: 3 ternary { value: "\x01" mask: "\xff" } })pb",
+       false},
+      {R"pb(match { field_id: 1 exact { value: "\x05" } }
+            match { field_id: 3 ternary { value: "\x00" mask: "\x00" } })pb",
+       true},
+      // Unknown field.
+      {R"pb(match { field_id: 4 exact { value: "\x05" } })pb", false},
+  };
+  for (const auto& e : filters) {
+    ::p4::v1::TableEntry filter;
+    ASSERT_OK(ParseProtoFromString(e.first, &filter));
+    EXPECT_EQ(e.second, MatchesReadFilter(table_metadata, filter, entry))
+        << filter.ShortDebugString();
+  }
+}
+
+TEST(MatchesReadFilterTest, ExactZeroFilterMatchesMissingField) {
+  ::p4::config::v1::Table table;
+  ASSERT_OK(ParseProtoFromString(kReadFilterTable, &table));
+  P4TableMetadata table_metadata(table);
+  ::p4::v1::TableEntry entry;
+  ASSERT_OK(ParseProtoFromString(kReadFilterEntry, &entry));
+  // The exact field of the entry has the value zero.
+  entry.mutable_match()->erase(entry.mutable_match()->begin());
+  const std::vector<std::pair<std::string, bool>> filters = {
+      {R"pb(match { field_id: 1 exact { value: "\x00" } })pb", true},
+      {R"pb(match { field_id: 1 exact { value: "\x00\x00" } })pb", true},
+      {R"pb(match { field_id: 1 exact { value: "\x05" } })pb", false},
+  };
+  for (const auto& e : filters) {
+    ::p4::v1::TableEntry filter;
+    ASSERT_OK(ParseProtoFromString(e.first, &filter));
+    EXPECT_EQ(e.second, MatchesReadFilter(table_metadata, filter, entry))
+        << filter.ShortDebugString();
+  }
+}
+
+TEST(MatchesReadFilterTest, FiltersOnPriorityAndAction) {
+  ::p4::config::v1::Table table;
+  ASSERT_OK(ParseProtoFromString(kReadFilterTable, &table));
+  P4TableMetadata table_metadata(table);
+  ::p4::v1::TableEntry entry;
+  ASSERT_OK(ParseProtoFromString(kReadFilterEntry, &entry));
+  const std::vector<std::pair<std::string, bool>> filters = {
+      {R"pb(priority: 10)pb", true},
+      {R"pb(priority: 11)pb", false},
+      {R"pb(action { action { action_id: 7 } })pb", true},
+      {R"pb(action { action { action_id: 8 } })pb", false},
+      {R"pb(action { action { params { param_id: 2 value: "\x02" } } })pb",
+       true},
+      {R"pb(action {
+              action {
+                action_id: 7
+                params { param_id: 1 value: "\x02" }
+              }
+            })pb",
+       false},
+      {R"pb(action { action_profile_member_id: 1 })pb", false},
+  };
+  for (const auto& e : filters) {
+    ::p4::v1::TableEntry filter;
+    ASSERT_OK(ParseProtoFromString(e.first, &filter));
+    EXPECT_EQ(e.second, MatchesReadFilter(table_metadata, filter, entry))
+        << filter.ShortDebugString();
+  }
+}
+
 }  // namespace tdi
 }  // namespace hal
 }  // namespace stratum
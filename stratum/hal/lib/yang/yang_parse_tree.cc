@@ -48,11 +48,27 @@ void TreeNode::CopySubtree(const TreeNode& src) {
 
   // Deep-copy children.
   for (const auto& entry : src.children_) {
-    children_.emplace(entry.first, TreeNode(*this, entry.first));
-    children_[entry.first].CopySubtree(entry.second);
+    AddChild(entry.first)->CopySubtree(entry.second);
   }
 }
 
+const TreeNode* TreeNode::FindChildOrNull(absl::string_view name) const {
+  auto it = child_index_.find(name);
+  return it != child_index_.end() ? it->second : nullptr;
+}
+
+TreeNode* TreeNode::AddChild(const std::string& name, bool is_name_a_key) {
+  TreeNode* child = gtl::FindOrNull(children_, name);
+  if (child != nullptr) return child;
+  auto it =
+      children_.emplace(name, TreeNode(*this, name, is_name_a_key)).first;
+  child = &it->second;
+  // Entries of a std::map are never moved, so both the key and the pointer
+  // stay valid.
+  child_index_[it->first] = child;
+  return child;
+}
+
 ::util::Status TreeNode::VisitThisNodeAndItsChildren(
     const TreeNodeEventHandlerPtr& handler, const GnmiEvent& event,
     const ::gnmi::Path& path, GnmiSubscribeStream* stream) const {
@@ -104,14 +120,16 @@ const TreeNode* TreeNode::FindNodeOrNull(const ::gnmi::Path& path) const {
   // Map the input path to the supported one - walk the tree of known elements
   // element by element starting from this node and if the element is found the
   // move to the next one. If not found, return an error (nullptr).
+  static const std::string* const kNameKey = new std::string("name");
   int element = 0;
   const TreeNode* node = this;
   for (; node != nullptr && !node->children_.empty() &&
          element < path.elem_size();) {
-    node = gtl::FindOrNull(node->children_, path.elem(element).name());
-    auto* search = gtl::FindOrNull(path.elem(element).key(), "name");
+    const ::gnmi::PathElem& elem = path.elem(element);
+    node = node->FindChildOrNull(elem.name());
+    auto* search = gtl::FindOrNull(elem.key(), *kNameKey);
     if (search != nullptr && node != nullptr) {
-      node = gtl::FindOrNull(node->children_, *search);
+      node = node->FindChildOrNull(*search);
     }
     ++element;
   }
@@ -233,29 +251,16 @@ TreeNode* YangParseTree::AddNode(const ::gnmi::Path& path) {
   // No need to lock the mutex - it is locked by the method calling this one.
   TreeNode* node = &root_;
   for (const auto& element : path.elem()) {
-    TreeNode* child = gtl::FindOrNull(node->children_, element.name());
-    if (child == nullptr) {
-      // This path is not supported yet. Let's add a node with default
-      // processing.
-      node->children_.emplace(element.name(), TreeNode(*node, element.name()));
-      child = gtl::FindOrNull(node->children_, element.name());
-    }
-    node = child;
+    // If this path is not supported yet, a node with default processing is
+    // added.
+    node = node->AddChild(element.name());
     auto* search = gtl::FindOrNull(element.key(), "name");
     if (search == nullptr) {
       continue;
     }
 
     // A filtering pattern has been found!
-    child = gtl::FindOrNull(node->children_, *search);
-    if (child == nullptr) {
-      // This path is not supported yet. Let's add a node with default
-      // processing.
-      node->children_.emplace(
-          *search, TreeNode(*node, *search, true /* mark as a key */));
-      child = gtl::FindOrNull(node->children_, *search);
-    }
-    node = child;
+    node = node->AddChild(*search, true /* mark as a key */);
   }
   return node;
 }
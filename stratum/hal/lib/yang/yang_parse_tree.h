@@ -11,6 +11,8 @@
 #include <unordered_map>
 #include <utility>
 
+#include "absl/container/flat_hash_map.h"
+#include "absl/strings/string_view.h"
 #include "absl/synchronization/mutex.h"
 #include "gnmi/gnmi.grpc.pb.h"
 #include "stratum/glue/status/status.h"
@@ -84,6 +86,9 @@ class TreeNode {
         supports_on_replace_(false),
         supports_on_delete_(false) {}
   TreeNode(const TreeNode& src);
+  // Assigning a node would copy the child index of 'src', which points into
+  // the children of 'src'.
+  TreeNode& operator=(const TreeNode&) = delete;
 
   void CopySubtree(const TreeNode& src);
 
@@ -295,6 +300,13 @@ class TreeNode {
   // Returns path from root to this node.
   ::gnmi::Path GetPath() const;
 
+  // Returns the child named 'name' or nullptr if there is none.
+  const TreeNode* FindChildOrNull(absl::string_view name) const;
+
+  // Returns the child named 'name', adding it if it does not exist yet.
+  // Children must only be added with this method, so they are indexed.
+  TreeNode* AddChild(const std::string& name, bool is_name_a_key = false);
+
   std::map<std::string, TreeNode> children_;
 
  private:
@@ -382,6 +394,10 @@ class TreeNode {
   };
   const TreeNode* parent_;
   std::string name_;
+  // The entries of children_ by name. The keys point to the keys of
+  // children_, so looking up a path element neither allocates nor compares
+  // strings along the std::map.
+  absl::flat_hash_map<absl::string_view, TreeNode*> child_index_;
   // Some nodes are mapped to ::gnmi::PathElem 'name' key value. This variable
   // is used to mark them as such.
   bool is_name_a_key_ = false;
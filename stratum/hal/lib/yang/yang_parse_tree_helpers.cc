@@ -70,7 +70,7 @@ namespace helpers {
     LOG(ERROR) << "Message cannot be sent as the stream pointer is null!";
     return MAKE_ERROR(ERR_INTERNAL) << "stream pointer is null!";
   }
-  if (stream->Write(resp, ::grpc::WriteOptions()) == false) {
+  if (stream->Write(resp) == false) {
     return MAKE_ERROR(ERR_INTERNAL)
            << "Writing response to stream failed: " << resp.ShortDebugString();
   }
@@ -389,6 +389,16 @@ TreeNodeEventRegistration RegisterFunc() {
   };
 }
 
+// Port-specific version. The handler is only called for events of the port
+// 'port_id' of node 'node_id'.
+template <typename E>
+TreeNodeEventRegistration RegisterFunc(uint64 node_id, uint32 port_id) {
+  return [node_id, port_id](const EventHandlerRecordPtr& record) {
+    return EventHandlerList<E>::GetInstance()->Register(node_id, port_id,
+                                                        record);
+  };
+}
+
 // A helper method that hides the details of registering an event handler into
 // two per event type handler lists.
 template <typename E1, typename E2>
@@ -78,7 +78,8 @@ void SetUpInterfacesInterfaceStateLastChange(uint64 node_id, uint32 port_id,
                        &OperStatus::time_last_changed);
   auto on_change_functor = GetOnChangeFunctor(
       node_id, port_id, &PortOperStateChangedEvent::GetTimeLastChanged);
-  auto register_functor = RegisterFunc<PortOperStateChangedEvent>();
+  auto register_functor =
+      RegisterFunc<PortOperStateChangedEvent>(node_id, port_id);
   node->SetOnTimerHandler(poll_functor)
       ->SetOnPollHandler(poll_functor)
       ->SetOnChangeRegistration(register_functor)
@@ -144,7 +145,8 @@ void SetUpInterfacesInterfaceStateOperStatus(uint64 node_id, uint32 port_id,
   auto on_change_functor = GetOnChangeFunctor(
       node_id, port_id, &PortOperStateChangedEvent::GetNewState,
       ConvertPortStateToString);
-  auto register_functor = RegisterFunc<PortOperStateChangedEvent>();
+  auto register_functor =
+      RegisterFunc<PortOperStateChangedEvent>(node_id, port_id);
   node->SetOnTimerHandler(poll_functor)
       ->SetOnPollHandler(poll_functor)
       ->SetOnChangeRegistration(register_functor)
@@ -164,7 +166,8 @@ void SetUpInterfacesInterfaceStateAdminStatus(uint64 node_id, uint32 port_id,
   auto on_change_functor = GetOnChangeFunctor(
       node_id, port_id, &PortAdminStateChangedEvent::GetNewState,
       ConvertAdminStateToString);
-  auto register_functor = RegisterFunc<PortAdminStateChangedEvent>();
+  auto register_functor =
+      RegisterFunc<PortAdminStateChangedEvent>(node_id, port_id);
   node->SetOnTimerHandler(poll_functor)
       ->SetOnPollHandler(poll_functor)
       ->SetOnChangeRegistration(register_functor)
@@ -185,7 +188,8 @@ void SetUpInterfacesInterfaceStateLoopbackMode(uint64 node_id, uint32 port_id,
   auto on_change_functor = GetOnChangeFunctor(
       node_id, port_id, &PortLoopbackStateChangedEvent::GetNewState,
       IsLoopbackStateEnabled);
-  auto register_functor = RegisterFunc<PortLoopbackStateChangedEvent>();
+  auto register_functor =
+      RegisterFunc<PortLoopbackStateChangedEvent>(node_id, port_id);
   node->SetOnTimerHandler(poll_functor)
       ->SetOnPollHandler(poll_functor)
       ->SetOnChangeRegistration(register_functor)
@@ -222,7 +226,8 @@ void SetUpInterfacesInterfaceEthernetStatePortSpeed(uint64 node_id,
   auto on_change_functor = GetOnChangeFunctor(
       node_id, port_id, &PortSpeedBpsChangedEvent::GetSpeedBps,
       ConvertSpeedBpsToString);
-  auto register_functor = RegisterFunc<PortSpeedBpsChangedEvent>();
+  auto register_functor =
+      RegisterFunc<PortSpeedBpsChangedEvent>(node_id, port_id);
   node->SetOnTimerHandler(poll_functor)
       ->SetOnPollHandler(poll_functor)
       ->SetOnChangeRegistration(register_functor)
@@ -242,7 +247,8 @@ void SetUpInterfacesInterfaceEthernetStateNegotiatedPortSpeed(
       node_id, port_id,
       &PortNegotiatedSpeedBpsChangedEvent::GetNegotiatedSpeedBps,
       ConvertSpeedBpsToString);
-  auto register_functor = RegisterFunc<PortNegotiatedSpeedBpsChangedEvent>();
+  auto register_functor =
+      RegisterFunc<PortNegotiatedSpeedBpsChangedEvent>(node_id, port_id);
   node->SetOnTimerHandler(poll_functor)
       ->SetOnPollHandler(poll_functor)
       ->SetOnChangeRegistration(register_functor)
@@ -259,7 +265,8 @@ void SetUpInterfacesInterfaceStateCountersInOctets(uint64 node_id,
       GetPollCounterFunctor(node_id, port_id, &PortCounters::in_octets, tree);
   auto on_change_functor = GetOnChangeFunctor(
       node_id, port_id, &PortCountersChangedEvent::GetInOctets);
-  auto register_functor = RegisterFunc<PortCountersChangedEvent>();
+  auto register_functor =
+      RegisterFunc<PortCountersChangedEvent>(node_id, port_id);
   node->SetOnTimerHandler(poll_functor)
       ->SetOnPollHandler(poll_functor)
       ->SetOnChangeRegistration(register_functor)
@@ -282,7 +289,8 @@ void SetUpInterfacesInterfaceStateCountersOutOctets(uint64 node_id,
       GetPollCounterFunctor(node_id, port_id, &PortCounters::out_octets, tree);
   auto on_change_functor = GetOnChangeFunctor(
       node_id, port_id, &PortCountersChangedEvent::GetOutOctets);
-  auto register_functor = RegisterFunc<PortCountersChangedEvent>();
+  auto register_functor =
+      RegisterFunc<PortCountersChangedEvent>(node_id, port_id);
   node->SetOnTimerHandler(poll_functor)
       ->SetOnPollHandler(poll_functor)
       ->SetOnChangeRegistration(register_functor)
@@ -305,7 +313,8 @@ void SetUpInterfacesInterfaceStateCountersInUnicastPkts(uint64 node_id,
       node_id, port_id, &PortCounters::in_unicast_pkts, tree);
   auto on_change_functor = GetOnChangeFunctor(
       node_id, port_id, &PortCountersChangedEvent::GetInUnicastPkts);
-  auto register_functor = RegisterFunc<PortCountersChangedEvent>();
+  auto register_functor =
+      RegisterFunc<PortCountersChangedEvent>(node_id, port_id);
   node->SetOnTimerHandler(poll_functor)
       ->SetOnPollHandler(poll_functor)
       ->SetOnChangeRegistration(register_functor)
@@ -328,7 +337,8 @@ void SetUpInterfacesInterfaceStateCountersOutUnicastPkts(uint64 node_id,
       node_id, port_id, &PortCounters::out_unicast_pkts, tree);
   auto on_change_functor = GetOnChangeFunctor(
       node_id, port_id, &PortCountersChangedEvent::GetOutUnicastPkts);
-  auto register_functor = RegisterFunc<PortCountersChangedEvent>();
+  auto register_functor =
+      RegisterFunc<PortCountersChangedEvent>(node_id, port_id);
   node->SetOnTimerHandler(poll_functor)
       ->SetOnPollHandler(poll_functor)
       ->SetOnChangeRegistration(register_functor)
@@ -351,7 +361,8 @@ void SetUpInterfacesInterfaceStateCountersInBroadcastPkts(uint64 node_id,
       node_id, port_id, &PortCounters::in_broadcast_pkts, tree);
   auto on_change_functor = GetOnChangeFunctor(
       node_id, port_id, &PortCountersChangedEvent::GetInBroadcastPkts);
-  auto register_functor = RegisterFunc<PortCountersChangedEvent>();
+  auto register_functor =
+      RegisterFunc<PortCountersChangedEvent>(node_id, port_id);
   node->SetOnTimerHandler(poll_functor)
       ->SetOnPollHandler(poll_functor)
       ->SetOnChangeRegistration(register_functor)
@@ -372,7 +383,8 @@ void SetUpInterfacesInterfaceStateCountersOutBroadcastPkts(
       node_id, port_id, &PortCounters::out_broadcast_pkts, tree);
   auto on_change_functor = GetOnChangeFunctor(
       node_id, port_id, &PortCountersChangedEvent::GetOutBroadcastPkts);
-  auto register_functor = RegisterFunc<PortCountersChangedEvent>();
+  auto register_functor =
+      RegisterFunc<PortCountersChangedEvent>(node_id, port_id);
   node->SetOnTimerHandler(poll_functor)
       ->SetOnPollHandler(poll_functor)
       ->SetOnChangeRegistration(register_functor)
@@ -395,7 +407,8 @@ void SetUpInterfacesInterfaceStateCountersInMulticastPkts(uint64 node_id,
       node_id, port_id, &PortCounters::in_multicast_pkts, tree);
   auto on_change_functor = GetOnChangeFunctor(
       node_id, port_id, &PortCountersChangedEvent::GetInMulticastPkts);
-  auto register_functor = RegisterFunc<PortCountersChangedEvent>();
+  auto register_functor =
+      RegisterFunc<PortCountersChangedEvent>(node_id, port_id);
   node->SetOnTimerHandler(poll_functor)
       ->SetOnPollHandler(poll_functor)
       ->SetOnChangeRegistration(register_functor)
@@ -416,7 +429,8 @@ void SetUpInterfacesInterfaceStateCountersOutMulticastPkts(
       node_id, port_id, &PortCounters::out_multicast_pkts, tree);
   auto on_change_functor = GetOnChangeFunctor(
       node_id, port_id, &PortCountersChangedEvent::GetOutMulticastPkts);
-  auto register_functor = RegisterFunc<PortCountersChangedEvent>();
+  auto register_functor =
+      RegisterFunc<PortCountersChangedEvent>(node_id, port_id);
   node->SetOnTimerHandler(poll_functor)
       ->SetOnPollHandler(poll_functor)
       ->SetOnChangeRegistration(register_functor)
@@ -439,7 +453,8 @@ void SetUpInterfacesInterfaceStateCountersInDiscards(uint64 node_id,
       GetPollCounterFunctor(node_id, port_id, &PortCounters::in_discards, tree);
   auto on_change_functor = GetOnChangeFunctor(
       node_id, port_id, &PortCountersChangedEvent::GetInDiscards);
-  auto register_functor = RegisterFunc<PortCountersChangedEvent>();
+  auto register_functor =
+      RegisterFunc<PortCountersChangedEvent>(node_id, port_id);
   node->SetOnTimerHandler(poll_functor)
       ->SetOnPollHandler(poll_functor)
       ->SetOnChangeRegistration(register_functor)
@@ -462,7 +477,8 @@ void SetUpInterfacesInterfaceStateCountersOutDiscards(uint64 node_id,
                                             &PortCounters::out_discards, tree);
   auto on_change_functor = GetOnChangeFunctor(
       node_id, port_id, &PortCountersChangedEvent::GetOutDiscards);
-  auto register_functor = RegisterFunc<PortCountersChangedEvent>();
+  auto register_functor =
+      RegisterFunc<PortCountersChangedEvent>(node_id, port_id);
   node->SetOnTimerHandler(poll_functor)
       ->SetOnPollHandler(poll_functor)
       ->SetOnChangeRegistration(register_functor)
@@ -485,7 +501,8 @@ void SetUpInterfacesInterfaceStateCountersInUnknownProtos(uint64 node_id,
       node_id, port_id, &PortCounters::in_unknown_protos, tree);
   auto on_change_functor = GetOnChangeFunctor(
       node_id, port_id, &PortCountersChangedEvent::GetInUnknownProtos);
-  auto register_functor = RegisterFunc<PortCountersChangedEvent>();
+  auto register_functor =
+      RegisterFunc<PortCountersChangedEvent>(node_id, port_id);
   node->SetOnTimerHandler(poll_functor)
       ->SetOnPollHandler(poll_functor)
       ->SetOnChangeRegistration(register_functor)
@@ -508,7 +525,8 @@ void SetUpInterfacesInterfaceStateCountersInErrors(uint64 node_id,
       GetPollCounterFunctor(node_id, port_id, &PortCounters::in_errors, tree);
   auto on_change_functor = GetOnChangeFunctor(
       node_id, port_id, &PortCountersChangedEvent::GetInErrors);
-  auto register_functor = RegisterFunc<PortCountersChangedEvent>();
+  auto register_functor =
+      RegisterFunc<PortCountersChangedEvent>(node_id, port_id);
   node->SetOnTimerHandler(poll_functor)
       ->SetOnPollHandler(poll_functor)
       ->SetOnChangeRegistration(register_functor)
@@ -531,7 +549,8 @@ void SetUpInterfacesInterfaceStateCountersOutErrors(uint64 node_id,
       GetPollCounterFunctor(node_id, port_id, &PortCounters::out_errors, tree);
   auto on_change_functor = GetOnChangeFunctor(
       node_id, port_id, &PortCountersChangedEvent::GetOutErrors);
-  auto register_functor = RegisterFunc<PortCountersChangedEvent>();
+  auto register_functor =
+      RegisterFunc<PortCountersChangedEvent>(node_id, port_id);
   node->SetOnTimerHandler(poll_functor)
       ->SetOnPollHandler(poll_functor)
       ->SetOnChangeRegistration(register_functor)
@@ -554,7 +573,8 @@ void SetUpInterfacesInterfaceStateCountersInFcsErrors(uint64 node_id,
                                             &PortCounters::in_fcs_errors, tree);
   auto on_change_functor = GetOnChangeFunctor(
       node_id, port_id, &PortCountersChangedEvent::GetInFcsErrors);
-  auto register_functor = RegisterFunc<PortCountersChangedEvent>();
+  auto register_functor =
+      RegisterFunc<PortCountersChangedEvent>(node_id, port_id);
   node->SetOnTimerHandler(poll_functor)
       ->SetOnPollHandler(poll_functor)
       ->SetOnChangeRegistration(register_functor)
@@ -580,7 +600,8 @@ void SetUpLacpInterfacesInterfaceStateSystemPriority(uint64 node_id,
       &SystemPriority::priority);
   auto on_change_functor = GetOnChangeFunctor(
       node_id, port_id, &PortLacpSystemPriorityChangedEvent::GetSystemPriority);
-  auto register_functor = RegisterFunc<PortLacpSystemPriorityChangedEvent>();
+  auto register_functor =
+      RegisterFunc<PortLacpSystemPriorityChangedEvent>(node_id, port_id);
   node->SetOnTimerHandler(poll_functor)
       ->SetOnPollHandler(poll_functor)
       ->SetOnChangeRegistration(register_functor)
@@ -649,7 +670,8 @@ void SetUpInterfacesInterfaceConfigHealthIndicator(const std::string& state,
   auto on_change_functor = GetOnChangeFunctor(
       node_id, port_id, &PortHealthIndicatorChangedEvent::GetState,
       ConvertHealthStateToString);
-  auto register_functor = RegisterFunc<PortHealthIndicatorChangedEvent>();
+  auto register_functor =
+      RegisterFunc<PortHealthIndicatorChangedEvent>(node_id, port_id);
   node->SetOnTimerHandler(poll_functor)
       ->SetOnPollHandler(poll_functor)
       ->SetOnChangeRegistration(register_functor)
@@ -673,7 +695,8 @@ void SetUpInterfacesInterfaceStateHealthIndicator(uint64 node_id,
   auto on_change_functor = GetOnChangeFunctor(
       node_id, port_id, &PortHealthIndicatorChangedEvent::GetState,
       ConvertHealthStateToString);
-  auto register_functor = RegisterFunc<PortHealthIndicatorChangedEvent>();
+  auto register_functor =
+      RegisterFunc<PortHealthIndicatorChangedEvent>(node_id, port_id);
   node->SetOnTimerHandler(poll_functor)
       ->SetOnPollHandler(poll_functor)
       ->SetOnChangeRegistration(register_functor)
@@ -746,7 +769,8 @@ void SetUpInterfacesInterfaceEthernetStateForwardingViability(
   auto on_change_functor = GetOnChangeFunctor(
       node_id, port_id, &PortForwardingViabilityChangedEvent::GetState,
       ConvertTrunkMemberBlockStateToBool);
-  auto register_functor = RegisterFunc<PortForwardingViabilityChangedEvent>();
+  auto register_functor =
+      RegisterFunc<PortForwardingViabilityChangedEvent>(node_id, port_id);
   node->SetOnTimerHandler(poll_functor)
       ->SetOnPollHandler(poll_functor)
       ->SetOnChangeRegistration(register_functor)
@@ -767,7 +791,8 @@ void SetUpInterfacesInterfaceEthernetStateAutoNegotiate(uint64 node_id,
   auto on_change_functor =
       GetOnChangeFunctor(node_id, port_id, &PortAutonegChangedEvent::GetState,
                          IsPortAutonegEnabled);
-  auto register_functor = RegisterFunc<PortAutonegChangedEvent>();
+  auto register_functor =
+      RegisterFunc<PortAutonegChangedEvent>(node_id, port_id);
   node->SetOnTimerHandler(poll_functor)
       ->SetOnPollHandler(poll_functor)
       ->SetOnChangeRegistration(register_functor)
@@ -802,7 +827,8 @@ void SetUpQosInterfacesInterfaceOutputQueuesQueueStateId(uint64 node_id,
       &DataResponse::has_port_qos_counters,
       &DataRequest::Request::mutable_port_qos_counters,
       &PortQosCounters::queue_id);
-  auto register_functor = RegisterFunc<PortQosCountersChangedEvent>();
+  auto register_functor =
+      RegisterFunc<PortQosCountersChangedEvent>(node_id, port_id);
   auto on_change_functor = GetOnChangeFunctor(
       node_id, port_id, queue_id, &PortQosCountersChangedEvent::GetQueueId);
   node->SetOnTimerHandler(poll_functor)
@@ -822,7 +848,8 @@ void SetUpQosInterfacesInterfaceOutputQueuesQueueStateTransmitPkts(
       &DataResponse::has_port_qos_counters,
       &DataRequest::Request::mutable_port_qos_counters,
       &PortQosCounters::out_pkts);
-  auto register_functor = RegisterFunc<PortQosCountersChangedEvent>();
+  auto register_functor =
+      RegisterFunc<PortQosCountersChangedEvent>(node_id, port_id);
   auto on_change_functor =
       GetOnChangeFunctor(node_id, port_id, queue_id,
                          &PortQosCountersChangedEvent::GetTransmitPkts);
@@ -843,7 +870,8 @@ void SetUpQosInterfacesInterfaceOutputQueuesQueueStateTransmitOctets(
       &DataResponse::has_port_qos_counters,
       &DataRequest::Request::mutable_port_qos_counters,
       &PortQosCounters::out_octets);
-  auto register_functor = RegisterFunc<PortQosCountersChangedEvent>();
+  auto register_functor =
+      RegisterFunc<PortQosCountersChangedEvent>(node_id, port_id);
   auto on_change_functor =
       GetOnChangeFunctor(node_id, port_id, queue_id,
                          &PortQosCountersChangedEvent::GetTransmitOctets);
@@ -864,7 +892,8 @@ void SetUpQosInterfacesInterfaceOutputQueuesQueueStateDroppedPkts(
       &DataResponse::has_port_qos_counters,
       &DataRequest::Request::mutable_port_qos_counters,
       &PortQosCounters::out_dropped_pkts);
-  auto register_functor = RegisterFunc<PortQosCountersChangedEvent>();
+  auto register_functor =
+      RegisterFunc<PortQosCountersChangedEvent>(node_id, port_id);
   auto on_change_functor = GetOnChangeFunctor(
       node_id, port_id, queue_id, &PortQosCountersChangedEvent::GetDroppedPkts);
   node->SetOnTimerHandler(poll_functor)
@@ -40,7 +40,8 @@ void SetUpLacpInterfacesInterfaceStateSystemIdMac(uint64 node_id,
   auto on_change_functor = GetOnChangeFunctor(
       node_id, port_id, &PortLacpRouterMacChangedEvent::GetSystemIdMac,
       MacAddressToYangString);
-  auto register_functor = RegisterFunc<PortLacpRouterMacChangedEvent>();
+  auto register_functor =
+      RegisterFunc<PortLacpRouterMacChangedEvent>(node_id, port_id);
   node->SetOnTimerHandler(poll_functor)
       ->SetOnPollHandler(poll_functor)
       ->SetOnChangeRegistration(register_functor)
@@ -61,7 +62,8 @@ void SetUpInterfacesInterfaceEthernetStateMacAddress(uint64 node_id,
   auto on_change_functor = GetOnChangeFunctor(
       node_id, port_id, &PortMacAddressChangedEvent::GetMacAddress,
       MacAddressToYangString);
-  auto register_functor = RegisterFunc<PortMacAddressChangedEvent>();
+  auto register_functor =
+      RegisterFunc<PortMacAddressChangedEvent>(node_id, port_id);
   node->SetOnTimerHandler(poll_functor)
       ->SetOnPollHandler(poll_functor)
       ->SetOnChangeRegistration(register_functor)
@@ -127,7 +129,8 @@ void SetUpInterfacesInterfaceEthernetConfigPortSpeed(uint64 node_id,
 
     return ::util::OkStatus();
   };
-  auto register_functor = RegisterFunc<PortSpeedBpsChangedEvent>();
+  auto register_functor =
+      RegisterFunc<PortSpeedBpsChangedEvent>(node_id, port_id);
   auto on_change_functor = GetOnChangeFunctor(
       node_id, port_id, &PortSpeedBpsChangedEvent::GetSpeedBps,
       ConvertSpeedBpsToString);
@@ -195,7 +198,8 @@ void SetUpInterfacesInterfaceEthernetConfigAutoNegotiate(uint64 node_id,
 
     return ::util::OkStatus();
   };
-  auto register_functor = RegisterFunc<PortAutonegChangedEvent>();
+  auto register_functor =
+      RegisterFunc<PortAutonegChangedEvent>(node_id, port_id);
   auto on_change_functor =
       GetOnChangeFunctor(node_id, port_id, &PortAutonegChangedEvent::GetState,
                          IsPortAutonegEnabled);
@@ -261,7 +265,8 @@ void SetUpInterfacesInterfaceConfigEnabled(const bool state, uint64 node_id,
 
     return ::util::OkStatus();
   };
-  auto register_functor = RegisterFunc<PortAdminStateChangedEvent>();
+  auto register_functor =
+      RegisterFunc<PortAdminStateChangedEvent>(node_id, port_id);
   auto on_change_functor = GetOnChangeFunctor(
       node_id, port_id, &PortAdminStateChangedEvent::GetNewState,
       IsAdminStateEnabled);
@@ -329,7 +334,8 @@ void SetUpInterfacesInterfaceConfigLoopbackMode(const bool loopback,
 
     return ::util::OkStatus();
   };
-  auto register_functor = RegisterFunc<PortLoopbackStateChangedEvent>();
+  auto register_functor =
+      RegisterFunc<PortLoopbackStateChangedEvent>(node_id, port_id);
   auto on_change_functor = GetOnChangeFunctor(
       node_id, port_id, &PortLoopbackStateChangedEvent::GetNewState,
       IsLoopbackStateEnabled);
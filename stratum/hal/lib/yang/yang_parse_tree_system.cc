@@ -15,6 +15,7 @@
 #include "stratum/hal/lib/yang/yang_parse_tree.h"
 #include "stratum/hal/lib/yang/yang_parse_tree_helpers.h"
 #include "stratum/hal/lib/yang/yang_parse_tree_paths.h"
+#include "stratum/lib/metrics.h"
 
 namespace stratum {
 namespace hal {
@@ -103,6 +104,21 @@ void SetUpSystemLoggingConsoleStateSeverity(TreeNode* node,
       ->SetOnChangeHandler(on_change_functor);
 }
 
+////////////////////////////////////////////////////////////////////////////////
+// /debug/metrics/prometheus
+void SetUpDebugMetricsPrometheus(TreeNode* node) {
+  auto poll_functor = [](const GnmiEvent& event, const ::gnmi::Path& path,
+                         GnmiSubscribeStream* stream) {
+    const std::string text =
+        MetricRegistry::GetInstance()->ExportPrometheusText();
+    return SendResponse(GetResponse(path, text), stream);
+  };
+  auto on_change_functor = UnsupportedFunc();
+  node->SetOnPollHandler(poll_functor)
+      ->SetOnTimerHandler(poll_functor)
+      ->SetOnChangeHandler(on_change_functor);
+}
+
 }  // namespace
 
 ////////////////////////
@@ -118,6 +134,9 @@ void YangParseTreePaths::AddSubtreeSystem(YangParseTree* tree) {
   node = tree->AddNode(
       GetPath("system")("logging")("console")("state")("severity")());
   SetUpSystemLoggingConsoleStateSeverity(node, tree);
+
+  node = tree->AddNode(GetPath("debug")("metrics")("prometheus")());
+  SetUpDebugMetricsPrometheus(node);
 }
 
 }  // namespace hal
@@ -18,6 +18,7 @@
 #include "stratum/hal/lib/common/writer_mock.h"
 #include "stratum/hal/lib/yang/yang_parse_tree_mock.h"
 #include "stratum/lib/constants.h"
+#include "stratum/lib/metrics.h"
 #include "stratum/lib/test_utils/matchers.h"
 #include "stratum/lib/utils.h"
 
@@ -210,7 +211,7 @@ class YangParseTreeTest : public ::testing::Test {
     // Mock gRPC stream that copies parameter of Write() to 'resp'. The contents
     // of the 'resp' variable are than checked.
     SubscribeReaderWriterMock stream;
-    EXPECT_CALL(stream, Write(_, _))
+    EXPECT_CALL(stream, Write(_))
         .WillOnce(DoAll(
             WithArgs<0>(Invoke(
                 [resp](const ::gnmi::SubscribeResponse& r) { *resp = r; })),
@@ -577,6 +578,32 @@ TEST_F(YangParseTreeTest, LazyOneTimeCopyOnWritePtrModifiedViaRef) {
 
 TEST_F(YangParseTreeTest, CopySubtree) { PrintNode(GetRoot(), ""); }
 
+TEST_F(YangParseTreeTest, FindNodeOrNullWithIndexedChildren) {
+  AddSubtreeInterface("interface-1");
+
+  const TreeNode* node = GetRoot().FindNodeOrNull(GetPath("interfaces")(
+      "interface", "interface-1")("state")("oper-status")());
+  ASSERT_NE(nullptr, node);
+  EXPECT_EQ("oper-status", node->name());
+  EXPECT_EQ("interface-1", node->parent().parent().name());
+
+  EXPECT_EQ(nullptr, GetRoot().FindNodeOrNull(GetPath("interfaces")(
+                         "interface", "interface-1")("no-such-leaf")()));
+  EXPECT_EQ(nullptr, GetRoot().FindNodeOrNull(GetPath("interfaces")(
+                         "interface", "no-such-interface")("state")()));
+  // Known names at the wrong position.
+  EXPECT_EQ(nullptr, GetRoot().FindNodeOrNull(
+                         GetPath("interfaces")("state")("oper-status")()));
+
+  // A copy of the tree indexes its own children.
+  TreeNode copy(GetRoot());
+  const TreeNode* copied_node = copy.FindNodeOrNull(GetPath("interfaces")(
+      "interface", "interface-1")("state")("oper-status")());
+  ASSERT_NE(nullptr, copied_node);
+  EXPECT_NE(node, copied_node);
+  EXPECT_EQ("oper-status", copied_node->name());
+}
+
 TEST_F(YangParseTreeTest, AllSupportOnTime) {
   EXPECT_FALSE(GetRoot().AllSubtreeLeavesSupportOnTimer());
   PrintNodeWithOnTimer(GetRoot(), "");
@@ -833,7 +860,7 @@ TEST_F(YangParseTreeTest, GetDataFromSwitchInterfaceDataConvertedCorrectly) {
   // of the 'resp' variable are than checked.
   SubscribeReaderWriterMock stream;
   ::gnmi::SubscribeResponse resp;
-  EXPECT_CALL(stream, Write(_, _))
+  EXPECT_CALL(stream, Write(_))
       .WillOnce(
           DoAll(WithArgs<0>(Invoke(
                     [&resp](const ::gnmi::SubscribeResponse& r) { resp = r; })),
@@ -992,7 +1019,7 @@ TEST_F(YangParseTreeTest, InterfacesInterfaceStateNameOnPollSuccess) {
   // of the 'resp' variable are than checked.
   SubscribeReaderWriterMock stream;
   ::gnmi::SubscribeResponse resp;
-  EXPECT_CALL(stream, Write(_, _))
+  EXPECT_CALL(stream, Write(_))
       .WillOnce(
           DoAll(WithArgs<0>(Invoke(
                     [&resp](const ::gnmi::SubscribeResponse& r) { resp = r; })),
@@ -1026,7 +1053,7 @@ TEST_F(YangParseTreeTest, InterfacesInterfaceStateIdOnPollSuccess) {
   // of the 'resp' variable is then checked.
   SubscribeReaderWriterMock stream;
   ::gnmi::SubscribeResponse resp;
-  EXPECT_CALL(stream, Write(_, _))
+  EXPECT_CALL(stream, Write(_))
       .WillOnce(
           DoAll(WithArgs<0>(Invoke(
                     [&resp](const ::gnmi::SubscribeResponse& r) { resp = r; })),
@@ -2607,7 +2634,7 @@ TEST_F(YangParseTreeTest,
 
   // Mock gRPC stream that checks the contents of the 'resp' parameter.
   SubscribeReaderWriterMock stream;
-  EXPECT_CALL(stream, Write(_, _))
+  EXPECT_CALL(stream, Write(_))
       .WillOnce(
           DoAll(WithArgs<0>(Invoke([](const ::gnmi::SubscribeResponse& resp) {
                   // Check that the result of the call is what is expected.
@@ -2663,7 +2690,7 @@ TEST_F(YangParseTreeTest,
 
   // Mock gRPC stream that checks the contents of the 'resp' parameter.
   SubscribeReaderWriterMock stream;
-  EXPECT_CALL(stream, Write(_, _))
+  EXPECT_CALL(stream, Write(_))
       .WillOnce(
           DoAll(WithArgs<0>(Invoke([](const ::gnmi::SubscribeResponse& resp) {
                   // Check that the result of the call is what is expected.
@@ -2845,7 +2872,7 @@ TEST_F(YangParseTreeTest,
 
   // Mock gRPC stream that checks the contents of the 'resp' parameter.
   SubscribeReaderWriterMock stream;
-  EXPECT_CALL(stream, Write(_, _))
+  EXPECT_CALL(stream, Write(_))
       .WillOnce(
           DoAll(WithArgs<0>(Invoke([](const ::gnmi::SubscribeResponse& resp) {
                   // Check that the result of the call is what is expected.
@@ -2902,7 +2929,7 @@ TEST_F(YangParseTreeTest,
 
   // Mock gRPC stream that checks the contents of the 'resp' parameter.
   SubscribeReaderWriterMock stream;
-  EXPECT_CALL(stream, Write(_, _))
+  EXPECT_CALL(stream, Write(_))
       .WillOnce(
           DoAll(WithArgs<0>(Invoke([](const ::gnmi::SubscribeResponse& resp) {
                   // Check that the result of the call is what is expected.
@@ -4799,6 +4826,24 @@ TEST_F(YangParseTreeTest, SystemLoggingConsoleStateSeverityOnPollSuccess) {
   EXPECT_EQ(resp.update().update(0).val().string_val(), kSeverityNoticeString);
 }
 
+// Check if the '/debug/metrics/prometheus' OnPoll action works correctly.
+TEST_F(YangParseTreeTest, DebugMetricsPrometheusOnPollSuccess) {
+  auto path = GetPath("debug")("metrics")("prometheus")();
+  MetricRegistry::GetInstance()
+      ->GetCounter("yang_test_polls_total", "Test counter.")
+      ->Increment();
+
+  // Call the event handler. 'resp' will contain the message that is sent to the
+  // controller.
+  ::gnmi::SubscribeResponse resp;
+  ASSERT_OK(ExecuteOnPoll(path, &resp));
+
+  // Check that the result of the call is what is expected.
+  ASSERT_THAT(resp.update().update(), SizeIs(1));
+  EXPECT_THAT(resp.update().update(0).val().string_val(),
+              HasSubstr("yang_test_polls_total 1\n"));
+}
+
 // Check if the '/system/logging/console/state/severity' OnChange action works
 // correctly.
 TEST_F(YangParseTreeTest, SystemLoggingConsoleStateSeverityOnChangeSuccess) {
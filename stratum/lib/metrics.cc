@@ -0,0 +1,210 @@
+// Copyright 2024 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#include "stratum/lib/metrics.h"
+
+#include <stdio.h>
+
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_format.h"
+#include "absl/strings/str_join.h"
+#include "gflags/gflags.h"
+#include "stratum/glue/logging.h"
+#include "stratum/glue/status/status_macros.h"
+#include "stratum/lib/macros.h"
+#include "stratum/lib/utils.h"
+#include "stratum/public/lib/error.h"
+
+DEFINE_string(metrics_text_file, "",
+              "File the internal metrics are periodically written to, in the "
+              "Prometheus text format. Empty disables the export.");
+DEFINE_uint32(metrics_text_file_interval_ms, 10000,
+              "Interval of the metrics export to --metrics_text_file.");
+
+namespace stratum {
+
+namespace {
+
+// Escapes a label value as required by the Prometheus text format.
+std::string EscapeLabelValue(const std::string& value) {
+  std::string escaped;
+  escaped.reserve(value.size());
+  for (char c : value) {
+    switch (c) {
+      case '\\':
+        escaped += "\\\\";
+        break;
+      case '"':
+        escaped += "\\\"";
+        break;
+      case '\n':
+        escaped += "\\n";
+        break;
+      default:
+        escaped += c;
+        break;
+    }
+  }
+  return escaped;
+}
+
+// Formats the labels as they appear between the braces of a sample.
+std::string FormatLabels(const MetricLabels& labels) {
+  return absl::StrJoin(
+      labels, ",",
+      [](std::string* out, const std::pair<std::string, std::string>& label) {
+        absl::StrAppend(out, label.first, "=\"", EscapeLabelValue(label.second),
+                        "\"");
+      });
+}
+
+// Returns the sample name with its labels and an optional extra label.
+std::string SampleName(const std::string& name, const std::string& labels,
+                       const std::string& extra_label = "") {
+  if (labels.empty() && extra_label.empty()) return name;
+  return absl::StrCat(name, "{", labels,
+                      labels.empty() || extra_label.empty() ? "" : ",",
+                      extra_label, "}");
+}
+
+}  // namespace
+
+constexpr int LatencyHistogram::kNumBuckets;
+
+LatencyHistogram::LatencyHistogram() : count_(0), sum_ns_(0) {
+  for (auto& bucket : buckets_) bucket.store(0, std::memory_order_relaxed);
+}
+
+void LatencyHistogram::Record(absl::Duration latency) {
+  int64 micros = absl::ToInt64Microseconds(latency);
+  int bucket = 0;
+  if (micros > 1) {
+    // The smallest i with 2^i >= micros.
+    bucket = 64 - __builtin_clzll(static_cast<uint64>(micros - 1));
+    if (bucket >= kNumBuckets) bucket = kNumBuckets - 1;
+  }
+  buckets_[bucket].fetch_add(1, std::memory_order_relaxed);
+  count_.fetch_add(1, std::memory_order_relaxed);
+  sum_ns_.fetch_add(absl::ToInt64Nanoseconds(latency),
+                    std::memory_order_relaxed);
+}
+
+absl::Duration LatencyHistogram::BucketUpperBound(int bucket) {
+  if (bucket >= kNumBuckets - 1) return absl::InfiniteDuration();
+  return absl::Microseconds(int64{1} << bucket);
+}
+
+MetricRegistry* MetricRegistry::GetInstance() {
+  static MetricRegistry* instance = new MetricRegistry();
+  return instance;
+}
+
+LatencyHistogram* MetricRegistry::GetHistogram(const std::string& name,
+                                               const std::string& help,
+                                               const MetricLabels& labels) {
+  absl::MutexLock l(&lock_);
+  auto it = metrics_.find(name);
+  if (it == metrics_.end()) {
+    it = metrics_.emplace(name, Metric()).first;
+    it->second.help = help;
+    it->second.is_histogram = true;
+  }
+  if (!it->second.is_histogram) return nullptr;
+  auto& histogram = it->second.histograms[FormatLabels(labels)];
+  if (histogram == nullptr) histogram.reset(new LatencyHistogram());
+  return histogram.get();
+}
+
+MetricCounter* MetricRegistry::GetCounter(const std::string& name,
+                                          const std::string& help,
+                                          const MetricLabels& labels) {
+  absl::MutexLock l(&lock_);
+  auto it = metrics_.find(name);
+  if (it == metrics_.end()) {
+    it = metrics_.emplace(name, Metric()).first;
+    it->second.help = help;
+    it->second.is_histogram = false;
+  }
+  if (it->second.is_histogram) return nullptr;
+  auto& counter = it->second.counters[FormatLabels(labels)];
+  if (counter == nullptr) counter.reset(new MetricCounter());
+  return counter.get();
+}
+
+std::string MetricRegistry::ExportPrometheusText() const {
+  absl::MutexLock l(&lock_);
+  std::string text;
+  for (const auto& e : metrics_) {
+    const std::string& name = e.first;
+    const Metric& metric = e.second;
+    absl::StrAppend(&text, "# HELP ", name, " ", metric.help, "\n");
+    absl::StrAppend(&text, "# TYPE ", name, " ",
+                    metric.is_histogram ? "histogram" : "counter", "\n");
+    for (const auto& c : metric.counters) {
+      absl::StrAppend(&text, SampleName(name, c.first), " ", c.second->value(),
+                      "\n");
+    }
+    for (const auto& h : metric.histograms) {
+      const LatencyHistogram& histogram = *h.second;
+      // The count is the sum of the buckets, so that it is consistent with
+      // them while samples are being recorded.
+      uint64 cumulative_count = 0;
+      for (int i = 0; i < LatencyHistogram::kNumBuckets; ++i) {
+        cumulative_count += histogram.bucket_count(i);
+        absl::Duration upper_bound = LatencyHistogram::BucketUpperBound(i);
+        std::string le =
+            upper_bound == absl::InfiniteDuration()
+                ? "+Inf"
+                : absl::StrFormat("%g", absl::ToDoubleSeconds(upper_bound));
+        absl::StrAppend(&text,
+                        SampleName(name + "_bucket", h.first,
+                                   absl::StrCat("le=\"", le, "\"")),
+                        " ", cumulative_count, "\n");
+      }
+      absl::StrAppend(
+          &text, SampleName(name + "_sum", h.first), " ",
+          absl::StrFormat("%g", absl::ToDoubleSeconds(histogram.sum())), "\n");
+      absl::StrAppend(&text, SampleName(name + "_count", h.first), " ",
+                      cumulative_count, "\n");
+    }
+  }
+
+  return text;
+}
+
+::util::Status MetricRegistry::StartTextFileExport() {
+  if (FLAGS_metrics_text_file.empty()) return ::util::OkStatus();
+  RET_CHECK(FLAGS_metrics_text_file_interval_ms > 0)
+      << "Invalid metrics export interval "
+      << FLAGS_metrics_text_file_interval_ms << ".";
+  absl::MutexLock l(&lock_);
+  if (export_timer_ != nullptr) return ::util::OkStatus();
+  RETURN_IF_ERROR(hal::TimerDaemon::Start());
+  RETURN_IF_ERROR(hal::TimerDaemon::RequestPeriodicTimer(
+      FLAGS_metrics_text_file_interval_ms, FLAGS_metrics_text_file_interval_ms,
+      [this]() { return WriteTextFile(); }, &export_timer_));
+  LOG(INFO) << "Exporting the metrics to " << FLAGS_metrics_text_file
+            << " every " << FLAGS_metrics_text_file_interval_ms << " ms.";
+
+  return ::util::OkStatus();
+}
+
+void MetricRegistry::StopTextFileExport() {
+  absl::MutexLock l(&lock_);
+  // The timer daemon only keeps a weak pointer to the descriptor.
+  export_timer_.reset();
+}
+
+::util::Status MetricRegistry::WriteTextFile() const {
+  // Write to a temporary file first, so that readers never see a partial file.
+  const std::string tmp_filename = FLAGS_metrics_text_file + ".tmp";
+  RETURN_IF_ERROR(WriteStringToFile(ExportPrometheusText(), tmp_filename));
+  if (rename(tmp_filename.c_str(), FLAGS_metrics_text_file.c_str()) != 0) {
+    return MAKE_ERROR(ERR_INTERNAL) << "Failed to rename " << tmp_filename
+                                    << " to " << FLAGS_metrics_text_file << ".";
+  }
+
+  return ::util::OkStatus();
+}
+
+}  // namespace stratum
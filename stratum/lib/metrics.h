@@ -0,0 +1,171 @@
+// Copyright 2024 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+// Lightweight, process-wide latency histograms and counters, exported in the
+// Prometheus text exposition format.
+
+#ifndef STRATUM_LIB_METRICS_H_
+#define STRATUM_LIB_METRICS_H_
+
+#include <atomic>
+#include <map>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
+#include "stratum/glue/integral_types.h"
+#include "stratum/glue/status/status.h"
+#include "stratum/lib/timer_daemon.h"
+
+namespace stratum {
+
+// The label names and values of a metric, e.g. {{"table_id", "123"}}.
+using MetricLabels = std::vector<std::pair<std::string, std::string>>;
+
+// A histogram of latencies with fixed exponential buckets, from 1us to about
+// 67s. Recording a sample is lock-free and costs a few atomic increments.
+class LatencyHistogram {
+ public:
+  // The upper bound of bucket i is 2^i microseconds. The last bucket has no
+  // upper bound.
+  static constexpr int kNumBuckets = 28;
+
+  LatencyHistogram();
+
+  // Adds a latency sample to the histogram.
+  void Record(absl::Duration latency);
+
+  // Returns the number of samples in the given bucket (not cumulative).
+  uint64 bucket_count(int bucket) const {
+    return buckets_[bucket].load(std::memory_order_relaxed);
+  }
+
+  // Returns the number of samples and the sum of their latencies.
+  uint64 count() const { return count_.load(std::memory_order_relaxed); }
+  absl::Duration sum() const {
+    return absl::Nanoseconds(sum_ns_.load(std::memory_order_relaxed));
+  }
+
+  // Returns the upper bound of the given bucket, or absl::InfiniteDuration()
+  // for the last bucket.
+  static absl::Duration BucketUpperBound(int bucket);
+
+  // LatencyHistogram is neither copyable nor movable.
+  LatencyHistogram(const LatencyHistogram&) = delete;
+  LatencyHistogram& operator=(const LatencyHistogram&) = delete;
+
+ private:
+  std::atomic<uint64> buckets_[kNumBuckets];
+  std::atomic<uint64> count_;
+  std::atomic<int64> sum_ns_;
+};
+
+// A monotonically increasing counter.
+class MetricCounter {
+ public:
+  MetricCounter() : value_(0) {}
+
+  void Increment(uint64 delta = 1) {
+    value_.fetch_add(delta, std::memory_order_relaxed);
+  }
+  uint64 value() const { return value_.load(std::memory_order_relaxed); }
+
+  // MetricCounter is neither copyable nor movable.
+  MetricCounter(const MetricCounter&) = delete;
+  MetricCounter& operator=(const MetricCounter&) = delete;
+
+ private:
+  std::atomic<uint64> value_;
+};
+
+// Records the time from its construction to its destruction in a histogram.
+// A null histogram records nothing.
+class ScopedLatencyRecorder {
+ public:
+  explicit ScopedLatencyRecorder(LatencyHistogram* histogram)
+      : histogram_(histogram), start_time_(absl::Now()) {}
+  ~ScopedLatencyRecorder() {
+    if (histogram_ != nullptr) histogram_->Record(absl::Now() - start_time_);
+  }
+
+  // ScopedLatencyRecorder is neither copyable nor movable.
+  ScopedLatencyRecorder(const ScopedLatencyRecorder&) = delete;
+  ScopedLatencyRecorder& operator=(const ScopedLatencyRecorder&) = delete;
+
+ private:
+  LatencyHistogram* const histogram_;
+  const absl::Time start_time_;
+};
+
+// The MetricRegistry owns all the metrics of the process. A metric is a named
+// family of histograms or counters, one per distinct set of label values.
+// Metrics are created on first use and never deleted, so callers can keep the
+// returned pointers, e.g. in a function-local static for fixed labels.
+class MetricRegistry {
+ public:
+  // Returns the singleton instance.
+  static MetricRegistry* GetInstance();
+
+  // Returns the histogram of the given metric and labels, creating it if
+  // needed. The help string is only used when the metric is created. Returns
+  // nullptr if the name is already used by a counter.
+  LatencyHistogram* GetHistogram(const std::string& name,
+                                 const std::string& help,
+                                 const MetricLabels& labels = {})
+      LOCKS_EXCLUDED(lock_);
+
+  // Returns the counter of the given metric and labels, creating it if
+  // needed. Returns nullptr if the name is already used by a histogram.
+  MetricCounter* GetCounter(const std::string& name, const std::string& help,
+                            const MetricLabels& labels = {})
+      LOCKS_EXCLUDED(lock_);
+
+  // Returns all the metrics in the Prometheus text exposition format. Latency
+  // histograms are exported in seconds.
+  std::string ExportPrometheusText() const LOCKS_EXCLUDED(lock_);
+
+  // Periodically writes ExportPrometheusText() to the file given by the
+  // --metrics_text_file flag, e.g. for the node_exporter textfile collector.
+  // Does nothing if the flag is empty or the export is already running.
+  ::util::Status StartTextFileExport() LOCKS_EXCLUDED(lock_);
+
+  // Stops the periodic export started by StartTextFileExport().
+  void StopTextFileExport() LOCKS_EXCLUDED(lock_);
+
+  // MetricRegistry is neither copyable nor movable.
+  MetricRegistry(const MetricRegistry&) = delete;
+  MetricRegistry& operator=(const MetricRegistry&) = delete;
+
+ private:
+  // A metric and all its label sets, keyed by the formatted labels.
+  struct Metric {
+    std::string help;
+    bool is_histogram;
+    std::map<std::string, std::unique_ptr<LatencyHistogram>> histograms;
+    std::map<std::string, std::unique_ptr<MetricCounter>> counters;
+  };
+
+  MetricRegistry() {}
+
+  // Writes the metrics to the export file.
+  ::util::Status WriteTextFile() const;
+
+  // Protects the metric maps. The metric values are atomics updated without
+  // holding the lock.
+  mutable absl::Mutex lock_;
+
+  // Map from metric name to metric, sorted for a stable export.
+  std::map<std::string, Metric> metrics_ GUARDED_BY(lock_);
+
+  // The timer of the periodic text file export, if running.
+  hal::TimerDaemon::DescriptorPtr export_timer_ GUARDED_BY(lock_);
+};
+
+}  // namespace stratum
+
+#endif  // STRATUM_LIB_METRICS_H_
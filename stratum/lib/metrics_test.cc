@@ -0,0 +1,85 @@
+// Copyright 2024 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#include "stratum/lib/metrics.h"
+
+#include <string>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+namespace stratum {
+
+using ::testing::HasSubstr;
+using ::testing::Not;
+
+TEST(LatencyHistogramTest, RecordsSamplesInExponentialBuckets) {
+  LatencyHistogram histogram;
+  histogram.Record(absl::ZeroDuration());
+  histogram.Record(absl::Microseconds(1));
+  histogram.Record(absl::Microseconds(3));
+  histogram.Record(absl::Microseconds(4));
+  histogram.Record(absl::Hours(1));
+  EXPECT_EQ(2, histogram.bucket_count(0));
+  EXPECT_EQ(0, histogram.bucket_count(1));
+  EXPECT_EQ(2, histogram.bucket_count(2));
+  EXPECT_EQ(1, histogram.bucket_count(LatencyHistogram::kNumBuckets - 1));
+  EXPECT_EQ(5, histogram.count());
+  EXPECT_EQ(absl::Hours(1) + absl::Microseconds(8), histogram.sum());
+  EXPECT_EQ(absl::Microseconds(4), LatencyHistogram::BucketUpperBound(2));
+  EXPECT_EQ(absl::InfiniteDuration(),
+            LatencyHistogram::BucketUpperBound(
+                LatencyHistogram::kNumBuckets - 1));
+}
+
+TEST(MetricRegistryTest, ReturnsTheSameMetricForTheSameLabels) {
+  auto* registry = MetricRegistry::GetInstance();
+  LatencyHistogram* h1 =
+      registry->GetHistogram("test_same_latency_seconds", "Help.",
+                             {{"table_id", "1"}});
+  LatencyHistogram* h2 =
+      registry->GetHistogram("test_same_latency_seconds", "Help.",
+                             {{"table_id", "2"}});
+  ASSERT_NE(nullptr, h1);
+  ASSERT_NE(nullptr, h2);
+  EXPECT_NE(h1, h2);
+  EXPECT_EQ(h1, registry->GetHistogram("test_same_latency_seconds", "Help.",
+                                       {{"table_id", "1"}}));
+  // A name is either a histogram or a counter.
+  EXPECT_EQ(nullptr,
+            registry->GetCounter("test_same_latency_seconds", "Help."));
+}
+
+TEST(MetricRegistryTest, ExportsPrometheusText) {
+  auto* registry = MetricRegistry::GetInstance();
+  MetricCounter* counter = registry->GetCounter(
+      "test_export_packets_total", "Packets.", {{"node", "a\"b"}});
+  ASSERT_NE(nullptr, counter);
+  counter->Increment(3);
+  LatencyHistogram* histogram =
+      registry->GetHistogram("test_export_latency_seconds", "Latency.");
+  ASSERT_NE(nullptr, histogram);
+  histogram->Record(absl::Microseconds(3));
+  histogram->Record(absl::Microseconds(10));
+
+  std::string text = registry->ExportPrometheusText();
+  EXPECT_THAT(text,
+              HasSubstr("# TYPE test_export_packets_total counter\n"
+                        "test_export_packets_total{node=\"a\\\"b\"} 3\n"));
+  EXPECT_THAT(text,
+              HasSubstr("# HELP test_export_latency_seconds Latency.\n"
+                        "# TYPE test_export_latency_seconds histogram\n"
+                        "test_export_latency_seconds_bucket"
+                        "{le=\"1e-06\"} 0\n"));
+  EXPECT_THAT(text, HasSubstr("test_export_latency_seconds_bucket"
+                              "{le=\"4e-06\"} 1\n"));
+  EXPECT_THAT(text, HasSubstr("test_export_latency_seconds_bucket"
+                              "{le=\"1.6e-05\"} 2\n"));
+  EXPECT_THAT(text,
+              HasSubstr("test_export_latency_seconds_bucket{le=\"+Inf\"} 2\n"
+                        "test_export_latency_seconds_sum 1.3e-05\n"
+                        "test_export_latency_seconds_count 2\n"));
+  EXPECT_THAT(text, Not(HasSubstr("test_export_latency_seconds{")));
+}
+
+}  // namespace stratum
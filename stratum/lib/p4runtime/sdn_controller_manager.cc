@@ -5,6 +5,7 @@
 #include "stratum/lib/p4runtime/sdn_controller_manager.h"
 
 #include <algorithm>
+#include <utility>
 
 #include "absl/numeric/int128.h"
 #include "absl/status/status.h"
@@ -13,6 +14,7 @@
 #include "absl/strings/str_join.h"
 #include "absl/types/optional.h"
 #include "glog/logging.h"
+#include "grpcpp/impl/codegen/proto_utils.h"
 #include "p4/v1/p4runtime.pb.h"
 #include "stratum/hal/lib/p4/utils.h"
 
@@ -328,12 +330,23 @@ std::string SdnConnection::GetName() const {
 void SdnConnection::SendStreamMessageResponse(
     const p4::v1::StreamMessageResponse& response) {
   VLOG(2) << "Sending response: " << response.ShortDebugString();
-  if (!grpc_stream_->Write(response)) {
+  bool success = writer_ != nullptr ? writer_->Write(response)
+                                    : grpc_stream_->Write(response);
+  if (!success) {
     LOG(ERROR) << "Could not send stream message response to gRPC context '"
                << grpc_context_ << "': " << response.ShortDebugString();
   }
 }
 
+void SdnConnection::SendSerializedStreamMessageResponse(
+    const grpc::ByteBuffer& response) {
+  if (!writer_->WriteSerialized(response)) {
+    LOG(ERROR) << "Could not send serialized stream message response of "
+               << response.Length() << " bytes to gRPC context '"
+               << grpc_context_ << "'.";
+  }
+}
+
 grpc::Status SdnControllerManager::HandleArbitrationUpdate(
     const p4::v1::MasterArbitrationUpdate& update, SdnConnection* controller) {
   absl::MutexLock l(&lock_);
@@ -485,6 +498,7 @@ grpc::Status SdnControllerManager::HandleArbitrationUpdate(
                 << PrettyPrintElectionId(new_election_id_for_connection);
     }
   }
+  UpdatePrimaryConnections();
 
   return grpc::Status::OK;
 }
@@ -518,6 +532,7 @@ void SdnControllerManager::Disconnect(SdnConnection* connection) {
   if (was_primary) {
     InformConnectionsAboutPrimaryChange(connection->GetRoleName());
   }
+  UpdatePrimaryConnections();
 }
 
 grpc::Status SdnControllerManager::AllowRequest(
@@ -822,6 +837,30 @@ void SdnControllerManager::SendArbitrationResponse(SdnConnection* connection) {
   connection->SendStreamMessageResponse(response);
 }
 
+void SdnControllerManager::UpdatePrimaryConnections() {
+  primary_connections_.clear();
+  primaries_accept_serialized_responses_ = true;
+  for (const auto& connection : connections_) {
+    if (!connection->GetElectionId().has_value()) continue;
+    auto election_id_it =
+        election_id_past_by_role_.find(connection->GetRoleName());
+    if (election_id_it == election_id_past_by_role_.end() ||
+        election_id_it->second != connection->GetElectionId()) {
+      continue;
+    }
+    PrimaryConnection primary;
+    primary.connection = connection;
+    auto role_config_it = role_config_by_name_.find(connection->GetRoleName());
+    if (role_config_it != role_config_by_name_.end()) {
+      primary.role_config = role_config_it->second;
+    }
+    if (!connection->AcceptsSerializedResponses()) {
+      primaries_accept_serialized_responses_ = false;
+    }
+    primary_connections_.push_back(std::move(primary));
+  }
+}
+
 absl::Status SdnControllerManager::SendPacketInToPrimary(
     const p4::v1::StreamMessageResponse& response) {
   if (response.update_case() != p4::v1::StreamMessageResponse::kPacket) {
@@ -834,24 +873,54 @@ absl::Status SdnControllerManager::SendPacketInToPrimary(
 
 absl::Status SdnControllerManager::SendStreamMessageToPrimary(
     const p4::v1::StreamMessageResponse& response) {
+  // The primary connections are only read here, so concurrent senders (e.g.
+  // PacketIns of different nodes or threads) do not serialize on the lock.
+  // A synchronous gRPC stream does not allow concurrent writes though, so the
+  // exclusive lock is kept if a primary connection writes to one.
+  {
+    absl::ReaderMutexLock l(&lock_);
+    if (primaries_accept_serialized_responses_) {
+      return SendStreamMessageToPrimaryLocked(response);
+    }
+  }
   absl::MutexLock l(&lock_);
+  return SendStreamMessageToPrimaryLocked(response);
+}
 
+absl::Status SdnControllerManager::SendStreamMessageToPrimaryLocked(
+    const p4::v1::StreamMessageResponse& response) {
   bool found_at_least_one_primary = false;
-
-  for (const auto& connection : connections_) {
-    absl::optional<absl::uint128> election_id_past_for_role =
-        election_id_past_by_role_[connection->GetRoleName()];
-    if (election_id_past_for_role.has_value() &&
-        election_id_past_for_role == connection->GetElectionId()) {
-      absl::optional<P4RoleConfig> role_config =
-          role_config_by_name_[connection->GetRoleName()];
-      if (VerifyStreamMessageNotFiltered(role_config, response)) {
-        found_at_least_one_primary = true;
-        connection->SendStreamMessageResponse(response);
+  // The response is serialized at most once, the resulting slices are shared
+  // by all the connections it is sent to.
+  grpc::ByteBuffer serialized_response;
+  bool is_serialized = false;
+
+  for (const auto& primary : primary_connections_) {
+    // We don't report an error for packets getting filtered as this is
+    // expected operation.
+    if (!VerifyStreamMessageNotFiltered(primary.role_config, response)) {
+      continue;
+    }
+    found_at_least_one_primary = true;
+    if (!primary.connection->AcceptsSerializedResponses()) {
+      primary.connection->SendStreamMessageResponse(response);
+      continue;
+    }
+    if (!is_serialized) {
+      bool own_buffer;
+      grpc::Status status =
+          grpc::SerializationTraits<p4::v1::StreamMessageResponse>::Serialize(
+              response, &serialized_response, &own_buffer);
+      if (!status.ok()) {
+        return absl::InternalError(absl::StrCat(
+            "Failed to serialize StreamMessageResponse: ",
+            status.error_message()));
       }
-      // We don't report an error for packets getting filtered as this is
-      // expected operation.
+      is_serialized = true;
     }
+    VLOG(2) << "Sending response: " << response.ShortDebugString();
+    primary.connection->SendSerializedStreamMessageResponse(
+        serialized_response);
   }
 
   if (!found_at_least_one_primary) {
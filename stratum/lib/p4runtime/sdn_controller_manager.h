@@ -12,6 +12,9 @@
 #include "absl/container/flat_hash_set.h"
 #include "absl/numeric/int128.h"
 #include "absl/status/status.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/types/optional.h"
+#include "grpcpp/support/byte_buffer.h"
 #include "p4/v1/p4runtime.grpc.pb.h"
 #include "p4/v1/p4runtime.pb.h"
 #include "stratum/public/proto/p4_role_config.pb.h"
@@ -22,14 +25,45 @@ namespace p4runtime {
 // Named role for a SDN controller.
 constexpr char kP4RuntimeRoleSdnController[] = "sdn_controller";
 
+// Writes the StreamMessageResponses of a connection to its stream. Unlike a
+// synchronous gRPC stream, the writer can be called from several threads at
+// once and does not block, the responses are queued. It also takes responses
+// that are already serialized, so that a response sent to several connections
+// is serialized only once.
+class StreamMessageResponseWriter {
+ public:
+  virtual ~StreamMessageResponseWriter() {}
+
+  // Queues a StreamMessageResponse for writing. Returns false if the response
+  // cannot be sent.
+  virtual bool Write(const p4::v1::StreamMessageResponse& response) = 0;
+
+  // Queues a serialized StreamMessageResponse for writing. The buffer slices
+  // are shared, not copied. Returns false if the response cannot be sent.
+  virtual bool WriteSerialized(const grpc::ByteBuffer& response) = 0;
+};
+
 // A connection between a controller and p4rt server.
 class SdnConnection {
  public:
+  // A connection writing to a synchronous gRPC stream. The writes to the
+  // stream are serialized by the SdnControllerManager.
   SdnConnection(
-      grpc::ServerContext* context,
+      grpc::ServerContextBase* context,
       grpc::ServerReaderWriterInterface<p4::v1::StreamMessageResponse,
                                         p4::v1::StreamMessageRequest>* stream)
-      : initialized_(false), grpc_context_(context), grpc_stream_(stream) {}
+      : initialized_(false),
+        grpc_context_(context),
+        grpc_stream_(stream),
+        writer_(nullptr) {}
+
+  // A connection writing to a StreamMessageResponseWriter.
+  SdnConnection(grpc::ServerContextBase* context,
+                StreamMessageResponseWriter* writer)
+      : initialized_(false),
+        grpc_context_(context),
+        grpc_stream_(nullptr),
+        writer_(writer) {}
 
   void Initialize() { initialized_ = true; }
   bool IsInitialized() const { return initialized_; }
@@ -46,6 +80,14 @@ class SdnConnection {
   // Sends back StreamMessageResponse to this controller.
   void SendStreamMessageResponse(const p4::v1::StreamMessageResponse& response);
 
+  // Returns true if the connection can send serialized responses. Such a
+  // connection can also be written to by several threads at once.
+  bool AcceptsSerializedResponses() const { return writer_ != nullptr; }
+
+  // Sends back an already serialized StreamMessageResponse to this
+  // controller. Only to be called if AcceptsSerializedResponses() is true.
+  void SendSerializedStreamMessageResponse(const grpc::ByteBuffer& response);
+
  private:
   // The SDN connection should be initialized through arbitration before it can
   // be used.
@@ -63,11 +105,13 @@ class SdnConnection {
   absl::optional<absl::uint128> election_id_;
 
   // While the gRPC connection is open we keep access to the context & the
-  // read/write stream for communication.
-  grpc::ServerContext* grpc_context_;  // not owned.
+  // read/write stream or the writer for communication. Only one of
+  // grpc_stream_ and writer_ is set.
+  grpc::ServerContextBase* grpc_context_;  // not owned.
   grpc::ServerReaderWriterInterface<p4::v1::StreamMessageResponse,
                                     p4::v1::StreamMessageRequest>*
-      grpc_stream_;  // not owned.
+      grpc_stream_;                      // not owned.
+  StreamMessageResponseWriter* writer_;  // not owned.
 };
 
 class SdnControllerManager {
@@ -123,6 +167,16 @@ class SdnControllerManager {
   void SendArbitrationResponse(SdnConnection* connection)
       ABSL_EXCLUSIVE_LOCKS_REQUIRED(lock_);
 
+  // Rebuilds primary_connections_. To be called whenever a connection, an
+  // election ID or a role config changes.
+  void UpdatePrimaryConnections() ABSL_EXCLUSIVE_LOCKS_REQUIRED(lock_);
+
+  // Sends a stream message to the primary connections. A reader lock is only
+  // enough if all the primary connections accept serialized responses.
+  absl::Status SendStreamMessageToPrimaryLocked(
+      const p4::v1::StreamMessageResponse& response)
+      ABSL_SHARED_LOCKS_REQUIRED(lock_);
+
   // Lock for protecting SdnControllerManager member fields.
   mutable absl::Mutex lock_;
 
@@ -169,6 +223,21 @@ class SdnControllerManager {
   absl::flat_hash_map<absl::optional<std::string>,
                       absl::optional<absl::uint128>>
       election_id_past_by_role_ ABSL_GUARDED_BY(lock_);
+
+  // A primary connection and the config of its role.
+  struct PrimaryConnection {
+    SdnConnection* connection;  // not owned.
+    absl::optional<P4RoleConfig> role_config;
+  };
+
+  // Snapshot of the current primary connections, derived from the members
+  // above. Lets SendStreamMessageToPrimary() fan out the stream messages
+  // without any map lookup or role config copy.
+  std::vector<PrimaryConnection> primary_connections_ ABSL_GUARDED_BY(lock_);
+
+  // True if all the primary connections accept serialized responses, i.e.
+  // they can be written to concurrently.
+  bool primaries_accept_serialized_responses_ ABSL_GUARDED_BY(lock_) = true;
 };
 
 }  // namespace p4runtime
@@ -0,0 +1,223 @@
+// Copyright 2024 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#include "stratum/lib/p4runtime/sdn_controller_manager.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "absl/memory/memory.h"
+#include "absl/status/status.h"
+#include "absl/types/optional.h"
+#include "gmock/gmock.h"
+#include "grpcpp/grpcpp.h"
+#include "gtest/gtest.h"
+#include "p4/v1/p4runtime.pb.h"
+#include "stratum/lib/p4runtime/stream_message_reader_writer_mock.h"
+#include "stratum/public/proto/p4_role_config.pb.h"
+
+namespace stratum {
+namespace p4runtime {
+namespace {
+
+using ::testing::_;
+using ::testing::Invoke;
+using ::testing::Return;
+
+constexpr uint64_t kDeviceId = 1;
+
+// A writer which records the responses written to it.
+class StreamMessageResponseWriterMock : public StreamMessageResponseWriter {
+ public:
+  StreamMessageResponseWriterMock() {
+    ON_CALL(*this, Write(_)).WillByDefault(Return(true));
+    ON_CALL(*this, WriteSerialized(_))
+        .WillByDefault(Invoke([this](const grpc::ByteBuffer& response) {
+          serialized_responses.push_back(response);
+          return true;
+        }));
+  }
+
+  MOCK_METHOD1(Write, bool(const p4::v1::StreamMessageResponse&));
+  MOCK_METHOD1(WriteSerialized, bool(const grpc::ByteBuffer&));
+
+  std::vector<grpc::ByteBuffer> serialized_responses;
+};
+
+// A controller connected with a StreamMessageResponseWriter.
+struct Controller {
+  Controller() : connection(&context, &writer) {}
+
+  grpc::ServerContext context;
+  ::testing::NiceMock<StreamMessageResponseWriterMock> writer;
+  SdnConnection connection;
+};
+
+p4::v1::MasterArbitrationUpdate ArbitrationUpdate(
+    const absl::optional<std::string>& role_name, uint64_t election_id) {
+  p4::v1::MasterArbitrationUpdate update;
+  update.set_device_id(kDeviceId);
+  if (role_name.has_value()) update.mutable_role()->set_name(*role_name);
+  update.mutable_election_id()->set_low(election_id);
+  return update;
+}
+
+p4::v1::MasterArbitrationUpdate ArbitrationUpdate(
+    const std::string& role_name, uint64_t election_id,
+    const P4RoleConfig& role_config) {
+  p4::v1::MasterArbitrationUpdate update =
+      ArbitrationUpdate(role_name, election_id);
+  update.mutable_role()->mutable_config()->PackFrom(role_config);
+  return update;
+}
+
+p4::v1::StreamMessageResponse PacketIn(const std::string& payload) {
+  p4::v1::StreamMessageResponse response;
+  response.mutable_packet()->set_payload(payload);
+  return response;
+}
+
+p4::v1::StreamMessageResponse Deserialize(const grpc::ByteBuffer& buffer) {
+  // Deserialize() consumes the buffer, the copy only references its slices.
+  grpc::ByteBuffer copy(buffer);
+  p4::v1::StreamMessageResponse response;
+  EXPECT_TRUE(
+      grpc::SerializationTraits<p4::v1::StreamMessageResponse>::Deserialize(
+          &copy, &response)
+          .ok());
+  return response;
+}
+
+class SdnControllerManagerTest : public ::testing::Test {
+ protected:
+  SdnControllerManagerTest() : manager_(kDeviceId) {}
+
+  void Arbitrate(const p4::v1::MasterArbitrationUpdate& update,
+                 Controller* controller) {
+    grpc::Status status =
+        manager_.HandleArbitrationUpdate(update, &controller->connection);
+    ASSERT_TRUE(status.ok()) << status.error_message();
+  }
+
+  SdnControllerManager manager_;
+};
+
+TEST_F(SdnControllerManagerTest, PacketInGoesToThePromotedPrimary) {
+  Controller first;
+  Controller second;
+  Arbitrate(ArbitrationUpdate(absl::nullopt, 1), &first);
+  Arbitrate(ArbitrationUpdate(absl::nullopt, 2), &second);
+
+  EXPECT_TRUE(manager_.SendPacketInToPrimary(PacketIn("a")).ok());
+  EXPECT_TRUE(first.writer.serialized_responses.empty());
+  ASSERT_EQ(1, second.writer.serialized_responses.size());
+  EXPECT_EQ("a", Deserialize(second.writer.serialized_responses[0])
+                     .packet()
+                     .payload());
+
+  manager_.Disconnect(&first.connection);
+  manager_.Disconnect(&second.connection);
+}
+
+TEST_F(SdnControllerManagerTest, DemotedPrimaryStopsReceivingPacketIns) {
+  Controller controller;
+  Arbitrate(ArbitrationUpdate(absl::nullopt, 2), &controller);
+  EXPECT_TRUE(manager_.SendPacketInToPrimary(PacketIn("a")).ok());
+
+  // A lower election ID turns the primary into a backup.
+  Arbitrate(ArbitrationUpdate(absl::nullopt, 1), &controller);
+  EXPECT_TRUE(absl::IsFailedPrecondition(
+      manager_.SendPacketInToPrimary(PacketIn("b"))));
+  EXPECT_EQ(1, controller.writer.serialized_responses.size());
+
+  manager_.Disconnect(&controller.connection);
+}
+
+TEST_F(SdnControllerManagerTest, DisconnectedPrimaryStopsReceivingPacketIns) {
+  Controller backup;
+  auto primary = absl::make_unique<Controller>();
+  Arbitrate(ArbitrationUpdate(absl::nullopt, 1), &backup);
+  Arbitrate(ArbitrationUpdate(absl::nullopt, 2), primary.get());
+  EXPECT_TRUE(manager_.SendPacketInToPrimary(PacketIn("a")).ok());
+
+  // The backup does not become primary, its election ID is lower than the
+  // one of the last primary.
+  manager_.Disconnect(&primary->connection);
+  primary.reset();
+  EXPECT_TRUE(absl::IsFailedPrecondition(
+      manager_.SendPacketInToPrimary(PacketIn("b"))));
+  EXPECT_TRUE(backup.writer.serialized_responses.empty());
+
+  manager_.Disconnect(&backup.connection);
+}
+
+TEST_F(SdnControllerManagerTest, RoleConfigChangeAppliesToPacketIns) {
+  Controller controller;
+  P4RoleConfig role_config;
+  role_config.set_receives_packet_ins(true);
+  Arbitrate(ArbitrationUpdate("role", 1, role_config), &controller);
+  EXPECT_TRUE(manager_.SendPacketInToPrimary(PacketIn("a")).ok());
+
+  // The primary pushes a role config which filters out the PacketIns.
+  role_config.set_receives_packet_ins(false);
+  Arbitrate(ArbitrationUpdate("role", 1, role_config), &controller);
+  EXPECT_TRUE(absl::IsFailedPrecondition(
+      manager_.SendPacketInToPrimary(PacketIn("b"))));
+  EXPECT_EQ(1, controller.writer.serialized_responses.size());
+
+  manager_.Disconnect(&controller.connection);
+}
+
+TEST_F(SdnControllerManagerTest, PacketInIsSerializedOnceForAllPrimaries) {
+  Controller first;
+  Controller second;
+  Arbitrate(ArbitrationUpdate("first", 1), &first);
+  Arbitrate(ArbitrationUpdate("second", 1), &second);
+  EXPECT_CALL(first.writer, Write(_)).Times(0);
+  EXPECT_CALL(second.writer, Write(_)).Times(0);
+
+  // Large enough not to be inlined in the slices.
+  const std::string payload(1000, 'a');
+  EXPECT_TRUE(manager_.SendPacketInToPrimary(PacketIn(payload)).ok());
+  ASSERT_EQ(1, first.writer.serialized_responses.size());
+  ASSERT_EQ(1, second.writer.serialized_responses.size());
+  EXPECT_EQ(payload, Deserialize(first.writer.serialized_responses[0])
+                         .packet()
+                         .payload());
+
+  // Both connections share the slices of the same serialization.
+  std::vector<grpc::Slice> first_slices;
+  std::vector<grpc::Slice> second_slices;
+  ASSERT_TRUE(first.writer.serialized_responses[0].Dump(&first_slices).ok());
+  ASSERT_TRUE(second.writer.serialized_responses[0].Dump(&second_slices).ok());
+  ASSERT_EQ(first_slices.size(), second_slices.size());
+  for (size_t i = 0; i < first_slices.size(); ++i) {
+    EXPECT_EQ(first_slices[i].begin(), second_slices[i].begin());
+  }
+
+  manager_.Disconnect(&first.connection);
+  manager_.Disconnect(&second.connection);
+}
+
+TEST_F(SdnControllerManagerTest, StreamPrimaryGetsTypedPacketIn) {
+  Controller first;
+  grpc::ServerContext context;
+  StreamMessageReaderWriterMock stream;
+  SdnConnection second(&context, &stream);
+  Arbitrate(ArbitrationUpdate("first", 1), &first);
+  ASSERT_TRUE(
+      manager_.HandleArbitrationUpdate(ArbitrationUpdate("second", 1), &second)
+          .ok());
+
+  EXPECT_CALL(stream, Write(_, _)).WillOnce(Return(true));
+  EXPECT_TRUE(manager_.SendPacketInToPrimary(PacketIn("a")).ok());
+  EXPECT_EQ(1, first.writer.serialized_responses.size());
+
+  manager_.Disconnect(&first.connection);
+  manager_.Disconnect(&second);
+}
+
+}  // namespace
+}  // namespace p4runtime
+}  // namespace stratum
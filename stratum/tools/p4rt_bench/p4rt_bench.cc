@@ -0,0 +1,513 @@
+// Copyright 2024 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+// End-to-end P4Runtime benchmark. Drives a configurable mix of Write batches,
+// wildcard Reads, PacketOuts and StreamChannel arbitrations against a Stratum
+// server from N concurrent clients and reports the throughput and latency
+// distribution of each operation type.
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <deque>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>  // NOLINT
+#include <utility>
+#include <vector>
+
+#include "absl/memory/memory.h"
+#include "absl/numeric/int128.h"
+#include "absl/strings/str_format.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
+#include "gflags/gflags.h"
+#include "grpcpp/create_channel.h"
+#include "grpcpp/grpcpp.h"
+#include "p4/config/v1/p4info.pb.h"
+#include "p4/v1/p4runtime.grpc.pb.h"
+#include "p4/v1/p4runtime.pb.h"
+#include "stratum/glue/init_google.h"
+#include "stratum/glue/integral_types.h"
+#include "stratum/glue/logging.h"
+#include "stratum/glue/status/status.h"
+#include "stratum/glue/status/status_macros.h"
+#include "stratum/hal/lib/p4/utils.h"
+#include "stratum/lib/constants.h"
+#include "stratum/lib/macros.h"
+#include "stratum/lib/p4runtime/p4runtime_session.h"
+#include "stratum/lib/security/credentials_manager.h"
+#include "stratum/lib/utils.h"
+
+DEFINE_string(grpc_addr, stratum::kLocalStratumUrl,
+              "P4Runtime server address.");
+DEFINE_uint64(device_id, 1, "P4Runtime device ID.");
+DEFINE_string(p4_info_file, "",
+              "Path to an optional P4Info text proto file. If specified, the "
+              "pipeline is pushed before the benchmark starts and the P4Info "
+              "is used to look up the bitwidth of the varied match field.");
+DEFINE_string(p4_pipeline_config_file, "",
+              "Path to an optional binary device config pushed together with "
+              "the P4Info.");
+DEFINE_string(table_entry_file, "",
+              "Path to a TableEntry text proto used as template for writes "
+              "and reads. The first match field must be an exact match, its "
+              "value is replaced by a unique value for every written entry.");
+DEFINE_string(packet_out_file, "",
+              "Path to an optional PacketOut text proto. Its metadata is used "
+              "for all PacketOuts, the payload is set by --packet_out_size.");
+DEFINE_int32(num_clients, 1, "Number of concurrent P4Runtime clients.");
+DEFINE_int32(duration_sec, 10,
+             "Duration of the benchmark in seconds, 0 means no limit. At "
+             "least one of --duration_sec and --max_ops_per_client must be "
+             "set.");
+DEFINE_uint64(max_ops_per_client, 0,
+              "Maximum number of operations per client, 0 means no limit.");
+DEFINE_int32(max_qps_per_client, 0,
+             "Maximum operations per second per client, 0 means no limit.");
+DEFINE_int32(write_weight, 1, "Relative weight of Write operations.");
+DEFINE_int32(read_weight, 0, "Relative weight of wildcard Read operations.");
+DEFINE_int32(packet_out_weight, 0, "Relative weight of PacketOut operations.");
+DEFINE_int32(arbitration_weight, 0,
+             "Relative weight of StreamChannel arbitration operations. Each "
+             "one opens a new stream as backup controller.");
+DEFINE_int32(write_batch_size, 1, "Number of updates per Write request.");
+DEFINE_int32(max_batches_per_client, 1000,
+             "Number of inserted batches a client keeps installed. Once "
+             "reached, every second Write deletes the oldest batch.");
+DEFINE_bool(read_all_tables, false,
+            "Read all tables instead of only the table of the template.");
+DEFINE_int32(packet_out_size, 64, "Payload size of PacketOuts in bytes.");
+
+namespace stratum {
+namespace tools {
+namespace p4rt_bench {
+
+const char kUsage[] = R"USAGE(
+Usage: p4rt_bench [options]
+  This tool benchmarks the P4Runtime service of a Stratum device with a mix of
+  Write, Read, PacketOut and arbitration operations from concurrent clients and
+  reports throughput and p50/p99/p999 latencies per operation type.
+)USAGE";
+
+enum OpType { kWrite = 0, kRead, kPacketOut, kArbitration, kNumOpTypes };
+
+const char* const kOpTypeNames[kNumOpTypes] = {"Write", "Read", "PacketOut",
+                                               "Arbitration"};
+
+// A fixed-size histogram of latencies in nanoseconds. Every power of two is
+// split into kSubBuckets linear buckets, so a reported percentile is within
+// 1/kSubBuckets of the measured latency regardless of the number of samples.
+class OpLatencies {
+ public:
+  OpLatencies() : buckets_(kNumBuckets, 0) {}
+
+  void Record(int64 latency_ns) {
+    const uint64 value = latency_ns > 0 ? latency_ns : 0;
+    ++buckets_[BucketIndex(value)];
+    ++count_;
+    max_ns_ = std::max(max_ns_, value);
+  }
+
+  void Merge(const OpLatencies& other) {
+    for (int i = 0; i < kNumBuckets; ++i) buckets_[i] += other.buckets_[i];
+    count_ += other.count_;
+    max_ns_ = std::max(max_ns_, other.max_ns_);
+  }
+
+  uint64 count() const { return count_; }
+
+  // Returns the upper bound of the bucket holding the given quantile, or the
+  // largest latency for q >= 1.
+  uint64 PercentileNs(double q) const {
+    if (count_ == 0) return 0;
+    if (q >= 1.0) return max_ns_;
+    const uint64 rank = std::max<uint64>(1, std::ceil(q * count_));
+    uint64 cumulative_count = 0;
+    for (int i = 0; i < kNumBuckets; ++i) {
+      cumulative_count += buckets_[i];
+      if (cumulative_count >= rank) {
+        return std::min(BucketUpperBound(i), max_ns_);
+      }
+    }
+    return max_ns_;
+  }
+
+ private:
+  static constexpr int kSubBucketBits = 4;
+  static constexpr int kSubBuckets = 1 << kSubBucketBits;
+  static constexpr int kNumBuckets = (64 - kSubBucketBits) * kSubBuckets;
+
+  static int BucketIndex(uint64 value) {
+    if (value < kSubBuckets) return value;
+    const int shift = 63 - __builtin_clzll(value) - kSubBucketBits;
+    return (shift + 1) * kSubBuckets + ((value >> shift) - kSubBuckets);
+  }
+
+  static uint64 BucketUpperBound(int index) {
+    if (index < kSubBuckets) return index;
+    const int shift = index / kSubBuckets - 1;
+    const uint64 lower = static_cast<uint64>(kSubBuckets + index % kSubBuckets)
+                         << shift;
+    return lower + (uint64{1} << shift) - 1;
+  }
+
+  std::vector<uint64> buckets_;
+  uint64 count_ = 0;
+  uint64 max_ns_ = 0;
+};
+
+// Results of one operation type.
+struct OpStats {
+  uint64 errors = 0;
+  // Number of P4Runtime entities written or read by successful operations.
+  uint64 entities = 0;
+  OpLatencies latencies;
+
+  void Merge(const OpStats& other) {
+    errors += other.errors;
+    entities += other.entities;
+    latencies.Merge(other.latencies);
+  }
+};
+
+// State shared by all clients.
+struct BenchContext {
+  std::string grpc_addr;
+  std::shared_ptr<::grpc::ChannelCredentials> credentials;
+  uint64 device_id = 0;
+  ::p4::v1::Uint128 election_id;
+  // The primary session. Its stream channel carries the PacketOuts.
+  p4runtime::P4RuntimeSession* session = nullptr;
+  absl::Mutex stream_lock;
+  ::p4::v1::TableEntry entry_template;
+  int key_bitwidth = 0;
+  ::p4::v1::PacketOut packet_out;
+  // Source of unique match keys, shared so that clients never collide.
+  std::atomic<uint64> next_key{0};
+};
+
+// A single benchmark client with its own gRPC channel.
+class BenchClient {
+ public:
+  BenchClient(int id, BenchContext* context)
+      : id_(id), context_(context), stats_(kNumOpTypes) {
+    // A distinct channel argument keeps gRPC from sharing one connection
+    // between all clients.
+    ::grpc::ChannelArguments args = p4runtime::GrpcChannelArgumentsForP4rt();
+    args.SetInt("p4rt_bench.client_id", id);
+    stub_ = ::p4::v1::P4Runtime::NewStub(::grpc::CreateCustomChannel(
+        context_->grpc_addr, context_->credentials, args));
+  }
+
+  // Runs operations until the deadline or the operation limit is reached.
+  void Run(absl::Time deadline) {
+    std::mt19937 rng(id_);
+    std::discrete_distribution<int> op_distribution(
+        {static_cast<double>(FLAGS_write_weight),
+         static_cast<double>(FLAGS_read_weight),
+         static_cast<double>(FLAGS_packet_out_weight),
+         static_cast<double>(FLAGS_arbitration_weight)});
+    const absl::Duration op_interval =
+        FLAGS_max_qps_per_client > 0
+            ? absl::Seconds(1) / FLAGS_max_qps_per_client
+            : absl::ZeroDuration();
+    absl::Time next_op = absl::Now();
+    for (uint64 i = 0;
+         FLAGS_max_ops_per_client == 0 || i < FLAGS_max_ops_per_client; ++i) {
+      if (op_interval > absl::ZeroDuration()) {
+        absl::SleepFor(next_op - absl::Now());
+        next_op += op_interval;
+      }
+      if (absl::Now() >= deadline) break;
+      const OpType op = static_cast<OpType>(op_distribution(rng));
+      uint64 entities = 0;
+      const absl::Time start = absl::Now();
+      ::util::Status status = RunOp(op, &entities);
+      const absl::Duration latency = absl::Now() - start;
+      auto& stats = stats_[op];
+      if (!status.ok()) {
+        ++stats.errors;
+        LOG_EVERY_N(WARNING, 1000)
+            << kOpTypeNames[op] << " failed on client " << id_ << ": "
+            << status.error_message();
+        continue;
+      }
+      stats.entities += entities;
+      stats.latencies.Record(absl::ToInt64Nanoseconds(latency));
+    }
+  }
+
+  const OpStats& stats(OpType op) const { return stats_[op]; }
+
+ private:
+  ::util::Status RunOp(OpType op, uint64* entities) {
+    switch (op) {
+      case kWrite:
+        return DoWrite(entities);
+      case kRead:
+        return DoRead(entities);
+      case kPacketOut:
+        return DoPacketOut(entities);
+      case kArbitration:
+        return DoArbitration(entities);
+      default:
+        return MAKE_ERROR(ERR_INTERNAL) << "Unknown operation " << op << ".";
+    }
+  }
+
+  // Inserts a batch of new entries or, if the client holds the maximum number
+  // of batches, alternately deletes its oldest batch.
+  ::util::Status DoWrite(uint64* entities) {
+    ::p4::v1::WriteRequest req;
+    req.set_device_id(context_->device_id);
+    *req.mutable_election_id() = context_->election_id;
+    std::vector<uint64> keys;
+    ::p4::v1::Update::Type type = ::p4::v1::Update::INSERT;
+    if (static_cast<int>(batches_.size()) >= FLAGS_max_batches_per_client &&
+        delete_next_) {
+      type = ::p4::v1::Update::DELETE;
+      keys = std::move(batches_.front());
+      batches_.pop_front();
+    } else {
+      const uint64 key_mask = context_->key_bitwidth >= 64
+                                  ? ~0ULL
+                                  : (1ULL << context_->key_bitwidth) - 1;
+      for (int i = 0; i < FLAGS_write_batch_size; ++i) {
+        keys.push_back(context_->next_key.fetch_add(1) & key_mask);
+      }
+    }
+    delete_next_ = !delete_next_;
+    for (const uint64 key : keys) {
+      auto* update = req.add_updates();
+      update->set_type(type);
+      auto* entry = update->mutable_entity()->mutable_table_entry();
+      *entry = context_->entry_template;
+      entry->mutable_match(0)->mutable_exact()->set_value(
+          hal::Uint64ToByteStream(key));
+      if (type == ::p4::v1::Update::DELETE) entry->clear_action();
+    }
+    ::p4::v1::WriteResponse resp;
+    ::grpc::ClientContext context;
+    ::grpc::Status status = stub_->Write(&context, req, &resp);
+    if (!status.ok()) {
+      // Keep inserted keys so that they are deleted later, failed deletes are
+      // not retried.
+      if (type == ::p4::v1::Update::INSERT) batches_.push_back(std::move(keys));
+      return MAKE_ERROR(ERR_INTERNAL)
+             << hal::P4RuntimeGrpcStatusToString(status);
+    }
+    if (type == ::p4::v1::Update::INSERT) batches_.push_back(std::move(keys));
+    *entities = req.updates_size();
+    return ::util::OkStatus();
+  }
+
+  // Reads all entries of the template table or of all tables.
+  ::util::Status DoRead(uint64* entities) {
+    ::p4::v1::ReadRequest req;
+    req.set_device_id(context_->device_id);
+    req.add_entities()->mutable_table_entry()->set_table_id(
+        FLAGS_read_all_tables ? 0 : context_->entry_template.table_id());
+    ::grpc::ClientContext context;
+    std::unique_ptr<::grpc::ClientReader<::p4::v1::ReadResponse>> reader =
+        stub_->Read(&context, req);
+    ::p4::v1::ReadResponse resp;
+    while (reader->Read(&resp)) {
+      *entities += resp.entities_size();
+    }
+    ::grpc::Status status = reader->Finish();
+    if (!status.ok()) {
+      return MAKE_ERROR(ERR_INTERNAL)
+             << hal::P4RuntimeGrpcStatusToString(status);
+    }
+    return ::util::OkStatus();
+  }
+
+  // Sends a PacketOut on the stream channel of the primary session.
+  ::util::Status DoPacketOut(uint64* entities) {
+    ::p4::v1::StreamMessageRequest req;
+    *req.mutable_packet() = context_->packet_out;
+    absl::MutexLock l(&context_->stream_lock);
+    if (!context_->session->StreamChannelWrite(req)) {
+      return MAKE_ERROR(ERR_UNAVAILABLE) << "Stream channel closed.";
+    }
+    *entities = 1;
+    return ::util::OkStatus();
+  }
+
+  // Opens a new stream channel, becomes backup controller and closes the
+  // stream again.
+  ::util::Status DoArbitration(uint64* entities) {
+    ::grpc::ClientContext context;
+    auto stream = stub_->StreamChannel(&context);
+    ::p4::v1::StreamMessageRequest req;
+    req.mutable_arbitration()->set_device_id(context_->device_id);
+    // Backup election IDs are below the time based ID of the primary.
+    req.mutable_arbitration()->mutable_election_id()->set_low(id_ + 1);
+    ::p4::v1::StreamMessageResponse resp;
+    ::util::Status result = ::util::OkStatus();
+    if (!stream->Write(req)) {
+      result = MAKE_ERROR(ERR_UNAVAILABLE) << "Stream channel closed.";
+    } else if (!stream->Read(&resp) ||
+               resp.update_case() !=
+                   ::p4::v1::StreamMessageResponse::kArbitration) {
+      result = MAKE_ERROR(ERR_INTERNAL) << "No arbitration response received.";
+    }
+    context.TryCancel();
+    stream->Finish();
+    *entities = 1;
+    return result;
+  }
+
+  const int id_;
+  BenchContext* context_;
+  std::unique_ptr<::p4::v1::P4Runtime::Stub> stub_;
+  std::vector<OpStats> stats_;
+  // Keys of the batches inserted by this client, oldest first.
+  std::deque<std::vector<uint64>> batches_;
+  bool delete_next_ = false;
+};
+
+void PrintReport(const std::vector<OpStats>& stats, absl::Duration elapsed) {
+  const double seconds = absl::ToDoubleSeconds(elapsed);
+  std::cout << absl::StrFormat(
+                   "%-12s %10s %8s %12s %14s %10s %10s %10s %10s\n", "op",
+                   "count", "errors", "ops/s", "entities/s", "p50(us)",
+                   "p99(us)", "p999(us)", "max(us)");
+  for (int op = 0; op < kNumOpTypes; ++op) {
+    const OpStats& s = stats[op];
+    const uint64 count = s.latencies.count();
+    if (count == 0 && s.errors == 0) continue;
+    auto percentile_us = [&s](double q) -> double {
+      return s.latencies.PercentileNs(q) / 1000.0;
+    };
+    std::cout << absl::StrFormat(
+        "%-12s %10d %8d %12.1f %14.1f %10.1f %10.1f %10.1f %10.1f\n",
+        kOpTypeNames[op], count, s.errors, count / seconds,
+        s.entities / seconds, percentile_us(0.5), percentile_us(0.99),
+        percentile_us(0.999), percentile_us(1.0));
+  }
+}
+
+::util::Status Main(int argc, char** argv) {
+  RET_CHECK(FLAGS_num_clients > 0) << "--num_clients must be positive.";
+  RET_CHECK(FLAGS_write_batch_size > 0)
+      << "--write_batch_size must be positive.";
+  RET_CHECK(FLAGS_duration_sec >= 0) << "--duration_sec must not be negative.";
+  RET_CHECK(FLAGS_duration_sec > 0 || FLAGS_max_ops_per_client > 0)
+      << "Either --duration_sec or --max_ops_per_client must be set.";
+  RET_CHECK(FLAGS_write_weight >= 0 && FLAGS_read_weight >= 0 &&
+            FLAGS_packet_out_weight >= 0 && FLAGS_arbitration_weight >= 0 &&
+            FLAGS_write_weight + FLAGS_read_weight + FLAGS_packet_out_weight +
+                    FLAGS_arbitration_weight >
+                0)
+      << "Operation weights must be non-negative and not all zero.";
+
+  BenchContext context;
+  context.grpc_addr = FLAGS_grpc_addr;
+  context.device_id = FLAGS_device_id;
+  if (FLAGS_write_weight > 0 || FLAGS_read_weight > 0) {
+    RET_CHECK(!FLAGS_table_entry_file.empty())
+        << "--table_entry_file is required for writes and reads.";
+    RETURN_IF_ERROR(
+        ReadProtoFromTextFile(FLAGS_table_entry_file, &context.entry_template));
+    RET_CHECK(context.entry_template.match_size() > 0 &&
+              context.entry_template.match(0).has_exact())
+        << "The first match field of the template must be an exact match.";
+    context.key_bitwidth =
+        context.entry_template.match(0).exact().value().size() * 8;
+  }
+  if (!FLAGS_packet_out_file.empty()) {
+    RETURN_IF_ERROR(
+        ReadProtoFromTextFile(FLAGS_packet_out_file, &context.packet_out));
+  }
+  context.packet_out.set_payload(std::string(FLAGS_packet_out_size, '\xab'));
+
+  ASSIGN_OR_RETURN(auto credentials_manager,
+                   CredentialsManager::CreateInstance());
+  context.credentials =
+      credentials_manager->GenerateExternalFacingClientCredentials();
+  ASSIGN_OR_RETURN(auto session, p4runtime::P4RuntimeSession::Create(
+                                     FLAGS_grpc_addr, context.credentials,
+                                     FLAGS_device_id));
+  context.session = session.get();
+  context.election_id = session->ElectionId();
+
+  if (!FLAGS_p4_info_file.empty()) {
+    ::p4::config::v1::P4Info p4info;
+    RETURN_IF_ERROR(ReadProtoFromTextFile(FLAGS_p4_info_file, &p4info));
+    std::string p4_device_config;
+    if (!FLAGS_p4_pipeline_config_file.empty()) {
+      RETURN_IF_ERROR(
+          ReadFileToString(FLAGS_p4_pipeline_config_file, &p4_device_config));
+    }
+    RETURN_IF_ERROR(
+        session->SetForwardingPipelineConfig(p4info, p4_device_config));
+    // Use the real bitwidth of the varied match field to generate valid keys.
+    for (const auto& table : p4info.tables()) {
+      if (table.preamble().id() != context.entry_template.table_id()) continue;
+      for (const auto& match_field : table.match_fields()) {
+        if (context.entry_template.match_size() > 0 &&
+            match_field.id() == context.entry_template.match(0).field_id()) {
+          context.key_bitwidth = match_field.bitwidth();
+        }
+      }
+    }
+  }
+
+  // Drain the primary stream so that PacketIns and stream errors sent by the
+  // switch never block it.
+  std::atomic<uint64> stream_messages{0};
+  std::thread stream_reader([&context, &stream_messages]() {
+    ::p4::v1::StreamMessageResponse resp;
+    while (context.session->StreamChannelRead(&resp)) {
+      ++stream_messages;
+    }
+  });
+
+  std::vector<std::unique_ptr<BenchClient>> clients;
+  for (int i = 0; i < FLAGS_num_clients; ++i) {
+    clients.push_back(absl::make_unique<BenchClient>(i, &context));
+  }
+  LOG(INFO) << "Running " << FLAGS_num_clients << " clients against "
+            << FLAGS_grpc_addr << ".";
+  const absl::Time start = absl::Now();
+  // Without a duration the clients only stop at --max_ops_per_client.
+  const absl::Time deadline = FLAGS_duration_sec > 0
+                                  ? start + absl::Seconds(FLAGS_duration_sec)
+                                  : absl::InfiniteFuture();
+  std::vector<std::thread> threads;
+  for (auto& client : clients) {
+    threads.emplace_back([&client, deadline]() { client->Run(deadline); });
+  }
+  for (auto& thread : threads) thread.join();
+  const absl::Duration elapsed = absl::Now() - start;
+
+  session->TryCancel();
+  stream_reader.join();
+
+  std::vector<OpStats> stats(kNumOpTypes);
+  for (const auto& client : clients) {
+    for (int op = 0; op < kNumOpTypes; ++op) {
+      stats[op].Merge(client->stats(static_cast<OpType>(op)));
+    }
+  }
+  PrintReport(stats, elapsed);
+  LOG(INFO) << "Received " << stream_messages << " stream messages.";
+
+  return ::util::OkStatus();
+}
+
+}  // namespace p4rt_bench
+}  // namespace tools
+}  // namespace stratum
+
+int main(int argc, char** argv) {
+  ::gflags::SetUsageMessage(stratum::tools::p4rt_bench::kUsage);
+  InitGoogle(argv[0], &argc, &argv, true);
+  stratum::InitStratumLogging();
+  return stratum::tools::p4rt_bench::Main(argc, argv).error_code();
+}
@@ -1,11 +1,20 @@
 // Copyright 2020-present Open Networking Foundation
 // Copyright 2024 Intel Corporation
 // SPDX-License-Identifier: Apache-2.0
+#include <algorithm>
+#include <atomic>
 #include <iostream>
 #include <memory>
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
 
 #include "absl/strings/numbers.h"
+#include "absl/strings/str_format.h"
 #include "absl/strings/str_split.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
 #include "gflags/gflags.h"
 #include "glog/logging.h"
 #include "grpcpp/grpcpp.h"
@@ -23,6 +32,7 @@
 #include "stratum/hal/lib/p4/utils.h"
 #include "stratum/lib/constants.h"
 #include "stratum/lib/macros.h"
+#include "stratum/lib/p4runtime/p4runtime_session.h"
 #include "stratum/lib/security/credentials_manager.h"
 #include "stratum/lib/utils.h"
 
@@ -32,6 +42,25 @@ DEFINE_string(pipeline_cfg, "pipeline_cfg.pb.txt", "The pipeline config file.");
 DEFINE_string(election_id, "0,1",
               "Election id for arbitration update (high,low).");
 DEFINE_uint64(device_id, 1, "P4Runtime device ID.");
+DEFINE_string(replay_mode, "asap",
+              "How write requests are paced. 'asap' sends them as fast as "
+              "possible, 'timed' sends them at the relative times recorded "
+              "in the log.");
+DEFINE_double(time_scale, 1.0,
+              "Speed up factor for the 'timed' replay mode. 2.0 replays the "
+              "log twice as fast as it was recorded.");
+DEFINE_int32(max_in_flight, 1,
+             "Maximum number of outstanding write requests. Values above 1 "
+             "pipeline the writes, which does not preserve the order in "
+             "which dependent batches are applied by the switch.");
+DEFINE_int32(num_channels, 1,
+             "Number of gRPC channels the write requests are spread over.");
+DEFINE_bool(regroup_batches, true,
+            "Send the updates in the batches of the original write requests. "
+            "If false, every update is sent in its own write request.");
+DEFINE_bool(stop_on_error, true,
+            "Stop the replay at the first write request which fails although "
+            "it succeeded on the original switch.");
 
 namespace stratum {
 namespace tools {
@@ -47,18 +76,250 @@ using ClientStreamChannelReaderWriter =
     ::grpc::ClientReaderWriter<::p4::v1::StreamMessageRequest,
                                ::p4::v1::StreamMessageResponse>;
 
+// A write request rebuilt from the log, with the per update error messages
+// the original switch returned.
+struct ReplayBatch {
+  // Time of the original request, relative to the first request in the log.
+  absl::Duration offset;
+  ::p4::v1::WriteRequest request;
+  std::vector<std::string> expected_errors;
+};
+
+// Measurements of all replayed batches.
+struct ReplayStats {
+  std::vector<absl::Duration> latencies;
+  int64 num_updates = 0;
+  int64 num_failed = 0;
+  // Largest delay between the recorded and the actual send time, only set in
+  // the 'timed' replay mode.
+  absl::Duration max_lag;
+};
+
+// Parses the write log into write requests. The P4Service logs every update
+// of a write request in its own line, all with the timestamp of the request,
+// so consecutive lines with the same timestamp and node ID form one batch.
+static ::util::Status ParseWriteLog(const std::string& path,
+                                    absl::uint128 election_id,
+                                    std::vector<ReplayBatch>* batches) {
+  std::string p4_write_logs;
+  RETURN_IF_ERROR(::stratum::ReadFileToString(path, &p4_write_logs));
+  std::vector<std::string> lines =
+      absl::StrSplit(p4_write_logs, '\n', absl::SkipEmpty());
+  // Log format: <timestamp>;<node_id>;<update proto>;<status>
+  // This regular expression contains 4 sub-match groups which extracts
+  // elements from the log string. See LogWriteRequest() in P4Service.
+  const RE2 write_req_regex(
+      "(\\d{4}-\\d{1,2}-\\d{1,2} "
+      "\\d{1,2}:\\d{1,2}:\\d{1,2}\\.\\d{6});(\\d+);(type[^;]*);(.*)");
+  std::string last_timestamp;
+  std::string last_node_id;
+  absl::Time first_time;
+  for (const std::string& line : lines) {
+    std::string timestamp;
+    std::string node_id;
+    std::string write_request_text;
+    std::string error_msg;
+    if (!RE2::FullMatch(line, write_req_regex, &timestamp, &node_id,
+                        &write_request_text, &error_msg)) {
+      // Can not find what we want in this line.
+      LOG(ERROR) << "Unable to find write request message, skip: " << line;
+      continue;
+    }
+    absl::Time time;
+    std::string err;
+    if (!absl::ParseTime("%Y-%m-%d %H:%M:%E6S", timestamp,
+                         absl::LocalTimeZone(), &time, &err)) {
+      return MAKE_ERROR(ERR_INVALID_PARAM)
+             << "Invalid timestamp '" << timestamp << "': " << err;
+    }
+    if (batches->empty()) first_time = time;
+
+    if (batches->empty() || !FLAGS_regroup_batches ||
+        timestamp != last_timestamp || node_id != last_node_id) {
+      ReplayBatch batch;
+      batch.offset = time - first_time;
+      batch.request.set_device_id(FLAGS_device_id);
+      batch.request.mutable_election_id()->set_high(
+          absl::Uint128High64(election_id));
+      batch.request.mutable_election_id()->set_low(
+          absl::Uint128Low64(election_id));
+      batches->push_back(std::move(batch));
+      last_timestamp = timestamp;
+      last_node_id = node_id;
+    }
+    ReplayBatch& batch = batches->back();
+    RETURN_IF_ERROR(
+        ParseProtoFromString(write_request_text, batch.request.add_updates()));
+    batch.expected_errors.push_back(std::move(error_msg));
+  }
+
+  return ::util::OkStatus();
+}
+
+// Compares the result of a replayed write request with the results logged by
+// the original switch. Differing error messages are only reported as
+// warnings, an error is returned if an update failed which succeeded on the
+// original switch.
+static ::util::Status CheckWriteResult(const ReplayBatch& batch,
+                                       const ::grpc::Status& status) {
+  if (status.ok()) {
+    for (const std::string& error_msg : batch.expected_errors) {
+      if (error_msg.empty()) continue;
+      LOG(WARNING) << "Expect to get an error, but the request succeeded.\n"
+                   << "Expected error: " << error_msg << "\n"
+                   << "Request: " << batch.request.ShortDebugString();
+    }
+    return ::util::OkStatus();
+  }
+
+  ::google::rpc::Status details;
+  if (status.error_details().empty() ||
+      !details.ParseFromString(status.error_details()) ||
+      details.details_size() != batch.request.updates_size()) {
+    // No per update results, the request failed as a whole.
+    return MAKE_ERROR(ERR_INTERNAL)
+           << "Failed to send P4Runtime write request: "
+           << batch.request.ShortDebugString() << "\n"
+           << ::stratum::hal::P4RuntimeGrpcStatusToString(status);
+  }
+  for (int i = 0; i < details.details_size(); ++i) {
+    ::p4::v1::Error detail;
+    RET_CHECK(details.details(i).UnpackTo(&detail))
+        << "Failed to parse the P4Runtime error from detail message.";
+    const std::string& error_msg = batch.expected_errors[i];
+    if (error_msg.empty()) {
+      if (detail.canonical_code() != ::google::rpc::OK) {
+        return MAKE_ERROR(ERR_INTERNAL)
+               << "Failed to send P4Runtime write request: "
+               << batch.request.updates(i).ShortDebugString() << "\n"
+               << ::stratum::hal::P4RuntimeGrpcStatusToString(status);
+      }
+    } else if (detail.canonical_code() == ::google::rpc::OK) {
+      LOG(WARNING) << "Expect to get an error, but the request succeeded.\n"
+                   << "Expected error: " << error_msg << "\n"
+                   << "Request: "
+                   << batch.request.updates(i).ShortDebugString();
+    } else if (detail.message() != error_msg) {
+      LOG(WARNING) << "The expected error message is different "
+                      "to the actual error message:\n"
+                   << "Expected: " << error_msg << "\n"
+                   << "Actual: " << detail.message();
+    }
+  }
+
+  return ::util::OkStatus();
+}
+
+// Sends all batches with FLAGS_max_in_flight concurrent senders. Batches are
+// dispatched in log order; in the 'timed' mode a batch is not sent before its
+// recorded offset from the start of the replay.
+static ::util::Status ReplayBatches(
+    const std::vector<ReplayBatch>& batches,
+    const std::vector<std::unique_ptr<::p4::v1::P4Runtime::Stub>>& stubs,
+    bool timed, ReplayStats* stats) {
+  std::atomic<size_t> next_batch(0);
+  std::atomic<bool> stop(false);
+  absl::Mutex lock;
+  ::util::Status first_error;  // Protected by lock.
+  const absl::Time start = absl::Now();
+
+  auto sender = [&](int sender_id) {
+    ::p4::v1::P4Runtime::Stub* stub = stubs[sender_id % stubs.size()].get();
+    std::vector<absl::Duration> latencies;
+    int64 num_updates = 0;
+    int64 num_failed = 0;
+    absl::Duration max_lag;
+    while (!stop.load()) {
+      size_t i = next_batch.fetch_add(1);
+      if (i >= batches.size()) break;
+      const ReplayBatch& batch = batches[i];
+      if (timed) {
+        absl::Time due = start + batch.offset / FLAGS_time_scale;
+        absl::Time now = absl::Now();
+        if (now < due) {
+          absl::SleepFor(due - now);
+        } else {
+          max_lag = std::max(max_lag, now - due);
+        }
+      }
+      VLOG(1) << "Sending request " << batch.request.DebugString();
+      ::grpc::ClientContext context;
+      ::p4::v1::WriteResponse write_resp;
+      absl::Time sent = absl::Now();
+      ::grpc::Status status = stub->Write(&context, batch.request, &write_resp);
+      latencies.push_back(absl::Now() - sent);
+      num_updates += batch.request.updates_size();
+      ::util::Status result = CheckWriteResult(batch, status);
+      if (!result.ok()) {
+        ++num_failed;
+        LOG(ERROR) << result.error_message();
+        if (FLAGS_stop_on_error) {
+          stop = true;
+          absl::MutexLock l(&lock);
+          if (first_error.ok()) first_error = result;
+        }
+      }
+    }
+    absl::MutexLock l(&lock);
+    stats->latencies.insert(stats->latencies.end(), latencies.begin(),
+                            latencies.end());
+    stats->num_updates += num_updates;
+    stats->num_failed += num_failed;
+    stats->max_lag = std::max(stats->max_lag, max_lag);
+  };
+
+  std::vector<std::thread> senders;
+  for (int i = 0; i < FLAGS_max_in_flight; ++i) {
+    senders.emplace_back(sender, i);
+  }
+  for (auto& t : senders) t.join();
+
+  return first_error;
+}
+
+// Prints the achieved rate and the per batch latency distribution.
+static void PrintReport(ReplayStats* stats, absl::Duration elapsed) {
+  std::vector<absl::Duration>& latencies = stats->latencies;
+  std::sort(latencies.begin(), latencies.end());
+  auto percentile = [&latencies](double p) {
+    if (latencies.empty()) return 0.0;
+    size_t i = std::min(latencies.size() - 1,
+                        static_cast<size_t>(p * latencies.size()));
+    return absl::ToDoubleMicroseconds(latencies[i]);
+  };
+  double seconds = std::max(absl::ToDoubleSeconds(elapsed), 1e-9);
+  std::cout << absl::StrFormat(
+      "Replayed %d batches (%d updates, %d failed) in %.3f s\n"
+      "Rate: %.1f batches/s, %.1f updates/s\n"
+      "Batch latency (us): p50 %.0f, p99 %.0f, p999 %.0f, max %.0f\n",
+      latencies.size(), stats->num_updates, stats->num_failed, seconds,
+      latencies.size() / seconds, stats->num_updates / seconds,
+      percentile(0.5), percentile(0.99), percentile(0.999),
+      latencies.empty() ? 0.0 : absl::ToDoubleMicroseconds(latencies.back()));
+  if (FLAGS_replay_mode == "timed") {
+    std::cout << absl::StrFormat("Max send lag behind the log: %.0f us\n",
+                                 absl::ToDoubleMicroseconds(stats->max_lag));
+  }
+}
+
 static ::util::Status Main(int argc, char** argv) {
   if (argc < 2) {
     LOG(INFO) << kUsage;
     return MAKE_ERROR(ERR_INVALID_PARAM).without_logging() << "";
   }
+  RET_CHECK(FLAGS_replay_mode == "asap" || FLAGS_replay_mode == "timed")
+      << "Invalid replay mode " << FLAGS_replay_mode << ".";
+  RET_CHECK(FLAGS_time_scale > 0) << "Time scale must be positive.";
+  RET_CHECK(FLAGS_max_in_flight > 0) << "Max in flight must be positive.";
+  RET_CHECK(FLAGS_num_channels > 0) << "Number of channels must be positive.";
 
   // Initialize the gRPC channel and P4Runtime service stub
   ASSIGN_OR_RETURN(auto credentials_manager,
                    CredentialsManager::CreateInstance());
-  auto channel = ::grpc::CreateChannel(
+  auto channel = ::grpc::CreateCustomChannel(
       FLAGS_grpc_addr,
-      credentials_manager->GenerateExternalFacingClientCredentials());
+      credentials_manager->GenerateExternalFacingClientCredentials(),
+      p4runtime::GrpcChannelArgumentsForP4rt());
   auto stub = ::p4::v1::P4Runtime::NewStub(channel);
 
   // Sends the arbitration update with given device id and election id.
@@ -75,6 +336,13 @@ static ::util::Status Main(int argc, char** argv) {
   absl::uint128 election_id =
       absl::MakeUint128(election_id_high, election_id_low);
 
+  // Parse the whole P4Runtime write log up front, so the replay rate is not
+  // limited by the text format parser.
+  std::vector<ReplayBatch> batches;
+  RETURN_IF_ERROR(ParseWriteLog(argv[1], election_id, &batches));
+  LOG(INFO) << "Parsed " << batches.size() << " write requests from "
+            << argv[1];
+
   stream_req.mutable_arbitration()->set_device_id(FLAGS_device_id);
   stream_req.mutable_arbitration()->mutable_election_id()->set_high(
       absl::Uint128High64(election_id));
@@ -118,71 +386,28 @@ static ::util::Status Main(int argc, char** argv) {
                                   status);
   }
 
-  // Parse the P4Runtime write log file and send write requests to the
-  // target device.
-  std::string p4_write_logs;
-  RETURN_IF_ERROR(::stratum::ReadFileToString(argv[1], &p4_write_logs));
-  std::vector<std::string> lines =
-      absl::StrSplit(p4_write_logs, '\n', absl::SkipEmpty());
-  for (const std::string& line : lines) {
-    ::p4::v1::WriteRequest write_req;
-    ::p4::v1::WriteResponse write_resp;
-    // Log format: <timestamp>;<node_id>;<update proto>;<status>
-    // This regular expression contains 4 sub-match groups which extracts
-    // elements from the log string. See LogWriteRequest() in P4Service.
-    RE2 write_req_regex(
-        "(\\d{4}-\\d{1,2}-\\d{1,2} "
-        "\\d{1,2}:\\d{1,2}:\\d{1,2}\\.\\d{6});(\\d+);(type[^;]*);(.*)");
-
-    std::string write_request_text;
-    std::string error_msg;
-    if (!RE2::FullMatch(line, write_req_regex, nullptr, nullptr,
-                        &write_request_text, &error_msg)) {
-      // Can not find what we want in this line.
-      LOG(ERROR) << "Unable to find write request message, skip: " << line;
-      continue;
-    }
+  // The primary stream above stays open during the replay. Writes can use
+  // additional channels, each one gets its own connection to the switch.
+  std::vector<std::unique_ptr<::p4::v1::P4Runtime::Stub>> write_stubs;
+  for (int i = 0; i < FLAGS_num_channels; ++i) {
+    ::grpc::ChannelArguments args = p4runtime::GrpcChannelArgumentsForP4rt();
+    args.SetInt("stratum_replay_channel", i);
+    write_stubs.push_back(
+        ::p4::v1::P4Runtime::NewStub(::grpc::CreateCustomChannel(
+            FLAGS_grpc_addr,
+            credentials_manager->GenerateExternalFacingClientCredentials(),
+            args)));
+  }
 
-    auto update = write_req.add_updates();
-    RETURN_IF_ERROR(ParseProtoFromString(write_request_text, update));
-    write_req.set_device_id(FLAGS_device_id);
-    write_req.mutable_election_id()->set_high(absl::Uint128High64(election_id));
-    write_req.mutable_election_id()->set_low(absl::Uint128Low64(election_id));
-    VLOG(1) << "Sending request " << write_req.DebugString();
-    ::grpc::ClientContext context;
-    status = stub->Write(&context, write_req, &write_resp);
-
-    if (!error_msg.empty()) {
-      // Here we expect to get an error, since we only send one update per
-      // write request, all we need to do is to check the first error detail.
-      // For now, we only show the message if there is an error instead of
-      // return with an error status.
-      if (status.ok()) {
-        LOG(WARNING) << "Expect to get an error, but the request succeeded.\n"
-                     << "Expected error: " << error_msg << "\n"
-                     << "Request: " << write_req.ShortDebugString();
-      } else {
-        ::google::rpc::Status details;
-        RET_CHECK(details.ParseFromString(status.error_details()))
-            << "Failed to parse error details from gRPC status.";
-        if (details.details_size() != 0) {
-          ::p4::v1::Error detail;
-          RET_CHECK(details.details(0).UnpackTo(&detail))
-              << "Failed to parse the P4Runtime error from detail message.";
-          if (detail.message() != error_msg) {
-            LOG(WARNING) << "The expected error message is different "
-                            "to the actual error message:\n"
-                         << "Expected: " << error_msg << "\n"
-                         << "Actual: " << detail.message();
-          }
-        }
-      }
-    } else {
-      RET_CHECK(status.ok())
-          << "Failed to send P4Runtime write request: "
-          << write_req.ShortDebugString() << "\n"
-          << ::stratum::hal::P4RuntimeGrpcStatusToString(status);
-    }
+  ReplayStats stats;
+  absl::Time start = absl::Now();
+  ::util::Status replay_status = ReplayBatches(
+      batches, write_stubs, FLAGS_replay_mode == "timed", &stats);
+  PrintReport(&stats, absl::Now() - start);
+  RETURN_IF_ERROR(replay_status);
+  if (stats.num_failed > 0) {
+    return MAKE_ERROR(ERR_AT_LEAST_ONE_OPER_FAILED)
+           << stats.num_failed << " write requests failed.";
   }
 
   LOG(INFO) << "Done";